@@ -0,0 +1,42 @@
+/**----------------------------------------------------------------------------
+
+    @file       CrcBench.h
+    @defgroup   BenchNimbleLIB Bench Nimble LIB
+    @brief      CRC throughput benchmark for the Nimble LIB
+
+    @copyright  Neil Beresford 2023
+
+Notes:
+
+        please see CrcBench.cpp for full details.
+
+-----------------------------------------------------------------------------*/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include <cstdint>
+
+//-----------------------------------------------------------------------------
+// Namespace
+//-----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Function prototypes
+//-----------------------------------------------------------------------------
+
+bool benchCrc( uint32_t megabytes );
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: CrcBench.h
+//-----------------------------------------------------------------------------
@@ -0,0 +1,140 @@
+/**----------------------------------------------------------------------------
+
+    @file       HeadlessScreen.h
+    @defgroup   BenchNimbleLIB Bench Nimble LIB
+    @brief      Headless curses screen for the Nimble LIB benchmarks
+
+    @copyright  Neil Beresford 2023
+
+Notes:
+
+        please see HeadlessScreen.cpp for full details.
+
+-----------------------------------------------------------------------------*/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+extern "C"
+{
+#include "../../ExternalLibraries/PDCurses/curses.h"
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      Line record of a window, curses only declares it
+-----------------------------------------------------------------------------*/
+struct ldat
+{
+    chtype*        text;      //!< first cell of the line
+    NCURSES_SIZE_T firstchar; //!< first column changed, NO_CHANGE if none
+    NCURSES_SIZE_T lastchar;  //!< last column changed
+    NCURSES_SIZE_T oldindex;  //!< unused
+};
+
+//-----------------------------------------------------------------------------
+// Namespace
+//-----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Class definitions
+//-----------------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      In memory terminal behind the curses calls the Nimble Library
+                makes. Keys are queued for wgetch() and every doupdate() is
+                turned into the bytes a terminal would have been sent
+-----------------------------------------------------------------------------*/
+class HeadlessScreen
+{
+  public:
+    // constants ---------------------------------------------------------------
+    static const int DEFAULT_COLUMNS = 160; //!< screen width unless set before initscr()
+    static const int DEFAULT_LINES   = 50;  //!< screen height unless set before initscr()
+    static const int NO_CHANGE       = -1;  //!< line record firstchar when the line is unchanged
+    // singleton ---------------------------------------------------------------
+    static HeadlessScreen& getInstance();
+    // setup -------------------------------------------------------------------
+    void setScreenSize( int columns, int lines );
+    // input -------------------------------------------------------------------
+    void     pushKey( int key );
+    void     pushKeys( const std::vector<int>& keys );
+    uint32_t getPendingKeys() const;
+    // output ------------------------------------------------------------------
+    uint64_t           getFrameCount() const;
+    uint64_t           getBytesEmitted() const;
+    uint64_t           getLastFrameBytes() const;
+    uint32_t           getLastFrameCells() const;
+    const std::string& getLastFrame() const;
+    std::string        getLine( int line ) const;
+    chtype             getCell( int line, int column ) const;
+    // curses backend ----------------------------------------------------------
+    WINDOW* createScreen();
+    WINDOW* createWindow( WINDOW* parent, int lines, int columns, int y, int x );
+    bool    deleteWindow( WINDOW* win );
+    void    copyWindow( WINDOW* win );
+    void    update();
+    int     readKey();
+    int     setCursorVisibility( int visibility );
+    bool    setColourPair( int pair, int ink, int paper );
+    mmask_t setMouseMask( mmask_t mask );
+
+  private:
+    // typedefs ----------------------------------------------------------------
+    /**------------------------------------------------------------------------
+        @ingroup    BenchNimbleLIB Bench Nimble LIB
+        @brief      Cells and line records behind one WINDOW
+    -------------------------------------------------------------------------*/
+    struct WindowData
+    {
+        WINDOW              win;   //!< curses window handed out
+        std::vector<ldat>   lines; //!< line records, win._line points here
+        std::vector<chtype> cells; //!< cells, empty for sub-windows which share their parent's
+    };
+
+    // constructors ------------------------------------------------------------
+    HeadlessScreen();
+    // private variables -------------------------------------------------------
+    std::map<WINDOW*, std::unique_ptr<WindowData>> m_windows;    //!< windows created, by handle
+    std::vector<chtype>                            m_virtual;    //!< screen as the windows refreshed it
+    std::vector<chtype>                            m_physical;   //!< screen as the terminal shows it
+    std::vector<short>                             m_pairInk;    //!< ink colour of each colour pair
+    std::vector<short>                             m_pairPaper;  //!< paper colour of each colour pair
+    std::deque<int>                                m_keys;       //!< keys waiting for wgetch()
+    std::string                                    m_frame;      //!< bytes sent by the last doupdate()
+    int                                            m_columns;    //!< screen width
+    int                                            m_lines;      //!< screen height
+    int                                            m_cursorX;    //!< terminal cursor column
+    int                                            m_cursorY;    //!< terminal cursor line
+    chtype                                         m_attributes; //!< terminal attributes in effect
+    int                                            m_visibility; //!< curs_set() visibility
+    mmask_t                                        m_mouseMask;  //!< mousemask() events
+    uint64_t                                       m_frames;     //!< doupdate() calls
+    uint64_t                                       m_bytes;      //!< bytes sent by every doupdate()
+    uint32_t                                       m_cells;      //!< cells sent by the last doupdate()
+    // private functions -------------------------------------------------------
+    void emitCell( int y, int x, chtype cell );
+    void emitAttributes( chtype attributes );
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: HeadlessScreen.h
+//-----------------------------------------------------------------------------
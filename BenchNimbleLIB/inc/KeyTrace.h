@@ -0,0 +1,78 @@
+/**----------------------------------------------------------------------------
+
+    @file       KeyTrace.h
+    @defgroup   BenchNimbleLIB Bench Nimble LIB
+    @brief      Keystroke traces replayed by the Nimble LIB benchmarks
+
+    @copyright  Neil Beresford 2023
+
+Notes:
+
+        please see KeyTrace.cpp for full details.
+
+-----------------------------------------------------------------------------*/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+// Namespace
+//-----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Class definitions
+//-----------------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      Keys arriving between two screen updates, and the operation
+                they are timed as
+-----------------------------------------------------------------------------*/
+struct KeyFrame
+{
+    std::string      operation; //!< operation the frame is reported under
+    std::vector<int> keys;      //!< keys handled in the frame, in order
+};
+
+/**----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      A recorded or generated keystroke trace
+-----------------------------------------------------------------------------*/
+class KeyTrace
+{
+  public:
+    // file --------------------------------------------------------------------
+    bool load( const std::string& fileName );
+    bool save( const std::string& fileName ) const;
+    // building ----------------------------------------------------------------
+    void addFrame( const std::string& operation, const std::vector<int>& keys );
+    void addTyping( const std::string& text );
+    void addPaging( uint32_t pages );
+    void addPaste( const std::string& text, uint32_t pastes, bool bracketed = true );
+    void addSearch( const std::vector<int>& placeCursor, uint32_t matches );
+    // getters -----------------------------------------------------------------
+    const std::vector<KeyFrame>& getFrames() const;
+    uint64_t                     getKeyCount() const;
+
+  private:
+    // private variables -------------------------------------------------------
+    std::vector<KeyFrame> m_frames; //!< frames in replay order
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: KeyTrace.h
+//-----------------------------------------------------------------------------
@@ -0,0 +1,42 @@
+/**----------------------------------------------------------------------------
+
+    @file       QuickOpenBench.h
+    @defgroup   BenchNimbleLIB Bench Nimble LIB
+    @brief      Quick open filter benchmark for the Nimble LIB
+
+    @copyright  Neil Beresford 2023
+
+Notes:
+
+        please see QuickOpenBench.cpp for full details.
+
+-----------------------------------------------------------------------------*/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include <cstdint>
+
+//-----------------------------------------------------------------------------
+// Namespace
+//-----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Function prototypes
+//-----------------------------------------------------------------------------
+
+bool benchQuickOpen( uint32_t files );
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: QuickOpenBench.h
+//-----------------------------------------------------------------------------
@@ -0,0 +1,163 @@
+/**----------------------------------------------------------------------------
+
+    @file       CrcBench.cpp
+    @defgroup   BenchNimbleLIB Bench Nimble LIB
+    @brief      CRC throughput benchmark for the Nimble LIB
+
+    @copyright  Neil Beresford 2023
+
+Notes:
+
+    Times the CRC of a buffer by each method of the Crc engine against the
+    bitwise CRC-16 loop Tools::crc16 used before it, reporting megabytes a
+    second and the speed up over the bitwise loop. Each is run three times
+    and the fastest kept. A CRC that differs from the table method's is
+    reported as a failure.
+
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include "../inc/CrcBench.h"
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <vector>
+#include "../../NimbleLIB/inc/Modules/Utilities/Crc.h"
+
+//-----------------------------------------------------------------------------
+// Namespace
+//-----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Local functions
+//-----------------------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      CRC-16/MODBUS a bit at a time, as Tools::crc16 was
+    @param      data        bytes
+    @param      length      number of bytes
+    @return     uint32_t    CRC
+------------------------------------------------------------------------------*/
+static uint32_t crc16Bitwise( const uint8_t* data, size_t length )
+{
+    uint16_t crc = 0xFFFF;
+
+    while ( length-- )
+    {
+        crc ^= *data++;
+        for ( uint32_t bit = 0; bit < 8; bit++ )
+        {
+            crc = ( crc & 1 ) ? ( crc >> 1 ) ^ 0xA001 : crc >> 1;
+        }
+    }
+    return crc;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      times a CRC, the fastest of three runs
+    @param      function    calculates the CRC
+    @param      crc         set to the CRC
+    @return     double      seconds
+------------------------------------------------------------------------------*/
+static double timeCrc( const std::function<uint32_t()>& function, uint32_t& crc )
+{
+    double best = 0.0;
+
+    for ( uint32_t run = 0; run < 3; run++ )
+    {
+        auto start = std::chrono::steady_clock::now();
+        crc        = function();
+        auto end   = std::chrono::steady_clock::now();
+
+        double seconds = std::chrono::duration<double>( end - start ).count();
+        if ( run == 0 || seconds < best )
+        {
+            best = seconds;
+        }
+    }
+    return best;
+}
+
+//-----------------------------------------------------------------------------
+// External functions
+//-----------------------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      reports the throughput of each CRC method
+    @param      megabytes   size of the buffer
+    @return     bool        false if a method gave a different CRC
+------------------------------------------------------------------------------*/
+bool benchCrc( uint32_t megabytes )
+{
+    std::vector<uint8_t> buffer( (size_t)megabytes << 20 );
+    bool                 passed = true;
+    uint32_t             crc    = 0;
+
+    for ( size_t index = 0; index < buffer.size(); index++ )
+    {
+        buffer[index] = (uint8_t)( ( index * 2654435761u ) >> 13 );
+    }
+
+    double   bitwise    = timeCrc( [&]() { return crc16Bitwise( buffer.data(), buffer.size() ); }, crc );
+    uint32_t expected16 = crc;
+
+    printf( "%-8s %-10s %12s %10s %10s\n", "crc", "method", "MB/s", "speed up", "crc" );
+    printf( "%-8s %-10s %12.1f %10.1f %10.8X\n", "crc16", "bitwise", megabytes / bitwise, 1.0, crc );
+
+    const struct
+    {
+        const char*  name;
+        Crc::CrcType type;
+    } types[] = { { "crc16", Crc::CrcType::Crc16 }, { "crc32", Crc::CrcType::Crc32 }, { "crc32c", Crc::CrcType::Crc32C } };
+    const struct
+    {
+        const char*    name;
+        Crc::CrcMethod method;
+    } methods[] = { { "table", Crc::CrcMethod::Table }, { "slice8", Crc::CrcMethod::Slice8 }, { "hardware", Crc::CrcMethod::Hardware } };
+
+    for ( auto& type : types )
+    {
+        uint32_t expected = ( type.type == Crc::CrcType::Crc16 ) ? expected16 : 0;
+        for ( auto& method : methods )
+        {
+            Crc check( type.type, method.method );
+            if ( method.method == Crc::CrcMethod::Hardware && check.getMethod() != Crc::CrcMethod::Hardware )
+            {
+                continue;
+            }
+
+            double seconds = timeCrc(
+                [&]()
+                {
+                    Crc engine( type.type, method.method );
+                    engine.update( buffer.data(), buffer.size() );
+                    return engine.finalise();
+                },
+                crc );
+            if ( method.method == Crc::CrcMethod::Table && type.type != Crc::CrcType::Crc16 )
+            {
+                expected = crc;
+            }
+            printf( "%-8s %-10s %12.1f %10.1f %10.8X%s\n", type.name, method.name, megabytes / seconds, bitwise / seconds, crc, ( crc == expected ) ? "" : " FAIL" );
+            passed &= ( crc == expected );
+        }
+    }
+    return passed;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: CrcBench.cpp
+//-----------------------------------------------------------------------------
@@ -0,0 +1,1044 @@
+/**----------------------------------------------------------------------------
+
+    @file       HeadlessScreen.cpp
+    @defgroup   BenchNimbleLIB Bench Nimble LIB
+    @brief      Headless curses screen for the Nimble LIB benchmarks
+
+    @copyright  Neil Beresford 2023
+
+Notes:
+
+    This file defines the curses calls the Nimble Library and NimbleIDE
+    make, so a target linked with it in place of the curses library runs
+    without a terminal. Only those calls are defined, anything else the
+    library starts to use shows up as a link error here first.
+
+    The windows are laid out the way curses lays them out. Each WINDOW has
+    a line record per line pointing at its cells, a sub-window's records
+    point into its parent's cells, and the records keep the first and last
+    column changed. wnoutrefresh() copies the changed columns to the
+    virtual screen, doupdate() compares the virtual screen with what the
+    terminal shows and writes the difference as the escape sequences a
+    terminal would be sent, cursor moves, attribute changes and the
+    characters, so getLastFrameBytes() is the cost of the frame.
+
+    The curses headers on Linux are ncurses', the line records and the
+    WINDOW fields used are ncurses'. wgetch() never waits, it returns the
+    next key pushed or ERR, and there are no mouse events.
+
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include "../inc/HeadlessScreen.h"
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+//-----------------------------------------------------------------------------
+// Namespace
+//-----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Local data
+//-----------------------------------------------------------------------------
+
+static const int MAX_COLOUR_PAIRS = 256; //!< colour pairs init_pair() accepts
+
+//-----------------------------------------------------------------------------
+// Class definitions
+//-----------------------------------------------------------------------------
+
+// constructors ----------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      HeadlessScreen Constructor
+
+------------------------------------------------------------------------------*/
+HeadlessScreen::HeadlessScreen() : m_pairInk( MAX_COLOUR_PAIRS, -1 ), m_pairPaper( MAX_COLOUR_PAIRS, -1 )
+{
+    m_columns    = DEFAULT_COLUMNS;
+    m_lines      = DEFAULT_LINES;
+    m_cursorX    = 0;
+    m_cursorY    = 0;
+    m_attributes = A_NORMAL;
+    m_visibility = 1;
+    m_mouseMask  = 0;
+    m_frames     = 0;
+    m_bytes      = 0;
+    m_cells      = 0;
+}
+
+// singleton -------------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      gets the headless screen
+    @return     HeadlessScreen&     the screen
+------------------------------------------------------------------------------*/
+HeadlessScreen& HeadlessScreen::getInstance()
+{
+    static HeadlessScreen instance;
+    return instance;
+}
+
+// setup -----------------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      sets the size of the screen, before initscr()
+    @param      columns screen width
+    @param      lines   screen height
+    @return     void
+------------------------------------------------------------------------------*/
+void HeadlessScreen::setScreenSize( int columns, int lines )
+{
+    m_columns = columns;
+    m_lines   = lines;
+}
+
+// input -----------------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      queues a key for wgetch()
+    @param      key     key code
+    @return     void
+------------------------------------------------------------------------------*/
+void HeadlessScreen::pushKey( int key )
+{
+    m_keys.push_back( key );
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      queues keys for wgetch(), in order
+    @param      keys    key codes
+    @return     void
+------------------------------------------------------------------------------*/
+void HeadlessScreen::pushKeys( const std::vector<int>& keys )
+{
+    m_keys.insert( m_keys.end(), keys.begin(), keys.end() );
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      gets the number of keys not yet read
+    @return     uint32_t    keys waiting
+------------------------------------------------------------------------------*/
+uint32_t HeadlessScreen::getPendingKeys() const
+{
+    return (uint32_t)m_keys.size();
+}
+
+// output ----------------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      gets the number of doupdate() calls
+    @return     uint64_t    frames
+------------------------------------------------------------------------------*/
+uint64_t HeadlessScreen::getFrameCount() const
+{
+    return m_frames;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      gets the bytes every doupdate() has sent
+    @return     uint64_t    bytes
+------------------------------------------------------------------------------*/
+uint64_t HeadlessScreen::getBytesEmitted() const
+{
+    return m_bytes;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      gets the bytes the last doupdate() sent
+    @return     uint64_t    bytes
+------------------------------------------------------------------------------*/
+uint64_t HeadlessScreen::getLastFrameBytes() const
+{
+    return m_frame.size();
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      gets the cells the last doupdate() sent
+    @return     uint32_t    cells
+------------------------------------------------------------------------------*/
+uint32_t HeadlessScreen::getLastFrameCells() const
+{
+    return m_cells;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      gets the bytes the last doupdate() sent
+    @return     const std::string&  escape sequences and characters
+------------------------------------------------------------------------------*/
+const std::string& HeadlessScreen::getLastFrame() const
+{
+    return m_frame;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      gets the characters of a line as the terminal shows it, line
+                drawing is shown as '-', '|' and '+'
+    @param      line    screen line
+    @return     std::string     characters, empty if off the screen
+------------------------------------------------------------------------------*/
+std::string HeadlessScreen::getLine( int line ) const
+{
+    std::string text;
+
+    if ( line >= 0 && line < m_lines && m_physical.empty() == false )
+    {
+        for ( int column = 0; column < m_columns; column++ )
+        {
+            chtype cell = m_physical[line * m_columns + column];
+            char   ch   = (char)( cell & A_CHARTEXT );
+            if ( cell & A_ALTCHARSET )
+            {
+                ch = ( ch == 'q' ) ? '-' : ( ch == 'x' ) ? '|' : '+';
+            }
+            text += ch;
+        }
+    }
+    return text;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      gets a cell as the terminal shows it
+    @param      line    screen line
+    @param      column  screen column
+    @return     chtype  character and attributes, 0 if off the screen
+------------------------------------------------------------------------------*/
+chtype HeadlessScreen::getCell( int line, int column ) const
+{
+    if ( line < 0 || line >= m_lines || column < 0 || column >= m_columns || m_physical.empty() )
+    {
+        return 0;
+    }
+    return m_physical[line * m_columns + column];
+}
+
+// curses backend --------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      creates the screen and stdscr, for initscr()
+    @return     WINDOW*     stdscr
+------------------------------------------------------------------------------*/
+WINDOW* HeadlessScreen::createScreen()
+{
+    if ( stdscr == nullptr )
+    {
+        LINES = m_lines;
+        COLS  = m_columns;
+        m_virtual.assign( (size_t)m_lines * m_columns, ' ' );
+        m_physical.assign( (size_t)m_lines * m_columns, ' ' );
+        for ( int ch = 0; ch < 128; ch++ )
+        {
+            acs_map[ch] = (chtype)ch | A_ALTCHARSET;
+        }
+        COLORS      = 256;
+        COLOR_PAIRS = MAX_COLOUR_PAIRS;
+        stdscr      = createWindow( nullptr, m_lines, m_columns, 0, 0 );
+    }
+    return stdscr;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      creates a window, for newwin() and subwin()
+    @param      parent  window to share the cells of, nullptr for a new window
+    @param      lines   height, 0 to reach the bottom of the parent
+    @param      columns width, 0 to reach the right of the parent
+    @param      y       screen line of the top
+    @param      x       screen column of the left
+    @return     WINDOW*     window, nullptr if it does not fit
+------------------------------------------------------------------------------*/
+WINDOW* HeadlessScreen::createWindow( WINDOW* parent, int lines, int columns, int y, int x )
+{
+    int top    = parent ? parent->_begy : 0;
+    int left   = parent ? parent->_begx : 0;
+    int bottom = parent ? top + parent->_maxy + 1 : m_lines;
+    int right  = parent ? left + parent->_maxx + 1 : m_columns;
+
+    lines   = ( lines > 0 ) ? lines : bottom - y;
+    columns = ( columns > 0 ) ? columns : right - x;
+    if ( y < top || x < left || lines <= 0 || columns <= 0 || y + lines > bottom || x + columns > right )
+    {
+        return nullptr;
+    }
+
+    auto    data = std::make_unique<WindowData>();
+    WINDOW* win  = &data->win;
+    memset( win, 0, sizeof( WINDOW ) );
+    win->_maxy      = (NCURSES_SIZE_T)( lines - 1 );
+    win->_maxx      = (NCURSES_SIZE_T)( columns - 1 );
+    win->_begy      = (NCURSES_SIZE_T)y;
+    win->_begx      = (NCURSES_SIZE_T)x;
+    win->_bkgd      = ' ';
+    win->_delay     = -1;
+    win->_regbottom = (NCURSES_SIZE_T)( lines - 1 );
+    win->_parent    = parent;
+    win->_pary      = y - top;
+    win->_parx      = x - left;
+
+    data->lines.resize( lines );
+    if ( parent == nullptr )
+    {
+        data->cells.assign( (size_t)lines * columns, ' ' );
+    }
+    for ( int line = 0; line < lines; line++ )
+    {
+        ldat& record     = data->lines[line];
+        record.text      = parent ? parent->_line[win->_pary + line].text + win->_parx : data->cells.data() + (size_t)line * columns;
+        record.firstchar = 0;
+        record.lastchar  = win->_maxx;
+        record.oldindex  = 0;
+    }
+    win->_line = data->lines.data();
+    m_windows.emplace( win, std::move( data ) );
+    return win;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      frees a window, for delwin()
+    @param      win     window
+    @return     bool    false if the window is not known
+------------------------------------------------------------------------------*/
+bool HeadlessScreen::deleteWindow( WINDOW* win )
+{
+    return m_windows.erase( win ) > 0;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      copies the changed columns of a window to the virtual
+                screen, for wnoutrefresh()
+    @param      win     window
+    @return     void
+------------------------------------------------------------------------------*/
+void HeadlessScreen::copyWindow( WINDOW* win )
+{
+    for ( int line = 0; line <= win->_maxy; line++ )
+    {
+        ldat& record = win->_line[line];
+        int   y      = win->_begy + line;
+        if ( record.firstchar == NO_CHANGE )
+        {
+            continue;
+        }
+        if ( y < m_lines )
+        {
+            int first = std::max<int>( record.firstchar, 0 );
+            int last  = std::min<int>( record.lastchar, m_columns - 1 - win->_begx );
+            for ( int column = first; column <= last; column++ )
+            {
+                m_virtual[y * m_columns + win->_begx + column] = record.text[column];
+            }
+        }
+        record.firstchar = NO_CHANGE;
+        record.lastchar  = NO_CHANGE;
+    }
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      sends the cells that differ from the terminal, for doupdate()
+    @return     void
+------------------------------------------------------------------------------*/
+void HeadlessScreen::update()
+{
+    m_frame.clear();
+    m_cells = 0;
+    for ( int y = 0; y < m_lines; y++ )
+    {
+        for ( int x = 0; x < m_columns; x++ )
+        {
+            size_t cell = (size_t)y * m_columns + x;
+            if ( m_virtual[cell] != m_physical[cell] )
+            {
+                emitCell( y, x, m_virtual[cell] );
+                m_physical[cell] = m_virtual[cell];
+                m_cells++;
+            }
+        }
+    }
+    m_bytes += m_frame.size();
+    m_frames++;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      reads the next key queued, for wgetch()
+    @return     int     key, ERR if none
+------------------------------------------------------------------------------*/
+int HeadlessScreen::readKey()
+{
+    if ( m_keys.empty() )
+    {
+        return ERR;
+    }
+    int key = m_keys.front();
+    m_keys.pop_front();
+    return key;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      sets the cursor visibility, for curs_set()
+    @param      visibility  0 hidden, 1 normal, 2 very visible
+    @return     int     visibility before
+------------------------------------------------------------------------------*/
+int HeadlessScreen::setCursorVisibility( int visibility )
+{
+    int before   = m_visibility;
+    m_visibility = visibility;
+    return before;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      sets the colours of a colour pair, for init_pair()
+    @param      pair    colour pair
+    @param      ink     foreground colour
+    @param      paper   background colour
+    @return     bool    false if the pair is out of range
+------------------------------------------------------------------------------*/
+bool HeadlessScreen::setColourPair( int pair, int ink, int paper )
+{
+    if ( pair < 1 || pair >= MAX_COLOUR_PAIRS )
+    {
+        return false;
+    }
+    m_pairInk[pair]   = (short)ink;
+    m_pairPaper[pair] = (short)paper;
+    return true;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      sets the mouse events reported, for mousemask()
+    @param      mask    events wanted
+    @return     mmask_t     mask before
+------------------------------------------------------------------------------*/
+mmask_t HeadlessScreen::setMouseMask( mmask_t mask )
+{
+    mmask_t before = m_mouseMask;
+    m_mouseMask    = mask;
+    return before;
+}
+
+// private functions -----------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      writes one cell to the frame, moving the cursor and changing
+                the attributes first if needed
+    @param      y       screen line
+    @param      x       screen column
+    @param      cell    character and attributes
+    @return     void
+------------------------------------------------------------------------------*/
+void HeadlessScreen::emitCell( int y, int x, chtype cell )
+{
+    char buffer[32];
+
+    if ( y != m_cursorY || x != m_cursorX )
+    {
+        snprintf( buffer, sizeof( buffer ), "\x1b[%d;%dH", y + 1, x + 1 );
+        m_frame += buffer;
+    }
+    if ( ( cell & A_ATTRIBUTES ) != m_attributes )
+    {
+        emitAttributes( cell & A_ATTRIBUTES );
+    }
+
+    // line drawing goes out as UTF-8 box characters
+    char ch = (char)( cell & A_CHARTEXT );
+    if ( cell & A_ALTCHARSET )
+    {
+        switch ( ch )
+        {
+            case 'q': m_frame += "\xe2\x94\x80"; break;
+            case 'x': m_frame += "\xe2\x94\x82"; break;
+            case 'l': m_frame += "\xe2\x94\x8c"; break;
+            case 'k': m_frame += "\xe2\x94\x90"; break;
+            case 'm': m_frame += "\xe2\x94\x94"; break;
+            case 'j': m_frame += "\xe2\x94\x98"; break;
+            default: m_frame += "\xe2\x94\xbc"; break;
+        }
+    }
+    else
+    {
+        m_frame += ch;
+    }
+    m_cursorY = y;
+    m_cursorX = x + 1;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      writes the escape sequence setting the attributes and colours
+    @param      attributes  attributes and colour pair of the next cell
+    @return     void
+------------------------------------------------------------------------------*/
+void HeadlessScreen::emitAttributes( chtype attributes )
+{
+    std::string sequence = "\x1b[0";
+    int         pair     = PAIR_NUMBER( attributes );
+
+    sequence += ( attributes & A_BOLD ) ? ";1" : "";
+    sequence += ( attributes & A_DIM ) ? ";2" : "";
+    sequence += ( attributes & A_UNDERLINE ) ? ";4" : "";
+    sequence += ( attributes & A_BLINK ) ? ";5" : "";
+    sequence += ( attributes & ( A_REVERSE | A_STANDOUT ) ) ? ";7" : "";
+    if ( pair > 0 && pair < MAX_COLOUR_PAIRS )
+    {
+        short ink   = m_pairInk[pair];
+        short paper = m_pairPaper[pair];
+        if ( ink >= 0 )
+        {
+            sequence += ( ink < 8 ) ? ";3" + std::to_string( ink ) : ";38;5;" + std::to_string( ink );
+        }
+        if ( paper >= 0 )
+        {
+            sequence += ( paper < 8 ) ? ";4" + std::to_string( paper ) : ";48;5;" + std::to_string( paper );
+        }
+    }
+    m_frame += sequence + "m";
+    m_attributes = attributes;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// Curses calls
+//-----------------------------------------------------------------------------
+
+using Nimble::HeadlessScreen;
+
+/**-----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      marks columns of a window line changed
+    @param      win     window
+    @param      y       window line
+    @param      first   first column changed
+    @param      last    last column changed
+    @return     void
+------------------------------------------------------------------------------*/
+static void markChanged( WINDOW* win, int y, int first, int last )
+{
+    ldat& record = win->_line[y];
+    if ( record.firstchar == HeadlessScreen::NO_CHANGE || first < record.firstchar )
+    {
+        record.firstchar = (NCURSES_SIZE_T)first;
+    }
+    if ( last > record.lastchar )
+    {
+        record.lastchar = (NCURSES_SIZE_T)last;
+    }
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      gives a character the window attributes, colour and
+                background the way curses does when it is written
+    @param      win     window
+    @param      ch      character, with any attributes of its own
+    @return     chtype  cell
+------------------------------------------------------------------------------*/
+static chtype renderChar( WINDOW* win, chtype ch )
+{
+    chtype cell = ch | ( win->_attrs & ~A_COLOR );
+
+    if ( ( cell & A_COLOR ) == 0 )
+    {
+        cell |= ( win->_attrs & A_COLOR ) ? ( win->_attrs & A_COLOR ) : ( win->_bkgd & A_COLOR );
+    }
+    return cell | ( win->_bkgd & A_ATTRIBUTES & ~A_COLOR );
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      gets the blank cell of a window
+    @param      win     window
+    @return     chtype  background character and attributes
+------------------------------------------------------------------------------*/
+static chtype blankChar( WINDOW* win )
+{
+    chtype blank = win->_bkgd;
+    return ( blank & A_CHARTEXT ) ? blank : ( blank | ' ' );
+}
+
+extern "C"
+{
+
+// screen ----------------------------------------------------------------------
+
+WINDOW* stdscr      = nullptr;
+int     LINES       = 0;
+int     COLS        = 0;
+int     COLORS      = 0;
+int     COLOR_PAIRS = 0;
+chtype  acs_map[128];
+
+WINDOW*( initscr )( void )
+{
+    return HeadlessScreen::getInstance().createScreen();
+}
+
+int( endwin )( void )
+{
+    return OK;
+}
+
+int( cbreak )( void )
+{
+    return OK;
+}
+
+int( noecho )( void )
+{
+    return OK;
+}
+
+int( start_color )( void )
+{
+    return OK;
+}
+
+int( curs_set )( int visibility )
+{
+    return HeadlessScreen::getInstance().setCursorVisibility( visibility );
+}
+
+int( init_pair )( NCURSES_PAIRS_T pair, NCURSES_COLOR_T ink, NCURSES_COLOR_T paper )
+{
+    return HeadlessScreen::getInstance().setColourPair( pair, ink, paper ) ? OK : ERR;
+}
+
+// windows ---------------------------------------------------------------------
+
+WINDOW*( subwin )( WINDOW* parent, int lines, int columns, int y, int x )
+{
+    return parent ? HeadlessScreen::getInstance().createWindow( parent, lines, columns, y, x ) : nullptr;
+}
+
+int( delwin )( WINDOW* win )
+{
+    return HeadlessScreen::getInstance().deleteWindow( win ) ? OK : ERR;
+}
+
+int( mvwin )( WINDOW* win, int y, int x )
+{
+    WINDOW* parent = win ? win->_parent : nullptr;
+    int     top    = parent ? parent->_begy : 0;
+    int     left   = parent ? parent->_begx : 0;
+    int     bottom = parent ? top + parent->_maxy + 1 : LINES;
+    int     right  = parent ? left + parent->_maxx + 1 : COLS;
+
+    if ( win == nullptr || y < top || x < left || y + win->_maxy + 1 > bottom || x + win->_maxx + 1 > right )
+    {
+        return ERR;
+    }
+
+    // a sub-window moved shows the parent's cells at its new place
+    win->_begy = (NCURSES_SIZE_T)y;
+    win->_begx = (NCURSES_SIZE_T)x;
+    if ( parent != nullptr )
+    {
+        win->_pary = y - top;
+        win->_parx = x - left;
+        for ( int line = 0; line <= win->_maxy; line++ )
+        {
+            win->_line[line].text = parent->_line[win->_pary + line].text + win->_parx;
+        }
+    }
+    return wtouchln( win, 0, win->_maxy + 1, 1 );
+}
+
+int( wtouchln )( WINDOW* win, int y, int lines, int changed )
+{
+    if ( win == nullptr || y < 0 || y > win->_maxy )
+    {
+        return ERR;
+    }
+    for ( int line = y; line < y + lines && line <= win->_maxy; line++ )
+    {
+        win->_line[line].firstchar = (NCURSES_SIZE_T)( changed ? 0 : HeadlessScreen::NO_CHANGE );
+        win->_line[line].lastchar  = (NCURSES_SIZE_T)( changed ? win->_maxx : HeadlessScreen::NO_CHANGE );
+    }
+    return OK;
+}
+
+int( wnoutrefresh )( WINDOW* win )
+{
+    if ( win == nullptr )
+    {
+        return ERR;
+    }
+    HeadlessScreen::getInstance().copyWindow( win );
+    return OK;
+}
+
+int( doupdate )( void )
+{
+    HeadlessScreen::getInstance().update();
+    return OK;
+}
+
+int( refresh )( void )
+{
+    if ( stdscr == nullptr )
+    {
+        return ERR;
+    }
+    wnoutrefresh( stdscr );
+    return doupdate();
+}
+
+// attributes ------------------------------------------------------------------
+
+int( wattr_on )( WINDOW* win, attr_t attributes, void* )
+{
+    if ( win == nullptr )
+    {
+        return ERR;
+    }
+    if ( attributes & A_COLOR )
+    {
+        win->_attrs &= ~A_COLOR;
+    }
+    win->_attrs |= attributes;
+    return OK;
+}
+
+int( wattr_off )( WINDOW* win, attr_t attributes, void* )
+{
+    if ( win == nullptr )
+    {
+        return ERR;
+    }
+    if ( attributes & A_COLOR )
+    {
+        win->_attrs &= ~A_COLOR;
+    }
+    win->_attrs &= ~( attributes & ~A_COLOR );
+    return OK;
+}
+
+int( wattrset )( WINDOW* win, int attributes )
+{
+    if ( win == nullptr )
+    {
+        return ERR;
+    }
+    win->_attrs = (attr_t)attributes;
+    return OK;
+}
+
+int( wbkgd )( WINDOW* win, chtype background )
+{
+    if ( win == nullptr )
+    {
+        return ERR;
+    }
+
+    // cells in the old background take the new one
+    chtype oldBlank = blankChar( win );
+    chtype oldAttrs = win->_bkgd & A_ATTRIBUTES;
+    chtype newAttrs = background & A_ATTRIBUTES;
+    win->_bkgd      = background;
+    chtype newBlank = blankChar( win );
+    for ( int line = 0; line <= win->_maxy; line++ )
+    {
+        chtype* text = win->_line[line].text;
+        for ( int column = 0; column <= win->_maxx; column++ )
+        {
+            chtype cell = text[column];
+            if ( ( cell & A_CHARTEXT ) == ( oldBlank & A_CHARTEXT ) )
+            {
+                cell = ( cell & A_ATTRIBUTES ) | ( newBlank & A_CHARTEXT );
+            }
+            if ( ( cell & A_COLOR ) == ( oldAttrs & A_COLOR ) )
+            {
+                cell = ( cell & ~A_COLOR ) | ( newAttrs & A_COLOR );
+            }
+            text[column] = ( cell & ~( oldAttrs & ~A_COLOR ) ) | ( newAttrs & ~A_COLOR );
+        }
+    }
+    win->_attrs = ( win->_attrs & ~oldAttrs ) | newAttrs;
+    return wtouchln( win, 0, win->_maxy + 1, 1 );
+}
+
+int( wchgat )( WINDOW* win, int length, attr_t attributes, NCURSES_PAIRS_T pair, const void* )
+{
+    if ( win == nullptr )
+    {
+        return ERR;
+    }
+    chtype* text = win->_line[win->_cury].text;
+    int     last = ( length < 0 ) ? win->_maxx : std::min<int>( win->_maxx, win->_curx + length - 1 );
+    for ( int column = win->_curx; column <= last; column++ )
+    {
+        text[column] = ( text[column] & A_CHARTEXT ) | ( attributes & ~A_COLOR ) | COLOR_PAIR( pair );
+    }
+    if ( last >= win->_curx )
+    {
+        markChanged( win, win->_cury, win->_curx, last );
+    }
+    return OK;
+}
+
+// output ----------------------------------------------------------------------
+
+int( wmove )( WINDOW* win, int y, int x )
+{
+    if ( win == nullptr || y < 0 || x < 0 || y > win->_maxy || x > win->_maxx )
+    {
+        return ERR;
+    }
+    win->_cury = (NCURSES_SIZE_T)y;
+    win->_curx = (NCURSES_SIZE_T)x;
+    return OK;
+}
+
+int( waddnstr )( WINDOW* win, const char* text, int length )
+{
+    if ( win == nullptr || text == nullptr )
+    {
+        return ERR;
+    }
+
+    size_t count = ( length < 0 ) ? strlen( text ) : strnlen( text, (size_t)length );
+    for ( size_t index = 0; index < count; index++ )
+    {
+        unsigned char ch = (unsigned char)text[index];
+        int           y  = win->_cury;
+        int           x  = win->_curx;
+
+        if ( ch == '\n' )
+        {
+            // clear to the end of the line, then start the next
+            for ( int column = x; column <= win->_maxx; column++ )
+            {
+                win->_line[y].text[column] = blankChar( win );
+            }
+            markChanged( win, y, x, win->_maxx );
+            if ( y == win->_maxy )
+            {
+                return ERR;
+            }
+            win->_cury++;
+            win->_curx = 0;
+            continue;
+        }
+        if ( ch == '\r' )
+        {
+            win->_curx = 0;
+            continue;
+        }
+
+        int    cells = ( ch == '\t' ) ? 8 - ( x % 8 ) : 1;
+        chtype cell  = renderChar( win, ( ch == '\t' ) ? ' ' : ch );
+        for ( int fill = 0; fill < cells; fill++ )
+        {
+            win->_line[win->_cury].text[win->_curx] = cell;
+            markChanged( win, win->_cury, win->_curx, win->_curx );
+            if ( win->_curx < win->_maxx )
+            {
+                win->_curx++;
+            }
+            else if ( win->_cury < win->_maxy )
+            {
+                win->_cury++;
+                win->_curx = 0;
+            }
+            else
+            {
+                // past the bottom right, curses does not scroll here
+                return ERR;
+            }
+        }
+    }
+    return OK;
+}
+
+int( mvwprintw )( WINDOW* win, int y, int x, const char* format, ... )
+{
+    if ( wmove( win, y, x ) == ERR )
+    {
+        return ERR;
+    }
+
+    va_list arguments;
+    va_start( arguments, format );
+    va_list copy;
+    va_copy( copy, arguments );
+    int length = vsnprintf( nullptr, 0, format, copy );
+    va_end( copy );
+    std::string text( length > 0 ? (size_t)length : 0, '\0' );
+    vsnprintf( text.data(), text.size() + 1, format, arguments );
+    va_end( arguments );
+    return waddnstr( win, text.c_str(), -1 );
+}
+
+int( werase )( WINDOW* win )
+{
+    if ( win == nullptr )
+    {
+        return ERR;
+    }
+    for ( int line = 0; line <= win->_maxy; line++ )
+    {
+        std::fill( win->_line[line].text, win->_line[line].text + win->_maxx + 1, blankChar( win ) );
+    }
+    win->_cury = 0;
+    win->_curx = 0;
+    return wtouchln( win, 0, win->_maxy + 1, 1 );
+}
+
+int( wdelch )( WINDOW* win )
+{
+    if ( win == nullptr )
+    {
+        return ERR;
+    }
+    chtype* text = win->_line[win->_cury].text;
+    std::move( text + win->_curx + 1, text + win->_maxx + 1, text + win->_curx );
+    text[win->_maxx] = blankChar( win );
+    markChanged( win, win->_cury, win->_curx, win->_maxx );
+    return OK;
+}
+
+int( whline )( WINDOW* win, chtype ch, int length )
+{
+    if ( win == nullptr )
+    {
+        return ERR;
+    }
+    chtype cell = renderChar( win, ( ch & A_CHARTEXT ) ? ch : ACS_HLINE );
+    int    last = std::min<int>( win->_maxx, win->_curx + length - 1 );
+    for ( int column = win->_curx; column <= last; column++ )
+    {
+        win->_line[win->_cury].text[column] = cell;
+    }
+    if ( last >= win->_curx )
+    {
+        markChanged( win, win->_cury, win->_curx, last );
+    }
+    return OK;
+}
+
+int( wvline )( WINDOW* win, chtype ch, int length )
+{
+    if ( win == nullptr )
+    {
+        return ERR;
+    }
+    chtype cell = renderChar( win, ( ch & A_CHARTEXT ) ? ch : ACS_VLINE );
+    int    last = std::min<int>( win->_maxy, win->_cury + length - 1 );
+    for ( int line = win->_cury; line <= last; line++ )
+    {
+        win->_line[line].text[win->_curx] = cell;
+        markChanged( win, line, win->_curx, win->_curx );
+    }
+    return OK;
+}
+
+int( box )( WINDOW* win, chtype vertical, chtype horizontal )
+{
+    if ( win == nullptr )
+    {
+        return ERR;
+    }
+    chtype across = renderChar( win, ( horizontal & A_CHARTEXT ) ? horizontal : ACS_HLINE );
+    chtype down   = renderChar( win, ( vertical & A_CHARTEXT ) ? vertical : ACS_VLINE );
+    int    bottom = win->_maxy;
+    int    right  = win->_maxx;
+    for ( int column = 1; column < right; column++ )
+    {
+        win->_line[0].text[column]      = across;
+        win->_line[bottom].text[column] = across;
+    }
+    for ( int line = 1; line < bottom; line++ )
+    {
+        win->_line[line].text[0]     = down;
+        win->_line[line].text[right] = down;
+        markChanged( win, line, 0, 0 );
+        markChanged( win, line, right, right );
+    }
+    win->_line[0].text[0]          = renderChar( win, ACS_ULCORNER );
+    win->_line[0].text[right]      = renderChar( win, ACS_URCORNER );
+    win->_line[bottom].text[0]     = renderChar( win, ACS_LLCORNER );
+    win->_line[bottom].text[right] = renderChar( win, ACS_LRCORNER );
+    markChanged( win, 0, 0, right );
+    markChanged( win, bottom, 0, right );
+    return OK;
+}
+
+// input -----------------------------------------------------------------------
+
+int( keypad )( WINDOW* win, bool enable )
+{
+    if ( win == nullptr )
+    {
+        return ERR;
+    }
+    win->_use_keypad = enable;
+    return OK;
+}
+
+int( nodelay )( WINDOW* win, bool enable )
+{
+    if ( win == nullptr )
+    {
+        return ERR;
+    }
+    win->_delay = enable ? 0 : -1;
+    return OK;
+}
+
+int( wgetch )( WINDOW* )
+{
+    return HeadlessScreen::getInstance().readKey();
+}
+
+mmask_t( mousemask )( mmask_t mask, mmask_t* oldMask )
+{
+    mmask_t before = HeadlessScreen::getInstance().setMouseMask( mask );
+    if ( oldMask != nullptr )
+    {
+        *oldMask = before;
+    }
+    return mask;
+}
+
+int( getmouse )( MEVENT* )
+{
+    return ERR;
+}
+
+} // extern "C"
+
+//-----------------------------------------------------------------------------
+// End of file: HeadlessScreen.cpp
+//-----------------------------------------------------------------------------
@@ -0,0 +1,243 @@
+/**----------------------------------------------------------------------------
+
+    @file       KeyTrace.cpp
+    @defgroup   BenchNimbleLIB Bench Nimble LIB
+    @brief      Keystroke traces replayed by the Nimble LIB benchmarks
+
+    @copyright  Neil Beresford 2023
+
+Notes:
+
+    A trace is a list of frames, each frame the keys the editor handles
+    between two screen updates. A trace file holds one frame per line, the
+    operation name first and then the key codes in decimal,
+
+        typing 105 110 116
+        paging 338
+        # lines starting with a hash are comments
+
+    NimbleIDE --record <file> writes the keys it handles in this form, as
+    operation "recorded", so a session can be replayed by the benchmark.
+
+    The generated traces cover typing a key per frame, paging through the
+    file, a paste arriving as one frame of keys and stepping through the
+    matches of a search.
+
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include "../inc/KeyTrace.h"
+#include <fstream>
+#include <sstream>
+
+//-----------------------------------------------------------------------------
+// Namespace
+//-----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Local data
+//-----------------------------------------------------------------------------
+
+static const int KEY_PAGE_DOWN = 338; //!< curses KEY_NPAGE
+static const int KEY_PAGE_UP   = 339; //!< curses KEY_PPAGE
+static const int KEY_FIND      = 6;   //!< Ctrl+F, find the word under the cursor
+static const int KEY_FIND_NEXT = 7;   //!< Ctrl+G
+static const int KEY_FIND_PREV = 18;  //!< Ctrl+R
+
+//-----------------------------------------------------------------------------
+// Class definitions
+//-----------------------------------------------------------------------------
+
+// file ------------------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      adds the frames of a trace file
+    @param      fileName    trace file
+    @return     bool        false if the file could not be read or a line is
+                            not an operation followed by key codes
+------------------------------------------------------------------------------*/
+bool KeyTrace::load( const std::string& fileName )
+{
+    std::ifstream file( fileName );
+    std::string   line;
+
+    if ( !file )
+    {
+        return false;
+    }
+    while ( std::getline( file, line ) )
+    {
+        std::istringstream stream( line );
+        std::string        operation;
+        std::vector<int>   keys;
+        int                key = 0;
+
+        if ( !( stream >> operation ) || operation[0] == '#' )
+        {
+            continue;
+        }
+        while ( stream >> key )
+        {
+            keys.push_back( key );
+        }
+        if ( !stream.eof() )
+        {
+            return false;
+        }
+        addFrame( operation, keys );
+    }
+    return true;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      writes the trace as a trace file
+    @param      fileName    trace file
+    @return     bool        false if the file could not be written
+------------------------------------------------------------------------------*/
+bool KeyTrace::save( const std::string& fileName ) const
+{
+    std::ofstream file( fileName );
+
+    for ( const KeyFrame& frame : m_frames )
+    {
+        file << frame.operation;
+        for ( int key : frame.keys )
+        {
+            file << ' ' << key;
+        }
+        file << '\n';
+    }
+    return file.good();
+}
+
+// building --------------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      adds a frame
+    @param      operation   operation the frame is reported under
+    @param      keys        keys handled in the frame
+    @return     void
+------------------------------------------------------------------------------*/
+void KeyTrace::addFrame( const std::string& operation, const std::vector<int>& keys )
+{
+    m_frames.push_back( { operation, keys } );
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      adds text typed a key at a time, a frame per key
+    @param      text    text typed, '\n' is the enter key
+    @return     void
+------------------------------------------------------------------------------*/
+void KeyTrace::addTyping( const std::string& text )
+{
+    for ( char ch : text )
+    {
+        addFrame( "typing", { (unsigned char)ch } );
+    }
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      adds paging down through the file and back up again
+    @param      pages   pages each way
+    @return     void
+------------------------------------------------------------------------------*/
+void KeyTrace::addPaging( uint32_t pages )
+{
+    for ( uint32_t page = 0; page < pages * 2; page++ )
+    {
+        addFrame( "paging", { ( page < pages ) ? KEY_PAGE_DOWN : KEY_PAGE_UP } );
+    }
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      adds pastes, each arriving as one frame of keys the way a
+                terminal delivers them
+    @param      text        text pasted
+    @param      pastes      times the text is pasted
+    @param      bracketed   true to wrap the text in the bracketed paste
+                            sequences, operation "paste", otherwise the keys
+                            arrive bare, operation "rawpaste"
+    @return     void
+------------------------------------------------------------------------------*/
+void KeyTrace::addPaste( const std::string& text, uint32_t pastes, bool bracketed )
+{
+    std::vector<int> keys( text.begin(), text.end() );
+
+    if ( bracketed )
+    {
+        keys.insert( keys.begin(), { 27, '[', '2', '0', '0', '~' } );
+        keys.insert( keys.end(), { 27, '[', '2', '0', '1', '~' } );
+    }
+    for ( uint32_t paste = 0; paste < pastes; paste++ )
+    {
+        addFrame( bracketed ? "paste" : "rawpaste", keys );
+    }
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      adds a search for the word under the cursor, then steps
+                forward through the matches and back again
+    @param      placeCursor keys moving the cursor onto the word
+    @param      matches     matches stepped through each way
+    @return     void
+------------------------------------------------------------------------------*/
+void KeyTrace::addSearch( const std::vector<int>& placeCursor, uint32_t matches )
+{
+    std::vector<int> keys = placeCursor;
+
+    keys.push_back( KEY_FIND );
+    addFrame( "search", keys );
+    for ( uint32_t match = 0; match < matches * 2; match++ )
+    {
+        addFrame( "search", { ( match < matches ) ? KEY_FIND_NEXT : KEY_FIND_PREV } );
+    }
+}
+
+// getters ---------------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      gets the frames
+    @return     const std::vector<KeyFrame>&    frames in replay order
+------------------------------------------------------------------------------*/
+const std::vector<KeyFrame>& KeyTrace::getFrames() const
+{
+    return m_frames;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      gets the number of keys in every frame
+    @return     uint64_t    keys
+------------------------------------------------------------------------------*/
+uint64_t KeyTrace::getKeyCount() const
+{
+    uint64_t count = 0;
+
+    for ( const KeyFrame& frame : m_frames )
+    {
+        count += frame.keys.size();
+    }
+    return count;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: KeyTrace.cpp
+//-----------------------------------------------------------------------------
@@ -0,0 +1,126 @@
+/**----------------------------------------------------------------------------
+
+    @file       QuickOpenBench.cpp
+    @defgroup   BenchNimbleLIB Bench Nimble LIB
+    @brief      Quick open filter benchmark for the Nimble LIB
+
+    @copyright  Neil Beresford 2023
+
+Notes:
+
+    Times the IDEFuzzyFilter of the quick open palette on the paths of a
+    generated project, a query typed a key at a time then taken off again
+    with backspace, the way the palette filters on each key. Each key is
+    filtered on one thread and on the pool, and the time of each reported
+    against the frame budget of FRAME_BUDGET_MS. Matches on the pool that
+    differ from those on one thread are reported as a failure.
+
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include "../inc/QuickOpenBench.h"
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "../../NimbleLIB/inc/Modules/IDE/IDEFuzzyFilter.h"
+
+//-----------------------------------------------------------------------------
+// Namespace
+//-----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+
+#define FRAME_BUDGET_MS ( 16.0 ) /* a key must be filtered within a frame */
+
+//-----------------------------------------------------------------------------
+// Local functions
+//-----------------------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      times the filter of one key
+    @param      filter      filter
+    @param      query       query typed so far
+    @return     double      milliseconds
+------------------------------------------------------------------------------*/
+static double timeFilter( IDEFuzzyFilter& filter, const std::string& query )
+{
+    auto start = std::chrono::steady_clock::now();
+    filter.filter( query );
+    return std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+}
+
+//-----------------------------------------------------------------------------
+// External functions
+//-----------------------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      reports the time the filter takes for each key of a query
+    @param      files       paths in the generated project
+    @return     bool        false if the pool matched differently
+------------------------------------------------------------------------------*/
+bool benchQuickOpen( uint32_t files )
+{
+    IDEFuzzyFilter           single;
+    IDEFuzzyFilter           pooled;
+    std::string              query = "modsubfile12cp";
+    std::vector<std::string> typed;
+    bool                     passed = true;
+    double                   worst  = 0.0;
+
+    for ( uint32_t index = 0; index < files; index++ )
+    {
+        std::string path = "src/module" + std::to_string( index % 97 ) + "/sub" + std::to_string( index % 13 ) + "/File_" + std::to_string( index ) + ( ( index & 1 ) ? ".cpp" : ".h" );
+        single.addItem( path );
+        pooled.addItem( path );
+    }
+    single.setParallelThreshold( 0xFFFFFFFF );
+
+    // typed a key at a time, then taken off again
+    for ( size_t length = 1; length <= query.size(); length++ )
+    {
+        typed.push_back( query.substr( 0, length ) );
+    }
+    for ( size_t length = query.size() - 1; length > 0; length-- )
+    {
+        typed.push_back( query.substr( 0, length ) );
+    }
+
+    printf( "quick open, %u files, frame budget %.0f ms\n", files, FRAME_BUDGET_MS );
+    printf( "%-16s %10s %12s %12s\n", "query", "matches", "single ms", "pool ms" );
+    for ( const std::string& keys : typed )
+    {
+        double singleTime = timeFilter( single, keys );
+        double pooledTime = timeFilter( pooled, keys );
+
+        bool same = single.getMatches().size() == pooled.getMatches().size();
+        for ( size_t index = 0; same && index < single.getMatches().size(); index++ )
+        {
+            same = single.getMatches()[index].item == pooled.getMatches()[index].item && single.getMatches()[index].score == pooled.getMatches()[index].score;
+        }
+        printf( "%-16s %10zu %12.2f %12.2f%s%s\n", keys.c_str(), pooled.getMatches().size(), singleTime, pooledTime, ( pooledTime > FRAME_BUDGET_MS ) ? " OVER" : "",
+                same ? "" : " FAIL" );
+        passed &= same;
+        worst = ( pooledTime > worst ) ? pooledTime : worst;
+    }
+    printf( "slowest key on the pool %.2f ms\n", worst );
+    return passed;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: QuickOpenBench.cpp
+//-----------------------------------------------------------------------------
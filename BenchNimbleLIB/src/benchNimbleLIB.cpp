@@ -0,0 +1,340 @@
+/**----------------------------------------------------------------------------
+
+    @file       benchNimbleLIB.cpp
+    @defgroup   BenchNimbleLIB Bench Nimble LIB
+    @brief      Editor benchmarks for the Nimble LIB
+
+    @copyright  Neil Beresford 2023
+
+Notes:
+
+    Replays keystroke traces against the editor windows on the headless
+    screen and reports, for each operation, the latency of a frame and the
+    bytes the frame sent to the terminal.
+
+        BenchNimbleLIB [--trace <file>] [--size <columns> <lines>]
+                       [--profile <file>] [file...]
+        BenchNimbleLIB --crc [megabytes]
+        BenchNimbleLIB --quickopen [files]
+
+    Each file named is opened in the editor and the trace replayed against
+    it. Without a file a generated C++ source is used. Without --trace the
+    generated traces are replayed, typing, paging, a large paste, bracketed
+    and bare, and a search. The documents are never saved.
+
+    A frame is handled the way the NimbleIDE main loop handles it, every
+    key waiting is read by CursesInput, typed text and pastes are passed
+    to the editor as single inserts, then the windows changed are drawn
+    and sent in one update. The latency is the
+    time from the first key being read to the update being sent.
+
+    --profile enables the Profiler for the replay, prints the zones that
+    took longest for each file and writes the zones recorded to the file
+    as a Chrome trace.
+
+    --crc times the CRC engine against the bitwise CRC-16 on a buffer of
+    the size given, 64MB by default, and exits, please see CrcBench.cpp.
+
+    --quickopen times the quick open filter on each key of a query, on the
+    paths of a generated project of the size given, 200000 files by
+    default, and exits, please see QuickOpenBench.cpp.
+
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../inc/CrcBench.h"
+#include "../inc/HeadlessScreen.h"
+#include "../inc/KeyTrace.h"
+#include "../inc/QuickOpenBench.h"
+#include "../../NimbleLIB/inc/NimbleLib.h"
+
+//-----------------------------------------------------------------------------
+// Namespace access
+//-----------------------------------------------------------------------------
+
+using namespace Nimble;
+using namespace Nimble::Screen;
+
+//-----------------------------------------------------------------------------
+// Typedefs, enums and structs
+//-----------------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      Measurements of the frames of one operation
+-----------------------------------------------------------------------------*/
+typedef struct
+{
+    std::vector<double>   latency; //!< microseconds per frame
+    std::vector<uint64_t> bytes;   //!< bytes sent per frame
+    uint64_t              keys;    //!< keys handled
+
+} TS_OPERATION_STATS;
+
+//-----------------------------------------------------------------------------
+// Local functions
+//-----------------------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      gets a percentile of a list of samples
+    @param      samples     samples, sorted in place
+    @param      percent     percentile wanted, 0 to 100
+    @return     T           sample at the percentile
+------------------------------------------------------------------------------*/
+template <typename T> static T percentile( std::vector<T>& samples, double percent )
+{
+    if ( samples.empty() )
+    {
+        return T();
+    }
+    std::sort( samples.begin(), samples.end() );
+    size_t index = (size_t)( percent / 100.0 * ( samples.size() - 1 ) + 0.5 );
+    return samples[index];
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      writes a C++ source to benchmark against
+    @param      fileName    file to write
+    @param      functions   functions in the file, 10 lines each
+    @return     bool        false if the file could not be written
+------------------------------------------------------------------------------*/
+static bool writeSource( const std::string& fileName, uint32_t functions )
+{
+    std::ofstream file( fileName );
+
+    file << "// generated by BenchNimbleLIB\n#include <cstdint>\n\n";
+    for ( uint32_t function = 0; function < functions; function++ )
+    {
+        file << "uint32_t value" << function << "( uint32_t count )\n{\n";
+        file << "    uint32_t total = 0; /* running total */\n";
+        file << "    for ( uint32_t index = 0; index < count; index++ )\n    {\n";
+        file << "        total += index * " << function << ";\n    }\n";
+        file << "    return total;\n}\n\n";
+    }
+    return file.good();
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    BenchNimbleLIB Bench Nimble LIB
+    @brief      builds the generated traces
+    @return     KeyTrace    typing, paging, paste and search
+------------------------------------------------------------------------------*/
+static KeyTrace buildTrace()
+{
+    KeyTrace    trace;
+    std::string paste;
+
+    for ( uint32_t line = 0; line < 100; line++ )
+    {
+        paste += "    total += lookup[ " + std::to_string( line ) + " ] * scale;\n";
+    }
+    for ( uint32_t repeat = 0; repeat < 20; repeat++ )
+    {
+        trace.addTyping( "    total = ( total << 1 ) ^ count;\n" );
+    }
+    trace.addPaging( 200 );
+    trace.addPaste( paste, 10 );
+    trace.addPaste( paste, 10, false );
+
+    // the cursor is left below the pasted lines, the search is for "lookup"
+    trace.addSearch( { KEY_UP, KEY_HOME, KEY_RIGHT, KEY_RIGHT, KEY_RIGHT, KEY_RIGHT, KEY_RIGHT, KEY_RIGHT, KEY_RIGHT, KEY_RIGHT, KEY_RIGHT, KEY_RIGHT, KEY_RIGHT, KEY_RIGHT, KEY_RIGHT, KEY_RIGHT, KEY_RIGHT }, 200 );
+    return trace;
+}
+
+//-----------------------------------------------------------------------------
+// External Functionality
+//-----------------------------------------------------------------------------
+
+int main( int argc, char* argv[] )
+{
+    HeadlessScreen&          screen = HeadlessScreen::getInstance();
+    CursesInput              input;
+    KeyTrace                 trace;
+    std::vector<std::string> files;
+    bool                     traceLoaded = false;
+    std::string              sourceFile;
+    std::string              profileFile;
+
+    // arguments
+    for ( int arg = 1; arg < argc; arg++ )
+    {
+        std::string argument = argv[arg];
+        if ( argument == "--trace" && arg + 1 < argc )
+        {
+            if ( trace.load( argv[++arg] ) == false )
+            {
+                fprintf( stderr, "BenchNimbleLIB : cannot read trace %s\n", argv[arg] );
+                return EXIT_FAILURE;
+            }
+            traceLoaded = true;
+        }
+        else if ( argument == "--crc" )
+        {
+            uint32_t megabytes = ( arg + 1 < argc ) ? (uint32_t)atoi( argv[arg + 1] ) : 0;
+            return benchCrc( megabytes ? megabytes : 64 ) ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+        else if ( argument == "--quickopen" )
+        {
+            uint32_t count = ( arg + 1 < argc ) ? (uint32_t)atoi( argv[arg + 1] ) : 0;
+            return benchQuickOpen( count ? count : 200000 ) ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+        else if ( argument == "--profile" && arg + 1 < argc )
+        {
+            profileFile = argv[++arg];
+        }
+        else if ( argument == "--size" && arg + 2 < argc )
+        {
+            screen.setScreenSize( atoi( argv[arg + 1] ), atoi( argv[arg + 2] ) );
+            arg += 2;
+        }
+        else
+        {
+            files.push_back( argument );
+        }
+    }
+    if ( traceLoaded == false )
+    {
+        trace = buildTrace();
+    }
+    if ( files.empty() )
+    {
+        sourceFile = ( std::filesystem::temp_directory_path() / "BenchNimbleLIB.cpp" ).string();
+        if ( writeSource( sourceFile, 2000 ) == false )
+        {
+            fprintf( stderr, "BenchNimbleLIB : cannot write %s\n", sourceFile.c_str() );
+            return EXIT_FAILURE;
+        }
+        files.push_back( sourceFile );
+    }
+
+    // the screen is set up the way NimbleIDE sets it up
+    initscr();
+    keypad( stdscr, TRUE );
+    nodelay( stdscr, TRUE );
+    noecho();
+    curs_set( 0 );
+    CursesColour::getInstance().init();
+
+    printf( "%-24s %-10s %7s %8s %10s %10s %10s %10s %12s %10s %10s\n", "file", "operation", "frames", "keys", "p50 us", "p90 us", "p99 us", "max us", "bytes/frame", "p99 bytes", "max bytes" );
+    for ( std::string& fileName : files )
+    {
+        IDEEditor            winEditor;
+        EditorStatusWin      winEditorStatus;
+        EditorLineNumbersWin winLineNumbers;
+
+        winEditor.init( COLS - 39, LINES - 9, 9, 4 );
+        if ( winEditor.start( fileName ) != LibraryError::No_Error )
+        {
+            fprintf( stderr, "BenchNimbleLIB : cannot open %s\n", fileName.c_str() );
+            continue;
+        }
+        while ( winEditor.isLoading() )
+        {
+            winEditor.processLoad();
+        }
+        winEditorStatus.setIDEEditor( &winEditor );
+        winLineNumbers.setIDEEditor( &winEditor );
+
+        // the first frame sends the whole screen, it is not measured
+        CursesWin::beginFrame();
+        winEditorStatus.display();
+        winLineNumbers.display();
+        winEditor.displayEditor();
+        CursesWin::endFrame();
+
+        std::map<std::string, TS_OPERATION_STATS> stats;
+        std::vector<std::string>                   order;
+        Profiler::getInstance().setEnabled( profileFile.empty() == false );
+        for ( const KeyFrame& frame : trace.getFrames() )
+        {
+            screen.pushKeys( frame.keys );
+            auto start = std::chrono::steady_clock::now();
+
+            CursesWin::beginFrame();
+            bool editorChanged = false;
+            for ( const CursesInput::InputEvent& event : input.pump() )
+            {
+                if ( event.type == CursesInput::EventType::Key )
+                {
+                    editorChanged |= winEditor.processKeyEdit( event.key );
+                }
+                else
+                {
+                    editorChanged |= winEditor.processText( event.text, event.type == CursesInput::EventType::Paste );
+                }
+            }
+            if ( editorChanged )
+            {
+                winEditor.displayEditor();
+                winLineNumbers.display();
+            }
+            winEditorStatus.display();
+            winEditor.processDisplay();
+            CursesWin::endFrame();
+
+            auto end = std::chrono::steady_clock::now();
+            if ( stats.count( frame.operation ) == 0 )
+            {
+                order.push_back( frame.operation );
+            }
+            TS_OPERATION_STATS& operation = stats[frame.operation];
+            operation.latency.push_back( std::chrono::duration<double, std::micro>( end - start ).count() );
+            operation.bytes.push_back( screen.getLastFrameBytes() );
+            operation.keys += frame.keys.size();
+        }
+
+        // report, in the order the operations were first replayed
+        std::string shortName = std::filesystem::path( fileName ).filename().string();
+        for ( const std::string& name : order )
+        {
+            TS_OPERATION_STATS& operation = stats[name];
+            uint64_t            total     = 0;
+            for ( uint64_t bytes : operation.bytes )
+            {
+                total += bytes;
+            }
+            printf( "%-24.24s %-10.10s %7zu %8llu %10.1f %10.1f %10.1f %10.1f %12.1f %10llu %10llu\n", shortName.c_str(), name.c_str(), operation.latency.size(), (unsigned long long)operation.keys,
+                    percentile( operation.latency, 50 ), percentile( operation.latency, 90 ), percentile( operation.latency, 99 ), percentile( operation.latency, 100 ),
+                    (double)total / operation.bytes.size(), (unsigned long long)percentile( operation.bytes, 99 ), (unsigned long long)percentile( operation.bytes, 100 ) );
+        }
+        if ( Profiler::isEnabled() )
+        {
+            Profiler::getInstance().setEnabled( false );
+            for ( auto& zone : Profiler::getInstance().getTopZones( 8 ) )
+            {
+                printf( "%-24.24s %-36s %10.1f us/frame\n", shortName.c_str(), zone.first, zone.second / 1e3 / std::clamp<uint64_t>( Profiler::getInstance().getFrameCount(), 1, Profiler::FRAME_HISTORY ) );
+            }
+        }
+    }
+    endwin();
+
+    if ( profileFile.empty() == false && Profiler::getInstance().exportChromeTrace( profileFile ) == false )
+    {
+        fprintf( stderr, "BenchNimbleLIB : cannot write %s\n", profileFile.c_str() );
+    }
+
+    if ( sourceFile.empty() == false )
+    {
+        std::filesystem::remove( sourceFile );
+    }
+    return EXIT_SUCCESS;
+}
+
+//-----------------------------------------------------------------------------
+// End of file: benchNimbleLIB.cpp
+//-----------------------------------------------------------------------------
@@ -8,6 +8,34 @@
 
 Notes:
 
+    The main loop is event driven, it sleeps in CursesEventLoop until a key
+    arrives or a timer is due (cursor blink, title clock, dialog frames).
+    Windows are only redrawn when a key or a timer has changed them.
+
+    Every file named on the command line is opened, F4 and F5 switch to the
+    next and previous open file.
+
+    Each frame every key waiting is read by CursesInput. Runs of typed keys
+    and bracketed pastes go to the editor as a single insert, and the
+    editor is drawn once for the whole batch.
+
+    --record <file> writes the keys read in each frame to the file, one
+    frame per line, which BenchNimbleLIB can replay as a trace.
+
+    F6 shows the frame times and the most expensive zones in the status bar,
+    profiling only while they are shown. F7 writes the zones recorded to
+    TRACE_FILE as a Chrome trace.
+
+    F8 searches every file below the current folder for the word at the
+    cursor, on a pool of threads, the lines found are listed in the project
+    window as they arrive while typing carries on.
+
+    F9 opens the quick open palette, listing every file below the current
+    folder, typing narrows the list to the best matches and enter opens
+    the file under the cursor, or switches to it if it is open already.
+    Ctrl+K then Ctrl+O does the same, a chord not finished within
+    CursesKeyBindings::CHORD_TIMEOUT_MS is dropped.
+
 -----------------------------------------------------------------------------*/
 
 //-----------------------------------------------------------------------------
@@ -49,11 +77,15 @@ using namespace Nimble::Screen;
 // Defines
 //-----------------------------------------------------------------------------
 
-#if ( __linux__ )
-#define DELAYSIZE ( 10 )
-#else
-#define DELAYSIZE ( 1 )
-#endif
+#define CURSOR_BLINK_MS  ( 500 )  /* editor cursor flash rate */
+#define CLOCK_UPDATE_MS  ( 1000 ) /* title window clock */
+#define DIALOG_FRAME_MS  ( 40 )   /* dialog frames, only while a dialog is open */
+#define LOAD_POLL_MS     ( 15 )   /* file load, only while a file is being read in */
+#define SEARCH_POLL_MS   ( 50 )   /* project search, only while a search is running */
+#define REPEAT_REPORT_MS ( 5000 ) /* repeats of the last error are logged */
+#define TRACE_FILE       ( "NimbleIDE_trace.json" ) /* F7 Chrome trace export */
+#define CHORD_KEY        ( 11 ) /* Ctrl+K, starts a chord */
+#define QUICK_OPEN_KEY   ( 15 ) /* Ctrl+O, after Ctrl+K opens quick open */
 #define MAX_OPTIONS      ( 7 )
 #define TITLECOLOR       ( 57 ) /* color pair indices */
 #define MAINMENUCOLOR    ( 2 | A_BOLD )
@@ -109,10 +141,30 @@ int main( int argc, char* argv[] )
     EditorLineNumbersWin winLineNumbers;
     IDEManager           dialogManager;
 
-    // setup the editor
+    // setup the editor, every file named is opened, the last is shown
+    std::vector<std::string> filenames;
+    std::ofstream            record;
+    for ( int arg = 1; arg < argc; arg++ )
+    {
+        std::string argument = argv[arg];
+        if ( argument == "--record" && arg + 1 < argc )
+        {
+            record.open( argv[++arg] );
+        }
+        else
+        {
+            filenames.push_back( argument );
+        }
+    }
+    if ( filenames.empty() )
+    {
+        filenames.push_back( "test.txt" );
+    }
     winEditor.init( COLS - 39, LINES - 9, 9, 4 );
-    std::string filename = "test.txt";
-    winEditor.start( filename );
+    for ( std::string& filename : filenames )
+    {
+        winEditor.start( filename );
+    }
 
     // setup the other windoews
     winEditorStatus.setIDEEditor( &winEditor );
@@ -121,81 +173,265 @@ int main( int argc, char* argv[] )
     winEditorHex.setIDEEditor( &winEditor );
     winLineNumbers.setIDEEditor( &winEditor );
 
+    // the first frame, every window is written to the terminal at once
+    CursesWin::beginFrame();
     winEditorStatus.display();
     winEditorProject.display();
     winEditorTitle.display();
     winLineNumbers.display();
     winEditor.displayEditor();
+    CursesWin::endFrame();
 
-    while ( key != 'q' )
+    // redraw every window once a dialog has closed over them
+    auto processDialogs = [ & ]( uint32_t input )
     {
-        bool forceUpdate = false;
-        delay_output( DELAYSIZE );
+        dialogManager.process( input );
+        std::string selected;
+        if ( dialogManager.takeSelectedFile( selected ) )
+        {
+            winEditor.start( selected );
+        }
+        if ( dialogManager.redrawNeeded() )
+        {
+            winEditorStatus.display( true );
+            winEditorProject.display( true );
+            winEditorTitle.display( true );
+            winLineNumbers.display( true );
+            winEditor.redrawBackground();
+            winEditor.displayEditor();
+            dialogManager.clearRedrawNeeded();
+        }
+    };
+
+    // pastes arrive bracketed, so each is inserted as one edit
+    CursesInput input;
+    input.setBracketedPaste( true );
+
+    // chords, the keys are held until the chord is finished or broken
+    CursesKeyboard chords;
+    chords.addChord( "QuickOpen", { CHORD_KEY, QUICK_OPEN_KEY }, [ & ]( uint32_t ) { dialogManager.addControl( ManagerControlID::ID_QuickOpen ); } );
 
-        // display the other windows...
-        winEditorTitle.display();
-        winEditorStatus.display();
-        winEditorProject.display();
+    // timers, the loop sleeps until a key arrives or one of these is due
+    CursesEventLoop events;
+    uint32_t        dialogTimer = events.addTimer( DIALOG_FRAME_MS, [ & ]() { processDialogs( ERR ); }, false );
+    uint32_t        loadTimer   = events.addTimer( LOAD_POLL_MS,
+                                                   [ & ]()
+                                                   {
+                                                       // lines read in so far are shown as they arrive
+                                                       if ( winEditor.processLoad() == true && bHexWindow == false && dialogManager.areControlsActive() == false )
+                                                       {
+                                                           winEditor.displayEditor();
+                                                           winLineNumbers.display();
+                                                       }
+                                                       winEditorStatus.display();
+                                                   },
+                                                   winEditor.isLoading() );
+    uint32_t searchTimer = events.addTimer( SEARCH_POLL_MS,
+                                            [ & ]()
+                                            {
+                                                if ( winEditorProject.processSearch() == true )
+                                                {
+                                                    winEditorProject.display();
+                                                }
+                                            },
+                                            false );
+    // wakes the loop to pass on an escape key held for the rest of a sequence
+    uint32_t escapeTimer = events.addTimer( CursesInput::ESCAPE_TIMEOUT_MS, []() {}, false );
+    // drops a chord not finished in time
+    uint32_t chordTimer = events.addTimer( CursesKeyBindings::CHORD_TIMEOUT_MS,
+                                           [ & ]()
+                                           {
+                                               chords.setKey( 0 );
+                                               chords.processKeyMaps();
+                                           },
+                                           false );
+    events.addTimer( CLOCK_UPDATE_MS, [ & ]() { winEditorTitle.display(); } );
+    events.addTimer( REPEAT_REPORT_MS, []() { ErrorHandler::getInstance().reportRepeats(); } );
+    events.addTimer( CURSOR_BLINK_MS,
+                     [ & ]()
+                     {
+                         if ( bHexWindow == false && dialogManager.areControlsActive() == false )
+                         {
+                             winEditor.blinkCursor();
+                             winEditor.processDisplay();
+                         }
+                     } );
 
-        GControl.ProcessMouse();
+    while ( key != 'q' )
+    {
+        events.waitForInput();
 
-        key = getch();
-        if ( dialogManager.areControlsActive() == true )
+        // windows drawn from here on are sent to the terminal together
+        CursesWin::beginFrame();
+        events.processTimers();
+
+        // every key waiting is handled as one batch, the editor is drawn once
+        const std::vector<CursesInput::InputEvent>& batch         = input.pump();
+        bool                                         keyProcessed  = batch.empty() == false;
+        bool                                         editorChanged = false;
+        events.setTimerActive( escapeTimer, input.hasPendingEscape() );
+        if ( record.is_open() && keyProcessed )
         {
-            dialogManager.process( key );
-            if ( dialogManager.redrawNeeded() )
+            record << "recorded";
+            for ( uint32_t recorded : input.getKeys() )
             {
-                winEditorStatus.display( true );
-                winEditorProject.display( true );
-                winEditorTitle.display( true );
-                winLineNumbers.display( true );
-                winEditor.redrawBackground();
-                winEditor.displayEditor();
-                dialogManager.clearRedrawNeeded();
+                record << " " << recorded;
             }
+            record << '\n';
         }
-        else
+
+        auto processKey = [ & ]()
         {
-            if ( key == KEY_F( 1 ) )
+            GControl.ProcessMouse();
+
+            if ( dialogManager.areControlsActive() == true )
             {
-                bHexWindow = !bHexWindow;
-                if ( bHexWindow == true )
+                processDialogs( key );
+            }
+            else
+            {
+                if ( bHexWindow == false )
                 {
-                    winEditor.hideWindow();
-                    winLineNumbers.hideWindow();
-                    winEditorHex.showWindow();
-                    winEditorHex.redrawBackground();
+                    // a key used by a chord goes no further
+                    chords.setKey( key );
+                    chords.processKeyMaps();
+                    if ( chords.getKey() == 0 )
+                    {
+                        return;
+                    }
                 }
-                else
+                if ( key == KEY_F( 1 ) )
                 {
-                    winEditor.showWindow();
+                    bHexWindow = !bHexWindow;
+                    if ( bHexWindow == true )
+                    {
+                        winEditor.hideWindow();
+                        winLineNumbers.hideWindow();
+                        // the hex editor views the file of the active document, opened again once it changes on disk
+                        if ( winEditorHex.isFileOpen( winEditor.getFilename() ) == false )
+                        {
+                            winEditorHex.openFile( winEditor.getFilename() );
+                        }
+                        winEditorHex.showWindow();
+                        winEditorHex.redrawBackground();
+                    }
+                    else
+                    {
+                        winEditor.showWindow();
 
-                    winLineNumbers.showWindow();
-                    winEditorHex.hideWindow();
-                    winLineNumbers.redrawBackground();
+                        winLineNumbers.showWindow();
+                        winEditorHex.hideWindow();
+                        winLineNumbers.redrawBackground();
+                    }
+                }
+                if ( key == KEY_F( 2 ) || key == KEY_F( 3 ) )
+                {
+                    ManagerControlID dialogID = ( key == KEY_F( 2 ) ) ? ManagerControlID::ID_LoadFile : ManagerControlID::ID_LoadFile;
+                    dialogManager.addControl( dialogID );
+                }
+                if ( key == KEY_F( 9 ) && bHexWindow == false )
+                {
+                    dialogManager.addControl( ManagerControlID::ID_QuickOpen );
+                }
+                if ( key == KEY_F( 6 ) )
+                {
+                    winEditorStatus.setProfileOverlay( !winEditorStatus.isProfileOverlayShown() );
+                    winEditorStatus.display( true );
+                }
+                if ( key == KEY_F( 7 ) )
+                {
+                    Profiler::getInstance().exportChromeTrace( TRACE_FILE );
+                }
+                if ( key == KEY_F( 8 ) && bHexWindow == false )
+                {
+                    winEditorProject.searchProject( winEditor.getWordAtCursor() );
+                    winEditorProject.display();
+                }
+                if ( ( key == KEY_F( 4 ) || key == KEY_F( 5 ) ) && bHexWindow == false )
+                {
+                    // cycle through the open files
+                    if ( winEditor.nextBuffer( key == KEY_F( 4 ) ) == LibraryError::No_Error )
+                    {
+                        winLineNumbers.display( true );
+                        winEditorTitle.display( true );
+                    }
+                }
+                else if ( bHexWindow == true )
+                {
+                    if ( winEditorHex.processKey( key ) == true )
+                    {
+                        winEditorHex.display();
+                    }
+                }
+                else if ( winEditor.processKeyEdit( key ) == true )
+                {
+                    editorChanged = true;
                 }
             }
-            if ( key == KEY_F( 2 ) || key == KEY_F( 3 ) )
+        };
+
+        for ( const CursesInput::InputEvent& event : batch )
+        {
+            if ( key == 'q' )
+            {
+                break;
+            }
+            if ( event.type == CursesInput::EventType::Key )
             {
-                ManagerControlID dialogID = ( key == KEY_F( 2 ) ) ? ManagerControlID::ID_LoadFile : ManagerControlID::ID_LoadFile;
-                dialogManager.addControl( dialogID );
+                key = event.key;
+                processKey();
             }
-            if ( bHexWindow == true )
+            else if ( bHexWindow == false && dialogManager.areControlsActive() == false )
             {
-                winEditorHex.display();
+                // typed text, up to a 'q' which quits, and pastes are one edit
+                std::string text = event.text;
+                if ( chords.isChordPending() && text.empty() == false )
+                {
+                    // no chord goes on with typed text, the text breaks it
+                    chords.setKey( (uint8_t)text[0] );
+                    chords.processKeyMaps();
+                }
+                if ( event.type == CursesInput::EventType::Text && text.find( 'q' ) != std::string::npos )
+                {
+                    text.resize( text.find( 'q' ) + 1 );
+                    key = 'q';
+                }
+                GControl.ProcessMouse();
+                editorChanged |= winEditor.processText( text, event.type == CursesInput::EventType::Paste );
             }
             else
             {
-                if ( winEditor.processKeyEdit( key ) == true || forceUpdate == true )
+                for ( size_t index = 0; index < event.text.size() && key != 'q'; index++ )
                 {
-                    winEditor.displayEditor();
-                    winLineNumbers.display();
+                    key = (uint8_t)event.text[index];
+                    processKey();
                 }
+            }
+        }
+        if ( editorChanged )
+        {
+            winEditor.displayEditor();
+            winLineNumbers.display();
+        }
+
+        // only the windows a key can change are redrawn
+        if ( keyProcessed )
+        {
+            winEditorStatus.display();
+            winEditorProject.display();
+            if ( bHexWindow == false && dialogManager.areControlsActive() == false )
+            {
                 winEditor.processMouse();
                 winEditor.processDisplay();
             }
         }
+        events.setTimerActive( dialogTimer, dialogManager.areControlsActive() );
+        events.setTimerActive( loadTimer, winEditor.isLoading() );
+        events.setTimerActive( searchTimer, winEditorProject.isSearching() );
+        events.setTimerActive( chordTimer, chords.isChordPending() );
+        CursesWin::endFrame();
     }
+    input.setBracketedPaste( false );
     curs_set( 1 );
 
     // Return success
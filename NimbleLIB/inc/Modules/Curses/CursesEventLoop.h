@@ -0,0 +1,84 @@
+/**----------------------------------------------------------------------------
+
+    @file       CursesEventLoop.h
+    @defgroup   NimbleLIBCurses Nimble Library Curses Module
+    @brief      Curses Event Loop class for the Nimble Library
+
+    @copyright  Neil Bereford 2023
+
+Notes:
+
+        please see CursesEventLoop.cpp for full details.
+
+-----------------------------------------------------------------------------*/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Include files
+// ----------------------------------------------------------------------------
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+// Namespace
+// ----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBCurses Nimble Library Curses Module
+    @brief      Event loop, sleeps until there is keyboard input or the next
+                timer is due, rather than polling the keyboard.
+-----------------------------------------------------------------------------*/
+class CursesEventLoop
+{
+  public:
+    typedef std::function<void()> TimerCallback; //!< called when a timer is due
+
+    // Constructor and destructor ---------------------------------------------
+    CursesEventLoop();
+    ~CursesEventLoop();
+    // Timers ----------------------------------------------------------------
+    uint32_t addTimer( uint32_t intervalMs, TimerCallback callback, bool active = true );
+    void     setTimerActive( uint32_t timerID, bool active );
+    uint32_t processTimers();
+    // Input -----------------------------------------------------------------
+    int32_t getTimeout() const;
+    bool    waitForInput();
+
+  private:
+    typedef std::chrono::steady_clock Clock; //!< clock used for the timers
+
+    /**------------------------------------------------------------------------
+        @ingroup    NimbleLIBCurses Nimble Library Curses Module
+        @brief      Repeating timer
+    -------------------------------------------------------------------------*/
+    struct Timer
+    {
+        std::chrono::milliseconds interval; //!< time between calls
+        Clock::time_point         due;      //!< next time the timer is due
+        TimerCallback             callback; //!< called when due
+        bool                      active;   //!< timer is running
+    };
+
+    // Member variables -------------------------------------------------------
+    std::vector<Timer> m_timers; //!< timers, the index is the timer ID
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: CursesEventLoop.h
+// ----------------------------------------------------------------------------
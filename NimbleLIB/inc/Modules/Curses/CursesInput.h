@@ -0,0 +1,108 @@
+/**----------------------------------------------------------------------------
+
+    @file       CursesInput.h
+    @defgroup   NimbleLIBCurses Nimble Library Curses Module
+    @brief      Curses Input pump class for the Nimble Library
+
+    @copyright  Neil Bereford 2023
+
+Notes:
+
+        please see CursesInput.cpp for full details.
+
+-----------------------------------------------------------------------------*/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Include files
+// ----------------------------------------------------------------------------
+
+#include <cinttypes>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+// Namespace
+// ----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBCurses Nimble Library Curses Module
+    @brief      Input pump, reads every key waiting into a batch of events.
+                Runs of printable keys become one text event and a
+                bracketed paste becomes one paste event.
+-----------------------------------------------------------------------------*/
+class CursesInput
+{
+  public:
+    // Constants --------------------------------------------------------------
+    static const uint32_t MAX_BATCH_KEYS    = 0x10000; //!< most keys read into one batch
+    static const uint32_t ESCAPE_TIMEOUT_MS = 50;      //!< wait for the rest of an escape sequence
+
+    /**------------------------------------------------------------------------
+        @ingroup    NimbleLIBCurses Nimble Library Curses Module
+        @brief      Type of an input event
+    -------------------------------------------------------------------------*/
+    enum class EventType
+    {
+        Key,  //!< a single key, anything not printable
+        Text, //!< a run of printable keys
+        Paste //!< the text of a bracketed paste
+    };
+
+    /**------------------------------------------------------------------------
+        @ingroup    NimbleLIBCurses Nimble Library Curses Module
+        @brief      One input event of a batch
+    -------------------------------------------------------------------------*/
+    struct InputEvent
+    {
+        EventType   type; //!< key, text or paste
+        uint32_t    key;  //!< the key, Key events only
+        std::string text; //!< the text, Text and Paste events only
+    };
+
+    // Constructor and destructor ---------------------------------------------
+    CursesInput();
+    ~CursesInput();
+    // Input -----------------------------------------------------------------
+    void                           setBracketedPaste( bool enabled );
+    void                           setEscapeTimeout( uint32_t timeoutMs );
+    const std::vector<InputEvent>& pump();
+    const std::vector<InputEvent>& processKeys( const std::vector<uint32_t>& keys );
+    // Getters ---------------------------------------------------------------
+    const std::vector<InputEvent>& getEvents() const;
+    const std::vector<uint32_t>&   getKeys() const;
+    bool                           isPasting() const;
+    bool                           hasPendingEscape() const;
+
+  private:
+    // Member variables -------------------------------------------------------
+    std::vector<InputEvent> m_events;    //!< events of the last batch
+    std::vector<uint32_t>   m_keys;      //!< keys read for the last batch
+    std::vector<uint32_t>   m_escape;        //!< keys of an escape sequence being read
+    std::string             m_paste;         //!< text of the paste being read
+    uint64_t                m_escapeStart;   //!< time the escape sequence started, milliseconds
+    uint32_t                m_escapeTimeout; //!< wait for the rest of an escape sequence
+    bool                    m_pasting;       //!< inside a bracketed paste
+    bool                    m_bracketed;     //!< terminal asked to bracket pastes
+    // Member functions -------------------------------------------------------
+    void addKey( uint32_t key );
+    void addText( char ch );
+    void flushEscape();
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: CursesInput.h
+// ----------------------------------------------------------------------------
@@ -0,0 +1,119 @@
+/**----------------------------------------------------------------------------
+
+    @file       CursesKeyBindings.h
+    @defgroup   NimbleLIBCurses Nimble Library Curses Module
+    @brief      Compiled key binding table for the Nimble Library
+
+    @copyright  Neil Bereford 2023
+
+Notes:
+
+        please see CursesKeyBindings.cpp for full details.
+
+-----------------------------------------------------------------------------*/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Include files
+// ----------------------------------------------------------------------------
+
+#include <cinttypes>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+// Namespace
+// ----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+using pKeyFunction = std::function<void( uint32_t )>; //!< Keymap Function pointer type
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBCurses Nimble Library Curses Module
+    @brief      Key bindings compiled into a hash table, single keys and
+                chords of keys are looked up in constant time
+   --------------------------------------------------------------------------*/
+class CursesKeyBindings
+{
+  public:
+    // Constants ----------------------------------------------------------------
+    static const uint32_t CHORD_TIMEOUT_MS = 1000; //!< time allowed between the keys of a chord
+    static const uint32_t MIN_SLOTS        = 16;   //!< smallest table, a power of 2
+
+    /**----------------------------------------------------------------------------
+        @ingroup    NimbleLIBCurses Nimble Library Curses Module
+        @brief      What a key did
+    -----------------------------------------------------------------------------*/
+    enum class KeyResult
+    {
+        Unbound, //!< key is not bound, it was not used
+        Handled, //!< a binding was called
+        Pending  //!< key started or continued a chord
+    };
+
+    // Constructors and destructors ---------------------------------------------
+    CursesKeyBindings();
+    // Member functions ---------------------------------------------------------
+    // Bindings -----------------------------------------------------------------
+    void     clear();
+    bool     addBinding( const std::vector<uint32_t>& sequence, pKeyFunction function );
+    uint32_t getBindingCount() const noexcept;
+    // Dispatch -----------------------------------------------------------------
+    KeyResult dispatch( uint32_t key );
+    KeyResult dispatch( uint32_t key, uint64_t timeMs );
+    bool      processTimeout();
+    bool      processTimeout( uint64_t timeMs );
+    bool      isPending() const noexcept;
+    void      setChordTimeout( uint32_t timeoutMs ) noexcept;
+
+  private:
+    // Private types ------------------------------------------------------------
+    /**----------------------------------------------------------------------------
+        @ingroup    NimbleLIBCurses Nimble Library Curses Module
+        @brief      One edge of the chord trie, a key followed from a node
+    -----------------------------------------------------------------------------*/
+    typedef struct
+    {
+        uint64_t edge;    //!< node << 32 | key, EMPTY_EDGE if the slot is free
+        uint32_t child;   //!< node the key leads to, NO_NODE if no chord continues
+        int32_t  handler; //!< binding called, NO_HANDLER if the key only starts chords
+
+    } KeySlot;
+
+    // Private constants --------------------------------------------------------
+    static const uint64_t EMPTY_EDGE = ~0ULL; //!< free slot
+    static const uint32_t NO_NODE    = 0;     //!< the root, never a child
+    static const int32_t  NO_HANDLER = -1;    //!< no binding on the edge
+    // Private data members -----------------------------------------------------
+    std::vector<KeySlot>      slots;          //!< open addressed edges, a power of 2
+    std::vector<pKeyFunction> handlers;       //!< bindings, by handler index
+    uint32_t                  usedSlots;      //!< edges in slots
+    uint32_t                  nodeCount;      //!< trie nodes, the root is node 0
+    uint32_t                  pendingNode;    //!< node of the chord in progress, NO_NODE if none
+    int32_t                   pendingHandler; //!< binding of the keys so far, called if the chord times out
+    uint32_t                  pendingKey;     //!< last key of the chord in progress
+    uint64_t                  pendingTimeMs;  //!< when the last key of the chord arrived
+    uint32_t                  chordTimeoutMs; //!< time allowed between the keys of a chord
+    // Private functions --------------------------------------------------------
+    KeySlot* findSlot( uint32_t node, uint32_t key );
+    KeySlot& insertSlot( uint32_t node, uint32_t key );
+    void     growTable();
+    bool     abandonChord();
+    void     resetChord();
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: CursesKeyBindings.h
+// ----------------------------------------------------------------------------
@@ -27,6 +27,7 @@ extern "C"
 #include "../../../../ExternalLibraries/PDCurses/curses.h"
 }
 
+#include "CursesKeyBindings.h"
 #include "../ErrorHandling/ErrorHandler.h"
 #include "../Utilities/StatusCtrl.h"
 
@@ -47,8 +48,6 @@ namespace Nimble
 // Class definitions
 // ----------------------------------------------------------------------------
 
-using pKeyFunction = std::function<void( uint32_t )>; //!< Keymap Function pointer type
-
 /**----------------------------------------------------------------------------
     @ingroup    NimbleLIBCurses Nimble Library Curses Module
     @brief      Key map structure for the Nimble Library
@@ -84,14 +83,21 @@ class CursesKeyboard
     void addKeyMap( const std::string& name, const std::vector<uint32_t>& keys, pKeyFunction function );
     void addKeyMap( const KeyMap& keyMap );
     void addKeyMapArray( const std::vector<KeyMap>& keyMapArray );
+    void addChord( const std::string& name, const std::vector<uint32_t>& keys, pKeyFunction function );
     void clearKeyMaps();
     void processKeyMaps();
+    bool isChordPending() const noexcept;
     //---------------------------------------------------------------------------
   private:
     // Private data members
-    std::vector<KeyMap> keyMaps; //!< List of key maps
-    uint32_t            lastKey; //!< Last key pressed
-    uint32_t            key;     //!< Current key pressed
+    std::vector<KeyMap> keyMaps;                 //!< List of key maps
+    std::vector<KeyMap> chordMaps;               //!< List of chords, keys pressed in order
+    CursesKeyBindings   bindings;                //!< key maps and chords compiled for lookup
+    bool                bindingsChanged = false; //!< bindings to be compiled again
+    uint32_t            lastKey         = 0;     //!< Last key pressed
+    uint32_t            key             = 0;     //!< Current key pressed
+    // Private functions
+    void compileBindings();
     // --------------------------------------------------------------------------
 };
 
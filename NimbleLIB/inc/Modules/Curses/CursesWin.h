@@ -74,10 +74,14 @@ class CursesWin : public CursesMouse
     LibraryError drawHorizontalLine( uint32_t x, uint32_t y, uint32_t length );
     LibraryError clear();
     LibraryError refresh();
+    // Frame compositor ---------------------------------------------------------
+    static void beginFrame();
+    static void endFrame();
 
     // display functions --------------------------------------------------------
     LibraryError print( uint32_t x, uint32_t y, const std::string& text );
     LibraryError displayHighlight( uint32_t x, uint32_t y, uint32_t markStart, uint32_t markEnd );
+    LibraryError displayColour( uint32_t x, uint32_t y, uint32_t start, uint32_t end, uint32_t colour );
     LibraryError colourWindow( uint32_t colour, bool hasBox );
     LibraryError eraseChar( uint32_t x, uint32_t y );
     LibraryError hideWindow();
@@ -95,9 +99,14 @@ class CursesWin : public CursesMouse
     uint32_t winInkColour;   //!< Colour of the ink
     uint32_t winPaperColour; //!< Colour of the paper
     WINDOW*  win;            //!< The curses window
+    bool     winTouched;     //!< Whole window is copied to the screen on the next draw
+
+    // Class variables ----------------------------------------------------------
+    static uint32_t frameDepth; //!< Open beginFrame() calls, the screen is only updated at 0
 
     // Member functions ---------------------------------------------------------
     bool colourBox( uint32_t colour, bool hasBox );
+    void flush();
 };
 
 //-----------------------------------------------------------------------------
@@ -17,6 +17,7 @@
 #include "../IDE/IDEWindow.h"
 #include "../IDE/IDEEditor.h"
 #include "../Curses/CursesColour.h"
+#include "../FileHandling/PatchedFile.h"
 
 //-----------------------------------------------------------------------------
 // Namespace
@@ -47,23 +48,52 @@ class EditorHexWin : public IDEWindow
     const uint32_t    WIN_INK_COLOUR   = IDE_COL_FG_BLACK;           //!< ink colour of the Project window
     const uint32_t    WIN_PAPER_COLOUR = IDE_COL_BG_WHITE;           //!< paper colour of the Project window
     const std::string WIN_TITLE        = " NimbleIDE - Hex Editor "; //!< title of the Project window
+    const std::string TRUNCATED_TITLE  = "- truncated, no save ";    //!< added to the title once the file is cut short
+    const std::string VIEW_ONLY_TITLE  = "- view only until saved "; //!< added to the title while the document has unsaved changes
     const uint32_t    WIN_TITLE_X      = 2;                          //!< x position of the title of the Project window
     const uint32_t    WIN_TITLE_Y      = 0;                          //!< y position of the title of the Project window
+    const uint32_t    ROW_X            = 2;                          //!< x position of the rows
+    const uint32_t    ROW_Y            = 1;                          //!< y position of the first row
+    const uint32_t    EDIT_INK_COLOUR  = IDE_COL_FG_RED;             //!< ink colour of edited bytes
+    // Constants --------------------------------------------------------------
+    static const uint32_t BYTES_PER_ROW = 16; //!< bytes shown on each row
+    static const uint32_t OFFSET_DIGITS = 8;  //!< minimum hex digits in the offset column
+    static const uint32_t SAVE_KEY      = 19; //!< Ctrl+S, write the edits to the file
     // Constructor & destructor -----------------------------------------------
     EditorHexWin();
     ~EditorHexWin();
     // Public functions -------------------------------------------------------
     // setters ----------------------------------------------------------------
     void setIDEEditor( IDEEditor* editor );
+    // file -------------------------------------------------------------------
+    LibraryError openFile( const std::string& filename );
+    LibraryError saveFile();
+    bool         isFileOpen( const std::string& filename ) const;
+    bool         isViewOnly() const;
     // display ----------------------------------------------------------------
     void display( bool bRedraw = false );
     void redrawBackground();
+    // control ----------------------------------------------------------------
+    bool processKey( uint32_t key );
+    // formatting -------------------------------------------------------------
+    static void formatRow( std::string& row, uint64_t offset, const uint8_t* bytes, uint32_t count, uint32_t offsetDigits );
 
   private:
     // Private constants ------------------------------------------------------
     // Private functions ------------------------------------------------------
+    uint32_t getRows() const;
+    uint32_t getHexColumn( uint32_t index ) const;
+    uint32_t getAsciiColumn( uint32_t index ) const;
+    void     moveCursor( int64_t bytes );
+    bool     editNibble( uint8_t nibble );
     // Private members --------------------------------------------------------
-    IDEEditor* m_editor = nullptr; //!< refernece to the editor/IDE
+    IDEEditor*  m_editor       = nullptr;       //!< refernece to the editor/IDE
+    PatchedFile m_file;                         //!< file being viewed, with the unsaved edits
+    uint64_t    m_topOffset    = 0;             //!< offset of the first byte shown
+    uint64_t    m_cursor       = 0;             //!< offset of the byte under the cursor
+    bool        m_lowNibble    = false;         //!< next hex digit typed sets the low nibble
+    uint32_t    m_offsetDigits = OFFSET_DIGITS; //!< hex digits in the offset column, enough for the file size
+    std::string m_row;                          //!< row being formatted, reused for every row
 };
 
 //-----------------------------------------------------------------------------
@@ -16,7 +16,8 @@
 
 #include "../IDE/IDEWindow.h"
 #include "../IDE/IDEEditor.h"
-#include "../IDE/IDEButton.h"
+#include "../IDE/IDEListView.h"
+#include "../IDE/IDEProjectSearch.h"
 #include "../Curses/CursesColour.h"
 
 //-----------------------------------------------------------------------------
@@ -51,22 +52,34 @@ class EditorProjectWin : public IDEWindow
     const std::string WIN_TITLE        = " Project Window "; //!< title of the Project window
     const uint32_t    WIN_TITLE_X      = 2;                  //!< x position of the title of the Project window
     const uint32_t    WIN_TITLE_Y      = 0;                  //!< y position of the title of the Project window
+    const uint32_t    LIST_X           = 1;                  //!< x position of the search results
+    const uint32_t    LIST_Y           = 2;                  //!< y position of the search results
+    const uint32_t    LIST_WIDTH       = WIN_WIDTH - 2;      //!< width of the search results
+    const uint32_t    LIST_ROWS        = WIN_HEIGHT - 3;     //!< rows of search results shown
     // Constructor & destructor -----------------------------------------------
     EditorProjectWin();
     ~EditorProjectWin();
     // Public functions -------------------------------------------------------
     // setters ----------------------------------------------------------------
     void setIDEEditor( IDEEditor* editor );
+    // project search ---------------------------------------------------------
+    LibraryError searchProject( const std::string& pattern );
+    bool         processSearch();
+    bool         isSearching() const;
     // display ----------------------------------------------------------------
     void display( bool bRedraw = false );
 
   private:
     // Private constants ------------------------------------------------------
     // Private functions ------------------------------------------------------
+    void getRow( uint32_t item, std::string& text, uint32_t& colour ) const;
+    void drawSearchStatus();
     // Private members --------------------------------------------------------
-    IDEEditor* m_editor = nullptr; //!< refernece to the editor/IDE
-    IDEButton  m_button;           //!< button for the project window
-    IDEButton  m_button2;          //!< button for the project window
+    IDEEditor*                                  m_editor = nullptr;     //!< refernece to the editor/IDE
+    IDEProjectSearch                            m_search;               //!< searches the files of the project
+    std::vector<IDEProjectSearch::SearchResult> m_results;              //!< lines found so far
+    IDEListView                                 m_listView;             //!< shows the lines found
+    bool                                        m_searchActive = false; //!< lines may still arrive
 };
 
 //-----------------------------------------------------------------------------
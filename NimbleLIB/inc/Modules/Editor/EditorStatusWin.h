@@ -55,6 +55,9 @@ class EditorStatusWin : public IDEWindow
     // Public functions -------------------------------------------------------
     // setters ----------------------------------------------------------------
     void setIDEEditor( IDEEditor* editor );
+    void setProfileOverlay( bool show );
+    // getters ----------------------------------------------------------------
+    bool isProfileOverlayShown() const;
     // display ----------------------------------------------------------------
     void display( bool bRedraw = false );
 
@@ -67,9 +70,16 @@ class EditorStatusWin : public IDEWindow
     const uint32_t STATUS_EDITORCOLOFFSET1SZ = 5;                         //!< colour offset size for editor lines
     const uint32_t STATUS_EDITORCOLOFFSET2   = STATUS_EDITORXOFFSET - 20; //!< colour offset for editor cursor position
     const uint32_t STATUS_EDITORCOLOFFSET2SZ = 13;                        //!< colour offset size for editor cursor position
+    const uint32_t STATUS_LOADX              = 4;                         //!< x position of the load progress
+    const uint32_t STATUS_LOADSIZE           = 14;                        //!< width of the load progress
+    const uint32_t STATUS_FRAMEX             = 20;                        //!< x position of the frame times
+    const uint32_t STATUS_ZONESX             = 30;                        //!< x position of the most expensive zones
+    const uint32_t STATUS_TOPZONES           = 4;                         //!< zones shown
     // Private functions ------------------------------------------------------
+    void displayProfile();
     // Private members --------------------------------------------------------
-    IDEEditor* m_editor = nullptr; //!< refernece to the editor/IDE
+    IDEEditor* m_editor         = nullptr; //!< refernece to the editor/IDE
+    bool       m_profileOverlay = false;   //!< show the frame times and zones
 };
 
 //-----------------------------------------------------------------------------
@@ -14,9 +14,11 @@
 // Include files
 // ----------------------------------------------------------------------------
 
+#include <atomic>
 #include <string>
 #include <chrono>
 #include <ctime>
+#include <mutex>
 #include <vector>
 
 #include "../Logging/Logger.h"
@@ -51,10 +53,12 @@ enum class ErrorType
   --------------------------------------------------------------------------*/
 struct ErrorInformation
 {
-    std::string  message; //!< Error message
-    std::time_t  time;    //!< Time of error
-    ErrorType    type;    //!< Error type
-    LibraryError number;  //!< Error code
+    std::string  message;  //!< Error message
+    std::time_t  time;     //!< Time of error
+    std::time_t  lastTime; //!< Time of the last repeat of the error
+    uint32_t     repeats;  //!< Times the error was reported in a row
+    ErrorType    type;     //!< Error type
+    LibraryError number;   //!< Error code
 };
 
 /**---------------------------------------------------------------------------
@@ -80,6 +84,10 @@ struct ErrorStatus
 class ErrorHandler : public Logger
 {
   public:
+    // Constants -----------------------------------------------------------------
+    static const uint32_t RECENT_ERRORS = 256; //!< errors kept for reportErrors(), repeats are counted not kept
+    static const uint32_t ERROR_CODES   = 256; //!< distinct error codes counted, a power of 2
+
     // Function to access the singleton -----------------------------------------
     static ErrorHandler& getInstance()
     {
@@ -87,14 +95,37 @@ class ErrorHandler : public Logger
         return instance;
     }
     // Error handling functions ------------------------------------------------
-    void handleError( ErrorType type, LibraryError error, const std::string& message );
-    void reportErrors();
-    void clearErrors();
+    void     handleError( ErrorType type, LibraryError error, const std::string& message );
+    void     reportErrors();
+    void     clearErrors();
+    uint32_t reportRepeats();
+    void     flush() override;
+
+    // Error queries -------------------------------------------------------------
+    uint64_t                      getErrorCount( LibraryError error );
+    bool                          getErrorTimes( LibraryError error, std::time_t& first, std::time_t& last );
+    std::vector<ErrorInformation> getRecentErrors();
 
     // Unit Test functions -----------------------------------------------------
     ErrorStatus getStatusInformation();
 
   private:
+    // Private Types -------------------------------------------------------------
+    /**-----------------------------------------------------------------------
+        @ingroup    NimbleLIBError Nimble Library Error Module
+        @brief      Count and times of one error code, a slot of the table
+      ----------------------------------------------------------------------*/
+    struct ErrorCounter
+    {
+        std::atomic<uint32_t> number; //!< error code, EMPTY_CODE if the slot is free
+        std::atomic<uint64_t> count;  //!< times reported
+        std::atomic<int64_t>  first;  //!< time first reported
+        std::atomic<int64_t>  last;   //!< time last reported
+    };
+
+    // Private Constants ---------------------------------------------------------
+    static const uint32_t EMPTY_CODE = 0xFFFFFFFF; //!< free counter slot
+
     // Singleton constructor and destructor ------------------------------------
     ErrorHandler();
     ~ErrorHandler();
@@ -102,10 +133,17 @@ class ErrorHandler : public Logger
     ErrorHandler& operator=( const ErrorHandler& ) = delete;
 
     // Private Data -------------------------------------------------------------
-    std::vector<ErrorInformation> errorList; //!< List of errors
+    std::mutex                    recentMutex;           //!< guards the recent errors
+    std::vector<ErrorInformation> errorList;             //!< ring of the last RECENT_ERRORS errors
+    uint32_t                      errorNext;             //!< ring index of the next error
+    uint32_t                      errorCount;            //!< errors in the ring
+    uint32_t                      repeatsLogged;         //!< reports of the newest error already logged
+    ErrorCounter                  counters[ERROR_CODES]; //!< count of each error code
+    std::atomic<uint32_t>         typeCounts[4];         //!< count of each ErrorType
 
     // Private functions --------------------------------------------------------
-    void displayMessage( const ErrorInformation& error );
+    void          displayMessage( const ErrorInformation& error );
+    ErrorCounter* findCounter( LibraryError error, bool add );
 
 }; // end class Singleton ErrorHandler
 
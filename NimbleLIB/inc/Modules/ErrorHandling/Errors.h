@@ -60,6 +60,8 @@ enum class LibraryError
 
     Logger_base_error = LIBRARY_ERROR_BASE,                                 //!< 0x10001000 Base error for the Logger
     Logger_InitializeNotCalled,                                             //!< 0x10001001 Failed to initialise the Logger
+    Logger_QueueFull,                                                       //!< 0x10001002 Log record dropped, the queue is full
+    Logger_FailedToOpenFile,                                                //!< 0x10001003 Failed to open the log file
     Curses_base_error = Logger_base_error + MODULE_OFFSET,                  //!< 0x10002000 Base error for the Curses module
     CursesColour_AlreadyInitialised,                                        //!< 0x10002001 Curses Colour class already initialised
     CursesColour_InvalidColourPair,                                         //!< 0x10002002 Curses Colour class invalid colour pair
@@ -73,6 +75,18 @@ enum class LibraryError
     CursesWin_FailedToDrawVerticalLine,                                     //!< 0x10001006 Curses Window class failed to draw vertical line
     CursesWin_FailedToDrawHorizontalLine,                                   //!< 0x10001007 Curses Window class failed to draw horizontal line
     FileHandlding_base_error = Curses_base_error + MODULE_OFFSET,           //!< 0x10003000 Base error for the File Handling module
+    MappedFile_FailedToOpenFile,                                            //!< 0x10003001 Failed to open the file to map
+    MappedFile_FailedToMapFile,                                             //!< 0x10003002 Failed to map the file into memory
+    PatchedFile_FileNotOpen,                                                //!< 0x10003003 No file open to edit
+    PatchedFile_InvalidOffset,                                              //!< 0x10003004 Offset past the end of the file
+    PatchedFile_FailedToSaveFile,                                           //!< 0x10003005 Failed to write the edits to the file
+    AtomicFileWriter_FailedToCreateFile,                                    //!< 0x10003006 Failed to create the temporary file
+    AtomicFileWriter_FailedToWriteFile,                                     //!< 0x10003007 Failed to write or sync the temporary file
+    AtomicFileWriter_FailedToReplaceFile,                                   //!< 0x10003008 Failed to rename the temporary file over the target
+    FileManager_FailedToOpenFile,                                           //!< 0x10003009 File to add to the manager can not be found
+    FileManager_FileNotOpen,                                                //!< 0x1000300A No file with the ID given
+    DirectoryScanner_FailedToReadDirectory,                                 //!< 0x1000300B Failed to read the directory
+    PatchedFile_FileTruncated,                                              //!< 0x1000300C File cut short on disk, the edits can not be saved
     ErrorHandler_base_error  = FileHandlding_base_error + MODULE_OFFSET,    //!< 0x10004000 Base error for the Error Handling module
     Screen_base_error        = FileHandlding_base_error + MODULE_OFFSET,    //!< 0x10005000 Base error for the Screen module
     Screen_ConsoleInfoFailed,                                               //!< 0x10005001 Failed to get the console information
@@ -104,6 +118,14 @@ enum class LibraryError
     IDEButtin_WindowNotInitialised,                                         //!< 0x1000700F Button window not initialised
     IDEWindow_InitNotCalled,                                                //!< 0x10007010 Window not initialised
     IDEWindow_FailedToCreateWindow,                                         //!< 0x10007011 Failed to create window
+    IDEPieceTable_InvalidPosition,                                          //!< 0x10007012 Document position out of range
+    IDEFileLoader_FailedToReadFile,                                         //!< 0x10007013 File read failed while loading
+    IDEFileHandler_FileStillLoading,                                        //!< 0x10007014 File has not finished loading
+    IDEProjectSearch_FailedToOpenDirectory,                                 //!< 0x10007015 Project search folder can not be read
+    IDETrigramIndex_InvalidIndexFile,                                       //!< 0x10007016 Project index file is damaged or of another version
+    IDEProjectFiles_FailedToOpenDirectory,                                  //!< 0x10007017 Quick open project folder can not be read
+    IDEEditor_ReplaceNotUndoable,                                           //!< 0x10007018 Replace too large for the undo budget
+    IDEEditor_FileTruncated,                                                //!< 0x10007019 Large file cut short on disk while viewed
 };
 
 //-----------------------------------------------------------------------------
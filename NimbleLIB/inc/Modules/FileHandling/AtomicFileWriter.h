@@ -0,0 +1,80 @@
+/**----------------------------------------------------------------------------
+
+    @file       AtomicFileWriter.h
+    @defgroup   NimbleLIBFile Nimble Library File Module
+    @brief      Writes a file in large gathered batches and replaces the
+                target only once the whole file is on disk
+    @copyright  Neil Bereford 2023
+
+-----------------------------------------------------------------------------*/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../ErrorHandling/ErrorHandler.h"
+
+//-----------------------------------------------------------------------------
+// Namesapce
+//-----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Clsss Definitions
+//-----------------------------------------------------------------------------
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      AtomicFileWriter class, the text is written to a temporary
+                file next to the target, which is synced and renamed over
+                the target by commit(). A failed or abandoned write leaves
+                the target as it was.
+  --------------------------------------------------------------------------*/
+class AtomicFileWriter
+{
+  public:
+    // Constants ------------------------------------------------------------
+    static const uint32_t MAX_SPANS = 1024; //!< spans gathered into one write, IOV_MAX on Linux
+    // Constructor / Destructor ---------------------------------------------
+    AtomicFileWriter();
+    ~AtomicFileWriter();
+    AtomicFileWriter( const AtomicFileWriter& )            = delete;
+    AtomicFileWriter& operator=( const AtomicFileWriter& ) = delete;
+    // File Handling --------------------------------------------------------
+    LibraryError open( const std::string& fileName );
+    LibraryError write( std::string_view span );
+    LibraryError commit();
+    void         abort();
+    // Getters --------------------------------------------------------------
+    bool     isOpen() const;
+    uint64_t getBytesWritten() const;
+
+  private:
+    // Private Data -------------------------------------------------------
+    std::string                   fileName;     //!< file being replaced
+    std::string                   tempName;     //!< temporary file written
+    intptr_t                      fileHandle;   //!< temporary file, -1 if none
+    std::vector<std::string_view> spans;        //!< spans waiting to be written
+    uint64_t                      bytesWritten; //!< bytes written so far
+    LibraryError                  writeError;   //!< first error, later writes are skipped
+    // Private Functions --------------------------------------------------
+    LibraryError flush();
+    LibraryError fail( LibraryError error, const std::string& message );
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: AtomicFileWriter.h
+//-----------------------------------------------------------------------------
@@ -0,0 +1,141 @@
+/**----------------------------------------------------------------------------
+
+    @file       DirectoryScanner.h
+    @defgroup   NimbleLIBFile Nimble Library File Module
+    @brief      Background directory scanner with cached listings
+    @copyright  Neil Bereford 2023
+
+Notes:
+
+        please see DirectoryScanner.cpp for full details.
+
+-----------------------------------------------------------------------------*/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../ErrorHandling/ErrorHandler.h"
+#include "../Utilities/SPSCQueue.h"
+
+//-----------------------------------------------------------------------------
+// Namesapce
+//-----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Clsss Definitions
+//-----------------------------------------------------------------------------
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      One entry of a directory listing
+  --------------------------------------------------------------------------*/
+struct DirectoryEntry
+{
+    std::string name;      //!< name of the entry, without the path
+    bool        directory; //!< true for a directory, or a link to one
+};
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Directory Scanner Class, reads a directory on a thread of its
+                own and passes the entries to the UI thread in batches.
+                Listings read are cached until the directory changes.
+                Every function is called from the UI thread.
+  --------------------------------------------------------------------------*/
+class DirectoryScanner
+{
+  public:
+    // Constants ------------------------------------------------------------
+    static const uint32_t SCAN_BATCH   = 256;     //!< entries passed to the UI thread together, at most
+    static const uint32_t SCAN_BATCHES = 64;      //!< batches waiting in the queue at most
+    static const uint32_t CACHED_PATHS = 16;      //!< directory listings kept
+    static const uint32_t READ_BUFFER  = 0x10000; //!< bytes of entries read from the kernel at a time
+
+    // Function to access the singleton -------------------------------------
+    static DirectoryScanner& getInstance()
+    {
+        static DirectoryScanner instance; // Created only once
+        return instance;
+    }
+
+    // Scanning -------------------------------------------------------------
+    void scan( const std::string& path );
+    bool poll( std::vector<DirectoryEntry>& entries );
+    void cancel();
+    // Cache ----------------------------------------------------------------
+    bool isCached( const std::string& path );
+    void clearCache();
+    // Getters --------------------------------------------------------------
+    bool               isScanning() const;
+    bool               hasFailed() const;
+    const std::string& getPath() const;
+
+  private:
+    // Private Types --------------------------------------------------------
+    /**-----------------------------------------------------------------------
+        @ingroup    NimbleLIBFile Nimble Library File Module
+        @brief      A directory listing kept in the cache
+      ----------------------------------------------------------------------*/
+    struct CachedListing
+    {
+        std::vector<DirectoryEntry>     entries;   //!< entries, in the order read
+        std::filesystem::file_time_type writeTime; //!< directory write time when read
+        int                             watch;     //!< inotify watch, -1 if there is none
+        uint64_t                        lastUsed;  //!< use count when last read
+    };
+
+    // Singleton constructor and destructor ---------------------------------
+    DirectoryScanner();
+    ~DirectoryScanner();
+    DirectoryScanner( const DirectoryScanner& )            = delete;
+    DirectoryScanner& operator=( const DirectoryScanner& ) = delete;
+
+    // Private Data ---------------------------------------------------------
+    SPSCQueue<std::vector<DirectoryEntry>> batches;      //!< entries read, waiting to be polled
+    std::thread                            scanner;      //!< background scanner thread
+    std::atomic<bool>                      stopScanning; //!< asks the scanner to finish early
+    std::atomic<bool>                      scanComplete; //!< every batch has been queued
+    std::atomic<bool>                      scanFailed;   //!< the directory could not be read
+    std::string                            scanPath;     //!< directory being scanned, or last scanned
+    std::vector<DirectoryEntry>            listing;      //!< entries polled so far, cached once complete
+    std::vector<DirectoryEntry>            batch;        //!< batch being polled, reused
+    bool                                   scanning;     //!< entries are still to be polled
+    bool                                   scanCached;   //!< the entries come from the cache
+    bool                                   scanChanged;  //!< the directory changed while it was read
+    int                                    scanWatch;    //!< inotify watch of the directory being read
+    std::map<std::string, CachedListing>   cache;        //!< listings, by directory
+    uint64_t                               useCount;     //!< bumped as listings are used
+    int                                    notifyHandle; //!< inotify instance, -1 if there is none
+
+    // Private functions ----------------------------------------------------
+    std::string getKey( const std::string& path ) const;
+    void        scanDirectory( std::string path );
+    bool        queueBatch( std::vector<DirectoryEntry>&& entries );
+    void        finishScan();
+    void        processNotifications();
+    int         addWatch( const std::string& path );
+    void        removeWatch( int watch );
+    void        removeListing( std::map<std::string, CachedListing>::iterator found );
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: DirectoryScanner.h
+//-----------------------------------------------------------------------------
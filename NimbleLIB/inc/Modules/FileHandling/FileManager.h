@@ -5,18 +5,27 @@
     @brief      File Manager Module
     @copyright  Neil Bereford 2023
 
+Notes:
+
+        please see FileManager.cpp for full details.
+
 -----------------------------------------------------------------------------*/
+
+#pragma once
+
 //-----------------------------------------------------------------------------
 // Includes
 //-----------------------------------------------------------------------------
 
 #include <cstdint>
-#include <fstream>
-#include <iostream>
+#include <filesystem>
 #include <string>
-#include <fstream>
 #include <vector>
 
+#include "../ErrorHandling/ErrorHandler.h"
+#include "../IDE/IDEPieceTable.h"
+#include "../IDE/IDEUndoJournal.h"
+
 //-----------------------------------------------------------------------------
 // Namesapce
 //-----------------------------------------------------------------------------
@@ -35,10 +44,12 @@ namespace Nimble
 typedef enum
 {
     IDLE = 0,    //!< 0 - structure is idle and free for use
-    OPENED,      //!< 1 - File has been opened
-    READ,        //!< 2 - File has been read
-    ERROR,       //!< 3 - Errored state
-    TOTAL_STATES //!< 4 - Total States
+    OPENED,      //!< 1 - File has been opened, its buffer is held by the editor
+    READ,        //!< 2 - File has been read, its buffer is held here
+    COMPRESSED,  //!< 3 - Buffer is held here compressed
+    DROPPED,     //!< 4 - Buffer matches the file, it is read again when needed
+    ERROR,       //!< 5 - Errored state
+    TOTAL_STATES //!< 6 - Total States
 
 } TE_FILE_STATE;
 
@@ -50,12 +61,20 @@ typedef enum
   --------------------------------------------------------------------------*/
 typedef struct
 {
-    std::string          fileName;   //!< Full File Name
-    std::ifstream        fileHandle; //!< File Handle, when opened
-    std::vector<uint8_t> fileData;   //!< File Data, stored as bytes
-    TE_FILE_STATE        fileState;  //!< File State Machine
-    uint32_t             fileSize;   //!< File Size in bytes
-    uint32_t             fileID;     //!< Unique File ID
+    std::string                     fileName;        //!< Full File Name
+    IDEPieceTable                   document;        //!< Buffer, when READ
+    IDEUndoJournal                  journal;         //!< Undo journal, kept while the buffer is not OPENED
+    std::string                     packedText;      //!< Compressed buffer text, when COMPRESSED
+    IDEUndoJournal::CursorState     cursor;          //!< Cursor when the buffer was stored
+    TE_FILE_STATE                   fileState;       //!< File State Machine
+    uint64_t                        fileSize;        //!< File Size in bytes, when last read or saved
+    std::filesystem::file_time_type fileTime;        //!< File write time, when last read or saved
+    uint64_t                        lastUsed;        //!< Use count when the buffer was last stored or restored
+    uint64_t                        memoryUsed;      //!< Bytes held for the buffer
+    uint32_t                        fileID;          //!< Unique File ID
+    bool                            modified;        //!< Buffer differs from the file
+    bool                            trailingNewline; //!< Compressed text ended with a newline
+    bool                            crlf;            //!< Compressed text ended its lines with "\r\n"
 
 } TS_FILE_DATA, *PTS_FILE_DATA;
 
@@ -66,18 +85,49 @@ typedef struct
 class FileManager
 {
   public:
+    // Constants ------------------------------------------------------------
+    static const uint32_t NO_FILE               = 0xFFFFFFFF; //!< file ID returned when no file
+    static const uint64_t DEFAULT_MEMORY_BUDGET = 0x10000000; //!< bytes the stored buffers may hold, 256MB
     // Public Methods -------------------------------------------------------
     // Constructor / Destructor ---------------------------------------------
     FileManager();
     ~FileManager();
     // File Handling --------------------------------------------------------
     uint32_t openFile( const std::string& fileName );
+    bool     closeFile( uint32_t fileID );
+    void     setFileSynced( uint32_t fileID );
+    // Buffer Handling ------------------------------------------------------
+    LibraryError storeBuffer( uint32_t fileID, IDEPieceTable& document, IDEUndoJournal& journal, const IDEUndoJournal::CursorState& cursor, bool modified );
+    bool         restoreBuffer( uint32_t fileID, IDEPieceTable& document, IDEUndoJournal& journal, IDEUndoJournal::CursorState& cursor, bool& modified );
+    bool         releaseBuffer( uint32_t fileID );
+    // Getters --------------------------------------------------------------
+    uint32_t           findFile( const std::string& fileName ) const;
+    uint32_t           getNextFileID( uint32_t fileID, bool forward ) const;
+    uint32_t           getFileCount() const;
+    TE_FILE_STATE      getFileState( uint32_t fileID ) const;
+    const std::string& getFileName( uint32_t fileID ) const;
+    bool               isModified( uint32_t fileID ) const;
+    uint64_t           getMemoryUsed() const;
+    uint64_t           getMemoryBudget() const;
+    // Setters --------------------------------------------------------------
+    void setMemoryBudget( uint64_t budget );
 
   private:
     // Private Data -------------------------------------------------------
-    std::vector<TS_FILE_DATA> fileList;   //!< List of files
-    uint32_t                  nextFileID; //!< Unique File ID used for next file
-    uint32_t                  fileCount;  //!< Total number of files handled
+    std::vector<TS_FILE_DATA> fileList;     //!< List of files, IDLE entries are reused
+    uint32_t                  nextFileID;   //!< Unique File ID used for next file
+    uint32_t                  fileCount;    //!< Total number of files handled
+    uint64_t                  memoryBudget; //!< Bytes the stored buffers may hold
+    uint64_t                  memoryUsed;   //!< Bytes the stored buffers hold
+    uint64_t                  useCount;     //!< Counts stores and restores, orders the buffers by use
+    // Private Methods ----------------------------------------------------
+    PTS_FILE_DATA       getFile( uint32_t fileID );
+    const TS_FILE_DATA* getFile( uint32_t fileID ) const;
+    bool                fileChanged( const TS_FILE_DATA& file ) const;
+    void                compressBuffer( TS_FILE_DATA& file );
+    void                dropBuffer( TS_FILE_DATA& file );
+    void                setMemoryUsed( TS_FILE_DATA& file, uint64_t bytes );
+    void                trimToBudget();
 };
 
 //-----------------------------------------------------------------------------
@@ -0,0 +1,85 @@
+/**----------------------------------------------------------------------------
+
+    @file       MappedFile.h
+    @defgroup   NimbleLIBFile Nimble Library File Module
+    @brief      Read only memory mapped file
+    @copyright  Neil Bereford 2023
+
+-----------------------------------------------------------------------------*/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../ErrorHandling/ErrorHandler.h"
+
+//-----------------------------------------------------------------------------
+// Namesapce
+//-----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+struct MappedRange;
+
+//-----------------------------------------------------------------------------
+// Clsss Definitions
+//-----------------------------------------------------------------------------
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      MappedFile class, maps a whole file read only into memory.
+                Pages are only loaded by the OS when they are touched, so the
+                resident memory follows what is read, not the file size.
+                Bytes cut off by another process truncating the file read
+                as zero. Past the mappings the truncation guard can hold,
+                files are read into memory instead.
+  --------------------------------------------------------------------------*/
+class MappedFile
+{
+  public:
+    // Constructor / Destructor ---------------------------------------------
+    MappedFile();
+    ~MappedFile();
+    MappedFile( const MappedFile& )            = delete;
+    MappedFile& operator=( const MappedFile& ) = delete;
+    // File Handling --------------------------------------------------------
+    LibraryError open( const std::string& fileName );
+    void         close();
+    // Getters --------------------------------------------------------------
+    bool               isOpen() const;
+    bool               isTruncated() const;
+    bool               isChangedOnDisk() const;
+    const char*        getData() const;
+    uint64_t           getSize() const;
+    const std::string& getFileName() const;
+
+  private:
+#if !defined( _WIN32 )
+    // Private Functions --------------------------------------------------
+    LibraryError readCopy( int file, uint64_t size );
+#endif
+    // Private Data -------------------------------------------------------
+    std::string       fileName;  //!< Full File Name
+    const char*       fileData;  //!< Start of the mapping, nullptr if empty
+    uint64_t          fileSize;  //!< File Size in bytes
+    bool              fileOpen;  //!< File has been mapped
+    MappedRange*      fileRange; //!< Entry guarding the mapping against truncation, POSIX only
+    std::vector<char> fileCopy;  //!< File read into memory when no guard entry is free, POSIX only
+    uint64_t          fileIndex; //!< inode or file index when mapped
+    uint64_t          fileTime;  //!< last write time when mapped
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: MappedFile.h
+//-----------------------------------------------------------------------------
@@ -0,0 +1,83 @@
+/**----------------------------------------------------------------------------
+
+    @file       PatchedFile.h
+    @defgroup   NimbleLIBFile Nimble Library File Module
+    @brief      Memory mapped file with a sparse overlay of byte edits
+    @copyright  Neil Bereford 2023
+
+Notes:
+
+        please see PatchedFile.cpp for full details.
+
+-----------------------------------------------------------------------------*/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+#include "../ErrorHandling/ErrorHandler.h"
+#include "MappedFile.h"
+
+//-----------------------------------------------------------------------------
+// Namesapce
+//-----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Clsss Definitions
+//-----------------------------------------------------------------------------
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      PatchedFile class, byte editable view of a mapped file.
+                Edits are held in a sparse overlay keyed by file offset, the
+                file itself is only written by save().
+  --------------------------------------------------------------------------*/
+class PatchedFile
+{
+  public:
+    // Constructor / Destructor ---------------------------------------------
+    PatchedFile();
+    ~PatchedFile();
+    PatchedFile( const PatchedFile& )            = delete;
+    PatchedFile& operator=( const PatchedFile& ) = delete;
+    // File Handling --------------------------------------------------------
+    LibraryError open( const std::string& fileName );
+    void         close();
+    LibraryError save();
+    void         discardEdits();
+    // Byte access ----------------------------------------------------------
+    uint8_t      getByte( uint64_t offset ) const;
+    uint32_t     readBytes( uint64_t offset, uint8_t* buffer, uint32_t count ) const;
+    LibraryError setByte( uint64_t offset, uint8_t value );
+    bool         isEdited( uint64_t offset ) const;
+    // Getters --------------------------------------------------------------
+    bool               isOpen() const;
+    bool               isModified() const;
+    bool               isTruncated() const;
+    bool               isChangedOnDisk() const;
+    uint64_t           getSize() const;
+    uint64_t           getEditCount() const;
+    const std::string& getFileName() const;
+
+  private:
+    // Private Data -------------------------------------------------------
+    MappedFile                  file;  //!< Original file contents, read only
+    std::map<uint64_t, uint8_t> edits; //!< Edited bytes by offset, only bytes that differ from the file
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: PatchedFile.h
+//-----------------------------------------------------------------------------
@@ -42,6 +42,9 @@ namespace Nimble
 /**----------------------------------------------------------------------------
     @ingroup    NimbleLIBIDE Nimble Library IDE Module
     @brief      IDEEditline class for the Nimble Library
+                The line is held in a gap buffer, the gap follows the cursor
+                so typing and deleting at the cursor do not move the rest of
+                the line.
 -----------------------------------------------------------------------------*/
 class IDEEditline : public StatusCtrl
 {
@@ -75,6 +78,7 @@ class IDEEditline : public StatusCtrl
     uint32_t    getHilightEnd() const;
     std::string getLineString() const;
     uint32_t    getLineBufferLimit() const;
+    uint64_t    getBytesMoved() const;
     // setters -----------------------------------------------------------------
     void setLineXpos( uint32_t xpos );
     void setLineYpos( uint32_t ypos );
@@ -105,6 +109,8 @@ class IDEEditline : public StatusCtrl
     bool         isEditlineFlagSet( EditlineFlags flag ) const noexcept;
 
   private:
+    // constants ---------------------------------------------------------------
+    static const uint32_t GAP_SIZE = 16; //!< Smallest gap left when the buffer grows
     // private variables -------------------------------------------------------
     uint32_t            lineXpos;        //!< X position of line
     uint32_t            lineYpos;        //!< Y position of line
@@ -113,10 +119,17 @@ class IDEEditline : public StatusCtrl
     uint32_t            linePaperColour; //!< Paper colour of line
     uint32_t            lineCursor;      //!< X position of cursor
     uint32_t            lineBufferLimit; //!< Limit of line buffer
-    std::vector<int8_t> lineBuffer;      //!< Buffer for line
+    std::vector<int8_t> lineBuffer;      //!< Gap buffer for line, text either side of the gap
+    uint32_t            gapStart;        //!< Start of the gap, text before the cursor ends here
+    uint32_t            gapEnd;          //!< End of the gap, text after the cursor starts here
+    uint64_t            bytesMoved;      //!< Bytes moved by gap moves and buffer growth
     // advanced editline --------------------------------------------------------
     uint32_t hilightStart; //!< Start of hilight
     uint32_t hilightEnd;   //!< End of hilight
+    // private functions -------------------------------------------------------
+    uint32_t getTextLength() const;
+    void     moveGap( uint32_t position );
+    void     reserveGap( uint32_t length );
 };
 
 //-----------------------------------------------------------------------------
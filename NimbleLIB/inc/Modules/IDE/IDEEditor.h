@@ -28,9 +28,13 @@ extern "C"
 #include "../Curses/CursesWin.h"
 #include "../Curses/CursesMouse.h"
 #include "../ErrorHandling/ErrorHandler.h"
+#include "../FileHandling/FileManager.h"
 #include "../Utilities/StatusCtrl.h"
 #include "IDEEditline.h"
 #include "IDEFileHandler.h"
+#include "IDESearch.h"
+#include "IDESyntax.h"
+#include "IDEUndoJournal.h"
 
 //-----------------------------------------------------------------------------
 // Namespace
@@ -60,6 +64,7 @@ class IDEEditor : protected IDEFileHandler, public CursesMouse
     {
         FormatWhenPrint = 0, //!< 0: Format when printing, otherwise just print signel colour
         MarkedTextActive,    //!< 1: Marked text is active
+        LargeFileMode,       //!< 2: Large file, read only view of the mapped file
     };
     // constructor & destructor -------------------------------------------------
     IDEEditor();
@@ -67,53 +72,114 @@ class IDEEditor : protected IDEFileHandler, public CursesMouse
     // initialisation ----------------------------------------------------------
     LibraryError init( uint32_t width, uint32_t height, uint32_t x, uint32_t y );
     LibraryError start( std::string& filename );
+    // buffers -----------------------------------------------------------------
+    LibraryError switchBuffer( uint32_t fileID );
+    LibraryError nextBuffer( bool forward );
     // public functions --------------------------------------------------------
     // getters -----------------------------------------------------------------
-    uint32_t getCurrentLine() const;
-    uint32_t getCurrentColumn() const;
-    uint32_t getTotalLines() const;
-    uint32_t getCursorX() const;
-    uint32_t getCursorY() const;
-    WINDOW*  getWindow() const;
+    uint32_t             getCurrentLine() const;
+    uint32_t             getCurrentColumn() const;
+    uint32_t             getTotalLines() const;
+    const IDEPieceTable& getDocument() const;
+    const FileManager&   getFileManager() const;
+    uint32_t             getActiveFile() const;
+    const std::string&   getFilename() const;
+    bool                 isLoading() const;
+    bool                 isModified() const;
+    uint32_t             getLoadProgress() const;
+    bool                 isFileTruncated() const;
+    uint32_t             getCursorX() const;
+    uint32_t             getCursorY() const;
+    WINDOW*              getWindow() const;
+    std::string          getWordAtCursor() const;
     // setters -----------------------------------------------------------------
     void setCursorPosition( uint32_t x, uint32_t y );
     void scrollEditor( bool upIfTrue );
     // display functions -------------------------------------------------------
     LibraryError displayEditor();
+    void         markRowsDirty( uint32_t firstRow, uint32_t lastRow );
     LibraryError print( uint32_t x, uint32_t y, const std::string& text );
     LibraryError showWindow();
     LibraryError hideWindow();
     void         redrawBackground();
     // control functions -------------------------------------------------------
-    bool processKeyViewOnly( uint32_t key );
-    bool processKeyEdit( uint32_t key );
-    bool processDisplay();
+    bool         processKeyViewOnly( uint32_t key );
+    bool         processKeyEdit( uint32_t key );
+    bool         processText( const std::string& text, bool paste );
+    bool         processDisplay();
+    bool         processLoad();
+    LibraryError save();
+    void         blinkCursor();
+    bool         undo();
+    bool         redo();
+    // find / replace ----------------------------------------------------------
+    bool     find( const std::string& pattern, bool matchCase, bool wholeWord );
+    bool     findNext();
+    bool     findPrevious();
+    bool     replace( const std::string& replacement );
+    uint64_t replaceAll( const std::string& replacement );
 
   private:
+    // private constants -------------------------------------------------------
+    static const uint32_t UNDO_KEY          = 26;         //!< Ctrl+Z
+    static const uint32_t REDO_KEY          = 25;         //!< Ctrl+Y
+    static const uint32_t SAVE_KEY          = 19;         //!< Ctrl+S
+    static const uint32_t FIND_KEY          = 6;          //!< Ctrl+F, find the word under the cursor
+    static const uint32_t FIND_NEXT_KEY     = 7;          //!< Ctrl+G
+    static const uint32_t FIND_PREVIOUS_KEY = 18;         //!< Ctrl+R
+    static const uint64_t LOAD_FRAME_BUDGET = 0x00800000; //!< bytes appended by each processLoad(), 8MB
     // private variables -------------------------------------------------------
-    uint32_t                   m_width;         //!< width of the editor window
-    uint32_t                   m_height;        //!< height of the editor window
-    uint32_t                   m_xStart;        //!< x position of the editor window
-    uint32_t                   m_yStart;        //!< y position of the editor window
-    int32_t                    m_currentLine;   //!< current line number
-    int32_t                    m_currentColumn; //!< current column number
-    uint32_t                   m_cursorX;       //!< x position of the cursor
-    uint32_t                   m_cursorY;       //!< y position of the cursor
-    uint32_t                   m_oldCursorX;    //!< x position of the cursor before it was moved
-    uint32_t                   m_oldCursorY;    //!< y position of the cursor before it was moved
-    bool                       m_cursorDrawn;   //!< flag to indicate if the cursor has been drawn
-    uint32_t                   m_frameCount;    //!< frame count for the IDEEditor
-    std::unique_ptr<CursesWin> m_editorWin;     //!< editor window
+    uint32_t                         m_width;           //!< width of the editor window
+    uint32_t                         m_height;          //!< height of the editor window
+    uint32_t                         m_xStart;          //!< x position of the editor window
+    uint32_t                         m_yStart;          //!< y position of the editor window
+    int32_t                          m_currentLine;     //!< current line number
+    int32_t                          m_currentColumn;   //!< current column number
+    uint32_t                         m_cursorX;         //!< x position of the cursor
+    uint32_t                         m_cursorY;         //!< y position of the cursor
+    uint32_t                         m_oldCursorX;      //!< x position of the cursor before it was moved
+    uint32_t                         m_oldCursorY;      //!< y position of the cursor before it was moved
+    bool                             m_cursorDrawn;     //!< flag to indicate if the cursor has been drawn
+    std::unique_ptr<CursesWin>       m_editorWin;       //!< editor window
+    std::vector<bool>                m_dirtyRows;       //!< rows that have to be redrawn
+    int32_t                          m_drawnLine;       //!< m_currentLine when the rows were last drawn
+    int32_t                          m_drawnColumn;     //!< m_currentColumn when the rows were last drawn
+    uint32_t                         m_drawnLines;      //!< total lines when the rows were last drawn
+    IDEUndoJournal                   m_journal;         //!< edits that can be undone and redone
+    IDEUndoJournal::CursorState      m_editCursor;      //!< cursor before the key being edited
+    bool                             m_documentEdited;  //!< the key being edited changed the document
+    IDESearch                        m_search;          //!< find / replace pattern and search
+    std::vector<std::string_view>    m_searchSpans;     //!< pieces of the document searched
+    uint64_t                         m_matchOffset;     //!< offset of the match shown, NOT_FOUND if none
+    IDESyntax                        m_syntax;          //!< syntax highlighter and its line state cache
+    std::vector<IDESyntax::TokenRun> m_tokenRuns;       //!< token runs of the row being drawn
+    FileManager                      m_files;           //!< open files, holds the buffers not being edited
+    uint32_t                         m_activeFile;      //!< file being edited, FileManager::NO_FILE if none
+    bool                             m_truncatedLogged; //!< the large file being cut short has been reported
     // private functions -------------------------------------------------------
     bool    checkCursorKeys( uint32_t key );
     bool    checkEditKeys( uint32_t key );
     uint8_t getCharFromEditor( uint32_t x, uint32_t y );
     void    eraseCharFromEditor( uint32_t x, uint32_t y );
     void    insertCharIntoEditor( uint32_t x, uint32_t y, uint8_t ch );
+    void    insertTextIntoEditor( uint32_t x, uint32_t y, const std::string& text );
     void    insertLineIntoEditor( uint32_t y );
     void    placeCursorinLine( uint32_t y );
+    void    placeCursorAt( uint32_t line, uint32_t column );
     void    moveTextRight();
     void    updateHighlighting( uint32_t curline );
+    void    updateSyntaxColours( uint32_t curline, std::string_view line );
+    void    joinLinesInEditor( uint32_t line );
+    void    stashBuffer();
+    // undo / redo -------------------------------------------------------------
+    IDEUndoJournal::CursorState getCursorState() const;
+    void                        restoreCursorState( const IDEUndoJournal::CursorState& cursor );
+    void                        updateEditFlags();
+    // find / replace ----------------------------------------------------------
+    uint64_t                             getCursorOffset() const;
+    const std::vector<std::string_view>& getSearchSpans();
+    void                                 showMatch( uint64_t offset );
+    void                                 clearMatch();
 };
 
 //-----------------------------------------------------------------------------
@@ -16,8 +16,11 @@
 
 #include <filesystem>
 #include <vector>
+#include "../FileHandling/DirectoryScanner.h"
 #include "IDEDialog.h"
 #include "IDEButton.h"
+#include "IDEFuzzyFilter.h"
+#include "IDEListView.h"
 
 //-----------------------------------------------------------------------------
 // Namespace
@@ -44,6 +47,7 @@ class IDEFileDialog : public IDEDialog
     // constants --------------------------------------------------------------
     static const uint32_t m_kDialogWidth  = 60;
     static const uint32_t m_kDialogHeight = 25;
+    static const uint32_t m_kMaxFilter    = 40; //!< characters typed into the filter at most
     // initialisation ---------------------------------------------------------
     LibraryError initLoader( const std::string& path, const std::string& filename, const std::string titleDialog );
     // Getters functions ------------------------------------------------------
@@ -75,28 +79,42 @@ class IDEFileDialog : public IDEDialog
 
     // cursor control ---------------------------------------------------------
     KeyMap m_keyMapCursorControl = {
-        "CursorControl", {KEY_UP, KEY_DOWN, KEY_LEFT, KEY_RIGHT},
+        "CursorControl", {KEY_UP, KEY_DOWN, KEY_LEFT, KEY_RIGHT, KEY_PPAGE, KEY_NPAGE, KEY_HOME, KEY_END},
          std::bind( &IDEFileDialog::cursorControl, this, std::placeholders::_1 )
     };
 
     KeyMap m_keyMapDialogControl = {
-        "DialogControl", {KEY_ESC, KEY_ENTER},
+        "DialogControl", {KEY_ESC, KEY_ENTER, '\n'},
          std::bind( &IDEFileDialog::dialogControl, this, std::placeholders::_1 )
     };
 
+    // keys typed into the filter, filled in by initLoader()
+    KeyMap m_keyMapFilterControl = {
+        "FilterControl", {},
+         std::bind( &IDEFileDialog::filterControl, this, std::placeholders::_1 )
+    };
+
     // private member variables -----------------------------------------------
     std::string           m_path;             // !< Path
     std::string           m_filename;         //!< Filename
     std::string           m_titleDialog;      //!< Title of the dialog
     std::vector<FileData> m_filesInDirectory; //!< Files in the directory
-    uint32_t              m_cursorPos;        //!< Cursor position
-    uint32_t              m_fileStartPos;     //!< start of first shown file
+    std::vector<uint32_t> m_visible;          //!< Files shown, best match first, by index into m_filesInDirectory
+    std::string           m_query;            //!< Filter typed
+    IDEFuzzyFilter        m_filter;           //!< Matches the filter against the file names
+    bool                  m_filterChanged;    //!< Files added since the filter was given the names
+    IDEListView           m_listView;         //!< Shows the files on screen
     bool                  m_completed;        //!< Completed
     bool                  m_cancelled;        //!< Cancelled
     // private functions -------------------------------------------------------
-    void drawCursor();
-    void cursorControl( uint32_t key );
-    void dialogControl( uint32_t key );
+    void        cursorControl( uint32_t key );
+    void        dialogControl( uint32_t key );
+    void        filterControl( uint32_t key );
+    void        applyFilter();
+    void        getRow( uint32_t item, std::string& text, uint32_t& colour ) const;
+    void        updateStatus();
+    bool        pollDirectory();
+    static bool isBefore( const FileData& first, const FileData& second );
     //-------------------------------------------------------------------------
 };
 
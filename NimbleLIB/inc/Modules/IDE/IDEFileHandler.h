@@ -16,13 +16,20 @@
 
 #include <cinttypes>
 #include <cstdint>
+#include <fstream>
+#include <map>
 #include <memory>
 #include <vector>
 #include <sstream>
+#include <string_view>
 
 #include "../ErrorHandling/ErrorHandler.h"
+#include "../FileHandling/AtomicFileWriter.h"
 #include "../Utilities/StatusCtrl.h"
 #include "IDEEditline.h"
+#include "IDEFileLoader.h"
+#include "IDELargeFile.h"
+#include "IDEPieceTable.h"
 
 //-----------------------------------------------------------------------------
 // Namespace
@@ -41,6 +48,8 @@ namespace Nimble
 class IDEFileHandler : public StatusCtrl
 {
   public:
+    // constants ---------------------------------------------------------------
+    static const uint64_t LARGE_FILE_SIZE = 0x04000000; //!< files of this size or more are viewed read only
     // typedefs and enums ------------------------------------------------------
     typedef struct _EditLineAttributes
     {
@@ -115,23 +124,37 @@ class IDEFileHandler : public StatusCtrl
     void setFlags( uint32_t flags );
     void setStatus( std::string status );
     // getters -----------------------------------------------------------------
-    std::string getStatus();
-    uint32_t    getFlags();
+    std::string        getStatus();
+    uint32_t           getFlags();
+    const std::string& getFilename() const;
+    bool               isLoading() const;
+    bool               isModified() const;
+    uint32_t           getLoadProgress() const;
     // file functions ----------------------------------------------------------
     LibraryError openFile( std::string& filename );
+    LibraryError openLargeFile( std::string& filename );
     LibraryError saveFile( std::string& filename );
+    bool         pollLoad( uint64_t byteBudget, uint32_t& firstLine, uint32_t& linesAdded );
     //--------------------------------------------------------------------------
   private:
     // private variables -------------------------------------------------------
-    uint32_t      m_flags;    //!< File handler flags
-    std::string   m_filename; //!< Filename
-    std::string   m_status;   //!< Status string
-    std::ofstream m_fileOut;  //!< File stream - output
-    std::ifstream m_fileIn;   //!< File stream - input
+    uint32_t      m_flags;          //!< File handler flags
+    std::string   m_filename;       //!< Filename
+    std::string   m_status;         //!< Status string
+    IDEFileLoader m_loader;         //!< Reads the file opened in the background
+    uint64_t      m_savedEditCount; //!< document edit count when it matched the file
+    // private functions -------------------------------------------------------
+    LibraryError writeDocument( const std::string& filename );
   protected:
-    std::vector<std::string>                  m_editlines;          //!< Edit lines
-    std::vector<EditLineAttributes>           m_editlineAttributes; //!< Edit line attributes
+    IDEPieceTable                             m_document;           //!< Document being edited
+    IDELargeFile                              m_largeFile;          //!< Large file being viewed, read only
+    std::map<uint32_t, EditLineAttributes>    m_editlineAttributes; //!< Edit line attributes, only lines that have any
     std::vector<std::unique_ptr<IDEEditline>> m_test;               //!< Test for class insertion
+    // document editing --------------------------------------------------------
+    void               restoreDocument( const std::string& filename, bool modified );
+    EditLineAttributes getLineAttributes( uint32_t line ) const;
+    LibraryError       splitDocumentLine( uint32_t line, uint32_t column );
+    LibraryError       joinDocumentLines( uint32_t line );
     //--------------------------------------------------------------------------
 };
 
@@ -0,0 +1,96 @@
+/**----------------------------------------------------------------------------
+
+    @file       IDEFileLoader.h
+    @defgroup   NimbleLIBIDE Nimble Library IDE Module
+    @brief      IDEFileLoader class for the Nimble Library
+
+    @copyright  Neil Bereford 2023
+
+Notes:
+
+        please see IDEFileLoader.cpp for full details.
+
+-----------------------------------------------------------------------------*/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Include files
+// ----------------------------------------------------------------------------
+
+#include <atomic>
+#include <cinttypes>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include "../ErrorHandling/ErrorHandler.h"
+#include "../Utilities/SPSCQueue.h"
+#include "IDEPieceTable.h"
+
+//-----------------------------------------------------------------------------
+// Namespace
+// ----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Background file loader for the Nimble Library
+                A reader thread reads the file in large blocks and passes
+                batches of whole lines to the UI thread through a lock free
+                queue, the UI thread appends them to the document a frame at
+                a time.
+-----------------------------------------------------------------------------*/
+class IDEFileLoader
+{
+  public:
+    // constants ---------------------------------------------------------------
+    static const uint32_t LOAD_BLOCK_SIZE = 0x00100000; //!< bytes read at a time, 1MB
+    static const uint32_t LOAD_BATCHES    = 16;         //!< batches waiting in the queue at most
+    // constructors & destructors ----------------------------------------------
+    IDEFileLoader();
+    ~IDEFileLoader();
+    IDEFileLoader( const IDEFileLoader& )            = delete;
+    IDEFileLoader& operator=( const IDEFileLoader& ) = delete;
+    // initialisation ----------------------------------------------------------
+    LibraryError open( const std::string& filename );
+    void         close();
+    // loading -----------------------------------------------------------------
+    bool poll( IDEPieceTable& document, uint64_t byteBudget, uint32_t& firstLine, uint32_t& linesAdded );
+    // getters -----------------------------------------------------------------
+    bool     isLoading() const;
+    uint64_t getFileSize() const;
+    uint64_t getBytesLoaded() const;
+    uint32_t getProgress() const;
+
+  private:
+    // private variables -------------------------------------------------------
+    SPSCQueue<std::string> m_batches;         //!< line batches read, waiting to be appended
+    std::thread            m_reader;          //!< background reader thread
+    std::atomic<bool>      m_stopReading;     //!< asks the reader to finish early
+    std::atomic<bool>      m_readComplete;    //!< every batch has been queued
+    std::atomic<bool>      m_readFailed;      //!< the file could not be read to the end
+    std::atomic<bool>      m_trailingNewline; //!< the file ends with a line feed
+    std::atomic<bool>      m_crlf;            //!< the first line ends with "\r\n"
+    uint64_t               m_fileSize;        //!< size of the file when opened
+    uint64_t               m_bytesLoaded;     //!< bytes appended to the document
+    bool                   m_loading;         //!< batches are still to be appended
+    std::string            m_batch;           //!< batch being appended, reused
+    // private functions -------------------------------------------------------
+    void readFile( std::string filename );
+    bool queueBatch( std::string&& batch );
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: IDEFileLoader.h
+// ----------------------------------------------------------------------------
@@ -0,0 +1,141 @@
+/**----------------------------------------------------------------------------
+
+    @file       IDEFuzzyFilter.h
+    @defgroup   NimbleLIBIDE Nimble Library IDE Module
+    @brief      IDEFuzzyFilter class for the Nimble Library
+
+    @copyright  Neil Bereford 2023
+
+Notes:
+
+        please see IDEFuzzyFilter.cpp for full details.
+
+-----------------------------------------------------------------------------*/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Include files
+// ----------------------------------------------------------------------------
+
+#include <cinttypes>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../Utilities/ThreadPool.h"
+
+//-----------------------------------------------------------------------------
+// Namespace
+// ----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Fuzzy filter for the Nimble Library
+                Narrows a list of names to those holding the characters of a
+                query in order, ignoring case, best matches first. The names
+                are indexed once, lower cased with a mask of the characters
+                each holds, so most names are rejected without being read.
+                Long lists are scored on a pool of threads.
+-----------------------------------------------------------------------------*/
+class IDEFuzzyFilter
+{
+  public:
+    /**------------------------------------------------------------------------
+        @ingroup    NimbleLIBIDE Nimble Library IDE Module
+        @brief      A name matching the query
+    -------------------------------------------------------------------------*/
+    struct Match
+    {
+        uint32_t item;  //!< index of the name, in the order added
+        int32_t  score; //!< higher is a better match
+    };
+
+    // constants ---------------------------------------------------------------
+    static const int32_t  SCORE_MATCH        = 16;      //!< each character matched
+    static const int32_t  BONUS_START        = 10;      //!< matched at the start of the name
+    static const int32_t  BONUS_BOUNDARY     = 8;       //!< matched after a separator, / \ _ - . or space
+    static const int32_t  BONUS_CAMEL        = 6;       //!< matched at a capital following a small letter
+    static const int32_t  BONUS_CONSECUTIVE  = 4;       //!< matched straight after the last match
+    static const int32_t  MAX_GAP_PENALTY    = 8;       //!< most taken off for characters skipped between matches
+    static const uint32_t PARALLEL_THRESHOLD = 100000;  //!< names scored on the pool once more than this are to be scored
+    static const uint32_t PARALLEL_CHUNK     = 16384;   //!< names scored by each task of the pool
+    static const uint32_t SIMD_NAME_LENGTH   = 64;      //!< names this long or shorter are scored with SSE2
+    static const uint32_t SIMD_PADDING       = 64;      //!< bytes after the last lower cased name, read by the SSE2 loads
+    static const uint32_t HISTORY_LIMIT      = 4000000; //!< matches kept for the queries typed before the last, at most
+
+    // constructors & destructors ----------------------------------------------
+    IDEFuzzyFilter();
+    // index -------------------------------------------------------------------
+    void     clear();
+    void     addItem( std::string_view name );
+    uint32_t getItemCount() const;
+    // filtering ---------------------------------------------------------------
+    const std::vector<Match>& filter( std::string_view query );
+    const std::vector<Match>& getMatches() const;
+    bool                      score( uint32_t item, int32_t& result ) const;
+    void                      setParallelThreshold( uint32_t names );
+
+  private:
+    /**------------------------------------------------------------------------
+        @ingroup    NimbleLIBIDE Nimble Library IDE Module
+        @brief      A name matching a query, where its last character matched
+    -------------------------------------------------------------------------*/
+    struct Found
+    {
+        uint32_t item;  //!< index of the name, in the order added
+        int32_t  total; //!< score of the characters matched, before the length of the name is taken off
+        int32_t  last;  //!< place in the name of the last character matched
+    };
+
+    /**------------------------------------------------------------------------
+        @ingroup    NimbleLIBIDE Nimble Library IDE Module
+        @brief      The names matching a query typed, kept for backspace
+    -------------------------------------------------------------------------*/
+    struct Level
+    {
+        uint32_t           length; //!< characters of m_query matched
+        std::vector<Found> found;  //!< names matching them, in the order added
+    };
+
+    // private variables -------------------------------------------------------
+    std::string                     m_lower;     //!< every name lower cased, one after the other
+    std::string                     m_names;     //!< every name as added, for the case of each letter
+    std::vector<uint32_t>           m_offsets;   //!< start of each name, and the end of the last
+    std::vector<uint64_t>           m_masks;     //!< characters each name holds, a bit each
+    std::string                     m_query;     //!< query of m_matches, lower cased
+    uint64_t                        m_queryMask; //!< characters the query holds
+    std::vector<Level>              m_levels;    //!< names matching each query typed, shorter first, the last matches m_query
+    size_t                          m_kept;      //!< matches held by m_levels
+    std::vector<Match>              m_matches;   //!< names matching m_query, best first
+    std::vector<Match>              m_ranked;    //!< m_matches as they are ranked
+    std::vector<uint32_t>           m_counts;    //!< matches of each score, for the ranking
+    bool                            m_valid;     //!< m_matches is the result of m_query
+    uint32_t                        m_parallel;  //!< names scored on the pool once more than this are to be scored
+    std::unique_ptr<ThreadPool>     m_pool;      //!< workers, started by the first long list scored
+    std::vector<std::vector<Found>> m_chunks;    //!< names matching in each chunk scored on the pool
+    // private functions -------------------------------------------------------
+    bool            scoreFrom( uint32_t item, size_t first, int32_t& total, int32_t& last ) const;
+    void            scanItems( uint32_t first, uint32_t last, std::vector<Found>& found ) const;
+    void            narrowItems( const std::vector<Found>& source, size_t first, size_t last, size_t matched, std::vector<Found>& found ) const;
+    void            scoreParallel( const std::vector<Found>* source, size_t matched, std::vector<Found>& found );
+    void            addLevel( Level&& level );
+    void            rankMatches( const std::vector<Found>& found );
+    static uint64_t getCharMask( uint8_t ch );
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: IDEFuzzyFilter.h
+// ----------------------------------------------------------------------------
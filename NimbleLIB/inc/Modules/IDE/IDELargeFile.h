@@ -0,0 +1,93 @@
+/**----------------------------------------------------------------------------
+
+    @file       IDELargeFile.h
+    @defgroup   NimbleLIBIDE Nimble Library IDE Module
+    @brief      IDELargeFile class for the Nimble Library
+
+    @copyright  Neil Bereford 2023
+
+-----------------------------------------------------------------------------*/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Include files
+// ----------------------------------------------------------------------------
+
+#include <atomic>
+#include <cinttypes>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "../ErrorHandling/ErrorHandler.h"
+#include "../FileHandling/MappedFile.h"
+
+//-----------------------------------------------------------------------------
+// Namespace
+// ----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Read only view of a large file for the Nimble Library
+                The file is memory mapped and lines are returned as views into
+                the mapping. A background thread builds a sparse index holding
+                the offset of every LINE_INDEX_STEP'th line, lines in between
+                are found by scanning forward from the nearest checkpoint.
+-----------------------------------------------------------------------------*/
+class IDELargeFile
+{
+  public:
+    // constants ---------------------------------------------------------------
+    static const uint32_t LINE_INDEX_STEP = 256;     //!< lines between index checkpoints
+    static const uint32_t INDEX_READ_SIZE = 0x40000; //!< bytes read per indexing block
+    // constructors & destructors ----------------------------------------------
+    IDELargeFile();
+    ~IDELargeFile();
+    IDELargeFile( const IDELargeFile& )            = delete;
+    IDELargeFile& operator=( const IDELargeFile& ) = delete;
+    // initialisation ----------------------------------------------------------
+    LibraryError open( const std::string& filename );
+    void         close();
+    // getters -----------------------------------------------------------------
+    bool             isOpen() const;
+    bool             isIndexComplete() const;
+    bool             isTruncated() const;
+    uint32_t         getLineCount() const;
+    uint64_t         getFileSize() const;
+    uint64_t         getIndexedBytes() const;
+    std::string_view getLine( uint32_t line );
+
+  private:
+    // private variables -------------------------------------------------------
+    MappedFile            m_file;          //!< mapped file
+    std::vector<uint64_t> m_checkpoints;   //!< offset of every LINE_INDEX_STEP'th line
+    std::mutex            m_indexLock;     //!< guards m_checkpoints
+    std::thread           m_indexer;       //!< background indexing thread
+    std::atomic<bool>     m_stopIndexing;  //!< asks the indexer to finish early
+    std::atomic<bool>     m_indexComplete; //!< whole file has been indexed
+    std::atomic<uint32_t> m_lineFeeds;     //!< line feeds found so far
+    std::atomic<uint64_t> m_indexedBytes;  //!< bytes scanned so far
+    uint32_t              m_lastLine;      //!< line of the last lookup
+    uint64_t              m_lastOffset;    //!< offset of the last lookup
+    // private functions -------------------------------------------------------
+    void buildIndex( std::string filename );
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: IDELargeFile.h
+// ----------------------------------------------------------------------------
@@ -0,0 +1,106 @@
+/**----------------------------------------------------------------------------
+
+    @file       IDEListView.h
+    @defgroup   NimbleLIBIDE Nimble Library IDE Module
+    @brief      IDEListView class for the Nimble Library
+
+    @copyright  Neil Bereford 2023
+
+Notes:
+
+        please see IDEListView.cpp for full details.
+
+-----------------------------------------------------------------------------*/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Include files
+// ----------------------------------------------------------------------------
+
+#include <cinttypes>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "../../../../ExternalLibraries/PDCurses/curses.h"
+
+//-----------------------------------------------------------------------------
+// Namespace
+// ----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      List view for the Nimble Library
+                Shows a window of rows onto a list of any length with a
+                cursor. Rows are asked for by index, only for the rows on
+                screen, and only rows that have changed are painted.
+-----------------------------------------------------------------------------*/
+class IDEListView
+{
+  public:
+    // types -------------------------------------------------------------------
+    using RowFunction = std::function<void( uint32_t item, std::string& text, uint32_t& colour )>;
+
+    // constructors & destructors ----------------------------------------------
+    IDEListView();
+    // initialisation ----------------------------------------------------------
+    void init( WINDOW* window, uint32_t x, uint32_t y, uint32_t width, uint32_t rows, uint32_t blankColour, RowFunction rowFunction );
+    // setters -----------------------------------------------------------------
+    void setItemCount( uint32_t count );
+    void setCursor( uint32_t item );
+    void moveCursor( int32_t rows );
+    void invalidate();
+    // getters -----------------------------------------------------------------
+    uint32_t getItemCount() const;
+    uint32_t getCursor() const;
+    uint32_t getTop() const;
+    uint32_t getRows() const;
+    // draw --------------------------------------------------------------------
+    uint32_t draw( uint32_t cursorColour );
+
+  private:
+    // constants ---------------------------------------------------------------
+    static const uint32_t NO_ITEM = UINT32_MAX; //!< row shows no item
+
+    /**------------------------------------------------------------------------
+        @ingroup    NimbleLIBIDE Nimble Library IDE Module
+        @brief      What a row of the window was last painted with
+    -------------------------------------------------------------------------*/
+    struct DrawnRow
+    {
+        uint32_t item;     //!< item shown, NO_ITEM for a blank row
+        bool     selected; //!< painted with the cursor
+    };
+
+    // private variables -------------------------------------------------------
+    WINDOW*               m_window;      //!< window the rows are painted on
+    uint32_t              m_x;           //!< column of the rows
+    uint32_t              m_y;           //!< line of the first row
+    uint32_t              m_width;       //!< characters in each row
+    uint32_t              m_rows;        //!< rows on screen
+    uint32_t              m_blankColour; //!< colour of rows past the end of the list
+    RowFunction           m_rowFunction; //!< gets the text and colour of an item
+    uint32_t              m_itemCount;   //!< items in the list
+    uint32_t              m_cursor;      //!< item under the cursor
+    uint32_t              m_top;         //!< item on the first row
+    std::vector<DrawnRow> m_drawn;       //!< rows as last painted
+    std::string           m_text;        //!< row being painted, reused
+    // private functions -------------------------------------------------------
+    void clampCursor();
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: IDEListView.h
+// ----------------------------------------------------------------------------
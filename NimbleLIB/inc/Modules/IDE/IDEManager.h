@@ -17,10 +17,12 @@
 #include <cinttypes>
 #include <cstdint>
 #include <functional>
+#include <string>
 #include <vector>
 
 #include "../ErrorHandling/ErrorHandler.h"
 #include "IDEDialog.h"
+#include "IDEProjectFiles.h"
 #include "IDEWindow.h"
 
 //-----------------------------------------------------------------------------
@@ -42,6 +44,7 @@ enum class ManagerControlID
 {
     ID_LoadFile = 0, //!< Load file ID
     ID_SaveFile,     //!< Save file ID
+    ID_QuickOpen,    //!< Quick open palette ID
     ID_Total         //!< Total number of controls
 };
 
@@ -99,22 +102,27 @@ class IDEManager : public IDEWindow
     const bool redrawNeeded() const;
     void       clearRedrawNeeded();
     uint32_t   getActiveControlCount() const;
+    bool       takeSelectedFile( std::string& filename );
 
   private:
     // variables ---------------------------------------------------------------
     // clang-format off
     IDEManagerControl m_controls[ static_cast<uint32_t>( ManagerControlID::ID_Total ) ] = //!< Controls
     {
-        { ManagerControlID::ID_LoadFile, [ this ]() { this->LoadFileCallback(); }, "Load File", ManagerControlState::NotActive },
-        { ManagerControlID::ID_SaveFile, [ this ]() { this->SaveFileCallback(); }, "Save File", ManagerControlState::NotActive }
+        { ManagerControlID::ID_LoadFile,  [ this ]() { this->LoadFileCallback(); },  "Load File",  ManagerControlState::NotActive },
+        { ManagerControlID::ID_SaveFile,  [ this ]() { this->SaveFileCallback(); },  "Save File",  ManagerControlState::NotActive },
+        { ManagerControlID::ID_QuickOpen, [ this ]() { this->QuickOpenCallback(); }, "Quick Open", ManagerControlState::NotActive }
     };
     // clang-format on
     std::vector<std::unique_ptr<IDEDialog>> activeControls;
     std::vector<ManagerControlID>           activeControlIDs;
     bool                                    m_bRedrawNeeded;
+    IDEProjectFiles                         m_projectFiles; //!< files listed by the quick open palette, kept between uses
+    std::string                             m_selectedFile; //!< file chosen by the quick open palette, not yet taken
     // functions ---------------------------------------------------------------
-    void LoadFileCallback(); //!< Load file callback
-    void SaveFileCallback(); //!< Save file callback
+    void LoadFileCallback();  //!< Load file callback
+    void SaveFileCallback();  //!< Save file callback
+    void QuickOpenCallback(); //!< Quick open callback
 };
 
 //-----------------------------------------------------------------------------
@@ -0,0 +1,161 @@
+/**----------------------------------------------------------------------------
+
+    @file       IDEPieceTable.h
+    @defgroup   NimbleLIBIDE Nimble Library IDE Module
+    @brief      IDEPieceTable class for the Nimble Library
+
+    @copyright  Neil Bereford 2023
+
+-----------------------------------------------------------------------------*/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Include files
+// ----------------------------------------------------------------------------
+
+#include <cinttypes>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../ErrorHandling/ErrorHandler.h"
+
+//-----------------------------------------------------------------------------
+// Namespace
+// ----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Piece table document model for the Nimble Library
+                The text is held in a read only original buffer and an append
+                only add buffer. The document is a sequence of pieces that
+                reference those buffers, kept in a balanced tree (treap) so that
+                offset and line lookups, inserts and erases are O(log n).
+-----------------------------------------------------------------------------*/
+class IDEPieceTable
+{
+  public:
+    // constructors & destructors ----------------------------------------------
+    IDEPieceTable();
+    ~IDEPieceTable();
+    IDEPieceTable( IDEPieceTable&& )            = default;
+    IDEPieceTable& operator=( IDEPieceTable&& ) = default;
+    // initialisation ----------------------------------------------------------
+    void clear();
+    void load( std::string&& text );
+    // getters -----------------------------------------------------------------
+    uint32_t    getLineCount() const;
+    uint32_t    getLineLength( uint32_t line ) const;
+    std::string getLine( uint32_t line ) const;
+    uint8_t     getChar( uint32_t line, uint32_t column ) const;
+    uint64_t    getLength() const;
+    uint64_t    getLineOffset( uint32_t line ) const;
+    uint32_t    getLineAt( uint64_t offset ) const;
+    std::string getText() const;
+    std::string getText( uint64_t offset, uint64_t length ) const;
+    void        getSpans( std::vector<std::string_view>& spans ) const;
+    bool        hasTrailingNewline() const;
+    bool        usesCrlf() const;
+    uint32_t    getPieceCount() const;
+    uint64_t    getEditCount() const;
+    uint64_t    getMemoryUsed() const;
+    // setters -----------------------------------------------------------------
+    void setTrailingNewline( bool trailingNewline );
+    void setCrlf( bool crlf );
+    // editing -----------------------------------------------------------------
+    LibraryError insert( uint32_t line, uint32_t column, const std::string& text );
+    LibraryError erase( uint32_t line, uint32_t column, uint64_t length );
+    LibraryError insertAt( uint64_t offset, const std::string& text );
+    LibraryError eraseAt( uint64_t offset, uint64_t length );
+    LibraryError splitLine( uint32_t line, uint32_t column );
+    LibraryError joinLines( uint32_t line );
+
+  private:
+    // constants ---------------------------------------------------------------
+    static const uint32_t NIL = 0xFFFFFFFF; //!< null node index
+
+    // typedefs and enums ------------------------------------------------------
+    /**------------------------------------------------------------------------
+        @ingroup    NimbleLIBIDE Nimble Library IDE Module
+        @brief      Buffer a piece refers to
+    -------------------------------------------------------------------------*/
+    enum class BufferID : uint8_t
+    {
+        Original = 0, //!< file contents, never modified
+        Add,          //!< appended text, only ever grows
+    };
+
+    /**------------------------------------------------------------------------
+        @ingroup    NimbleLIBIDE Nimble Library IDE Module
+        @brief      Node of the piece tree, one piece plus subtree totals
+    -------------------------------------------------------------------------*/
+    struct PieceNode
+    {
+        uint64_t start;        //!< start offset within the buffer
+        uint64_t length;       //!< length of the piece in bytes
+        uint64_t subLength;    //!< bytes in this subtree
+        uint32_t lineFeeds;    //!< line feeds within the piece
+        uint32_t subLineFeeds; //!< line feeds in this subtree
+        uint32_t left;         //!< left child index
+        uint32_t right;        //!< right child index
+        uint32_t priority;     //!< treap priority
+        BufferID buffer;       //!< buffer the piece refers to
+    };
+
+    // private variables -------------------------------------------------------
+    std::string            m_original;        //!< original (file) buffer
+    std::string            m_add;             //!< append buffer
+    std::vector<uint64_t>  m_originalFeeds;   //!< offsets of '\n' in the original buffer
+    std::vector<uint64_t>  m_addFeeds;        //!< offsets of '\n' in the append buffer
+    std::vector<PieceNode> m_nodes;           //!< node pool
+    std::vector<uint32_t>  m_freeNodes;       //!< recycled node indices
+    uint32_t               m_root;            //!< root of the piece tree
+    uint32_t               m_seed;            //!< priority generator state
+    bool                   m_trailingNewline; //!< loaded text ended with a newline
+    bool                   m_crlf;            //!< loaded text ended its first line with "\r\n"
+    uint64_t               m_editCount;       //!< inserts and erases made, never reset
+
+    // private functions -------------------------------------------------------
+    uint32_t createNode( BufferID buffer, uint64_t start, uint64_t length );
+    void     freeTree( uint32_t node );
+    void     update( uint32_t node );
+    uint64_t subtreeLength( uint32_t node ) const;
+    uint32_t subtreeFeeds( uint32_t node ) const;
+    uint32_t countFeeds( BufferID buffer, uint64_t start, uint64_t length ) const;
+    uint64_t nthFeed( BufferID buffer, uint64_t start, uint32_t n ) const;
+    uint32_t merge( uint32_t left, uint32_t right );
+    void     split( uint32_t node, uint64_t offset, uint32_t& left, uint32_t& right );
+    bool     extendLast( uint32_t node, uint64_t addStart, uint64_t length, uint32_t lineFeeds );
+    void     collect( uint32_t node, uint64_t offset, uint64_t length, std::string& out ) const;
+    void     collectSpans( uint32_t node, std::vector<std::string_view>& spans ) const;
+    bool     toOffset( uint32_t line, uint32_t column, uint64_t& offset ) const;
+    uint64_t lineEnd( uint32_t line ) const;
+
+    /**------------------------------------------------------------------------
+        @ingroup    NimbleLIBIDE Nimble Library IDE Module
+        @brief      returns the buffer text a piece refers to
+        @param      buffer  buffer identifier
+        @return     const std::string&  buffer
+    -------------------------------------------------------------------------*/
+    const std::string& bufferText( BufferID buffer ) const
+    {
+        return ( buffer == BufferID::Original ) ? m_original : m_add;
+    }
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: IDEPieceTable.h
+// ----------------------------------------------------------------------------
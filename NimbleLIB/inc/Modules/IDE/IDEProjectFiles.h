@@ -0,0 +1,115 @@
+/**----------------------------------------------------------------------------
+
+    @file       IDEProjectFiles.h
+    @defgroup   NimbleLIBIDE Nimble Library IDE Module
+    @brief      IDEProjectFiles class for the Nimble Library
+
+    @copyright  Neil Bereford 2023
+
+Notes:
+
+        please see IDEProjectFiles.cpp for full details.
+
+-----------------------------------------------------------------------------*/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Include files
+// ----------------------------------------------------------------------------
+
+#include <atomic>
+#include <cinttypes>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "../ErrorHandling/ErrorHandler.h"
+#include "IDEFuzzyFilter.h"
+
+//-----------------------------------------------------------------------------
+// Namespace
+// ----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      List of every file below a folder, kept in memory
+                The folder is walked again on a thread of its own, reading
+                only the folders that have changed since the last walk, and
+                the names are indexed by an IDEFuzzyFilter as they are.
+                Every function is called from the UI thread.
+-----------------------------------------------------------------------------*/
+class IDEProjectFiles
+{
+  public:
+    // constants ---------------------------------------------------------------
+    static const uint32_t SETTLE_SECONDS = 2; //!< folders written this recently are read again by the next walk
+
+    // constructors & destructors ----------------------------------------------
+    IDEProjectFiles();
+    ~IDEProjectFiles();
+    IDEProjectFiles( const IDEProjectFiles& )            = delete;
+    IDEProjectFiles& operator=( const IDEProjectFiles& ) = delete;
+    // refreshing --------------------------------------------------------------
+    LibraryError refresh( const std::string& folder );
+    bool         poll();
+    void         cancel();
+    // getters -----------------------------------------------------------------
+    bool                            isRefreshing() const;
+    const std::string&              getFolder() const;
+    const std::vector<std::string>& getPaths() const;
+    std::string                     getFullPath( uint32_t item ) const;
+    IDEFuzzyFilter&                 getFilter();
+    uint32_t                        getFoldersRead() const;
+
+  private:
+    /**------------------------------------------------------------------------
+        @ingroup    NimbleLIBIDE Nimble Library IDE Module
+        @brief      Names in a folder when it was last read, sorted
+    -------------------------------------------------------------------------*/
+    struct FolderListing
+    {
+        std::filesystem::file_time_type modified; //!< write time of the folder when read
+        bool                            settled;  //!< read long enough after it was written for the time to be trusted
+        std::vector<std::string>        files;    //!< files in the folder
+        std::vector<std::string>        folders;  //!< folders in the folder, other than those starting with '.'
+    };
+
+    using ListingMap = std::unordered_map<std::string, FolderListing>;
+
+    // private variables -------------------------------------------------------
+    std::string              m_folder;      //!< folder listed
+    std::vector<std::string> m_paths;       //!< every file, relative to m_folder
+    IDEFuzzyFilter           m_filter;      //!< indexes m_paths
+    ListingMap               m_listings;    //!< each folder read, by path relative to m_folder, owned by the worker while it runs
+    std::thread              m_worker;      //!< walks the folder
+    std::atomic<bool>        m_cancelled;   //!< the worker is to stop
+    std::atomic<bool>        m_finished;    //!< the worker has finished, its list can be taken
+    bool                     m_refreshing;  //!< the worker was started and its list not yet taken
+    std::vector<std::string> m_nextPaths;   //!< list built by the worker
+    IDEFuzzyFilter           m_nextFilter;  //!< indexes m_nextPaths
+    bool                     m_nextChanged; //!< m_nextPaths differs from m_paths
+    uint32_t                 m_foldersRead; //!< folders the last walk read, rather than took from m_listings
+
+    // private functions -------------------------------------------------------
+    void walkProject();
+    bool walkFolder( const std::string& relative, ListingMap& listings );
+    void readFolder( const std::filesystem::path& path, FolderListing& listing );
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: IDEProjectFiles.h
+// ----------------------------------------------------------------------------
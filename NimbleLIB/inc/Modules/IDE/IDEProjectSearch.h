@@ -0,0 +1,157 @@
+/**----------------------------------------------------------------------------
+
+    @file       IDEProjectSearch.h
+    @defgroup   NimbleLIBIDE Nimble Library IDE Module
+    @brief      IDEProjectSearch class for the Nimble Library
+
+    @copyright  Neil Bereford 2023
+
+Notes:
+
+        please see IDEProjectSearch.cpp for full details.
+
+-----------------------------------------------------------------------------*/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Include files
+// ----------------------------------------------------------------------------
+
+#include <atomic>
+#include <cinttypes>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "../ErrorHandling/ErrorHandler.h"
+#include "../Utilities/ThreadPool.h"
+#include "IDESearch.h"
+#include "IDETrigramIndex.h"
+
+//-----------------------------------------------------------------------------
+// Namespace
+// ----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Project search for the Nimble Library
+                Searches every file below a folder for a pattern, on a pool
+                of threads, while the UI thread carries on. The lines found
+                are collected with poll() as they arrive.
+-----------------------------------------------------------------------------*/
+class IDEProjectSearch
+{
+  public:
+    /**------------------------------------------------------------------------
+        @ingroup    NimbleLIBIDE Nimble Library IDE Module
+        @brief      A line holding a match
+    -------------------------------------------------------------------------*/
+    struct SearchResult
+    {
+        std::string path;   //!< file holding the match
+        uint32_t    line;   //!< line of the match, from 1
+        uint32_t    column; //!< column of the first match on the line, from 0
+        std::string text;   //!< the line, cut to MAX_LINE_TEXT characters
+    };
+
+    // constants ---------------------------------------------------------------
+    static const uint32_t MAX_RESULTS   = 10000;   //!< lines found before the search stops
+    static const uint32_t MAX_LINE_TEXT = 160;     //!< characters of each line kept
+    static const uint32_t FILE_BATCH    = 16;      //!< files searched by each task
+    static const uint32_t BINARY_CHECK  = 0x2000;  //!< bytes checked for a NUL, which marks a binary file
+    static const uint32_t SMALL_FILE    = 0x40000; //!< files shorter than this are read rather than mapped
+
+    // constructors & destructors ----------------------------------------------
+    IDEProjectSearch();
+    ~IDEProjectSearch();
+    IDEProjectSearch( const IDEProjectSearch& )            = delete;
+    IDEProjectSearch& operator=( const IDEProjectSearch& ) = delete;
+    // searching ---------------------------------------------------------------
+    LibraryError start( const std::string& folder, const std::string& pattern, bool matchCase, bool wholeWord );
+    bool         poll( std::vector<SearchResult>& results );
+    void         cancel();
+    void         setIndexed( bool indexed );
+    // getters -----------------------------------------------------------------
+    bool               isSearching() const;
+    bool               isTruncated() const;
+    bool               isIndexed() const;
+    const std::string& getPattern() const;
+    uint64_t           getFilesSearched() const;
+    uint64_t           getFilesSkipped() const;
+    uint64_t           getMatchCount() const;
+    uint64_t           getFilesIndexed() const;
+    // helpers -----------------------------------------------------------------
+    static bool isBinary( const char* data, uint64_t size );
+
+  private:
+    /**------------------------------------------------------------------------
+        @ingroup    NimbleLIBIDE Nimble Library IDE Module
+        @brief      One search, shared by its tasks, which may outlive it
+                    when it is cancelled
+    -------------------------------------------------------------------------*/
+    struct SearchState
+    {
+        IDESearch                 search;        //!< pattern, only read once the search starts
+        std::atomic<bool>         cancelled;     //!< tasks are to stop
+        std::atomic<uint32_t>     unfinished;    //!< tasks submitted and not yet finished
+        std::atomic<uint64_t>     filesSearched; //!< files read
+        std::atomic<uint64_t>     filesSkipped;  //!< binary files, and files that could not be read
+        std::atomic<uint64_t>     matchCount;    //!< lines found
+        std::atomic<uint64_t>     filesIndexed;  //!< files added to the index
+        std::mutex                lock;          //!< guards found
+        std::vector<SearchResult> found;         //!< lines found and not yet polled
+        IDETrigramIndex*          index;         //!< index used, nullptr if every file is searched
+        IDETrigramIndex::Update   update;        //!< changes to the index found by the walk
+        std::vector<uint8_t>      candidate;     //!< files the index found, already searched
+        bool                      searchAll;     //!< the index could not narrow the search
+    };
+
+    /**------------------------------------------------------------------------
+        @ingroup    NimbleLIBIDE Nimble Library IDE Module
+        @brief      A file that is not in the index as it is now
+    -------------------------------------------------------------------------*/
+    struct ChangedFile
+    {
+        std::string                path;     //!< path to read
+        std::string                relative; //!< path in the index
+        uint32_t                   file;     //!< file in the index, NOT_INDEXED if new
+        IDETrigramIndex::FileStamp stamp;    //!< stamp of the file now
+    };
+
+    // private variables -------------------------------------------------------
+    std::shared_ptr<SearchState>     m_state;      //!< search running, or last run
+    std::string                      m_pattern;    //!< pattern of m_state
+    std::unique_ptr<ThreadPool>      m_pool;       //!< workers, started by the first search
+    std::unique_ptr<IDETrigramIndex> m_index;      //!< index of the folder searched
+    std::shared_ptr<SearchState>     m_indexState; //!< last search to use m_index
+    bool                             m_indexed;    //!< searches use the index
+
+    // private functions -------------------------------------------------------
+    void submit( const std::shared_ptr<SearchState>& state, ThreadPool::Task task );
+    void walkFolder( const std::shared_ptr<SearchState>& state, const std::string& folder );
+    void searchFiles( const std::shared_ptr<SearchState>& state, const std::vector<std::string>& files );
+    void searchIndexed( const std::shared_ptr<SearchState>& state, const std::string& folder, const std::string& pattern );
+    void walkIndexed( const std::shared_ptr<SearchState>& state, const std::string& folder, const std::string& relative );
+    void indexFiles( const std::shared_ptr<SearchState>& state, const std::vector<ChangedFile>& files );
+    static void finishIndexed( SearchState& state );
+    static void searchFile( SearchState& state, const std::string& path, std::vector<SearchResult>& results );
+    static bool readFile( const std::string& path, MappedFile& file, const char*& data, uint64_t& size );
+    static void searchData( SearchState& state, const std::string& path, const char* data, uint64_t size, std::vector<SearchResult>& results );
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: IDEProjectSearch.h
+// ----------------------------------------------------------------------------
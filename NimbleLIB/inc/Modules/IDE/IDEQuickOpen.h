@@ -0,0 +1,110 @@
+/**----------------------------------------------------------------------------
+
+    @file       IDEQuickOpen.h
+    @defgroup   NimbleLIBIDE Nimble Library IDE Module
+    @brief      IDEQuickOpen class for the Nimble Library
+
+    @copyright  Neil Bereford 2023
+
+Notes:
+
+        please see IDEQuickOpen.cpp for full details.
+
+-----------------------------------------------------------------------------*/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Include files
+// ----------------------------------------------------------------------------
+
+#include <string>
+#include <vector>
+#include "IDEDialog.h"
+#include "IDEListView.h"
+#include "IDEProjectFiles.h"
+
+//-----------------------------------------------------------------------------
+// Namespace
+// ----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Quick open palette, every file of the project narrowed to
+                those matching the characters typed, best match first
+-----------------------------------------------------------------------------*/
+class IDEQuickOpen : public IDEDialog
+{
+  public:
+    // constructor & destructor -----------------------------------------------
+    IDEQuickOpen();
+    ~IDEQuickOpen();
+    // constants --------------------------------------------------------------
+    static const uint32_t m_kDialogWidth  = 70;
+    static const uint32_t m_kDialogHeight = 25;
+    static const uint32_t m_kListWidth    = 62; //!< characters of a path shown
+    static const uint32_t m_kMaxFilter    = 60; //!< characters typed into the filter at most
+    // initialisation ---------------------------------------------------------
+    LibraryError initQuickOpen( IDEProjectFiles& files, const std::string titleDialog );
+    // Getters functions ------------------------------------------------------
+    const std::string& getFilename() const;
+    bool               isCompleted() const;
+    bool               isCancelled() const;
+    uint64_t           getFilterTime() const;
+    // Process ----------------------------------------------------------------
+    LibraryError processKeyPress( uint32_t ch );
+    // Draw -------------------------------------------------------------------
+    LibraryError drawQuickOpen();
+
+  private:
+    // cursor control ---------------------------------------------------------
+    KeyMap m_keyMapCursorControl = {
+        "CursorControl", {KEY_UP, KEY_DOWN, KEY_PPAGE, KEY_NPAGE, KEY_HOME, KEY_END},
+         std::bind( &IDEQuickOpen::cursorControl, this, std::placeholders::_1 )
+    };
+
+    KeyMap m_keyMapDialogControl = {
+        "DialogControl", {KEY_ESC, KEY_ENTER, '\n'},
+         std::bind( &IDEQuickOpen::dialogControl, this, std::placeholders::_1 )
+    };
+
+    // keys typed into the filter, filled in by initQuickOpen()
+    KeyMap m_keyMapFilterControl = {
+        "FilterControl", {},
+         std::bind( &IDEQuickOpen::filterControl, this, std::placeholders::_1 )
+    };
+
+    // private member variables -----------------------------------------------
+    IDEProjectFiles*      m_files;       //!< files of the project, owned by the IDEManager
+    std::string           m_titleDialog; //!< Title of the dialog
+    std::string           m_filename;    //!< path of the file chosen
+    std::vector<uint32_t> m_visible;     //!< files shown, best match first, by index into the paths
+    std::string           m_query;       //!< Filter typed
+    IDEListView           m_listView;    //!< Shows the files on screen
+    uint64_t              m_filterTime;  //!< microseconds the last filter took
+    bool                  m_completed;   //!< Completed
+    bool                  m_cancelled;   //!< Cancelled
+    // private functions -------------------------------------------------------
+    void cursorControl( uint32_t key );
+    void dialogControl( uint32_t key );
+    void filterControl( uint32_t key );
+    void applyFilter();
+    void getRow( uint32_t item, std::string& text, uint32_t& colour ) const;
+    void updateStatus();
+    //-------------------------------------------------------------------------
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: IDEQuickOpen.h
+// ----------------------------------------------------------------------------
@@ -0,0 +1,101 @@
+/**----------------------------------------------------------------------------
+
+    @file       IDESearch.h
+    @defgroup   NimbleLIBIDE Nimble Library IDE Module
+    @brief      IDESearch class for the Nimble Library
+
+    @copyright  Neil Bereford 2023
+
+Notes:
+
+        please see IDESearch.cpp for full details.
+
+-----------------------------------------------------------------------------*/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Include files
+// ----------------------------------------------------------------------------
+
+#include <cinttypes>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+// Namespace
+// ----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Substring search for the Nimble Library
+                Finds a pattern in a block of text, optionally ignoring case
+                and only matching whole words. Candidates are found by
+                comparing the first and last bytes of the pattern 32 or 16
+                positions at a time, then checked in full. Text held in
+                pieces, as IDEPieceTable spans, is searched in place.
+-----------------------------------------------------------------------------*/
+class IDESearch
+{
+  public:
+    // constants ---------------------------------------------------------------
+    static const uint64_t NOT_FOUND = UINT64_MAX; //!< returned when there is no match
+
+    // constructors & destructors ----------------------------------------------
+    IDESearch();
+    ~IDESearch();
+    // setters -----------------------------------------------------------------
+    void setPattern( const std::string& pattern, bool matchCase, bool wholeWord );
+    // getters -----------------------------------------------------------------
+    const std::string& getPattern() const;
+    bool               isMatchCase() const;
+    bool               isWholeWord() const;
+    // searching ---------------------------------------------------------------
+    uint64_t findNext( const char* data, uint64_t size, uint64_t from ) const;
+    uint64_t findPrevious( const char* data, uint64_t size, uint64_t before ) const;
+    uint64_t findAll( const char* data, uint64_t size, std::vector<uint64_t>& matches ) const;
+    uint64_t findNext( const std::vector<std::string_view>& spans, uint64_t from ) const;
+    uint64_t findPrevious( const std::vector<std::string_view>& spans, uint64_t before ) const;
+    uint64_t findAll( const std::vector<std::string_view>& spans, std::vector<uint64_t>& matches ) const;
+    // cpu support -------------------------------------------------------------
+    static bool isAvx2Supported();
+
+  private:
+    // private variables -------------------------------------------------------
+    std::string m_pattern;   //!< text to find
+    bool        m_matchCase; //!< case must match
+    bool        m_wholeWord; //!< match must not be part of a longer word
+    uint8_t     m_first;     //!< first byte of the pattern, folded if ignoring case
+    uint8_t     m_last;      //!< last byte of the pattern, folded if ignoring case
+    uint8_t     m_firstFold; //!< OR'd into text bytes before comparing with m_first
+    uint8_t     m_lastFold;  //!< OR'd into text bytes before comparing with m_last
+    bool        m_useAvx2;   //!< AVX2 is available for the candidate scan
+
+    // private functions -------------------------------------------------------
+    uint64_t nextCandidate( const char* data, uint64_t size, uint64_t from ) const;
+    uint64_t scanScalar( const char* data, uint64_t size, uint64_t from ) const;
+    uint64_t scanSse2( const char* data, uint64_t size, uint64_t from ) const;
+    uint64_t scanAvx2( const char* data, uint64_t size, uint64_t from ) const;
+    bool     isMatch( const char* data, uint64_t size, uint64_t position ) const;
+    bool     isWordChar( uint8_t ch ) const;
+    uint64_t findNextInSpans( const std::vector<std::string_view>& spans, uint64_t from, size_t& index, uint64_t& base ) const;
+    uint64_t findAcrossSpans( const std::vector<std::string_view>& spans, size_t index, uint64_t base, uint64_t from, uint64_t before, bool lastMatch ) const;
+    bool     isSpanWordEdge( const std::vector<std::string_view>& spans, size_t index, uint64_t base, uint64_t position ) const;
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: IDESearch.h
+// ----------------------------------------------------------------------------
@@ -0,0 +1,144 @@
+/**----------------------------------------------------------------------------
+
+    @file       IDESyntax.h
+    @defgroup   NimbleLIBIDE Nimble Library IDE Module
+    @brief      IDESyntax class for the Nimble Library
+
+    @copyright  Neil Bereford 2023
+
+Notes:
+
+        please see IDESyntax.cpp for full details.
+
+-----------------------------------------------------------------------------*/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Include files
+// ----------------------------------------------------------------------------
+
+#include <cinttypes>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "IDEPieceTable.h"
+
+//-----------------------------------------------------------------------------
+// Namespace
+// ----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      C / C++ syntax highlighter for the Nimble Library
+                Splits a line into coloured token runs. The lexer state at
+                the end of every line is cached, so after an edit only the
+                edited lines and the lines whose start state changed are
+                lexed again.
+-----------------------------------------------------------------------------*/
+class IDESyntax
+{
+  public:
+    // constants ---------------------------------------------------------------
+    static const uint32_t NO_CHANGE     = 0xFFFFFFFF; //!< no line changed state
+    static const uint32_t MAX_DELIMITER = 16;         //!< longest raw string delimiter
+
+    // typedefs and enums ------------------------------------------------------
+    /**------------------------------------------------------------------------
+        @ingroup    NimbleLIBIDE Nimble Library IDE Module
+        @brief      Token types, each has its own colour
+    -------------------------------------------------------------------------*/
+    enum class TokenType : uint8_t
+    {
+        Text = 0,     //!< identifiers, operators and anything else
+        Keyword,      //!< language keywords
+        Type,         //!< built in and standard integer types
+        Preprocessor, //!< preprocessor directives
+        Number,       //!< numeric literals
+        String,       //!< string and character literals
+        Comment,      //!< line and block comments
+        Total         //!< number of token types
+    };
+
+    /**------------------------------------------------------------------------
+        @ingroup    NimbleLIBIDE Nimble Library IDE Module
+        @brief      What the lexer is inside at the end of a line
+    -------------------------------------------------------------------------*/
+    enum class LexMode : uint8_t
+    {
+        Normal = 0,   //!< nothing carries on to the next line
+        BlockComment, //!< inside a block comment
+        RawString,    //!< inside a raw string literal
+        String,       //!< string literal continued with a backslash
+        LineComment,  //!< line comment continued with a backslash
+    };
+
+    /**------------------------------------------------------------------------
+        @ingroup    NimbleLIBIDE Nimble Library IDE Module
+        @brief      Lexer state at the end of a line
+    -------------------------------------------------------------------------*/
+    struct LexState
+    {
+        LexMode mode;                       //!< what the lexer is inside
+        uint8_t delimiterLength;            //!< length of the raw string delimiter
+        char    delimiter[ MAX_DELIMITER ]; //!< raw string delimiter
+
+        bool operator==( const LexState& other ) const;
+    };
+
+    /**------------------------------------------------------------------------
+        @ingroup    NimbleLIBIDE Nimble Library IDE Module
+        @brief      A run of one token type within a line
+    -------------------------------------------------------------------------*/
+    struct TokenRun
+    {
+        uint32_t  start;  //!< column the run starts at
+        uint32_t  length; //!< length of the run
+        TokenType type;   //!< token type of the run
+    };
+
+    // constructors & destructors ----------------------------------------------
+    IDESyntax();
+    ~IDESyntax();
+    // line cache --------------------------------------------------------------
+    void     clear();
+    void     linesChanged( uint32_t line, uint32_t oldCount, uint32_t newCount );
+    bool     update( const IDEPieceTable& document, uint32_t lastLine, uint32_t& firstChanged, uint32_t& lastChanged );
+    LexState getStartState( uint32_t line ) const;
+    uint32_t getLinesLexed() const;
+    // lexing ------------------------------------------------------------------
+    static LexState lexLine( std::string_view line, const LexState& start, std::vector<TokenRun>* runs );
+    static LexState initialState();
+    static bool     isSourceFile( const std::string& filename );
+
+  private:
+    // private variables -------------------------------------------------------
+    std::vector<LexState> m_lineEnd;    //!< lexer state at the end of each line
+    uint32_t              m_dirtyFrom;  //!< first line whose end state may be out of date
+    uint32_t              m_dirtyTo;    //!< last line edited, states can only settle after it
+    uint32_t              m_lexedTo;    //!< lines below this have been lexed at least once
+    uint32_t              m_linesLexed; //!< lines lexed by update(), for measuring
+
+    // private functions -------------------------------------------------------
+    static TokenType findKeyword( std::string_view word );
+    static uint32_t  scanQuoted( std::string_view line, uint32_t pos, char quote, bool& continued );
+    static uint32_t  scanRawString( std::string_view line, uint32_t pos, const LexState& state );
+    static void      addRun( std::vector<TokenRun>* runs, uint32_t start, uint32_t end, TokenType type );
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: IDESyntax.h
+// ----------------------------------------------------------------------------
@@ -0,0 +1,207 @@
+/**----------------------------------------------------------------------------
+
+    @file       IDETrigramIndex.h
+    @defgroup   NimbleLIBIDE Nimble Library IDE Module
+    @brief      IDETrigramIndex class for the Nimble Library
+
+    @copyright  Neil Bereford 2023
+
+Notes:
+
+        please see IDETrigramIndex.cpp for full details.
+
+-----------------------------------------------------------------------------*/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Include files
+// ----------------------------------------------------------------------------
+
+#include <cinttypes>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "../ErrorHandling/ErrorHandler.h"
+#include "../FileHandling/MappedFile.h"
+
+//-----------------------------------------------------------------------------
+// Namespace
+// ----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Trigram index of the files below a folder, kept on disk
+                For every three characters it lists the files holding them,
+                so a search need only read the files that could match.
+-----------------------------------------------------------------------------*/
+class IDETrigramIndex
+{
+  public:
+    /**------------------------------------------------------------------------
+        @ingroup    NimbleLIBIDE Nimble Library IDE Module
+        @brief      When a file was last written, and its length
+    -------------------------------------------------------------------------*/
+    struct FileStamp
+    {
+        int64_t  modified; //!< last write time, in the file clock's ticks
+        uint64_t size;     //!< length in bytes
+    };
+
+    /**------------------------------------------------------------------------
+        @ingroup    NimbleLIBIDE Nimble Library IDE Module
+        @brief      A file added to the index, or whose contents changed
+    -------------------------------------------------------------------------*/
+    struct AddedFile
+    {
+        std::string          path;     //!< relative to the folder indexed
+        uint32_t             replaces; //!< file it replaces, NOT_INDEXED if new
+        FileStamp            stamp;    //!< stamp when it was read
+        uint32_t             crc;      //!< CRC-32C of the contents
+        uint32_t             flags;    //!< FLAG_BINARY or FLAG_UNINDEXED
+        std::vector<uint8_t> trigrams; //!< sorted trigrams, delta and varint encoded
+    };
+
+    /**------------------------------------------------------------------------
+        @ingroup    NimbleLIBIDE Nimble Library IDE Module
+        @brief      Changes found while a folder is walked, filled in by many
+                    threads and written by commit()
+    -------------------------------------------------------------------------*/
+    struct Update
+    {
+        std::mutex                                  lock;     //!< guards added and touched
+        std::vector<uint8_t>                        seen;     //!< files found by the walk, one byte each
+        std::vector<AddedFile>                      added;    //!< files to add
+        std::vector<std::pair<uint32_t, FileStamp>> touched;  //!< files written again with the same contents
+        bool                                        complete; //!< the whole folder was walked, files not seen are removed
+    };
+
+    // constants ---------------------------------------------------------------
+    static const uint32_t        NOT_INDEXED      = 0xFFFFFFFF;             //!< file is not in the index
+    static const uint32_t        VERSION          = 1;                      //!< version of the index file
+    static const uint32_t        FLAG_REMOVED     = 0x01;                   //!< file removed or replaced, its postings are ignored
+    static const uint32_t        FLAG_BINARY      = 0x02;                   //!< binary file, never searched
+    static const uint32_t        FLAG_UNINDEXED   = 0x04;                   //!< file too long to index, always searched
+    static const uint64_t        MAX_INDEXED_SIZE = 0x1000000;              //!< files longer than this are not indexed
+    static const uint32_t        COMPACT_SHARE    = 4;                      //!< files are renumbered once 1 / COMPACT_SHARE are removed
+    static constexpr const char* INDEX_FILE       = ".nimble/trigrams.idx"; //!< index, below the folder indexed
+
+    // constructors & destructors ----------------------------------------------
+    IDETrigramIndex();
+    ~IDETrigramIndex();
+    IDETrigramIndex( const IDETrigramIndex& )            = delete;
+    IDETrigramIndex& operator=( const IDETrigramIndex& ) = delete;
+    // index file --------------------------------------------------------------
+    LibraryError open( const std::string& folder );
+    void         close();
+    // searching ---------------------------------------------------------------
+    bool query( const std::string& pattern, std::vector<uint32_t>& files ) const;
+    // updating ----------------------------------------------------------------
+    void         beginUpdate( Update& update ) const;
+    void         markSeen( Update& update, uint32_t file ) const;
+    bool         updateFile( Update& update, uint32_t file, const std::string& path, const FileStamp& stamp, const char* data, uint64_t size, bool binary ) const;
+    LibraryError commit( Update& update );
+    // getters -----------------------------------------------------------------
+    const std::string& getFolder() const;
+    uint32_t           getFileCount() const;
+    uint32_t           getTrigramCount() const;
+    uint32_t           getRemovedCount() const;
+    uint32_t           findFile( std::string_view path ) const;
+    std::string_view   getPath( uint32_t file ) const;
+    uint32_t           getFlags( uint32_t file ) const;
+    bool               isCurrent( uint32_t file, const FileStamp& stamp ) const;
+    // helpers -----------------------------------------------------------------
+    static void extractTrigrams( const char* data, uint64_t size, std::vector<uint32_t>& trigrams );
+
+  private:
+    /**------------------------------------------------------------------------
+        @ingroup    NimbleLIBIDE Nimble Library IDE Module
+        @brief      Start of the index file
+    -------------------------------------------------------------------------*/
+    struct IndexHeader
+    {
+        char     magic[4];     //!< "NTRI"
+        uint32_t version;      //!< VERSION
+        uint32_t fileCount;    //!< FileRecords, removed files included
+        uint32_t trigramCount; //!< TrigramRecords
+        uint32_t removedCount; //!< files marked FLAG_REMOVED
+        uint32_t reserved;     //!< zero
+        uint64_t namesSize;    //!< bytes of file names
+        uint64_t postingsSize; //!< bytes of posting lists
+    };
+
+    /**------------------------------------------------------------------------
+        @ingroup    NimbleLIBIDE Nimble Library IDE Module
+        @brief      A file in the index, its number is its place in the table
+    -------------------------------------------------------------------------*/
+    struct FileRecord
+    {
+        FileStamp stamp;      //!< stamp when it was indexed
+        uint32_t  nameOffset; //!< start of the path in the names
+        uint32_t  nameLength; //!< length of the path
+        uint32_t  crc;        //!< CRC-32C of the contents
+        uint32_t  flags;      //!< FLAG_ values
+    };
+
+    /**------------------------------------------------------------------------
+        @ingroup    NimbleLIBIDE Nimble Library IDE Module
+        @brief      A trigram and the files holding it, the table is sorted
+                    by trigram
+    -------------------------------------------------------------------------*/
+    struct TrigramRecord
+    {
+        uint32_t trigram;  //!< three characters, folded to lower case
+        uint32_t count;    //!< files in the posting list
+        uint32_t lastFile; //!< last file in the list, new files follow it
+        uint32_t reserved; //!< zero
+        uint64_t offset;   //!< start of the posting list in the postings
+    };
+
+    /**------------------------------------------------------------------------
+        @ingroup    NimbleLIBIDE Nimble Library IDE Module
+        @brief      Posting list of a trigram built by commit()
+    -------------------------------------------------------------------------*/
+    struct PostingList
+    {
+        uint32_t             count = 0; //!< files in the list
+        uint32_t             first = 0; //!< first file
+        uint32_t             last  = 0; //!< last file
+        std::vector<uint8_t> gaps;      //!< files after the first, as gaps
+    };
+
+    // private variables -------------------------------------------------------
+    std::string                                    m_folder;    //!< folder indexed
+    MappedFile                                     m_file;      //!< index file
+    const IndexHeader*                             m_header;    //!< header, nullptr if there is no index
+    const FileRecord*                              m_files;     //!< file table
+    const TrigramRecord*                           m_trigrams;  //!< trigram table
+    const char*                                    m_names;     //!< file names
+    const uint8_t*                                 m_postings;  //!< posting lists
+    std::unordered_map<std::string_view, uint32_t> m_lookup;    //!< file number of each path
+    std::vector<uint32_t>                          m_unindexed; //!< files always searched
+
+    // private functions -------------------------------------------------------
+    bool                 mapIndex();
+    const TrigramRecord* findTrigram( uint32_t trigram ) const;
+    void                 readPostings( const TrigramRecord& record, std::vector<uint32_t>& files ) const;
+    static void          putVarint( std::vector<uint8_t>& bytes, uint32_t value );
+    static uint32_t      getVarint( const uint8_t*& bytes, const uint8_t* end );
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: IDETrigramIndex.h
+// ----------------------------------------------------------------------------
@@ -0,0 +1,143 @@
+/**----------------------------------------------------------------------------
+
+    @file       IDEUndoJournal.h
+    @defgroup   NimbleLIBIDE Nimble Library IDE Module
+    @brief      IDEUndoJournal class for the Nimble Library
+
+    @copyright  Neil Bereford 2023
+
+Notes:
+
+        please see IDEUndoJournal.cpp for full details.
+
+-----------------------------------------------------------------------------*/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Include files
+// ----------------------------------------------------------------------------
+
+#include <cinttypes>
+#include <cstdint>
+#include <deque>
+#include <string>
+
+#include "IDEPieceTable.h"
+
+//-----------------------------------------------------------------------------
+// Namespace
+// ----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Undo / redo journal for the Nimble Library
+                Records the inserts and erases made to a document, with the
+                cursor before and after, and replays them backwards or
+                forwards. Only the text of each edit is stored.
+-----------------------------------------------------------------------------*/
+class IDEUndoJournal
+{
+  public:
+    // constants ---------------------------------------------------------------
+    static const uint64_t DEFAULT_BYTE_BUDGET = 0x01000000; //!< journal memory budget, 16MB
+
+    // typedefs and enums ------------------------------------------------------
+    /**------------------------------------------------------------------------
+        @ingroup    NimbleLIBIDE Nimble Library IDE Module
+        @brief      Editor cursor and scroll position, restored by undo/redo
+    -------------------------------------------------------------------------*/
+    struct CursorState
+    {
+        int32_t  currentLine;   //!< first line shown
+        int32_t  currentColumn; //!< first column shown
+        uint32_t cursorX;       //!< cursor x position in the window
+        uint32_t cursorY;       //!< cursor y position in the window
+    };
+
+    // constructors & destructors ----------------------------------------------
+    IDEUndoJournal( uint64_t byteBudget = DEFAULT_BYTE_BUDGET );
+    ~IDEUndoJournal();
+    IDEUndoJournal( IDEUndoJournal&& )            = default;
+    IDEUndoJournal& operator=( IDEUndoJournal&& ) = default;
+    // recording ---------------------------------------------------------------
+    void recordInsert( uint64_t offset, const std::string& text, const CursorState& before );
+    void recordErase( uint64_t offset, const std::string& text, const CursorState& before );
+    void setCursorAfter( const CursorState& after );
+    void closeStep();
+    void beginGroup();
+    void endGroup();
+    void clear();
+    // undo / redo -------------------------------------------------------------
+    bool undo( IDEPieceTable& document, CursorState& cursor );
+    bool redo( IDEPieceTable& document, CursorState& cursor );
+    // getters -----------------------------------------------------------------
+    bool     canUndo() const;
+    bool     canRedo() const;
+    bool     canRecordStep( uint64_t edits, uint64_t textBytes ) const;
+    uint32_t getUndoSteps() const;
+    uint32_t getRedoSteps() const;
+    uint64_t getBytesUsed() const;
+    uint64_t getByteBudget() const;
+    // setters -----------------------------------------------------------------
+    void setByteBudget( uint64_t byteBudget );
+
+  private:
+    // typedefs and enums ------------------------------------------------------
+    /**------------------------------------------------------------------------
+        @ingroup    NimbleLIBIDE Nimble Library IDE Module
+        @brief      Type of edit recorded
+    -------------------------------------------------------------------------*/
+    enum class EditType : uint8_t
+    {
+        Insert = 0, //!< text was inserted at the offset
+        Erase,      //!< text was erased from the offset
+    };
+
+    /**------------------------------------------------------------------------
+        @ingroup    NimbleLIBIDE Nimble Library IDE Module
+        @brief      One recorded edit, a step is one or more edits
+    -------------------------------------------------------------------------*/
+    struct EditRecord
+    {
+        uint64_t    offset; //!< document offset of the edit
+        std::string text;   //!< text inserted or erased
+        CursorState before; //!< cursor before the edit
+        CursorState after;  //!< cursor after the edit
+        uint32_t    step;   //!< step the edit belongs to, undone together
+        EditType    type;   //!< insert or erase
+    };
+
+    // private variables -------------------------------------------------------
+    std::deque<EditRecord> m_undo;       //!< edits that can be undone, newest at the back
+    std::deque<EditRecord> m_redo;       //!< edits that can be redone, next at the back
+    uint64_t               m_byteBudget; //!< most bytes the journal may hold
+    uint64_t               m_bytesUsed;  //!< bytes held by both lists
+    uint32_t               m_undoSteps;  //!< steps in m_undo
+    uint32_t               m_redoSteps;  //!< steps in m_redo
+    uint32_t               m_lastStep;   //!< number of the newest step
+    uint32_t               m_groupDepth; //!< open beginGroup() calls
+    bool                   m_stepOpen;   //!< next edit may join the last step
+
+    // private functions -------------------------------------------------------
+    void     record( EditType type, uint64_t offset, const std::string& text, const CursorState& before );
+    bool     coalesce( EditType type, uint64_t offset, const std::string& text );
+    void     clearRedo();
+    void     trim();
+    uint64_t recordBytes( const EditRecord& record ) const;
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: IDEUndoJournal.h
+// ----------------------------------------------------------------------------
@@ -13,10 +13,15 @@
 // Includes
 //-----------------------------------------------------------------------------
 
+#include <atomic>
+#include <cstdint>
+#include <deque>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <string>
-#include <fstream>
+#include <thread>
 #include <vector>
 #include "../ErrorHandling/Errors.h"
 
@@ -40,10 +45,20 @@ namespace Nimble
 class Logger
 {
   public:
+    // Constants ------------------------------------------------------------
+    static const uint32_t RING_RECORDS       = 1024;       //!< records queued before logging drops, a power of 2
+    static const uint32_t PAYLOAD_SIZE       = 480;        //!< message bytes kept in a record, longer is cut short
+    static const uint32_t HISTORY_LINES      = 1024;       //!< lines kept for saveLog()
+    static const uint64_t DEFAULT_FILE_SIZE  = 0x00100000; //!< log file size before it is rotated, 1MB
+    static const uint32_t DEFAULT_FILE_COUNT = 3;          //!< log files kept, the current one and older ones
+    static const uint32_t BATCH_DELAY_MS     = 2;          //!< writer waits this long after waking to gather records
+
     // Public Methods -------------------------------------------------------
     // Constructor / Destructor ---------------------------------------------
     Logger();
     ~Logger();
+    Logger( const Logger& )            = delete;
+    Logger& operator=( const Logger& ) = delete;
 
     // intialization --------------------------------------------------------
     void loggerInitialize();
@@ -52,16 +67,66 @@ class Logger
     LibraryError LogMessage( const std::string& message );
     LibraryError LogError( LibraryError error, const std::string& message );
 
+    // Output of log data ---------------------------------------------------
+    void         setOutputTerminal( bool enabled );
+    LibraryError setOutputFile( const std::string& fileName, uint64_t fileSize = DEFAULT_FILE_SIZE, uint32_t fileCount = DEFAULT_FILE_COUNT );
+    void         closeOutputFile();
+    virtual void flush();
+    uint64_t     getDroppedCount() const;
+
     // Control of log data --------------------------------------------------
-    void clearLog();
-    void saveLog();
+    void         clearLog();
+    LibraryError saveLog();
 
   private:
+    // Private Types --------------------------------------------------------
+    /**-----------------------------------------------------------------------
+        @ingroup    NimbleLIBLogger Nimble Library Logger Module
+        @brief      One queued log entry, a cell of the ring. The sequence
+                    says whether the cell is free or holds a record.
+      ----------------------------------------------------------------------*/
+    struct alignas( 64 ) LogRecord
+    {
+        std::atomic<uint64_t> sequence;              //!< ring position the cell is ready for
+        int64_t               ticks;                 //!< nanoseconds since the epoch, system clock
+        LibraryError          error;                 //!< error logged, No_Error for a message
+        uint16_t              length;                //!< bytes of payload used
+        char                  payload[PAYLOAD_SIZE]; //!< message text, not terminated
+    };
+
     // Private Data ---------------------------------------------------------
-    std::vector<std::string> loggedInformation; //!< Internal store of all logged messaages
-    bool                     loggerInitialized; //!< True, if the logger has been initialized
-    bool                     outputTerminal;    //!< True, will display on stdout to the terminal
-    bool                     outputFile;        //!< True, will log directly to file, not need to save log
+    std::unique_ptr<LogRecord[]>        ring;              //!< MPSC ring of RING_RECORDS records
+    alignas( 64 ) std::atomic<uint64_t> enqueuePosition;   //!< next ring position a caller claims
+    alignas( 64 ) std::atomic<uint64_t> writtenCount;      //!< records the writer has output
+    std::atomic<uint64_t>               droppedCount;      //!< records dropped as the ring was full
+    std::atomic<bool>                   writerSleeping;    //!< writer is waiting for records
+    std::atomic<uint32_t>               writerWake;        //!< bumped to wake the writer
+    std::atomic<bool>                   stopWriter;        //!< writer drains the ring and ends
+    std::thread                         writerThread;      //!< formats and outputs the records
+    uint64_t                            dequeuePosition;   //!< next ring position the writer reads, writer only
+    uint64_t                            droppedReported;   //!< dropped records already reported, writer only
+    int64_t                             stampSecond;       //!< second stampText was made for, writer only
+    std::string                         stampText;         //!< formatted time stamp of stampSecond, writer only
+    std::mutex                          sinkMutex;         //!< guards the file and terminal output
+    std::ofstream                       logFile;           //!< log file being written, if outputFile
+    std::string                         logFileName;       //!< name of the log file
+    uint64_t                            logFileSize;       //!< bytes in the log file
+    uint64_t                            maxFileSize;       //!< log file size before rotating
+    uint32_t                            maxFiles;          //!< log files kept when rotating
+    std::mutex                          historyMutex;      //!< guards loggedInformation
+    std::deque<std::string>             loggedInformation; //!< last HISTORY_LINES logged lines
+    bool                                loggerInitialized; //!< True, if the logger has been initialized
+    std::atomic<bool>                   outputTerminal;    //!< True, will display on stdout to the terminal
+    std::atomic<bool>                   outputFile;        //!< True, will log directly to file, not need to save log
+
+    // Private functions ----------------------------------------------------
+    LibraryError pushRecord( LibraryError error, const std::string& message );
+    void         wakeWriter();
+    void         writerLoop();
+    uint64_t     drainRecords( std::string& batch );
+    void         formatStamp( int64_t ticks );
+    void         writeBatch( const std::string& batch );
+    void         rotateFile();
 };
 
 //---------------------------------------------------------------------------
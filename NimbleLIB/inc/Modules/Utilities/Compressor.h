@@ -0,0 +1,67 @@
+/**----------------------------------------------------------------------------
+
+    @file       Compressor.h
+    @defgroup   NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      Compressor class for the Nimble Library
+
+    @copyright  Neil Bereford 2023
+
+Notes:
+
+        please see Compressor.cpp for full details.
+
+-----------------------------------------------------------------------------*/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Include files
+// ----------------------------------------------------------------------------
+
+#include <cinttypes>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+//-----------------------------------------------------------------------------
+// Namespace
+// ----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      Fast LZ77 compressor for the Nimble Library
+                Used to hold text that is not being worked on in less memory,
+                it trades ratio for speed.
+-----------------------------------------------------------------------------*/
+class Compressor
+{
+  public:
+    // constants ---------------------------------------------------------------
+    static const uint32_t MIN_MATCH  = 4;      //!< shortest match encoded
+    static const uint32_t MAX_OFFSET = 0xFFFF; //!< furthest back a match can start
+    static const uint32_t HASH_BITS  = 16;     //!< bits of the match finder hash
+    // compression -------------------------------------------------------------
+    static void     compress( std::string_view input, std::string& output );
+    static bool     decompress( std::string_view input, std::string& output );
+    static uint64_t getOriginalSize( std::string_view input );
+
+  private:
+    // private functions -------------------------------------------------------
+    static void writeLength( std::string& output, uint64_t length );
+    static bool readLength( const uint8_t*& cursor, const uint8_t* end, uint64_t& length );
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: Compressor.h
+// ----------------------------------------------------------------------------
@@ -0,0 +1,100 @@
+/**----------------------------------------------------------------------------
+
+    @file       Crc.h
+    @defgroup   NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      CRC engine for the Nimble Library
+
+    @copyright  Neil Bereford 2023
+
+Notes:
+
+        please see Crc.cpp for full details.
+
+-----------------------------------------------------------------------------*/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Include files
+// ----------------------------------------------------------------------------
+
+#include <cinttypes>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "../ErrorHandling/Errors.h"
+
+//-----------------------------------------------------------------------------
+// Namespace
+// ----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      Streaming CRC calculation, data is passed to update() in as
+                many pieces as wanted and finalise() gives the CRC of it all.
+-----------------------------------------------------------------------------*/
+class Crc
+{
+  public:
+    /**------------------------------------------------------------------------
+        @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+        @brief      CRC calculated
+    -------------------------------------------------------------------------*/
+    enum class CrcType
+    {
+        Crc16,  //!< CRC-16/MODBUS, as Tools::crc16
+        Crc32,  //!< CRC-32, as zip and png
+        Crc32C  //!< CRC-32C (Castagnoli), as iSCSI and ext4
+    };
+
+    /**------------------------------------------------------------------------
+        @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+        @brief      How the CRC is calculated, every method gives the same CRC
+    -------------------------------------------------------------------------*/
+    enum class CrcMethod
+    {
+        Fastest,  //!< hardware when the CPU has it, otherwise slice by 8
+        Table,    //!< a table lookup a byte
+        Slice8,   //!< eight table lookups for eight bytes
+        Hardware  //!< SSE4.2 crc32 instruction, CRC-32C only, else slice by 8
+    };
+
+    // constants ---------------------------------------------------------------
+    static const uint32_t TABLE_SIZE  = 256; //!< entries in a lookup table
+    static const uint32_t SLICE_BYTES = 8;   //!< bytes taken in one step by slice by 8
+    // constructor -------------------------------------------------------------
+    explicit Crc( CrcType type = CrcType::Crc32, CrcMethod method = CrcMethod::Fastest );
+    // streaming ---------------------------------------------------------------
+    void         reset();
+    void         update( const void* data, size_t length );
+    LibraryError updateFile( const std::string& fileName );
+    uint32_t     finalise() const;
+    // one shot ----------------------------------------------------------------
+    static uint32_t calculate( CrcType type, const void* data, size_t length );
+    // getters -----------------------------------------------------------------
+    CrcType     getType() const;
+    CrcMethod   getMethod() const;
+    static bool hasHardwareCrc32C();
+
+  private:
+    // member variables --------------------------------------------------------
+    CrcType   crcType;   //!< CRC calculated
+    CrcMethod crcMethod; //!< method used, never Fastest
+    uint32_t  crcValue;  //!< running CRC, before the final xor
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: Crc.h
+// ----------------------------------------------------------------------------
@@ -0,0 +1,192 @@
+/**----------------------------------------------------------------------------
+
+    @file       Profiler.h
+    @defgroup   NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      Profiler class for the Nimble Library
+
+    @copyright  Neil Bereford 2023
+
+Notes:
+
+        please see Profiler.cpp for full details.
+
+-----------------------------------------------------------------------------*/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Include files
+// ----------------------------------------------------------------------------
+
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+// Defines
+// ----------------------------------------------------------------------------
+
+// times the rest of the enclosing scope, compiled out with NIMBLE_NO_PROFILER
+#define PROFILE_CONCAT_( a, b ) a##b
+#define PROFILE_CONCAT( a, b )  PROFILE_CONCAT_( a, b )
+#if defined( NIMBLE_NO_PROFILER )
+#define PROFILE_ZONE( name )
+#else
+#define PROFILE_ZONE( name ) ::Nimble::ProfileZone PROFILE_CONCAT( profileZone, __LINE__ )( name )
+#endif
+
+//-----------------------------------------------------------------------------
+// Namespace
+// ----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      Frame and zone timings for the Nimble Library
+                Zones are timed with ProfileZone into a ring per thread,
+                frames are timed by CursesWin::beginFrame() and endFrame().
+                Nothing is recorded until setEnabled( true ).
+-----------------------------------------------------------------------------*/
+class Profiler
+{
+  public:
+    // constants ---------------------------------------------------------------
+    static const uint32_t ZONE_HISTORY  = 8192; //!< zones kept per thread, a power of 2
+    static const uint32_t FRAME_HISTORY = 256;  //!< frames kept for the frame statistics
+    // singleton ---------------------------------------------------------------
+    static Profiler& getInstance();
+    // control -----------------------------------------------------------------
+    void setEnabled( bool enabled );
+    void clear();
+    /**------------------------------------------------------------------------
+        @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+        @brief      checks if zones and frames are being recorded
+        @return     bool    true if recording
+    -------------------------------------------------------------------------*/
+    static bool isEnabled()
+    {
+        return enabled.load( std::memory_order_relaxed );
+    }
+    /**------------------------------------------------------------------------
+        @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+        @brief      gets the time since the profiler was created
+        @return     uint64_t    nanoseconds
+    -------------------------------------------------------------------------*/
+    uint64_t now() const
+    {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - m_epoch ).count();
+    }
+    // recording ---------------------------------------------------------------
+    void recordZone( const char* name, uint64_t start, uint64_t end );
+    void beginFrame();
+    void endFrame();
+    // statistics --------------------------------------------------------------
+    bool                                          getFrameTimes( double& lastMs, double& averageMs, double& p99Ms ) const;
+    std::vector<std::pair<const char*, uint64_t>> getTopZones( uint32_t count ) const;
+    uint64_t                                      getFrameCount() const;
+    // export ------------------------------------------------------------------
+    bool exportChromeTrace( const std::string& fileName ) const;
+
+  private:
+    // typedefs ----------------------------------------------------------------
+    /**------------------------------------------------------------------------
+        @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+        @brief      One zone timed, the fields are atomic so the ring can be
+                    read while its thread writes it
+    -------------------------------------------------------------------------*/
+    struct ZoneRecord
+    {
+        std::atomic<const char*> name;  //!< zone name, a string literal
+        std::atomic<uint64_t>    start; //!< nanoseconds from the epoch
+        std::atomic<uint64_t>    end;   //!< nanoseconds from the epoch
+    };
+
+    /**------------------------------------------------------------------------
+        @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+        @brief      Zones timed by one thread, only that thread writes it
+    -------------------------------------------------------------------------*/
+    struct ZoneRing
+    {
+        std::unique_ptr<ZoneRecord[]> records;  //!< ZONE_HISTORY records
+        std::atomic<uint64_t>         written;  //!< records written, the next index is written % ZONE_HISTORY
+        uint32_t                      threadID; //!< thread number in the trace
+    };
+
+    // constructors ------------------------------------------------------------
+    Profiler();
+    // private variables -------------------------------------------------------
+    static std::atomic<bool>               enabled;        //!< recording zones and frames
+    std::chrono::steady_clock::time_point  m_epoch;        //!< time zero of the recorded times
+    mutable std::mutex                     m_ringsMutex;   //!< guards m_rings, taken once per thread
+    std::vector<std::unique_ptr<ZoneRing>> m_rings;        //!< ring of every thread that has timed a zone
+    std::vector<uint64_t>                  m_frameStarts;  //!< start of the last FRAME_HISTORY frames
+    std::vector<uint64_t>                  m_frameLengths; //!< length of the last FRAME_HISTORY frames
+    uint64_t                               m_frameCount;   //!< frames recorded
+    uint64_t                               m_frameStart;   //!< start of the frame in progress
+    // private functions -------------------------------------------------------
+    ZoneRing* getThreadRing();
+};
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      Times the scope it is declared in as a named zone, only a
+                flag is checked while the profiler is disabled
+-----------------------------------------------------------------------------*/
+class ProfileZone
+{
+  public:
+    /**------------------------------------------------------------------------
+        @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+        @brief      ProfileZone Constructor, starts the zone
+        @param      name    zone name, must be a string literal
+    -------------------------------------------------------------------------*/
+    explicit ProfileZone( const char* name ) : m_name( name ), m_start( 0 )
+    {
+        if ( Profiler::isEnabled() )
+        {
+            m_start = Profiler::getInstance().now();
+        }
+        else
+        {
+            m_name = nullptr;
+        }
+    }
+    /**------------------------------------------------------------------------
+        @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+        @brief      ProfileZone Destructor, records the zone
+    -------------------------------------------------------------------------*/
+    ~ProfileZone()
+    {
+        if ( m_name != nullptr )
+        {
+            Profiler& profiler = Profiler::getInstance();
+            profiler.recordZone( m_name, m_start, profiler.now() );
+        }
+    }
+    ProfileZone( const ProfileZone& )            = delete;
+    ProfileZone& operator=( const ProfileZone& ) = delete;
+
+  private:
+    const char* m_name;  //!< zone name, nullptr if not being recorded
+    uint64_t    m_start; //!< start of the zone
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: Profiler.h
+// ----------------------------------------------------------------------------
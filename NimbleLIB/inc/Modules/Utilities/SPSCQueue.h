@@ -0,0 +1,150 @@
+/**----------------------------------------------------------------------------
+
+    @file       SPSCQueue.h
+    @defgroup   NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      SPSCQueue class for the Nimble Library
+
+    @copyright  Neil Bereford 2023
+
+Notes:
+
+    Single producer, single consumer ring buffer. The producer only writes
+    m_tail and the consumer only writes m_head, so neither needs a lock. The
+    release store of one side pairs with the acquire load of the other, an
+    item is fully written before the consumer can see it and fully read
+    before the producer can reuse its slot. The two indices are kept on
+    separate cache lines so the threads do not share one.
+
+-----------------------------------------------------------------------------*/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Include files
+// ----------------------------------------------------------------------------
+
+#include <atomic>
+#include <cinttypes>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+// Namespace
+// ----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      Lock free single producer, single consumer queue
+                push() may only be called from one thread and pop() from one
+                other thread.
+-----------------------------------------------------------------------------*/
+template <typename T>
+class SPSCQueue
+{
+  public:
+    // constants ---------------------------------------------------------------
+    static const uint32_t CACHE_LINE_SIZE = 64; //!< keeps the indices apart
+
+    // constructors & destructors ----------------------------------------------
+    /**------------------------------------------------------------------------
+        @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+        @brief      SPSCQueue Constructor
+        @param      capacity    items the queue holds, rounded up to a power of 2
+    -------------------------------------------------------------------------*/
+    explicit SPSCQueue( uint32_t capacity )
+    {
+        uint32_t size = 1;
+        while ( size < capacity )
+        {
+            size <<= 1;
+        }
+        m_slots.resize( size );
+        m_mask = size - 1;
+        m_head.store( 0, std::memory_order_relaxed );
+        m_tail.store( 0, std::memory_order_relaxed );
+    }
+    SPSCQueue( const SPSCQueue& )            = delete;
+    SPSCQueue& operator=( const SPSCQueue& ) = delete;
+
+    // producer ----------------------------------------------------------------
+    /**------------------------------------------------------------------------
+        @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+        @brief      adds an item, producer thread only
+        @param      item    item to move into the queue
+        @return     bool    false if the queue is full, the item is not moved
+    -------------------------------------------------------------------------*/
+    bool push( T&& item )
+    {
+        uint32_t tail = m_tail.load( std::memory_order_relaxed );
+        if ( tail - m_head.load( std::memory_order_acquire ) > m_mask )
+        {
+            return false;
+        }
+        m_slots[tail & m_mask] = std::move( item );
+        m_tail.store( tail + 1, std::memory_order_release );
+        return true;
+    }
+
+    // consumer ----------------------------------------------------------------
+    /**------------------------------------------------------------------------
+        @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+        @brief      removes the oldest item, consumer thread only
+        @param      item    set to the item removed
+        @return     bool    false if the queue is empty
+    -------------------------------------------------------------------------*/
+    bool pop( T& item )
+    {
+        uint32_t head = m_head.load( std::memory_order_relaxed );
+        if ( head == m_tail.load( std::memory_order_acquire ) )
+        {
+            return false;
+        }
+        item = std::move( m_slots[head & m_mask] );
+        m_head.store( head + 1, std::memory_order_release );
+        return true;
+    }
+
+    // getters -----------------------------------------------------------------
+    /**------------------------------------------------------------------------
+        @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+        @brief      checks if the queue is empty, exact only on the consumer
+        @return     bool    true if there is nothing to pop
+    -------------------------------------------------------------------------*/
+    bool isEmpty() const
+    {
+        return m_head.load( std::memory_order_acquire ) == m_tail.load( std::memory_order_acquire );
+    }
+
+    /**------------------------------------------------------------------------
+        @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+        @brief      returns the number of items the queue holds
+        @return     uint32_t    capacity
+    -------------------------------------------------------------------------*/
+    uint32_t getCapacity() const
+    {
+        return m_mask + 1;
+    }
+
+  private:
+    // private variables -------------------------------------------------------
+    std::vector<T>                                   m_slots; //!< ring of items
+    uint32_t                                         m_mask;  //!< capacity - 1
+    alignas( CACHE_LINE_SIZE ) std::atomic<uint32_t> m_head;  //!< next item to pop, written by the consumer
+    alignas( CACHE_LINE_SIZE ) std::atomic<uint32_t> m_tail;  //!< next slot to push, written by the producer
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: SPSCQueue.h
+// ----------------------------------------------------------------------------
@@ -0,0 +1,104 @@
+/**----------------------------------------------------------------------------
+
+    @file       ThreadPool.h
+    @defgroup   NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      Work stealing thread pool for the Nimble Library
+
+    @copyright  Neil Bereford 2023
+
+Notes:
+
+        please see ThreadPool.cpp for full details.
+
+-----------------------------------------------------------------------------*/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Include files
+// ----------------------------------------------------------------------------
+
+#include <atomic>
+#include <cinttypes>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+// Namespace
+// ----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      Work stealing thread pool for the Nimble Library
+                Each worker has a queue of its own, tasks a worker submits go
+                on its own queue, and a worker with nothing to do takes the
+                oldest task from another worker's queue.
+-----------------------------------------------------------------------------*/
+class ThreadPool
+{
+  public:
+    // types -------------------------------------------------------------------
+    using Task = std::function<void()>;
+
+    // constructors & destructors ----------------------------------------------
+    explicit ThreadPool( uint32_t threads = 0 );
+    ~ThreadPool();
+    ThreadPool( const ThreadPool& )            = delete;
+    ThreadPool& operator=( const ThreadPool& ) = delete;
+    // tasks -------------------------------------------------------------------
+    void submit( Task task );
+    void wait();
+    // getters -----------------------------------------------------------------
+    bool     isIdle() const;
+    uint32_t getThreadCount() const;
+    uint64_t getStolenCount() const;
+
+  private:
+    /**------------------------------------------------------------------------
+        @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+        @brief      Tasks waiting for a worker, its owner takes the newest,
+                    other workers steal the oldest
+    -------------------------------------------------------------------------*/
+    struct WorkQueue
+    {
+        std::mutex       lock;  //!< guards tasks
+        std::deque<Task> tasks; //!< tasks waiting
+    };
+
+    // private variables -------------------------------------------------------
+    std::vector<std::unique_ptr<WorkQueue>> m_queues;      //!< a queue for each worker
+    std::vector<std::thread>                m_workers;     //!< worker threads
+    std::mutex                              m_sleepLock;   //!< guards sleeping and waking
+    std::condition_variable                 m_wakeUp;      //!< signalled when tasks are submitted
+    std::condition_variable                 m_finished;    //!< signalled when the last task finishes
+    std::atomic<uint32_t>                   m_queued;      //!< tasks waiting in the queues
+    std::atomic<uint32_t>                   m_unfinished;  //!< tasks submitted and not yet finished
+    std::atomic<uint32_t>                   m_nextQueue;   //!< queue for the next task submitted from outside
+    std::atomic<uint64_t>                   m_stolen;      //!< tasks taken from another worker's queue
+    bool                                    m_stopping;    //!< workers are to exit, guarded by m_sleepLock
+
+    // private functions -------------------------------------------------------
+    void workerLoop( uint32_t index );
+    bool takeTask( uint32_t index, Task& task );
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: ThreadPool.h
+// ----------------------------------------------------------------------------
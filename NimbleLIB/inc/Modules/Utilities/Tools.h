@@ -57,14 +57,6 @@ class Tools
     Tools( const Tools& )            = delete;
     Tools& operator=( const Tools& ) = delete;
 
-    // Constants ---------------------------------------------------------------
-    // crc16 constants ----------------------------------------------------------
-    const uint16_t CRC_START = 0xFFFF; //<! Const values for the crc16 - CRC start value
-    const uint16_t CRC_POLY  = 0xA001; //<! Const values for the crc16 - CRC polynomial
-    const uint16_t CRC_MASK  = 0x0001; //<! Const values for the crc16 - CRC mask
-    const uint16_t CRC_SHIFT = 1;      //<! Const values for the crc16 - CRC shift
-    const uint16_t CRC_BITS  = 8;      //<! Const values for the crc16 - CRC bits
-
 }; // end class Singleton Tools
 
 //-----------------------------------------------------------------------------
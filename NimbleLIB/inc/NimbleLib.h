@@ -14,27 +14,51 @@
 // Includes
 //-----------------------------------------------------------------------------
 
-#include "Modules/Screen/ScreenInfo.h"            // ScreenInfo class
-#include "Modules/Screen/ScreenWord.h"            // ScreenWord class
-#include "Modules/Screen/ScreenPrint.h"           // ScreenPrint class
-#include "Modules/Screen/ScreenBox.h"             // ScreenBox class
-#include "Modules/Screen/ScreenControl.h"         // ScreenControl class
-#include "Modules/Framework/CFrameworkObject.hpp" // Hardware FrameworkObject class
-#include "Modules/Curses/CursesColour.h"          // CursesColour class
-#include "Modules/Curses/CursesWin.h"             // CursesWin class
-#include "Modules/Curses/CursesMenu.h"            // CursesMenu class
-#include "Modules/IDE/IDEEditline.h"              // IDEEditline class
-#include "Modules/IDE/IDEEditBox.h"               // IDEEditBox class
-#include "Modules/IDE/IDEEditor.h"                // IDEEditor class
-#include "Modules/IDE/IDEDialog.h"                // IDEDialog class
-#include "Modules/IDE/IDEFileDialog.h"            // IDEFileDialog class
-#include "Modules/IDE/IDEWindow.h"                // IDEWindow class
-#include "Modules/IDE/IDEManager.h"               // IDEManager class
-#include "Modules/Editor/EditorHexWin.h"          // EditorHexWin class
-#include "Modules/Editor/EditorStatusWin.h"       // EditorStatusWin class
-#include "Modules/Editor/EditorTitleWin.h"        // EditorTitleWin class
-#include "Modules/Editor/EditorProjectWin.h"      // EditorProjectWin class
-#include "Modules/Editor/EditorLineNumbersWin.h"  // EditorProjectWin class
+#include "Modules/Screen/ScreenInfo.h"             // ScreenInfo class
+#include "Modules/Screen/ScreenWord.h"             // ScreenWord class
+#include "Modules/Screen/ScreenPrint.h"            // ScreenPrint class
+#include "Modules/Screen/ScreenBox.h"              // ScreenBox class
+#include "Modules/Screen/ScreenControl.h"          // ScreenControl class
+#include "Modules/Framework/CFrameworkObject.hpp"  // Hardware FrameworkObject class
+#include "Modules/Curses/CursesColour.h"           // CursesColour class
+#include "Modules/Curses/CursesWin.h"              // CursesWin class
+#include "Modules/Curses/CursesMenu.h"             // CursesMenu class
+#include "Modules/Curses/CursesEventLoop.h"        // CursesEventLoop class
+#include "Modules/Curses/CursesInput.h"            // CursesInput class
+#include "Modules/Utilities/Profiler.h"            // Profiler class
+#include "Modules/Utilities/ThreadPool.h"          // ThreadPool class
+#include "Modules/Utilities/Crc.h"                 // Crc class
+#include "Modules/Utilities/Compressor.h"          // Compressor class
+#include "Modules/Utilities/Tools.h"               // Tools class
+#include "Modules/FileHandling/MappedFile.h"       // MappedFile class
+#include "Modules/FileHandling/PatchedFile.h"      // PatchedFile class
+#include "Modules/FileHandling/AtomicFileWriter.h" // AtomicFileWriter class
+#include "Modules/FileHandling/FileManager.h"      // FileManager class
+#include "Modules/FileHandling/DirectoryScanner.h" // DirectoryScanner class
+#include "Modules/IDE/IDEEditline.h"               // IDEEditline class
+#include "Modules/IDE/IDEPieceTable.h"             // IDEPieceTable class
+#include "Modules/IDE/IDEUndoJournal.h"            // IDEUndoJournal class
+#include "Modules/IDE/IDESearch.h"                 // IDESearch class
+#include "Modules/IDE/IDESyntax.h"                 // IDESyntax class
+#include "Modules/IDE/IDELargeFile.h"              // IDELargeFile class
+#include "Modules/IDE/IDEFileLoader.h"             // IDEFileLoader class
+#include "Modules/IDE/IDEFuzzyFilter.h"            // IDEFuzzyFilter class
+#include "Modules/IDE/IDEListView.h"               // IDEListView class
+#include "Modules/IDE/IDETrigramIndex.h"           // IDETrigramIndex class
+#include "Modules/IDE/IDEProjectSearch.h"          // IDEProjectSearch class
+#include "Modules/IDE/IDEProjectFiles.h"           // IDEProjectFiles class
+#include "Modules/IDE/IDEEditBox.h"                // IDEEditBox class
+#include "Modules/IDE/IDEEditor.h"                 // IDEEditor class
+#include "Modules/IDE/IDEDialog.h"                 // IDEDialog class
+#include "Modules/IDE/IDEFileDialog.h"             // IDEFileDialog class
+#include "Modules/IDE/IDEQuickOpen.h"              // IDEQuickOpen class
+#include "Modules/IDE/IDEWindow.h"                 // IDEWindow class
+#include "Modules/IDE/IDEManager.h"                // IDEManager class
+#include "Modules/Editor/EditorHexWin.h"           // EditorHexWin class
+#include "Modules/Editor/EditorStatusWin.h"        // EditorStatusWin class
+#include "Modules/Editor/EditorTitleWin.h"         // EditorTitleWin class
+#include "Modules/Editor/EditorProjectWin.h"       // EditorProjectWin class
+#include "Modules/Editor/EditorLineNumbersWin.h"   // EditorProjectWin class
 
 //-----------------------------------------------------------------------------
 // End of file: NimbleLib.h
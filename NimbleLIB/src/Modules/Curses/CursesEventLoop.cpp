@@ -0,0 +1,201 @@
+/**----------------------------------------------------------------------------
+
+    @file       CursesEventLoop.cpp
+    @defgroup   NimbleLIBCurses Nimble Library Curses Module
+    @brief      Curses Event Loop class for the Nimble Library
+
+    @copyright  Neil Bereford 2023
+
+Notes:
+
+    waitForInput() blocks until a key is waiting or until the next active
+    timer is due, whichever is first. With no active timers it blocks until
+    a key arrives, so an idle IDE does not wake up at all.
+
+    On Linux stdin is poll()ed. Curses can hold keys it has already read
+    from stdin, so after a wake up the caller should read every waiting key
+    with getch() until ERR. Elsewhere curses' own timeout() is used for the
+    wait and the key read is pushed back with ungetch().
+
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// Include files
+// ----------------------------------------------------------------------------
+
+#include "../../../inc/Modules/Curses/CursesEventLoop.h"
+
+extern "C"
+{
+#include "../../../../ExternalLibraries/PDCurses/curses.h"
+}
+
+#if ( __linux__ )
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+//-----------------------------------------------------------------------------
+// Namespace
+// ----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Class functions
+// ----------------------------------------------------------------------------
+
+// constructors & destructors -------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBCurses Nimble Library Curses Module
+    @brief      Constructor for CursesEventLoop class
+
+-----------------------------------------------------------------------------*/
+CursesEventLoop::CursesEventLoop()
+{
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBCurses Nimble Library Curses Module
+    @brief      Destructor for CursesEventLoop class
+
+-----------------------------------------------------------------------------*/
+CursesEventLoop::~CursesEventLoop()
+{
+}
+
+// Timers ---------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBCurses Nimble Library Curses Module
+    @brief      Adds a repeating timer
+    @param      intervalMs  time between calls in milliseconds
+    @param      callback    function called when the timer is due
+    @param      active      true to start the timer straight away
+    @return     uint32_t    timer ID
+-----------------------------------------------------------------------------*/
+uint32_t CursesEventLoop::addTimer( uint32_t intervalMs, TimerCallback callback, bool active /*= true*/ )
+{
+    Timer timer;
+    timer.interval = std::chrono::milliseconds( intervalMs );
+    timer.due      = Clock::now() + timer.interval;
+    timer.callback = callback;
+    timer.active   = active;
+
+    m_timers.push_back( timer );
+    return (uint32_t)m_timers.size() - 1;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBCurses Nimble Library Curses Module
+    @brief      Starts or stops a timer, a started timer is next due one
+                interval from now
+    @param      timerID     timer ID returned by addTimer()
+    @param      active      true to start, false to stop
+    @return     void
+-----------------------------------------------------------------------------*/
+void CursesEventLoop::setTimerActive( uint32_t timerID, bool active )
+{
+    if ( timerID < m_timers.size() && m_timers[timerID].active != active )
+    {
+        m_timers[timerID].active = active;
+        m_timers[timerID].due    = Clock::now() + m_timers[timerID].interval;
+    }
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBCurses Nimble Library Curses Module
+    @brief      Calls every timer that is due. A timer that has fallen more
+                than an interval behind is not called again to catch up.
+    @return     uint32_t    number of timers called
+-----------------------------------------------------------------------------*/
+uint32_t CursesEventLoop::processTimers()
+{
+    uint32_t          called = 0;
+    Clock::time_point now    = Clock::now();
+
+    for ( uint32_t index = 0; index < m_timers.size(); index++ )
+    {
+        if ( m_timers[index].active && m_timers[index].due <= now )
+        {
+            m_timers[index].due += m_timers[index].interval;
+            if ( m_timers[index].due <= now )
+            {
+                m_timers[index].due = now + m_timers[index].interval;
+            }
+            // the callback may add timers, so do not hold a reference
+            TimerCallback callback = m_timers[index].callback;
+            callback();
+            called++;
+        }
+    }
+    return called;
+}
+
+// Input ----------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBCurses Nimble Library Curses Module
+    @brief      Returns the time until the next active timer is due
+    @return     int32_t     milliseconds, 0 if one is due, -1 if no timers
+-----------------------------------------------------------------------------*/
+int32_t CursesEventLoop::getTimeout() const
+{
+    int32_t           timeout = -1;
+    Clock::time_point now     = Clock::now();
+
+    for ( const Timer& timer : m_timers )
+    {
+        if ( timer.active )
+        {
+            auto    wait     = std::chrono::ceil<std::chrono::milliseconds>( timer.due - now ).count();
+            int32_t waitTime = ( wait < 0 ) ? 0 : (int32_t)wait;
+            if ( timeout < 0 || waitTime < timeout )
+            {
+                timeout = waitTime;
+            }
+        }
+    }
+    return timeout;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBCurses Nimble Library Curses Module
+    @brief      Sleeps until there is keyboard input or a timer is due
+    @return     bool    true if input is waiting to be read with getch()
+-----------------------------------------------------------------------------*/
+bool CursesEventLoop::waitForInput()
+{
+    bool    inputReady = false;
+    int32_t timeout    = getTimeout();
+
+#if ( __linux__ )
+    struct pollfd input;
+    input.fd      = STDIN_FILENO;
+    input.events  = POLLIN;
+    input.revents = 0;
+
+    // an interrupted wait (EINTR, e.g. a resize) is treated as a wake up
+    inputReady = ( poll( &input, 1, timeout ) > 0 );
+#else
+    wtimeout( stdscr, timeout );
+    int key = wgetch( stdscr );
+    nodelay( stdscr, TRUE );
+    if ( key != ERR )
+    {
+        ungetch( key );
+        inputReady = true;
+    }
+#endif
+    return inputReady;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: CursesEventLoop.cpp
+// ----------------------------------------------------------------------------
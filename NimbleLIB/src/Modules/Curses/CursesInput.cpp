@@ -0,0 +1,322 @@
+/**----------------------------------------------------------------------------
+
+    @file       CursesInput.cpp
+    @defgroup   NimbleLIBCurses Nimble Library Curses Module
+    @brief      Curses Input pump class for the Nimble Library
+
+    @copyright  Neil Bereford 2023
+
+Notes:
+
+    pump() reads every key curses holds with getch(), until ERR, and turns
+    them into a batch of events. Consecutive printable keys (32 to 126) are
+    joined into one Text event, so typing ahead or an unbracketed paste is
+    inserted with one edit and drawn once rather than once a key. Any other
+    key is a Key event of its own, in order.
+
+    setBracketedPaste( true ) asks the terminal to wrap pastes in
+    ESC [ 2 0 0 ~ and ESC [ 2 0 1 ~. Everything between the two is one
+    Paste event, line feeds and all, so a paste is a single edit and a
+    single undo step. A paste can span batches, the event is made once the
+    end arrives. An escape sequence that is not the start of a paste is
+    passed on as the keys it was made of.
+
+    The bytes of a bracket can be split over two batches, so an escape
+    sequence cut off by the end of a batch is held for the next, until
+    ESCAPE_TIMEOUT_MS after it started. The escape key on its own is such
+    a sequence, it is passed on once the wait is over, hasPendingEscape()
+    tells the caller to pump again then.
+
+    processKeys() does the same for keys already read, it is used by the
+    benchmark and the unit tests.
+
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// Include files
+// ----------------------------------------------------------------------------
+
+#include "../../../inc/Modules/Curses/CursesInput.h"
+#include <chrono>
+#include <cstdio>
+
+extern "C"
+{
+#include "../../../../ExternalLibraries/PDCurses/curses.h"
+}
+
+//-----------------------------------------------------------------------------
+// Namespace
+// ----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Local data
+// ----------------------------------------------------------------------------
+
+static const std::vector<uint32_t> PASTE_START = { 27, '[', '2', '0', '0', '~' }; //!< bracketed paste start
+static const std::vector<uint32_t> PASTE_END   = { 27, '[', '2', '0', '1', '~' }; //!< bracketed paste end
+
+//-----------------------------------------------------------------------------
+// Local functions
+// ----------------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBCurses Nimble Library Curses Module
+    @brief      Gets the clock used to time escape sequences
+    @return     uint64_t    milliseconds
+-----------------------------------------------------------------------------*/
+static uint64_t getTimeMs()
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+//-----------------------------------------------------------------------------
+// Class functions
+// ----------------------------------------------------------------------------
+
+// constructors & destructors -------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBCurses Nimble Library Curses Module
+    @brief      Constructor for CursesInput class
+
+-----------------------------------------------------------------------------*/
+CursesInput::CursesInput()
+{
+    m_escapeStart   = 0;
+    m_escapeTimeout = ESCAPE_TIMEOUT_MS;
+    m_pasting       = false;
+    m_bracketed     = false;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBCurses Nimble Library Curses Module
+    @brief      Destructor for CursesInput class, the terminal stops
+                bracketing pastes
+
+-----------------------------------------------------------------------------*/
+CursesInput::~CursesInput()
+{
+    setBracketedPaste( false );
+}
+
+// input ----------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBCurses Nimble Library Curses Module
+    @brief      Asks the terminal to bracket pastes, or to stop
+    @param      enabled     true to bracket pastes
+    @return     void
+-----------------------------------------------------------------------------*/
+void CursesInput::setBracketedPaste( bool enabled )
+{
+#if ( __linux__ )
+    if ( enabled != m_bracketed )
+    {
+        fputs( enabled ? "\033[?2004h" : "\033[?2004l", stdout );
+        fflush( stdout );
+    }
+#endif
+    m_bracketed = enabled;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBCurses Nimble Library Curses Module
+    @brief      Sets how long an escape sequence cut off by the end of a
+                batch waits for the rest, 0 passes it on straight away
+    @param      timeoutMs   milliseconds
+    @return     void
+-----------------------------------------------------------------------------*/
+void CursesInput::setEscapeTimeout( uint32_t timeoutMs )
+{
+    m_escapeTimeout = timeoutMs;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBCurses Nimble Library Curses Module
+    @brief      Reads every key waiting into a batch of events
+    @return     const std::vector<InputEvent>&  events, empty if no key was
+                                                waiting
+-----------------------------------------------------------------------------*/
+const std::vector<CursesInput::InputEvent>& CursesInput::pump()
+{
+    std::vector<uint32_t> keys;
+    int                   input = ERR;
+
+    while ( keys.size() < MAX_BATCH_KEYS && ( input = getch() ) != ERR )
+    {
+        keys.push_back( (uint32_t)input );
+    }
+    return processKeys( keys );
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBCurses Nimble Library Curses Module
+    @brief      Turns keys already read into a batch of events
+    @param      keys    keys, in the order they were pressed
+    @return     const std::vector<InputEvent>&  events
+-----------------------------------------------------------------------------*/
+const std::vector<CursesInput::InputEvent>& CursesInput::processKeys( const std::vector<uint32_t>& keys )
+{
+    m_events.clear();
+    m_keys = keys;
+
+    for ( uint32_t key : keys )
+    {
+        if ( key == 27 && m_escape.empty() == false )
+        {
+            // an escape sequence broken by another escape
+            flushEscape();
+        }
+        if ( key != 27 && m_escape.empty() )
+        {
+            addKey( key );
+            continue;
+        }
+
+        // match the escape sequence against the paste bracket expected
+        const std::vector<uint32_t>& bracket = m_pasting ? PASTE_END : PASTE_START;
+        if ( m_escape.empty() )
+        {
+            m_escapeStart = getTimeMs();
+        }
+        m_escape.push_back( key );
+        if ( bracket[m_escape.size() - 1] != key )
+        {
+            flushEscape();
+        }
+        else if ( m_escape.size() == bracket.size() )
+        {
+            m_escape.clear();
+            if ( m_pasting )
+            {
+                m_events.push_back( { EventType::Paste, 0, std::move( m_paste ) } );
+                m_paste.clear();
+            }
+            m_pasting = !m_pasting;
+        }
+    }
+
+    // the rest of the sequence may be in the next batch, inside a paste it
+    // is held until the end arrives
+    if ( m_pasting == false && m_escape.empty() == false && getTimeMs() - m_escapeStart >= m_escapeTimeout )
+    {
+        flushEscape();
+    }
+    return m_events;
+}
+
+// getters --------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBCurses Nimble Library Curses Module
+    @brief      Gets the events of the last batch
+    @return     const std::vector<InputEvent>&  events
+-----------------------------------------------------------------------------*/
+const std::vector<CursesInput::InputEvent>& CursesInput::getEvents() const
+{
+    return m_events;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBCurses Nimble Library Curses Module
+    @brief      Gets the keys read for the last batch, as they were read
+    @return     const std::vector<uint32_t>&    keys
+-----------------------------------------------------------------------------*/
+const std::vector<uint32_t>& CursesInput::getKeys() const
+{
+    return m_keys;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBCurses Nimble Library Curses Module
+    @brief      Checks if a bracketed paste is still being read
+    @return     bool    true if the end of a paste has not arrived
+-----------------------------------------------------------------------------*/
+bool CursesInput::isPasting() const
+{
+    return m_pasting;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBCurses Nimble Library Curses Module
+    @brief      Checks if the keys of an escape sequence are held waiting for
+                the rest, the next pump() passes them on once the escape
+                timeout is over
+    @return     bool    true if keys are held
+-----------------------------------------------------------------------------*/
+bool CursesInput::hasPendingEscape() const
+{
+    return m_pasting == false && m_escape.empty() == false;
+}
+
+// private functions ----------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBCurses Nimble Library Curses Module
+    @brief      Adds a key to the batch, to the paste if one is being read
+    @param      key     key
+    @return     void
+-----------------------------------------------------------------------------*/
+void CursesInput::addKey( uint32_t key )
+{
+    if ( m_pasting )
+    {
+        // keys curses decoded from the pasted bytes are not text
+        if ( key < 256 )
+        {
+            m_paste += (char)key;
+        }
+    }
+    else if ( key >= 32 && key <= 126 )
+    {
+        addText( (char)key );
+    }
+    else
+    {
+        m_events.push_back( { EventType::Key, key, std::string() } );
+    }
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBCurses Nimble Library Curses Module
+    @brief      Adds a printable key to the batch, joining the text before it
+    @param      ch      character
+    @return     void
+-----------------------------------------------------------------------------*/
+void CursesInput::addText( char ch )
+{
+    if ( m_events.empty() || m_events.back().type != EventType::Text )
+    {
+        m_events.push_back( { EventType::Text, 0, std::string() } );
+    }
+    m_events.back().text += ch;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBCurses Nimble Library Curses Module
+    @brief      Passes on the keys of an escape sequence that was not a
+                paste bracket
+    @return     void
+-----------------------------------------------------------------------------*/
+void CursesInput::flushEscape()
+{
+    std::vector<uint32_t> escape;
+
+    escape.swap( m_escape );
+    for ( uint32_t key : escape )
+    {
+        addKey( key );
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: CursesInput.cpp
+// ----------------------------------------------------------------------------
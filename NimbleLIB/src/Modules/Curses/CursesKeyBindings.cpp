@@ -0,0 +1,354 @@
+/**----------------------------------------------------------------------------
+
+    @file       CursesKeyBindings.cpp
+    @defgroup   NimbleLIBCurses Nimble Library Curses Module
+    @brief      Compiled key binding table for the Nimble Library
+
+    @copyright  Neil Bereford 2023
+
+Notes:
+
+    The bindings form a trie, a binding of one key is an edge from the root
+    and a chord such as Ctrl+K Ctrl+C is a path of edges. Every edge is
+    held in one open addressed hash table keyed on the node and the key,
+    so finding what a key does is a single probe sequence however many
+    bindings there are.
+
+    A key that starts or continues a chord is held as pending. The chord
+    completes with its last key, a key that does not continue it ends the
+    chord and is then looked up from the root. A chord not continued within
+    the chord timeout is abandoned, processTimeout() does this and
+    dispatch() does it first. Where the keys so far are a binding of their
+    own as well as the start of a longer chord, that binding is called when
+    the chord is abandoned.
+
+    The first binding added for a sequence is kept, later ones for the
+    same sequence are refused. Bindings must not be added or cleared from
+    inside a binding.
+
+-----------------------------------------------------------------------------*/
+//-----------------------------------------------------------------------------
+// Include files
+// ----------------------------------------------------------------------------
+
+#include "../../../inc/Modules/Curses/CursesKeyBindings.h"
+#include <chrono>
+
+//-----------------------------------------------------------------------------
+// Namespace
+// ----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Local functions
+// ----------------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBCurses Nimble Library Curses Module
+    @brief      Gets the clock used to time chords
+    @return     uint64_t    milliseconds
+--------------------------------------------------------------------------*/
+static uint64_t getTimeMs()
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+//-----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+// Constructors and destructors ---------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBCurses Nimble Library Curses Module
+    @brief      Key bindings constructor
+
+--------------------------------------------------------------------------*/
+CursesKeyBindings::CursesKeyBindings()
+{
+    chordTimeoutMs = CHORD_TIMEOUT_MS;
+    clear();
+}
+
+// Bindings -----------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBCurses Nimble Library Curses Module
+    @brief      Removes every binding and any chord in progress
+    @return     void
+--------------------------------------------------------------------------*/
+void CursesKeyBindings::clear()
+{
+    slots.assign( MIN_SLOTS, { EMPTY_EDGE, NO_NODE, NO_HANDLER } );
+    handlers.clear();
+    usedSlots = 0;
+    nodeCount = 1;
+    resetChord();
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBCurses Nimble Library Curses Module
+    @brief      Adds a binding
+    @param      sequence    key, or keys of a chord in order
+    @param      function    called with the last key when the sequence is
+                            pressed
+    @return     bool        false if the sequence is empty or already bound
+--------------------------------------------------------------------------*/
+bool CursesKeyBindings::addBinding( const std::vector<uint32_t>& sequence, pKeyFunction function )
+{
+    uint32_t node = NO_NODE;
+
+    for ( size_t index = 0; index < sequence.size(); index++ )
+    {
+        KeySlot* slot = findSlot( node, sequence[index] );
+        if ( slot == nullptr )
+        {
+            slot = &insertSlot( node, sequence[index] );
+        }
+        if ( index + 1 == sequence.size() )
+        {
+            if ( slot->handler != NO_HANDLER )
+            {
+                return false;
+            }
+            slot->handler = (int32_t)handlers.size();
+            handlers.push_back( function );
+            return true;
+        }
+        if ( slot->child == NO_NODE )
+        {
+            slot->child = nodeCount++;
+        }
+        node = slot->child;
+    }
+    return false;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBCurses Nimble Library Curses Module
+    @brief      Gets the number of bindings
+    @return     uint32_t    bindings
+--------------------------------------------------------------------------*/
+uint32_t CursesKeyBindings::getBindingCount() const noexcept
+{
+    return (uint32_t)handlers.size();
+}
+
+// Dispatch -----------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBCurses Nimble Library Curses Module
+    @brief      Calls the binding of a key, timing chords by the clock
+    @param      key         key pressed
+    @return     KeyResult   what the key did
+--------------------------------------------------------------------------*/
+CursesKeyBindings::KeyResult CursesKeyBindings::dispatch( uint32_t key )
+{
+    return dispatch( key, getTimeMs() );
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBCurses Nimble Library Curses Module
+    @brief      Calls the binding of a key
+    @param      key         key pressed
+    @param      timeMs      time of the key, in milliseconds
+    @return     KeyResult   what the key did
+--------------------------------------------------------------------------*/
+CursesKeyBindings::KeyResult CursesKeyBindings::dispatch( uint32_t key, uint64_t timeMs )
+{
+    processTimeout( timeMs );
+
+    KeySlot* slot = findSlot( pendingNode, key );
+    if ( slot == nullptr && pendingNode != NO_NODE )
+    {
+        // the chord is broken, the key is looked up on its own
+        abandonChord();
+        slot = findSlot( NO_NODE, key );
+    }
+    if ( slot == nullptr )
+    {
+        return KeyResult::Unbound;
+    }
+    if ( slot->child != NO_NODE )
+    {
+        pendingNode    = slot->child;
+        pendingHandler = slot->handler;
+        pendingKey     = key;
+        pendingTimeMs  = timeMs;
+        return KeyResult::Pending;
+    }
+
+    resetChord();
+    if ( handlers[slot->handler] != nullptr )
+    {
+        handlers[slot->handler]( key );
+    }
+    return KeyResult::Handled;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBCurses Nimble Library Curses Module
+    @brief      Abandons a chord not continued in time, by the clock
+    @return     bool        true if a binding was called
+--------------------------------------------------------------------------*/
+bool CursesKeyBindings::processTimeout()
+{
+    return processTimeout( getTimeMs() );
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBCurses Nimble Library Curses Module
+    @brief      Abandons a chord not continued in time, calling the binding
+                of the keys so far if they have one
+    @param      timeMs      time now, in milliseconds
+    @return     bool        true if a binding was called
+--------------------------------------------------------------------------*/
+bool CursesKeyBindings::processTimeout( uint64_t timeMs )
+{
+    if ( pendingNode == NO_NODE || timeMs - pendingTimeMs < chordTimeoutMs )
+    {
+        return false;
+    }
+    return abandonChord();
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBCurses Nimble Library Curses Module
+    @brief      Ends the chord in progress, calling the binding of the keys
+                so far if they have one
+    @return     bool        true if a binding was called
+--------------------------------------------------------------------------*/
+bool CursesKeyBindings::abandonChord()
+{
+    int32_t  handler = pendingHandler;
+    uint32_t key     = pendingKey;
+    resetChord();
+    if ( handler != NO_HANDLER && handlers[handler] != nullptr )
+    {
+        handlers[handler]( key );
+        return true;
+    }
+    return false;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBCurses Nimble Library Curses Module
+    @brief      Checks if a chord is in progress
+    @return     bool        true if keys of a chord are held
+--------------------------------------------------------------------------*/
+bool CursesKeyBindings::isPending() const noexcept
+{
+    return pendingNode != NO_NODE;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBCurses Nimble Library Curses Module
+    @brief      Sets the time allowed between the keys of a chord
+    @param      timeoutMs   milliseconds
+    @return     void
+--------------------------------------------------------------------------*/
+void CursesKeyBindings::setChordTimeout( uint32_t timeoutMs ) noexcept
+{
+    chordTimeoutMs = timeoutMs;
+}
+
+// Private functions --------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBCurses Nimble Library Curses Module
+    @brief      Finds the edge of a key from a node
+    @param      node        trie node
+    @param      key         key
+    @return     KeySlot*    the edge, nullptr if the key is not bound there
+--------------------------------------------------------------------------*/
+CursesKeyBindings::KeySlot* CursesKeyBindings::findSlot( uint32_t node, uint32_t key )
+{
+    uint64_t edge  = ( (uint64_t)node << 32 ) | key;
+    uint32_t mask  = (uint32_t)slots.size() - 1;
+    uint32_t index = (uint32_t)( ( edge * 0x9E3779B97F4A7C15ULL ) >> 32 ) & mask;
+
+    while ( slots[index].edge != EMPTY_EDGE )
+    {
+        if ( slots[index].edge == edge )
+        {
+            return &slots[index];
+        }
+        index = ( index + 1 ) & mask;
+    }
+    return nullptr;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBCurses Nimble Library Curses Module
+    @brief      Adds an edge for a key from a node, the table is kept at
+                most half full
+    @param      node        trie node
+    @param      key         key, not already bound from the node
+    @return     KeySlot&    the new edge
+--------------------------------------------------------------------------*/
+CursesKeyBindings::KeySlot& CursesKeyBindings::insertSlot( uint32_t node, uint32_t key )
+{
+    if ( ( usedSlots + 1 ) * 2 > slots.size() )
+    {
+        growTable();
+    }
+
+    uint64_t edge  = ( (uint64_t)node << 32 ) | key;
+    uint32_t mask  = (uint32_t)slots.size() - 1;
+    uint32_t index = (uint32_t)( ( edge * 0x9E3779B97F4A7C15ULL ) >> 32 ) & mask;
+    while ( slots[index].edge != EMPTY_EDGE )
+    {
+        index = ( index + 1 ) & mask;
+    }
+    slots[index] = { edge, NO_NODE, NO_HANDLER };
+    usedSlots++;
+    return slots[index];
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBCurses Nimble Library Curses Module
+    @brief      Doubles the table, placing the edges again
+    @return     void
+--------------------------------------------------------------------------*/
+void CursesKeyBindings::growTable()
+{
+    std::vector<KeySlot> old( slots.size() * 2, { EMPTY_EDGE, NO_NODE, NO_HANDLER } );
+    old.swap( slots );
+
+    uint32_t mask = (uint32_t)slots.size() - 1;
+    for ( const KeySlot& slot : old )
+    {
+        if ( slot.edge != EMPTY_EDGE )
+        {
+            uint32_t index = (uint32_t)( ( slot.edge * 0x9E3779B97F4A7C15ULL ) >> 32 ) & mask;
+            while ( slots[index].edge != EMPTY_EDGE )
+            {
+                index = ( index + 1 ) & mask;
+            }
+            slots[index] = slot;
+        }
+    }
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBCurses Nimble Library Curses Module
+    @brief      Forgets the chord in progress
+    @return     void
+--------------------------------------------------------------------------*/
+void CursesKeyBindings::resetChord()
+{
+    pendingNode    = NO_NODE;
+    pendingHandler = NO_HANDLER;
+    pendingKey     = 0;
+    pendingTimeMs  = 0;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: CursesKeyBindings.cpp
+// ----------------------------------------------------------------------------
@@ -15,9 +15,14 @@ Notes:
     keys that are tested against the keyboard input. If a key is pressed
     that matches one of the keys in the key map, then the function
     pointer callback is called.
-    The key map is a list of keys that are tested against the keyboard
-    input. If a key is pressed that matches one of the keys in the key
-    map, then the function pointer callback is called.
+    The key maps are compiled into a CursesKeyBindings hash table the
+    next time a key is processed after they change, so finding the
+    callback of a key takes the same time however many maps there are.
+    Where more than one map lists a key, the first map added is called.
+
+    A chord is a list of keys pressed one after another, such as Ctrl+K
+    then Ctrl+C. The keys before the last are held until the chord
+    completes, is broken by another key or times out.
 
     The kry codes are defined in the curses.h header file. The following
     are the most common keys:
@@ -78,9 +83,11 @@ CursesKeyboard::CursesKeyboard()
   --------------------------------------------------------------------------*/
 CursesKeyboard::CursesKeyboard( const CursesKeyboard& other )
 {
-    keyMaps = other.keyMaps;
-    lastKey = 0;
-    key     = 0;
+    keyMaps         = other.keyMaps;
+    chordMaps       = other.chordMaps;
+    bindingsChanged = true;
+    lastKey         = 0;
+    key             = 0;
 }
 
 /**----------------------------------------------------------------------------
@@ -103,6 +110,7 @@ CursesKeyboard::CursesKeyboard( const std::string name, const std::vector<uint32
 CursesKeyboard::~CursesKeyboard()
 {
     keyMaps.clear();
+    chordMaps.clear();
 }
 
 // Getters ------------------------------------------------------------------
@@ -154,6 +162,7 @@ void CursesKeyboard::addKeyMap( const std::string& name, const std::vector<uint3
     keyMap.function = function;
 
     keyMaps.push_back( keyMap );
+    bindingsChanged = true;
 }
 
 /**----------------------------------------------------------------------------
@@ -165,6 +174,7 @@ void CursesKeyboard::addKeyMap( const std::string& name, const std::vector<uint3
 void CursesKeyboard::addKeyMap( const KeyMap& keyMap )
 {
     keyMaps.push_back( keyMap );
+    bindingsChanged = true;
 }
 
 /**----------------------------------------------------------------------------
@@ -179,6 +189,22 @@ void CursesKeyboard::addKeyMapArray( const std::vector<KeyMap>& keyMapArray )
     {
         keyMaps.push_back( keyMap );
     }
+    bindingsChanged = true;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBCurses Nimble Library Curses Module
+    @brief      Add a chord, the callback is called with the last key once
+                every key has been pressed in order
+    @param      name        Name of the chord
+    @param      keys        Keys of the chord, in order
+    @param      function    Function pointer callback
+    @return     void
+    --------------------------------------------------------------------------*/
+void CursesKeyboard::addChord( const std::string& name, const std::vector<uint32_t>& keys, pKeyFunction function )
+{
+    chordMaps.push_back( { name, keys, function } );
+    bindingsChanged = true;
 }
 
 /**----------------------------------------------------------------------------
@@ -189,34 +215,69 @@ void CursesKeyboard::addKeyMapArray( const std::vector<KeyMap>& keyMapArray )
 void CursesKeyboard::clearKeyMaps()
 {
     keyMaps.clear();
+    chordMaps.clear();
+    bindingsChanged = true;
 }
 
 /**----------------------------------------------------------------------------
     @ingroup    NimbleLIBCurses Nimble Library Curses Module
-    @brief      Process the keyboard
+    @brief      Process the keyboard, the key is used if it is bound or is
+                part of a chord. With no key a chord that has timed out is
+                abandoned.
     @return     void
     --------------------------------------------------------------------------*/
 void CursesKeyboard::processKeyMaps()
 {
+    if ( bindingsChanged == true )
+    {
+        compileBindings();
+    }
     if ( key != 0 )
     {
-        for ( auto& keyMap : keyMaps )
+        if ( bindings.dispatch( key ) != CursesKeyBindings::KeyResult::Unbound )
         {
-            for ( auto keyToTest : keyMap.keys )
-            {
-                if ( key == keyToTest )
-                {
-                    if ( keyMap.function != nullptr )
-                    {
-                        keyMap.function( key );
-                    }
-                    lastKey = key;
-                    key     = 0;
-                    break;
-                }
-            }
+            lastKey = key;
+            key     = 0;
         }
     }
+    else
+    {
+        bindings.processTimeout();
+    }
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBCurses Nimble Library Curses Module
+    @brief      Checks if the keys of a chord are being held
+    @return     bool    true if a chord is in progress
+    --------------------------------------------------------------------------*/
+bool CursesKeyboard::isChordPending() const noexcept
+{
+    return bindings.isPending();
+}
+
+// Private functions --------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBCurses Nimble Library Curses Module
+    @brief      Compiles the key maps and chords into the bindings table
+    @return     void
+    --------------------------------------------------------------------------*/
+void CursesKeyboard::compileBindings()
+{
+    bindings.clear();
+    for ( auto& keyMap : keyMaps )
+    {
+        for ( auto keyToBind : keyMap.keys )
+        {
+            bindings.addBinding( { keyToBind }, keyMap.function );
+        }
+    }
+    for ( auto& chord : chordMaps )
+    {
+        bindings.addBinding( chord.keys, chord.function );
+    }
+    bindingsChanged = false;
 }
 
 //-----------------------------------------------------------------------------
@@ -204,22 +204,17 @@ int32_t CursesMenu::processMenu()
 
 /**----------------------------------------------------------------------------
     @ingroup    NimbleLIBCurses Nimble Library Curses Module
-    @brief      Process the key.
+    @brief      Process the key, through the compiled key bindings which
+                hold the menu keys.
     @param      key         Key code
     @return     void
 -----------------------------------------------------------------------------*/
 void CursesMenu::processKey( int32_t key )
 {
-    // process the key
-    for ( auto& keyMap : menuKeys )
+    if ( key != ERR )
     {
-        for ( auto& inKey : keyMap.keys )
-        {
-            if ( inKey == key )
-            {
-                keyMap.function( key );
-            }
-        }
+        setKey( (uint32_t)key );
+        processKeyMaps();
     }
 }
 
@@ -22,6 +22,14 @@ Notes:
            inkColour   - ink colour of the window
            paperColour - paper colour of the window
 
+        Drawing is batched into frames. draw() stages the window with
+        wnoutrefresh() and the terminal is written by one doupdate() when the
+        outermost endFrame() is called, outside a frame draw() updates the
+        screen straight away. Only the lines curses has seen change are
+        copied, touchwin() is only used after the whole window has been
+        repainted (colourWindow() or showWindow()). The outermost
+        frame is timed by the Profiler when it is enabled.
+
         The ColourWindow() function is used to set the colour of the window. The
         colour of the window is set using the curses wattron() function.
         The print() function is used to print text to the window.
@@ -42,6 +50,7 @@ Notes:
 
 #include <memory>
 #include "../../../inc/Modules/Curses/CursesWin.h"
+#include "../../../inc/Modules/Utilities/Profiler.h"
 
 //-----------------------------------------------------------------------------
 // Namespace
@@ -50,6 +59,12 @@ Notes:
 namespace Nimble
 {
 
+//-----------------------------------------------------------------------------
+// Class variables
+// ----------------------------------------------------------------------------
+
+uint32_t CursesWin::frameDepth = 0;
+
 //-----------------------------------------------------------------------------
 // Class Support Functions
 // ----------------------------------------------------------------------------
@@ -71,6 +86,7 @@ CursesWin::CursesWin()
     winInkColour   = 0;
     winPaperColour = 0;
     win            = nullptr;
+    winTouched     = true;
 }
 
 /**---------------------------------------------------------------------------
@@ -93,6 +109,7 @@ CursesWin::CursesWin( uint32_t width, uint32_t height, uint32_t x, uint32_t y, u
     winY           = y;
     winInkColour   = inkColour;
     winPaperColour = paperColour;
+    winTouched     = true;
 
     // create the window
     win = subwin( stdscr, winHeight, winWidth, winY, winX );
@@ -155,6 +172,28 @@ LibraryError CursesWin::displayHighlight( uint32_t x, uint32_t y, uint32_t markS
     return error;
 }
 
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBCurses Nimble Library Curses Module
+    @brief      Recolours a run of text already in the window, the text is
+                not printed again
+    @param      x       The x position of the text
+    @param      y       The y position of the text
+    @param      start   The start of the run
+    @param      end     The end of the run
+    @param      colour  The colour pair and attributes for the run
+    @return     The error code
+  --------------------------------------------------------------------------*/
+LibraryError CursesWin::displayColour( uint32_t x, uint32_t y, uint32_t start, uint32_t end, uint32_t colour )
+{
+    LibraryError error = LibraryError::No_Error;
+    if ( mvwchgat( win, y, x + start, end - start, colour & A_ATTRIBUTES, (short)( colour & A_CHARTEXT ), nullptr ) == ERR )
+    {
+        error = LibraryError::CursesWin_FailedToPrintToWindow;
+        ErrorHandler::getInstance().handleError( ErrorType::Error, error, "Failed to colour the curses window" );
+    }
+    return error;
+}
+
 /**---------------------------------------------------------------------------
     @ingroup    NimbleLIBCurses Nimble Library Curses Module
     @brief      Prints text to the curses window
@@ -251,15 +290,16 @@ LibraryError CursesWin::init( uint32_t width, uint32_t height, uint32_t x, uint3
   --------------------------------------------------------------------------*/
 LibraryError CursesWin::draw()
 {
+    PROFILE_ZONE( "CursesWin::draw" );
+
     LibraryError error = LibraryError::No_Error;
 
     // update the mouse
     processMouse();
     drawMouse( win );
 
-    // update the window.
-    touchwin( win );
-    wrefresh( win );
+    // stage the window, the screen is updated at the end of the frame
+    flush();
 
     return error;
 }
@@ -322,10 +362,45 @@ LibraryError CursesWin::clear()
 LibraryError CursesWin::refresh()
 {
     LibraryError error = LibraryError::No_Error;
-    wrefresh( win );
+    flush();
     return error;
 }
 
+// Frame compositor -----------------------------------------------------------
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBCurses Nimble Library Curses Module
+    @brief      Starts a frame, windows drawn until the matching endFrame()
+                are written to the terminal together. Frames can be nested.
+    @return     void
+  --------------------------------------------------------------------------*/
+void CursesWin::beginFrame()
+{
+    if ( frameDepth++ == 0 )
+    {
+        Profiler::getInstance().beginFrame();
+    }
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBCurses Nimble Library Curses Module
+    @brief      Ends a frame, the outermost frame writes every staged window
+                to the terminal with a single doupdate()
+    @return     void
+  --------------------------------------------------------------------------*/
+void CursesWin::endFrame()
+{
+    if ( frameDepth > 0 )
+    {
+        frameDepth--;
+        if ( frameDepth == 0 )
+        {
+            doupdate();
+            Profiler::getInstance().endFrame();
+        }
+    }
+}
+
 /**---------------------------------------------------------------------------
     @ingroup    NimbleLIBCurses Nimble Library Curses Module
     @brief      Hides the curses window
@@ -347,6 +422,7 @@ LibraryError CursesWin::showWindow()
 {
     LibraryError error = LibraryError::No_Error;
     mvwin( win, winY, winX );
+    winTouched = true;
     return error;
 }
 
@@ -526,14 +602,34 @@ bool CursesWin::colourBox( uint32_t colour, bool hasBox )
         box( win, 0, 0 );
     }
 
-    // update the window
-    touchwin( win );
-    wrefresh( win );
+    // the whole window has been repainted
+    winTouched = true;
+    flush();
 
     drawn = true;
     return ( drawn );
 }
 
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBCurses Nimble Library Curses Module
+    @brief      Stages the window for the screen, touching it first if it was
+                repainted, and updates the screen if no frame is open
+    @return     void
+  --------------------------------------------------------------------------*/
+void CursesWin::flush()
+{
+    if ( winTouched )
+    {
+        touchwin( win );
+        winTouched = false;
+    }
+    wnoutrefresh( win );
+    if ( frameDepth == 0 )
+    {
+        doupdate();
+    }
+}
+
 /**---------------------------------------------------------------------------
     @ingroup    NimbleLIBCurses Nimble Library Curses Module
     @brief      Sets the colour of the window
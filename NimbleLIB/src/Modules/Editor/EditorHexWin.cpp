@@ -8,6 +8,28 @@
 
 Notes:
 
+    The hex editor views a file through PatchedFile, the file is memory
+    mapped so only the rows on screen are ever read and a multi-GB image
+    opens straight away. Typed hex digits are held in the PatchedFile
+    overlay, shown in EDIT_INK_COLOUR, and only written to the file by
+    saveFile() (Ctrl+S). If the file is cut short on disk the rows past its
+    new end read as zeros, the title says so once the rows are read and
+    PatchedFile refuses the save.
+
+    The file is only reused when it is unchanged on disk, a save from the
+    text editor replaces the file so the hex view is opened again. While
+    the text document has unsaved changes the file on disk is not what
+    the user is editing, so the hex view is view only until it is saved.
+
+    Each row is built into one string by formatRow() and printed with a
+    single call. The hex digits and the printable character of every byte
+    value come from HEX_TABLE, built at compile time, so formatting a byte
+    is two table reads.
+
+    Row layout, offsetDigits is 8 or more for files over 4GB :
+
+        OOOOOOOO  HH HH HH HH HH HH HH HH HH HH HH HH HH HH HH HH  AAAAAAAAAAAAAAAA
+
 -----------------------------------------------------------------------------*/
 
 #pragma once
@@ -27,6 +49,41 @@ Notes:
 namespace Nimble
 {
 
+//-----------------------------------------------------------------------------
+// Local data
+// ----------------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Hex digits and printable character for every byte value
+----------------------------------------------------------------------------*/
+struct HexTable
+{
+    char hex[256][2]; //!< two hex digits of the byte
+    char ascii[256];  //!< the byte if printable, otherwise '.'
+};
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Builds the byte formatting table
+    @return     HexTable    table for all 256 byte values
+----------------------------------------------------------------------------*/
+static constexpr HexTable makeHexTable()
+{
+    const char digits[] = "0123456789ABCDEF";
+    HexTable   table    = {};
+
+    for ( uint32_t value = 0; value < 256; value++ )
+    {
+        table.hex[value][0] = digits[value >> 4];
+        table.hex[value][1] = digits[value & 0x0F];
+        table.ascii[value]  = ( value >= 0x20 && value < 0x7F ) ? (char)value : '.';
+    }
+    return table;
+}
+
+static constexpr HexTable HEX_TABLE = makeHexTable(); //!< byte formatting table
+
 //-----------------------------------------------------------------------------
 // Class functions
 // ----------------------------------------------------------------------------
@@ -53,38 +110,128 @@ EditorHexWin::~EditorHexWin()
 {
 }
 
+// file -----------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Opens a file in the hex editor, unsaved edits to the previous
+                file are lost
+    @param      filename    file to view
+    @return     LibraryError    error code
+----------------------------------------------------------------------------*/
+LibraryError EditorHexWin::openFile( const std::string& filename )
+{
+    LibraryError error = m_file.open( filename );
+
+    m_topOffset    = 0;
+    m_cursor       = 0;
+    m_lowNibble    = false;
+    m_offsetDigits = OFFSET_DIGITS;
+    while ( m_offsetDigits < 16 && ( m_file.getSize() >> ( m_offsetDigits * 4 ) ) != 0 )
+    {
+        m_offsetDigits++;
+    }
+    return error;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Writes the edited bytes back to the file
+    @return     LibraryError    error code
+----------------------------------------------------------------------------*/
+LibraryError EditorHexWin::saveFile()
+{
+    return m_file.save();
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Checks if a file is the one being viewed and is unchanged
+                on disk since it was opened
+    @param      filename    file to check
+    @return     bool    true if the file is open in the hex editor
+----------------------------------------------------------------------------*/
+bool EditorHexWin::isFileOpen( const std::string& filename ) const
+{
+    return m_file.isOpen() && m_file.getFileName() == filename && m_file.isChangedOnDisk() == false;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Checks if editing is refused, the text document of the file
+                has unsaved changes
+    @return     bool    true if view only
+----------------------------------------------------------------------------*/
+bool EditorHexWin::isViewOnly() const
+{
+    return m_editor != nullptr && m_editor->isModified();
+}
+
 // display --------------------------------------------------------------------
 
 /**----------------------------------------------------------------------------
     @ingroup    NimbleLIBIDE Nimble Library IDE Module
-    @brief      Display the status window
+    @brief      Display the rows of the file around the cursor
+    @param      bRedraw     true to repaint the window background first
 ----------------------------------------------------------------------------*/
 void EditorHexWin::display( bool bRedraw /*= false*/ )
 {
     if ( m_editor != nullptr )
     {
-        // clear the window
-        clear();
-        // display the title
-        print( WIN_TITLE_X, WIN_TITLE_Y, WIN_TITLE );
-        // display the data
-        int      line   = 1;
-        int      col    = 0;
-        uint8_t* offset = (uint8_t*)getWindow();
-
-        while ( line < WIN_HEIGHT - 1 )
+        if ( bRedraw == true )
         {
-            // display the offset
-            mvwprintw( getWindow(), line, 2, "%08X", offset );
-            // display the data
-            col = 0;
-            while ( col < 16 )
+            colourWindow( COLOUR_INDEX( WIN_INK_COLOUR, WIN_PAPER_COLOUR ), true );
+        }
+        print( WIN_TITLE_X, WIN_TITLE_Y, m_file.isModified() ? WIN_TITLE + "* " : WIN_TITLE + "  " );
+
+        uint32_t rowWidth = WIN_WIDTH - ROW_X - 1;
+        uint8_t  bytes[BYTES_PER_ROW];
+
+        for ( uint32_t row = 0; row < getRows(); row++ )
+        {
+            uint64_t offset = m_topOffset + (uint64_t)row * BYTES_PER_ROW;
+            uint32_t count  = m_file.readBytes( offset, bytes, BYTES_PER_ROW );
+
+            if ( count > 0 )
+            {
+                formatRow( m_row, offset, bytes, count, m_offsetDigits );
+            }
+            else
             {
-                mvwprintw( getWindow(), line, 13 + ( col * 3 ), "%02X", offset[ line * 16 + col ] );
-                col++;
-                offset++;
+                m_row.clear();
             }
-            line++;
+            m_row.resize( rowWidth, ' ' );
+            print( ROW_X, ROW_Y + row, m_row );
+
+            // colour the edited bytes and the cursor
+            for ( uint32_t index = 0; index < count; index++ )
+            {
+                bool edited = m_file.isEdited( offset + index );
+                bool cursor = ( offset + index == m_cursor );
+                if ( edited || cursor )
+                {
+                    attr_t  attribute = cursor ? A_REVERSE : A_NORMAL;
+                    short   colour    = edited ? COLOUR_INDEX( EDIT_INK_COLOUR, WIN_PAPER_COLOUR ) : COLOUR_INDEX( WIN_INK_COLOUR, WIN_PAPER_COLOUR );
+                    if ( getHexColumn( index ) + 2 <= rowWidth )
+                    {
+                        mvwchgat( getWindow(), ROW_Y + row, ROW_X + getHexColumn( index ), 2, attribute, colour, nullptr );
+                    }
+                    if ( getAsciiColumn( index ) + 1 <= rowWidth )
+                    {
+                        mvwchgat( getWindow(), ROW_Y + row, ROW_X + getAsciiColumn( index ), 1, attribute, colour, nullptr );
+                    }
+                }
+            }
+        }
+
+        // the rows just read may have come from pages lost to a truncation
+        if ( m_file.isTruncated() )
+        {
+            print( WIN_TITLE_X + (uint32_t)WIN_TITLE.size() + 2, WIN_TITLE_Y, TRUNCATED_TITLE );
+        }
+        else if ( isViewOnly() )
+        {
+            print( WIN_TITLE_X + (uint32_t)WIN_TITLE.size() + 2, WIN_TITLE_Y, VIEW_ONLY_TITLE );
         }
 
         // display the window
@@ -101,9 +248,107 @@ void EditorHexWin::redrawBackground()
     if ( m_editor != nullptr )
     {
         colourWindow( COLOUR_INDEX( WIN_INK_COLOUR, WIN_PAPER_COLOUR ), true );
-        print( WIN_TITLE_X, WIN_TITLE_Y, WIN_TITLE );
-        // display the window
-        draw();
+        display();
+    }
+}
+
+// control --------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Handles a key, cursor movement, hex digit entry and save
+    @param      key     key pressed
+    @return     bool    true if the key was used
+----------------------------------------------------------------------------*/
+bool EditorHexWin::processKey( uint32_t key )
+{
+    bool    used = true;
+    int64_t page = (int64_t)getRows() * BYTES_PER_ROW;
+
+    switch ( key )
+    {
+        case KEY_LEFT:
+            moveCursor( -1 );
+            break;
+        case KEY_RIGHT:
+            moveCursor( 1 );
+            break;
+        case KEY_UP:
+            moveCursor( -(int64_t)BYTES_PER_ROW );
+            break;
+        case KEY_DOWN:
+            moveCursor( BYTES_PER_ROW );
+            break;
+        case KEY_PPAGE:
+            moveCursor( -page );
+            break;
+        case KEY_NPAGE:
+            moveCursor( page );
+            break;
+        case KEY_HOME:
+            moveCursor( -(int64_t)( m_cursor % BYTES_PER_ROW ) );
+            break;
+        case KEY_END:
+            moveCursor( BYTES_PER_ROW - 1 - ( m_cursor % BYTES_PER_ROW ) );
+            break;
+        case SAVE_KEY:
+            if ( isViewOnly() == false )
+            {
+                saveFile();
+            }
+            break;
+        default:
+            if ( key >= '0' && key <= '9' )
+            {
+                used = editNibble( (uint8_t)( key - '0' ) );
+            }
+            else if ( key >= 'a' && key <= 'f' )
+            {
+                used = editNibble( (uint8_t)( key - 'a' + 10 ) );
+            }
+            else if ( key >= 'A' && key <= 'F' )
+            {
+                used = editNibble( (uint8_t)( key - 'A' + 10 ) );
+            }
+            else
+            {
+                used = false;
+            }
+            break;
+    }
+    return used;
+}
+
+// formatting -----------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Formats a row of the hex view into one string, offset, hex
+                bytes and characters. A short row is padded so the character
+                column stays aligned.
+    @param      row             string to format into, resized to fit
+    @param      offset          file offset of the first byte
+    @param      bytes           bytes of the row
+    @param      count           number of bytes, up to BYTES_PER_ROW
+    @param      offsetDigits    hex digits in the offset
+----------------------------------------------------------------------------*/
+void EditorHexWin::formatRow( std::string& row, uint64_t offset, const uint8_t* bytes, uint32_t count, uint32_t offsetDigits )
+{
+    uint32_t hexStart   = offsetDigits + 2;
+    uint32_t asciiStart = hexStart + ( BYTES_PER_ROW * 3 ) + 1;
+
+    row.assign( asciiStart + BYTES_PER_ROW, ' ' );
+    char* text = row.data();
+
+    for ( uint32_t digit = 0; digit < offsetDigits; digit++ )
+    {
+        text[offsetDigits - 1 - digit] = HEX_TABLE.hex[( offset >> ( digit * 4 ) ) & 0x0F][1];
+    }
+    for ( uint32_t index = 0; index < count && index < BYTES_PER_ROW; index++ )
+    {
+        text[hexStart + ( index * 3 )]     = HEX_TABLE.hex[bytes[index]][0];
+        text[hexStart + ( index * 3 ) + 1] = HEX_TABLE.hex[bytes[index]][1];
+        text[asciiStart + index]           = HEX_TABLE.ascii[bytes[index]];
     }
 }
 
@@ -119,6 +364,105 @@ void EditorHexWin::setIDEEditor( IDEEditor* editor )
     m_editor = editor;
 }
 
+// private functions ----------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Returns the number of rows inside the window border
+    @return     uint32_t    rows
+----------------------------------------------------------------------------*/
+uint32_t EditorHexWin::getRows() const
+{
+    return ( WIN_HEIGHT > 2 ) ? WIN_HEIGHT - 2 : 0;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Returns the column of a byte's hex digits within a row
+    @param      index       byte in the row
+    @return     uint32_t    column from the start of the row
+----------------------------------------------------------------------------*/
+uint32_t EditorHexWin::getHexColumn( uint32_t index ) const
+{
+    return m_offsetDigits + 2 + ( index * 3 );
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Returns the column of a byte's character within a row
+    @param      index       byte in the row
+    @return     uint32_t    column from the start of the row
+----------------------------------------------------------------------------*/
+uint32_t EditorHexWin::getAsciiColumn( uint32_t index ) const
+{
+    return m_offsetDigits + 2 + ( BYTES_PER_ROW * 3 ) + 1 + index;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Moves the cursor, clamped to the file, and scrolls so the
+                cursor row is on screen
+    @param      bytes   distance to move, negative moves back
+----------------------------------------------------------------------------*/
+void EditorHexWin::moveCursor( int64_t bytes )
+{
+    uint64_t size = m_file.getSize();
+    if ( size == 0 )
+    {
+        return;
+    }
+
+    if ( bytes < 0 )
+    {
+        m_cursor = ( (uint64_t)-bytes > m_cursor ) ? 0 : m_cursor - (uint64_t)-bytes;
+    }
+    else
+    {
+        m_cursor = ( (uint64_t)bytes > size - 1 - m_cursor ) ? size - 1 : m_cursor + (uint64_t)bytes;
+    }
+    m_lowNibble = false;
+
+    uint64_t rowStart = m_cursor - ( m_cursor % BYTES_PER_ROW );
+    uint64_t page     = (uint64_t)getRows() * BYTES_PER_ROW;
+    if ( rowStart < m_topOffset )
+    {
+        m_topOffset = rowStart;
+    }
+    else if ( page > 0 && rowStart >= m_topOffset + page )
+    {
+        m_topOffset = rowStart - page + BYTES_PER_ROW;
+    }
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Sets the next nibble of the byte under the cursor, the cursor
+                moves on once both nibbles are typed
+    @param      nibble  value 0 to 15
+    @return     bool    true if the byte was changed
+----------------------------------------------------------------------------*/
+bool EditorHexWin::editNibble( uint8_t nibble )
+{
+    if ( m_cursor >= m_file.getSize() || isViewOnly() )
+    {
+        return false;
+    }
+
+    uint8_t value = m_file.getByte( m_cursor );
+    value         = m_lowNibble ? (uint8_t)( ( value & 0xF0 ) | nibble ) : (uint8_t)( ( value & 0x0F ) | ( nibble << 4 ) );
+    m_file.setByte( m_cursor, value );
+
+    if ( m_lowNibble )
+    {
+        moveCursor( 1 );
+    }
+    else
+    {
+        m_lowNibble = true;
+    }
+    return true;
+}
+
 //-----------------------------------------------------------------------------
 
 } // namespace Nimble
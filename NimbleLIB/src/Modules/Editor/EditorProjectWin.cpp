@@ -8,6 +8,16 @@
 
 Notes:
 
+    The window lists the lines found by a project search, F8 searches every
+    file below the current folder for the word at the editor cursor. The
+    search runs on IDEProjectSearch's threads, processSearch() collects the
+    lines found so far, from a timer, and they are shown as they arrive.
+    Only the rows on screen are drawn, by an IDEListView.
+
+    Searches use the trigram index kept in the folder's .nimble folder, the
+    first search builds it and later searches only read the files that
+    could match and the files changed since.
+
 -----------------------------------------------------------------------------*/
 
 #pragma once
@@ -16,6 +26,7 @@ Notes:
 // Include files
 // ----------------------------------------------------------------------------
 
+#include <filesystem>
 #include "../../../inc/Modules/Editor/EditorProjectWin.h"
 
 //-----------------------------------------------------------------------------
@@ -42,13 +53,11 @@ EditorProjectWin::EditorProjectWin()
     colourWindow( COLOUR_INDEX( WIN_INK_COLOUR, WIN_PAPER_COLOUR ), true );
     print( WIN_TITLE_X, WIN_TITLE_Y, WIN_TITLE );
 
-    // update the buttons
-    m_button.initButton( 3, 1, 24, 3, IDE_COL_FG_BLUE, IDE_COL_BG_WHITE );
-    m_button.setButtonText( "Button" );
-    m_button.setWindowHandle( getWindow() );
-    m_button2.initButton( 3, 4, 24, 7, IDE_COL_FG_GREEN, IDE_COL_BG_WHITE );
-    m_button2.setButtonText( "Big Button" );
-    m_button2.setWindowHandle( getWindow() );
+    // the search results
+    m_search.setIndexed( true );
+    m_listView.init( getWindow(), LIST_X, LIST_Y, LIST_WIDTH, LIST_ROWS, COLOUR_INDEX( WIN_INK_COLOUR, WIN_PAPER_COLOUR ),
+                     std::bind( &EditorProjectWin::getRow, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3 ) );
+    drawSearchStatus();
 }
 
 /**----------------------------------------------------------------------------
@@ -73,13 +82,13 @@ void EditorProjectWin::display( bool bRedraw /*= false*/ )
         {
             colourWindow( COLOUR_INDEX( WIN_INK_COLOUR, WIN_PAPER_COLOUR ), true );
             print( WIN_TITLE_X, WIN_TITLE_Y, WIN_TITLE );
+            m_listView.invalidate();
         }
+        // only the rows of results that have changed are drawn, there is no cursor
+        drawSearchStatus();
+        m_listView.draw( COLOUR_INDEX( WIN_INK_COLOUR, WIN_PAPER_COLOUR ) );
         // display the window
         draw();
-        m_button.drawButton();
-        m_button.processClick( m_editor->getMouseX(), m_editor->getMouseY() );
-        m_button2.drawButton();
-        m_button2.processClick( m_editor->getMouseX(), m_editor->getMouseY() );
     }
 }
 
@@ -95,6 +104,104 @@ void EditorProjectWin::setIDEEditor( IDEEditor* editor )
     m_editor = editor;
 }
 
+// project search -------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Starts searching every file below the current folder, the
+                lines found so far are cleared
+    @param      pattern     text to find, matching case
+    @return     LibraryError
+----------------------------------------------------------------------------*/
+LibraryError EditorProjectWin::searchProject( const std::string& pattern )
+{
+    LibraryError error = m_search.start( std::filesystem::current_path().string(), pattern, true, false );
+
+    m_results.clear();
+    m_listView.setItemCount( 0 );
+    m_searchActive = ( error == LibraryError::No_Error && pattern.empty() == false );
+    return error;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Adds the lines found since the last call
+    @return     bool    true if the window needs drawing
+----------------------------------------------------------------------------*/
+bool EditorProjectWin::processSearch()
+{
+    // checked before polling, every line found before the search ended is polled
+    bool running = m_search.isSearching();
+    bool changed = m_search.poll( m_results );
+
+    if ( changed )
+    {
+        m_listView.setItemCount( (uint32_t)m_results.size() );
+    }
+    if ( running == false && m_searchActive == true )
+    {
+        m_searchActive = false;
+        changed        = true;
+    }
+    return changed;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Checks if lines may still arrive from the search
+    @return     bool    true until the search has ended and been polled
+----------------------------------------------------------------------------*/
+bool EditorProjectWin::isSearching() const
+{
+    return m_searchActive;
+}
+
+// private functions ----------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Gets a row of the results, the file name, line and text
+    @param      item    line found
+    @param      text    set to the row
+    @param      colour  set to the colour of the row
+    @return     void
+----------------------------------------------------------------------------*/
+void EditorProjectWin::getRow( uint32_t item, std::string& text, uint32_t& colour ) const
+{
+    const IDEProjectSearch::SearchResult& result = m_results[item];
+    size_t                                indent = result.text.find_first_not_of( " \t" );
+
+    text = std::filesystem::path( result.path ).filename().string() + ":" + std::to_string( result.line ) + " ";
+    if ( indent != std::string::npos )
+    {
+        text.append( result.text, indent, std::string::npos );
+    }
+    colour = COLOUR_INDEX( WIN_INK_COLOUR, WIN_PAPER_COLOUR );
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Draws the line above the results, the pattern searched for
+                and the lines and files found so far
+    @return     void
+----------------------------------------------------------------------------*/
+void EditorProjectWin::drawSearchStatus()
+{
+    std::string statusText;
+
+    if ( m_search.getPattern().empty() )
+    {
+        statusText = "F8 searches for the word";
+    }
+    else
+    {
+        statusText = ( m_searchActive ? "Searching " : "" ) + m_search.getPattern() + ": " + std::to_string( m_search.getMatchCount() ) + ( m_search.isTruncated() ? "+" : "" ) + " in " +
+                     std::to_string( m_search.getFilesSearched() ) + " files";
+    }
+    statusText.resize( LIST_WIDTH, ' ' );
+    print( LIST_X, LIST_Y - 1, statusText );
+}
+
 //-----------------------------------------------------------------------------
 
 } // namespace Nimble
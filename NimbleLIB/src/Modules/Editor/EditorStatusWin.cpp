@@ -8,6 +8,10 @@
 
 Notes:
 
+    With the profile overlay shown the status bar also shows the last,
+    average and 99th percentile frame times and the zones that took longest
+    over the Profiler's frame history, in milliseconds per frame.
+
 -----------------------------------------------------------------------------*/
 
 #pragma once
@@ -18,6 +22,10 @@ Notes:
 
 #include "../../../inc/Modules/Editor/EditorStatusWin.h"
 #include "../../../inc/Modules/Global/Globals.h"
+#include "../../../inc/Modules/Utilities/Profiler.h"
+#include <algorithm>
+#include <cstdio>
+#include <string_view>
 
 //-----------------------------------------------------------------------------
 // Namespace
@@ -77,11 +85,59 @@ void EditorStatusWin::display( bool bRedraw /*= false*/ )
         mvwchgat( getWindow(), STATUS_EDITORLINE, COLS - STATUS_EDITORCOLOFFSET2, STATUS_EDITORCOLOFFSET2SZ, A_NORMAL, COLOUR_INDEX( IDE_COL_FG_GREEN, IDE_COL_BG_WHITE ), nullptr );
         mvwprintw( getWindow(), STATUS_EDITORMOUSE, COLS - STATUS_EDITORXOFFSET, "Mouse: %d, %d    ", GControl.getMouseX(), GControl.getMouseY() );
         mvwprintw( getWindow(), STATUS_EDITORMOUSE, 4, "Componets active - %d", GControl.getManagerComponents() );
+        // progress of a file still being read in, blanked once it is loaded
+        std::string loadString = m_editor->isLoading() ? "Loading: " + std::to_string( m_editor->getLoadProgress() ) + "%" : "";
+        if ( m_editor->isFileTruncated() )
+        {
+            loadString = "File truncated";
+        }
+        loadString.resize( STATUS_LOADSIZE, ' ' );
+        mvwprintw( getWindow(), STATUS_EDITORLINE, STATUS_LOADX, "%s", loadString.c_str() );
+        if ( m_profileOverlay == true )
+        {
+            displayProfile();
+        }
         // display the window
         draw();
     }
 }
 
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Display the frame times and the most expensive zones
+----------------------------------------------------------------------------*/
+void EditorStatusWin::displayProfile()
+{
+    Profiler& profiler  = Profiler::getInstance();
+    double    lastMs    = 0.0;
+    double    averageMs = 0.0;
+    double    p99Ms     = 0.0;
+    char      text[64];
+
+    // frame times, beside the load progress
+    std::string frameString = "Frame ms: none";
+    if ( profiler.getFrameTimes( lastMs, averageMs, p99Ms ) )
+    {
+        snprintf( text, sizeof( text ), "Frame ms: %.2f avg %.2f p99 %.2f", lastMs, averageMs, p99Ms );
+        frameString = text;
+    }
+    frameString.resize( std::max<int>( COLS - STATUS_EDITORXOFFSET - STATUS_FRAMEX - 1, 0 ), ' ' );
+    mvwprintw( getWindow(), STATUS_EDITORLINE, STATUS_FRAMEX, "%s", frameString.c_str() );
+
+    // zones, as time per frame without the class name
+    uint64_t    frames      = std::min<uint64_t>( std::max<uint64_t>( profiler.getFrameCount(), 1 ), Profiler::FRAME_HISTORY );
+    std::string zonesString = "Top:";
+    for ( auto& zone : profiler.getTopZones( STATUS_TOPZONES ) )
+    {
+        std::string_view name = zone.first;
+        name                  = name.substr( name.rfind( ':' ) == std::string_view::npos ? 0 : name.rfind( ':' ) + 1 );
+        snprintf( text, sizeof( text ), " %.*s %.2f", (int)name.size(), name.data(), zone.second / 1e6 / frames );
+        zonesString += text;
+    }
+    zonesString.resize( std::max<int>( COLS - STATUS_EDITORXOFFSET - STATUS_ZONESX - 1, 0 ), ' ' );
+    mvwprintw( getWindow(), STATUS_EDITORMOUSE, STATUS_ZONESX, "%s", zonesString.c_str() );
+}
+
 // setters --------------------------------------------------------------------
 
 /**----------------------------------------------------------------------------
@@ -94,6 +150,30 @@ void EditorStatusWin::setIDEEditor( IDEEditor* editor )
     m_editor = editor;
 }
 
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Shows or hides the profile overlay, the Profiler is enabled
+                while it is shown
+    @param      show        true to show the overlay
+----------------------------------------------------------------------------*/
+void EditorStatusWin::setProfileOverlay( bool show )
+{
+    m_profileOverlay = show;
+    Profiler::getInstance().setEnabled( show );
+}
+
+// getters --------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Checks if the profile overlay is shown
+    @return     bool        true if shown
+----------------------------------------------------------------------------*/
+bool EditorStatusWin::isProfileOverlayShown() const
+{
+    return m_profileOverlay;
+}
+
 //-----------------------------------------------------------------------------
 
 } // namespace Nimble
@@ -21,15 +21,22 @@ Notes:
     - LibraryError - Error number
     - std::string - Error message
 
-    The ErrorHandler::handleError() function creates a new ErrorInformation
-    structure and adds it to the errorList vector. This vector is used to
-    report the errors to the console terminal if needed, and log them.
+    Storage is bounded. The last RECENT_ERRORS errors are kept in a ring,
+    the oldest is written over once it is full, and the same error reported
+    again straight after is counted against the entry already kept rather
+    than stored or logged again, so a burst of one error costs one entry.
+    The log is told how many times it repeated once a different error
+    arrives, when reportRepeats() is called, which the IDE does on a timer,
+    on flush() and when the handler is destroyed, so the count of a burst
+    that ends the run is not lost.
+    Every report is also counted, by ErrorType and by error code, with the
+    times a code was first and last reported. The counters are atomics in a
+    fixed open addressed table, getErrorCount(), getErrorTimes() and
+    getStatusInformation() read them without walking the errors. Only the
+    ring takes a lock.
     The ErrorHandler::reportErrors() function is used to report the errors
-    to the console terminal. This function loops through the errorList vector
-    and calls the ErrorHandler::displayMessage() function to display the
-    error to the console terminal.
-    The ErrorHandler::displayMessage() function displays the error to the
-    console terminal. This function takes one parameter:
+    kept to the console terminal, calling ErrorHandler::displayMessage() for
+    each. This function takes one parameter:
 
     - ErrorInformation - Error structure
 
@@ -41,6 +48,7 @@ Notes:
 // Include files
 // ----------------------------------------------------------------------------
 
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
 #include "../../../inc/Modules/ErrorHandling/ErrorHandler.h"
@@ -63,7 +71,12 @@ namespace Nimble
   --------------------------------------------------------------------------*/
 ErrorHandler::ErrorHandler()
 {
-    errorList.clear();
+    errorList.resize( RECENT_ERRORS );
+    for ( ErrorCounter& counter : counters )
+    {
+        counter.number.store( EMPTY_CODE, std::memory_order_relaxed );
+    }
+    clearErrors();
 
     // Initialize the logger
     loggerInitialize();
@@ -76,6 +89,8 @@ ErrorHandler::ErrorHandler()
   --------------------------------------------------------------------------*/
 ErrorHandler::~ErrorHandler()
 {
+    // the logger drains the ring as it is destroyed
+    reportRepeats();
     errorList.clear();
 }
 
@@ -89,26 +104,118 @@ ErrorHandler::~ErrorHandler()
   --------------------------------------------------------------------------*/
 void ErrorHandler::handleError( ErrorType errorType, LibraryError errorNumber, const std::string& message )
 {
-    // Create a new error
-    ErrorInformation info;
-    info.type    = errorType;
-    info.number  = errorNumber;
-    info.message = message;
-    info.time    = std::chrono::system_clock::to_time_t( std::chrono::system_clock::now() ); // Add the error to the list
-    errorList.push_back( info );
+    std::time_t now      = std::chrono::system_clock::to_time_t( std::chrono::system_clock::now() );
+    uint32_t    repeated = 0;
+
+    // count the error, by type and by code
+    typeCounts[std::min<uint32_t>( (uint32_t)errorType, (uint32_t)ErrorType::Critical )].fetch_add( 1, std::memory_order_relaxed );
+    ErrorCounter* counter = findCounter( errorNumber, true );
+    if ( counter != nullptr )
+    {
+        int64_t unset = 0;
+        counter->first.compare_exchange_strong( unset, (int64_t)now, std::memory_order_relaxed );
+        counter->last.store( (int64_t)now, std::memory_order_relaxed );
+        counter->count.fetch_add( 1, std::memory_order_relaxed );
+    }
+
+    {
+        std::lock_guard<std::mutex> lock( recentMutex );
+
+        // a repeat of the last error only counts against it
+        ErrorInformation* last = ( errorCount > 0 ) ? &errorList[( errorNext + RECENT_ERRORS - 1 ) % RECENT_ERRORS] : nullptr;
+        if ( last != nullptr && last->type == errorType && last->number == errorNumber && last->message == message )
+        {
+            last->repeats++;
+            last->lastTime = now;
+            return;
+        }
+        repeated      = ( last != nullptr ) ? last->repeats - repeatsLogged : 0;
+        repeatsLogged = 1;
+
+        // Add the error to the list, over the oldest once it is full
+        ErrorInformation& info = errorList[errorNext];
+        info.type              = errorType;
+        info.number            = errorNumber;
+        info.message           = message;
+        info.time              = now;
+        info.lastTime          = now;
+        info.repeats           = 1;
+        errorNext              = ( errorNext + 1 ) % RECENT_ERRORS;
+        if ( errorCount < RECENT_ERRORS )
+        {
+            errorCount++;
+        }
+    }
 
     // log error message
+    if ( repeated > 0 )
+    {
+        LogMessage( "last error repeated " + std::to_string( repeated ) + " times" );
+    }
     LogError( errorNumber, message );
 }
 
 /**---------------------------------------------------------------------------
     @ingroup    NimbleLIBError Nimble Library Error Module
-    @brief      Clears the error list
+    @brief      Logs how many times the newest error has repeated since it,
+                or its repeats, were last logged
+    @return     uint32_t - repeats logged, 0 if there were none
+  --------------------------------------------------------------------------*/
+uint32_t ErrorHandler::reportRepeats()
+{
+    uint32_t repeated = 0;
+
+    {
+        std::lock_guard<std::mutex> lock( recentMutex );
+        if ( errorCount > 0 )
+        {
+            const ErrorInformation& last = errorList[( errorNext + RECENT_ERRORS - 1 ) % RECENT_ERRORS];
+            repeated                     = last.repeats - repeatsLogged;
+            repeatsLogged                = last.repeats;
+        }
+    }
+
+    if ( repeated > 0 )
+    {
+        LogMessage( "last error repeated " + std::to_string( repeated ) + " times" );
+    }
+    return repeated;
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBError Nimble Library Error Module
+    @brief      Logs the repeats of the newest error not yet logged, then
+                waits until everything logged so far has been output
+    @return     void
+  --------------------------------------------------------------------------*/
+void ErrorHandler::flush()
+{
+    reportRepeats();
+    Logger::flush();
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBError Nimble Library Error Module
+    @brief      Clears the error list and the counts
     @return     void
   --------------------------------------------------------------------------*/
 void ErrorHandler::clearErrors()
 {
-    errorList.clear();
+    std::lock_guard<std::mutex> lock( recentMutex );
+
+    errorNext     = 0;
+    errorCount    = 0;
+    repeatsLogged = 0;
+    for ( ErrorCounter& counter : counters )
+    {
+        counter.count.store( 0, std::memory_order_relaxed );
+        counter.first.store( 0, std::memory_order_relaxed );
+        counter.last.store( 0, std::memory_order_relaxed );
+    }
+    for ( std::atomic<uint32_t>& count : typeCounts )
+    {
+        count.store( 0, std::memory_order_relaxed );
+    }
 }
 
 /**---------------------------------------------------------------------------
@@ -118,7 +225,9 @@ void ErrorHandler::clearErrors()
  --------------------------------------------------------------------------*/
 void ErrorHandler::reportErrors()
 {
-    if ( errorList.empty() )
+    std::vector<ErrorInformation> errors = getRecentErrors();
+
+    if ( errors.empty() )
     {
         std::cout << "No errors to report" << std::endl;
         return;
@@ -126,13 +235,66 @@ void ErrorHandler::reportErrors()
     else
     {
         std::cout << "Errors reported:" << std::endl;
-        for ( auto& error : errorList )
+        for ( auto& error : errors )
         {
             displayMessage( error );
         }
     }
 }
 
+// error queries --------------------------------------------------------------
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBError Nimble Library Error Module
+    @brief      Returns the times an error code has been reported
+    @param      error - Error code
+    @return     uint64_t - times reported since the last clearErrors()
+  --------------------------------------------------------------------------*/
+uint64_t ErrorHandler::getErrorCount( LibraryError error )
+{
+    ErrorCounter* counter = findCounter( error, false );
+    return ( counter != nullptr ) ? counter->count.load( std::memory_order_relaxed ) : 0;
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBError Nimble Library Error Module
+    @brief      Returns when an error code was first and last reported
+    @param      error - Error code
+    @param      first - set to the time first reported
+    @param      last - set to the time last reported
+    @return     bool - false if the error has not been reported
+  --------------------------------------------------------------------------*/
+bool ErrorHandler::getErrorTimes( LibraryError error, std::time_t& first, std::time_t& last )
+{
+    ErrorCounter* counter = findCounter( error, false );
+    if ( counter == nullptr || counter->count.load( std::memory_order_relaxed ) == 0 )
+    {
+        return false;
+    }
+    first = (std::time_t)counter->first.load( std::memory_order_relaxed );
+    last  = (std::time_t)counter->last.load( std::memory_order_relaxed );
+    return true;
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBError Nimble Library Error Module
+    @brief      Returns the errors kept, a run of the same error is one
+                entry with its repeats counted
+    @return     std::vector<ErrorInformation> - errors, oldest first
+  --------------------------------------------------------------------------*/
+std::vector<ErrorInformation> ErrorHandler::getRecentErrors()
+{
+    std::lock_guard<std::mutex>   lock( recentMutex );
+    std::vector<ErrorInformation> errors;
+
+    errors.reserve( errorCount );
+    for ( uint32_t index = 0; index < errorCount; index++ )
+    {
+        errors.push_back( errorList[( errorNext + RECENT_ERRORS - errorCount + index ) % RECENT_ERRORS] );
+    }
+    return errors;
+}
+
 /**---------------------------------------------------------------------------
     @ingroup    USBHIDConsoleApplication USB HID Console Application
     @brief      Returns the current status of the error handler
@@ -143,34 +305,10 @@ ErrorStatus ErrorHandler::getStatusInformation()
 {
     ErrorStatus info;
 
-    info.Clear();
-
-    for ( auto& error : errorList )
-    {
-        switch ( error.type )
-        {
-            case ErrorType::Status:
-            {
-                info.numStatus++;
-                break;
-            }
-            case ErrorType::Warning:
-            {
-                info.numWarnings++;
-                break;
-            }
-            case ErrorType::Critical:
-            {
-                info.numCritical++;
-                break;
-            }
-            default:
-            {
-                info.numErrors++;
-                break;
-            }
-        }
-    }
+    info.numStatus   = typeCounts[(uint32_t)ErrorType::Status].load( std::memory_order_relaxed );
+    info.numWarnings = typeCounts[(uint32_t)ErrorType::Warning].load( std::memory_order_relaxed );
+    info.numErrors   = typeCounts[(uint32_t)ErrorType::Error].load( std::memory_order_relaxed );
+    info.numCritical = typeCounts[(uint32_t)ErrorType::Critical].load( std::memory_order_relaxed );
     info.totalErrors = info.numErrors + info.numWarnings + info.numStatus + info.numCritical;
     return info;
 }
@@ -212,7 +350,48 @@ void ErrorHandler::displayMessage( const ErrorInformation& error )
         }
     }
     // continue to display the error message
-    std::cout << error.message << " (" << std::hex << (uint32_t)error.number << ")" << std::dec << std::endl;
+    std::cout << error.message << " (" << std::hex << (uint32_t)error.number << ")" << std::dec;
+    if ( error.repeats > 1 )
+    {
+        std::cout << " x " << error.repeats;
+    }
+    std::cout << std::endl;
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBError Nimble Library Error Module
+    @brief      Finds the counter of an error code, the table is open
+                addressed and slots are claimed without a lock
+    @param      error - Error code
+    @param      add - claim a slot if the code has none
+    @return     ErrorCounter* - counter, nullptr if not found or the table
+                is full
+  --------------------------------------------------------------------------*/
+ErrorHandler::ErrorCounter* ErrorHandler::findCounter( LibraryError error, bool add )
+{
+    uint32_t number = (uint32_t)error;
+    uint32_t index  = (uint32_t)( ( number * 0x9E3779B97F4A7C15ULL ) >> 32 ) & ( ERROR_CODES - 1 );
+
+    for ( uint32_t probe = 0; probe < ERROR_CODES; probe++ )
+    {
+        ErrorCounter& counter = counters[index];
+        uint32_t      current = counter.number.load( std::memory_order_acquire );
+        if ( current == EMPTY_CODE && add )
+        {
+            counter.number.compare_exchange_strong( current, number, std::memory_order_acq_rel );
+            current = counter.number.load( std::memory_order_acquire );
+        }
+        if ( current == number )
+        {
+            return &counter;
+        }
+        if ( current == EMPTY_CODE )
+        {
+            return nullptr;
+        }
+        index = ( index + 1 ) & ( ERROR_CODES - 1 );
+    }
+    return nullptr;
 }
 
 //-----------------------------------------------------------------------------
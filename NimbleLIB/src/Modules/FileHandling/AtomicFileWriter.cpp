@@ -0,0 +1,381 @@
+/**----------------------------------------------------------------------------
+
+    @file       AtomicFileWriter.cpp
+    @defgroup   NimbleLIBFile Nimble Library File Module
+    @brief      Writes a file in large gathered batches and replaces the
+                target only once the whole file is on disk
+    @copyright  Neil Bereford 2023
+
+Notes:
+
+    write() does not copy, it keeps a view of each span and the caller
+    keeps the text alive until commit(). Up to MAX_SPANS views are handed
+    to the OS in one writev(), so the number of system calls follows the
+    number of spans / MAX_SPANS rather than the number of lines.
+
+    The temporary file is created in the same directory as the target so
+    the rename cannot cross a file system. commit() syncs the file before
+    the rename and the directory after it, after a crash the target is
+    either the old file or the whole new one. The target's permissions are
+    copied to the temporary file, a symbolic link is followed so the file
+    it points to is replaced rather than the link.
+
+-----------------------------------------------------------------------------*/
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include "../../../inc/Modules/FileHandling/AtomicFileWriter.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <filesystem>
+
+#if defined( _WIN32 )
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+//-----------------------------------------------------------------------------
+// Namesapce
+//-----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Class Support Functions
+//-----------------------------------------------------------------------------
+
+// Constructors and Destructors -----------------------------------------------
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Constructor for the AtomicFileWriter class
+
+  --------------------------------------------------------------------------*/
+AtomicFileWriter::AtomicFileWriter()
+{
+    fileHandle   = -1;
+    bytesWritten = 0;
+    writeError   = LibraryError::No_Error;
+    spans.reserve( MAX_SPANS );
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Destructor for the AtomicFileWriter class, a write not
+                committed is abandoned and the target left as it was
+
+  --------------------------------------------------------------------------*/
+AtomicFileWriter::~AtomicFileWriter()
+{
+    abort();
+}
+
+// File Handling --------------------------------------------------------------
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Creates the temporary file the text is written to, any write
+                not committed is abandoned
+    @param      fileName    file to write, replaced by commit()
+    @return     LibraryError    error code
+  --------------------------------------------------------------------------*/
+LibraryError AtomicFileWriter::open( const std::string& fileName )
+{
+    abort();
+    writeError   = LibraryError::No_Error;
+    bytesWritten = 0;
+
+    // replace the file a link points to, not the link
+    std::error_code       pathError;
+    std::filesystem::path target = fileName;
+    if ( std::filesystem::is_symlink( target, pathError ) )
+    {
+        target = std::filesystem::canonical( target, pathError );
+        if ( pathError )
+        {
+            target = fileName;
+        }
+    }
+    std::filesystem::path directory = target.parent_path();
+    std::string           prefix    = ( directory.empty() ? std::string() : directory.string() + "/" ) + "." + target.filename().string();
+    this->fileName                  = target.string();
+
+#if defined( _WIN32 )
+    tempName      = prefix + "." + std::to_string( GetCurrentProcessId() ) + ".tmp";
+    HANDLE handle = CreateFileA( tempName.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr );
+    if ( handle == INVALID_HANDLE_VALUE )
+    {
+        tempName.clear();
+        return fail( LibraryError::AtomicFileWriter_FailedToCreateFile, "AtomicFileWriter::open() : failed to create a file beside " + this->fileName );
+    }
+    fileHandle = (intptr_t)handle;
+#else
+    std::vector<char> pattern( prefix.begin(), prefix.end() );
+    const char*       suffix = ".XXXXXX";
+    pattern.insert( pattern.end(), suffix, suffix + 8 );
+    int file = mkstemp( pattern.data() );
+    if ( file < 0 )
+    {
+        return fail( LibraryError::AtomicFileWriter_FailedToCreateFile, "AtomicFileWriter::open() : failed to create a file beside " + this->fileName );
+    }
+    tempName   = pattern.data();
+    fileHandle = file;
+
+    // mkstemp() creates the file 0600, give it the target's permissions
+    struct stat info;
+    if ( stat( this->fileName.c_str(), &info ) == 0 )
+    {
+        fchmod( file, info.st_mode & 07777 );
+    }
+    else
+    {
+        mode_t mask = umask( 0 );
+        umask( mask );
+        fchmod( file, 0666 & ~mask );
+    }
+#endif
+    return LibraryError::No_Error;
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Adds a span to the file, the text is not copied and must
+                stay valid until commit() or abort()
+    @param      span    text to write
+    @return     LibraryError    error code, the first error is kept
+  --------------------------------------------------------------------------*/
+LibraryError AtomicFileWriter::write( std::string_view span )
+{
+    if ( fileHandle == -1 || writeError != LibraryError::No_Error )
+    {
+        return ( writeError != LibraryError::No_Error ) ? writeError : LibraryError::AtomicFileWriter_FailedToWriteFile;
+    }
+    if ( span.empty() == false )
+    {
+        spans.push_back( span );
+        if ( spans.size() == MAX_SPANS )
+        {
+            return flush();
+        }
+    }
+    return LibraryError::No_Error;
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Writes the spans left, syncs the file to disk and renames it
+                over the target. On failure the target is left as it was
+    @return     LibraryError    error code
+  --------------------------------------------------------------------------*/
+LibraryError AtomicFileWriter::commit()
+{
+    LibraryError error = flush();
+
+    if ( fileHandle == -1 )
+    {
+        error = LibraryError::AtomicFileWriter_FailedToWriteFile;
+    }
+    if ( error != LibraryError::No_Error )
+    {
+        abort();
+        return error;
+    }
+
+#if defined( _WIN32 )
+    HANDLE handle = (HANDLE)fileHandle;
+    bool   synced = FlushFileBuffers( handle ) != FALSE;
+    CloseHandle( handle );
+    fileHandle = -1;
+    if ( synced == false )
+    {
+        error = fail( LibraryError::AtomicFileWriter_FailedToWriteFile, "AtomicFileWriter::commit() : failed to sync " + tempName );
+    }
+    else if ( MoveFileExA( tempName.c_str(), fileName.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH ) == FALSE )
+    {
+        error = fail( LibraryError::AtomicFileWriter_FailedToReplaceFile, "AtomicFileWriter::commit() : failed to replace " + fileName );
+    }
+#else
+    int  file   = (int)fileHandle;
+    bool synced = fsync( file ) == 0;
+    fileHandle  = -1;
+    if ( ::close( file ) != 0 || synced == false )
+    {
+        error = fail( LibraryError::AtomicFileWriter_FailedToWriteFile, "AtomicFileWriter::commit() : failed to sync " + tempName );
+    }
+    else if ( rename( tempName.c_str(), fileName.c_str() ) != 0 )
+    {
+        error = fail( LibraryError::AtomicFileWriter_FailedToReplaceFile, "AtomicFileWriter::commit() : failed to replace " + fileName );
+    }
+    else
+    {
+        // the rename itself is only durable once the directory is synced
+        std::string directory = std::filesystem::path( fileName ).parent_path().string();
+        int         folder    = ::open( directory.empty() ? "." : directory.c_str(), O_RDONLY | O_DIRECTORY );
+        if ( folder >= 0 )
+        {
+            fsync( folder );
+            ::close( folder );
+        }
+    }
+#endif
+
+    if ( error == LibraryError::No_Error )
+    {
+        tempName.clear();
+    }
+    abort();
+    return error;
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Abandons the write, the temporary file is removed and the
+                target left as it was
+    @return     void
+  --------------------------------------------------------------------------*/
+void AtomicFileWriter::abort()
+{
+    if ( fileHandle != -1 )
+    {
+#if defined( _WIN32 )
+        CloseHandle( (HANDLE)fileHandle );
+#else
+        ::close( (int)fileHandle );
+#endif
+        fileHandle = -1;
+    }
+    if ( tempName.empty() == false )
+    {
+        std::remove( tempName.c_str() );
+        tempName.clear();
+    }
+    spans.clear();
+}
+
+// Getters --------------------------------------------------------------------
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Returns if a write has been opened and not yet committed
+    @return     bool    true if open
+  --------------------------------------------------------------------------*/
+bool AtomicFileWriter::isOpen() const
+{
+    return fileHandle != -1;
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Returns the bytes written to the temporary file so far
+    @return     uint64_t    bytes written
+  --------------------------------------------------------------------------*/
+uint64_t AtomicFileWriter::getBytesWritten() const
+{
+    return bytesWritten;
+}
+
+// Private Functions ----------------------------------------------------------
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Writes the spans waiting, gathered into as few writes as the
+                OS allows
+    @return     LibraryError    error code
+  --------------------------------------------------------------------------*/
+LibraryError AtomicFileWriter::flush()
+{
+    if ( writeError != LibraryError::No_Error || spans.empty() )
+    {
+        spans.clear();
+        return writeError;
+    }
+
+#if defined( _WIN32 )
+    for ( std::string_view span : spans )
+    {
+        while ( span.empty() == false )
+        {
+            DWORD length  = (DWORD)std::min<size_t>( span.size(), 0x40000000 );
+            DWORD written = 0;
+            if ( WriteFile( (HANDLE)fileHandle, span.data(), length, &written, nullptr ) == FALSE )
+            {
+                spans.clear();
+                return fail( LibraryError::AtomicFileWriter_FailedToWriteFile, "AtomicFileWriter::flush() : failed to write " + tempName );
+            }
+            span.remove_prefix( written );
+            bytesWritten += written;
+        }
+    }
+#else
+    struct iovec vectors[MAX_SPANS];
+    uint32_t     count = (uint32_t)spans.size();
+    for ( uint32_t index = 0; index < count; index++ )
+    {
+        vectors[index].iov_base = (void*)spans[index].data();
+        vectors[index].iov_len  = spans[index].size();
+    }
+
+    // a write may stop short, carry on from where it stopped
+    struct iovec* next = vectors;
+    while ( count > 0 )
+    {
+        ssize_t written = writev( (int)fileHandle, next, (int)count );
+        if ( written < 0 )
+        {
+            if ( errno == EINTR )
+            {
+                continue;
+            }
+            spans.clear();
+            return fail( LibraryError::AtomicFileWriter_FailedToWriteFile, "AtomicFileWriter::flush() : failed to write " + tempName );
+        }
+        bytesWritten += (uint64_t)written;
+        while ( count > 0 && (size_t)written >= next->iov_len )
+        {
+            written -= (ssize_t)next->iov_len;
+            next++;
+            count--;
+        }
+        if ( count > 0 )
+        {
+            next->iov_base = (char*)next->iov_base + written;
+            next->iov_len -= (size_t)written;
+        }
+    }
+#endif
+    spans.clear();
+    return LibraryError::No_Error;
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Records and reports an error, only the first is kept
+    @param      error   error code
+    @param      message message for the error handler
+    @return     LibraryError    the error code
+  --------------------------------------------------------------------------*/
+LibraryError AtomicFileWriter::fail( LibraryError error, const std::string& message )
+{
+    if ( writeError == LibraryError::No_Error )
+    {
+        writeError = error;
+    }
+    ErrorHandler::getInstance().handleError( ErrorType::Error, error, message );
+    return error;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: AtomicFileWriter.cpp
+//-----------------------------------------------------------------------------
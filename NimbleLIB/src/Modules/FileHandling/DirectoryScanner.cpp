@@ -0,0 +1,579 @@
+/**----------------------------------------------------------------------------
+
+    @file       DirectoryScanner.cpp
+    @defgroup   NimbleLIBFile Nimble Library File Module
+    @brief      Background directory scanner with cached listings
+    @copyright  Neil Bereford 2023
+
+Notes:
+
+    scan() starts a scanner thread reading the directory and returns at
+    once, poll() is called by the UI thread once a frame and hands over the
+    entries read so far, so a large directory, or one on a slow network
+    mount, is shown as it arrives rather than freezing the UI.
+
+    On Linux the scanner reads the directory with getdents64, READ_BUFFER
+    bytes of entries a call, and takes whether an entry is a directory
+    from its d_type. Only entries the file system gives no type for, and
+    symbolic links, are stat'ed. Other systems use directory_iterator,
+    whose entries already hold their type on Windows. The entries are not
+    sorted, the caller sorts them as it wants.
+
+    Each completed listing is cached, CACHED_PATHS of them, the least
+    recently used dropped first, so reading the same directory again is
+    instant. On Linux an inotify watch is added on the directory before it
+    is read, any change to its entries drops the listing. Where there is
+    no inotify, or no watch could be added, the directory write time is
+    checked instead when the listing is used. A listing of a directory that
+    changed while it was read is not cached.
+
+-----------------------------------------------------------------------------*/
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include "../../../inc/Modules/FileHandling/DirectoryScanner.h"
+#include <chrono>
+
+#if defined( __linux__ )
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+//-----------------------------------------------------------------------------
+// Namesapce
+//-----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Local Data
+//-----------------------------------------------------------------------------
+
+#if defined( __linux__ )
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Directory entry as getdents64 returns it
+  --------------------------------------------------------------------------*/
+struct LinuxDirent64
+{
+    uint64_t       d_ino;    //!< inode number
+    int64_t        d_off;    //!< offset of the next entry
+    unsigned short d_reclen; //!< size of this entry
+    unsigned char  d_type;   //!< file type, DT_UNKNOWN if not known
+    char           d_name[]; //!< name, null terminated
+};
+
+static const uint32_t WATCH_EVENTS = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR; //!< changes to the entries
+#endif
+
+//-----------------------------------------------------------------------------
+// Class Support Functions
+//-----------------------------------------------------------------------------
+
+// Constructors and Destructors -----------------------------------------------
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Constructor for the DirectoryScanner class
+
+  --------------------------------------------------------------------------*/
+DirectoryScanner::DirectoryScanner() : batches( SCAN_BATCHES )
+{
+    stopScanning = false;
+    scanComplete = false;
+    scanFailed   = false;
+    scanning     = false;
+    scanCached   = false;
+    scanChanged  = false;
+    scanWatch    = -1;
+    useCount     = 0;
+#if defined( __linux__ )
+    notifyHandle = inotify_init1( IN_NONBLOCK | IN_CLOEXEC );
+#else
+    notifyHandle = -1;
+#endif
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Destructor for the DirectoryScanner class, stops the scanner
+
+  --------------------------------------------------------------------------*/
+DirectoryScanner::~DirectoryScanner()
+{
+    cancel();
+    clearCache();
+#if defined( __linux__ )
+    if ( notifyHandle >= 0 )
+    {
+        ::close( notifyHandle );
+    }
+#endif
+}
+
+// Scanning -------------------------------------------------------------------
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Starts reading a directory, any scan in progress is stopped.
+                The entries are collected with poll().
+    @param      path    directory to read
+    @return     void
+  --------------------------------------------------------------------------*/
+void DirectoryScanner::scan( const std::string& path )
+{
+    cancel();
+
+    scanPath    = getKey( path );
+    scanning    = true;
+    scanChanged = false;
+    scanFailed  = false;
+    scanCached  = isCached( scanPath );
+    if ( scanCached )
+    {
+        return;
+    }
+
+    // the watch is added first, so a change while reading is seen
+    scanWatch    = addWatch( scanPath );
+    stopScanning = false;
+    scanComplete = false;
+    scanner      = std::thread( &DirectoryScanner::scanDirectory, this, scanPath );
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Adds the entries read since the last poll to a list
+    @param      entries     list the entries are added to
+    @return     bool        true if entries were added
+  --------------------------------------------------------------------------*/
+bool DirectoryScanner::poll( std::vector<DirectoryEntry>& entries )
+{
+    bool changed = false;
+
+    if ( scanning && scanCached )
+    {
+        auto found = cache.find( scanPath );
+        if ( found == cache.end() )
+        {
+            // dropped since the scan was started, read it after all
+            scan( scanPath );
+            return false;
+        }
+        found->second.lastUsed = ++useCount;
+        entries.insert( entries.end(), found->second.entries.begin(), found->second.entries.end() );
+        scanning = false;
+        return found->second.entries.empty() == false;
+    }
+
+    while ( scanning )
+    {
+        // read before the pop, an empty queue after the last batch is the end
+        bool complete = scanComplete.load( std::memory_order_acquire );
+        if ( batches.pop( batch ) == false )
+        {
+            if ( complete )
+            {
+                finishScan();
+            }
+            break;
+        }
+        entries.insert( entries.end(), batch.begin(), batch.end() );
+        listing.insert( listing.end(), std::make_move_iterator( batch.begin() ), std::make_move_iterator( batch.end() ) );
+        changed = true;
+    }
+    return changed;
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Stops the scan in progress, the entries read are not cached
+    @return     void
+  --------------------------------------------------------------------------*/
+void DirectoryScanner::cancel()
+{
+    stopScanning = true;
+    if ( scanner.joinable() )
+    {
+        scanner.join();
+    }
+    while ( batches.pop( batch ) )
+    {
+    }
+    removeWatch( scanWatch );
+    scanWatch  = -1;
+    scanning   = false;
+    scanCached = false;
+    listing.clear();
+    batch.clear();
+}
+
+// Cache ----------------------------------------------------------------------
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Checks if a directory's listing is cached and still current,
+                a listing found to be out of date is dropped
+    @param      path    directory
+    @return     bool    true if reading the directory will be instant
+  --------------------------------------------------------------------------*/
+bool DirectoryScanner::isCached( const std::string& path )
+{
+    processNotifications();
+
+    auto found = cache.find( getKey( path ) );
+    if ( found == cache.end() )
+    {
+        return false;
+    }
+    if ( found->second.watch < 0 )
+    {
+        std::error_code                 error;
+        std::filesystem::file_time_type writeTime = std::filesystem::last_write_time( found->first, error );
+        if ( error || writeTime != found->second.writeTime )
+        {
+            removeListing( found );
+            return false;
+        }
+    }
+    return true;
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Drops every cached listing
+    @return     void
+  --------------------------------------------------------------------------*/
+void DirectoryScanner::clearCache()
+{
+    while ( cache.empty() == false )
+    {
+        removeListing( cache.begin() );
+    }
+}
+
+// Getters --------------------------------------------------------------------
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Checks if entries of the scan are still to be polled
+    @return     bool    true until the last entry has been polled
+  --------------------------------------------------------------------------*/
+bool DirectoryScanner::isScanning() const
+{
+    return scanning;
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Checks if the last scan could not read its directory
+    @return     bool    true if the directory was not read to the end
+  --------------------------------------------------------------------------*/
+bool DirectoryScanner::hasFailed() const
+{
+    return scanFailed;
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Returns the directory of the last scan
+    @return     const std::string&  absolute path of the directory
+  --------------------------------------------------------------------------*/
+const std::string& DirectoryScanner::getPath() const
+{
+    return scanPath;
+}
+
+// Private Functions ----------------------------------------------------------
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Makes the cache key of a directory, its absolute path made
+                without touching the file system
+    @param      path    directory
+    @return     std::string     key
+  --------------------------------------------------------------------------*/
+std::string DirectoryScanner::getKey( const std::string& path ) const
+{
+    std::error_code       error;
+    std::filesystem::path absolute = std::filesystem::absolute( path.empty() ? "." : path, error );
+    std::string           key      = ( error ? std::filesystem::path( path ) : absolute ).lexically_normal().string();
+
+    // "/tmp/" and "/tmp" are the same directory, the root keeps its separator
+    if ( key.size() > 1 && ( key.back() == '/' || key.back() == '\\' ) && key[key.size() - 2] != ':' )
+    {
+        key.pop_back();
+    }
+    return key;
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Scanner thread, reads the directory and queues its entries
+    @param      path    directory to read
+    @return     void
+  --------------------------------------------------------------------------*/
+void DirectoryScanner::scanDirectory( std::string path )
+{
+    std::vector<DirectoryEntry> entries;
+
+#if defined( __linux__ )
+    int directory = ::open( path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC );
+    if ( directory < 0 )
+    {
+        scanFailed = true;
+    }
+    else
+    {
+        std::vector<char> buffer( READ_BUFFER );
+        while ( stopScanning == false )
+        {
+            long bytes = syscall( SYS_getdents64, directory, buffer.data(), buffer.size() );
+            if ( bytes <= 0 )
+            {
+                scanFailed = ( bytes < 0 );
+                break;
+            }
+            for ( long offset = 0; offset < bytes; )
+            {
+                const LinuxDirent64* entry = (const LinuxDirent64*)( buffer.data() + offset );
+                const char*          name  = entry->d_name;
+                offset += entry->d_reclen;
+                if ( name[0] == '.' && ( name[1] == '\0' || ( name[1] == '.' && name[2] == '\0' ) ) )
+                {
+                    continue;
+                }
+
+                // only an entry of unknown type, or a link, needs a stat
+                bool isDirectory = ( entry->d_type == DT_DIR );
+                if ( entry->d_type == DT_UNKNOWN || entry->d_type == DT_LNK )
+                {
+                    struct stat info;
+                    isDirectory = fstatat( directory, name, &info, 0 ) == 0 && S_ISDIR( info.st_mode );
+                }
+                entries.push_back( { name, isDirectory } );
+                if ( entries.size() >= SCAN_BATCH && queueBatch( std::move( entries ) ) == false )
+                {
+                    break;
+                }
+            }
+
+            // what one read returned is passed on at once, a slow mount is shown as it arrives
+            if ( entries.empty() == false && queueBatch( std::move( entries ) ) == false )
+            {
+                break;
+            }
+        }
+        ::close( directory );
+    }
+#else
+    std::error_code error;
+    for ( std::filesystem::directory_iterator entry( path, error ), end; error == false && entry != end && stopScanning == false; entry.increment( error ) )
+    {
+        std::error_code typeError;
+        entries.push_back( { entry->path().filename().string(), entry->is_directory( typeError ) } );
+        if ( entries.size() >= SCAN_BATCH && queueBatch( std::move( entries ) ) == false )
+        {
+            break;
+        }
+    }
+    scanFailed = (bool)error;
+    if ( entries.empty() == false )
+    {
+        queueBatch( std::move( entries ) );
+    }
+#endif
+    scanComplete.store( true, std::memory_order_release );
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Queues a batch of entries, waiting while the queue is full
+    @param      entries     entries, left empty
+    @return     bool        false if asked to stop while waiting
+  --------------------------------------------------------------------------*/
+bool DirectoryScanner::queueBatch( std::vector<DirectoryEntry>&& entries )
+{
+    while ( batches.push( std::move( entries ) ) == false )
+    {
+        if ( stopScanning )
+        {
+            return false;
+        }
+        std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+    }
+    entries.clear();
+    entries.reserve( SCAN_BATCH );
+    return true;
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Ends a scan once its last entry has been polled, caching the
+                listing if the directory was read whole and did not change
+    @return     void
+  --------------------------------------------------------------------------*/
+void DirectoryScanner::finishScan()
+{
+    scanner.join();
+    scanning = false;
+    processNotifications();
+
+    if ( scanFailed )
+    {
+        ErrorHandler::getInstance().handleError( ErrorType::Error, LibraryError::DirectoryScanner_FailedToReadDirectory, "DirectoryScanner::poll() : failed to read " + scanPath );
+    }
+    if ( scanFailed || scanChanged )
+    {
+        removeWatch( scanWatch );
+        scanWatch = -1;
+        listing.clear();
+        return;
+    }
+
+    // the least recently used listing makes way
+    if ( cache.size() >= CACHED_PATHS )
+    {
+        auto oldest = cache.begin();
+        for ( auto found = cache.begin(); found != cache.end(); found++ )
+        {
+            if ( found->second.lastUsed < oldest->second.lastUsed )
+            {
+                oldest = found;
+            }
+        }
+        removeListing( oldest );
+    }
+
+    std::error_code error;
+    CachedListing&  cached = cache[scanPath];
+    cached.entries.swap( listing );
+    cached.writeTime = std::filesystem::last_write_time( scanPath, error );
+    cached.watch     = scanWatch;
+    cached.lastUsed  = ++useCount;
+    scanWatch        = -1;
+    listing.clear();
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Reads the inotify events waiting, dropping the listings of
+                directories that changed
+    @return     void
+  --------------------------------------------------------------------------*/
+void DirectoryScanner::processNotifications()
+{
+#if defined( __linux__ )
+    alignas( struct inotify_event ) char buffer[4096];
+    ssize_t                              bytes;
+
+    while ( notifyHandle >= 0 && ( bytes = read( notifyHandle, buffer, sizeof( buffer ) ) ) > 0 )
+    {
+        for ( ssize_t offset = 0; offset < bytes; )
+        {
+            const struct inotify_event* event = (const struct inotify_event*)( buffer + offset );
+            offset += sizeof( struct inotify_event ) + event->len;
+            if ( event->mask & IN_Q_OVERFLOW )
+            {
+                // events were lost, nothing cached can be trusted
+                scanChanged = true;
+                clearCache();
+                continue;
+            }
+            if ( event->wd == scanWatch )
+            {
+                scanChanged = true;
+            }
+            for ( auto found = cache.begin(); found != cache.end(); found++ )
+            {
+                if ( found->second.watch == event->wd )
+                {
+                    removeListing( found );
+                    break;
+                }
+            }
+        }
+    }
+#endif
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Watches a directory for changes to its entries
+    @param      path    directory
+    @return     int     watch, -1 if it could not be watched
+  --------------------------------------------------------------------------*/
+int DirectoryScanner::addWatch( const std::string& path )
+{
+#if defined( __linux__ )
+    if ( notifyHandle >= 0 )
+    {
+        return inotify_add_watch( notifyHandle, path.c_str(), WATCH_EVENTS );
+    }
+#endif
+    return -1;
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Stops watching a directory, unless a cached listing or the
+                scan still uses the watch
+    @param      watch   watch, nothing is done for -1
+    @return     void
+  --------------------------------------------------------------------------*/
+void DirectoryScanner::removeWatch( int watch )
+{
+#if defined( __linux__ )
+    if ( notifyHandle < 0 || watch < 0 )
+    {
+        return;
+    }
+    for ( auto& found : cache )
+    {
+        if ( found.second.watch == watch )
+        {
+            return;
+        }
+    }
+    inotify_rm_watch( notifyHandle, watch );
+#endif
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Drops a cached listing and its watch. Two paths to the same
+                directory share a watch, the listings of both are dropped.
+    @param      found   listing
+    @return     void
+  --------------------------------------------------------------------------*/
+void DirectoryScanner::removeListing( std::map<std::string, CachedListing>::iterator found )
+{
+    int watch = found->second.watch;
+
+    cache.erase( found );
+    if ( watch >= 0 )
+    {
+        for ( auto other = cache.begin(); other != cache.end(); )
+        {
+            other = ( other->second.watch == watch ) ? cache.erase( other ) : std::next( other );
+        }
+        if ( watch != scanWatch )
+        {
+            removeWatch( watch );
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: DirectoryScanner.cpp
+//-----------------------------------------------------------------------------
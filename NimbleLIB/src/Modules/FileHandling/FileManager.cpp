@@ -7,12 +7,34 @@
 
 Notes:
 
+    The File Manager holds the buffers of every open file other than the
+    one being edited. The editor hands its document, undo journal and
+    cursor over with storeBuffer() when it switches away from a file, and
+    takes them back with restoreBuffer(). Both are moved, not copied, so
+    switching between resident files costs nothing however large they are.
+
+    Stored buffers are kept under a memory budget. When they go over it
+    the least recently used buffers are compressed first, the text is
+    flattened and packed with the Compressor, and only if that is not
+    enough are buffers that match their file on disk dropped. A dropped
+    buffer is read from disk again when it is next restored, a buffer with
+    unsaved edits is never dropped. The undo journal is kept in every
+    state, its offsets are still valid once the text is unpacked or read
+    again, unless the file has been changed on disk since it was read.
+
+    A file is changed on disk if its size or write time differ from when
+    it was last read or saved, see setFileSynced(). An unmodified buffer is
+    not restored if its file has changed, it is read from disk instead.
+
 -----------------------------------------------------------------------------*/
 //-----------------------------------------------------------------------------
 // Includes
 //-----------------------------------------------------------------------------
 
 #include "../../../inc/Modules/FileHandling/FileManager.h"
+#include "../../../inc/Modules/Utilities/Compressor.h"
+#include "../../../inc/Modules/Utilities/Profiler.h"
+#include <algorithm>
 
 //-----------------------------------------------------------------------------
 // Namesapce
@@ -34,8 +56,11 @@ namespace Nimble
   --------------------------------------------------------------------------*/
 FileManager::FileManager()
 {
-    fileCount  = 0;
-    nextFileID = 0;
+    fileCount    = 0;
+    nextFileID   = 0;
+    memoryBudget = DEFAULT_MEMORY_BUDGET;
+    memoryUsed   = 0;
+    useCount     = 0;
     fileList.clear();
 }
 
@@ -48,6 +73,510 @@ FileManager::~FileManager()
 {
 }
 
+// File Handling --------------------------------------------------------------
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Adds a file to the manager, its buffer is read when it is
+                first restored
+    @param      fileName    file to open
+    @return     uint32_t    file ID, the existing ID if already open, NO_FILE
+                            if the file can not be found
+  --------------------------------------------------------------------------*/
+uint32_t FileManager::openFile( const std::string& fileName )
+{
+    uint32_t fileID = findFile( fileName );
+
+    if ( fileID == NO_FILE )
+    {
+        std::error_code fileError;
+        if ( std::filesystem::is_regular_file( fileName, fileError ) == false )
+        {
+            ErrorHandler::getInstance().handleError( ErrorType::Error, LibraryError::FileManager_FailedToOpenFile, "FileManager::openFile() : " + fileName );
+            return NO_FILE;
+        }
+
+        // reuse an idle entry if there is one
+        auto file = std::find_if( fileList.begin(), fileList.end(), []( const TS_FILE_DATA& entry ) { return entry.fileState == IDLE; } );
+        if ( file == fileList.end() )
+        {
+            file = fileList.emplace( fileList.end() );
+        }
+        file->fileName        = fileName;
+        file->fileState       = DROPPED;
+        file->cursor          = { 0, 0, 0, 0 };
+        file->lastUsed        = useCount;
+        file->memoryUsed      = 0;
+        file->fileID          = nextFileID++;
+        file->modified        = false;
+        file->trailingNewline = false;
+        file->crlf            = false;
+        file->journal.clear();
+        fileID = file->fileID;
+        setFileSynced( fileID );
+        fileCount++;
+    }
+    return fileID;
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Removes a file from the manager, any buffer held is freed
+    @param      fileID  file to close
+    @return     bool    false if the file is not open
+  --------------------------------------------------------------------------*/
+bool FileManager::closeFile( uint32_t fileID )
+{
+    PTS_FILE_DATA file = getFile( fileID );
+
+    if ( file == nullptr )
+    {
+        return false;
+    }
+    setMemoryUsed( *file, 0 );
+    file->document  = IDEPieceTable();
+    file->journal   = IDEUndoJournal();
+    file->packedText.clear();
+    file->packedText.shrink_to_fit();
+    file->fileName.clear();
+    file->fileState = IDLE;
+    fileCount--;
+    return true;
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Records the file on disk as matching the buffer, called
+                once the file has been read or saved
+    @param      fileID  file read or saved
+    @return     void
+  --------------------------------------------------------------------------*/
+void FileManager::setFileSynced( uint32_t fileID )
+{
+    PTS_FILE_DATA   file = getFile( fileID );
+    std::error_code fileError;
+
+    if ( file != nullptr )
+    {
+        file->fileSize = std::filesystem::file_size( file->fileName, fileError );
+        file->fileTime = std::filesystem::last_write_time( file->fileName, fileError );
+        if ( fileError )
+        {
+            file->fileSize = 0;
+            file->fileTime = std::filesystem::file_time_type();
+        }
+    }
+}
+
+// Buffer Handling ------------------------------------------------------------
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Takes the buffer of a file the editor is switching away from,
+                the document and journal are moved and left empty
+    @param      fileID      file the buffer belongs to
+    @param      document    buffer text
+    @param      journal     buffer undo journal
+    @param      cursor      cursor in the buffer
+    @param      modified    true if the buffer differs from the file
+    @return     LibraryError    error code
+  --------------------------------------------------------------------------*/
+LibraryError FileManager::storeBuffer( uint32_t fileID, IDEPieceTable& document, IDEUndoJournal& journal, const IDEUndoJournal::CursorState& cursor, bool modified )
+{
+    PTS_FILE_DATA file = getFile( fileID );
+
+    if ( file == nullptr )
+    {
+        ErrorHandler::getInstance().handleError( ErrorType::Error, LibraryError::FileManager_FileNotOpen, "FileManager::storeBuffer() : no file " + std::to_string( fileID ) );
+        return LibraryError::FileManager_FileNotOpen;
+    }
+
+    file->document = std::move( document );
+    file->journal  = std::move( journal );
+    file->packedText.clear();
+    file->cursor    = cursor;
+    file->modified  = modified;
+    file->fileState = READ;
+    file->lastUsed  = ++useCount;
+    document.clear();
+    journal.clear();
+    setMemoryUsed( *file, file->document.getMemoryUsed() + file->journal.getBytesUsed() );
+    trimToBudget();
+    return LibraryError::No_Error;
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Hands the buffer of a file to the editor switching to it. The
+                journal and cursor are always handed back, the document only
+                if it is still held and the file has not changed under it
+    @param      fileID      file to restore
+    @param      document    set to the buffer text
+    @param      journal     set to the buffer undo journal
+    @param      cursor      set to the cursor in the buffer
+    @param      modified    set true if the buffer differs from the file
+    @return     bool    false if the file has to be read from disk
+  --------------------------------------------------------------------------*/
+bool FileManager::restoreBuffer( uint32_t fileID, IDEPieceTable& document, IDEUndoJournal& journal, IDEUndoJournal::CursorState& cursor, bool& modified )
+{
+    PROFILE_ZONE( "FileManager::restoreBuffer" );
+
+    PTS_FILE_DATA file     = getFile( fileID );
+    bool          restored = false;
+
+    if ( file == nullptr || file->fileState == OPENED )
+    {
+        return false;
+    }
+
+    // an unmodified buffer is read again if the file has been changed
+    if ( file->modified == false && fileChanged( *file ) )
+    {
+        dropBuffer( *file );
+        file->journal.clear();
+        file->cursor = { 0, 0, 0, 0 };
+    }
+
+    if ( file->fileState == READ )
+    {
+        document = std::move( file->document );
+        file->document.clear();
+        restored = true;
+    }
+    else if ( file->fileState == COMPRESSED )
+    {
+        std::string text;
+        restored = Compressor::decompress( file->packedText, text );
+        if ( restored )
+        {
+            // inserted rather than loaded, a final newline in the text is an empty last line
+            document.clear();
+            document.insertAt( 0, text );
+            document.setTrailingNewline( file->trailingNewline );
+            document.setCrlf( file->crlf );
+        }
+        else
+        {
+            ErrorHandler::getInstance().handleError( ErrorType::Error, LibraryError::FileManager_FailedToOpenFile, "FileManager::restoreBuffer() : buffer lost " + file->fileName );
+            file->journal.clear();
+            file->cursor = { 0, 0, 0, 0 };
+        }
+        file->packedText.clear();
+        file->packedText.shrink_to_fit();
+    }
+
+    journal         = std::move( file->journal );
+    cursor          = file->cursor;
+    modified        = restored && file->modified;
+    file->fileState = OPENED;
+    file->lastUsed  = ++useCount;
+    file->journal.clear();
+    setMemoryUsed( *file, 0 );
+    return restored;
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Gives up the buffer of a file the editor is switching away
+                from without storing it, for buffers that are views of the
+                file rather than copies. It is read from disk when restored
+    @param      fileID  file the buffer belongs to
+    @return     bool    false if the file is not open
+  --------------------------------------------------------------------------*/
+bool FileManager::releaseBuffer( uint32_t fileID )
+{
+    PTS_FILE_DATA file = getFile( fileID );
+
+    if ( file == nullptr )
+    {
+        return false;
+    }
+    file->journal.clear();
+    file->cursor   = { 0, 0, 0, 0 };
+    file->modified = false;
+    file->lastUsed = ++useCount;
+    dropBuffer( *file );
+    return true;
+}
+
+// Getters --------------------------------------------------------------------
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Finds an open file by name
+    @param      fileName    file to find
+    @return     uint32_t    file ID, NO_FILE if not open
+  --------------------------------------------------------------------------*/
+uint32_t FileManager::findFile( const std::string& fileName ) const
+{
+    for ( const TS_FILE_DATA& file : fileList )
+    {
+        if ( file.fileState != IDLE && file.fileName == fileName )
+        {
+            return file.fileID;
+        }
+    }
+    return NO_FILE;
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Gets the file opened after or before a file, wrapping round
+    @param      fileID  file to start from
+    @param      forward true for the next file, false for the previous
+    @return     uint32_t    file ID, NO_FILE if no files are open
+  --------------------------------------------------------------------------*/
+uint32_t FileManager::getNextFileID( uint32_t fileID, bool forward ) const
+{
+    uint32_t next = NO_FILE;
+    uint32_t wrap = NO_FILE;
+
+    // IDs are handed out in order, so the nearest ID past this one is next
+    for ( const TS_FILE_DATA& file : fileList )
+    {
+        if ( file.fileState == IDLE )
+        {
+            continue;
+        }
+        bool past   = forward ? file.fileID > fileID : file.fileID < fileID;
+        bool nearer = next == NO_FILE || ( forward ? file.fileID < next : file.fileID > next );
+        bool outer  = wrap == NO_FILE || ( forward ? file.fileID < wrap : file.fileID > wrap );
+        if ( past && nearer )
+        {
+            next = file.fileID;
+        }
+        if ( outer )
+        {
+            wrap = file.fileID;
+        }
+    }
+    return next != NO_FILE ? next : wrap;
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Gets the number of files open
+    @return     uint32_t    files open
+  --------------------------------------------------------------------------*/
+uint32_t FileManager::getFileCount() const
+{
+    return fileCount;
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Gets the state of a file's buffer
+    @param      fileID  file to check
+    @return     TE_FILE_STATE   buffer state, IDLE if the file is not open
+  --------------------------------------------------------------------------*/
+TE_FILE_STATE FileManager::getFileState( uint32_t fileID ) const
+{
+    const TS_FILE_DATA* file = getFile( fileID );
+    return file != nullptr ? file->fileState : IDLE;
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Gets the name of a file
+    @param      fileID  file to check
+    @return     const std::string&  file name, empty if the file is not open
+  --------------------------------------------------------------------------*/
+const std::string& FileManager::getFileName( uint32_t fileID ) const
+{
+    static const std::string noName;
+    const TS_FILE_DATA*      file = getFile( fileID );
+    return file != nullptr ? file->fileName : noName;
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Checks if a stored buffer has unsaved edits
+    @param      fileID  file to check
+    @return     bool    true if the buffer differs from the file
+  --------------------------------------------------------------------------*/
+bool FileManager::isModified( uint32_t fileID ) const
+{
+    const TS_FILE_DATA* file = getFile( fileID );
+    return file != nullptr && file->modified;
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Gets the bytes held by the stored buffers
+    @return     uint64_t    bytes held
+  --------------------------------------------------------------------------*/
+uint64_t FileManager::getMemoryUsed() const
+{
+    return memoryUsed;
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Gets the bytes the stored buffers may hold
+    @return     uint64_t    memory budget
+  --------------------------------------------------------------------------*/
+uint64_t FileManager::getMemoryBudget() const
+{
+    return memoryBudget;
+}
+
+// Setters --------------------------------------------------------------------
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Sets the bytes the stored buffers may hold, buffers are
+                compressed or dropped at once if they are over it
+    @param      budget  memory budget
+    @return     void
+  --------------------------------------------------------------------------*/
+void FileManager::setMemoryBudget( uint64_t budget )
+{
+    memoryBudget = budget;
+    trimToBudget();
+}
+
+// Private Methods ------------------------------------------------------------
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Gets the entry of an open file
+    @param      fileID  file to find
+    @return     PTS_FILE_DATA   entry, nullptr if not open
+  --------------------------------------------------------------------------*/
+PTS_FILE_DATA FileManager::getFile( uint32_t fileID )
+{
+    return const_cast<PTS_FILE_DATA>( static_cast<const FileManager*>( this )->getFile( fileID ) );
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Gets the entry of an open file
+    @param      fileID  file to find
+    @return     const TS_FILE_DATA*     entry, nullptr if not open
+  --------------------------------------------------------------------------*/
+const TS_FILE_DATA* FileManager::getFile( uint32_t fileID ) const
+{
+    for ( const TS_FILE_DATA& file : fileList )
+    {
+        if ( file.fileState != IDLE && file.fileID == fileID )
+        {
+            return &file;
+        }
+    }
+    return nullptr;
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Checks if a file has changed on disk since it was last read
+                or saved
+    @param      file    entry to check
+    @return     bool    true if the size or write time differ
+  --------------------------------------------------------------------------*/
+bool FileManager::fileChanged( const TS_FILE_DATA& file ) const
+{
+    std::error_code fileError;
+    uint64_t        fileSize = std::filesystem::file_size( file.fileName, fileError );
+    auto            fileTime = std::filesystem::last_write_time( file.fileName, fileError );
+    return fileError || fileSize != file.fileSize || fileTime != file.fileTime;
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Packs a stored buffer, its pieces are flattened into the text
+    @param      file    entry to compress, must be READ
+    @return     void
+  --------------------------------------------------------------------------*/
+void FileManager::compressBuffer( TS_FILE_DATA& file )
+{
+    PROFILE_ZONE( "FileManager::compressBuffer" );
+
+    Compressor::compress( file.document.getText(), file.packedText );
+    file.packedText.shrink_to_fit();
+    file.trailingNewline = file.document.hasTrailingNewline();
+    file.crlf            = file.document.usesCrlf();
+    file.document        = IDEPieceTable();
+    file.fileState       = COMPRESSED;
+    setMemoryUsed( file, file.packedText.capacity() + file.journal.getBytesUsed() );
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Frees a stored buffer, it is read from disk when restored
+    @param      file    entry to drop, must not be modified
+    @return     void
+  --------------------------------------------------------------------------*/
+void FileManager::dropBuffer( TS_FILE_DATA& file )
+{
+    file.document = IDEPieceTable();
+    file.packedText.clear();
+    file.packedText.shrink_to_fit();
+    file.fileState = DROPPED;
+    setMemoryUsed( file, file.journal.getBytesUsed() );
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Sets the bytes held for a buffer, keeping the total
+    @param      file    entry
+    @param      bytes   bytes now held for it
+    @return     void
+  --------------------------------------------------------------------------*/
+void FileManager::setMemoryUsed( TS_FILE_DATA& file, uint64_t bytes )
+{
+    memoryUsed -= file.memoryUsed;
+    memoryUsed += bytes;
+    file.memoryUsed = bytes;
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Compresses, then drops, the least recently used buffers until
+                the stored buffers are within the memory budget
+    @return     void
+  --------------------------------------------------------------------------*/
+void FileManager::trimToBudget()
+{
+    if ( memoryUsed <= memoryBudget )
+    {
+        return;
+    }
+
+    std::vector<PTS_FILE_DATA> stored;
+    for ( TS_FILE_DATA& file : fileList )
+    {
+        if ( file.fileState == READ || file.fileState == COMPRESSED )
+        {
+            stored.push_back( &file );
+        }
+    }
+    std::sort( stored.begin(), stored.end(), []( PTS_FILE_DATA a, PTS_FILE_DATA b ) { return a->lastUsed < b->lastUsed; } );
+
+    // packing keeps the buffer, so it goes first, oldest first
+    for ( PTS_FILE_DATA file : stored )
+    {
+        if ( memoryUsed <= memoryBudget )
+        {
+            return;
+        }
+        if ( file->fileState == READ )
+        {
+            compressBuffer( *file );
+        }
+    }
+    for ( PTS_FILE_DATA file : stored )
+    {
+        if ( memoryUsed <= memoryBudget )
+        {
+            return;
+        }
+        if ( file->modified == false )
+        {
+            dropBuffer( *file );
+        }
+    }
+}
+
 //-----------------------------------------------------------------------------
 
 } // namespace Nimble
@@ -0,0 +1,500 @@
+/**----------------------------------------------------------------------------
+
+    @file       MappedFile.cpp
+    @defgroup   NimbleLIBFile Nimble Library File Module
+    @brief      Read only memory mapped file
+    @copyright  Neil Bereford 2023
+
+Notes:
+
+    The file and mapping handles are closed as soon as the view is mapped,
+    the view itself keeps the file referenced until it is unmapped.
+    A zero length file is valid, it is open but has no data.
+
+    On POSIX another process may truncate the file while it is mapped, the
+    pages past the new end then raise SIGBUS when read. Each mapping is
+    entered in a table the SIGBUS handler looks up, a fault inside one has
+    the rest of the mapping replaced with zeroed pages and the mapping
+    marked truncated, so the read carries on with zeros rather than ending
+    the program, isTruncated() reports it to the owner. Faults outside the
+    table are passed to the handler installed before. Windows refuses to
+    truncate a file with a view mapped, so needs no handler.
+
+    The inode (file index on Windows), last write time and size are kept
+    from open(), isChangedOnDisk() compares them with the file now, so a
+    file replaced by a save or written by another program is noticed.
+
+    When every table entry is taken the file is not mapped at all, it is
+    read into a private copy instead, an unguarded mapping would end the
+    program on truncation. The copy costs memory the size of the file, so
+    the table is sized well past the files the IDE keeps open at once.
+
+-----------------------------------------------------------------------------*/
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include "../../../inc/Modules/FileHandling/MappedFile.h"
+
+#if defined( _WIN32 )
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <mutex>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//-----------------------------------------------------------------------------
+// Namesapce
+//-----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+#if !defined( _WIN32 )
+
+//-----------------------------------------------------------------------------
+// Local types and data
+//-----------------------------------------------------------------------------
+
+static const uint32_t MAX_MAPPINGS = 64; //!< mappings guarded against truncation at once
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      A mapping the SIGBUS handler may repair, start is zero when
+                the entry is free
+  --------------------------------------------------------------------------*/
+struct MappedRange
+{
+    std::atomic<uintptr_t> start;     //!< first byte of the mapping
+    std::atomic<uint64_t>  size;      //!< bytes mapped
+    std::atomic<bool>      truncated; //!< a page past the end of file was read
+};
+
+static MappedRange      g_mappedRanges[MAX_MAPPINGS]; //!< mappings open
+static struct sigaction g_previousBusAction;          //!< SIGBUS handler installed before ours
+static std::once_flag   g_busHandlerInstalled;        //!< handler installed once
+
+//-----------------------------------------------------------------------------
+// Local functions
+//-----------------------------------------------------------------------------
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      SIGBUS handler, a read past the end of a truncated mapping
+                has the rest of the mapping replaced with zeroed pages
+    @param      signal      signal number
+    @param      info        faulting address
+    @param      context     passed on to the previous handler
+    @return     void
+  --------------------------------------------------------------------------*/
+static void onBusError( int signal, siginfo_t* info, void* context )
+{
+    uintptr_t address = (uintptr_t)info->si_addr;
+
+    for ( MappedRange& range : g_mappedRanges )
+    {
+        uintptr_t start = range.start.load();
+        uint64_t  size  = range.size.load();
+        if ( start != 0 && address >= start && address - start < size )
+        {
+            uintptr_t page = address & ~(uintptr_t)( sysconf( _SC_PAGESIZE ) - 1 );
+            if ( mmap( (void*)page, (size_t)( start + size - page ), PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0 ) != MAP_FAILED )
+            {
+                range.truncated.store( true );
+                return;
+            }
+        }
+    }
+
+    // not ours, handled as it would have been without us
+    if ( g_previousBusAction.sa_flags & SA_SIGINFO )
+    {
+        g_previousBusAction.sa_sigaction( signal, info, context );
+    }
+    else if ( g_previousBusAction.sa_handler != SIG_DFL && g_previousBusAction.sa_handler != SIG_IGN )
+    {
+        g_previousBusAction.sa_handler( signal );
+    }
+    else
+    {
+        ::signal( SIGBUS, SIG_DFL );
+        raise( SIGBUS );
+    }
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Installs the SIGBUS handler, the first time a file is mapped
+    @return     void
+  --------------------------------------------------------------------------*/
+static void installBusHandler()
+{
+    std::call_once( g_busHandlerInstalled,
+                    []()
+                    {
+                        struct sigaction action = {};
+                        action.sa_sigaction     = onBusError;
+                        action.sa_flags         = SA_SIGINFO;
+                        sigemptyset( &action.sa_mask );
+                        sigaction( SIGBUS, &action, &g_previousBusAction );
+                    } );
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Enters a mapping in the table guarded by the handler
+    @param      data        start of the mapping
+    @param      size        bytes mapped
+    @return     MappedRange*    entry, nullptr if the table is full
+  --------------------------------------------------------------------------*/
+static MappedRange* addMappedRange( const char* data, uint64_t size )
+{
+    installBusHandler();
+    for ( MappedRange& range : g_mappedRanges )
+    {
+        uintptr_t free = 0;
+        if ( range.start.compare_exchange_strong( free, (uintptr_t)data ) )
+        {
+            // nothing can fault in the mapping until open() returns it
+            range.size.store( size );
+            range.truncated.store( false );
+            return &range;
+        }
+    }
+    return nullptr;
+}
+
+#endif
+
+//-----------------------------------------------------------------------------
+// Class Support Functions
+//-----------------------------------------------------------------------------
+
+// Constructors and Destructors -----------------------------------------------
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Constructor for the MappedFile class
+
+  --------------------------------------------------------------------------*/
+MappedFile::MappedFile()
+{
+    fileData  = nullptr;
+    fileSize  = 0;
+    fileOpen  = false;
+    fileRange = nullptr;
+    fileIndex = 0;
+    fileTime  = 0;
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Destructor for the MappedFile class, unmaps the file
+
+  --------------------------------------------------------------------------*/
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+// File Handling --------------------------------------------------------------
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Maps the file read only, any previous mapping is released
+    @param      fileName    file to map
+    @return     LibraryError    error code
+  --------------------------------------------------------------------------*/
+LibraryError MappedFile::open( const std::string& fileName )
+{
+    LibraryError error = LibraryError::No_Error;
+
+    close();
+
+#if defined( _WIN32 )
+    HANDLE file = CreateFileA( fileName.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+    if ( file == INVALID_HANDLE_VALUE )
+    {
+        error = LibraryError::MappedFile_FailedToOpenFile;
+    }
+    else
+    {
+        LARGE_INTEGER              size;
+        BY_HANDLE_FILE_INFORMATION info;
+        if ( GetFileSizeEx( file, &size ) == FALSE || GetFileInformationByHandle( file, &info ) == FALSE )
+        {
+            error = LibraryError::MappedFile_FailedToOpenFile;
+        }
+        else if ( size.QuadPart > 0 )
+        {
+            HANDLE mapping = CreateFileMappingA( file, nullptr, PAGE_READONLY, 0, 0, nullptr );
+            if ( mapping == nullptr )
+            {
+                error = LibraryError::MappedFile_FailedToMapFile;
+            }
+            else
+            {
+                fileData = (const char*)MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+                if ( fileData == nullptr )
+                {
+                    error = LibraryError::MappedFile_FailedToMapFile;
+                }
+                CloseHandle( mapping );
+            }
+        }
+        if ( error == LibraryError::No_Error )
+        {
+            fileSize  = (uint64_t)size.QuadPart;
+            fileIndex = ( (uint64_t)info.nFileIndexHigh << 32 ) | info.nFileIndexLow;
+            fileTime  = ( (uint64_t)info.ftLastWriteTime.dwHighDateTime << 32 ) | info.ftLastWriteTime.dwLowDateTime;
+        }
+        CloseHandle( file );
+    }
+#else
+    int file = ::open( fileName.c_str(), O_RDONLY );
+    if ( file < 0 )
+    {
+        error = LibraryError::MappedFile_FailedToOpenFile;
+    }
+    else
+    {
+        struct stat info;
+        if ( fstat( file, &info ) != 0 )
+        {
+            error = LibraryError::MappedFile_FailedToOpenFile;
+        }
+        else
+        {
+            fileIndex = (uint64_t)info.st_ino;
+            fileTime  = (uint64_t)info.st_mtim.tv_sec * 1000000000 + (uint64_t)info.st_mtim.tv_nsec;
+        }
+        if ( error == LibraryError::No_Error && info.st_size > 0 )
+        {
+            void* mapping = mmap( nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, file, 0 );
+            if ( mapping == MAP_FAILED )
+            {
+                error = LibraryError::MappedFile_FailedToMapFile;
+            }
+            else
+            {
+                fileData  = (const char*)mapping;
+                fileSize  = (uint64_t)info.st_size;
+                fileRange = addMappedRange( fileData, fileSize );
+                if ( fileRange == nullptr )
+                {
+                    // no guard entry free, a copy cannot fault when the file is cut short
+                    munmap( mapping, (size_t)fileSize );
+                    fileData = nullptr;
+                    fileSize = 0;
+                    error    = readCopy( file, (uint64_t)info.st_size );
+                }
+            }
+        }
+        ::close( file );
+    }
+#endif
+
+    if ( error == LibraryError::No_Error )
+    {
+        this->fileName = fileName;
+        fileOpen       = true;
+    }
+    else
+    {
+        ErrorHandler::getInstance().handleError( ErrorType::Error, error, "MappedFile::open() : failed to map " + fileName );
+    }
+    return error;
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Releases the mapping, all pointers into it become invalid
+    @return     void
+  --------------------------------------------------------------------------*/
+void MappedFile::close()
+{
+    if ( fileData != nullptr )
+    {
+#if defined( _WIN32 )
+        UnmapViewOfFile( fileData );
+#else
+        if ( fileCopy.empty() == false )
+        {
+            fileCopy.clear();
+            fileCopy.shrink_to_fit();
+        }
+        else
+        {
+            // out of the table before the pages go, another mapping may take them
+            if ( fileRange != nullptr )
+            {
+                fileRange->start.store( 0 );
+            }
+            munmap( (void*)fileData, (size_t)fileSize );
+        }
+#endif
+    }
+    fileRange = nullptr;
+    fileData  = nullptr;
+    fileSize  = 0;
+    fileOpen  = false;
+    fileIndex = 0;
+    fileTime  = 0;
+    fileName.clear();
+}
+
+#if !defined( _WIN32 )
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Reads the whole file into a private copy, used in place of
+                a mapping when the truncation guard table is full
+    @param      file        open file descriptor
+    @param      size        file size when opened
+    @return     LibraryError    error code
+  --------------------------------------------------------------------------*/
+LibraryError MappedFile::readCopy( int file, uint64_t size )
+{
+    fileCopy.resize( (size_t)size );
+
+    uint64_t total = 0;
+    while ( total < size )
+    {
+        ssize_t bytes = ::read( file, fileCopy.data() + total, (size_t)( size - total ) );
+        if ( bytes < 0 && errno == EINTR )
+        {
+            continue;
+        }
+        if ( bytes < 0 )
+        {
+            fileCopy.clear();
+            return LibraryError::MappedFile_FailedToOpenFile;
+        }
+        if ( bytes == 0 )
+        {
+            // cut short since the size was read, keep what is there
+            break;
+        }
+        total += (uint64_t)bytes;
+    }
+
+    fileCopy.resize( (size_t)total );
+    fileData = fileCopy.empty() ? nullptr : fileCopy.data();
+    fileSize = total;
+    return LibraryError::No_Error;
+}
+
+#endif
+
+// Getters --------------------------------------------------------------------
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Returns if the file was cut short while mapped, the bytes
+                past its new end read as zero
+    @return     bool    true if truncated
+  --------------------------------------------------------------------------*/
+bool MappedFile::isTruncated() const
+{
+#if defined( _WIN32 )
+    return false;
+#else
+    return fileRange != nullptr && fileRange->truncated.load();
+#endif
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Returns if the file on disk is no longer the one mapped, it
+                was replaced, written to, resized or removed since open()
+    @return     bool    true if changed, false if unchanged or not open
+  --------------------------------------------------------------------------*/
+bool MappedFile::isChangedOnDisk() const
+{
+    if ( fileOpen == false )
+    {
+        return false;
+    }
+
+#if defined( _WIN32 )
+    BY_HANDLE_FILE_INFORMATION info;
+    LARGE_INTEGER              size;
+    HANDLE                     file    = CreateFileA( fileName.c_str(), 0, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+    bool                       changed = true;
+    if ( file != INVALID_HANDLE_VALUE )
+    {
+        if ( GetFileInformationByHandle( file, &info ) != FALSE && GetFileSizeEx( file, &size ) != FALSE )
+        {
+            changed = ( ( (uint64_t)info.nFileIndexHigh << 32 ) | info.nFileIndexLow ) != fileIndex ||
+                      ( ( (uint64_t)info.ftLastWriteTime.dwHighDateTime << 32 ) | info.ftLastWriteTime.dwLowDateTime ) != fileTime ||
+                      (uint64_t)size.QuadPart != fileSize;
+        }
+        CloseHandle( file );
+    }
+    return changed;
+#else
+    struct stat info;
+    if ( stat( fileName.c_str(), &info ) != 0 )
+    {
+        return true;
+    }
+    return (uint64_t)info.st_ino != fileIndex ||
+           (uint64_t)info.st_mtim.tv_sec * 1000000000 + (uint64_t)info.st_mtim.tv_nsec != fileTime ||
+           (uint64_t)info.st_size != fileSize;
+#endif
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Returns if a file is mapped
+    @return     bool    true if mapped
+  --------------------------------------------------------------------------*/
+bool MappedFile::isOpen() const
+{
+    return fileOpen;
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Returns the start of the mapped data
+    @return     const char*     data, nullptr if nothing is mapped
+  --------------------------------------------------------------------------*/
+const char* MappedFile::getData() const
+{
+    return fileData;
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Returns the size of the mapped file
+    @return     uint64_t    size in bytes
+  --------------------------------------------------------------------------*/
+uint64_t MappedFile::getSize() const
+{
+    return fileSize;
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Returns the name of the mapped file
+    @return     const std::string&  file name
+  --------------------------------------------------------------------------*/
+const std::string& MappedFile::getFileName() const
+{
+    return fileName;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: MappedFile.cpp
+//-----------------------------------------------------------------------------
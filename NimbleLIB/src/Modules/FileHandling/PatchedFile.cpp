@@ -0,0 +1,336 @@
+/**----------------------------------------------------------------------------
+
+    @file       PatchedFile.cpp
+    @defgroup   NimbleLIBFile Nimble Library File Module
+    @brief      Memory mapped file with a sparse overlay of byte edits
+    @copyright  Neil Bereford 2023
+
+Notes:
+
+    The file is mapped read only, so opening a very large file costs nothing
+    until its pages are read. Edits never touch the mapping, each edited byte
+    is stored in the overlay and reads apply the overlay on top of the
+    mapping. Writing a byte back to its original value removes it from the
+    overlay, so the overlay only ever holds real changes.
+
+    save() writes each run of consecutive edited bytes in place, the file is
+    never rewritten as a whole. The mapping is released while the file is
+    written and mapped again afterwards. Bytes can only be changed, the size
+    of the file is fixed. Once the file has been cut short on disk the bytes
+    past its new end read as zero, save() then refuses rather than writing
+    the edits and the zeros back over the shorter file.
+
+-----------------------------------------------------------------------------*/
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include "../../../inc/Modules/FileHandling/PatchedFile.h"
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+// Namesapce
+//-----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Class Support Functions
+//-----------------------------------------------------------------------------
+
+// Constructors and Destructors -----------------------------------------------
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Constructor for the PatchedFile class
+
+  --------------------------------------------------------------------------*/
+PatchedFile::PatchedFile()
+{
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Destructor for the PatchedFile class, unsaved edits are lost
+
+  --------------------------------------------------------------------------*/
+PatchedFile::~PatchedFile()
+{
+    close();
+}
+
+// File Handling --------------------------------------------------------------
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Maps the file, any previous file and its edits are released
+    @param      fileName    file to open
+    @return     LibraryError    error code
+  --------------------------------------------------------------------------*/
+LibraryError PatchedFile::open( const std::string& fileName )
+{
+    edits.clear();
+    return file.open( fileName );
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Releases the file, unsaved edits are lost
+    @return     void
+  --------------------------------------------------------------------------*/
+void PatchedFile::close()
+{
+    edits.clear();
+    file.close();
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Writes the edited bytes back into the file, one write per run
+                of consecutive bytes, then maps the saved file
+    @return     LibraryError    error code
+  --------------------------------------------------------------------------*/
+LibraryError PatchedFile::save()
+{
+    LibraryError error = LibraryError::No_Error;
+
+    if ( file.isOpen() == false )
+    {
+        error = LibraryError::PatchedFile_FileNotOpen;
+        ErrorHandler::getInstance().handleError( ErrorType::Error, error, "PatchedFile::save() : no file open" );
+        return error;
+    }
+    if ( edits.empty() )
+    {
+        return error;
+    }
+    if ( file.isTruncated() )
+    {
+        error = LibraryError::PatchedFile_FileTruncated;
+        ErrorHandler::getInstance().handleError( ErrorType::Error, error, "PatchedFile::save() : " + file.getFileName() + " was cut short on disk, open it again" );
+        return error;
+    }
+
+    // the mapping is released while the file is written
+    std::string fileName = file.getFileName();
+    file.close();
+
+    std::fstream output( fileName, std::ios::in | std::ios::out | std::ios::binary );
+    if ( output.is_open() == false )
+    {
+        error = LibraryError::PatchedFile_FailedToSaveFile;
+    }
+    else
+    {
+        std::vector<char> run;
+        auto              edit = edits.begin();
+        while ( edit != edits.end() && output.good() )
+        {
+            uint64_t start = edit->first;
+            run.clear();
+            while ( edit != edits.end() && edit->first == start + run.size() )
+            {
+                run.push_back( (char)edit->second );
+                ++edit;
+            }
+            output.seekp( (std::streamoff)start );
+            output.write( run.data(), (std::streamsize)run.size() );
+        }
+        output.flush();
+        if ( output.good() == false )
+        {
+            error = LibraryError::PatchedFile_FailedToSaveFile;
+        }
+        output.close();
+    }
+
+    if ( error == LibraryError::No_Error )
+    {
+        edits.clear();
+    }
+    else
+    {
+        ErrorHandler::getInstance().handleError( ErrorType::Error, error, "PatchedFile::save() : failed to write " + fileName );
+    }
+
+    // map the file again, the edits are still held if the write failed
+    LibraryError mapError = file.open( fileName );
+    return ( error == LibraryError::No_Error ) ? mapError : error;
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Drops every unsaved edit
+    @return     void
+  --------------------------------------------------------------------------*/
+void PatchedFile::discardEdits()
+{
+    edits.clear();
+}
+
+// Byte access ----------------------------------------------------------------
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Returns a byte, including any edit
+    @param      offset      offset in the file
+    @return     uint8_t     byte, 0 if out of range
+  --------------------------------------------------------------------------*/
+uint8_t PatchedFile::getByte( uint64_t offset ) const
+{
+    uint8_t value = 0;
+    readBytes( offset, &value, 1 );
+    return value;
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Copies bytes from the file and applies the edits in the range
+    @param      offset      offset of the first byte
+    @param      buffer      buffer for the bytes
+    @param      count       number of bytes wanted
+    @return     uint32_t    number of bytes copied, less at the end of file
+  --------------------------------------------------------------------------*/
+uint32_t PatchedFile::readBytes( uint64_t offset, uint8_t* buffer, uint32_t count ) const
+{
+    uint64_t size = file.getSize();
+
+    if ( offset >= size )
+    {
+        return 0;
+    }
+    if ( count > size - offset )
+    {
+        count = (uint32_t)( size - offset );
+    }
+    memcpy( buffer, file.getData() + offset, count );
+
+    for ( auto edit = edits.lower_bound( offset ); edit != edits.end() && edit->first < offset + count; ++edit )
+    {
+        buffer[edit->first - offset] = edit->second;
+    }
+    return count;
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Changes a byte in the overlay, setting the value held in the
+                file removes the edit
+    @param      offset      offset in the file
+    @param      value       new value
+    @return     LibraryError    error code
+  --------------------------------------------------------------------------*/
+LibraryError PatchedFile::setByte( uint64_t offset, uint8_t value )
+{
+    if ( offset >= file.getSize() )
+    {
+        ErrorHandler::getInstance().handleError( ErrorType::Error, LibraryError::PatchedFile_InvalidOffset, "PatchedFile::setByte() : offset past the end of the file" );
+        return LibraryError::PatchedFile_InvalidOffset;
+    }
+
+    if ( (uint8_t)file.getData()[offset] == value )
+    {
+        edits.erase( offset );
+    }
+    else
+    {
+        edits[offset] = value;
+    }
+    return LibraryError::No_Error;
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Returns if a byte has an unsaved edit
+    @param      offset      offset in the file
+    @return     bool    true if edited
+  --------------------------------------------------------------------------*/
+bool PatchedFile::isEdited( uint64_t offset ) const
+{
+    return edits.find( offset ) != edits.end();
+}
+
+// Getters --------------------------------------------------------------------
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Returns if a file is open
+    @return     bool    true if open
+  --------------------------------------------------------------------------*/
+bool PatchedFile::isOpen() const
+{
+    return file.isOpen();
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Returns if there are unsaved edits
+    @return     bool    true if modified
+  --------------------------------------------------------------------------*/
+bool PatchedFile::isModified() const
+{
+    return edits.empty() == false;
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Returns if the file was cut short on disk since it was opened,
+                checked after reading and before saving
+    @return     bool    true if truncated
+  --------------------------------------------------------------------------*/
+bool PatchedFile::isTruncated() const
+{
+    return file.isTruncated();
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Returns if the file on disk was replaced or written since it
+                was opened or saved, the bytes shown may be out of date
+    @return     bool    true if changed
+  --------------------------------------------------------------------------*/
+bool PatchedFile::isChangedOnDisk() const
+{
+    return file.isChangedOnDisk();
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Returns the size of the file
+    @return     uint64_t    size in bytes
+  --------------------------------------------------------------------------*/
+uint64_t PatchedFile::getSize() const
+{
+    return file.getSize();
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Returns the number of edited bytes
+    @return     uint64_t    bytes held in the overlay
+  --------------------------------------------------------------------------*/
+uint64_t PatchedFile::getEditCount() const
+{
+    return edits.size();
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBFile Nimble Library File Module
+    @brief      Returns the name of the open file
+    @return     const std::string&  file name, empty if no file is open
+  --------------------------------------------------------------------------*/
+const std::string& PatchedFile::getFileName() const
+{
+    return file.getFileName();
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: PatchedFile.cpp
+//-----------------------------------------------------------------------------
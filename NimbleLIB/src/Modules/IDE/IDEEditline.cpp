@@ -8,6 +8,11 @@
 
 Notes:
 
+    lineBuffer is a gap buffer, the text before the cursor is held at the
+    start of the buffer and the text after it at the end, with the unused
+    gap in between. Cursor moves only change lineCursor, the gap is moved
+    to the cursor when the next edit happens, so typing and deleting are
+    amortised O(1) and a paste copies the string once.
 
 -----------------------------------------------------------------------------*/
 
@@ -16,7 +21,9 @@ Notes:
 // ----------------------------------------------------------------------------
 
 #include "../../../inc/Modules/IDE/IDEEditline.h"
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
 
 //-----------------------------------------------------------------------------
 // Namespace
@@ -39,6 +46,11 @@ namespace Nimble
 IDEEditline::IDEEditline()
 {
     lineBufferLimit = 27;
+    lineLength      = 0;
+    lineCursor      = 0;
+    gapStart        = 0;
+    gapEnd          = 0;
+    bytesMoved      = 0;
 }
 
 /**----------------------------------------------------------------------------
@@ -122,9 +134,9 @@ uint8_t IDEEditline::getLineBufferChar( uint32_t index ) const
 {
     uint8_t charToReturn = 0;
 
-    if ( index < lineLength )
+    if ( index < lineLength && index < getTextLength() )
     {
-        charToReturn = lineBuffer[ index ];
+        charToReturn = lineBuffer[ ( index < gapStart ) ? index : index + ( gapEnd - gapStart ) ];
     }
     else
     {
@@ -161,7 +173,12 @@ uint32_t IDEEditline::getHilightEnd() const
 -----------------------------------------------------------------------------*/
 std::string IDEEditline::getLineString() const
 {
-    return std::string( lineBuffer.begin(), lineBuffer.end() );
+    std::string text;
+
+    text.reserve( getTextLength() );
+    text.append( lineBuffer.begin(), lineBuffer.begin() + gapStart );
+    text.append( lineBuffer.begin() + gapEnd, lineBuffer.end() );
+    return text;
 }
 
 /**----------------------------------------------------------------------------
@@ -174,6 +191,17 @@ uint32_t IDEEditline::getLineBufferLimit() const
     return lineBufferLimit;
 }
 
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Get the number of bytes moved within the line buffer by
+                edits since init(), used to check the cost of editing
+    @return     uint64_t    bytes moved
+-----------------------------------------------------------------------------*/
+uint64_t IDEEditline::getBytesMoved() const
+{
+    return bytesMoved;
+}
+
 // setters ---------------------------------------------------------------------
 
 /**----------------------------------------------------------------------------
@@ -251,9 +279,9 @@ void IDEEditline::setLineCursor( uint32_t cursor )
 -----------------------------------------------------------------------------*/
 void IDEEditline::setLineBufferChar( uint32_t index, uint8_t charToSet )
 {
-    if ( index < lineLength )
+    if ( index < lineLength && index < getTextLength() )
     {
-        lineBuffer[ index ] = charToSet;
+        lineBuffer[ ( index < gapStart ) ? index : index + ( gapEnd - gapStart ) ] = charToSet;
     }
     else
     {
@@ -318,9 +346,12 @@ LibraryError IDEEditline::init( std::string& inText, uint32_t inXpos, uint32_t i
         lineInkColour   = COLOR_WHITE;
         linePaperColour = COLOR_BLACK;
 
-        // copy the text into the line buffer
-        lineBuffer.clear();
-        std::copy( inText.begin(), inText.end(), std::back_inserter( lineBuffer ) );
+        // copy the text into the line buffer, the gap starts at the cursor
+        lineBuffer.assign( GAP_SIZE + inText.length(), 0 );
+        std::copy( inText.begin(), inText.end(), lineBuffer.begin() + GAP_SIZE );
+        gapStart   = 0;
+        gapEnd     = GAP_SIZE;
+        bytesMoved = 0;
 
         // set the initialised flag
         setInitialized();
@@ -383,7 +414,9 @@ LibraryError IDEEditline::addChar( uint8_t inChar )
             lineCursor = lineLength;
         }
         // insert the character at the cursor position
-        lineBuffer.insert( lineBuffer.begin() + lineCursor, inChar );
+        moveGap( lineCursor );
+        reserveGap( 1 );
+        lineBuffer[ gapStart++ ] = inChar;
         // increment the line length
         lineLength++;
         lineBufferLimit++;
@@ -417,8 +450,20 @@ LibraryError IDEEditline::deleteChar( void )
                 ErrorHandler::getInstance().handleError( ErrorType::Warning, LibraryError::IDEEditline_IncorrectBufferIndex, "IDEEditline::deleteChar() : cursor out of bounds" );
                 lineCursor = lineLength - 1;
             }
-            lineBuffer[ lineLength - 1 ] = 0;
-            lineBuffer.erase( lineBuffer.begin() + lineCursor );
+            // the character is removed by widening the gap, backspacing
+            // at the gap needs no move at all
+            if ( gapStart == lineCursor + 1 )
+            {
+                gapStart--;
+            }
+            else
+            {
+                moveGap( lineCursor );
+                if ( gapEnd < lineBuffer.size() )
+                {
+                    gapEnd++;
+                }
+            }
             // decrement the line length
             lineLength--;
             lineBufferLimit--;
@@ -445,7 +490,10 @@ LibraryError IDEEditline::addString( std::string& inString )
             lineCursor = lineLength;
         }
         // insert the string at the cursor position
-        lineBuffer.insert( lineBuffer.begin() + lineCursor, inString.begin(), inString.end() );
+        moveGap( lineCursor );
+        reserveGap( inString.length() );
+        std::copy( inString.begin(), inString.end(), lineBuffer.begin() + gapStart );
+        gapStart += inString.length();
         // increment the line length
         lineLength += inString.length();
         // increment the cursor position
@@ -465,16 +513,21 @@ LibraryError IDEEditline::deleteChars( uint32_t numChars )
     LibraryError returnError = LibraryError::IDEEditline_InitNotCalled;
     if ( isNotInitialized() == false )
     {
-        // check the cursor is within the bounds of the line buffer
-        if ( lineCursor >= lineLength )
+        if ( lineLength > 0 )
         {
-            ErrorHandler::getInstance().handleError( ErrorType::Warning, LibraryError::IDEEditline_IncorrectBufferIndex, "IDEEditline::deleteChars() : cursor out of bounds" );
-            lineCursor = lineLength - 1;
+            // check the cursor is within the bounds of the line buffer
+            if ( lineCursor >= lineLength )
+            {
+                ErrorHandler::getInstance().handleError( ErrorType::Warning, LibraryError::IDEEditline_IncorrectBufferIndex, "IDEEditline::deleteChars() : cursor out of bounds" );
+                lineCursor = lineLength - 1;
+            }
+            // delete the characters at the cursor position, by widening the gap
+            moveGap( lineCursor );
+            numChars = std::min<uint32_t>( numChars, (uint32_t)lineBuffer.size() - gapEnd );
+            gapEnd += numChars;
+            // decrement the line length
+            lineLength -= numChars;
         }
-        // delete the character at the cursor position
-        lineBuffer.erase( lineBuffer.begin() + lineCursor );
-        // decrement the line length
-        lineLength--;
         returnError = LibraryError::No_Error;
     }
     return ( returnError );
@@ -565,6 +618,71 @@ LibraryError IDEEditline::moveCursorEnd( void )
     return ( returnError );
 }
 
+// Gap buffer ------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Gets the length of the text held in the line buffer
+    @return     uint32_t    length of the text, excluding the gap
+-----------------------------------------------------------------------------*/
+uint32_t IDEEditline::getTextLength() const
+{
+    return (uint32_t)lineBuffer.size() - ( gapEnd - gapStart );
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Moves the gap to a text position, only the text between the
+                old and new positions is moved
+    @param      position    text position for the start of the gap
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDEEditline::moveGap( uint32_t position )
+{
+    position = std::min( position, getTextLength() );
+
+    if ( position < gapStart )
+    {
+        // text before the gap moves to after it
+        uint32_t count = gapStart - position;
+        memmove( lineBuffer.data() + gapEnd - count, lineBuffer.data() + position, count );
+        gapStart -= count;
+        gapEnd -= count;
+        bytesMoved += count;
+    }
+    else if ( position > gapStart )
+    {
+        // text after the gap moves to before it
+        uint32_t count = position - gapStart;
+        memmove( lineBuffer.data() + gapStart, lineBuffer.data() + gapEnd, count );
+        gapStart += count;
+        gapEnd += count;
+        bytesMoved += count;
+    }
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Makes sure the gap can hold a number of characters, the buffer
+                at least doubles when it grows so growth is amortised O(1)
+    @param      length  characters that are about to be inserted
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDEEditline::reserveGap( uint32_t length )
+{
+    if ( gapEnd - gapStart < length )
+    {
+        uint32_t tailLength = (uint32_t)lineBuffer.size() - gapEnd;
+        uint32_t newSize    = std::max<uint32_t>( (uint32_t)lineBuffer.size() * 2, getTextLength() + length + GAP_SIZE );
+        uint32_t newGapEnd  = newSize - tailLength;
+
+        lineBuffer.resize( newSize );
+        memmove( lineBuffer.data() + newGapEnd, lineBuffer.data() + gapEnd, tailLength );
+        gapEnd = newGapEnd;
+        bytesMoved += tailLength;
+    }
+}
+
 // FLag control ----------------------------------------------------------------
 /**----------------------------------------------------------------------------
     @ingroup    NimbleLIBIDE Nimble Library IDE Module
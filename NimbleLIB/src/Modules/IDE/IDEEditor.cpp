@@ -8,6 +8,43 @@
 
 Notes:
 
+    Files of LARGE_FILE_SIZE or more are opened in LargeFileMode, they are
+    view only and the visible rows are drawn straight from the mapped file.
+    If another process cuts the file short the rows past its new end read
+    as zeros, this is checked after the rows are drawn, reported once and
+    shown in the status bar.
+
+    Every change the edit keys make to the document is recorded in
+    m_journal as an insert or erase with the cursor before and after, Ctrl+Z
+    and Ctrl+Y undo and redo it. Undo and redo clear any marked text.
+
+    Find / replace searches the pieces of the document in place, a match
+    may run across pieces. The match shown is the only marked text, Ctrl+F
+    finds the word under the cursor, Ctrl+G and Ctrl+R find the next and
+    previous match, wrapping round the document. replaceAll() erases and
+    inserts at each match, last match first so the earlier offsets hold,
+    and records them as a single undo step. A replace too large for the
+    undo budget is refused, the undo history is kept.
+
+    C and C++ files are opened with FormatWhenPrint set and are coloured by
+    m_syntax. The edit functions tell it which lines they changed, before
+    the rows are drawn it lexes those lines and any below them whose start
+    state changed, and those rows are redrawn too.
+
+    Every file opened is kept in m_files, switchBuffer() hands the
+    document, journal and cursor of the file being edited to it and takes
+    those of the file switched to back, so switching does not read a file
+    again unless m_files had to drop it to keep within its memory budget.
+
+    Files below LARGE_FILE_SIZE are read in the background, processLoad()
+    is called from a timer and appends up to LOAD_FRAME_BUDGET bytes of
+    lines each time. The lines already in can be viewed and edited, the
+    appended lines are new lines at the end so the undo journal is
+    unaffected.
+
+    displayEditor() only redraws the rows marked dirty. The edit functions
+    mark the rows they change, scrolling marks the whole view and a change
+    in the number of lines marks the rows from the end of the shorter file.
 
 -----------------------------------------------------------------------------*/
 
@@ -18,8 +55,13 @@ Notes:
 #include "../../../inc/Modules/IDE/IDEEditor.h"
 #include "../../../inc/Modules/Curses/CursesColour.h"
 #include "../../../inc/Modules/Global/Globals.h"
+#include "../../../inc/Modules/Utilities/Profiler.h"
+#include <algorithm>
+#include <cctype>
 #include <cstdint>
+#include <filesystem>
 #include <memory>
+#include <string_view>
 
 //-----------------------------------------------------------------------------
 // Namespace
@@ -28,6 +70,24 @@ Notes:
 namespace Nimble
 {
 
+//-----------------------------------------------------------------------------
+// Local data
+// ----------------------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Colour of each syntax token type, in IDESyntax::TokenType order
+------------------------------------------------------------------------------*/
+static const uint32_t TOKEN_COLOURS[(uint32_t)IDESyntax::TokenType::Total] = {
+    COLOUR_INDEX( IDE_COL_FG_BLACK, IDE_COL_BG_WHITE ),         //!< Text
+    COLOUR_INDEX( IDE_COL_FG_BLUE, IDE_COL_BG_WHITE ) | A_BOLD, //!< Keyword
+    COLOUR_INDEX( IDE_COL_FG_BLUE, IDE_COL_BG_WHITE ),          //!< Type
+    COLOUR_INDEX( IDE_COL_FG_MAGENTA, IDE_COL_BG_WHITE ),       //!< Preprocessor
+    COLOUR_INDEX( IDE_COL_FG_RED, IDE_COL_BG_WHITE ),           //!< Number
+    COLOUR_INDEX( IDE_COL_FG_RED, IDE_COL_BG_WHITE ),           //!< String
+    COLOUR_INDEX( IDE_COL_FG_GREEN, IDE_COL_BG_WHITE ),         //!< Comment
+};
+
 //-----------------------------------------------------------------------------
 // Class definitions
 // ----------------------------------------------------------------------------
@@ -42,16 +102,26 @@ namespace Nimble
 IDEEditor::IDEEditor()
 {
     // default the editor values
-    m_currentLine   = 0;
-    m_currentColumn = 0;
-    m_cursorX       = 0;
-    m_cursorY       = 0;
-    m_oldCursorX    = 0;
-    m_oldCursorY    = 0;
+    m_currentLine     = 0;
+    m_currentColumn   = 0;
+    m_cursorX         = 0;
+    m_cursorY         = 0;
+    m_oldCursorX      = 0;
+    m_oldCursorY      = 0;
+    m_cursorDrawn     = true;
+    m_drawnLine       = -1;
+    m_drawnColumn     = -1;
+    m_drawnLines      = 0;
+    m_editCursor      = getCursorState();
+    m_documentEdited  = false;
+    m_matchOffset     = IDESearch::NOT_FOUND;
+    m_activeFile      = FileManager::NO_FILE;
+    m_truncatedLogged = false;
 
     // set up the Editor flags
     clearUserFlag( (uint32_t)EditorFlags::FormatWhenPrint );
     clearUserFlag( (uint32_t)EditorFlags::MarkedTextActive );
+    clearUserFlag( (uint32_t)EditorFlags::LargeFileMode );
 }
 
 /**-----------------------------------------------------------------------------
@@ -92,6 +162,7 @@ LibraryError IDEEditor::init( uint32_t width, uint32_t height, uint32_t x, uint3
         // create the curses window
         m_editorWin = std::make_unique<CursesWin>( m_width, m_height + 1, m_xStart, m_yStart, IDE_COL_FG_BLACK, IDE_COL_BG_WHITE );
         m_editorWin->colourWindow( COLOUR_INDEX( IDE_COL_FG_BLACK, IDE_COL_BG_WHITE ), true );
+        m_dirtyRows.assign( m_height - 1, true );
         setInitialized();
     }
 
@@ -100,34 +171,132 @@ LibraryError IDEEditor::init( uint32_t width, uint32_t height, uint32_t x, uint3
 
 /**-----------------------------------------------------------------------------
     @ingroup    NimbleLIBIDE Nimble Library IDE Module
-    @brief      Start the IDEEditor class
-    @param      filename    filename to open
-    @return     LibraryError    error code, if any
------------------------------------------------------------------------------*/
+    @brief      Start the IDEEditor class, opens a file and switches to it.
+                A file already open is switched to without reading it again
+    @param      filename    file to edit
+    @return     LibraryError    error code
+------------------------------------------------------------------------------*/
 LibraryError IDEEditor::start( std::string& filename )
 {
-    LibraryError error = LibraryError::No_Error;
     if ( isNotInitialized() )
     {
-        error = LibraryError::IDEEditor_NotInitialized;
+        return LibraryError::IDEEditor_NotInitialized;
+    }
+
+    uint32_t fileID = m_files.openFile( filename );
+    if ( fileID == FileManager::NO_FILE )
+    {
+        return LibraryError::IDEFileHandler_FailedToOpenFile;
+    }
+    return switchBuffer( fileID );
+}
+
+// buffers ---------------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      switches the editor to another open file. The buffer being
+                edited is stored in m_files, the one switched to is taken
+                from it, or read from disk if it was dropped
+    @param      fileID  file to switch to
+    @return     LibraryError    error code
+------------------------------------------------------------------------------*/
+LibraryError IDEEditor::switchBuffer( uint32_t fileID )
+{
+    PROFILE_ZONE( "IDEEditor::switchBuffer" );
+
+    LibraryError                error    = LibraryError::No_Error;
+    IDEUndoJournal::CursorState cursor   = { 0, 0, 0, 0 };
+    bool                        modified = false;
+
+    if ( isNotInitialized() )
+    {
+        return LibraryError::IDEEditor_NotInitialized;
+    }
+    if ( fileID == m_activeFile )
+    {
+        return LibraryError::No_Error;
+    }
+
+    stashBuffer();
+    std::string filename = m_files.getFileName( fileID );
+    if ( m_files.restoreBuffer( fileID, m_document, m_journal, cursor, modified ) )
+    {
+        restoreDocument( filename, modified );
+        clearUserFlag( (uint32_t)EditorFlags::LargeFileMode );
     }
     else
     {
-        error = openFile( filename );
-        if ( error == LibraryError::No_Error )
+        // large files are mapped and viewed rather than read in
+        std::error_code sizeError;
+        uintmax_t       fileSize = std::filesystem::file_size( filename, sizeError );
+        if ( !sizeError && fileSize >= LARGE_FILE_SIZE )
+        {
+            error = openLargeFile( filename );
+            setUserFlag( (uint32_t)EditorFlags::LargeFileMode );
+            m_truncatedLogged = false;
+            m_journal.clear();
+            cursor = { 0, 0, 0, 0 };
+        }
+        else
         {
-            // TODO: sort out settins properly
-            Screen::sEditorSettings* pSettings = Screen::Globals::getInstance().getEditorSettings();
-            pSettings->Theme                   = Screen::eEditorTheme::Dark;
-            pSettings->LineNumbers             = true;
+            error = openFile( filename );
+            clearUserFlag( (uint32_t)EditorFlags::LargeFileMode );
 
-            displayEditor();
-            enableMouse();
+            // the journal was kept, read as far as the cursor so it is on a line
+            uint32_t cursorLine = (uint32_t)( cursor.currentLine + cursor.cursorY );
+            while ( error == LibraryError::No_Error && isLoading() && getTotalLines() <= cursorLine )
+            {
+                processLoad();
+            }
         }
+        m_files.setFileSynced( fileID );
+    }
+    m_activeFile = fileID;
+
+    if ( IDESyntax::isSourceFile( filename ) )
+    {
+        setUserFlag( (uint32_t)EditorFlags::FormatWhenPrint );
+    }
+    else
+    {
+        clearUserFlag( (uint32_t)EditorFlags::FormatWhenPrint );
+    }
+    restoreCursorState( cursor );
+    if ( error == LibraryError::No_Error )
+    {
+        // show whatever has been read already, the rest follows
+        processLoad();
+
+        // TODO: sort out settins properly
+        Screen::sEditorSettings* pSettings = Screen::Globals::getInstance().getEditorSettings();
+        pSettings->Theme                   = Screen::eEditorTheme::Dark;
+        pSettings->LineNumbers             = true;
+
+        displayEditor();
+        enableMouse();
     }
     return error;
 }
 
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      switches to the file opened after or before the one being
+                edited, wrapping round
+    @param      forward true for the next file, false for the previous
+    @return     LibraryError    error code
+------------------------------------------------------------------------------*/
+LibraryError IDEEditor::nextBuffer( bool forward )
+{
+    uint32_t fileID = m_files.getNextFileID( m_activeFile, forward );
+
+    if ( fileID == FileManager::NO_FILE )
+    {
+        return LibraryError::IDEFileHandler_FileNotOpen;
+    }
+    return switchBuffer( fileID );
+}
+
 // display functions -----------------------------------------------------------
 
 /**-----------------------------------------------------------------------------
@@ -137,57 +306,119 @@ LibraryError IDEEditor::start( std::string& filename )
 -----------------------------------------------------------------------------*/
 LibraryError IDEEditor::displayEditor()
 {
+    PROFILE_ZONE( "IDEEditor::displayEditor" );
+
     LibraryError error         = LibraryError::No_Error;
 
     uint32_t     curline       = 0;
     uint32_t     curcol        = m_currentColumn;
     uint32_t     displayWidth  = m_width - 2;
     uint32_t     displayHeight = m_height - 1;
+    uint32_t     totalLines    = getTotalLines();
+    bool         rowsDrawn     = false;
+    bool         formatted     = isUserFlagSet( (uint32_t)EditorFlags::FormatWhenPrint ) && isUserFlagSet( (uint32_t)EditorFlags::LargeFileMode ) == false;
 
-    std::string  blankline( displayWidth, ' ' );
-
-    while ( curline < ( displayHeight ) && ( curline < ( displayHeight + m_editlines.size() - 1 ) ) )
+    // scrolling moves every row, a change in length moves the rows at the end
+    if ( m_currentLine != m_drawnLine || m_currentColumn != m_drawnColumn )
     {
-        std::string line;
-
-        line = "¬";
-        if ( ( curline + m_currentLine ) < m_editlines.size() )
+        markRowsDirty( 0, displayHeight - 1 );
+    }
+    else if ( totalLines != m_drawnLines )
+    {
+        int32_t firstRow = (int32_t)std::min( totalLines, m_drawnLines ) - 1 - m_currentLine;
+        markRowsDirty( std::max( firstRow, 0 ), displayHeight - 1 );
+    }
+    m_drawnLine   = m_currentLine;
+    m_drawnColumn = m_currentColumn;
+    m_drawnLines  = totalLines;
+
+    // lex the edited lines, rows whose start state changed are redrawn too
+    uint32_t firstChanged;
+    uint32_t lastChanged;
+    if ( formatted && m_syntax.update( m_document, m_currentLine + displayHeight - 1, firstChanged, lastChanged ) )
+    {
+        int32_t firstRow = (int32_t)firstChanged - m_currentLine;
+        int32_t lastRow  = (int32_t)lastChanged - m_currentLine;
+        if ( lastRow >= 0 )
         {
-            line = m_editlines[ curline + m_currentLine ];
+            markRowsDirty( std::max( firstRow, 0 ), lastRow );
         }
+    }
 
-        // move to the current column, blanking if off screen
-        if ( line.length() > 0 && line.length() >= curcol )
-        {
-            line = line.substr( curcol, displayWidth );
-        }
-        else
+    while ( curline < ( displayHeight ) && ( curline < ( displayHeight + totalLines - 1 ) ) )
+    {
+        if ( m_dirtyRows[curline] == false )
         {
-            line = "¬";
+            curline++;
+            continue;
         }
 
-        if ( line.length() > displayWidth )
+        std::string      text;
+        std::string_view line;
+
+        if ( ( curline + m_currentLine ) < totalLines )
         {
-            line = line.substr( 0, displayWidth );
+            if ( isUserFlagSet( (uint32_t)EditorFlags::LargeFileMode ) )
+            {
+                // view straight into the mapping, only the visible rows are touched
+                line = m_largeFile.getLine( curline + m_currentLine );
+            }
+            else
+            {
+                text = m_document.getLine( curline + m_currentLine );
+                line = text;
+            }
         }
 
-        // print the line, blanking first
-        m_editorWin->print( 1, curline + 1, blankline );
-        if ( line != "¬" )
+        // print the visible part of the line padded to the width, in one go
+        std::string row( displayWidth, ' ' );
+        if ( line.length() > curcol )
         {
-            m_editorWin->print( 1, curline + 1, line );
+            line.copy( row.data(), displayWidth, curcol );
         }
+        m_editorWin->print( 1, curline + 1, row );
 
         // attribute the line
+        if ( formatted )
+        {
+            updateSyntaxColours( curline, line );
+        }
         updateHighlighting( curline );
+        m_dirtyRows[curline] = false;
+        rowsDrawn            = true;
         curline++;
     }
 
-    m_editorWin->draw();
+    if ( rowsDrawn )
+    {
+        m_editorWin->draw();
+    }
+
+    // the rows just read may have come from pages lost to a truncation
+    if ( rowsDrawn && m_truncatedLogged == false && isFileTruncated() )
+    {
+        m_truncatedLogged = true;
+        ErrorHandler::getInstance().handleError( ErrorType::Warning, LibraryError::IDEEditor_FileTruncated, "IDEEditor::displayEditor() : " + getFilename() + " was cut short on disk, the lines past its end read as zeros" );
+    }
 
     return error;
 }
 
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      marks a range of rows to be redrawn by the next displayEditor()
+    @param      firstRow    first row, from the top of the window
+    @param      lastRow     last row, inclusive, clamped to the window
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDEEditor::markRowsDirty( uint32_t firstRow, uint32_t lastRow )
+{
+    for ( uint32_t row = firstRow; row <= lastRow && row < m_dirtyRows.size(); row++ )
+    {
+        m_dirtyRows[row] = true;
+    }
+}
+
 /**-----------------------------------------------------------------------------
     @ingroup    NimbleLIBIDE Nimble Library IDE Module
     @brief      print to the editor window
@@ -217,6 +448,7 @@ LibraryError IDEEditor::print( uint32_t x, uint32_t y, const std::string& text )
 void IDEEditor::redrawBackground()
 {
     m_editorWin->colourWindow( COLOUR_INDEX( IDE_COL_FG_BLACK, IDE_COL_BG_WHITE ), true );
+    markRowsDirty( 0, m_height - 1 );
     displayEditor();
     m_editorWin->draw();
 }
@@ -250,7 +482,92 @@ uint32_t IDEEditor::getCurrentColumn() const
 ------------------------------------------------------------------------------*/
 uint32_t IDEEditor::getTotalLines() const
 {
-    return m_editlines.size();
+    if ( isUserFlagSet( (uint32_t)EditorFlags::LargeFileMode ) )
+    {
+        return m_largeFile.getLineCount();
+    }
+    return m_document.getLineCount();
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      get the document being edited, for line access by the
+                other editor windows
+    @return     const IDEPieceTable&    document
+------------------------------------------------------------------------------*/
+const IDEPieceTable& IDEEditor::getDocument() const
+{
+    return m_document;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      get the open files
+    @return     const FileManager&    file manager holding the other buffers
+------------------------------------------------------------------------------*/
+const FileManager& IDEEditor::getFileManager() const
+{
+    return m_files;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      get the file being edited
+    @return     uint32_t    file ID, FileManager::NO_FILE if none
+------------------------------------------------------------------------------*/
+uint32_t IDEEditor::getActiveFile() const
+{
+    return m_activeFile;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      get the name of the file being edited
+    @return     const std::string&    filename
+------------------------------------------------------------------------------*/
+const std::string& IDEEditor::getFilename() const
+{
+    return IDEFileHandler::getFilename();
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      check if the document has changes not yet saved
+    @return     bool    true if modified
+------------------------------------------------------------------------------*/
+bool IDEEditor::isModified() const
+{
+    return IDEFileHandler::isModified();
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      check if the file is still being read in
+    @return     bool    true while lines are still to be added
+------------------------------------------------------------------------------*/
+bool IDEEditor::isLoading() const
+{
+    return IDEFileHandler::isLoading();
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      check if the large file being viewed was cut short on disk
+    @return     bool    true if truncated
+------------------------------------------------------------------------------*/
+bool IDEEditor::isFileTruncated() const
+{
+    return isUserFlagSet( (uint32_t)EditorFlags::LargeFileMode ) && m_largeFile.isTruncated();
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      get how much of the file has been read in
+    @return     uint32_t    percentage loaded
+------------------------------------------------------------------------------*/
+uint32_t IDEEditor::getLoadProgress() const
+{
+    return IDEFileHandler::getLoadProgress();
 }
 
 /**-----------------------------------------------------------------------------
@@ -298,7 +615,7 @@ void IDEEditor::setCursorPosition( uint32_t x, uint32_t y )
         m_cursorX = x - m_xStart - 1;
         m_cursorY = y - m_yStart - 1;
 
-        if ( m_cursorX + m_currentColumn > m_editlines[ m_currentLine + m_cursorY ].length() )
+        if ( m_cursorX + m_currentColumn > m_document.getLineLength( m_currentLine + m_cursorY ) )
             placeCursorinLine( m_currentLine );
     }
 }
@@ -315,10 +632,10 @@ void IDEEditor::scrollEditor( bool upIfTrue )
 
     if ( m_currentLine < 0 )
         m_currentLine = 0;
-    if ( m_currentLine > m_editlines.size() )
-        m_currentLine = m_editlines.size();
+    if ( m_currentLine > getTotalLines() )
+        m_currentLine = getTotalLines();
 
-    if ( m_cursorX + m_currentColumn > m_editlines[ m_currentLine + m_cursorY ].length() )
+    if ( m_cursorX + m_currentColumn > m_document.getLineLength( m_currentLine + m_cursorY ) )
         placeCursorinLine( m_currentLine );
 }
 
@@ -332,24 +649,194 @@ void IDEEditor::scrollEditor( bool upIfTrue )
 ------------------------------------------------------------------------------*/
 bool IDEEditor::processKeyEdit( uint32_t key )
 {
+    PROFILE_ZONE( "IDEEditor::processKeyEdit" );
+
     bool displayChanged = false;
 
     // save the old cursor position
     // m_oldCursorX = m_cursorX;
     // m_oldCursorY = m_cursorY;
 
-    if ( key != ERR )
+    if ( isUserFlagSet( (uint32_t)EditorFlags::LargeFileMode ) )
+    {
+        // large files are view only
+        displayChanged = processKeyViewOnly( key );
+    }
+    else if ( key == UNDO_KEY )
+    {
+        displayChanged = undo();
+    }
+    else if ( key == REDO_KEY )
+    {
+        displayChanged = redo();
+    }
+    else if ( key == SAVE_KEY )
+    {
+        save();
+    }
+    else if ( key == FIND_KEY )
+    {
+        std::string word = getWordAtCursor();
+        displayChanged   = word.empty() ? findNext() : find( word, true, true );
+    }
+    else if ( key == FIND_NEXT_KEY )
+    {
+        displayChanged = findNext();
+    }
+    else if ( key == FIND_PREVIOUS_KEY )
+    {
+        displayChanged = findPrevious();
+    }
+    else if ( key != ERR )
     {
         displayChanged = checkCursorKeys( key );
         if ( displayChanged == false )
         {
-            displayChanged = checkEditKeys( key );
+            m_editCursor     = getCursorState();
+            m_documentEdited = false;
+            displayChanged   = checkEditKeys( key );
+        }
+
+        if ( m_documentEdited == true )
+        {
+            m_journal.setCursorAfter( getCursorState() );
+            m_matchOffset = IDESearch::NOT_FOUND;
+            updateEditFlags();
+            m_documentEdited = false;
+        }
+        else if ( displayChanged == true )
+        {
+            // the cursor moved, the next edit starts a new undo step
+            m_journal.closeStep();
         }
     }
 
     return displayChanged;
 }
 
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      inserts text at the cursor as one edit, a run of typed keys
+                or a paste. Typed text joins the typing before it in the
+                undo journal, a paste is always an undo step of its own.
+    @param      text    text, line ends of a paste may be CR LF or CR
+    @param      paste   true if the text was pasted
+    @return     bool    true if display changed
+------------------------------------------------------------------------------*/
+bool IDEEditor::processText( const std::string& text, bool paste )
+{
+    PROFILE_ZONE( "IDEEditor::processText" );
+
+    std::string inserted;
+
+    if ( isUserFlagSet( (uint32_t)EditorFlags::LargeFileMode ) )
+    {
+        // large files are view only, the keys are handled one at a time
+        bool displayChanged = false;
+        for ( char ch : text )
+        {
+            displayChanged |= processKeyViewOnly( (uint8_t)ch );
+        }
+        return displayChanged;
+    }
+
+    // line ends become line feeds, other control characters are dropped
+    inserted.reserve( text.size() );
+    for ( size_t index = 0; index < text.size(); index++ )
+    {
+        char ch = text[index];
+        if ( ch == '\r' )
+        {
+            inserted += '\n';
+            if ( index + 1 < text.size() && text[index + 1] == '\n' )
+            {
+                index++;
+            }
+        }
+        else if ( ch == '\n' || ch == '\t' || ( (uint8_t)ch >= 32 && ch != 127 ) )
+        {
+            inserted += ch;
+        }
+    }
+    if ( inserted.empty() )
+    {
+        return false;
+    }
+
+    uint32_t line   = m_currentLine + m_cursorY;
+    uint32_t column = (uint32_t)( m_currentColumn + m_cursorX );
+    size_t   lastLF = inserted.rfind( '\n' );
+
+    m_editCursor     = getCursorState();
+    m_documentEdited = false;
+    if ( paste )
+    {
+        m_journal.beginGroup();
+    }
+    insertTextIntoEditor( m_cursorX, m_cursorY, inserted );
+    if ( paste )
+    {
+        m_journal.endGroup();
+    }
+    if ( m_documentEdited == false )
+    {
+        return false;
+    }
+
+    // the cursor goes to the end of the text inserted
+    if ( lastLF == std::string::npos )
+    {
+        placeCursorAt( line, column + (uint32_t)inserted.size() );
+    }
+    else
+    {
+        placeCursorAt( line + (uint32_t)std::count( inserted.begin(), inserted.end(), '\n' ), (uint32_t)( inserted.size() - lastLF - 1 ) );
+        markRowsDirty( 0, m_height - 1 );
+    }
+
+    m_journal.setCursorAfter( getCursorState() );
+    m_matchOffset = IDESearch::NOT_FOUND;
+    updateEditFlags();
+    m_documentEdited = false;
+    return true;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      undoes the last edit step
+    @return     bool    true if the document changed
+------------------------------------------------------------------------------*/
+bool IDEEditor::undo()
+{
+    IDEUndoJournal::CursorState cursor;
+    bool                        undone = false;
+
+    if ( isUserFlagSet( (uint32_t)EditorFlags::LargeFileMode ) == false && m_journal.undo( m_document, cursor ) )
+    {
+        restoreCursorState( cursor );
+        undone = true;
+    }
+    return undone;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      redoes the last edit step undone
+    @return     bool    true if the document changed
+------------------------------------------------------------------------------*/
+bool IDEEditor::redo()
+{
+    IDEUndoJournal::CursorState cursor;
+    bool                        redone = false;
+
+    if ( isUserFlagSet( (uint32_t)EditorFlags::LargeFileMode ) == false && m_journal.redo( m_document, cursor ) )
+    {
+        restoreCursorState( cursor );
+        redone = true;
+    }
+    return redone;
+}
+
 /**-----------------------------------------------------------------------------
     @ingroup    NimbleLIBIDE Nimble Library IDE Module
     @brief      process the keys presses
@@ -358,6 +845,8 @@ bool IDEEditor::processKeyEdit( uint32_t key )
 ------------------------------------------------------------------------------*/
 bool IDEEditor::processKeyViewOnly( uint32_t key )
 {
+    PROFILE_ZONE( "IDEEditor::processKeyViewOnly" );
+
     bool displayChanged = false;
 
     if ( key != ERR )
@@ -375,7 +864,7 @@ bool IDEEditor::processKeyViewOnly( uint32_t key )
             }
             case 258: // down
             {
-                if ( m_currentLine < m_editlines.size() - 1 )
+                if ( m_currentLine < getTotalLines() - 1 )
                 {
                     m_currentLine++;
                     displayChanged = true;
@@ -395,9 +884,9 @@ bool IDEEditor::processKeyViewOnly( uint32_t key )
             case 338: // page down
             {
                 m_currentLine += m_height;
-                if ( m_currentLine > m_editlines.size() - 1 )
+                if ( m_currentLine > getTotalLines() - 1 )
                 {
-                    m_currentLine = m_editlines.size() - 1;
+                    m_currentLine = getTotalLines() - 1;
                 }
                 displayChanged = true;
                 break;
@@ -439,13 +928,6 @@ bool IDEEditor::processDisplay()
     bool        displayChanged = false;
     std::string charStr        = " ";
 
-    // flash the cursor...
-    m_frameCount++;
-    if ( ( m_frameCount & 0x1f ) == 0 )
-    {
-        m_cursorDrawn = m_cursorDrawn ? false : true;
-    }
-
     mvwchgat( m_editorWin->getWindow(), m_oldCursorY + 1, m_oldCursorX + 1, 1, A_REVERSE, 0, nullptr );
 
     m_oldCursorX = m_cursorX;
@@ -461,6 +943,56 @@ bool IDEEditor::processDisplay()
     return displayChanged;
 }
 
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      saves the document over the file it was opened from, Ctrl+S
+    @return     LibraryError    error code
+-----------------------------------------------------------------------------*/
+LibraryError IDEEditor::save()
+{
+    std::string  filename = IDEFileHandler::getFilename();
+    LibraryError error    = saveFile( filename );
+
+    if ( error == LibraryError::No_Error )
+    {
+        m_files.setFileSynced( m_activeFile );
+    }
+    return error;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      appends the lines read since the last call while a file is
+                loading, called from the load timer. The new rows are drawn
+                by the next displayEditor()
+    @return     bool    true if lines were added
+-----------------------------------------------------------------------------*/
+bool IDEEditor::processLoad()
+{
+    PROFILE_ZONE( "IDEEditor::processLoad" );
+
+    uint32_t firstLine;
+    uint32_t linesAdded;
+
+    if ( pollLoad( LOAD_FRAME_BUDGET, firstLine, linesAdded ) == false )
+    {
+        return false;
+    }
+    m_syntax.linesChanged( firstLine, 1, 1 + linesAdded );
+    return true;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      flashes the cursor, called from the cursor blink timer. The
+                cursor is drawn by the next processDisplay()
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDEEditor::blinkCursor()
+{
+    m_cursorDrawn = m_cursorDrawn ? false : true;
+}
+
 /**-----------------------------------------------------------------------------
     @ingroup    NimbleLIBIDE Nimble Library IDE Module
     @brief      show the curses window
@@ -505,7 +1037,7 @@ bool IDEEditor::checkCursorKeys( uint32_t key )
             if ( m_cursorY > 0 )
             {
                 m_cursorY--;
-                if ( m_cursorX + m_currentColumn > m_editlines[ m_currentLine + m_cursorY ].length() )
+                if ( m_cursorX + m_currentColumn > m_document.getLineLength( m_currentLine + m_cursorY ) )
                     placeCursorinLine( m_currentLine );
                 displayChanged = true;
             }
@@ -514,7 +1046,7 @@ bool IDEEditor::checkCursorKeys( uint32_t key )
                 if ( m_currentLine > 0 )
                 {
                     m_currentLine--;
-                    if ( m_cursorX + m_currentColumn > m_editlines[ m_currentLine + m_cursorY ].length() )
+                    if ( m_cursorX + m_currentColumn > m_document.getLineLength( m_currentLine + m_cursorY ) )
                         placeCursorinLine( m_currentLine );
                     displayChanged = true;
                 }
@@ -525,20 +1057,20 @@ bool IDEEditor::checkCursorKeys( uint32_t key )
         {
             if ( m_cursorY < m_height - 2 )
             {
-                if ( m_cursorY + m_currentLine < m_editlines.size() - 1 )
+                if ( m_cursorY + m_currentLine < m_document.getLineCount() - 1 )
                 {
                     m_cursorY++;
-                    if ( m_cursorX + m_currentColumn > m_editlines[ m_currentLine + m_cursorY ].length() )
+                    if ( m_cursorX + m_currentColumn > m_document.getLineLength( m_currentLine + m_cursorY ) )
                         placeCursorinLine( m_currentLine );
                 }
                 displayChanged = true;
             }
             else
             {
-                if ( m_currentLine + m_cursorY < m_editlines.size() - 1 )
+                if ( m_currentLine + m_cursorY < m_document.getLineCount() - 1 )
                 {
                     m_currentLine++;
-                    if ( m_cursorX + m_currentColumn > m_editlines[ m_currentLine + m_cursorY ].length() )
+                    if ( m_cursorX + m_currentColumn > m_document.getLineLength( m_currentLine + m_cursorY ) )
                         placeCursorinLine( m_currentLine );
                     displayChanged = true;
                 }
@@ -568,7 +1100,7 @@ bool IDEEditor::checkCursorKeys( uint32_t key )
         {
             if ( m_cursorX < m_width - 3 )
             {
-                if ( m_cursorX < m_editlines[ m_currentLine + m_cursorY ].length() )
+                if ( m_cursorX < m_document.getLineLength( m_currentLine + m_cursorY ) )
                 {
                     m_cursorX++;
                     displayChanged = true;
@@ -612,10 +1144,9 @@ bool IDEEditor::checkEditKeys( uint32_t key )
             }
             else if ( m_currentLine + m_cursorY > 0 )
             {
-                m_cursorX = m_editlines[ m_currentLine + m_cursorY - 1 ].length();
-                m_editlines[ m_currentLine + m_cursorY - 1 ] += m_editlines[ m_currentLine + m_cursorY ];
-                m_editlines.erase( m_editlines.begin() + m_currentLine + m_cursorY );
-                m_editlineAttributes.erase( m_editlineAttributes.begin() + m_currentLine + m_cursorY );
+                m_cursorX = m_document.getLineLength( m_currentLine + m_cursorY - 1 );
+                joinLinesInEditor( m_currentLine + m_cursorY - 1 );
+                markRowsDirty( ( m_cursorY > 0 ) ? m_cursorY - 1 : 0, m_height - 1 );
                 m_cursorY--;
                 displayChanged = true;
             }
@@ -638,10 +1169,7 @@ bool IDEEditor::checkEditKeys( uint32_t key )
         {
             // spaces to add to string...
             uint32_t spaces = 4 - ( m_cursorX & 0x3 );
-            for ( uint32_t i = 0; i < spaces; i++ )
-            {
-                m_editlines[ m_currentLine + m_cursorY ].insert( m_cursorX, " " );
-            }
+            insertTextIntoEditor( m_cursorX, m_cursorY, std::string( spaces, ' ' ) );
             m_cursorX += spaces;
 
             if ( m_cursorX > m_width - 3 )
@@ -657,15 +1185,14 @@ bool IDEEditor::checkEditKeys( uint32_t key )
         }
         case 330: // delete
         {
-            if ( m_cursorX != m_editlines[ m_currentLine + m_cursorY ].length() && m_editlines[ m_currentLine + m_cursorY ].length() > 0 )
+            if ( m_cursorX != m_document.getLineLength( m_currentLine + m_cursorY ) && m_document.getLineLength( m_currentLine + m_cursorY ) > 0 )
             {
                 eraseCharFromEditor( m_cursorX, m_cursorY );
             }
-            else if ( m_currentLine + m_cursorY < m_editlines.size() - 1 )
+            else if ( m_currentLine + m_cursorY < m_document.getLineCount() - 1 )
             {
-                m_editlines[ m_currentLine + m_cursorY ] += m_editlines[ m_currentLine + m_cursorY + 1 ];
-                m_editlines.erase( m_editlines.begin() + m_currentLine + m_cursorY + 1 );
-                m_editlineAttributes.erase( m_editlineAttributes.begin() + m_currentLine + m_cursorY + 1 );
+                joinLinesInEditor( m_currentLine + m_cursorY );
+                markRowsDirty( m_cursorY, m_height - 1 );
             }
             displayChanged = true;
             break;
@@ -673,9 +1200,9 @@ bool IDEEditor::checkEditKeys( uint32_t key )
         case 338: // page down
         {
             m_currentLine += m_height - 2;
-            if ( m_currentLine + m_cursorY > m_editlines.size() - 1 )
+            if ( m_currentLine + m_cursorY > m_document.getLineCount() - 1 )
             {
-                m_currentLine = m_editlines.size() - 1 - m_cursorY;
+                m_currentLine = m_document.getLineCount() - 1 - m_cursorY;
             }
             placeCursorinLine( m_currentLine + m_cursorY );
             displayChanged = true;
@@ -701,12 +1228,12 @@ bool IDEEditor::checkEditKeys( uint32_t key )
         }
         case 358: // endKey:
         {
-            m_currentColumn = m_editlines[ m_currentLine + m_cursorY ].length() - m_width + 3;
+            m_currentColumn = m_document.getLineLength( m_currentLine + m_cursorY ) - m_width + 3;
             if ( m_currentColumn < 0 )
             {
                 m_currentColumn = 0;
             }
-            m_cursorX      = m_editlines[ m_currentLine + m_cursorY ].length() - m_currentColumn;
+            m_cursorX      = m_document.getLineLength( m_currentLine + m_cursorY ) - m_currentColumn;
             displayChanged = true;
             break;
         }
@@ -741,12 +1268,12 @@ uint8_t IDEEditor::getCharFromEditor( uint32_t x, uint32_t y )
 {
     uint8_t ch = ' ';
 
-    if ( ( y + m_currentLine ) <= m_editlines.size() - 1 )
+    if ( ( y + m_currentLine ) <= m_document.getLineCount() - 1 )
     {
         x += m_currentColumn;
-        if ( x < m_editlines[ m_currentLine + y ].length() )
+        if ( x < m_document.getLineLength( m_currentLine + y ) )
         {
-            ch = m_editlines[ m_currentLine + y ][ x ];
+            ch = m_document.getChar( m_currentLine + y, x );
         }
     }
     return ch;
@@ -762,22 +1289,41 @@ uint8_t IDEEditor::getCharFromEditor( uint32_t x, uint32_t y )
 -----------------------------------------------------------------------------*/
 void IDEEditor::insertCharIntoEditor( uint32_t x, uint32_t y, uint8_t ch )
 {
+    insertTextIntoEditor( x, y, std::string( 1, (char)ch ) );
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      inserts text into the editor, padding the line with spaces
+                if the position is past the end of the line
+    @param      x     x position
+    @param      y     y position
+    @param      text  text to insert
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDEEditor::insertTextIntoEditor( uint32_t x, uint32_t y, const std::string& text )
+{
+    markRowsDirty( y, y );
     x += m_currentColumn;
     y += m_currentLine;
 
-    if ( y < m_editlines.size() )
+    if ( y < m_document.getLineCount() )
     {
+        uint32_t    length   = m_document.getLineLength( y );
+        uint32_t    column   = std::min<uint32_t>( length, x );
+        std::string inserted = text;
+
         // pad with spaces if less then x position
-        if ( m_editlines[ y ].length() < x )
+        if ( length < x )
         {
-            uint32_t nCursorPos = m_editlines[ y ].length();
-            while ( nCursorPos <= x )
-            {
-                m_editlines[ y ].insert( nCursorPos, 1, ' ' );
-                nCursorPos++;
-            }
+            inserted.insert( 0, x - length, ' ' );
+        }
+        if ( m_document.insert( y, column, inserted ) == LibraryError::No_Error )
+        {
+            m_syntax.linesChanged( y, 1, 1 + (uint32_t)std::count( inserted.begin(), inserted.end(), '\n' ) );
+            m_journal.recordInsert( m_document.getLineOffset( y ) + column, inserted, m_editCursor );
+            m_documentEdited = true;
         }
-        m_editlines[ y ].insert( x, 1, ch );
     }
 }
 
@@ -790,14 +1336,21 @@ void IDEEditor::insertCharIntoEditor( uint32_t x, uint32_t y, uint8_t ch )
 ------------------------------------------------------------------------------*/
 void IDEEditor::eraseCharFromEditor( uint32_t x, uint32_t y )
 {
+    markRowsDirty( y, y );
     x += m_currentColumn;
     y += m_currentLine;
 
-    if ( y < m_editlines.size() )
+    if ( y < m_document.getLineCount() )
     {
-        if ( m_editlines[ y ].length() > x )
+        if ( m_document.getLineLength( y ) > x )
         {
-            m_editlines[ y ].erase( x, 1 );
+            std::string erased( 1, (char)m_document.getChar( y, x ) );
+            if ( m_document.erase( y, x, 1 ) == LibraryError::No_Error )
+            {
+                m_syntax.linesChanged( y, 1, 1 );
+                m_journal.recordErase( m_document.getLineOffset( y ) + x, erased, m_editCursor );
+                m_documentEdited = true;
+            }
         }
     }
 }
@@ -810,13 +1363,61 @@ void IDEEditor::eraseCharFromEditor( uint32_t x, uint32_t y )
 ------------------------------------------------------------------------------*/
 void IDEEditor::insertLineIntoEditor( uint32_t y )
 {
+    // the split line and every row below it change
+    markRowsDirty( ( y > 0 ) ? y - 1 : 0, m_height - 1 );
     y += m_currentLine;
-    std::string newText = m_editlines[ y - 1 ].substr( m_cursorX, m_editlines[ y - 1 ].length() - m_cursorX );
-    m_editlines[ y - 1 ].erase( m_cursorX, m_editlines[ y - 1 ].length() - m_cursorX );
-    m_editlines.insert( m_editlines.begin() + y, newText );
-    EditLineAttributes attr;
-    attr.clear();
-    m_editlineAttributes.insert( m_editlineAttributes.begin() + y, attr );
+    uint32_t column = std::min<uint32_t>( m_cursorX, m_document.getLineLength( y - 1 ) );
+    if ( splitDocumentLine( y - 1, column ) == LibraryError::No_Error )
+    {
+        m_syntax.linesChanged( y - 1, 1, 2 );
+        m_journal.recordInsert( m_document.getLineOffset( y - 1 ) + column, "\n", m_editCursor );
+        m_documentEdited = true;
+    }
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      hands the buffer being edited to m_files before switching
+                away from it. A file still loading is read to the end first,
+                a mapped large file has no buffer to keep
+    @return     void
+------------------------------------------------------------------------------*/
+void IDEEditor::stashBuffer()
+{
+    if ( m_activeFile == FileManager::NO_FILE )
+    {
+        return;
+    }
+    if ( isUserFlagSet( (uint32_t)EditorFlags::LargeFileMode ) )
+    {
+        m_files.releaseBuffer( m_activeFile );
+    }
+    else
+    {
+        while ( isLoading() )
+        {
+            processLoad();
+        }
+        m_files.storeBuffer( m_activeFile, m_document, m_journal, getCursorState(), isModified() );
+    }
+    m_activeFile = FileManager::NO_FILE;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      joins a document line with the line after it
+    @param      line  document line index
+    @return     void
+------------------------------------------------------------------------------*/
+void IDEEditor::joinLinesInEditor( uint32_t line )
+{
+    uint64_t offset = m_document.getLineOffset( line ) + m_document.getLineLength( line );
+    if ( joinDocumentLines( line ) == LibraryError::No_Error )
+    {
+        m_syntax.linesChanged( line, 2, 1 );
+        m_journal.recordErase( offset, "\n", m_editCursor );
+        m_documentEdited = true;
+    }
 }
 
 /**-----------------------------------------------------------------------------
@@ -829,13 +1430,13 @@ void IDEEditor::placeCursorinLine( uint32_t y )
 {
     y += m_cursorY;
 
-    if ( y < m_editlines.size() )
+    if ( y < m_document.getLineCount() )
     {
-        if ( m_cursorX > m_editlines[ y ].length() )
+        if ( m_cursorX > m_document.getLineLength( y ) )
         {
-            m_cursorX = m_editlines[ y ].length();
+            m_cursorX = m_document.getLineLength( y );
         }
-        m_currentColumn = m_editlines[ y ].length() - m_width + 3;
+        m_currentColumn = m_document.getLineLength( y ) - m_width + 3;
         if ( m_currentColumn < 0 )
         {
             m_currentColumn = 0;
@@ -843,6 +1444,35 @@ void IDEEditor::placeCursorinLine( uint32_t y )
     }
 }
 
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      places the cursor on a document line and column, scrolling
+                only as far as needed to show it
+    @param      line    document line
+    @param      column  document column
+    @return     void
+------------------------------------------------------------------------------*/
+void IDEEditor::placeCursorAt( uint32_t line, uint32_t column )
+{
+    uint32_t lastRow    = m_height - 3;
+    uint32_t lastColumn = m_width - 3;
+
+    if ( line < (uint32_t)m_currentLine )
+    {
+        m_currentLine = line;
+    }
+    else if ( line > m_currentLine + lastRow )
+    {
+        m_currentLine = line - lastRow;
+    }
+    if ( column < (uint32_t)m_currentColumn || column > m_currentColumn + lastColumn )
+    {
+        m_currentColumn = ( column > lastColumn ) ? column - lastColumn : 0;
+    }
+    m_cursorY = line - m_currentLine;
+    m_cursorX = column - m_currentColumn;
+}
+
 /**-----------------------------------------------------------------------------
     @ingroup    NimbleLIBIDE Nimble Library IDE Module
     @brief      moves the text right - 16 characters
@@ -850,23 +1480,23 @@ void IDEEditor::placeCursorinLine( uint32_t y )
 ------------------------------------------------------------------------------*/
 void IDEEditor::moveTextRight()
 {
-    // if ( m_cursorX != m_editlines[ m_currentLine + m_cursorY ].length() - m_currentColumn )
+    // if ( m_cursorX != m_document.getLineLength( m_currentLine + m_cursorY ) - m_currentColumn )
     {
         m_currentColumn += 16;
-        if ( m_currentColumn > m_editlines[ m_currentLine + m_cursorY ].length() - m_width + 3 )
+        if ( m_currentColumn > m_document.getLineLength( m_currentLine + m_cursorY ) - m_width + 3 )
         {
-            m_currentColumn = m_editlines[ m_currentLine + m_cursorY ].length() - m_width + 3;
+            m_currentColumn = m_document.getLineLength( m_currentLine + m_cursorY ) - m_width + 3;
         }
-        if ( m_cursorX + m_currentColumn > m_editlines[ m_currentLine + m_cursorY ].length() )
+        if ( m_cursorX + m_currentColumn > m_document.getLineLength( m_currentLine + m_cursorY ) )
         {
-            m_cursorX = m_editlines[ m_currentLine + m_cursorY ].length() - m_currentColumn;
+            m_cursorX = m_document.getLineLength( m_currentLine + m_cursorY ) - m_currentColumn;
         }
         else
         {
             m_cursorX -= 16;
-            if ( m_cursorX + m_currentColumn > m_editlines[ m_currentLine + m_cursorY ].length() )
+            if ( m_cursorX + m_currentColumn > m_document.getLineLength( m_currentLine + m_cursorY ) )
             {
-                m_cursorX = m_editlines[ m_currentLine + m_cursorY ].length() - m_currentColumn;
+                m_cursorX = m_document.getLineLength( m_currentLine + m_cursorY ) - m_currentColumn;
             }
         }
     }
@@ -880,8 +1510,11 @@ void IDEEditor::moveTextRight()
 ------------------------------------------------------------------------------*/
 void IDEEditor::updateHighlighting( uint32_t curline )
 {
-    int32_t nStart = (int32_t)m_editlineAttributes[ curline ].MarkStart - m_currentColumn;
-    int32_t nEnd   = (int32_t)m_editlineAttributes[ curline ].MarkEnd - m_currentColumn;
+    PROFILE_ZONE( "IDEEditor::updateHighlighting" );
+
+    EditLineAttributes attributes = getLineAttributes( curline + m_currentLine );
+    int32_t            nStart     = (int32_t)attributes.MarkStart - m_currentColumn;
+    int32_t            nEnd       = (int32_t)attributes.MarkEnd - m_currentColumn;
 
     if ( nStart < 0 )
     {
@@ -898,12 +1531,414 @@ void IDEEditor::updateHighlighting( uint32_t curline )
             }
             if ( ( nEnd - nStart ) > 0 )
             {
-                m_editorWin->displayHighlight( 0, curline, nStart, nEnd );
+                m_editorWin->displayHighlight( 1, curline + 1, nStart, nEnd );
             }
         }
     }
 }
 
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      colours the syntax tokens of the editor line just printed
+    @param      curline  current line
+    @param      line     text of the line
+    @return     void
+------------------------------------------------------------------------------*/
+void IDEEditor::updateSyntaxColours( uint32_t curline, std::string_view line )
+{
+    uint32_t firstColumn = m_currentColumn;
+    uint32_t lastColumn  = m_currentColumn + m_width - 2;
+
+    m_syntax.lexLine( line, m_syntax.getStartState( curline + m_currentLine ), &m_tokenRuns );
+    for ( const IDESyntax::TokenRun& run : m_tokenRuns )
+    {
+        uint32_t start = std::max( run.start, firstColumn );
+        uint32_t end   = std::min( run.start + run.length, lastColumn );
+        if ( start >= lastColumn )
+        {
+            break;
+        }
+        if ( end > start )
+        {
+            m_editorWin->displayColour( 1, curline + 1, start - firstColumn, end - firstColumn, TOKEN_COLOURS[(uint32_t)run.type] );
+        }
+    }
+}
+
+// undo / redo -----------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      returns the cursor and scroll position for the undo journal
+    @return     IDEUndoJournal::CursorState    cursor state
+------------------------------------------------------------------------------*/
+IDEUndoJournal::CursorState IDEEditor::getCursorState() const
+{
+    IDEUndoJournal::CursorState cursor;
+    cursor.currentLine   = m_currentLine;
+    cursor.currentColumn = m_currentColumn;
+    cursor.cursorX       = m_cursorX;
+    cursor.cursorY       = m_cursorY;
+    return cursor;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      puts back the cursor after an undo or redo and redraws the
+                view, marked text is cleared as its lines may have moved
+    @param      cursor  cursor state from the journal
+    @return     void
+------------------------------------------------------------------------------*/
+void IDEEditor::restoreCursorState( const IDEUndoJournal::CursorState& cursor )
+{
+    m_currentLine   = cursor.currentLine;
+    m_currentColumn = cursor.currentColumn;
+    m_cursorX       = cursor.cursorX;
+    m_cursorY       = cursor.cursorY;
+
+    m_editlineAttributes.clear();
+    clearUserFlag( (uint32_t)EditorFlags::MarkedTextActive );
+    markRowsDirty( 0, m_height - 1 );
+    m_syntax.clear();
+    m_matchOffset = IDESearch::NOT_FOUND;
+    updateEditFlags();
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      sets the Undo, Redo, Find and Replace file handler flags
+    @return     void
+------------------------------------------------------------------------------*/
+void IDEEditor::updateEditFlags()
+{
+    uint32_t searchFlags = (uint32_t)FileHandlerFlags::Find | (uint32_t)FileHandlerFlags::FindNext | (uint32_t)FileHandlerFlags::FindPrevious | (uint32_t)FileHandlerFlags::Replace;
+    uint32_t flags       = getFlags() & ~( (uint32_t)FileHandlerFlags::Undo | (uint32_t)FileHandlerFlags::Redo | searchFlags );
+
+    if ( m_journal.canUndo() )
+    {
+        flags |= (uint32_t)FileHandlerFlags::Undo;
+    }
+    if ( m_journal.canRedo() )
+    {
+        flags |= (uint32_t)FileHandlerFlags::Redo;
+    }
+    if ( isUserFlagSet( (uint32_t)EditorFlags::LargeFileMode ) == false )
+    {
+        flags |= (uint32_t)FileHandlerFlags::Find;
+        if ( m_search.getPattern().empty() == false )
+        {
+            flags |= (uint32_t)FileHandlerFlags::FindNext | (uint32_t)FileHandlerFlags::FindPrevious;
+        }
+        if ( m_matchOffset != IDESearch::NOT_FOUND )
+        {
+            flags |= (uint32_t)FileHandlerFlags::Replace;
+        }
+    }
+    setFlags( flags );
+}
+
+// find / replace --------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      returns the document offset of the cursor, clamped to the
+                end of the line
+    @return     uint64_t    document offset
+------------------------------------------------------------------------------*/
+uint64_t IDEEditor::getCursorOffset() const
+{
+    uint32_t line   = m_currentLine + m_cursorY;
+    uint32_t column = std::min<uint32_t>( m_currentColumn + m_cursorX, m_document.getLineLength( line ) );
+    return m_document.getLineOffset( line ) + column;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      returns the pieces of the document for searching, taken
+                again for every search as an edit can move them
+    @return     const std::vector<std::string_view>&    document pieces
+------------------------------------------------------------------------------*/
+const std::vector<std::string_view>& IDEEditor::getSearchSpans()
+{
+    m_document.getSpans( m_searchSpans );
+    return m_searchSpans;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      marks a match, scrolls it into view and puts the cursor on it
+    @param      offset  document offset of the match
+    @return     void
+------------------------------------------------------------------------------*/
+void IDEEditor::showMatch( uint64_t offset )
+{
+    uint32_t line      = m_document.getLineAt( offset );
+    uint32_t column    = (uint32_t)( offset - m_document.getLineOffset( line ) );
+    uint32_t length    = (uint32_t)m_search.getPattern().size();
+    uint32_t rows      = m_height - 2;
+    uint32_t columns   = m_width - 3;
+    uint32_t markStart = std::min<uint32_t>( column, UINT16_MAX );
+    uint32_t markEnd   = std::min<uint32_t>( std::min( column + length, m_document.getLineLength( line ) ), UINT16_MAX );
+
+    // the match is the only marked text, a match over lines marks the first
+    m_editlineAttributes.clear();
+    m_editlineAttributes[line].MarkStart = (uint16_t)markStart;
+    m_editlineAttributes[line].MarkEnd   = (uint16_t)markEnd;
+    setUserFlag( (uint32_t)EditorFlags::MarkedTextActive );
+
+    // scroll so the match is in view, centred if it was off screen
+    if ( line < (uint32_t)m_currentLine || line > m_currentLine + rows )
+    {
+        m_currentLine = ( line > rows / 2 ) ? line - rows / 2 : 0;
+    }
+    if ( column < (uint32_t)m_currentColumn || column + length > m_currentColumn + columns )
+    {
+        m_currentColumn = ( column + length > columns ) ? std::min( column, column + length - columns ) : 0;
+    }
+    m_cursorY     = line - m_currentLine;
+    m_cursorX     = column - m_currentColumn;
+    m_matchOffset = offset;
+
+    markRowsDirty( 0, m_height - 1 );
+    m_journal.closeStep();
+    updateEditFlags();
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      removes the match marking
+    @return     void
+------------------------------------------------------------------------------*/
+void IDEEditor::clearMatch()
+{
+    m_editlineAttributes.clear();
+    clearUserFlag( (uint32_t)EditorFlags::MarkedTextActive );
+    m_matchOffset = IDESearch::NOT_FOUND;
+    markRowsDirty( 0, m_height - 1 );
+    updateEditFlags();
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      returns the word the cursor is in or just after
+    @return     std::string     word, empty if there is none
+------------------------------------------------------------------------------*/
+std::string IDEEditor::getWordAtCursor() const
+{
+    std::string line   = m_document.getLine( m_currentLine + m_cursorY );
+    uint32_t    column = std::min<uint32_t>( m_currentColumn + m_cursorX, line.length() );
+    uint32_t    start  = column;
+    uint32_t    end    = column;
+
+    auto isWordChar = []( char ch ) { return isalnum( (uint8_t)ch ) || ch == '_'; };
+    while ( start > 0 && isWordChar( line[start - 1] ) )
+    {
+        start--;
+    }
+    while ( end < line.length() && isWordChar( line[end] ) )
+    {
+        end++;
+    }
+    return line.substr( start, end - start );
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      sets the text to find and shows the first match at or after
+                the cursor
+    @param      pattern     text to find
+    @param      matchCase   true if the case must match
+    @param      wholeWord   true to only match whole words
+    @return     bool        true if a match was found
+------------------------------------------------------------------------------*/
+bool IDEEditor::find( const std::string& pattern, bool matchCase, bool wholeWord )
+{
+    m_search.setPattern( pattern, matchCase, wholeWord );
+    m_matchOffset = IDESearch::NOT_FOUND;
+    if ( isUserFlagSet( (uint32_t)EditorFlags::LargeFileMode ) )
+    {
+        return false;
+    }
+
+    const std::vector<std::string_view>& spans  = getSearchSpans();
+    uint64_t                             offset = m_search.findNext( spans, getCursorOffset() );
+    if ( offset == IDESearch::NOT_FOUND )
+    {
+        offset = m_search.findNext( spans, 0 );
+    }
+
+    if ( offset == IDESearch::NOT_FOUND )
+    {
+        clearMatch();
+        return false;
+    }
+    showMatch( offset );
+    return true;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      shows the next match after the cursor, wrapping to the start
+    @return     bool    true if a match was found
+------------------------------------------------------------------------------*/
+bool IDEEditor::findNext()
+{
+    if ( m_search.getPattern().empty() || isUserFlagSet( (uint32_t)EditorFlags::LargeFileMode ) )
+    {
+        return false;
+    }
+
+    const std::vector<std::string_view>& spans  = getSearchSpans();
+    uint64_t                             from   = getCursorOffset();
+    uint64_t                             offset = m_search.findNext( spans, ( from == m_matchOffset ) ? from + 1 : from );
+    if ( offset == IDESearch::NOT_FOUND )
+    {
+        offset = m_search.findNext( spans, 0 );
+    }
+
+    if ( offset == IDESearch::NOT_FOUND )
+    {
+        clearMatch();
+        return false;
+    }
+    showMatch( offset );
+    return true;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      shows the match before the cursor, wrapping to the end
+    @return     bool    true if a match was found
+------------------------------------------------------------------------------*/
+bool IDEEditor::findPrevious()
+{
+    if ( m_search.getPattern().empty() || isUserFlagSet( (uint32_t)EditorFlags::LargeFileMode ) )
+    {
+        return false;
+    }
+
+    const std::vector<std::string_view>& spans  = getSearchSpans();
+    uint64_t                             offset = m_search.findPrevious( spans, getCursorOffset() );
+    if ( offset == IDESearch::NOT_FOUND )
+    {
+        offset = m_search.findPrevious( spans, m_document.getLength() );
+    }
+
+    if ( offset == IDESearch::NOT_FOUND )
+    {
+        clearMatch();
+        return false;
+    }
+    showMatch( offset );
+    return true;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      replaces the match shown and shows the next one
+    @param      replacement text to put in place of the match
+    @return     bool    true if the match was replaced
+------------------------------------------------------------------------------*/
+bool IDEEditor::replace( const std::string& replacement )
+{
+    if ( m_matchOffset == IDESearch::NOT_FOUND || isUserFlagSet( (uint32_t)EditorFlags::LargeFileMode ) )
+    {
+        return false;
+    }
+
+    // the match may have been moved off since it was shown
+    uint64_t offset = m_matchOffset;
+    if ( m_search.findNext( getSearchSpans(), offset ) != offset )
+    {
+        clearMatch();
+        return false;
+    }
+
+    IDEUndoJournal::CursorState before  = getCursorState();
+    std::string                 matched = m_document.getText( offset, m_search.getPattern().size() );
+    uint32_t                    line    = m_document.getLineAt( offset );
+    m_syntax.linesChanged( line, 1 + (uint32_t)std::count( matched.begin(), matched.end(), '\n' ), 1 + (uint32_t)std::count( replacement.begin(), replacement.end(), '\n' ) );
+    m_journal.beginGroup();
+    m_document.eraseAt( offset, matched.size() );
+    m_journal.recordErase( offset, matched, before );
+    m_document.insertAt( offset, replacement );
+    m_journal.recordInsert( offset, replacement, before );
+    m_journal.endGroup();
+
+    // carry on from the end of the replacement
+    const std::vector<std::string_view>& spans = getSearchSpans();
+    uint64_t                             next  = m_search.findNext( spans, offset + replacement.size() );
+    if ( next == IDESearch::NOT_FOUND )
+    {
+        next = m_search.findNext( spans, 0 );
+    }
+
+    if ( next == IDESearch::NOT_FOUND )
+    {
+        clearMatch();
+    }
+    else
+    {
+        showMatch( next );
+    }
+    m_journal.setCursorAfter( getCursorState() );
+    return true;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      replaces every match as one undo step, nothing is replaced
+                if the step would not fit the undo budget
+    @param      replacement text to put in place of each match
+    @return     uint64_t    number of matches replaced
+------------------------------------------------------------------------------*/
+uint64_t IDEEditor::replaceAll( const std::string& replacement )
+{
+    std::vector<uint64_t> matches;
+
+    if ( m_search.getPattern().empty() || isUserFlagSet( (uint32_t)EditorFlags::LargeFileMode ) )
+    {
+        return 0;
+    }
+
+    uint64_t count  = m_search.findAll( getSearchSpans(), matches );
+    uint64_t length = m_search.getPattern().size();
+    if ( count == 0 )
+    {
+        return 0;
+    }
+    if ( m_journal.canRecordStep( count * 2, count * ( length + replacement.size() ) ) == false )
+    {
+        ErrorHandler::getInstance().handleError( ErrorType::Warning, LibraryError::IDEEditor_ReplaceNotUndoable, "IDEEditor::replaceAll() : " + std::to_string( count ) + " matches are more than the undo budget holds, nothing was replaced" );
+        return 0;
+    }
+
+    // last match first, the offsets of the matches before it still hold
+    IDEUndoJournal::CursorState before = getCursorState();
+    m_journal.beginGroup();
+    for ( auto match = matches.rbegin(); match != matches.rend(); ++match )
+    {
+        std::string matched = m_document.getText( *match, length );
+        m_document.eraseAt( *match, length );
+        m_journal.recordErase( *match, matched, before );
+        m_document.insertAt( *match, replacement );
+        m_journal.recordInsert( *match, replacement, before );
+    }
+    m_journal.endGroup();
+    m_syntax.clear();
+
+    // the cursor stays on its line, moved back if the line is now shorter
+    if ( m_currentLine + m_cursorY >= m_document.getLineCount() )
+    {
+        m_currentLine = 0;
+        m_cursorY     = 0;
+    }
+    placeCursorinLine( m_currentLine );
+    clearMatch();
+    m_journal.setCursorAfter( getCursorState() );
+    return count;
+}
+
 //-----------------------------------------------------------------------------
 
 } // namespace Nimble
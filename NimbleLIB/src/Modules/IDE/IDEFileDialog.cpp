@@ -8,6 +8,21 @@
 
 Notes:
 
+    The directory is read by the DirectoryScanner, on a thread of its own,
+    and the entries are added to the list as they arrive, a frame at a
+    time, so a large or slow directory never freezes the dialog. Each
+    arrival is sorted and merged into the list, which is kept sorted, and
+    the cursor stays on the entry it was on. Reading a directory read
+    before is instant while it has not changed.
+
+    The list is shown by an IDEListView, which asks for the text of only
+    the rows on screen and paints only the rows that change, so scrolling
+    costs the same in a directory of ten files as in one of a hundred
+    thousand. Typing filters the list, the names holding the typed
+    characters in order are shown best match first, backspace takes the
+    last character off. The names are given to the IDEFuzzyFilter once,
+    when the filter is first used after the list has changed.
+
 -----------------------------------------------------------------------------*/
 //-----------------------------------------------------------------------------
 // Include files
@@ -16,6 +31,7 @@ Notes:
 #include <cstdint>
 #include <filesystem>
 #include <algorithm>
+#include <numeric>
 #include "../../../inc/Modules/ErrorHandling/ErrorHandler.h"
 #include "../../../inc/Modules/Curses/CursesColour.h"
 #include "../../../inc/Modules/Curses/CursesKeyboard.h"
@@ -41,10 +57,9 @@ namespace Nimble
 ----------------------------------------------------------------------------*/
 IDEFileDialog::IDEFileDialog()
 {
-    m_cursorPos    = 4;
-    m_cancelled    = false;
-    m_completed    = false;
-    m_fileStartPos = 0;
+    m_cancelled     = false;
+    m_completed     = false;
+    m_filterChanged = true;
 }
 
 /**----------------------------------------------------------------------------
@@ -54,6 +69,7 @@ IDEFileDialog::IDEFileDialog()
 ----------------------------------------------------------------------------*/
 IDEFileDialog::~IDEFileDialog()
 {
+    DirectoryScanner::getInstance().cancel();
 }
 
 // Initialisation -------------------------------------------------------------
@@ -83,10 +99,26 @@ LibraryError IDEFileDialog::initLoader( const std::string& path, const std::stri
     title( m_titleDialog );
     status( statusString );
 
+    m_listView.init( getWindow(), 3, 3, 52, getHeight() - 9, COLOUR_INDEX( IDE_COL_FG_BLACK, IDE_COL_BG_WHITE ),
+                     std::bind( &IDEFileDialog::getRow, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3 ) );
+    m_listView.setItemCount( (uint32_t)m_visible.size() );
+
+    // every printable character, and backspace, goes to the filter
+    m_keyMapFilterControl.keys = { 8, 127, KEY_BACKSPACE };
+    for ( uint32_t key = ' '; key <= '~'; key++ )
+    {
+        m_keyMapFilterControl.keys.push_back( key );
+    }
+
     addKeyMap( m_keyMapCursorControl );
     addKeyMap( m_keyMapDialogControl );
+    addKeyMap( m_keyMapFilterControl );
 
     buttons( getWindow(), "Cancel", "Load" );
+    if ( DirectoryScanner::getInstance().isScanning() )
+    {
+        status( "Reading directory..." );
+    }
     return error;
 }
 
@@ -100,47 +132,13 @@ LibraryError IDEFileDialog::initLoader( const std::string& path, const std::stri
 LibraryError IDEFileDialog::drawLoader()
 {
     LibraryError error = LibraryError::No_Error;
+    uint32_t     count = m_listView.getItemCount();
+
     // Draw the dialog
+    setVerticalScrollPos( ( count > 1 ) ? ( m_listView.getCursor() * 100 ) / ( count - 1 ) : 0 );
     drawDialog();
-    // Draw the files in the directory
-    uint32_t    yPos      = 3;
-    uint32_t    fileCount = 0;
-    std::string nameStr   = "";
-    for ( const auto& entry : m_filesInDirectory )
-    {
-        if ( fileCount++ < m_fileStartPos )
-            continue;
-
-        if ( yPos < ( getHeight() - 6 ) )
-        {
-            nameStr = entry.name;
-            nameStr.resize( 52, ' ' );
-
-            mvwaddstr( getWindow(), yPos, 3, nameStr.c_str() );
-
-            if ( entry.name == ".." )
-            {
-                mvwchgat( getWindow(), yPos, 3, 52, A_NORMAL, COLOUR_INDEX( IDE_COL_FG_BLUE, IDE_COL_BG_WHITE ), nullptr );
-            }
-            else
-            {
-                if ( entry.type == FileType::Directory )
-                {
-                    mvwchgat( getWindow(), yPos, 3, 52, A_NORMAL, COLOUR_INDEX( IDE_COL_FG_BLUE, IDE_COL_BG_WHITE ), nullptr );
-                }
-                else
-                {
-                    mvwchgat( getWindow(), yPos, 3, 52, A_NORMAL, COLOUR_INDEX( IDE_COL_FG_BLACK, IDE_COL_BG_WHITE ), nullptr );
-                }
-            }
-        }
-        else
-        {
-            break;
-        }
-        yPos++;
-    }
-    drawCursor();
+    // Draw the rows of files that have changed, with the cursor
+    m_listView.draw( COLOUR_INDEX( IDE_COL_FG_WHITE, IDE_COL_BG_BLACK ) );
     draw();
     refresh();
     return error;
@@ -156,7 +154,10 @@ LibraryError IDEFileDialog::processKeyPress( uint32_t ch )
 {
     LibraryError error = LibraryError::No_Error;
 
+    // entries read since the last frame
+    pollDirectory();
     processDialog( ch );
+    updateStatus();
     // check the button presses by the mouse...
     if ( isLeftButtonPressed() )
     {
@@ -166,20 +167,15 @@ LibraryError IDEFileDialog::processKeyPress( uint32_t ch )
     {
         m_completed = true;
     }
+    // the file under the cursor is the one chosen
+    if ( m_completed && m_visible.empty() == false )
+    {
+        m_filename = m_filesInDirectory[m_visible[m_listView.getCursor()]].name;
+    }
 
     return error;
 }
 
-/**----------------------------------------------------------------------------
-    @ingroup    NimbleLIBIDE Nimble Library IDE Module
-    @brief      Draw the File cursor
-    @return     void
-----------------------------------------------------------------------------*/
-void IDEFileDialog::drawCursor()
-{
-    mvwchgat( getWindow(), m_cursorPos + 3, 3, 52, A_NORMAL, COLOUR_INDEX( IDE_COL_FG_WHITE, IDE_COL_BG_BLACK ), nullptr );
-}
-
 // Control --------------------------------------------------------------------
 
 /**----------------------------------------------------------------------------
@@ -194,35 +190,32 @@ void IDEFileDialog::cursorControl( uint32_t ch )
     {
         case KEY_UP:
         {
-
-            if ( m_cursorPos == 0 && m_fileStartPos > 0 )
-            {
-                m_fileStartPos--;
-            }
-            else if ( m_cursorPos > 0 )
-            {
-                mvwchgat( getWindow(), m_cursorPos + 3, 3, 52, A_NORMAL, COLOUR_INDEX( IDE_COL_FG_BLACK, IDE_COL_BG_WHITE ), nullptr );
-                m_cursorPos--;
-                drawCursor();
-            }
-            setVerticalScrollPos( ( (float)( m_fileStartPos + m_cursorPos ) / (float)m_filesInDirectory.size() ) * 100 );
+            m_listView.moveCursor( -1 );
             break;
         }
         case KEY_DOWN:
         {
-            if ( m_cursorPos < ( getHeight() - 10 ) )
-            {
-                mvwchgat( getWindow(), m_cursorPos + 3, 3, 52, A_NORMAL, COLOUR_INDEX( IDE_COL_FG_BLACK, IDE_COL_BG_WHITE ), nullptr );
-                if ( m_cursorPos < m_filesInDirectory.size() )
-                    m_cursorPos++;
-                drawCursor();
-            }
-            else
-            {
-                if ( m_cursorPos + m_fileStartPos < m_filesInDirectory.size() - 1 )
-                    m_fileStartPos++;
-            }
-            setVerticalScrollPos( ( (float)( m_fileStartPos + m_cursorPos ) / (float)m_filesInDirectory.size() ) * 100 );
+            m_listView.moveCursor( 1 );
+            break;
+        }
+        case KEY_PPAGE:
+        {
+            m_listView.moveCursor( -(int32_t)m_listView.getRows() );
+            break;
+        }
+        case KEY_NPAGE:
+        {
+            m_listView.moveCursor( (int32_t)m_listView.getRows() );
+            break;
+        }
+        case KEY_HOME:
+        {
+            m_listView.setCursor( 0 );
+            break;
+        }
+        case KEY_END:
+        {
+            m_listView.setCursor( ( m_listView.getItemCount() > 0 ) ? m_listView.getItemCount() - 1 : 0 );
             break;
         }
         default:
@@ -249,6 +242,7 @@ void IDEFileDialog::dialogControl( uint32_t ch )
             break;
         }
         case KEY_ENTER:
+        case '\n':
         {
             m_completed = true;
             break;
@@ -260,6 +254,119 @@ void IDEFileDialog::dialogControl( uint32_t ch )
     }
 }
 
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Adds a typed character to the filter, or takes the last one
+                off for backspace, the best match is put under the cursor
+    @param      ch  Character to process
+    @return     void
+----------------------------------------------------------------------------*/
+void IDEFileDialog::filterControl( uint32_t ch )
+{
+    if ( ch == 8 || ch == 127 || ch == KEY_BACKSPACE )
+    {
+        if ( m_query.empty() )
+        {
+            return;
+        }
+        m_query.pop_back();
+    }
+    else if ( m_query.size() < m_kMaxFilter )
+    {
+        m_query += (char)ch;
+    }
+    else
+    {
+        return;
+    }
+    applyFilter();
+    m_listView.setCursor( 0 );
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Sets the files shown, every file in order without a filter,
+                the files matching it best first with one
+    @return     void
+----------------------------------------------------------------------------*/
+void IDEFileDialog::applyFilter()
+{
+    if ( m_query.empty() )
+    {
+        m_visible.resize( m_filesInDirectory.size() );
+        std::iota( m_visible.begin(), m_visible.end(), 0 );
+    }
+    else
+    {
+        if ( m_filterChanged )
+        {
+            m_filter.clear();
+            for ( const auto& entry : m_filesInDirectory )
+            {
+                m_filter.addItem( entry.name );
+            }
+            m_filterChanged = false;
+        }
+        const auto& matches = m_filter.filter( m_query );
+        m_visible.resize( matches.size() );
+        for ( size_t index = 0; index < matches.size(); index++ )
+        {
+            m_visible[index] = matches[index].item;
+        }
+    }
+    m_listView.setItemCount( (uint32_t)m_visible.size() );
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Gets a row of the list, directories are shown in blue
+    @param      item    row of the list
+    @param      text    set to the name of the file
+    @param      colour  set to the colour of the row
+    @return     void
+----------------------------------------------------------------------------*/
+void IDEFileDialog::getRow( uint32_t item, std::string& text, uint32_t& colour ) const
+{
+    const FileData& entry = m_filesInDirectory[m_visible[item]];
+
+    text.assign( entry.name );
+    if ( entry.type == FileType::Directory )
+    {
+        colour = COLOUR_INDEX( IDE_COL_FG_BLUE, IDE_COL_BG_WHITE );
+    }
+    else
+    {
+        colour = COLOUR_INDEX( IDE_COL_FG_BLACK, IDE_COL_BG_WHITE );
+    }
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Shows the filter in the status bar, or what the dialog is
+                doing when there is none
+    @return     void
+----------------------------------------------------------------------------*/
+void IDEFileDialog::updateStatus()
+{
+    std::string statusString;
+
+    if ( m_query.empty() == false )
+    {
+        statusString = "Filter: " + m_query + " (" + std::to_string( m_visible.size() ) + " matches)";
+    }
+    else if ( DirectoryScanner::getInstance().isScanning() )
+    {
+        statusString = "Reading directory...";
+    }
+    else
+    {
+        statusString = "Select file to load";
+    }
+    // the status bar is not cleared, so a shorter string covers the last
+    statusString.resize( getWidth() - 4, ' ' );
+    status( statusString );
+}
+
 // Getters --------------------------------------------------------------------
 
 /**----------------------------------------------------------------------------
@@ -306,8 +413,9 @@ const bool IDEFileDialog::isCancelled() const
 
 /**----------------------------------------------------------------------------
     @ingroup    NimbleLIBIDE Nimble Library IDE Module
-    @brief      Read the directory, sorting the results alphabetically
-    @param      path    Path to the file
+    @brief      Read the directory, in the background, the entries are added
+                sorted alphabetically as they arrive
+    @param      path    Path of the directory
     @return     LibraryError
 ----------------------------------------------------------------------------*/
 LibraryError IDEFileDialog::readDirectory( const std::string& path )
@@ -317,49 +425,78 @@ LibraryError IDEFileDialog::readDirectory( const std::string& path )
     fileData.type = FileType::Directory;
     fileData.name = "..";
 
-#if ( _WIN32_ )
-    std::filesystem::path currentPath = "c:/";
-#else
-    std::filesystem::path currentPath = "/";
-#endif
+    m_path = path;
     m_filesInDirectory.clear();
     m_filesInDirectory.push_back( fileData );
+    m_filterChanged = true;
+
+    // setup the dialog, with new file list
+    applyFilter();
+    m_listView.setCursor( 0 );
+
+    DirectoryScanner::getInstance().scan( path );
+    pollDirectory();
+    return error;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Adds the entries read since the last call, keeping the list
+                sorted and the cursor on the entry it was on
+    @return     bool    true if entries were added
+----------------------------------------------------------------------------*/
+bool IDEFileDialog::pollDirectory()
+{
+    std::vector<DirectoryEntry> entries;
+
+    if ( DirectoryScanner::getInstance().poll( entries ) == false )
+    {
+        return false;
+    }
 
-    // Read the directory, storing the files and directories
-    for ( const auto& entry : std::filesystem::directory_iterator( currentPath ) )
+    size_t   selected = m_visible.empty() ? 0 : m_visible[m_listView.getCursor()];
+    FileData current  = m_filesInDirectory[selected];
+    size_t   middle   = m_filesInDirectory.size();
+    for ( auto& entry : entries )
     {
         // special case for system files and directories that mess up the sort, and are not needed.
-        if ( entry.path().filename().string()[ 0 ] == '$' )
+        if ( entry.name.empty() || entry.name[0] == '$' )
         {
             continue;
         }
-        if ( entry.is_directory() )
-        {
-            fileData.type = FileType::Directory;
-        }
-        else
-        {
-            fileData.type = FileType::File;
-        }
-        fileData.name = entry.path().filename().string();
-        m_filesInDirectory.push_back( fileData );
+        m_filesInDirectory.push_back( { entry.directory ? FileType::Directory : FileType::File, std::move( entry.name ) } );
     }
 
-    // Sort the files and directories alphabetically (directories first)
-    std::sort( m_filesInDirectory.begin(), m_filesInDirectory.end(),
-               []( const FileData& a, const FileData& b ) -> bool
-               {
-                   if ( a.type != b.type )
-                   {
-                       return a.type < b.type;
-                   }
-                   return a.name < b.name;
-               } );
+    // Sort the new files and directories, then merge them in (directories first), ".." stays first
+    std::sort( m_filesInDirectory.begin() + middle, m_filesInDirectory.end(), isBefore );
+    std::inplace_merge( m_filesInDirectory.begin() + 1, m_filesInDirectory.begin() + middle, m_filesInDirectory.end(), isBefore );
 
-    // setup the dialog, with new file list
-    m_cursorPos    = 0;
-    m_fileStartPos = 0;
-    return error;
+    m_filterChanged = true;
+    applyFilter();
+
+    // entries merged in above the cursor move the view down with it, a filtered list is ranked afresh
+    if ( m_query.empty() && selected > 0 )
+    {
+        size_t moved = std::lower_bound( m_filesInDirectory.begin() + 1, m_filesInDirectory.end(), current, isBefore ) - m_filesInDirectory.begin();
+        m_listView.setCursor( (uint32_t)moved );
+    }
+    return true;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Order of the list, directories first then alphabetically
+    @param      first   entry
+    @param      second  entry
+    @return     bool    true if first is listed before second
+----------------------------------------------------------------------------*/
+bool IDEFileDialog::isBefore( const FileData& first, const FileData& second )
+{
+    if ( first.type != second.type )
+    {
+        return first.type < second.type;
+    }
+    return first.name < second.name;
 }
 
 //-----------------------------------------------------------------------------
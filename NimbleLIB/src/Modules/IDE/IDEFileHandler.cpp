@@ -8,6 +8,28 @@
 
 Notes:
 
+    The document is held in an IDEPieceTable (m_document), so line inserts
+    and joins do not move the lines that follow. Line attributes are kept
+    sparsely, keyed by line, so only lines that carry a mark are stored and
+    renumbered when lines are added or removed.
+
+    Files of LARGE_FILE_SIZE or more can be opened with openLargeFile(),
+    the file is then memory mapped (m_largeFile) rather than read, and is
+    view only. The document is left empty.
+
+    saveFile() hands the pieces of the document to an AtomicFileWriter as
+    they are, so a save is a few large gathered writes to a temporary file
+    that is then renamed over the target. The text keeps the line endings
+    it was loaded with, and ends with a newline only if the file did.
+
+    Other files are read by an IDEFileLoader thread, openFile() returns
+    once the reader has started and the document fills as pollLoad() is
+    called each frame. saveFile() is refused until the whole file is in.
+
+    isModified() compares the document's edit count with its count when it
+    last matched the file, the lines appended by the loader are counted as
+    matching. restoreDocument() takes a document the editor has put back in
+    m_document, from the FileManager, in place of opening the file.
 
 -----------------------------------------------------------------------------*/
 
@@ -16,6 +38,7 @@ Notes:
 // ----------------------------------------------------------------------------
 
 #include "../../../inc/Modules/IDE/IDEFileHandler.h"
+#include "../../../inc/Modules/Utilities/Profiler.h"
 #include <cstdint>
 
 //-----------------------------------------------------------------------------
@@ -38,6 +61,8 @@ namespace Nimble
 ------------------------------------------------------------------------------*/
 IDEFileHandler::IDEFileHandler()
 {
+    m_flags          = (uint32_t)FileHandlerFlags::None;
+    m_savedEditCount = 0;
 }
 
 /**-----------------------------------------------------------------------------
@@ -71,6 +96,47 @@ std::string IDEFileHandler::getStatus()
     return m_status;
 }
 
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      retrieve the name of the file last opened or saved
+    @return     const std::string&   filename
+------------------------------------------------------------------------------*/
+const std::string& IDEFileHandler::getFilename() const
+{
+    return m_filename;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      check if the file opened is still being read in
+    @return     bool    true while lines are still to be appended
+------------------------------------------------------------------------------*/
+bool IDEFileHandler::isLoading() const
+{
+    return m_loader.isLoading();
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      checks if the document has been edited since it was opened
+                or saved
+    @return     bool    true if the document differs from the file
+------------------------------------------------------------------------------*/
+bool IDEFileHandler::isModified() const
+{
+    return m_document.getEditCount() != m_savedEditCount;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      retrieve how much of the file opened has been read in
+    @return     uint32_t    percentage loaded
+------------------------------------------------------------------------------*/
+uint32_t IDEFileHandler::getLoadProgress() const
+{
+    return m_loader.getProgress();
+}
+
 // setters ---------------------------------------------------------------------
 
 /**-----------------------------------------------------------------------------
@@ -105,36 +171,80 @@ void IDEFileHandler::setStatus( std::string status )
 ------------------------------------------------------------------------------*/
 LibraryError IDEFileHandler::openFile( std::string& filename )
 {
-    LibraryError error = LibraryError::No_Error;
+    PROFILE_ZONE( "IDEFileHandler::openFile" );
 
-    // open the file
-    m_fileIn.open( filename );
-    if ( !m_fileIn.is_open() )
+    // start reading the file, the lines are appended by pollLoad()
+    LibraryError error = m_loader.open( filename );
+
+    if ( error != LibraryError::No_Error )
     {
         error = LibraryError::IDEFileHandler_FailedToOpenFile;
     }
     else
     {
         // prep for the file read
-        m_editlines.clear();
         m_editlineAttributes.clear();
+        m_largeFile.close();
+        m_document.clear();
+        m_savedEditCount = m_document.getEditCount();
 
         m_filename = filename;
         m_status   = "File Opened : ";
         m_status += m_filename;
+        m_flags |= (uint32_t)FileHandlerFlags::Open;
+        m_flags &= ~(uint32_t)FileHandlerFlags::Save;
+    }
 
-        // read the file
-        std::string line;
-        while ( getline( m_fileIn, line ) )
-        {
-            EditLineAttributes lineAttributes;
-            lineAttributes.clear();
-            m_editlines.push_back( line );
-            m_editlineAttributes.push_back( lineAttributes );
-        }
-        m_fileIn.close();
+    return error;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      append the lines read since the last call to the document
+    @param      byteBudget  bytes to append at most
+    @param      firstLine   set to the line the text was appended to
+    @param      linesAdded  set to the number of lines added after it
+    @return     bool    true if the document changed
+------------------------------------------------------------------------------*/
+bool IDEFileHandler::pollLoad( uint64_t byteBudget, uint32_t& firstLine, uint32_t& linesAdded )
+{
+    PROFILE_ZONE( "IDEFileHandler::pollLoad" );
+
+    // the lines loaded are the file, they are not edits
+    uint64_t editCount = m_document.getEditCount();
+    bool     changed   = m_loader.poll( m_document, byteBudget, firstLine, linesAdded );
+    m_savedEditCount += m_document.getEditCount() - editCount;
+    return changed;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      open a file read only, the file is mapped and its lines are
+                indexed in the background rather than read
+    @param      filename    std::string filename to open
+    @return     LibraryError    error code
+------------------------------------------------------------------------------*/
+LibraryError IDEFileHandler::openLargeFile( std::string& filename )
+{
+    PROFILE_ZONE( "IDEFileHandler::openLargeFile" );
+
+    LibraryError error = m_largeFile.open( filename );
+
+    if ( error != LibraryError::No_Error )
+    {
+        error = LibraryError::IDEFileHandler_FailedToOpenFile;
+    }
+    else
+    {
+        m_editlineAttributes.clear();
+        m_loader.close();
+        m_document.clear();
+        m_savedEditCount = m_document.getEditCount();
+
+        m_filename = filename;
+        m_status   = "File Opened (read only) : ";
+        m_status += m_filename;
         m_flags |= (uint32_t)FileHandlerFlags::Open;
-        m_flags &= -(uint32_t)FileHandlerFlags::Save;
     }
 
     return error;
@@ -148,28 +258,34 @@ LibraryError IDEFileHandler::openFile( std::string& filename )
 ------------------------------------------------------------------------------*/
 LibraryError IDEFileHandler::saveFile( std::string& filename )
 {
+    PROFILE_ZONE( "IDEFileHandler::saveFile" );
+
     LibraryError error = LibraryError::No_Error;
 
-    if ( m_flags & (uint32_t)FileHandlerFlags::Open )
+    if ( m_largeFile.isOpen() )
     {
-        // save the file
-        m_fileOut.open( filename );
-        if ( !m_fileOut.is_open() )
+        // large files are view only
+        error = LibraryError::IDEFileHandler_FailedToSaveFile;
+    }
+    else if ( m_loader.isLoading() )
+    {
+        // saving now would write a part of the file over the whole
+        error = LibraryError::IDEFileHandler_FileStillLoading;
+    }
+    else if ( m_flags & (uint32_t)FileHandlerFlags::Open )
+    {
+        // save the file, the target is only replaced once it is all written
+        if ( writeDocument( filename ) != LibraryError::No_Error )
         {
-            error = LibraryError::IDEFileHandler_FailedToOpenFile;
+            error = LibraryError::IDEFileHandler_FailedToSaveFile;
         }
         else
         {
-            for ( auto& editline : m_editlines )
-            {
-                m_fileOut << editline << std::endl;
-            }
-            m_fileOut.close();
             m_flags |= (uint32_t)FileHandlerFlags::Save;
-            m_flags &= -(uint32_t)FileHandlerFlags::Open;
             m_filename = filename;
             m_status   = "File Saved : ";
             m_status += m_filename;
+            m_savedEditCount = m_document.getEditCount();
         }
     }
     else
@@ -179,6 +295,164 @@ LibraryError IDEFileHandler::saveFile( std::string& filename )
     return error;
 }
 
+// private functions -----------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      write the document to a file, the pieces are written as they
+                are rather than line by line
+    @param      filename    std::string filename to write
+    @return     LibraryError    error code
+------------------------------------------------------------------------------*/
+LibraryError IDEFileHandler::writeDocument( const std::string& filename )
+{
+    AtomicFileWriter writer;
+    LibraryError     error = writer.open( filename );
+
+    // a file loaded with "\r\n" is kept that way, lines added since are
+    // only split with '\n' so they are given the '\r' too
+    bool crlf     = m_document.usesCrlf();
+    char previous = 0;
+
+    std::vector<std::string_view> spans;
+    m_document.getSpans( spans );
+    for ( std::string_view span : spans )
+    {
+        if ( error != LibraryError::No_Error )
+        {
+            break;
+        }
+        if ( crlf )
+        {
+            size_t from = 0;
+            for ( size_t feed = span.find( '\n' ); feed != std::string_view::npos; feed = span.find( '\n', feed + 1 ) )
+            {
+                if ( ( feed > 0 ? span[feed - 1] : previous ) != '\r' )
+                {
+                    writer.write( span.substr( from, feed - from ) );
+                    writer.write( "\r" );
+                    from = feed;
+                }
+            }
+            span     = span.substr( from );
+            previous = span.empty() ? previous : span.back();
+        }
+        error = writer.write( span );
+    }
+
+    if ( error == LibraryError::No_Error && m_document.hasTrailingNewline() )
+    {
+        error = writer.write( ( crlf && previous != '\r' ) ? "\r\n" : "\n" );
+    }
+    if ( error == LibraryError::No_Error )
+    {
+        error = writer.commit();
+    }
+    return error;
+}
+
+// document editing -------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      takes the document already placed in m_document as the open
+                file, in place of reading it
+    @param      filename    file the document belongs to
+    @param      modified    true if the document differs from the file
+    @return     void
+------------------------------------------------------------------------------*/
+void IDEFileHandler::restoreDocument( const std::string& filename, bool modified )
+{
+    m_editlineAttributes.clear();
+    m_loader.close();
+    m_largeFile.close();
+    m_savedEditCount = modified ? ~m_document.getEditCount() : m_document.getEditCount();
+
+    m_filename = filename;
+    m_status   = "File Restored : ";
+    m_status += m_filename;
+    m_flags |= (uint32_t)FileHandlerFlags::Open;
+    m_flags &= ~(uint32_t)FileHandlerFlags::Save;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      get the attributes of a line
+    @param      line    line index
+    @return     EditLineAttributes  attributes, cleared if the line has none
+------------------------------------------------------------------------------*/
+IDEFileHandler::EditLineAttributes IDEFileHandler::getLineAttributes( uint32_t line ) const
+{
+    EditLineAttributes attributes;
+    attributes.clear();
+
+    auto found = m_editlineAttributes.find( line );
+    if ( found != m_editlineAttributes.end() )
+    {
+        attributes = found->second;
+    }
+    return attributes;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      split a document line in two, moving the marked lines below
+    @param      line    line index
+    @param      column  column to split at
+    @return     LibraryError    error code
+------------------------------------------------------------------------------*/
+LibraryError IDEFileHandler::splitDocumentLine( uint32_t line, uint32_t column )
+{
+    LibraryError error = m_document.splitLine( line, column );
+
+    if ( error == LibraryError::No_Error )
+    {
+        // renumber the marked lines after the split
+        std::vector<std::map<uint32_t, EditLineAttributes>::node_type> moved;
+        auto attribute = m_editlineAttributes.upper_bound( line );
+        while ( attribute != m_editlineAttributes.end() )
+        {
+            moved.push_back( m_editlineAttributes.extract( attribute++ ) );
+        }
+        for ( auto& node : moved )
+        {
+            node.key()++;
+            m_editlineAttributes.insert( std::move( node ) );
+        }
+    }
+    return error;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      join a document line with the following line, moving the
+                marked lines below
+    @param      line    line index
+    @return     LibraryError    error code
+------------------------------------------------------------------------------*/
+LibraryError IDEFileHandler::joinDocumentLines( uint32_t line )
+{
+    LibraryError error = m_document.joinLines( line );
+
+    if ( error == LibraryError::No_Error )
+    {
+        // the joined line loses its marks, the lines after it move up
+        m_editlineAttributes.erase( line + 1 );
+        std::vector<std::map<uint32_t, EditLineAttributes>::node_type> moved;
+        auto attribute = m_editlineAttributes.upper_bound( line + 1 );
+        while ( attribute != m_editlineAttributes.end() )
+        {
+            moved.push_back( m_editlineAttributes.extract( attribute++ ) );
+        }
+        for ( auto& node : moved )
+        {
+            node.key()--;
+            m_editlineAttributes.insert( std::move( node ) );
+        }
+    }
+    return error;
+}
+
 //-----------------------------------------------------------------------------
 
 } // namespace Nimble
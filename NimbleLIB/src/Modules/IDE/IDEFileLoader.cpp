@@ -0,0 +1,317 @@
+/**----------------------------------------------------------------------------
+
+    @file       IDEFileLoader.cpp
+    @defgroup   NimbleLIBIDE Nimble Library IDE Module
+    @brief      IDEFileLoader class for the Nimble Library
+
+    @copyright  Neil Bereford 2023
+
+Notes:
+
+    The reader thread reads LOAD_BLOCK_SIZE bytes at a time and cuts each
+    block at its last line feed, the part line after it is carried on to
+    the next block. A batch holds whole lines without their final line
+    feed, every batch after the first starts with the line feed ending the
+    batch before, so appending a batch to the end of the document never
+    leaves an empty last line. Whether the file ends with a line feed is
+    only known at the end and is set on the document then, along with
+    whether the first line ended "\r\n".
+
+    The queue holds LOAD_BATCHES batches, the reader waits when it is full
+    so a slow UI never has more than that read ahead. poll() is called by
+    the UI thread once a frame and appends batches up to a byte budget, so
+    the first screenful is shown as soon as it is read and the lines
+    already loaded can be edited while the rest arrives.
+
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// Include files
+// ----------------------------------------------------------------------------
+
+#include "../../../inc/Modules/IDE/IDEFileLoader.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+//-----------------------------------------------------------------------------
+// Namespace
+// ----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+// Constructor & Destructor -----------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      IDEFileLoader Constructor
+
+------------------------------------------------------------------------------*/
+IDEFileLoader::IDEFileLoader() : m_batches( LOAD_BATCHES )
+{
+    m_stopReading     = false;
+    m_readComplete    = false;
+    m_readFailed      = false;
+    m_trailingNewline = false;
+    m_crlf            = false;
+    m_fileSize        = 0;
+    m_bytesLoaded     = 0;
+    m_loading         = false;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      IDEFileLoader Destructor
+
+------------------------------------------------------------------------------*/
+IDEFileLoader::~IDEFileLoader()
+{
+    close();
+}
+
+// initialisation --------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      starts loading a file in the background
+    @param      filename    file to load
+    @return     LibraryError    error code
+------------------------------------------------------------------------------*/
+LibraryError IDEFileLoader::open( const std::string& filename )
+{
+    std::error_code sizeError;
+
+    close();
+    m_fileSize = std::filesystem::file_size( filename, sizeError );
+    if ( sizeError )
+    {
+        m_fileSize = 0;
+        ErrorHandler::getInstance().handleError( ErrorType::Error, LibraryError::IDEFileHandler_FailedToOpenFile, "IDEFileLoader::open() : " + filename );
+        return LibraryError::IDEFileHandler_FailedToOpenFile;
+    }
+
+    m_stopReading     = false;
+    m_readComplete    = false;
+    m_readFailed      = false;
+    m_trailingNewline = false;
+    m_crlf            = false;
+    m_bytesLoaded     = 0;
+    m_loading         = true;
+    m_reader          = std::thread( &IDEFileLoader::readFile, this, filename );
+    return LibraryError::No_Error;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      stops loading, any batches not yet appended are dropped
+    @return     void
+------------------------------------------------------------------------------*/
+void IDEFileLoader::close()
+{
+    m_stopReading = true;
+    if ( m_reader.joinable() )
+    {
+        m_reader.join();
+    }
+    while ( m_batches.pop( m_batch ) )
+    {
+    }
+    m_batch.clear();
+    m_loading = false;
+}
+
+// loading ---------------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      appends the batches read so far to the end of the document,
+                UI thread only
+    @param      document    document being loaded
+    @param      byteBudget  stop once this many bytes have been appended
+    @param      firstLine   set to the line the batches were appended to
+    @param      linesAdded  set to the number of lines added after it
+    @return     bool    true if the document changed
+------------------------------------------------------------------------------*/
+bool IDEFileLoader::poll( IDEPieceTable& document, uint64_t byteBudget, uint32_t& firstLine, uint32_t& linesAdded )
+{
+    uint64_t appended = 0;
+    bool     changed  = false;
+
+    firstLine  = document.getLineCount() - 1;
+    linesAdded = 0;
+    while ( m_loading && appended < byteBudget )
+    {
+        // read before the pop, an empty queue after the last batch is the end
+        bool complete = m_readComplete.load( std::memory_order_acquire );
+        if ( m_batches.pop( m_batch ) == false )
+        {
+            if ( complete )
+            {
+                m_reader.join();
+                m_loading = false;
+                document.setTrailingNewline( m_trailingNewline );
+                document.setCrlf( m_crlf );
+                if ( m_readFailed )
+                {
+                    ErrorHandler::getInstance().handleError( ErrorType::Error, LibraryError::IDEFileLoader_FailedToReadFile, "IDEFileLoader::poll() : the file was not read to the end" );
+                }
+            }
+            break;
+        }
+
+        document.insertAt( document.getLength(), m_batch );
+        linesAdded += (uint32_t)std::count( m_batch.begin(), m_batch.end(), '\n' );
+        appended += m_batch.size();
+        changed = true;
+    }
+    m_bytesLoaded += appended;
+    return changed;
+}
+
+// getters ---------------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      checks if the file is still being loaded
+    @return     bool    true until the last batch has been appended
+------------------------------------------------------------------------------*/
+bool IDEFileLoader::isLoading() const
+{
+    return m_loading;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      returns the size of the file being loaded
+    @return     uint64_t    size in bytes
+------------------------------------------------------------------------------*/
+uint64_t IDEFileLoader::getFileSize() const
+{
+    return m_fileSize;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      returns the bytes appended to the document so far
+    @return     uint64_t    bytes loaded
+------------------------------------------------------------------------------*/
+uint64_t IDEFileLoader::getBytesLoaded() const
+{
+    return m_bytesLoaded;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      returns how much of the file has been loaded
+    @return     uint32_t    percentage loaded
+------------------------------------------------------------------------------*/
+uint32_t IDEFileLoader::getProgress() const
+{
+    if ( m_loading == false || m_fileSize == 0 )
+    {
+        return 100;
+    }
+    return (uint32_t)std::min<uint64_t>( 99, ( m_bytesLoaded * 100 ) / m_fileSize );
+}
+
+// private functions -----------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      reader thread, reads the file and queues it as line batches
+    @param      filename    file to read
+    @return     void
+------------------------------------------------------------------------------*/
+void IDEFileLoader::readFile( std::string filename )
+{
+    std::ifstream file( filename, std::ios::binary );
+    std::string   block;
+    bool          first = true;
+
+    if ( file.is_open() == false )
+    {
+        m_readFailed = true;
+    }
+
+    while ( file.is_open() && m_stopReading == false )
+    {
+        // the part line carried from the last block, then the next block
+        size_t carried = block.size();
+        block.resize( carried + LOAD_BLOCK_SIZE );
+        file.read( block.data() + carried, LOAD_BLOCK_SIZE );
+        block.resize( carried + (size_t)file.gcount() );
+
+        if ( (size_t)file.gcount() == 0 )
+        {
+            m_readFailed = file.bad();
+            if ( block.empty() == false )
+            {
+                // the last line has no line feed
+                queueBatch( first ? std::move( block ) : "\n" + block );
+            }
+            else
+            {
+                m_trailingNewline = ( first == false );
+            }
+            break;
+        }
+
+        size_t lastFeed = block.rfind( '\n' );
+        if ( lastFeed != std::string::npos )
+        {
+            std::string batch;
+            batch.reserve( lastFeed + 1 );
+            if ( first == false )
+            {
+                batch += '\n';
+            }
+            else
+            {
+                // the first line says how the file ends its lines
+                size_t firstFeed = block.find( '\n' );
+                m_crlf           = firstFeed > 0 && block[firstFeed - 1] == '\r';
+            }
+            batch.append( block, 0, lastFeed );
+            block.erase( 0, lastFeed + 1 );
+            first = false;
+            if ( queueBatch( std::move( batch ) ) == false )
+            {
+                break;
+            }
+        }
+    }
+    m_readComplete.store( true, std::memory_order_release );
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      queues a batch, waiting while the queue is full
+    @param      batch   batch of lines
+    @return     bool    false if asked to stop while waiting
+------------------------------------------------------------------------------*/
+bool IDEFileLoader::queueBatch( std::string&& batch )
+{
+    while ( m_batches.push( std::move( batch ) ) == false )
+    {
+        if ( m_stopReading )
+        {
+            return false;
+        }
+        std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: IDEFileLoader.cpp
+// ----------------------------------------------------------------------------
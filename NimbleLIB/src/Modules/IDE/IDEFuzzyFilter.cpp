@@ -0,0 +1,622 @@
+/**----------------------------------------------------------------------------
+
+    @file       IDEFuzzyFilter.cpp
+    @defgroup   NimbleLIBIDE Nimble Library IDE Module
+    @brief      IDEFuzzyFilter class for the Nimble Library
+
+    @copyright  Neil Bereford 2023
+
+Notes:
+
+    A name matches when the characters of the query appear in it in order,
+    ignoring case, not necessarily next to each other, "fdlg" matches
+    "IDEFileDialog.cpp". Each name is lower cased once, as it is added, into
+    one buffer, and given a 64 bit mask of the characters it holds. A name
+    whose mask lacks a character of the query cannot match and is passed
+    over without being read. The masks are tested four at a time with SSE2,
+    so a long list is mostly passed over a block of names at a time.
+
+    Each character of the query is found from just after the last one, the
+    first place each can go. A name of SIMD_NAME_LENGTH characters or less,
+    nearly every path, is loaded into four SSE2 registers once and each
+    character of the query compared with all 64 bytes at once, giving a
+    mask of its places, the next place is the lowest bit past the last
+    match. The lower cased names are followed by SIMD_PADDING bytes so the
+    registers can always be loaded whole, longer names use memchr. The
+    match is scored for each character, with bonuses where it starts a
+    name, follows a separator or is a capital in a camel case name, or
+    follows the last match directly, less a penalty for the characters
+    skipped since the last match. The matches are ranked by score, names
+    in the order added where the scores are equal.
+
+    A query that adds to the end of the last one can only match names the
+    last one matched, and as each character goes in the first place it
+    can, the characters of the last query match in the same places. Each
+    match keeps its score so far and the place of its last character, so
+    only the characters added are found and scored. Typing a query a key
+    at a time therefore reads fewer names with each key, and one character
+    of each. The matches of each query typed are kept, up to HISTORY_LIMIT
+    of them, so backspace goes back to the matches of the shorter query
+    rather than scoring every name again.
+
+    Once more than PARALLEL_THRESHOLD names are to be scored, every file of
+    a large project, they are split into chunks of PARALLEL_CHUNK names and
+    scored on a ThreadPool of the filter's own, one worker per core, started
+    by the first long list. Each chunk keeps its matches in a vector of its
+    own and the chunks are joined in order once the pool is idle, so the
+    matches are the same, in the same order, as scoring them on one thread.
+
+    The scores of a query fall in a range of a few hundred values, so the
+    matches are ranked with a counting sort rather than a comparison sort,
+    two passes over the matches whatever their number. The matches are
+    kept in the order added as well, which the counting sort needs to
+    leave names of equal score in that order, and which narrowing reads.
+
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// Include files
+// ----------------------------------------------------------------------------
+
+#include "../../../inc/Modules/IDE/IDEFuzzyFilter.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#if defined( __x86_64__ ) || defined( _M_X64 )
+#define FUZZY_FILTER_X86_64
+#include <emmintrin.h>
+#endif
+
+//-----------------------------------------------------------------------------
+// Namespace
+// ----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Local functions
+// ----------------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Lower cases an ASCII character
+    @param      ch          character
+    @return     uint8_t     lower case character
+-----------------------------------------------------------------------------*/
+static inline uint8_t toLower( uint8_t ch )
+{
+    return ( ch >= 'A' && ch <= 'Z' ) ? (uint8_t)( ch + ( 'a' - 'A' ) ) : ch;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Checks if a character separates the words of a name
+    @param      ch          character
+    @return     bool        true for / \ _ - . and space
+-----------------------------------------------------------------------------*/
+static inline bool isSeparator( uint8_t ch )
+{
+    return ch == '/' || ch == '\\' || ch == '_' || ch == '-' || ch == '.' || ch == ' ';
+}
+
+#if defined( FUZZY_FILTER_X86_64 )
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Finds every place a character is in a name of 64 characters
+                at most, with SSE2
+    @param      blocks      the name, and the bytes after it, 16 to a block
+    @param      ch          lower case character
+    @return     uint64_t    a bit for each place, bit 0 the first character
+-----------------------------------------------------------------------------*/
+static inline uint64_t findPositions( const __m128i blocks[4], char ch )
+{
+    const __m128i match = _mm_set1_epi8( ch );
+    uint64_t      first = (uint32_t)_mm_movemask_epi8( _mm_cmpeq_epi8( blocks[0], match ) ) | ( (uint32_t)_mm_movemask_epi8( _mm_cmpeq_epi8( blocks[1], match ) ) << 16 );
+    uint64_t      last  = (uint32_t)_mm_movemask_epi8( _mm_cmpeq_epi8( blocks[2], match ) ) | ( (uint32_t)_mm_movemask_epi8( _mm_cmpeq_epi8( blocks[3], match ) ) << 16 );
+    return first | ( last << 32 );
+}
+#endif
+
+//-----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+// constructors & destructors -------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Constructor for IDEFuzzyFilter class
+
+-----------------------------------------------------------------------------*/
+IDEFuzzyFilter::IDEFuzzyFilter()
+{
+    m_parallel = PARALLEL_THRESHOLD;
+    clear();
+}
+
+// index ----------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Removes every name
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDEFuzzyFilter::clear()
+{
+    m_lower.assign( SIMD_PADDING, '\0' );
+    m_names.clear();
+    m_offsets.assign( 1, 0 );
+    m_masks.clear();
+    m_levels.clear();
+    m_kept = 0;
+    m_matches.clear();
+    m_query.clear();
+    m_queryMask = 0;
+    m_valid     = false;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Adds a name to the index, it is the next item
+    @param      name    name
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDEFuzzyFilter::addItem( std::string_view name )
+{
+    uint64_t mask = 0;
+
+    // the padding after the last name is moved after this one
+    m_lower.resize( m_offsets.back() );
+    for ( char ch : name )
+    {
+        uint8_t lower = toLower( (uint8_t)ch );
+        m_lower += (char)lower;
+        mask |= getCharMask( lower );
+    }
+    m_names.append( name );
+    m_offsets.push_back( (uint32_t)m_lower.size() );
+    m_lower.append( SIMD_PADDING, '\0' );
+    m_masks.push_back( mask );
+    m_valid = false;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Gets the number of names
+    @return     uint32_t    names
+-----------------------------------------------------------------------------*/
+uint32_t IDEFuzzyFilter::getItemCount() const
+{
+    return (uint32_t)m_masks.size();
+}
+
+// filtering ------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Finds the names matching a query, an empty query matches every
+                name in the order added
+    @param      query   characters to match, in order
+    @return     const std::vector<Match>&   matches, best first
+-----------------------------------------------------------------------------*/
+const std::vector<IDEFuzzyFilter::Match>& IDEFuzzyFilter::filter( std::string_view query )
+{
+    std::string lower;
+    uint64_t    mask = 0;
+
+    for ( char ch : query )
+    {
+        lower += (char)toLower( (uint8_t)ch );
+        mask |= getCharMask( toLower( (uint8_t)ch ) );
+    }
+    if ( m_valid && lower == m_query )
+    {
+        return m_matches;
+    }
+
+    // the matches of the longest query typed that this one adds to are kept, the rest dropped
+    if ( m_valid == false )
+    {
+        m_levels.clear();
+        m_kept = 0;
+    }
+    while ( m_levels.empty() == false && ( m_levels.back().length > lower.size() || lower.compare( 0, m_levels.back().length, m_query, 0, m_levels.back().length ) != 0 ) )
+    {
+        m_kept -= m_levels.back().found.size();
+        m_levels.pop_back();
+    }
+    m_query     = lower;
+    m_queryMask = mask;
+    m_valid     = true;
+
+    if ( m_query.empty() )
+    {
+        m_matches.resize( m_masks.size() );
+        for ( uint32_t item = 0; item < m_masks.size(); item++ )
+        {
+            m_matches[item] = { item, 0 };
+        }
+        return m_matches;
+    }
+
+    if ( m_levels.empty() || m_levels.back().length < m_query.size() )
+    {
+        const std::vector<Found>* source = m_levels.empty() ? nullptr : &m_levels.back().found;
+        size_t                    matched = m_levels.empty() ? 0 : m_levels.back().length;
+        Level                     level;
+
+        level.length = (uint32_t)m_query.size();
+        if ( ( source ? source->size() : m_masks.size() ) > m_parallel )
+        {
+            scoreParallel( source, matched, level.found );
+        }
+        else if ( source )
+        {
+            narrowItems( *source, 0, source->size(), matched, level.found );
+        }
+        else
+        {
+            scanItems( 0, (uint32_t)m_masks.size(), level.found );
+        }
+        addLevel( std::move( level ) );
+    }
+    rankMatches( m_levels.back().found );
+    return m_matches;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Gets the matches of the last query
+    @return     const std::vector<Match>&   matches, best first
+-----------------------------------------------------------------------------*/
+const std::vector<IDEFuzzyFilter::Match>& IDEFuzzyFilter::getMatches() const
+{
+    return m_matches;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Scores a name against the last query
+    @param      item    name
+    @param      result  set to the score if the name matches
+    @return     bool    true if the name matches
+-----------------------------------------------------------------------------*/
+bool IDEFuzzyFilter::score( uint32_t item, int32_t& result ) const
+{
+    int32_t total = 0;
+    int32_t last  = -1;
+
+    if ( scoreFrom( item, 0, total, last ) == false )
+    {
+        return false;
+    }
+    // of equal matches the shorter name is better
+    result = total - (int32_t)( ( m_offsets[item + 1] - m_offsets[item] ) >> 3 );
+    return true;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Sets how many names are scored on one thread, more are scored
+                on the pool, PARALLEL_THRESHOLD unless set
+    @param      names   names scored on one thread at most
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDEFuzzyFilter::setParallelThreshold( uint32_t names )
+{
+    m_parallel = names;
+}
+
+// private functions ----------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Scores the characters of the last query from one on, carrying
+                on from where the characters before it matched
+    @param      item    name
+    @param      first   first character of the query to match
+    @param      total   score of the characters before, set to the score
+                        of the characters matched
+    @param      last    place of the character before, -1 for none, set to
+                        the place of the last character matched
+    @return     bool    true if the name matches
+-----------------------------------------------------------------------------*/
+bool IDEFuzzyFilter::scoreFrom( uint32_t item, size_t first, int32_t& total, int32_t& last ) const
+{
+    const char* lower    = m_lower.data() + m_offsets[item];
+    const char* names    = m_names.data() + m_offsets[item];
+    size_t      length   = m_offsets[item + 1] - m_offsets[item];
+    int64_t     previous = last;
+    size_t      position = (size_t)( previous + 1 );
+
+    if ( ( m_masks[item] & m_queryMask ) != m_queryMask )
+    {
+        return false;
+    }
+
+#if defined( FUZZY_FILTER_X86_64 )
+    // a short name is held in four registers, padding included, and each character of the query found in all of them at once
+    bool     simd   = length <= SIMD_NAME_LENGTH;
+    uint64_t inName = ( length < 64 ) ? ( 1ULL << length ) - 1 : ~0ULL;
+    __m128i  blocks[4];
+    if ( simd )
+    {
+        for ( uint32_t block = 0; block < 4; block++ )
+        {
+            blocks[block] = _mm_loadu_si128( (const __m128i*)( lower + block * 16 ) );
+        }
+    }
+#endif
+    for ( size_t character = first; character < m_query.size(); character++ )
+    {
+        char   ch = m_query[character];
+        size_t index;
+#if defined( FUZZY_FILTER_X86_64 )
+        if ( simd )
+        {
+            // the places in the name after the last match
+            uint64_t positions = findPositions( blocks, ch ) & inName & ( ( position < 64 ) ? ~0ULL << position : 0 );
+            if ( positions == 0 )
+            {
+                return false;
+            }
+            index = (size_t)std::countr_zero( positions );
+        }
+        else
+#endif
+        {
+            const char* found = (const char*)memchr( lower + position, ch, length - position );
+            if ( found == nullptr )
+            {
+                return false;
+            }
+            index = (size_t)( found - lower );
+        }
+
+        total += SCORE_MATCH;
+        if ( index == 0 )
+        {
+            total += BONUS_START;
+        }
+        else if ( isSeparator( (uint8_t)names[index - 1] ) )
+        {
+            total += BONUS_BOUNDARY;
+        }
+        else if ( names[index] >= 'A' && names[index] <= 'Z' && names[index - 1] >= 'a' && names[index - 1] <= 'z' )
+        {
+            total += BONUS_CAMEL;
+        }
+        if ( previous >= 0 && (int64_t)index == previous + 1 )
+        {
+            total += BONUS_CONSECUTIVE;
+        }
+        else if ( previous >= 0 )
+        {
+            total -= (int32_t)std::min<int64_t>( (int64_t)index - previous - 1, MAX_GAP_PENALTY );
+        }
+        previous = (int64_t)index;
+        position = index + 1;
+    }
+
+    last = (int32_t)previous;
+    return true;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Scores a range of the names against the last query, the names
+                whose masks lack a character of the query are passed over
+    @param      first   first name
+    @param      last    name after the last
+    @param      found   names matching, added in the order added
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDEFuzzyFilter::scanItems( uint32_t first, uint32_t last, std::vector<Found>& found ) const
+{
+    const uint64_t* masks = m_masks.data();
+    uint32_t        item  = first;
+    int32_t         total;
+    int32_t         place;
+
+#if defined( FUZZY_FILTER_X86_64 )
+    const __m128i query = _mm_set1_epi64x( (long long)m_queryMask );
+    const __m128i zero  = _mm_setzero_si128();
+    for ( ; item + 4 <= last; item += 4 )
+    {
+        // the bits of the query a name lacks, zero in both halves of a 64 bit lane when it has them all
+        __m128i low   = _mm_cmpeq_epi32( _mm_xor_si128( _mm_and_si128( _mm_loadu_si128( (const __m128i*)( masks + item ) ), query ), query ), zero );
+        __m128i high  = _mm_cmpeq_epi32( _mm_xor_si128( _mm_and_si128( _mm_loadu_si128( (const __m128i*)( masks + item + 2 ) ), query ), query ), zero );
+        low           = _mm_and_si128( low, _mm_shuffle_epi32( low, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+        high          = _mm_and_si128( high, _mm_shuffle_epi32( high, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+        uint32_t pass = (uint32_t)_mm_movemask_pd( _mm_castsi128_pd( low ) ) | ( (uint32_t)_mm_movemask_pd( _mm_castsi128_pd( high ) ) << 2 );
+        for ( ; pass != 0; pass &= pass - 1 )
+        {
+            uint32_t candidate = item + (uint32_t)std::countr_zero( pass );
+            total              = 0;
+            place              = -1;
+            if ( scoreFrom( candidate, 0, total, place ) )
+            {
+                found.push_back( { candidate, total, place } );
+            }
+        }
+    }
+#endif
+    for ( ; item < last; item++ )
+    {
+        total = 0;
+        place = -1;
+        if ( ( masks[item] & m_queryMask ) == m_queryMask && scoreFrom( item, 0, total, place ) )
+        {
+            found.push_back( { item, total, place } );
+        }
+    }
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Scores a range of the names a shorter query matched against
+                the characters the last query adds to it
+    @param      source  names the shorter query matched
+    @param      first   first of source
+    @param      last    one after the last of source
+    @param      matched characters of the query source matched
+    @param      found   names still matching, added in the order added
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDEFuzzyFilter::narrowItems( const std::vector<Found>& source, size_t first, size_t last, size_t matched, std::vector<Found>& found ) const
+{
+    for ( size_t index = first; index < last; index++ )
+    {
+        Found match = source[index];
+        if ( scoreFrom( match.item, matched, match.total, match.last ) )
+        {
+            found.push_back( match );
+        }
+    }
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Scores the names, or narrows the matches of a shorter query,
+                in chunks on the pool, the chunks are joined in order so the
+                matches stay in the order added
+    @param      source  names the shorter query matched, nullptr to score
+                        every name
+    @param      matched characters of the query source matched
+    @param      found   names matching
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDEFuzzyFilter::scoreParallel( const std::vector<Found>* source, size_t matched, std::vector<Found>& found )
+{
+    size_t count  = source ? source->size() : m_masks.size();
+    size_t chunks = ( count + PARALLEL_CHUNK - 1 ) / PARALLEL_CHUNK;
+
+    if ( m_pool == nullptr )
+    {
+        m_pool = std::make_unique<ThreadPool>();
+    }
+    m_chunks.resize( chunks );
+    for ( size_t chunk = 0; chunk < chunks; chunk++ )
+    {
+        size_t first = chunk * PARALLEL_CHUNK;
+        size_t last  = std::min<size_t>( first + PARALLEL_CHUNK, count );
+        m_pool->submit(
+            [this, source, matched, chunk, first, last]()
+            {
+                std::vector<Found>& scored = m_chunks[chunk];
+                scored.clear();
+                if ( source )
+                {
+                    narrowItems( *source, first, last, matched, scored );
+                }
+                else
+                {
+                    scanItems( (uint32_t)first, (uint32_t)last, scored );
+                }
+            } );
+    }
+    m_pool->wait();
+
+    for ( const auto& scored : m_chunks )
+    {
+        found.insert( found.end(), scored.begin(), scored.end() );
+    }
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Keeps the matches of the query typed, the matches of the
+                shortest queries are dropped once more than HISTORY_LIMIT
+                are kept
+    @param      level   names matching the query
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDEFuzzyFilter::addLevel( Level&& level )
+{
+    m_kept += level.found.size();
+    m_levels.push_back( std::move( level ) );
+    while ( m_levels.size() > 1 && m_kept > HISTORY_LIMIT )
+    {
+        m_kept -= m_levels.front().found.size();
+        m_levels.erase( m_levels.begin() );
+    }
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Ranks the names found, best score first, with a counting sort
+                on the score, names with the same score stay in the order
+                added as they are found in that order
+    @param      found   names matching, in the order added
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDEFuzzyFilter::rankMatches( const std::vector<Found>& found )
+{
+    int32_t lowest  = INT32_MAX;
+    int32_t highest = INT32_MIN;
+
+    // of equal matches the shorter name is better
+    m_matches.resize( found.size() );
+    for ( size_t index = 0; index < found.size(); index++ )
+    {
+        uint32_t item    = found[index].item;
+        int32_t  score   = found[index].total - (int32_t)( ( m_offsets[item + 1] - m_offsets[item] ) >> 3 );
+        m_matches[index] = { item, score };
+        lowest           = std::min( lowest, score );
+        highest          = std::max( highest, score );
+    }
+    if ( found.empty() )
+    {
+        return;
+    }
+
+    // the scores of a query fall in a few hundred values, a count of each
+    m_counts.assign( (size_t)( highest - lowest ) + 1, 0 );
+    for ( const Match& match : m_matches )
+    {
+        m_counts[highest - match.score]++;
+    }
+    uint32_t start = 0;
+    for ( uint32_t& count : m_counts )
+    {
+        uint32_t next = start + count;
+        count         = start;
+        start         = next;
+    }
+    m_ranked.resize( m_matches.size() );
+    for ( const Match& match : m_matches )
+    {
+        m_ranked[m_counts[highest - match.score]++] = match;
+    }
+    std::swap( m_matches, m_ranked );
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Gets the bit of a lower case character, letters and digits
+                have a bit each, other characters share the rest
+    @param      ch          lower case character
+    @return     uint64_t    bit
+-----------------------------------------------------------------------------*/
+uint64_t IDEFuzzyFilter::getCharMask( uint8_t ch )
+{
+    if ( ch >= 'a' && ch <= 'z' )
+    {
+        return 1ULL << ( ch - 'a' );
+    }
+    if ( ch >= '0' && ch <= '9' )
+    {
+        return 1ULL << ( 26 + ch - '0' );
+    }
+    return 1ULL << ( 36 + ch % 28 );
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: IDEFuzzyFilter.cpp
+// ----------------------------------------------------------------------------
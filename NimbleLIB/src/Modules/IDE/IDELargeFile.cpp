@@ -0,0 +1,295 @@
+/**----------------------------------------------------------------------------
+
+    @file       IDELargeFile.cpp
+    @defgroup   NimbleLIBIDE Nimble Library IDE Module
+    @brief      IDELargeFile class for the Nimble Library
+
+    @copyright  Neil Bereford 2023
+
+Notes:
+
+    The indexing thread reads the file through a stream rather than through
+    the mapping, so scanning the file does not fault every page of the
+    mapping into the editor. Only the rows that are displayed are touched.
+
+    Lines are split on '\n' in the same way as IDEPieceTable, a final line
+    feed does not start an extra line.
+
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// Include files
+// ----------------------------------------------------------------------------
+
+#include "../../../inc/Modules/IDE/IDELargeFile.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+//-----------------------------------------------------------------------------
+// Namespace
+// ----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+// Constructor & Destructor -----------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      IDELargeFile Constructor
+
+------------------------------------------------------------------------------*/
+IDELargeFile::IDELargeFile()
+{
+    m_stopIndexing  = false;
+    m_indexComplete = false;
+    m_lineFeeds     = 0;
+    m_indexedBytes  = 0;
+    m_lastLine      = 0;
+    m_lastOffset    = 0;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      IDELargeFile Destructor, stops the indexer and unmaps the file
+
+------------------------------------------------------------------------------*/
+IDELargeFile::~IDELargeFile()
+{
+    close();
+}
+
+// initialisation --------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      map a file and start indexing its lines in the background,
+                the first lines can be read straight away
+    @param      filename    file to open
+    @return     LibraryError    error code
+------------------------------------------------------------------------------*/
+LibraryError IDELargeFile::open( const std::string& filename )
+{
+    close();
+
+    LibraryError error = m_file.open( filename );
+    if ( error == LibraryError::No_Error )
+    {
+        // line 0 always starts at the beginning of the file
+        m_checkpoints.push_back( 0 );
+
+        if ( m_file.getSize() == 0 )
+        {
+            m_indexComplete = true;
+        }
+        else
+        {
+            m_indexer = std::thread( &IDELargeFile::buildIndex, this, filename );
+        }
+    }
+    return error;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      stop indexing and release the file
+    @return     void
+------------------------------------------------------------------------------*/
+void IDELargeFile::close()
+{
+    m_stopIndexing = true;
+    if ( m_indexer.joinable() )
+    {
+        m_indexer.join();
+    }
+    m_file.close();
+    m_checkpoints.clear();
+
+    m_stopIndexing  = false;
+    m_indexComplete = false;
+    m_lineFeeds     = 0;
+    m_indexedBytes  = 0;
+    m_lastLine      = 0;
+    m_lastOffset    = 0;
+}
+
+// getters ---------------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      returns if a file is open
+    @return     bool    true if open
+------------------------------------------------------------------------------*/
+bool IDELargeFile::isOpen() const
+{
+    return m_file.isOpen();
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      returns if the whole file has been indexed
+    @return     bool    true if indexed
+------------------------------------------------------------------------------*/
+bool IDELargeFile::isIndexComplete() const
+{
+    return m_indexComplete;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      returns if the file was cut short on disk while mapped, the
+                lines past its new end read as zeros
+    @return     bool    true if truncated
+------------------------------------------------------------------------------*/
+bool IDELargeFile::isTruncated() const
+{
+    return m_file.isTruncated();
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      returns the number of lines, this grows while the file is
+                being indexed
+    @return     uint32_t    lines known so far
+------------------------------------------------------------------------------*/
+uint32_t IDELargeFile::getLineCount() const
+{
+    uint32_t lines = m_lineFeeds + 1;
+
+    if ( m_indexComplete && m_file.getSize() > 0 && m_file.getData()[m_file.getSize() - 1] == '\n' )
+    {
+        lines--;
+    }
+    return lines;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      returns the size of the file
+    @return     uint64_t    size in bytes
+------------------------------------------------------------------------------*/
+uint64_t IDELargeFile::getFileSize() const
+{
+    return m_file.getSize();
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      returns how far the indexer has got through the file
+    @return     uint64_t    bytes indexed
+------------------------------------------------------------------------------*/
+uint64_t IDELargeFile::getIndexedBytes() const
+{
+    return m_indexedBytes;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      returns a line as a view into the mapping, without the line
+                feed. Scans forward from the closest checkpoint or from the
+                last lookup, so reading consecutive rows is cheap.
+    @param      line    line index
+    @return     std::string_view    line, empty if the line does not exist.
+                                    Valid until the file is closed.
+------------------------------------------------------------------------------*/
+std::string_view IDELargeFile::getLine( uint32_t line )
+{
+    const char* data = m_file.getData();
+    uint64_t    size = m_file.getSize();
+
+    if ( data == nullptr )
+    {
+        return std::string_view();
+    }
+
+    uint32_t base   = 0;
+    uint64_t offset = 0;
+    {
+        std::lock_guard<std::mutex> lock( m_indexLock );
+        size_t                      checkpoint = std::min<size_t>( line / LINE_INDEX_STEP, m_checkpoints.size() - 1 );
+        base                                   = (uint32_t)checkpoint * LINE_INDEX_STEP;
+        offset                                 = m_checkpoints[checkpoint];
+    }
+    if ( m_lastLine <= line && m_lastLine > base )
+    {
+        base   = m_lastLine;
+        offset = m_lastOffset;
+    }
+
+    // walk forward to the start of the line
+    while ( base < line )
+    {
+        const char* feed = (const char*)memchr( data + offset, '\n', size - offset );
+        if ( feed == nullptr )
+        {
+            return std::string_view();
+        }
+        offset = ( feed - data ) + 1;
+        base++;
+    }
+    m_lastLine   = line;
+    m_lastOffset = offset;
+
+    const char* feed   = (const char*)memchr( data + offset, '\n', size - offset );
+    uint64_t    length = ( feed == nullptr ) ? size - offset : ( feed - data ) - offset;
+    return std::string_view( data + offset, length );
+}
+
+// private functions -----------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      indexing thread, records a checkpoint every LINE_INDEX_STEP
+                lines and publishes its progress after each block
+    @param      filename    file to index
+    @return     void
+------------------------------------------------------------------------------*/
+void IDELargeFile::buildIndex( std::string filename )
+{
+    std::ifstream         input( filename, std::ios::binary );
+    std::vector<char>     block( INDEX_READ_SIZE );
+    std::vector<uint64_t> found;
+    uint64_t              position = 0;
+    uint32_t              feeds    = 0;
+
+    while ( m_stopIndexing == false && input.read( block.data(), block.size() ).gcount() > 0 )
+    {
+        const char* start = block.data();
+        const char* end   = start + input.gcount();
+        const char* next  = start;
+
+        found.clear();
+        while ( ( next = (const char*)memchr( next, '\n', end - next ) ) != nullptr )
+        {
+            next++;
+            feeds++;
+            if ( ( feeds % LINE_INDEX_STEP ) == 0 )
+            {
+                found.push_back( position + ( next - start ) );
+            }
+        }
+        if ( found.empty() == false )
+        {
+            std::lock_guard<std::mutex> lock( m_indexLock );
+            m_checkpoints.insert( m_checkpoints.end(), found.begin(), found.end() );
+        }
+        position += end - start;
+        m_lineFeeds    = feeds;
+        m_indexedBytes = position;
+    }
+
+    m_indexComplete = ( m_stopIndexing == false );
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: IDELargeFile.cpp
+// ----------------------------------------------------------------------------
@@ -0,0 +1,282 @@
+/**----------------------------------------------------------------------------
+
+    @file       IDEListView.cpp
+    @defgroup   NimbleLIBIDE Nimble Library IDE Module
+    @brief      IDEListView class for the Nimble Library
+
+    @copyright  Neil Bereford 2023
+
+Notes:
+
+    The list itself is not held here, only its length. The text and colour
+    of an item are asked for through the row function, by index, and only
+    for the items on screen, so drawing costs the same for ten items as for
+    a hundred thousand, and moving the cursor or scrolling a page is a sum.
+
+    Each row remembers the item it was painted with and whether it had the
+    cursor. A draw paints only the rows where either has changed, moving
+    the cursor down one paints two rows, scrolling paints every row. When
+    the items themselves change, say the list is filtered, invalidate()
+    has every row painted again on the next draw.
+
+    Example of usage:
+
+        IDEListView list;
+        list.init( win, 3, 3, 52, 16, COLOUR_INDEX( IDE_COL_FG_BLACK, IDE_COL_BG_WHITE ),
+                   [&]( uint32_t item, std::string& text, uint32_t& colour ) { text = names[item]; } );
+        list.setItemCount( names.size() );
+        list.moveCursor( 1 );
+        list.draw( COLOUR_INDEX( IDE_COL_FG_WHITE, IDE_COL_BG_BLACK ) );
+
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// Include files
+// ----------------------------------------------------------------------------
+
+#include <algorithm>
+#include "../../../inc/Modules/IDE/IDEListView.h"
+
+//-----------------------------------------------------------------------------
+// Namespace
+// ----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+// constructors & destructors -------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Constructor for IDEListView class
+
+-----------------------------------------------------------------------------*/
+IDEListView::IDEListView()
+{
+    m_window      = nullptr;
+    m_x           = 0;
+    m_y           = 0;
+    m_width       = 0;
+    m_rows        = 0;
+    m_blankColour = 0;
+    m_itemCount   = 0;
+    m_cursor      = 0;
+    m_top         = 0;
+}
+
+// initialisation -------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Sets where the list is shown and how its rows are found
+    @param      window      window to paint the rows on
+    @param      x           column of the rows
+    @param      y           line of the first row
+    @param      width       characters in each row
+    @param      rows        rows on screen
+    @param      blankColour colour of rows past the end of the list
+    @param      rowFunction gets the text and colour of an item
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDEListView::init( WINDOW* window, uint32_t x, uint32_t y, uint32_t width, uint32_t rows, uint32_t blankColour, RowFunction rowFunction )
+{
+    m_window      = window;
+    m_x           = x;
+    m_y           = y;
+    m_width       = width;
+    m_rows        = rows;
+    m_blankColour = blankColour;
+    m_rowFunction = std::move( rowFunction );
+    m_itemCount   = 0;
+    m_cursor      = 0;
+    m_top         = 0;
+    m_text.reserve( width );
+    invalidate();
+}
+
+// setters --------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Sets the number of items, every row is painted on the next
+                draw as the items may have changed
+    @param      count   items in the list
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDEListView::setItemCount( uint32_t count )
+{
+    m_itemCount = count;
+    clampCursor();
+    invalidate();
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Puts the cursor on an item, keeping it on the same row of the
+                screen where the list allows
+    @param      item    item to put the cursor on
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDEListView::setCursor( uint32_t item )
+{
+    uint32_t row = m_cursor - m_top;
+
+    m_cursor = item;
+    m_top    = ( m_cursor > row ) ? m_cursor - row : 0;
+    clampCursor();
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Moves the cursor up or down, scrolling to keep it on screen
+    @param      rows    rows to move, negative is up
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDEListView::moveCursor( int32_t rows )
+{
+    int64_t cursor = (int64_t)m_cursor + rows;
+
+    m_cursor = ( cursor < 0 ) ? 0 : (uint32_t)std::min<int64_t>( cursor, m_itemCount );
+    clampCursor();
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Has every row painted on the next draw
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDEListView::invalidate()
+{
+    m_drawn.clear();
+}
+
+// getters --------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Gets the number of items
+    @return     uint32_t    items in the list
+-----------------------------------------------------------------------------*/
+uint32_t IDEListView::getItemCount() const
+{
+    return m_itemCount;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Gets the item under the cursor
+    @return     uint32_t    item, 0 when the list is empty
+-----------------------------------------------------------------------------*/
+uint32_t IDEListView::getCursor() const
+{
+    return m_cursor;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Gets the item on the first row
+    @return     uint32_t    item
+-----------------------------------------------------------------------------*/
+uint32_t IDEListView::getTop() const
+{
+    return m_top;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Gets the number of rows on screen
+    @return     uint32_t    rows
+-----------------------------------------------------------------------------*/
+uint32_t IDEListView::getRows() const
+{
+    return m_rows;
+}
+
+// draw -----------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Paints the rows that have changed since the last draw
+    @param      cursorColour    colour of the row under the cursor
+    @return     uint32_t        rows painted
+-----------------------------------------------------------------------------*/
+uint32_t IDEListView::draw( uint32_t cursorColour )
+{
+    uint32_t painted = 0;
+
+    if ( m_window == nullptr )
+    {
+        return painted;
+    }
+    if ( m_drawn.size() != m_rows )
+    {
+        // nothing on screen can be trusted, so no row matches what is wanted
+        m_drawn.assign( m_rows, { NO_ITEM, true } );
+    }
+
+    for ( uint32_t row = 0; row < m_rows; row++ )
+    {
+        uint32_t item     = ( m_top + row < m_itemCount ) ? m_top + row : NO_ITEM;
+        bool     selected = ( item != NO_ITEM && item == m_cursor );
+        DrawnRow& drawn    = m_drawn[row];
+
+        if ( drawn.item == item && drawn.selected == selected )
+        {
+            continue;
+        }
+
+        uint32_t colour = m_blankColour;
+        m_text.clear();
+        if ( item != NO_ITEM )
+        {
+            m_rowFunction( item, m_text, colour );
+        }
+        m_text.resize( m_width, ' ' );
+
+        mvwaddnstr( m_window, m_y + row, m_x, m_text.c_str(), m_width );
+        mvwchgat( m_window, m_y + row, m_x, m_width, A_NORMAL, selected ? cursorColour : colour, nullptr );
+        drawn = { item, selected };
+        painted++;
+    }
+    return painted;
+}
+
+// private functions ----------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Keeps the cursor on an item and on screen
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDEListView::clampCursor()
+{
+    if ( m_cursor >= m_itemCount )
+    {
+        m_cursor = ( m_itemCount > 0 ) ? m_itemCount - 1 : 0;
+    }
+    if ( m_cursor < m_top )
+    {
+        m_top = m_cursor;
+    }
+    else if ( m_rows > 0 && m_cursor >= m_top + m_rows )
+    {
+        m_top = m_cursor - m_rows + 1;
+    }
+    // no blank rows below the end while there are items above the top
+    if ( m_top + m_rows > m_itemCount )
+    {
+        m_top = ( m_itemCount > m_rows ) ? m_itemCount - m_rows : 0;
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: IDEListView.cpp
+// ----------------------------------------------------------------------------
@@ -8,15 +8,22 @@
 
 Notes:
 
+    The quick open palette, ID_QuickOpen, lists the files below the current
+    folder from an IDEProjectFiles kept here, so the list of one use is
+    there at once for the next while the folder is walked again for
+    changes. The file chosen is kept until takeSelectedFile() is called.
+
 -----------------------------------------------------------------------------*/
 //-----------------------------------------------------------------------------
 // Include files
 // ----------------------------------------------------------------------------
 
+#include <filesystem>
 #include "../../../inc/Modules/Curses/CursesColour.h"
 #include "../../../inc/Modules/IDE/IDEManager.h"
 #include "../../../inc/Modules/IDE/IDEDialog.h"
 #include "../../../inc/Modules/IDE/IDEFileDialog.h"
+#include "../../../inc/Modules/IDE/IDEQuickOpen.h"
 #include "../../../inc/Modules/Global/Globals.h"
 
 //-----------------------------------------------------------------------------
@@ -89,6 +96,13 @@ void IDEManager::addControl( ManagerControlID dialogID )
                 ;
             break;
         }
+        case ManagerControlID::ID_QuickOpen:
+        {
+            activeControls.push_back( std::make_unique<IDEQuickOpen>() );
+            while ( getch() != ERR )
+                ;
+            break;
+        }
         default:
         {
             break;
@@ -155,6 +169,23 @@ uint32_t IDEManager::getActiveControlCount() const
     return activeControls.size();
 }
 
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Takes the file chosen in the quick open palette
+    @param      filename - set to the path of the file
+    @return     bool - true if a file was chosen since the last call
+-----------------------------------------------------------------------------*/
+bool IDEManager::takeSelectedFile( std::string& filename )
+{
+    if ( m_selectedFile.empty() )
+    {
+        return false;
+    }
+    filename = std::move( m_selectedFile );
+    m_selectedFile.clear();
+    return true;
+}
+
 // Controller callbacks -------------------------------------------------------
 
 /**----------------------------------------------------------------------------
@@ -189,10 +220,70 @@ void IDEManager::LoadFileCallback()
         {
             uint32_t key = pDialog->getKeytoProcess();
             pDialog->processKeyPress( key );
+            // the window is not cleared, only the rows of the list that change are drawn
+            pDialog->drawLoader();
+            if ( pDialog->isCancelled() )
+            {
+                pControl->eState = ManagerControlState::Cancel;
+            }
+            if ( pDialog->isCompleted() )
+            {
+                pControl->eState = ManagerControlState::Confirm;
+            }
+            break;
+        }
+        case ManagerControlState::Cancel:
+        case ManagerControlState::Confirm:
+        {
+            delwin( pDialog->getWindow() );
+            activeControls[ index ].reset();
+            activeControls.pop_back();
+            activeControlIDs.pop_back();
+            m_bRedrawNeeded = true;
+            break;
+        }
+        default:
+        {
+            break;
+        }
+    }
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Quick open callback
+    @return     none
+-----------------------------------------------------------------------------*/
+void IDEManager::QuickOpenCallback()
+{
+    IDEManagerControl* pControl = &m_controls[ static_cast<int>( ManagerControlID::ID_QuickOpen ) ];
+    uint32_t           index    = activeControls.size() - 1;
+    IDEQuickOpen*      pDialog  = (IDEQuickOpen*)activeControls[ index ].get();
+
+    switch ( pControl->eState )
+    {
+        case ManagerControlState::NotActive:
+        {
+            pControl->eState = ManagerControlState::Start;
+            break;
+        }
+        case ManagerControlState::Start:
+        {
+            // the files of the last use are shown while the folder is walked again
+            m_projectFiles.refresh( std::filesystem::current_path().string() );
+            pDialog->initQuickOpen( m_projectFiles, "Quick Open" );
             uint32_t colour = COLOUR_INDEX( activeControls[ index ]->getInkColour(), activeControls[ index ]->getPaperColour() );
             pDialog->colourWindow( colour, true );
             pDialog->setVerticalScroll();
-            pDialog->drawLoader();
+            pDialog->drawQuickOpen();
+            pControl->eState = ManagerControlState::Running;
+            break;
+        }
+        case ManagerControlState::Running:
+        {
+            uint32_t key = pDialog->getKeytoProcess();
+            pDialog->processKeyPress( key );
+            pDialog->drawQuickOpen();
             if ( pDialog->isCancelled() )
             {
                 pControl->eState = ManagerControlState::Cancel;
@@ -206,6 +297,10 @@ void IDEManager::LoadFileCallback()
         case ManagerControlState::Cancel:
         case ManagerControlState::Confirm:
         {
+            if ( pControl->eState == ManagerControlState::Confirm )
+            {
+                m_selectedFile = pDialog->getFilename();
+            }
             delwin( pDialog->getWindow() );
             activeControls[ index ].reset();
             activeControls.pop_back();
@@ -0,0 +1,941 @@
+/**----------------------------------------------------------------------------
+
+    @file       IDEPieceTable.cpp
+    @defgroup   NimbleLIBIDE Nimble Library IDE Module
+    @brief      IDEPieceTable class for the Nimble Library
+
+    @copyright  Neil Bereford 2023
+
+Notes:
+
+    The document is never stored as one string per line. Instead the loaded
+    file is kept, untouched, in the original buffer and every piece of typed
+    text is appended to the add buffer. The document itself is the in order
+    walk of a tree of pieces, each piece being a (buffer, start, length)
+    reference.
+
+    The tree is a treap: each node carries a random priority and the totals
+    (bytes and line feeds) of its subtree. Those totals let a line number or
+    a byte offset be found by walking down from the root, and an edit is a
+    split of the tree at the offset followed by a merge, so all of the
+    following cost O(log n) regardless of document size or edit position:
+
+        getLineOffset(), getLineLength(), insert(), erase()
+
+    Offsets of every '\n' in both buffers are indexed as the text arrives,
+    so the number of line feeds inside any piece is a binary search.
+
+    Consecutive typing at the end of the add buffer extends the last piece
+    rather than adding a new one, so the tree only grows at edit points.
+
+    If the loaded text ends with a newline, that newline is not part of the
+    document lines (matching the getline() behaviour the editor expects) and
+    hasTrailingNewline() reports it so it can be written back on save.
+    usesCrlf() likewise reports if the first line ended "\r\n".
+
+    getEditCount() counts every insert and erase, comparing it with the
+    count when the file was saved tells if the document has changed.
+
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// Include files
+// ----------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cstring>
+#include "../../../inc/Modules/IDE/IDEPieceTable.h"
+
+//-----------------------------------------------------------------------------
+// Namespace
+// ----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+// constructors & destructors --------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      constructor for IDEPieceTable class
+
+-----------------------------------------------------------------------------*/
+IDEPieceTable::IDEPieceTable()
+{
+    m_root            = NIL;
+    m_seed            = 0x9E3779B9;
+    m_trailingNewline = false;
+    m_crlf            = false;
+    m_editCount       = 0;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Destructor for IDEPieceTable class
+
+-----------------------------------------------------------------------------*/
+IDEPieceTable::~IDEPieceTable()
+{
+}
+
+// initialisation --------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Empties the document, releasing both buffers
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDEPieceTable::clear()
+{
+    m_original.clear();
+    m_add.clear();
+    m_originalFeeds.clear();
+    m_addFeeds.clear();
+    m_nodes.clear();
+    m_freeNodes.clear();
+    m_root            = NIL;
+    m_trailingNewline = false;
+    m_crlf            = false;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Loads the document, the text becomes the original buffer
+    @param      text    document text, moved into the table
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDEPieceTable::load( std::string&& text )
+{
+    clear();
+    m_original = std::move( text );
+
+    // index the line feeds of the original buffer
+    const char* base   = m_original.data();
+    const char* cursor = base;
+    const char* end    = base + m_original.size();
+    while ( cursor < end )
+    {
+        const char* feed = (const char*)memchr( cursor, '\n', end - cursor );
+        if ( feed == nullptr )
+        {
+            break;
+        }
+        m_originalFeeds.push_back( feed - base );
+        cursor = feed + 1;
+    }
+    m_crlf = m_originalFeeds.empty() == false && m_originalFeeds[ 0 ] > 0 && m_original[ m_originalFeeds[ 0 ] - 1 ] == '\r';
+
+    // the final newline terminates the last line, it does not start a new one
+    uint64_t length = m_original.size();
+    if ( length > 0 && m_original[ length - 1 ] == '\n' )
+    {
+        m_trailingNewline = true;
+        length--;
+    }
+    if ( length > 0 )
+    {
+        m_root = createNode( BufferID::Original, 0, length );
+    }
+}
+
+// getters ---------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Get the number of lines in the document
+    @return     uint32_t    number of lines, always at least one
+-----------------------------------------------------------------------------*/
+uint32_t IDEPieceTable::getLineCount() const
+{
+    return subtreeFeeds( m_root ) + 1;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Get the length of a line, excluding the line feed
+    @param      line    line index
+    @return     uint32_t    length of the line, 0 if out of range
+-----------------------------------------------------------------------------*/
+uint32_t IDEPieceTable::getLineLength( uint32_t line ) const
+{
+    uint32_t length = 0;
+
+    if ( line < getLineCount() )
+    {
+        length = (uint32_t)( lineEnd( line ) - getLineOffset( line ) );
+    }
+    return length;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Get the text of a line, excluding the line feed
+    @param      line    line index
+    @return     std::string text of the line, empty if out of range
+-----------------------------------------------------------------------------*/
+std::string IDEPieceTable::getLine( uint32_t line ) const
+{
+    std::string text;
+
+    if ( line < getLineCount() )
+    {
+        uint64_t start = getLineOffset( line );
+        uint64_t end   = lineEnd( line );
+        text.reserve( end - start );
+        collect( m_root, start, end - start, text );
+    }
+    return text;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Get a single character of the document
+    @param      line    line index
+    @param      column  column within the line
+    @return     uint8_t character, 0 if out of range
+-----------------------------------------------------------------------------*/
+uint8_t IDEPieceTable::getChar( uint32_t line, uint32_t column ) const
+{
+    uint8_t  ch     = 0;
+    uint64_t offset = 0;
+
+    if ( column < getLineLength( line ) && toOffset( line, column, offset ) )
+    {
+        std::string text;
+        collect( m_root, offset, 1, text );
+        ch = (uint8_t)text[ 0 ];
+    }
+    return ch;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Get the length of the document in bytes
+    @return     uint64_t    document length
+-----------------------------------------------------------------------------*/
+uint64_t IDEPieceTable::getLength() const
+{
+    return subtreeLength( m_root );
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Get the byte offset of the start of a line
+    @param      line    line index
+    @return     uint64_t    offset, or the document length if out of range
+-----------------------------------------------------------------------------*/
+uint64_t IDEPieceTable::getLineOffset( uint32_t line ) const
+{
+    uint64_t offset = 0;
+    uint32_t node   = m_root;
+
+    if ( line == 0 )
+    {
+        return 0;
+    }
+
+    // find the piece holding the line'th line feed
+    while ( node != NIL )
+    {
+        const PieceNode& piece    = m_nodes[ node ];
+        uint32_t         leftFeed = subtreeFeeds( piece.left );
+
+        if ( line <= leftFeed )
+        {
+            node = piece.left;
+        }
+        else if ( line <= leftFeed + piece.lineFeeds )
+        {
+            uint64_t feed = nthFeed( piece.buffer, piece.start, line - leftFeed );
+            return offset + subtreeLength( piece.left ) + ( feed - piece.start ) + 1;
+        }
+        else
+        {
+            line -= leftFeed + piece.lineFeeds;
+            offset += subtreeLength( piece.left ) + piece.length;
+            node = piece.right;
+        }
+    }
+    return getLength();
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Get the line holding a byte offset
+    @param      offset  byte offset
+    @return     uint32_t    line index, the last line if out of range
+-----------------------------------------------------------------------------*/
+uint32_t IDEPieceTable::getLineAt( uint64_t offset ) const
+{
+    uint32_t line = 0;
+    uint32_t node = m_root;
+
+    // count the line feeds before the offset
+    while ( node != NIL )
+    {
+        const PieceNode& piece      = m_nodes[ node ];
+        uint64_t         leftLength = subtreeLength( piece.left );
+
+        if ( offset < leftLength )
+        {
+            node = piece.left;
+        }
+        else if ( offset < leftLength + piece.length )
+        {
+            return line + subtreeFeeds( piece.left ) + countFeeds( piece.buffer, piece.start, offset - leftLength );
+        }
+        else
+        {
+            line += subtreeFeeds( piece.left ) + piece.lineFeeds;
+            offset -= leftLength + piece.length;
+            node = piece.right;
+        }
+    }
+    return getLineCount() - 1;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Get the whole document as a string
+    @return     std::string document text
+-----------------------------------------------------------------------------*/
+std::string IDEPieceTable::getText() const
+{
+    return getText( 0, getLength() );
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Get a range of the document as a string
+    @param      offset  start offset
+    @param      length  number of bytes, clamped to the document
+    @return     std::string text in the range
+-----------------------------------------------------------------------------*/
+std::string IDEPieceTable::getText( uint64_t offset, uint64_t length ) const
+{
+    std::string text;
+    uint64_t    total = getLength();
+
+    if ( offset < total )
+    {
+        length = std::min( length, total - offset );
+        text.reserve( length );
+        collect( m_root, offset, length, text );
+    }
+    return text;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Gets the text as views of the pieces in order, nothing is
+                copied. The views are valid until the document is next changed
+    @param      spans   set to one view per piece
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDEPieceTable::getSpans( std::vector<std::string_view>& spans ) const
+{
+    spans.clear();
+    spans.reserve( getPieceCount() );
+    collectSpans( m_root, spans );
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Check if the loaded text ended with a newline
+    @return     bool    true if the loaded text ended with a newline
+-----------------------------------------------------------------------------*/
+bool IDEPieceTable::hasTrailingNewline() const
+{
+    return m_trailingNewline;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Check if the loaded text ends its lines with "\r\n"
+    @return     bool    true if the first line ended with "\r\n"
+-----------------------------------------------------------------------------*/
+bool IDEPieceTable::usesCrlf() const
+{
+    return m_crlf;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Get the number of pieces making up the document
+    @return     uint32_t    number of pieces
+-----------------------------------------------------------------------------*/
+uint32_t IDEPieceTable::getPieceCount() const
+{
+    return (uint32_t)( m_nodes.size() - m_freeNodes.size() );
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Get the number of inserts and erases made to the document
+    @return     uint64_t    edit count, only ever increases
+-----------------------------------------------------------------------------*/
+uint64_t IDEPieceTable::getEditCount() const
+{
+    return m_editCount;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Get the memory held by the document, buffers, indices and
+                nodes
+    @return     uint64_t    bytes held
+-----------------------------------------------------------------------------*/
+uint64_t IDEPieceTable::getMemoryUsed() const
+{
+    return m_original.capacity() + m_add.capacity() + ( m_originalFeeds.capacity() + m_addFeeds.capacity() ) * sizeof( uint64_t ) + m_nodes.capacity() * sizeof( PieceNode ) +
+           m_freeNodes.capacity() * sizeof( uint32_t );
+}
+
+// setters ---------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Sets if the text ends with a newline, used when the text is
+                appended in parts rather than loaded
+    @param      trailingNewline true if the text ends with a newline
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDEPieceTable::setTrailingNewline( bool trailingNewline )
+{
+    m_trailingNewline = trailingNewline;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Sets if the text ends its lines with "\r\n", used when the
+                text is appended in parts rather than loaded
+    @param      crlf    true if the first line ends with "\r\n"
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDEPieceTable::setCrlf( bool crlf )
+{
+    m_crlf = crlf;
+}
+
+// editing ---------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Inserts text at a line and column
+    @param      line    line index
+    @param      column  column, may be the line length to append
+    @param      text    text to insert, may contain line feeds
+    @return     LibraryError    Error code or LibraryError::No_Error
+-----------------------------------------------------------------------------*/
+LibraryError IDEPieceTable::insert( uint32_t line, uint32_t column, const std::string& text )
+{
+    uint64_t offset = 0;
+
+    if ( toOffset( line, column, offset ) == false )
+    {
+        ErrorHandler::getInstance().handleError( ErrorType::Error, LibraryError::IDEPieceTable_InvalidPosition, "IDEPieceTable::insert() : position out of range" );
+        return LibraryError::IDEPieceTable_InvalidPosition;
+    }
+    return insertAt( offset, text );
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Erases text from a line and column, may span lines
+    @param      line    line index
+    @param      column  column within the line
+    @param      length  number of bytes to erase
+    @return     LibraryError    Error code or LibraryError::No_Error
+-----------------------------------------------------------------------------*/
+LibraryError IDEPieceTable::erase( uint32_t line, uint32_t column, uint64_t length )
+{
+    uint64_t offset = 0;
+
+    if ( toOffset( line, column, offset ) == false )
+    {
+        ErrorHandler::getInstance().handleError( ErrorType::Error, LibraryError::IDEPieceTable_InvalidPosition, "IDEPieceTable::erase() : position out of range" );
+        return LibraryError::IDEPieceTable_InvalidPosition;
+    }
+    return eraseAt( offset, length );
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Inserts text at a byte offset
+    @param      offset  byte offset, may be the document length to append
+    @param      text    text to insert
+    @return     LibraryError    Error code or LibraryError::No_Error
+-----------------------------------------------------------------------------*/
+LibraryError IDEPieceTable::insertAt( uint64_t offset, const std::string& text )
+{
+    if ( offset > getLength() )
+    {
+        ErrorHandler::getInstance().handleError( ErrorType::Error, LibraryError::IDEPieceTable_InvalidPosition, "IDEPieceTable::insertAt() : offset out of range" );
+        return LibraryError::IDEPieceTable_InvalidPosition;
+    }
+    if ( text.empty() )
+    {
+        return LibraryError::No_Error;
+    }
+
+    // append the text, indexing its line feeds
+    uint64_t addStart  = m_add.size();
+    uint32_t lineFeeds = 0;
+    m_add += text;
+    for ( uint64_t i = 0; i < text.size(); i++ )
+    {
+        if ( text[ i ] == '\n' )
+        {
+            m_addFeeds.push_back( addStart + i );
+            lineFeeds++;
+        }
+    }
+
+    // split at the offset and place the new piece between the halves
+    uint32_t left  = NIL;
+    uint32_t right = NIL;
+    split( m_root, offset, left, right );
+    if ( extendLast( left, addStart, text.size(), lineFeeds ) == false )
+    {
+        left = merge( left, createNode( BufferID::Add, addStart, text.size() ) );
+    }
+    m_root = merge( left, right );
+    m_editCount++;
+
+    return LibraryError::No_Error;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Erases a range of bytes
+    @param      offset  byte offset of the first byte to erase
+    @param      length  number of bytes to erase
+    @return     LibraryError    Error code or LibraryError::No_Error
+-----------------------------------------------------------------------------*/
+LibraryError IDEPieceTable::eraseAt( uint64_t offset, uint64_t length )
+{
+    if ( offset > getLength() || length > getLength() - offset )
+    {
+        ErrorHandler::getInstance().handleError( ErrorType::Error, LibraryError::IDEPieceTable_InvalidPosition, "IDEPieceTable::eraseAt() : range out of range" );
+        return LibraryError::IDEPieceTable_InvalidPosition;
+    }
+    if ( length == 0 )
+    {
+        return LibraryError::No_Error;
+    }
+
+    // cut out the middle section and release its nodes
+    uint32_t left   = NIL;
+    uint32_t middle = NIL;
+    uint32_t right  = NIL;
+    split( m_root, offset, left, right );
+    split( right, length, middle, right );
+    freeTree( middle );
+    m_root = merge( left, right );
+    m_editCount++;
+
+    return LibraryError::No_Error;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Splits a line in two at the column
+    @param      line    line index
+    @param      column  column to split at
+    @return     LibraryError    Error code or LibraryError::No_Error
+-----------------------------------------------------------------------------*/
+LibraryError IDEPieceTable::splitLine( uint32_t line, uint32_t column )
+{
+    return insert( line, column, "\n" );
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Joins a line with the line following it
+    @param      line    line index
+    @return     LibraryError    Error code or LibraryError::No_Error
+-----------------------------------------------------------------------------*/
+LibraryError IDEPieceTable::joinLines( uint32_t line )
+{
+    if ( line + 1 >= getLineCount() )
+    {
+        ErrorHandler::getInstance().handleError( ErrorType::Error, LibraryError::IDEPieceTable_InvalidPosition, "IDEPieceTable::joinLines() : no following line" );
+        return LibraryError::IDEPieceTable_InvalidPosition;
+    }
+    return eraseAt( lineEnd( line ), 1 );
+}
+
+// private functions -----------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Creates a single node tree for a piece
+    @param      buffer  buffer the piece refers to
+    @param      start   start offset within the buffer
+    @param      length  length of the piece
+    @return     uint32_t    node index
+-----------------------------------------------------------------------------*/
+uint32_t IDEPieceTable::createNode( BufferID buffer, uint64_t start, uint64_t length )
+{
+    uint32_t node;
+
+    if ( m_freeNodes.empty() == false )
+    {
+        node = m_freeNodes.back();
+        m_freeNodes.pop_back();
+    }
+    else
+    {
+        node = (uint32_t)m_nodes.size();
+        m_nodes.emplace_back();
+    }
+
+    // xorshift priority keeps the tree balanced in expectation
+    m_seed ^= m_seed << 13;
+    m_seed ^= m_seed >> 17;
+    m_seed ^= m_seed << 5;
+
+    PieceNode& piece   = m_nodes[ node ];
+    piece.buffer       = buffer;
+    piece.start        = start;
+    piece.length       = length;
+    piece.lineFeeds    = countFeeds( buffer, start, length );
+    piece.subLength    = length;
+    piece.subLineFeeds = piece.lineFeeds;
+    piece.left         = NIL;
+    piece.right        = NIL;
+    piece.priority     = m_seed;
+
+    return node;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Returns every node of a subtree to the free list
+    @param      node    root of the subtree
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDEPieceTable::freeTree( uint32_t node )
+{
+    std::vector<uint32_t> stack;
+
+    if ( node != NIL )
+    {
+        stack.push_back( node );
+    }
+    while ( stack.empty() == false )
+    {
+        uint32_t current = stack.back();
+        stack.pop_back();
+        if ( m_nodes[ current ].left != NIL )
+        {
+            stack.push_back( m_nodes[ current ].left );
+        }
+        if ( m_nodes[ current ].right != NIL )
+        {
+            stack.push_back( m_nodes[ current ].right );
+        }
+        m_freeNodes.push_back( current );
+    }
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Recalculates the subtree totals of a node
+    @param      node    node index
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDEPieceTable::update( uint32_t node )
+{
+    PieceNode& piece   = m_nodes[ node ];
+    piece.subLength    = piece.length + subtreeLength( piece.left ) + subtreeLength( piece.right );
+    piece.subLineFeeds = piece.lineFeeds + subtreeFeeds( piece.left ) + subtreeFeeds( piece.right );
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Get the number of bytes in a subtree
+    @param      node    node index, may be NIL
+    @return     uint64_t    bytes in the subtree
+-----------------------------------------------------------------------------*/
+uint64_t IDEPieceTable::subtreeLength( uint32_t node ) const
+{
+    return ( node == NIL ) ? 0 : m_nodes[ node ].subLength;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Get the number of line feeds in a subtree
+    @param      node    node index, may be NIL
+    @return     uint32_t    line feeds in the subtree
+-----------------------------------------------------------------------------*/
+uint32_t IDEPieceTable::subtreeFeeds( uint32_t node ) const
+{
+    return ( node == NIL ) ? 0 : m_nodes[ node ].subLineFeeds;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Counts the line feeds in a buffer range
+    @param      buffer  buffer to check
+    @param      start   start offset
+    @param      length  length of the range
+    @return     uint32_t    number of line feeds
+-----------------------------------------------------------------------------*/
+uint32_t IDEPieceTable::countFeeds( BufferID buffer, uint64_t start, uint64_t length ) const
+{
+    const std::vector<uint64_t>& feeds = ( buffer == BufferID::Original ) ? m_originalFeeds : m_addFeeds;
+
+    auto first = std::lower_bound( feeds.begin(), feeds.end(), start );
+    auto last  = std::lower_bound( first, feeds.end(), start + length );
+    return (uint32_t)( last - first );
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Finds the n'th line feed at or after a buffer offset
+    @param      buffer  buffer to check
+    @param      start   start offset
+    @param      n       line feed to find, 1 based
+    @return     uint64_t    buffer offset of the line feed
+-----------------------------------------------------------------------------*/
+uint64_t IDEPieceTable::nthFeed( BufferID buffer, uint64_t start, uint32_t n ) const
+{
+    const std::vector<uint64_t>& feeds = ( buffer == BufferID::Original ) ? m_originalFeeds : m_addFeeds;
+
+    auto first = std::lower_bound( feeds.begin(), feeds.end(), start );
+    return *( first + ( n - 1 ) );
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Joins two trees, every piece of left preceding right
+    @param      left    left tree
+    @param      right   right tree
+    @return     uint32_t    root of the joined tree
+-----------------------------------------------------------------------------*/
+uint32_t IDEPieceTable::merge( uint32_t left, uint32_t right )
+{
+    if ( left == NIL )
+    {
+        return right;
+    }
+    if ( right == NIL )
+    {
+        return left;
+    }
+    if ( m_nodes[ left ].priority > m_nodes[ right ].priority )
+    {
+        uint32_t child        = merge( m_nodes[ left ].right, right );
+        m_nodes[ left ].right = child;
+        update( left );
+        return left;
+    }
+    uint32_t child        = merge( left, m_nodes[ right ].left );
+    m_nodes[ right ].left = child;
+    update( right );
+    return right;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Splits a tree at a byte offset, cutting a piece if needed
+    @param      node    tree to split
+    @param      offset  bytes to place in the left tree
+    @param      left    returned left tree
+    @param      right   returned right tree
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDEPieceTable::split( uint32_t node, uint64_t offset, uint32_t& left, uint32_t& right )
+{
+    if ( node == NIL )
+    {
+        left  = NIL;
+        right = NIL;
+        return;
+    }
+
+    uint64_t leftLength = subtreeLength( m_nodes[ node ].left );
+    uint64_t length     = m_nodes[ node ].length;
+    uint32_t first      = NIL;
+    uint32_t second     = NIL;
+
+    if ( offset <= leftLength )
+    {
+        split( m_nodes[ node ].left, offset, first, second );
+        m_nodes[ node ].left = second;
+        update( node );
+        left  = first;
+        right = node;
+    }
+    else if ( offset >= leftLength + length )
+    {
+        split( m_nodes[ node ].right, offset - leftLength - length, first, second );
+        m_nodes[ node ].right = first;
+        update( node );
+        left  = node;
+        right = second;
+    }
+    else
+    {
+        // the offset falls inside this piece, cut it in two
+        uint64_t cut  = offset - leftLength;
+        uint32_t tail = createNode( m_nodes[ node ].buffer, m_nodes[ node ].start + cut, length - cut );
+
+        PieceNode& piece = m_nodes[ node ];
+        second           = piece.right;
+        piece.length     = cut;
+        piece.lineFeeds -= m_nodes[ tail ].lineFeeds;
+        piece.right = NIL;
+        update( node );
+        left  = node;
+        right = merge( tail, second );
+    }
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Extends the last piece of a tree if it ends where the new
+                text starts in the add buffer (continued typing)
+    @param      node        tree to extend
+    @param      addStart    add buffer offset of the new text
+    @param      length      length of the new text
+    @param      lineFeeds   line feeds in the new text
+    @return     bool        true if extended
+-----------------------------------------------------------------------------*/
+bool IDEPieceTable::extendLast( uint32_t node, uint64_t addStart, uint64_t length, uint32_t lineFeeds )
+{
+    if ( node == NIL )
+    {
+        return false;
+    }
+
+    uint32_t last = node;
+    while ( m_nodes[ last ].right != NIL )
+    {
+        last = m_nodes[ last ].right;
+    }
+    if ( m_nodes[ last ].buffer != BufferID::Add || m_nodes[ last ].start + m_nodes[ last ].length != addStart )
+    {
+        return false;
+    }
+
+    // every node on the right spine holds the last piece in its totals
+    for ( uint32_t current = node; current != NIL; current = m_nodes[ current ].right )
+    {
+        m_nodes[ current ].subLength += length;
+        m_nodes[ current ].subLineFeeds += lineFeeds;
+    }
+    m_nodes[ last ].length += length;
+    m_nodes[ last ].lineFeeds += lineFeeds;
+    return true;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Appends the text of a subtree range to a string
+    @param      node    subtree root
+    @param      offset  start offset relative to the subtree
+    @param      length  number of bytes
+    @param      out     string to append to
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDEPieceTable::collect( uint32_t node, uint64_t offset, uint64_t length, std::string& out ) const
+{
+    if ( node == NIL || length == 0 )
+    {
+        return;
+    }
+
+    const PieceNode& piece      = m_nodes[ node ];
+    uint64_t         pieceStart = subtreeLength( piece.left );
+    uint64_t         pieceEnd   = pieceStart + piece.length;
+    uint64_t         end        = offset + length;
+
+    if ( offset < pieceStart )
+    {
+        collect( piece.left, offset, std::min( end, pieceStart ) - offset, out );
+    }
+    if ( offset < pieceEnd && end > pieceStart )
+    {
+        uint64_t from = std::max( offset, pieceStart ) - pieceStart;
+        uint64_t to   = std::min( end, pieceEnd ) - pieceStart;
+        out.append( bufferText( piece.buffer ), piece.start + from, to - from );
+    }
+    if ( end > pieceEnd )
+    {
+        uint64_t from = std::max( offset, pieceEnd );
+        collect( piece.right, from - pieceEnd, end - from, out );
+    }
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Appends a view of every piece of a subtree, in order
+    @param      node    subtree root
+    @param      spans   views to append to
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDEPieceTable::collectSpans( uint32_t node, std::vector<std::string_view>& spans ) const
+{
+    if ( node == NIL )
+    {
+        return;
+    }
+
+    const PieceNode& piece = m_nodes[ node ];
+    collectSpans( piece.left, spans );
+    spans.push_back( std::string_view( bufferText( piece.buffer ) ).substr( piece.start, piece.length ) );
+    collectSpans( piece.right, spans );
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Converts a line and column to a byte offset
+    @param      line    line index
+    @param      column  column, may equal the line length
+    @param      offset  returned byte offset
+    @return     bool    true if the position is within the document
+-----------------------------------------------------------------------------*/
+bool IDEPieceTable::toOffset( uint32_t line, uint32_t column, uint64_t& offset ) const
+{
+    if ( line >= getLineCount() )
+    {
+        return false;
+    }
+
+    uint64_t start = getLineOffset( line );
+    if ( column > lineEnd( line ) - start )
+    {
+        return false;
+    }
+    offset = start + column;
+    return true;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Get the byte offset of the end of a line (its line feed)
+    @param      line    line index
+    @return     uint64_t    offset of the end of the line
+-----------------------------------------------------------------------------*/
+uint64_t IDEPieceTable::lineEnd( uint32_t line ) const
+{
+    if ( line + 1 < getLineCount() )
+    {
+        return getLineOffset( line + 1 ) - 1;
+    }
+    return getLength();
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: IDEPieceTable.cpp
+// ----------------------------------------------------------------------------
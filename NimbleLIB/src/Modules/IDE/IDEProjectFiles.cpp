@@ -0,0 +1,378 @@
+/**----------------------------------------------------------------------------
+
+    @file       IDEProjectFiles.cpp
+    @defgroup   NimbleLIBIDE Nimble Library IDE Module
+    @brief      IDEProjectFiles class for the Nimble Library
+
+    @copyright  Neil Bereford 2023
+
+Notes:
+
+    The list of every file below the project folder, for the quick open
+    palette. refresh() walks the folder on a thread of its own and poll()
+    takes the list once the walk has finished, until then the last list is
+    used, so opening the palette never waits for the disk.
+
+    Each folder read is kept, with the time it was last written. Adding,
+    removing or renaming a file or folder changes the time of the folder
+    holding it, so a walk reads only the folders whose times have changed
+    and takes the names of the rest from the last walk, one stat a folder
+    rather than a read. A folder written within SETTLE_SECONDS of being
+    read is read again by the next walk, a change made in the same tick of
+    the file clock would not change its time. Folders whose names start
+    with '.', .git and the like, and links are skipped, as by the project
+    search.
+
+    The paths are relative to the folder, with '/' between the names, the
+    files of a folder before those of the folders inside it, each sorted.
+    The worker also gives the paths to an IDEFuzzyFilter, so the palette
+    has nothing to index when it opens. A walk finding the same files as
+    the last keeps the last list and its filter.
+
+    Example of usage:
+
+        IDEProjectFiles files;
+        files.refresh( "." );
+        ...
+        if ( files.poll() )
+        {
+            files.getFilter().filter( "fdlg" );
+        }
+
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// Include files
+// ----------------------------------------------------------------------------
+
+#include "../../../inc/Modules/IDE/IDEProjectFiles.h"
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+//-----------------------------------------------------------------------------
+// Namespace
+// ----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+// constructors & destructors -------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Constructor for IDEProjectFiles class
+
+-----------------------------------------------------------------------------*/
+IDEProjectFiles::IDEProjectFiles()
+{
+    m_cancelled.store( false );
+    m_finished.store( false );
+    m_refreshing  = false;
+    m_nextChanged = false;
+    m_foldersRead = 0;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Destructor for IDEProjectFiles class, stops the walk running
+
+-----------------------------------------------------------------------------*/
+IDEProjectFiles::~IDEProjectFiles()
+{
+    cancel();
+}
+
+// refreshing -----------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Starts walking a folder for the files below it, the list of
+                the last walk is kept until poll() takes the new one, a walk
+                of the folder already running is left to finish
+    @param      folder  project folder
+    @return     LibraryError
+-----------------------------------------------------------------------------*/
+LibraryError IDEProjectFiles::refresh( const std::string& folder )
+{
+    std::error_code code;
+
+    if ( m_refreshing && folder != m_folder )
+    {
+        cancel();
+    }
+    poll();
+    if ( m_refreshing )
+    {
+        return LibraryError::No_Error;
+    }
+    if ( std::filesystem::is_directory( folder, code ) == false )
+    {
+        ErrorHandler::getInstance().handleError( ErrorType::Error, LibraryError::IDEProjectFiles_FailedToOpenDirectory, "IDEProjectFiles::refresh() : failed to read " + folder );
+        return LibraryError::IDEProjectFiles_FailedToOpenDirectory;
+    }
+
+    // the files of another folder are not kept
+    if ( folder != m_folder )
+    {
+        m_folder = folder;
+        m_paths.clear();
+        m_filter.clear();
+        m_listings.clear();
+    }
+    m_cancelled.store( false );
+    m_finished.store( false );
+    m_refreshing = true;
+    m_worker     = std::thread( &IDEProjectFiles::walkProject, this );
+    return LibraryError::No_Error;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Takes the list of a walk that has finished
+    @return     bool    true if the list has changed
+-----------------------------------------------------------------------------*/
+bool IDEProjectFiles::poll()
+{
+    if ( m_refreshing == false || m_finished.load() == false )
+    {
+        return false;
+    }
+    m_worker.join();
+    m_refreshing = false;
+
+    bool changed = m_nextChanged;
+    if ( changed )
+    {
+        std::swap( m_paths, m_nextPaths );
+        std::swap( m_filter, m_nextFilter );
+        m_nextFilter.clear();
+    }
+    m_nextPaths.clear();
+    return changed;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Stops the walk running, the list of the last walk is kept
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDEProjectFiles::cancel()
+{
+    if ( m_worker.joinable() )
+    {
+        m_cancelled.store( true );
+        m_worker.join();
+    }
+    m_refreshing = false;
+    m_nextPaths.clear();
+    m_nextFilter.clear();
+}
+
+// getters --------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Checks if a walk is running, or has finished and its list is
+                still to be taken by poll()
+    @return     bool    true while walking
+-----------------------------------------------------------------------------*/
+bool IDEProjectFiles::isRefreshing() const
+{
+    return m_refreshing;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Gets the project folder
+    @return     const std::string&  folder
+-----------------------------------------------------------------------------*/
+const std::string& IDEProjectFiles::getFolder() const
+{
+    return m_folder;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Gets every file below the folder, as of the last walk taken
+    @return     const std::vector<std::string>&     paths, relative to the folder
+-----------------------------------------------------------------------------*/
+const std::vector<std::string>& IDEProjectFiles::getPaths() const
+{
+    return m_paths;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Gets the path of a file, with the folder
+    @param      item            file, its index in getPaths()
+    @return     std::string     path
+-----------------------------------------------------------------------------*/
+std::string IDEProjectFiles::getFullPath( uint32_t item ) const
+{
+    return ( std::filesystem::path( m_folder ) / m_paths[item] ).string();
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Gets the filter indexing the paths, item numbers are indexes
+                in getPaths()
+    @return     IDEFuzzyFilter&     filter
+-----------------------------------------------------------------------------*/
+IDEFuzzyFilter& IDEProjectFiles::getFilter()
+{
+    return m_filter;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Gets the number of folders the last walk taken read, folders
+                unchanged since the walk before are not read
+    @return     uint32_t    folders read
+-----------------------------------------------------------------------------*/
+uint32_t IDEProjectFiles::getFoldersRead() const
+{
+    return m_foldersRead;
+}
+
+// private functions ----------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Walks the folder, on the worker, building the next list and
+                its filter
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDEProjectFiles::walkProject()
+{
+    ListingMap listings;
+
+    m_nextPaths.clear();
+    m_foldersRead = 0;
+    m_nextChanged = false;
+    if ( walkFolder( std::string(), listings ) )
+    {
+        // folders not found by this walk are dropped
+        m_listings    = std::move( listings );
+        m_nextChanged = ( m_nextPaths != m_paths );
+        if ( m_nextChanged )
+        {
+            m_nextFilter.clear();
+            for ( const std::string& path : m_nextPaths )
+            {
+                m_nextFilter.addItem( path );
+            }
+        }
+    }
+    else
+    {
+        // stopped part way, every folder is read by the next walk
+        m_listings.clear();
+    }
+    m_finished.store( true );
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Adds the files of a folder, and the folders inside it, to the
+                next list, the folder is only read if it has changed
+    @param      relative    folder, relative to the project folder
+    @param      listings    set to the listing of each folder walked
+    @return     bool        false if the walk was cancelled
+-----------------------------------------------------------------------------*/
+bool IDEProjectFiles::walkFolder( const std::string& relative, ListingMap& listings )
+{
+    std::error_code       code;
+    std::filesystem::path path = relative.empty() ? std::filesystem::path( m_folder ) : std::filesystem::path( m_folder ) / relative;
+
+    if ( m_cancelled.load() )
+    {
+        return false;
+    }
+
+    auto modified = std::filesystem::last_write_time( path, code );
+    if ( code )
+    {
+        return true;
+    }
+
+    // listings are not moved as the map grows, the reference holds while the folders inside are walked
+    FolderListing& listing = listings[relative];
+    auto           found   = m_listings.find( relative );
+    if ( found != m_listings.end() && found->second.settled && found->second.modified == modified )
+    {
+        listing = std::move( found->second );
+    }
+    else
+    {
+        auto now         = std::filesystem::file_time_type::clock::now();
+        listing.modified = modified;
+        listing.settled  = ( now - modified ) > std::chrono::seconds( (int64_t)SETTLE_SECONDS );
+        readFolder( path, listing );
+        m_foldersRead++;
+    }
+
+    std::string prefix = relative.empty() ? std::string() : relative + "/";
+    for ( const std::string& file : listing.files )
+    {
+        m_nextPaths.push_back( prefix + file );
+    }
+    for ( const std::string& folder : listing.folders )
+    {
+        if ( walkFolder( prefix + folder, listings ) == false )
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Reads the names in a folder, files and folders each sorted
+    @param      path        folder
+    @param      listing     set to the names
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDEProjectFiles::readFolder( const std::filesystem::path& path, FolderListing& listing )
+{
+    std::error_code                     code;
+    std::filesystem::directory_iterator entry( path, std::filesystem::directory_options::skip_permission_denied, code );
+
+    listing.files.clear();
+    listing.folders.clear();
+    for ( ; !code && entry != std::filesystem::directory_iterator(); entry.increment( code ) )
+    {
+        std::error_code statusCode;
+        std::string     name = entry->path().filename().string();
+        if ( entry->is_symlink( statusCode ) )
+        {
+            continue;
+        }
+        if ( entry->is_directory( statusCode ) )
+        {
+            if ( name.empty() == false && name[0] != '.' )
+            {
+                listing.folders.push_back( std::move( name ) );
+            }
+        }
+        else if ( entry->is_regular_file( statusCode ) )
+        {
+            listing.files.push_back( std::move( name ) );
+        }
+    }
+    std::sort( listing.files.begin(), listing.files.end() );
+    std::sort( listing.folders.begin(), listing.folders.end() );
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: IDEProjectFiles.cpp
+// ----------------------------------------------------------------------------
@@ -0,0 +1,795 @@
+/**----------------------------------------------------------------------------
+
+    @file       IDEProjectSearch.cpp
+    @defgroup   NimbleLIBIDE Nimble Library IDE Module
+    @brief      IDEProjectSearch class for the Nimble Library
+
+    @copyright  Neil Bereford 2023
+
+Notes:
+
+    The search runs on a work stealing ThreadPool, one worker per core,
+    started by the first search. Reading a folder is a task, which submits
+    a task for each folder inside it and a task for every FILE_BATCH files,
+    so the tree is walked and searched at the same time, on every core,
+    and a worker that runs out of work takes some from the others. Folders
+    whose names start with '.', .git and the like, and links are skipped.
+
+    A file shorter than SMALL_FILE bytes is read whole into a buffer kept
+    by each worker, for a small file mapping it costs more than the copy
+    it saves, larger files are mapped with MappedFile. A NUL byte in the
+    first BINARY_CHECK bytes marks the file as binary and it is skipped,
+    the bytes are compared 16 at a time with SSE2. The text is searched
+    with IDESearch, which compares 32 or 16 positions at once, and each
+    line holding a match is found once, with its line number and the
+    column of its first match.
+
+    The lines found in a file are added to the results together, under a
+    lock, and poll() takes every line added since the last call, so the
+    UI thread is never held up by the search. Every search has a state of
+    its own, shared by its tasks. cancel() marks the state and the tasks
+    stop at the next file or match, a new search does not wait for them,
+    the lines they find are never polled. The search stops on its own
+    once MAX_RESULTS lines have been found.
+
+    With setIndexed() a search uses the IDETrigramIndex of the folder. The
+    files the index gives for the pattern are searched first, then the
+    folder is walked and each file's time and length compared with those
+    indexed. A file that is new or changed is read, added to the index and
+    searched unless it was searched already, a file that is unchanged is
+    not read at all, so a search reads the files that could match and the
+    files that have changed. Once every task has finished the changes are
+    committed, on a worker, and the search only ends after that. Only one
+    search at a time uses the index, a search started while the last is
+    still committing walks the whole folder as before.
+
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// Include files
+// ----------------------------------------------------------------------------
+
+#include "../../../inc/Modules/IDE/IDEProjectSearch.h"
+#include "../../../inc/Modules/FileHandling/MappedFile.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+#if defined( __x86_64__ ) || defined( _M_X64 )
+#define PROJECT_SEARCH_X86_64
+#include <emmintrin.h>
+#endif
+
+#if !defined( _WIN32 )
+#include <sys/stat.h>
+#endif
+
+//-----------------------------------------------------------------------------
+// Namespace
+// ----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Local functions
+// ----------------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Gets the time and length of a file, with one stat() where
+                there is one, the walk of an indexed folder is mostly this
+    @param      entry   file
+    @param      stamp   set to the stamp
+    @return     void
+-----------------------------------------------------------------------------*/
+static void getFileStamp( const std::filesystem::directory_entry& entry, IDETrigramIndex::FileStamp& stamp )
+{
+#if defined( _WIN32 )
+    std::error_code code;
+    stamp.modified = entry.last_write_time( code ).time_since_epoch().count();
+    stamp.size     = entry.file_size( code );
+#else
+    struct stat status;
+    if ( stat( entry.path().c_str(), &status ) != 0 )
+    {
+        stamp.modified = 0;
+        stamp.size     = 0;
+        return;
+    }
+    stamp.modified = (int64_t)status.st_mtim.tv_sec * 1000000000 + status.st_mtim.tv_nsec;
+    stamp.size     = (uint64_t)status.st_size;
+#endif
+}
+
+//-----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+// constructors & destructors -------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Constructor for IDEProjectSearch class
+
+-----------------------------------------------------------------------------*/
+IDEProjectSearch::IDEProjectSearch()
+{
+    m_indexed = false;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Destructor for IDEProjectSearch class, waits for the tasks
+                of a cancelled search to stop
+
+-----------------------------------------------------------------------------*/
+IDEProjectSearch::~IDEProjectSearch()
+{
+    cancel();
+    m_pool.reset();
+}
+
+// searching ------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Starts searching every file below a folder, any search still
+                running is cancelled
+    @param      folder      folder to search
+    @param      pattern     text to find
+    @param      matchCase   true if the case must match
+    @param      wholeWord   true to only match whole words
+    @return     LibraryError
+-----------------------------------------------------------------------------*/
+LibraryError IDEProjectSearch::start( const std::string& folder, const std::string& pattern, bool matchCase, bool wholeWord )
+{
+    std::error_code code;
+
+    cancel();
+    m_pattern = pattern;
+    m_state.reset();
+
+    if ( std::filesystem::is_directory( folder, code ) == false )
+    {
+        ErrorHandler::getInstance().handleError( ErrorType::Error, LibraryError::IDEProjectSearch_FailedToOpenDirectory, "IDEProjectSearch::start() : failed to read " + folder );
+        return LibraryError::IDEProjectSearch_FailedToOpenDirectory;
+    }
+    if ( pattern.empty() )
+    {
+        return LibraryError::No_Error;
+    }
+    if ( m_pool == nullptr )
+    {
+        m_pool = std::make_unique<ThreadPool>();
+    }
+
+    std::shared_ptr<SearchState> state = std::make_shared<SearchState>();
+    state->search.setPattern( pattern, matchCase, wholeWord );
+    state->cancelled.store( false );
+    state->unfinished.store( 0 );
+    state->filesSearched.store( 0 );
+    state->filesSkipped.store( 0 );
+    state->matchCount.store( 0 );
+    state->filesIndexed.store( 0 );
+    state->index     = nullptr;
+    state->searchAll = true;
+    m_state          = state;
+
+    if ( m_indexed && ( m_indexState == nullptr || m_indexState->unfinished.load() == 0 ) )
+    {
+        if ( m_index == nullptr )
+        {
+            m_index = std::make_unique<IDETrigramIndex>();
+        }
+        // held until the index is committed, by the task that finishes last
+        state->index = m_index.get();
+        state->unfinished.store( 1 );
+        m_indexState = state;
+        submit( state, [this, state, folder, pattern]() { searchIndexed( state, folder, pattern ); } );
+    }
+    else
+    {
+        submit( state, [this, state, folder]() { walkFolder( state, folder ); } );
+    }
+    return LibraryError::No_Error;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Takes the lines found since the last call, UI thread only
+    @param      results     the lines found are added to the end
+    @return     bool        true if lines were added
+-----------------------------------------------------------------------------*/
+bool IDEProjectSearch::poll( std::vector<SearchResult>& results )
+{
+    if ( m_state == nullptr )
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> guard( m_state->lock );
+    if ( m_state->found.empty() )
+    {
+        return false;
+    }
+    if ( results.empty() )
+    {
+        results.swap( m_state->found );
+    }
+    else
+    {
+        std::move( m_state->found.begin(), m_state->found.end(), std::back_inserter( results ) );
+        m_state->found.clear();
+    }
+    return true;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Stops the search, its tasks stop at the next file or match
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDEProjectSearch::cancel()
+{
+    if ( m_state != nullptr )
+    {
+        m_state->cancelled.store( true );
+    }
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Sets whether searches use and update the folder's index
+    @param      indexed     true to use the index
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDEProjectSearch::setIndexed( bool indexed )
+{
+    m_indexed = indexed;
+}
+
+// getters --------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Checks if the search is still running
+    @return     bool    true while files are still to be searched
+-----------------------------------------------------------------------------*/
+bool IDEProjectSearch::isSearching() const
+{
+    return m_state != nullptr && m_state->cancelled.load() == false && m_state->unfinished.load() > 0;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Checks if the search stopped at MAX_RESULTS lines
+    @return     bool    true if there may be more matches
+-----------------------------------------------------------------------------*/
+bool IDEProjectSearch::isTruncated() const
+{
+    return m_state != nullptr && m_state->matchCount.load() >= MAX_RESULTS;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Checks if searches use the folder's index
+    @return     bool    true if the index is used
+-----------------------------------------------------------------------------*/
+bool IDEProjectSearch::isIndexed() const
+{
+    return m_indexed;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Gets the pattern of the last search
+    @return     const std::string&  pattern
+-----------------------------------------------------------------------------*/
+const std::string& IDEProjectSearch::getPattern() const
+{
+    return m_pattern;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Gets the number of files searched so far
+    @return     uint64_t    files
+-----------------------------------------------------------------------------*/
+uint64_t IDEProjectSearch::getFilesSearched() const
+{
+    return ( m_state != nullptr ) ? m_state->filesSearched.load() : 0;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Gets the number of binary or unreadable files skipped so far
+    @return     uint64_t    files
+-----------------------------------------------------------------------------*/
+uint64_t IDEProjectSearch::getFilesSkipped() const
+{
+    return ( m_state != nullptr ) ? m_state->filesSkipped.load() : 0;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Gets the number of lines found so far
+    @return     uint64_t    lines
+-----------------------------------------------------------------------------*/
+uint64_t IDEProjectSearch::getMatchCount() const
+{
+    return ( m_state != nullptr ) ? std::min<uint64_t>( m_state->matchCount.load(), MAX_RESULTS ) : 0;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Gets the number of files the search added to the index
+    @return     uint64_t    files new or changed
+-----------------------------------------------------------------------------*/
+uint64_t IDEProjectSearch::getFilesIndexed() const
+{
+    return ( m_state != nullptr ) ? m_state->filesIndexed.load() : 0;
+}
+
+// helpers --------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Checks if the start of a file holds a NUL byte
+    @param      data    contents of the file
+    @param      size    length of the file
+    @return     bool    true if the file is binary
+-----------------------------------------------------------------------------*/
+bool IDEProjectSearch::isBinary( const char* data, uint64_t size )
+{
+    uint64_t length   = std::min<uint64_t>( size, BINARY_CHECK );
+    uint64_t position = 0;
+
+#if defined( PROJECT_SEARCH_X86_64 )
+    const __m128i zero = _mm_setzero_si128();
+    for ( ; position + 64 <= length; position += 64 )
+    {
+        // four blocks are or'ed together, the test is made once for all four
+        __m128i first  = _mm_cmpeq_epi8( _mm_loadu_si128( (const __m128i*)( data + position ) ), zero );
+        __m128i second = _mm_cmpeq_epi8( _mm_loadu_si128( (const __m128i*)( data + position + 16 ) ), zero );
+        __m128i third  = _mm_cmpeq_epi8( _mm_loadu_si128( (const __m128i*)( data + position + 32 ) ), zero );
+        __m128i fourth = _mm_cmpeq_epi8( _mm_loadu_si128( (const __m128i*)( data + position + 48 ) ), zero );
+        __m128i found  = _mm_or_si128( _mm_or_si128( first, second ), _mm_or_si128( third, fourth ) );
+        if ( _mm_movemask_epi8( found ) != 0 )
+        {
+            return true;
+        }
+    }
+#endif
+    return memchr( data + position, 0, length - position ) != nullptr;
+}
+
+// private functions ----------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Submits a task of a search, counted until it finishes
+    @param      state   search the task belongs to
+    @param      task    task to run
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDEProjectSearch::submit( const std::shared_ptr<SearchState>& state, ThreadPool::Task task )
+{
+    state->unfinished.fetch_add( 1 );
+    m_pool->submit(
+        [state, task = std::move( task )]()
+        {
+            if ( state->cancelled.load() == false )
+            {
+                task();
+            }
+            // the last task of an indexed search commits the index
+            if ( state->unfinished.fetch_sub( 1 ) == 2 && state->index != nullptr )
+            {
+                finishIndexed( *state );
+                state->unfinished.fetch_sub( 1 );
+            }
+        } );
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Reads a folder, submitting a task for each folder inside it
+                and a task for every FILE_BATCH files
+    @param      state   search
+    @param      folder  folder to read
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDEProjectSearch::walkFolder( const std::shared_ptr<SearchState>& state, const std::string& folder )
+{
+    std::error_code                     code;
+    std::vector<std::string>            files;
+    std::filesystem::directory_iterator entry( folder, std::filesystem::directory_options::skip_permission_denied, code );
+
+    for ( ; !code && entry != std::filesystem::directory_iterator(); entry.increment( code ) )
+    {
+        if ( state->cancelled.load() )
+        {
+            return;
+        }
+
+        std::error_code statusCode;
+        std::string     name = entry->path().filename().string();
+        if ( entry->is_symlink( statusCode ) )
+        {
+            continue;
+        }
+        if ( entry->is_directory( statusCode ) )
+        {
+            if ( name.empty() == false && name[0] != '.' )
+            {
+                std::string path = entry->path().string();
+                submit( state, [this, state, path]() { walkFolder( state, path ); } );
+            }
+        }
+        else if ( entry->is_regular_file( statusCode ) )
+        {
+            files.push_back( entry->path().string() );
+            if ( files.size() == FILE_BATCH )
+            {
+                submit( state, [this, state, batch = std::move( files )]() { searchFiles( state, batch ); } );
+                files.clear();
+            }
+        }
+    }
+    // the last few files are searched here, rather than passed on
+    searchFiles( state, files );
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Searches files, adding the lines found to the results
+    @param      state   search
+    @param      files   files to search
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDEProjectSearch::searchFiles( const std::shared_ptr<SearchState>& state, const std::vector<std::string>& files )
+{
+    std::vector<SearchResult> results;
+
+    for ( const std::string& path : files )
+    {
+        if ( state->cancelled.load() )
+        {
+            return;
+        }
+
+        searchFile( *state, path, results );
+        if ( results.empty() == false )
+        {
+            std::lock_guard<std::mutex> guard( state->lock );
+            std::move( results.begin(), results.end(), std::back_inserter( state->found ) );
+            results.clear();
+        }
+    }
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Searches the files the index gives for the pattern, then walks
+                the folder for files the index does not know
+    @param      state   search
+    @param      folder  folder to search
+    @param      pattern text to find
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDEProjectSearch::searchIndexed( const std::shared_ptr<SearchState>& state, const std::string& folder, const std::string& pattern )
+{
+    IDETrigramIndex&      index = *state->index;
+    std::vector<uint32_t> files;
+
+    index.open( folder );
+    index.beginUpdate( state->update );
+    state->candidate.assign( index.getFileCount(), 0 );
+    state->searchAll = index.query( pattern, files ) == false;
+
+    std::vector<std::vector<std::string>> batches;
+    for ( uint32_t file : files )
+    {
+        state->candidate[file] = 1;
+        if ( ( index.getFlags( file ) & IDETrigramIndex::FLAG_BINARY ) == 0 )
+        {
+            if ( batches.empty() || batches.back().size() == FILE_BATCH )
+            {
+                batches.emplace_back();
+            }
+            batches.back().push_back( ( std::filesystem::path( folder ) / index.getPath( file ) ).string() );
+        }
+    }
+
+    // a worker takes its newest task first, so the files the index gave are
+    // searched before the walk, while other workers steal the walk
+    submit( state, [this, state, folder]() { walkIndexed( state, folder, "" ); } );
+    for ( std::vector<std::string>& batch : batches )
+    {
+        submit( state, [this, state, files = std::move( batch )]() { searchFiles( state, files ); } );
+    }
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Reads a folder, comparing each file with the index, the files
+                that have changed are passed to indexFiles()
+    @param      state       search
+    @param      folder      folder to read
+    @param      relative    path of the folder in the index, ending in '/'
+                            unless it is the folder indexed
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDEProjectSearch::walkIndexed( const std::shared_ptr<SearchState>& state, const std::string& folder, const std::string& relative )
+{
+    const IDETrigramIndex&              index = *state->index;
+    std::error_code                     code;
+    std::vector<std::string>            files;
+    std::vector<ChangedFile>            changed;
+    std::filesystem::directory_iterator entry( folder, std::filesystem::directory_options::skip_permission_denied, code );
+
+    for ( ; !code && entry != std::filesystem::directory_iterator(); entry.increment( code ) )
+    {
+        if ( state->cancelled.load() )
+        {
+            return;
+        }
+
+        std::error_code statusCode;
+        std::string     name = entry->path().filename().string();
+        if ( entry->is_symlink( statusCode ) )
+        {
+            continue;
+        }
+        if ( entry->is_directory( statusCode ) )
+        {
+            if ( name.empty() == false && name[0] != '.' )
+            {
+                std::string path    = entry->path().string();
+                std::string inIndex = relative + name + "/";
+                submit( state, [this, state, path, inIndex]() { walkIndexed( state, path, inIndex ); } );
+            }
+            continue;
+        }
+        if ( entry->is_regular_file( statusCode ) == false )
+        {
+            continue;
+        }
+
+        ChangedFile found;
+        found.relative = relative + name;
+        found.file     = index.findFile( found.relative );
+        getFileStamp( *entry, found.stamp );
+        index.markSeen( state->update, found.file );
+        if ( index.isCurrent( found.file, found.stamp ) )
+        {
+            // the index is right about it, it only needs reading if the index could not narrow the search
+            if ( state->searchAll && ( index.getFlags( found.file ) & IDETrigramIndex::FLAG_BINARY ) == 0 )
+            {
+                files.push_back( entry->path().string() );
+                if ( files.size() == FILE_BATCH )
+                {
+                    submit( state, [this, state, batch = std::move( files )]() { searchFiles( state, batch ); } );
+                    files.clear();
+                }
+            }
+            continue;
+        }
+
+        found.path = entry->path().string();
+        changed.push_back( std::move( found ) );
+        if ( changed.size() == FILE_BATCH )
+        {
+            submit( state, [this, state, batch = std::move( changed )]() { indexFiles( state, batch ); } );
+            changed.clear();
+        }
+    }
+    searchFiles( state, files );
+    indexFiles( state, changed );
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Reads files that are new or changed, adding them to the index
+                and searching those that have not been searched
+    @param      state   search
+    @param      files   files to read
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDEProjectSearch::indexFiles( const std::shared_ptr<SearchState>& state, const std::vector<ChangedFile>& files )
+{
+    std::vector<SearchResult> results;
+
+    for ( const ChangedFile& changed : files )
+    {
+        MappedFile  file;
+        const char* data;
+        uint64_t    size;
+        if ( state->cancelled.load() )
+        {
+            return;
+        }
+        if ( readFile( changed.path, file, data, size ) == false )
+        {
+            state->filesSkipped.fetch_add( 1 );
+            continue;
+        }
+
+        bool binary   = size > 0 && isBinary( data, size );
+        bool modified = state->index->updateFile( state->update, changed.file, changed.relative, changed.stamp, data, size, binary );
+        bool searched = changed.file < state->candidate.size() && state->candidate[changed.file] != 0;
+        if ( modified )
+        {
+            state->filesIndexed.fetch_add( 1 );
+        }
+        if ( binary )
+        {
+            state->filesSkipped.fetch_add( 1 );
+        }
+        else if ( searched == false && ( modified || state->searchAll ) )
+        {
+            // a file the index did not give, whose contents the index did not know
+            state->filesSearched.fetch_add( 1 );
+            searchData( *state, changed.path, data, size, results );
+        }
+        if ( results.empty() == false )
+        {
+            std::lock_guard<std::mutex> guard( state->lock );
+            std::move( results.begin(), results.end(), std::back_inserter( state->found ) );
+            results.clear();
+        }
+    }
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Commits the changes an indexed search found, called once every
+                other task of the search has finished
+    @param      state   search
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDEProjectSearch::finishIndexed( SearchState& state )
+{
+    // files not seen are only removed when nothing cut the walk short
+    state.update.complete = state.cancelled.load() == false;
+    state.index->commit( state.update );
+
+    // the state is kept until the next search, the changes are not needed
+    std::vector<IDETrigramIndex::AddedFile>().swap( state.update.added );
+    std::vector<uint8_t>().swap( state.update.seen );
+    std::vector<uint8_t>().swap( state.candidate );
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Searches a file, a line holding a match is found once
+    @param      state   search
+    @param      path    file to search
+    @param      results lines found are added to the end
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDEProjectSearch::searchFile( SearchState& state, const std::string& path, std::vector<SearchResult>& results )
+{
+    MappedFile  file;
+    const char* data;
+    uint64_t    size;
+
+    if ( readFile( path, file, data, size ) == false )
+    {
+        state.filesSkipped.fetch_add( 1 );
+        return;
+    }
+    if ( size > 0 && isBinary( data, size ) )
+    {
+        state.filesSkipped.fetch_add( 1 );
+        return;
+    }
+    state.filesSearched.fetch_add( 1 );
+    searchData( state, path, data, size, results );
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Reads a file, a small file into a buffer kept by each thread,
+                which holds it until the thread's next read, a larger file
+                is mapped
+    @param      path    file to read
+    @param      file    maps a larger file
+    @param      data    set to the contents
+    @param      size    set to the length
+    @return     bool    false if the file could not be read
+-----------------------------------------------------------------------------*/
+bool IDEProjectSearch::readFile( const std::string& path, MappedFile& file, const char*& data, uint64_t& size )
+{
+    static thread_local std::vector<char> buffer( SMALL_FILE );
+
+    // a small file is read whole, mapping costs more than the read saves
+    FILE* handle = fopen( path.c_str(), "rb" );
+    if ( handle == nullptr )
+    {
+        return false;
+    }
+    data = buffer.data();
+    size = fread( buffer.data(), 1, buffer.size(), handle );
+    fclose( handle );
+    if ( size == buffer.size() )
+    {
+        if ( file.open( path ) != LibraryError::No_Error )
+        {
+            return false;
+        }
+        data = file.getData();
+        size = file.getSize();
+    }
+    return true;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Searches the contents of a file, a line holding a match is
+                found once
+    @param      state   search
+    @param      path    file searched
+    @param      data    contents
+    @param      size    length of the contents
+    @param      results lines found are added to the end
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDEProjectSearch::searchData( SearchState& state, const std::string& path, const char* data, uint64_t size, std::vector<SearchResult>& results )
+{
+    if ( size == 0 )
+    {
+        return;
+    }
+
+    uint32_t line     = 1;
+    uint64_t counted  = 0;
+    uint64_t position = state.search.findNext( data, size, 0 );
+    while ( position != IDESearch::NOT_FOUND && state.cancelled.load() == false )
+    {
+        // lines are only counted up to each match
+        const char* feed = data + counted;
+        while ( ( feed = (const char*)memchr( feed, '\n', position - ( feed - data ) ) ) != nullptr )
+        {
+            line++;
+            feed++;
+        }
+        counted = position;
+
+        uint64_t lineStart = position;
+        while ( lineStart > 0 && data[lineStart - 1] != '\n' )
+        {
+            lineStart--;
+        }
+        const char* lineEnd = (const char*)memchr( data + position, '\n', size - position );
+        uint64_t    next    = ( lineEnd != nullptr ) ? (uint64_t)( lineEnd - data ) : size;
+
+        SearchResult result;
+        result.path   = path;
+        result.line   = line;
+        result.column = (uint32_t)( position - lineStart );
+        result.text.assign( data + lineStart, std::min<uint64_t>( next - lineStart, MAX_LINE_TEXT ) );
+        if ( result.text.empty() == false && result.text.back() == '\r' )
+        {
+            result.text.pop_back();
+        }
+        results.push_back( std::move( result ) );
+
+        if ( state.matchCount.fetch_add( 1 ) + 1 >= MAX_RESULTS )
+        {
+            state.cancelled.store( true );
+            break;
+        }
+        position = ( next < size ) ? state.search.findNext( data, size, next + 1 ) : IDESearch::NOT_FOUND;
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: IDEProjectSearch.cpp
+// ----------------------------------------------------------------------------
@@ -0,0 +1,411 @@
+/**----------------------------------------------------------------------------
+
+    @file       IDEQuickOpen.cpp
+    @defgroup   NimbleLIBIDE Nimble Library IDE Module
+    @brief      IDEQuickOpen class for the Nimble Library
+
+    @copyright  Neil Bereford 2023
+
+Notes:
+
+    The quick open palette lists every file below the project folder, from
+    the IDEProjectFiles kept by the IDEManager, so it opens at once with
+    the list of the last walk while the folder is walked again for changes.
+    The new list is taken on the next frame after the walk finishes.
+
+    Typing filters the list, the paths holding the typed characters in
+    order are shown best match first, backspace takes the last character
+    off. The paths were indexed by the IDEFuzzyFilter as they were listed,
+    so a key only scores them, narrowing the last matches where the query
+    adds to the last one, and scoring them on every core for a project of
+    more than IDEFuzzyFilter::PARALLEL_THRESHOLD files. The time the
+    filter took is shown with the matches.
+
+    The list is shown by an IDEListView, which asks for the text of only
+    the rows on screen, a path too long for the row is shown by its end,
+    the name of the file. Enter, or the Open button, chooses the file under
+    the cursor, getFilename() gives its path with the project folder.
+
+-----------------------------------------------------------------------------*/
+//-----------------------------------------------------------------------------
+// Include files
+// ----------------------------------------------------------------------------
+
+#include <chrono>
+#include <cstdint>
+#include <numeric>
+#include "../../../inc/Modules/Curses/CursesColour.h"
+#include "../../../inc/Modules/Curses/CursesKeyboard.h"
+#include "../../../inc/Modules/IDE/IDEQuickOpen.h"
+
+//-----------------------------------------------------------------------------
+// Namespace
+// ----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+// constructors & destructors -------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Constructor for IDEQuickOpen class
+
+----------------------------------------------------------------------------*/
+IDEQuickOpen::IDEQuickOpen()
+{
+    m_files      = nullptr;
+    m_filterTime = 0;
+    m_cancelled  = false;
+    m_completed  = false;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Destructor for IDEQuickOpen class
+
+----------------------------------------------------------------------------*/
+IDEQuickOpen::~IDEQuickOpen()
+{
+}
+
+// Initialisation -------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Initialise the Quick Open palette
+    @param      files       files of the project, refreshed by the caller
+    @param      titleDialog Title of the dialog
+    @return     LibraryError
+----------------------------------------------------------------------------*/
+LibraryError IDEQuickOpen::initQuickOpen( IDEProjectFiles& files, const std::string titleDialog )
+{
+    LibraryError error  = LibraryError::No_Error;
+    uint32_t     width  = m_kDialogWidth;
+    uint32_t     height = m_kDialogHeight;
+    uint32_t     xPos   = ( COLS / 2 ) - ( width / 2 );
+    uint32_t     yPos   = ( LINES / 2 ) - ( height / 2 );
+
+    m_files       = &files;
+    m_titleDialog = titleDialog;
+
+    initDialog( xPos, yPos, width, height, IDE_COL_FG_BLACK, IDE_COL_BG_WHITE );
+    title( m_titleDialog );
+
+    m_listView.init( getWindow(), 3, 3, m_kListWidth, getHeight() - 9, COLOUR_INDEX( IDE_COL_FG_BLACK, IDE_COL_BG_WHITE ),
+                     std::bind( &IDEQuickOpen::getRow, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3 ) );
+    m_files->poll();
+    applyFilter();
+
+    // every printable character, and backspace, goes to the filter
+    m_keyMapFilterControl.keys = { 8, 127, KEY_BACKSPACE };
+    for ( uint32_t key = ' '; key <= '~'; key++ )
+    {
+        m_keyMapFilterControl.keys.push_back( key );
+    }
+
+    addKeyMap( m_keyMapCursorControl );
+    addKeyMap( m_keyMapDialogControl );
+    addKeyMap( m_keyMapFilterControl );
+
+    buttons( getWindow(), "Cancel", "Open" );
+    updateStatus();
+    return error;
+}
+
+// Display --------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Draw the Quick Open palette
+    @return     LibraryError
+----------------------------------------------------------------------------*/
+LibraryError IDEQuickOpen::drawQuickOpen()
+{
+    LibraryError error = LibraryError::No_Error;
+    uint32_t     count = m_listView.getItemCount();
+
+    setVerticalScrollPos( ( count > 1 ) ? ( m_listView.getCursor() * 100 ) / ( count - 1 ) : 0 );
+    drawDialog();
+    // only the rows of files that have changed are drawn
+    m_listView.draw( COLOUR_INDEX( IDE_COL_FG_WHITE, IDE_COL_BG_BLACK ) );
+    draw();
+    refresh();
+    return error;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup   NimbleLIBIDE Nimble Library IDE Module
+    @brief     Process the Quick Open palette
+    @param     ch      Key pressed returned or ERR
+    @return    LibraryError
+----------------------------------------------------------------------------*/
+LibraryError IDEQuickOpen::processKeyPress( uint32_t ch )
+{
+    LibraryError error = LibraryError::No_Error;
+
+    // the list of a walk finished since the last frame
+    if ( m_files->poll() )
+    {
+        applyFilter();
+    }
+    processDialog( ch );
+    updateStatus();
+    // check the button presses by the mouse...
+    if ( isLeftButtonPressed() )
+    {
+        m_cancelled = true;
+    }
+    if ( isRightButtonPressed() )
+    {
+        m_completed = true;
+    }
+    // the file under the cursor is the one chosen
+    if ( m_completed && m_visible.empty() == false )
+    {
+        m_filename = m_files->getFullPath( m_visible[m_listView.getCursor()] );
+    }
+
+    return error;
+}
+
+// Control --------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Moves the cursor through the files
+    @param      ch  Character to process
+    @return     void
+----------------------------------------------------------------------------*/
+void IDEQuickOpen::cursorControl( uint32_t ch )
+{
+    switch ( ch )
+    {
+        case KEY_UP:
+        {
+            m_listView.moveCursor( -1 );
+            break;
+        }
+        case KEY_DOWN:
+        {
+            m_listView.moveCursor( 1 );
+            break;
+        }
+        case KEY_PPAGE:
+        {
+            m_listView.moveCursor( -(int32_t)m_listView.getRows() );
+            break;
+        }
+        case KEY_NPAGE:
+        {
+            m_listView.moveCursor( (int32_t)m_listView.getRows() );
+            break;
+        }
+        case KEY_HOME:
+        {
+            m_listView.setCursor( 0 );
+            break;
+        }
+        case KEY_END:
+        {
+            m_listView.setCursor( ( m_listView.getItemCount() > 0 ) ? m_listView.getItemCount() - 1 : 0 );
+            break;
+        }
+        default:
+        {
+            break;
+        }
+    }
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Closes the palette, choosing the file under the cursor
+    @param      ch  Character to process
+    @return     void
+----------------------------------------------------------------------------*/
+void IDEQuickOpen::dialogControl( uint32_t ch )
+{
+    switch ( ch )
+    {
+        case KEY_ESC:
+        {
+            m_cancelled = true;
+            break;
+        }
+        case KEY_ENTER:
+        case '\n':
+        {
+            m_completed = true;
+            break;
+        }
+        default:
+        {
+            break;
+        }
+    }
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Adds a typed character to the filter, or takes the last one
+                off for backspace, the best match is put under the cursor
+    @param      ch  Character to process
+    @return     void
+----------------------------------------------------------------------------*/
+void IDEQuickOpen::filterControl( uint32_t ch )
+{
+    if ( ch == 8 || ch == 127 || ch == KEY_BACKSPACE )
+    {
+        if ( m_query.empty() )
+        {
+            return;
+        }
+        m_query.pop_back();
+    }
+    else if ( m_query.size() < m_kMaxFilter )
+    {
+        m_query += (char)ch;
+    }
+    else
+    {
+        return;
+    }
+    applyFilter();
+    m_listView.setCursor( 0 );
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Sets the files shown, every file in order without a filter,
+                the files matching it best first with one
+    @return     void
+----------------------------------------------------------------------------*/
+void IDEQuickOpen::applyFilter()
+{
+    auto start = std::chrono::steady_clock::now();
+
+    if ( m_query.empty() )
+    {
+        m_visible.resize( m_files->getPaths().size() );
+        std::iota( m_visible.begin(), m_visible.end(), 0 );
+    }
+    else
+    {
+        const auto& matches = m_files->getFilter().filter( m_query );
+        m_visible.resize( matches.size() );
+        for ( size_t index = 0; index < matches.size(); index++ )
+        {
+            m_visible[index] = matches[index].item;
+        }
+    }
+    m_listView.setItemCount( (uint32_t)m_visible.size() );
+    m_filterTime = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>( std::chrono::steady_clock::now() - start ).count();
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Gets a row of the list, a path too long for the row is shown
+                by its end
+    @param      item    row of the list
+    @param      text    set to the path of the file
+    @param      colour  set to the colour of the row
+    @return     void
+----------------------------------------------------------------------------*/
+void IDEQuickOpen::getRow( uint32_t item, std::string& text, uint32_t& colour ) const
+{
+    const std::string& path = m_files->getPaths()[m_visible[item]];
+
+    if ( path.size() > m_kListWidth )
+    {
+        text.assign( "..." );
+        text.append( path, path.size() - ( m_kListWidth - 3 ), std::string::npos );
+    }
+    else
+    {
+        text.assign( path );
+    }
+    colour = COLOUR_INDEX( IDE_COL_FG_BLACK, IDE_COL_BG_WHITE );
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Shows the filter in the status bar, or what the palette is
+                doing when there is none
+    @return     void
+----------------------------------------------------------------------------*/
+void IDEQuickOpen::updateStatus()
+{
+    std::string statusString;
+
+    if ( m_query.empty() == false )
+    {
+        statusString = "Filter: " + m_query + " (" + std::to_string( m_visible.size() ) + " matches, " + std::to_string( m_filterTime / 1000 ) + "." +
+                       std::to_string( ( m_filterTime / 100 ) % 10 ) + " ms)";
+    }
+    else if ( m_files->isRefreshing() && m_visible.empty() )
+    {
+        statusString = "Listing project files...";
+    }
+    else
+    {
+        statusString = "Type to find a file (" + std::to_string( m_visible.size() ) + " files)";
+    }
+    // the status bar is not cleared, so a shorter string covers the last
+    statusString.resize( getWidth() - 4, ' ' );
+    status( statusString );
+}
+
+// Getters --------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Get the path of the file chosen, with the project folder
+    @return     std::string     path, empty if no file was chosen
+----------------------------------------------------------------------------*/
+const std::string& IDEQuickOpen::getFilename() const
+{
+    return m_filename;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Get the completed flag
+    @return     bool
+----------------------------------------------------------------------------*/
+bool IDEQuickOpen::isCompleted() const
+{
+    return m_completed;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Get the cancelled flag
+    @return     bool
+----------------------------------------------------------------------------*/
+bool IDEQuickOpen::isCancelled() const
+{
+    return m_cancelled;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Get the time the last filter took
+    @return     uint64_t    microseconds
+----------------------------------------------------------------------------*/
+uint64_t IDEQuickOpen::getFilterTime() const
+{
+    return m_filterTime;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: IDEQuickOpen.cpp
+// ----------------------------------------------------------------------------
@@ -0,0 +1,722 @@
+/**----------------------------------------------------------------------------
+
+    @file       IDESearch.cpp
+    @defgroup   NimbleLIBIDE Nimble Library IDE Module
+    @brief      IDESearch class for the Nimble Library
+
+    @copyright  Neil Bereford 2023
+
+Notes:
+
+    A position can only match if the text there starts with the first byte
+    of the pattern and has the last byte of the pattern pattern-length - 1
+    bytes later. Both bytes are compared for 32 positions at once with AVX2,
+    or 16 with SSE2, and only the positions that pass are compared in full.
+    AVX2 is chosen at run time, SSE2 is always present on x86-64, other
+    processors use the scalar scan.
+
+    When case is ignored a letter is compared with bit 0x20 set on both
+    sides, which maps upper to lower case. Other bytes that change with the
+    same bit only add candidates, the full compare rejects them.
+
+    Whole word matches must not have a letter, digit or '_' either side.
+
+    Text held in pieces is searched a piece at a time, in place. Only the
+    few bytes either side of a boundary between pieces are copied, to find
+    a match that starts in one piece and carries on into the next, so the
+    document is never copied into one block to be searched.
+
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// Include files
+// ----------------------------------------------------------------------------
+
+#include "../../../inc/Modules/IDE/IDESearch.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+#if defined( __x86_64__ ) || defined( _M_X64 )
+#define SEARCH_X86_64
+#include <immintrin.h>
+#if defined( _MSC_VER )
+#include <intrin.h>
+#define SEARCH_AVX2_TARGET
+#else
+#define SEARCH_AVX2_TARGET __attribute__( ( target( "avx2" ) ) )
+#endif
+#endif
+
+//-----------------------------------------------------------------------------
+// Namespace
+// ----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Local functions
+// ----------------------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      returns the index of the lowest set bit
+    @param      mask    non zero bit mask
+    @return     uint32_t    bit index
+------------------------------------------------------------------------------*/
+static inline uint32_t lowestBit( uint32_t mask )
+{
+#if defined( _MSC_VER )
+    unsigned long index;
+    _BitScanForward( &index, mask );
+    return (uint32_t)index;
+#else
+    return (uint32_t)__builtin_ctz( mask );
+#endif
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      copies a range of text held in pieces, walking back or on
+                from a known piece
+    @param      spans   pieces of the text, in order
+    @param      index   piece to start from
+    @param      base    position of the first byte of that piece
+    @param      start   first position to copy
+    @param      end     position after the last byte, clipped to the text
+    @param      text    set to the bytes copied
+    @return     void
+------------------------------------------------------------------------------*/
+static void copySpans( const std::vector<std::string_view>& spans, size_t index, uint64_t base, uint64_t start, uint64_t end, std::string& text )
+{
+    text.clear();
+    while ( start < base && index > 0 )
+    {
+        index--;
+        base -= spans[index].size();
+    }
+    for ( ; index < spans.size() && base < end; index++ )
+    {
+        uint64_t first = std::max( start, base );
+        uint64_t last  = std::min<uint64_t>( end, base + spans[index].size() );
+        if ( first < last )
+        {
+            text.append( spans[index].data() + ( first - base ), last - first );
+        }
+        base += spans[index].size();
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+// Constructor & Destructor -----------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      IDESearch Constructor
+
+------------------------------------------------------------------------------*/
+IDESearch::IDESearch()
+{
+    m_useAvx2 = isAvx2Supported();
+    setPattern( std::string(), true, false );
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      IDESearch Destructor
+
+------------------------------------------------------------------------------*/
+IDESearch::~IDESearch()
+{
+}
+
+// setters ---------------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      sets the text to find
+    @param      pattern     text to find
+    @param      matchCase   true if the case must match
+    @param      wholeWord   true to only match whole words
+    @return     void
+------------------------------------------------------------------------------*/
+void IDESearch::setPattern( const std::string& pattern, bool matchCase, bool wholeWord )
+{
+    m_pattern   = pattern;
+    m_matchCase = matchCase;
+    m_wholeWord = wholeWord;
+    m_first     = 0;
+    m_last      = 0;
+    m_firstFold = 0;
+    m_lastFold  = 0;
+
+    if ( m_pattern.empty() == false )
+    {
+        m_first = (uint8_t)m_pattern.front();
+        m_last  = (uint8_t)m_pattern.back();
+        if ( m_matchCase == false && isalpha( m_first ) )
+        {
+            m_firstFold = 0x20;
+            m_first |= m_firstFold;
+        }
+        if ( m_matchCase == false && isalpha( m_last ) )
+        {
+            m_lastFold = 0x20;
+            m_last |= m_lastFold;
+        }
+    }
+}
+
+// getters ---------------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      returns the text to find
+    @return     const std::string&  pattern
+------------------------------------------------------------------------------*/
+const std::string& IDESearch::getPattern() const
+{
+    return m_pattern;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      returns if the case must match
+    @return     bool    true if case sensitive
+------------------------------------------------------------------------------*/
+bool IDESearch::isMatchCase() const
+{
+    return m_matchCase;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      returns if only whole words match
+    @return     bool    true if whole words only
+------------------------------------------------------------------------------*/
+bool IDESearch::isWholeWord() const
+{
+    return m_wholeWord;
+}
+
+// searching -------------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      finds the first match at or after a position
+    @param      data    text to search
+    @param      size    length of the text
+    @param      from    first position to check
+    @return     uint64_t    position of the match, NOT_FOUND if none
+------------------------------------------------------------------------------*/
+uint64_t IDESearch::findNext( const char* data, uint64_t size, uint64_t from ) const
+{
+    uint64_t position = nextCandidate( data, size, from );
+
+    while ( position != NOT_FOUND && isMatch( data, size, position ) == false )
+    {
+        position = nextCandidate( data, size, position + 1 );
+    }
+    return position;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      finds the last match that starts before a position
+    @param      data    text to search
+    @param      size    length of the text
+    @param      before  matches must start before this position
+    @return     uint64_t    position of the match, NOT_FOUND if none
+------------------------------------------------------------------------------*/
+uint64_t IDESearch::findPrevious( const char* data, uint64_t size, uint64_t before ) const
+{
+    uint64_t length = m_pattern.size();
+
+    if ( length == 0 || length > size )
+    {
+        return NOT_FOUND;
+    }
+
+    uint64_t position = std::min( before, size - length + 1 );
+    while ( position > 0 )
+    {
+        position--;
+        if ( ( (uint8_t)data[position] | m_firstFold ) == m_first && ( (uint8_t)data[position + length - 1] | m_lastFold ) == m_last && isMatch( data, size, position ) )
+        {
+            return position;
+        }
+    }
+    return NOT_FOUND;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      finds every match, matches do not overlap
+    @param      data    text to search
+    @param      size    length of the text
+    @param      matches filled with the position of each match
+    @return     uint64_t    number of matches
+------------------------------------------------------------------------------*/
+uint64_t IDESearch::findAll( const char* data, uint64_t size, std::vector<uint64_t>& matches ) const
+{
+    matches.clear();
+
+    uint64_t position = findNext( data, size, 0 );
+    while ( position != NOT_FOUND )
+    {
+        matches.push_back( position );
+        position = findNext( data, size, position + m_pattern.size() );
+    }
+    return matches.size();
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      finds the first match at or after a position in text held
+                in pieces, a match may run across several pieces
+    @param      spans   pieces of the text, in order
+    @param      from    first position to check
+    @return     uint64_t    position of the match, NOT_FOUND if none
+------------------------------------------------------------------------------*/
+uint64_t IDESearch::findNext( const std::vector<std::string_view>& spans, uint64_t from ) const
+{
+    size_t   index = 0;
+    uint64_t base  = 0;
+    return findNextInSpans( spans, from, index, base );
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      finds the last match that starts before a position in text
+                held in pieces
+    @param      spans   pieces of the text, in order
+    @param      before  matches must start before this position
+    @return     uint64_t    position of the match, NOT_FOUND if none
+------------------------------------------------------------------------------*/
+uint64_t IDESearch::findPrevious( const std::vector<std::string_view>& spans, uint64_t before ) const
+{
+    size_t   index = 0;
+    uint64_t base  = 0;
+
+    if ( spans.empty() || before == 0 )
+    {
+        return NOT_FOUND;
+    }
+    while ( index + 1 < spans.size() && base + spans[index].size() < before )
+    {
+        base += spans[index].size();
+        index++;
+    }
+
+    while ( true )
+    {
+        // matches running into the next piece start after those inside this one
+        uint64_t position = findAcrossSpans( spans, index, base, 0, before, true );
+        if ( position != NOT_FOUND )
+        {
+            return position;
+        }
+
+        std::string_view span = spans[index];
+        position              = findPrevious( span.data(), span.size(), std::min<uint64_t>( before - base, span.size() ) );
+        while ( position != NOT_FOUND && isSpanWordEdge( spans, index, base, position ) == false )
+        {
+            position = findPrevious( span.data(), span.size(), position );
+        }
+        if ( position != NOT_FOUND )
+        {
+            return base + position;
+        }
+
+        if ( index == 0 )
+        {
+            return NOT_FOUND;
+        }
+        index--;
+        base -= spans[index].size();
+    }
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      finds every match in text held in pieces, matches do not
+                overlap
+    @param      spans   pieces of the text, in order
+    @param      matches filled with the position of each match
+    @return     uint64_t    number of matches
+------------------------------------------------------------------------------*/
+uint64_t IDESearch::findAll( const std::vector<std::string_view>& spans, std::vector<uint64_t>& matches ) const
+{
+    size_t   index = 0;
+    uint64_t base  = 0;
+
+    matches.clear();
+
+    uint64_t position = findNextInSpans( spans, 0, index, base );
+    while ( position != NOT_FOUND )
+    {
+        matches.push_back( position );
+        position = findNextInSpans( spans, position + m_pattern.size(), index, base );
+    }
+    return matches.size();
+}
+
+// cpu support -----------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      checks if the processor and OS support AVX2
+    @return     bool    true if AVX2 can be used
+------------------------------------------------------------------------------*/
+bool IDESearch::isAvx2Supported()
+{
+#if defined( SEARCH_X86_64 ) && defined( _MSC_VER )
+    int info[4];
+    __cpuid( info, 1 );
+    bool osSaves = ( info[2] & ( 1 << 27 ) ) != 0 && ( info[2] & ( 1 << 28 ) ) != 0;
+    if ( osSaves == false || ( _xgetbv( 0 ) & 0x6 ) != 0x6 )
+    {
+        return false;
+    }
+    __cpuidex( info, 7, 0 );
+    return ( info[1] & ( 1 << 5 ) ) != 0;
+#elif defined( SEARCH_X86_64 )
+    return __builtin_cpu_supports( "avx2" );
+#else
+    return false;
+#endif
+}
+
+// private functions -----------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      finds the next position whose first and last bytes match
+    @param      data    text to search
+    @param      size    length of the text
+    @param      from    first position to check
+    @return     uint64_t    candidate position, NOT_FOUND if none
+------------------------------------------------------------------------------*/
+uint64_t IDESearch::nextCandidate( const char* data, uint64_t size, uint64_t from ) const
+{
+    if ( m_pattern.empty() || m_pattern.size() > size || from > size - m_pattern.size() )
+    {
+        return NOT_FOUND;
+    }
+#if defined( SEARCH_X86_64 )
+    return m_useAvx2 ? scanAvx2( data, size, from ) : scanSse2( data, size, from );
+#else
+    return scanScalar( data, size, from );
+#endif
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      candidate scan a byte at a time, also used for the tail of
+                the vector scans
+    @param      data    text to search
+    @param      size    length of the text
+    @param      from    first position to check
+    @return     uint64_t    candidate position, NOT_FOUND if none
+------------------------------------------------------------------------------*/
+uint64_t IDESearch::scanScalar( const char* data, uint64_t size, uint64_t from ) const
+{
+    uint64_t last = m_pattern.size() - 1;
+
+    for ( uint64_t position = from; position + last < size; position++ )
+    {
+        if ( ( (uint8_t)data[position] | m_firstFold ) == m_first && ( (uint8_t)data[position + last] | m_lastFold ) == m_last )
+        {
+            return position;
+        }
+    }
+    return NOT_FOUND;
+}
+
+#if defined( SEARCH_X86_64 )
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      candidate scan 16 positions at a time
+    @param      data    text to search
+    @param      size    length of the text
+    @param      from    first position to check
+    @return     uint64_t    candidate position, NOT_FOUND if none
+------------------------------------------------------------------------------*/
+uint64_t IDESearch::scanSse2( const char* data, uint64_t size, uint64_t from ) const
+{
+    uint64_t last      = m_pattern.size() - 1;
+    uint64_t position  = from;
+    __m128i  first     = _mm_set1_epi8( (char)m_first );
+    __m128i  lastByte  = _mm_set1_epi8( (char)m_last );
+    __m128i  firstFold = _mm_set1_epi8( (char)m_firstFold );
+    __m128i  lastFold  = _mm_set1_epi8( (char)m_lastFold );
+
+    while ( position + last + 16 <= size )
+    {
+        __m128i  start = _mm_or_si128( _mm_loadu_si128( (const __m128i*)( data + position ) ), firstFold );
+        __m128i  end   = _mm_or_si128( _mm_loadu_si128( (const __m128i*)( data + position + last ) ), lastFold );
+        uint32_t mask  = (uint32_t)_mm_movemask_epi8( _mm_and_si128( _mm_cmpeq_epi8( start, first ), _mm_cmpeq_epi8( end, lastByte ) ) );
+        if ( mask != 0 )
+        {
+            return position + lowestBit( mask );
+        }
+        position += 16;
+    }
+    return scanScalar( data, size, position );
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      candidate scan 32 positions at a time
+    @param      data    text to search
+    @param      size    length of the text
+    @param      from    first position to check
+    @return     uint64_t    candidate position, NOT_FOUND if none
+------------------------------------------------------------------------------*/
+SEARCH_AVX2_TARGET uint64_t IDESearch::scanAvx2( const char* data, uint64_t size, uint64_t from ) const
+{
+    uint64_t last      = m_pattern.size() - 1;
+    uint64_t position  = from;
+    __m256i  first     = _mm256_set1_epi8( (char)m_first );
+    __m256i  lastByte  = _mm256_set1_epi8( (char)m_last );
+    __m256i  firstFold = _mm256_set1_epi8( (char)m_firstFold );
+    __m256i  lastFold  = _mm256_set1_epi8( (char)m_lastFold );
+
+    while ( position + last + 32 <= size )
+    {
+        __m256i  start = _mm256_or_si256( _mm256_loadu_si256( (const __m256i*)( data + position ) ), firstFold );
+        __m256i  end   = _mm256_or_si256( _mm256_loadu_si256( (const __m256i*)( data + position + last ) ), lastFold );
+        uint32_t mask  = (uint32_t)_mm256_movemask_epi8( _mm256_and_si256( _mm256_cmpeq_epi8( start, first ), _mm256_cmpeq_epi8( end, lastByte ) ) );
+        if ( mask != 0 )
+        {
+            return position + lowestBit( mask );
+        }
+        position += 32;
+    }
+    return scanSse2( data, size, position );
+}
+
+#else
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      no SSE2 on this processor, scalar scan
+    @param      data    text to search
+    @param      size    length of the text
+    @param      from    first position to check
+    @return     uint64_t    candidate position, NOT_FOUND if none
+------------------------------------------------------------------------------*/
+uint64_t IDESearch::scanSse2( const char* data, uint64_t size, uint64_t from ) const
+{
+    return scanScalar( data, size, from );
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      no AVX2 on this processor, scalar scan
+    @param      data    text to search
+    @param      size    length of the text
+    @param      from    first position to check
+    @return     uint64_t    candidate position, NOT_FOUND if none
+------------------------------------------------------------------------------*/
+uint64_t IDESearch::scanAvx2( const char* data, uint64_t size, uint64_t from ) const
+{
+    return scanScalar( data, size, from );
+}
+
+#endif
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      checks a candidate in full, including the word boundaries
+    @param      data        text to search
+    @param      size        length of the text
+    @param      position    candidate position
+    @return     bool    true if the pattern matches at the position
+------------------------------------------------------------------------------*/
+bool IDESearch::isMatch( const char* data, uint64_t size, uint64_t position ) const
+{
+    uint64_t length = m_pattern.size();
+
+    if ( m_matchCase )
+    {
+        if ( memcmp( data + position, m_pattern.data(), length ) != 0 )
+        {
+            return false;
+        }
+    }
+    else
+    {
+        for ( uint64_t index = 0; index < length; index++ )
+        {
+            if ( tolower( (uint8_t)data[position + index] ) != tolower( (uint8_t)m_pattern[index] ) )
+            {
+                return false;
+            }
+        }
+    }
+
+    if ( m_wholeWord )
+    {
+        if ( position > 0 && isWordChar( (uint8_t)data[position - 1] ) )
+        {
+            return false;
+        }
+        if ( position + length < size && isWordChar( (uint8_t)data[position + length] ) )
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      checks if a byte can be part of a word
+    @param      ch  byte to check
+    @return     bool    true for letters, digits and '_'
+------------------------------------------------------------------------------*/
+bool IDESearch::isWordChar( uint8_t ch ) const
+{
+    return isalnum( ch ) || ch == '_';
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      finds the next match in text held in pieces, carrying on
+                from a known piece
+    @param      spans   pieces of the text, in order
+    @param      from    first position to check
+    @param      index   piece to start from, left on the piece of the match
+    @param      base    position of that piece, moved with index
+    @return     uint64_t    position of the match, NOT_FOUND if none
+------------------------------------------------------------------------------*/
+uint64_t IDESearch::findNextInSpans( const std::vector<std::string_view>& spans, uint64_t from, size_t& index, uint64_t& base ) const
+{
+    for ( ; index < spans.size(); base += spans[index].size(), index++ )
+    {
+        std::string_view span = spans[index];
+        if ( base + span.size() <= from )
+        {
+            continue;
+        }
+
+        // matches inside the piece come before those running into the next
+        uint64_t position = findNext( span.data(), span.size(), ( from > base ) ? from - base : 0 );
+        while ( position != NOT_FOUND && isSpanWordEdge( spans, index, base, position ) == false )
+        {
+            position = findNext( span.data(), span.size(), position + 1 );
+        }
+        if ( position != NOT_FOUND )
+        {
+            return base + position;
+        }
+
+        position = findAcrossSpans( spans, index, base, from, UINT64_MAX, false );
+        if ( position != NOT_FOUND )
+        {
+            return position;
+        }
+    }
+    return NOT_FOUND;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      finds a match that starts in a piece and ends in a later one,
+                the bytes either side of the end of the piece are copied and
+                searched
+    @param      spans       pieces of the text, in order
+    @param      index       piece the match starts in
+    @param      base        position of that piece
+    @param      from        matches must start at or after this position
+    @param      before      matches must start before this position
+    @param      lastMatch   true for the last match, otherwise the first
+    @return     uint64_t    position of the match, NOT_FOUND if none
+------------------------------------------------------------------------------*/
+uint64_t IDESearch::findAcrossSpans( const std::vector<std::string_view>& spans, size_t index, uint64_t base, uint64_t from, uint64_t before, bool lastMatch ) const
+{
+    uint64_t length = m_pattern.size();
+    uint64_t end    = base + spans[index].size();
+
+    if ( length < 2 )
+    {
+        return NOT_FOUND;
+    }
+
+    // only the last length - 1 bytes of the piece can start such a match
+    uint64_t first = std::max( { base, ( end + 1 > length ) ? end + 1 - length : 0, from } );
+    uint64_t last  = std::min( end, before );
+    if ( first >= last )
+    {
+        return NOT_FOUND;
+    }
+
+    // one byte either side is kept for the whole word check
+    std::string seam;
+    uint64_t    seamStart = ( first > 0 ) ? first - 1 : 0;
+    copySpans( spans, index, base, seamStart, end + length, seam );
+
+    for ( uint64_t count = 0; count < last - first; count++ )
+    {
+        uint64_t position = lastMatch ? last - 1 - count : first + count;
+        uint64_t local    = position - seamStart;
+        if ( local + length <= seam.size() && isMatch( seam.data(), seam.size(), local ) )
+        {
+            return position;
+        }
+    }
+    return NOT_FOUND;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      checks the word boundaries of a match found inside a piece
+                that touches either end of it, against the bytes of the
+                pieces next to it
+    @param      spans       pieces of the text, in order
+    @param      index       piece of the match
+    @param      base        position of that piece
+    @param      position    match position within the piece
+    @return     bool    true if the match is kept
+------------------------------------------------------------------------------*/
+bool IDESearch::isSpanWordEdge( const std::vector<std::string_view>& spans, size_t index, uint64_t base, uint64_t position ) const
+{
+    uint64_t    end = base + spans[index].size();
+    std::string edge;
+
+    if ( m_wholeWord == false )
+    {
+        return true;
+    }
+    if ( position == 0 && base > 0 )
+    {
+        copySpans( spans, index, base, base - 1, base, edge );
+        if ( edge.empty() == false && isWordChar( (uint8_t)edge[0] ) )
+        {
+            return false;
+        }
+    }
+    if ( position + m_pattern.size() == spans[index].size() )
+    {
+        copySpans( spans, index, base, end, end + 1, edge );
+        if ( edge.empty() == false && isWordChar( (uint8_t)edge[0] ) )
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: IDESearch.cpp
+// ----------------------------------------------------------------------------
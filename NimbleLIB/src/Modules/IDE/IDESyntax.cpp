@@ -0,0 +1,756 @@
+/**----------------------------------------------------------------------------
+
+    @file       IDESyntax.cpp
+    @defgroup   NimbleLIBIDE Nimble Library IDE Module
+    @brief      IDESyntax class for the Nimble Library
+
+    @copyright  Neil Bereford 2023
+
+Notes:
+
+    Each byte is looked up in CHAR_CLASS to pick how the token starting
+    there is scanned, identifiers are then looked up in the sorted KEYWORDS
+    table.
+
+    Only block comments, raw strings and backslash continued strings and
+    line comments carry on to the next line, so that is all a LexState
+    holds. m_lineEnd has the state at the end of every line. After an edit
+    linesChanged() marks the edited lines, update() lexes from the first of
+    them and stops at the first line after the edit whose end state is the
+    same as before, every line below it is unchanged. update() is only asked
+    to go as far as the last line shown, the rest is lexed when scrolled to.
+
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// Include files
+// ----------------------------------------------------------------------------
+
+#include "../../../inc/Modules/IDE/IDESyntax.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <filesystem>
+
+//-----------------------------------------------------------------------------
+// Namespace
+// ----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Local data
+// ----------------------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Character classes, the start of a token
+------------------------------------------------------------------------------*/
+enum CharClass : uint8_t
+{
+    CC_OTHER = 0, //!< operators and punctuation
+    CC_SPACE,     //!< white space
+    CC_IDENT,     //!< letter or '_'
+    CC_DIGIT,     //!< 0 to 9
+    CC_QUOTE,     //!< '"'
+    CC_CHAR,      //!< '\''
+    CC_SLASH,     //!< '/'
+    CC_HASH,      //!< '#'
+    CC_DOT,       //!< '.'
+};
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Character class of every byte
+------------------------------------------------------------------------------*/
+static constexpr std::array<uint8_t, 256> CHAR_CLASS = []()
+{
+    std::array<uint8_t, 256> table = {};
+    for ( uint32_t ch = 'a'; ch <= 'z'; ch++ )
+    {
+        table[ch]        = CC_IDENT;
+        table[ch - 0x20] = CC_IDENT;
+    }
+    for ( uint32_t ch = '0'; ch <= '9'; ch++ )
+    {
+        table[ch] = CC_DIGIT;
+    }
+    table['_']  = CC_IDENT;
+    table[' ']  = CC_SPACE;
+    table['\t'] = CC_SPACE;
+    table['\r'] = CC_SPACE;
+    table['"']  = CC_QUOTE;
+    table['\''] = CC_CHAR;
+    table['/']  = CC_SLASH;
+    table['#']  = CC_HASH;
+    table['.']  = CC_DOT;
+    return table;
+}();
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Keyword table entry
+------------------------------------------------------------------------------*/
+struct Keyword
+{
+    std::string_view     word; //!< keyword text
+    IDESyntax::TokenType type; //!< Keyword or Type
+};
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      C / C++ keywords and types, sorted for a binary search
+------------------------------------------------------------------------------*/
+static constexpr Keyword KEYWORDS[] = {
+    { "alignas", IDESyntax::TokenType::Keyword },
+    { "alignof", IDESyntax::TokenType::Keyword },
+    { "asm", IDESyntax::TokenType::Keyword },
+    { "auto", IDESyntax::TokenType::Type },
+    { "bool", IDESyntax::TokenType::Type },
+    { "break", IDESyntax::TokenType::Keyword },
+    { "case", IDESyntax::TokenType::Keyword },
+    { "catch", IDESyntax::TokenType::Keyword },
+    { "char", IDESyntax::TokenType::Type },
+    { "char16_t", IDESyntax::TokenType::Type },
+    { "char32_t", IDESyntax::TokenType::Type },
+    { "char8_t", IDESyntax::TokenType::Type },
+    { "class", IDESyntax::TokenType::Keyword },
+    { "co_await", IDESyntax::TokenType::Keyword },
+    { "co_return", IDESyntax::TokenType::Keyword },
+    { "co_yield", IDESyntax::TokenType::Keyword },
+    { "concept", IDESyntax::TokenType::Keyword },
+    { "const", IDESyntax::TokenType::Keyword },
+    { "const_cast", IDESyntax::TokenType::Keyword },
+    { "consteval", IDESyntax::TokenType::Keyword },
+    { "constexpr", IDESyntax::TokenType::Keyword },
+    { "constinit", IDESyntax::TokenType::Keyword },
+    { "continue", IDESyntax::TokenType::Keyword },
+    { "decltype", IDESyntax::TokenType::Keyword },
+    { "default", IDESyntax::TokenType::Keyword },
+    { "delete", IDESyntax::TokenType::Keyword },
+    { "do", IDESyntax::TokenType::Keyword },
+    { "double", IDESyntax::TokenType::Type },
+    { "dynamic_cast", IDESyntax::TokenType::Keyword },
+    { "else", IDESyntax::TokenType::Keyword },
+    { "enum", IDESyntax::TokenType::Keyword },
+    { "explicit", IDESyntax::TokenType::Keyword },
+    { "export", IDESyntax::TokenType::Keyword },
+    { "extern", IDESyntax::TokenType::Keyword },
+    { "false", IDESyntax::TokenType::Keyword },
+    { "final", IDESyntax::TokenType::Keyword },
+    { "float", IDESyntax::TokenType::Type },
+    { "for", IDESyntax::TokenType::Keyword },
+    { "friend", IDESyntax::TokenType::Keyword },
+    { "goto", IDESyntax::TokenType::Keyword },
+    { "if", IDESyntax::TokenType::Keyword },
+    { "inline", IDESyntax::TokenType::Keyword },
+    { "int", IDESyntax::TokenType::Type },
+    { "int16_t", IDESyntax::TokenType::Type },
+    { "int32_t", IDESyntax::TokenType::Type },
+    { "int64_t", IDESyntax::TokenType::Type },
+    { "int8_t", IDESyntax::TokenType::Type },
+    { "long", IDESyntax::TokenType::Type },
+    { "mutable", IDESyntax::TokenType::Keyword },
+    { "namespace", IDESyntax::TokenType::Keyword },
+    { "new", IDESyntax::TokenType::Keyword },
+    { "noexcept", IDESyntax::TokenType::Keyword },
+    { "nullptr", IDESyntax::TokenType::Keyword },
+    { "operator", IDESyntax::TokenType::Keyword },
+    { "override", IDESyntax::TokenType::Keyword },
+    { "private", IDESyntax::TokenType::Keyword },
+    { "protected", IDESyntax::TokenType::Keyword },
+    { "public", IDESyntax::TokenType::Keyword },
+    { "register", IDESyntax::TokenType::Keyword },
+    { "reinterpret_cast", IDESyntax::TokenType::Keyword },
+    { "requires", IDESyntax::TokenType::Keyword },
+    { "return", IDESyntax::TokenType::Keyword },
+    { "short", IDESyntax::TokenType::Type },
+    { "signed", IDESyntax::TokenType::Type },
+    { "size_t", IDESyntax::TokenType::Type },
+    { "sizeof", IDESyntax::TokenType::Keyword },
+    { "static", IDESyntax::TokenType::Keyword },
+    { "static_assert", IDESyntax::TokenType::Keyword },
+    { "static_cast", IDESyntax::TokenType::Keyword },
+    { "struct", IDESyntax::TokenType::Keyword },
+    { "switch", IDESyntax::TokenType::Keyword },
+    { "template", IDESyntax::TokenType::Keyword },
+    { "this", IDESyntax::TokenType::Keyword },
+    { "thread_local", IDESyntax::TokenType::Keyword },
+    { "throw", IDESyntax::TokenType::Keyword },
+    { "true", IDESyntax::TokenType::Keyword },
+    { "try", IDESyntax::TokenType::Keyword },
+    { "typedef", IDESyntax::TokenType::Keyword },
+    { "typeid", IDESyntax::TokenType::Keyword },
+    { "typename", IDESyntax::TokenType::Keyword },
+    { "uint16_t", IDESyntax::TokenType::Type },
+    { "uint32_t", IDESyntax::TokenType::Type },
+    { "uint64_t", IDESyntax::TokenType::Type },
+    { "uint8_t", IDESyntax::TokenType::Type },
+    { "union", IDESyntax::TokenType::Keyword },
+    { "unsigned", IDESyntax::TokenType::Type },
+    { "using", IDESyntax::TokenType::Keyword },
+    { "virtual", IDESyntax::TokenType::Keyword },
+    { "void", IDESyntax::TokenType::Type },
+    { "volatile", IDESyntax::TokenType::Keyword },
+    { "wchar_t", IDESyntax::TokenType::Type },
+    { "while", IDESyntax::TokenType::Keyword },
+};
+
+static_assert( std::is_sorted( std::begin( KEYWORDS ), std::end( KEYWORDS ), []( const Keyword& a, const Keyword& b ) { return a.word < b.word; } ), "KEYWORDS must be sorted" );
+
+//-----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+// Constructor & Destructor -----------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      IDESyntax Constructor
+
+------------------------------------------------------------------------------*/
+IDESyntax::IDESyntax()
+{
+    clear();
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      IDESyntax Destructor
+
+------------------------------------------------------------------------------*/
+IDESyntax::~IDESyntax()
+{
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      compares two lexer states
+    @param      other   state to compare with
+    @return     bool    true if the same
+------------------------------------------------------------------------------*/
+bool IDESyntax::LexState::operator==( const LexState& other ) const
+{
+    return mode == other.mode && delimiterLength == other.delimiterLength && memcmp( delimiter, other.delimiter, delimiterLength ) == 0;
+}
+
+// line cache ------------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      forgets every cached state, used when a document is loaded
+                or changed in more than a few lines
+    @return     void
+------------------------------------------------------------------------------*/
+void IDESyntax::clear()
+{
+    m_lineEnd.clear();
+    m_dirtyFrom  = 0;
+    m_dirtyTo    = 0;
+    m_lexedTo    = 0;
+    m_linesLexed = 0;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      records an edit, oldCount lines from line were replaced by
+                newCount lines
+    @param      line        first line edited
+    @param      oldCount    lines before the edit, at least 1
+    @param      newCount    lines after the edit, at least 1
+    @return     void
+------------------------------------------------------------------------------*/
+void IDESyntax::linesChanged( uint32_t line, uint32_t oldCount, uint32_t newCount )
+{
+    bool pending = m_dirtyFrom < m_lexedTo;
+
+    if ( line >= m_lineEnd.size() )
+    {
+        m_dirtyFrom = std::min( m_dirtyFrom, line );
+        return;
+    }
+
+    // keep the cached states below the edit lined up with their lines
+    uint32_t first = line + 1;
+    if ( newCount > oldCount )
+    {
+        m_lineEnd.insert( m_lineEnd.begin() + first, newCount - oldCount, initialState() );
+    }
+    else if ( oldCount > newCount )
+    {
+        uint32_t last = std::min<uint32_t>( first + ( oldCount - newCount ), m_lineEnd.size() );
+        m_lineEnd.erase( m_lineEnd.begin() + first, m_lineEnd.begin() + last );
+    }
+
+    if ( m_lexedTo >= line + oldCount )
+    {
+        m_lexedTo = m_lexedTo + newCount - oldCount;
+    }
+    else
+    {
+        m_lexedTo = std::min( m_lexedTo, line );
+    }
+    if ( m_dirtyTo >= line + oldCount )
+    {
+        m_dirtyTo = m_dirtyTo + newCount - oldCount;
+    }
+    m_dirtyTo   = pending ? std::max( m_dirtyTo, line + newCount - 1 ) : line + newCount - 1;
+    m_dirtyFrom = std::min( m_dirtyFrom, line );
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      lexes the out of date lines up to lastLine, stopping early
+                once a line after the edit ends in the same state as before
+    @param      document        document being shown
+    @param      lastLine        last line that will be drawn
+    @param      firstChanged    set to the first line whose start state changed
+    @param      lastChanged     set to the last line whose start state changed
+    @return     bool    true if any line's start state changed
+------------------------------------------------------------------------------*/
+bool IDESyntax::update( const IDEPieceTable& document, uint32_t lastLine, uint32_t& firstChanged, uint32_t& lastChanged )
+{
+    uint32_t lineCount = document.getLineCount();
+
+    firstChanged = NO_CHANGE;
+    lastChanged  = NO_CHANGE;
+    if ( m_lineEnd.size() != lineCount )
+    {
+        // edits were missed, start again
+        clear();
+        m_lineEnd.assign( lineCount, initialState() );
+    }
+
+    while ( m_dirtyFrom < lineCount && m_dirtyFrom <= lastLine )
+    {
+        uint32_t line  = m_dirtyFrom;
+        bool     known = line < m_lexedTo;
+        LexState end   = lexLine( document.getLine( line ), getStartState( line ), nullptr );
+        m_linesLexed++;
+
+        if ( known && end == m_lineEnd[line] )
+        {
+            if ( line >= m_dirtyTo )
+            {
+                // settled, the lines below are as they were
+                m_dirtyFrom = m_lexedTo;
+                break;
+            }
+        }
+        else if ( known && line + 1 < lineCount )
+        {
+            firstChanged = std::min( firstChanged, line + 1 );
+            lastChanged  = ( lastChanged == NO_CHANGE ) ? line + 1 : std::max( lastChanged, line + 1 );
+        }
+        m_lineEnd[line] = end;
+        m_dirtyFrom     = line + 1;
+        m_lexedTo       = std::max( m_lexedTo, m_dirtyFrom );
+    }
+    return firstChanged != NO_CHANGE;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      returns the lexer state at the start of a line, update()
+                must have been called for the line
+    @param      line    line index
+    @return     LexState    state at the start of the line
+------------------------------------------------------------------------------*/
+IDESyntax::LexState IDESyntax::getStartState( uint32_t line ) const
+{
+    if ( line == 0 || line > m_lineEnd.size() )
+    {
+        return initialState();
+    }
+    return m_lineEnd[line - 1];
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      returns the number of lines lexed by update() since the last
+                clear()
+    @return     uint32_t    lines lexed
+------------------------------------------------------------------------------*/
+uint32_t IDESyntax::getLinesLexed() const
+{
+    return m_linesLexed;
+}
+
+// lexing ----------------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      lexes one line
+    @param      line    text of the line, without the line feed
+    @param      start   lexer state at the start of the line
+    @param      runs    filled with the token runs, nullptr for the state only
+    @return     LexState    lexer state at the end of the line
+------------------------------------------------------------------------------*/
+IDESyntax::LexState IDESyntax::lexLine( std::string_view line, const LexState& start, std::vector<TokenRun>* runs )
+{
+    LexState state     = start;
+    uint32_t length    = (uint32_t)line.size();
+    uint32_t pos       = 0;
+    bool     lineStart = true;
+
+    if ( runs != nullptr )
+    {
+        runs->clear();
+    }
+
+    // finish whatever the previous line left open
+    switch ( state.mode )
+    {
+        case LexMode::BlockComment:
+        {
+            size_t end = line.find( "*/" );
+            pos        = ( end == std::string_view::npos ) ? length : (uint32_t)end + 2;
+            addRun( runs, 0, pos, TokenType::Comment );
+            if ( end == std::string_view::npos )
+            {
+                return state;
+            }
+            break;
+        }
+        case LexMode::RawString:
+        {
+            uint32_t end = scanRawString( line, 0, state );
+            pos          = std::min( end, length );
+            addRun( runs, 0, pos, TokenType::String );
+            if ( end > length )
+            {
+                return state;
+            }
+            break;
+        }
+        case LexMode::String:
+        {
+            bool continued = false;
+            pos            = scanQuoted( line, 0, '"', continued );
+            addRun( runs, 0, pos, TokenType::String );
+            if ( continued )
+            {
+                return state;
+            }
+            break;
+        }
+        case LexMode::LineComment:
+        {
+            addRun( runs, 0, length, TokenType::Comment );
+            if ( length == 0 || line.back() != '\\' )
+            {
+                state.mode = LexMode::Normal;
+            }
+            return state;
+        }
+        default:
+        {
+            break;
+        }
+    }
+    state = initialState();
+    if ( pos > 0 )
+    {
+        lineStart = false;
+    }
+
+    while ( pos < length )
+    {
+        uint32_t tokenStart = pos;
+        uint8_t  ch         = (uint8_t)line[pos];
+
+        switch ( CHAR_CLASS[ch] )
+        {
+            case CC_SPACE:
+            {
+                pos++;
+                continue;
+            }
+            case CC_IDENT:
+            {
+                while ( pos < length && ( CHAR_CLASS[(uint8_t)line[pos]] == CC_IDENT || CHAR_CLASS[(uint8_t)line[pos]] == CC_DIGIT ) )
+                {
+                    pos++;
+                }
+                std::string_view word = line.substr( tokenStart, pos - tokenStart );
+                bool             raw  = ( word == "R" || word == "LR" || word == "uR" || word == "UR" || word == "u8R" );
+                bool             wide = ( word == "L" || word == "u" || word == "U" || word == "u8" );
+
+                if ( raw && pos < length && line[pos] == '"' )
+                {
+                    // R"delimiter( ... )delimiter"
+                    size_t open = line.find( '(', pos + 1 );
+                    if ( open != std::string_view::npos && open - pos - 1 <= MAX_DELIMITER )
+                    {
+                        LexState rawState        = initialState();
+                        rawState.mode            = LexMode::RawString;
+                        rawState.delimiterLength = (uint8_t)( open - pos - 1 );
+                        memcpy( rawState.delimiter, line.data() + pos + 1, rawState.delimiterLength );
+                        uint32_t end = scanRawString( line, (uint32_t)open + 1, rawState );
+                        pos          = std::min( end, length );
+                        addRun( runs, tokenStart, pos, TokenType::String );
+                        if ( end > length )
+                        {
+                            return rawState;
+                        }
+                        break;
+                    }
+                }
+                if ( ( raw || wide ) && pos < length && ( line[pos] == '"' || line[pos] == '\'' ) )
+                {
+                    // prefixed literal, lexed with the prefix
+                    bool continued = false;
+                    pos            = scanQuoted( line, pos + 1, line[pos], continued );
+                    addRun( runs, tokenStart, pos, TokenType::String );
+                    if ( continued && line[tokenStart + word.size()] == '"' )
+                    {
+                        state.mode = LexMode::String;
+                    }
+                    break;
+                }
+                addRun( runs, tokenStart, pos, findKeyword( word ) );
+                break;
+            }
+            case CC_DOT:
+            {
+                if ( pos + 1 >= length || CHAR_CLASS[(uint8_t)line[pos + 1]] != CC_DIGIT )
+                {
+                    pos++;
+                    break;
+                }
+                [[fallthrough]];
+            }
+            case CC_DIGIT:
+            {
+                // digits, letters for suffixes and hex, '.' and digit separators
+                pos++;
+                while ( pos < length )
+                {
+                    uint8_t next = (uint8_t)line[pos];
+                    if ( CHAR_CLASS[next] == CC_IDENT || CHAR_CLASS[next] == CC_DIGIT || next == '.' || next == '\'' )
+                    {
+                        pos++;
+                    }
+                    else if ( ( next == '+' || next == '-' ) && strchr( "eEpP", line[pos - 1] ) != nullptr )
+                    {
+                        pos++;
+                    }
+                    else
+                    {
+                        break;
+                    }
+                }
+                addRun( runs, tokenStart, pos, TokenType::Number );
+                break;
+            }
+            case CC_QUOTE:
+            case CC_CHAR:
+            {
+                bool continued = false;
+                pos            = scanQuoted( line, pos + 1, (char)ch, continued );
+                addRun( runs, tokenStart, pos, TokenType::String );
+                if ( continued && ch == '"' )
+                {
+                    state.mode = LexMode::String;
+                }
+                break;
+            }
+            case CC_SLASH:
+            {
+                if ( pos + 1 < length && line[pos + 1] == '/' )
+                {
+                    addRun( runs, tokenStart, length, TokenType::Comment );
+                    state.mode = ( line.back() == '\\' ) ? LexMode::LineComment : LexMode::Normal;
+                    return state;
+                }
+                if ( pos + 1 < length && line[pos + 1] == '*' )
+                {
+                    size_t end = line.find( "*/", pos + 2 );
+                    if ( end == std::string_view::npos )
+                    {
+                        addRun( runs, tokenStart, length, TokenType::Comment );
+                        state.mode = LexMode::BlockComment;
+                        return state;
+                    }
+                    pos = (uint32_t)end + 2;
+                    addRun( runs, tokenStart, pos, TokenType::Comment );
+                    break;
+                }
+                pos++;
+                break;
+            }
+            case CC_HASH:
+            {
+                pos++;
+                if ( lineStart )
+                {
+                    // '#' and the directive name
+                    while ( pos < length && CHAR_CLASS[(uint8_t)line[pos]] == CC_SPACE )
+                    {
+                        pos++;
+                    }
+                    while ( pos < length && CHAR_CLASS[(uint8_t)line[pos]] == CC_IDENT )
+                    {
+                        pos++;
+                    }
+                    addRun( runs, tokenStart, pos, TokenType::Preprocessor );
+
+                    // #include <file>
+                    size_t open = line.find_first_not_of( " \t", pos );
+                    if ( line.substr( tokenStart, pos - tokenStart ).find( "include" ) != std::string_view::npos && open != std::string_view::npos && line[open] == '<' )
+                    {
+                        size_t close = line.find( '>', open );
+                        pos          = ( close == std::string_view::npos ) ? length : (uint32_t)close + 1;
+                        addRun( runs, (uint32_t)open, pos, TokenType::String );
+                    }
+                }
+                break;
+            }
+            default:
+            {
+                pos++;
+                break;
+            }
+        }
+        lineStart = false;
+    }
+    return state;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      returns the state at the start of a file
+    @return     LexState    Normal state
+------------------------------------------------------------------------------*/
+IDESyntax::LexState IDESyntax::initialState()
+{
+    LexState state;
+    state.mode            = LexMode::Normal;
+    state.delimiterLength = 0;
+    memset( state.delimiter, 0, sizeof( state.delimiter ) );
+    return state;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      checks if a file is C or C++ source, by its extension
+    @param      filename    file name
+    @return     bool    true if the file should be highlighted
+------------------------------------------------------------------------------*/
+bool IDESyntax::isSourceFile( const std::string& filename )
+{
+    static const char* extensions[] = { ".c", ".cc", ".cpp", ".cxx", ".h", ".hh", ".hpp", ".hxx", ".inl" };
+    std::string        extension    = std::filesystem::path( filename ).extension().string();
+
+    std::transform( extension.begin(), extension.end(), extension.begin(), []( unsigned char ch ) { return (char)tolower( ch ); } );
+    for ( const char* known : extensions )
+    {
+        if ( extension == known )
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// private functions -----------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      looks up an identifier in the keyword table
+    @param      word    identifier
+    @return     TokenType   Keyword, Type or Text
+------------------------------------------------------------------------------*/
+IDESyntax::TokenType IDESyntax::findKeyword( std::string_view word )
+{
+    auto found = std::lower_bound( std::begin( KEYWORDS ), std::end( KEYWORDS ), word, []( const Keyword& keyword, std::string_view value ) { return keyword.word < value; } );
+    if ( found != std::end( KEYWORDS ) && found->word == word )
+    {
+        return found->type;
+    }
+    return TokenType::Text;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      finds the end of a quoted literal
+    @param      line        text of the line
+    @param      pos         first position after the opening quote
+    @param      quote       closing quote
+    @param      continued   set if the line ends with a backslash inside it
+    @return     uint32_t    position after the closing quote, or the line length
+------------------------------------------------------------------------------*/
+uint32_t IDESyntax::scanQuoted( std::string_view line, uint32_t pos, char quote, bool& continued )
+{
+    uint32_t length = (uint32_t)line.size();
+
+    continued = false;
+    while ( pos < length )
+    {
+        if ( line[pos] == '\\' )
+        {
+            if ( pos + 1 == length )
+            {
+                continued = true;
+                return length;
+            }
+            pos += 2;
+        }
+        else if ( line[pos] == quote )
+        {
+            return pos + 1;
+        }
+        else
+        {
+            pos++;
+        }
+    }
+    return length;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      finds the end of a raw string literal
+    @param      line    text of the line
+    @param      pos     position to search from
+    @param      state   RawString state holding the delimiter
+    @return     uint32_t    position after the closing quote, or past the
+                            line length if the literal carries on
+------------------------------------------------------------------------------*/
+uint32_t IDESyntax::scanRawString( std::string_view line, uint32_t pos, const LexState& state )
+{
+    std::string close = ")" + std::string( state.delimiter, state.delimiterLength ) + "\"";
+    size_t      end   = line.find( close, pos );
+
+    if ( end == std::string_view::npos )
+    {
+        return (uint32_t)line.size() + 1;
+    }
+    return (uint32_t)( end + close.size() );
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      adds a token run, plain text runs are not stored
+    @param      runs    run list, may be nullptr
+    @param      start   start of the run
+    @param      end     end of the run
+    @param      type    token type
+    @return     void
+------------------------------------------------------------------------------*/
+void IDESyntax::addRun( std::vector<TokenRun>* runs, uint32_t start, uint32_t end, TokenType type )
+{
+    if ( runs != nullptr && type != TokenType::Text && end > start )
+    {
+        runs->push_back( { start, end - start, type } );
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: IDESyntax.cpp
+// ----------------------------------------------------------------------------
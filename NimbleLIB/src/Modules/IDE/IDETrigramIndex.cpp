@@ -0,0 +1,783 @@
+/**----------------------------------------------------------------------------
+
+    @file       IDETrigramIndex.cpp
+    @defgroup   NimbleLIBIDE Nimble Library IDE Module
+    @brief      IDETrigramIndex class for the Nimble Library
+
+    @copyright  Neil Bereford 2023
+
+Notes:
+
+    The index lists, for every three characters found in the files below a
+    folder, the files holding them. Characters are folded to lower case, so
+    one index serves searches that match case and those that do not. Any
+    match of a pattern holds every trigram of the pattern, so only the files
+    in all of the pattern's posting lists need be read, the shortest list
+    is read first and the others intersected with it.
+
+    The index is one file, INDEX_FILE below the folder, mapped with
+    MappedFile and read in place:
+
+        IndexHeader
+        FileRecord[fileCount]       path, stamp and CRC-32C of each file
+        TrigramRecord[trigramCount] sorted by trigram
+        names                       the paths, relative to the folder
+        postings                    a posting list for each trigram
+
+    A posting list holds file numbers in order, each stored as the gap from
+    the one before as a varint, seven bits a byte, so most take one byte.
+
+    Files are kept up to date from their stamps. A search walking the folder
+    passes each file that is new, or whose time or length has changed, to
+    updateFile(), which compares its CRC with the one indexed, a file written
+    again with the same contents keeps its postings and only its stamp is
+    updated. commit() writes the changes with an AtomicFileWriter. A changed
+    file is added as a new file and the old one is marked FLAG_REMOVED, as
+    new files are numbered after every file indexed their postings are just
+    appended to the lists, the lists already written are copied unchanged.
+    Removed files are dropped from query results, once 1 / COMPACT_SHARE of
+    the files are removed the files are renumbered and every list rewritten.
+
+    Binary files are indexed with no postings so that they are not read
+    again, files longer than MAX_INDEXED_SIZE are not indexed and every
+    query returns them.
+
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// Include files
+// ----------------------------------------------------------------------------
+
+#include "../../../inc/Modules/IDE/IDETrigramIndex.h"
+#include "../../../inc/Modules/FileHandling/AtomicFileWriter.h"
+#include "../../../inc/Modules/Utilities/Crc.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+
+//-----------------------------------------------------------------------------
+// Namespace
+// ----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Local variables
+// ----------------------------------------------------------------------------
+
+static const char     INDEX_MAGIC[4] = { 'N', 'T', 'R', 'I' }; //!< start of an index file
+static const uint32_t TRIGRAM_SPACE  = 1 << 24;                 //!< trigrams of three bytes
+
+//-----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+// constructors & destructors -------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Constructor for IDETrigramIndex class
+
+-----------------------------------------------------------------------------*/
+IDETrigramIndex::IDETrigramIndex()
+{
+    m_header   = nullptr;
+    m_files    = nullptr;
+    m_trigrams = nullptr;
+    m_names    = nullptr;
+    m_postings = nullptr;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Destructor for IDETrigramIndex class
+
+-----------------------------------------------------------------------------*/
+IDETrigramIndex::~IDETrigramIndex()
+{
+    close();
+}
+
+// index file -----------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Opens the index of a folder, a folder with no index file has
+                an empty index, nothing is done if it is already open
+    @param      folder  folder indexed
+    @return     LibraryError    IDETrigramIndex_InvalidIndexFile if the index
+                                file is damaged, the index is then empty
+-----------------------------------------------------------------------------*/
+LibraryError IDETrigramIndex::open( const std::string& folder )
+{
+    if ( folder == m_folder && m_header != nullptr )
+    {
+        return LibraryError::No_Error;
+    }
+
+    close();
+    m_folder = folder;
+    return mapIndex() ? LibraryError::No_Error : LibraryError::IDETrigramIndex_InvalidIndexFile;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Closes the index file
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDETrigramIndex::close()
+{
+    m_lookup.clear();
+    m_unindexed.clear();
+    m_file.close();
+    m_header   = nullptr;
+    m_files    = nullptr;
+    m_trigrams = nullptr;
+    m_names    = nullptr;
+    m_postings = nullptr;
+}
+
+// searching ------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Finds the files that could hold a pattern, every file holding
+                it is found, the files found need not hold it
+    @param      pattern     text to find, the case is ignored
+    @param      files       set to the files found, in order
+    @return     bool        false if the index can not narrow the search, the
+                            pattern is shorter than a trigram or there is no
+                            index, every file must then be searched
+-----------------------------------------------------------------------------*/
+bool IDETrigramIndex::query( const std::string& pattern, std::vector<uint32_t>& files ) const
+{
+    std::vector<uint32_t>             trigrams;
+    std::vector<const TrigramRecord*> records;
+
+    files.clear();
+    extractTrigrams( pattern.data(), pattern.size(), trigrams );
+    if ( trigrams.empty() || m_header == nullptr )
+    {
+        return false;
+    }
+
+    for ( uint32_t trigram : trigrams )
+    {
+        const TrigramRecord* record = findTrigram( trigram );
+        if ( record == nullptr )
+        {
+            // no file indexed holds it
+            records.clear();
+            break;
+        }
+        records.push_back( record );
+    }
+
+    if ( records.empty() == false )
+    {
+        // the shortest list first, the list only gets shorter
+        std::sort( records.begin(), records.end(), []( const TrigramRecord* a, const TrigramRecord* b ) { return a->count < b->count; } );
+        readPostings( *records[0], files );
+
+        std::vector<uint32_t> next;
+        for ( size_t index = 1; index < records.size() && files.empty() == false; index++ )
+        {
+            next.clear();
+            readPostings( *records[index], next );
+            files.erase( std::set_intersection( files.begin(), files.end(), next.begin(), next.end(), files.begin() ), files.end() );
+        }
+        files.erase( std::remove_if( files.begin(), files.end(), [this]( uint32_t file ) { return ( m_files[file].flags & FLAG_REMOVED ) != 0; } ), files.end() );
+    }
+
+    // files too long to index could hold anything
+    if ( m_unindexed.empty() == false )
+    {
+        size_t found = files.size();
+        files.insert( files.end(), m_unindexed.begin(), m_unindexed.end() );
+        std::inplace_merge( files.begin(), files.begin() + found, files.end() );
+    }
+    return true;
+}
+
+// updating -------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Readies an update of the index, before the folder is walked
+    @param      update  update to ready
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDETrigramIndex::beginUpdate( Update& update ) const
+{
+    std::lock_guard<std::mutex> guard( update.lock );
+    update.seen.assign( getFileCount(), 0 );
+    update.added.clear();
+    update.touched.clear();
+    update.complete = false;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Notes a file indexed was found by the walk, files not found
+                are removed when the walk is complete, a file is only noted
+                by one thread
+    @param      update  update
+    @param      file    file found
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDETrigramIndex::markSeen( Update& update, uint32_t file ) const
+{
+    if ( file < update.seen.size() )
+    {
+        update.seen[file] = 1;
+    }
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Adds a new or changed file to an update, a file whose
+                contents have not changed only has its stamp updated
+    @param      update  update, may be shared by many threads
+    @param      file    file indexed with the same path, or NOT_INDEXED
+    @param      path    path, relative to the folder
+    @param      stamp   stamp when it was read
+    @param      data    contents
+    @param      size    length of the contents
+    @param      binary  true if the file is binary
+    @return     bool    true if the contents have changed
+-----------------------------------------------------------------------------*/
+bool IDETrigramIndex::updateFile( Update& update, uint32_t file, const std::string& path, const FileStamp& stamp, const char* data, uint64_t size, bool binary ) const
+{
+    uint32_t crc = Crc::calculate( Crc::CrcType::Crc32C, data, size );
+
+    if ( file < getFileCount() && m_files[file].crc == crc && m_files[file].stamp.size == size && ( ( m_files[file].flags & FLAG_BINARY ) != 0 ) == binary )
+    {
+        std::lock_guard<std::mutex> guard( update.lock );
+        update.touched.emplace_back( file, stamp );
+        return false;
+    }
+
+    AddedFile added;
+    added.path     = path;
+    added.replaces = file;
+    added.stamp    = stamp;
+    added.crc      = crc;
+    added.flags    = 0;
+    if ( binary )
+    {
+        added.flags = FLAG_BINARY;
+    }
+    else if ( size > MAX_INDEXED_SIZE )
+    {
+        added.flags = FLAG_UNINDEXED;
+    }
+    else
+    {
+        static thread_local std::vector<uint32_t> trigrams;
+        extractTrigrams( data, size, trigrams );
+
+        uint32_t previous = 0;
+        added.trigrams.reserve( trigrams.size() * 2 );
+        for ( uint32_t trigram : trigrams )
+        {
+            putVarint( added.trigrams, trigram - previous );
+            previous = trigram;
+        }
+    }
+
+    std::lock_guard<std::mutex> guard( update.lock );
+    update.added.push_back( std::move( added ) );
+    return true;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Writes an update to the index file and maps it again, the
+                tasks filling in the update must have finished
+    @param      update  update to write
+    @return     LibraryError
+-----------------------------------------------------------------------------*/
+LibraryError IDETrigramIndex::commit( Update& update )
+{
+    uint32_t                oldCount = getFileCount();
+    uint32_t                removed  = 0;
+    std::vector<FileRecord> files( m_files, m_files + oldCount );
+
+    // files changed, written again or no longer there
+    for ( const auto& touched : update.touched )
+    {
+        files[touched.first].stamp = touched.second;
+    }
+    for ( const AddedFile& added : update.added )
+    {
+        if ( added.replaces < oldCount )
+        {
+            files[added.replaces].flags |= FLAG_REMOVED;
+        }
+    }
+    for ( uint32_t file = 0; file < oldCount; file++ )
+    {
+        if ( update.complete && file < update.seen.size() && update.seen[file] == 0 )
+        {
+            files[file].flags |= FLAG_REMOVED;
+        }
+        removed += ( files[file].flags & FLAG_REMOVED ) ? 1 : 0;
+    }
+    if ( update.added.empty() && update.touched.empty() && removed == getRemovedCount() )
+    {
+        return LibraryError::No_Error;
+    }
+
+    // once enough files are removed they are dropped and the rest renumbered
+    bool                    compact = removed > 0 && (uint64_t)removed * COMPACT_SHARE > oldCount + update.added.size();
+    std::vector<uint32_t>   renumber( oldCount );
+    std::vector<FileRecord> outFiles;
+    std::string             names;
+    if ( compact )
+    {
+        for ( uint32_t file = 0; file < oldCount; file++ )
+        {
+            renumber[file] = NOT_INDEXED;
+            if ( ( files[file].flags & FLAG_REMOVED ) == 0 )
+            {
+                renumber[file] = (uint32_t)outFiles.size();
+                outFiles.push_back( files[file] );
+                outFiles.back().nameOffset = (uint32_t)names.size();
+                names.append( m_names + files[file].nameOffset, files[file].nameLength );
+            }
+        }
+        removed = 0;
+    }
+    else
+    {
+        outFiles.swap( files );
+        if ( m_header != nullptr )
+        {
+            names.assign( m_names, m_header->namesSize );
+        }
+    }
+
+    // the new files are numbered after the rest, their lists follow the old
+    std::unordered_map<uint32_t, PostingList> addedLists;
+    for ( const AddedFile& added : update.added )
+    {
+        FileRecord record;
+        record.stamp      = added.stamp;
+        record.nameOffset = (uint32_t)names.size();
+        record.nameLength = (uint32_t)added.path.size();
+        record.crc        = added.crc;
+        record.flags      = added.flags;
+        names.append( added.path );
+
+        uint32_t       file     = (uint32_t)outFiles.size();
+        uint32_t       trigram  = 0;
+        const uint8_t* position = added.trigrams.data();
+        const uint8_t* end      = position + added.trigrams.size();
+        while ( position < end )
+        {
+            trigram += getVarint( position, end );
+            PostingList& list = addedLists[trigram];
+            if ( list.count == 0 )
+            {
+                list.first = file;
+            }
+            else
+            {
+                putVarint( list.gaps, file - list.last );
+            }
+            list.last = file;
+            list.count++;
+        }
+        outFiles.push_back( record );
+    }
+
+    std::vector<uint32_t> addedTrigrams;
+    addedTrigrams.reserve( addedLists.size() );
+    for ( const auto& list : addedLists )
+    {
+        addedTrigrams.push_back( list.first );
+    }
+    std::sort( addedTrigrams.begin(), addedTrigrams.end() );
+
+    // the old and new lists are merged in trigram order
+    std::vector<TrigramRecord> outTrigrams;
+    std::vector<uint8_t>       postings;
+    std::vector<uint32_t>      oldFiles;
+    uint32_t                   oldTrigrams = getTrigramCount();
+    size_t                     oldIndex    = 0;
+    size_t                     addedIndex  = 0;
+    postings.reserve( ( m_header != nullptr ) ? m_header->postingsSize : 0 );
+    while ( oldIndex < oldTrigrams || addedIndex < addedTrigrams.size() )
+    {
+        TrigramRecord record;
+        bool          useOld   = oldIndex < oldTrigrams && ( addedIndex == addedTrigrams.size() || m_trigrams[oldIndex].trigram <= addedTrigrams[addedIndex] );
+        bool          useAdded = addedIndex < addedTrigrams.size() && ( oldIndex == oldTrigrams || addedTrigrams[addedIndex] <= m_trigrams[oldIndex].trigram );
+        record.trigram         = useOld ? m_trigrams[oldIndex].trigram : addedTrigrams[addedIndex];
+        record.count           = 0;
+        record.lastFile        = 0;
+        record.reserved        = 0;
+        record.offset          = postings.size();
+
+        if ( useOld )
+        {
+            const TrigramRecord& old = m_trigrams[oldIndex++];
+            if ( compact )
+            {
+                oldFiles.clear();
+                readPostings( old, oldFiles );
+                for ( uint32_t file : oldFiles )
+                {
+                    if ( renumber[file] != NOT_INDEXED )
+                    {
+                        putVarint( postings, renumber[file] - record.lastFile );
+                        record.lastFile = renumber[file];
+                        record.count++;
+                    }
+                }
+            }
+            else
+            {
+                // lists are stored in trigram order, each ends where the next starts
+                uint64_t end = ( oldIndex < oldTrigrams ) ? m_trigrams[oldIndex].offset : m_header->postingsSize;
+                postings.insert( postings.end(), m_postings + old.offset, m_postings + end );
+                record.count    = old.count;
+                record.lastFile = old.lastFile;
+            }
+        }
+        if ( useAdded )
+        {
+            const PostingList& list = addedLists[addedTrigrams[addedIndex++]];
+            putVarint( postings, list.first - record.lastFile );
+            postings.insert( postings.end(), list.gaps.begin(), list.gaps.end() );
+            record.count += list.count;
+            record.lastFile = list.last;
+        }
+        if ( record.count > 0 )
+        {
+            outTrigrams.push_back( record );
+        }
+    }
+
+    IndexHeader header;
+    memcpy( header.magic, INDEX_MAGIC, sizeof( header.magic ) );
+    header.version      = VERSION;
+    header.fileCount    = (uint32_t)outFiles.size();
+    header.trigramCount = (uint32_t)outTrigrams.size();
+    header.removedCount = removed;
+    header.reserved     = 0;
+    header.namesSize    = names.size();
+    header.postingsSize = postings.size();
+
+    std::error_code  code;
+    std::string      fileName = ( std::filesystem::path( m_folder ) / INDEX_FILE ).string();
+    AtomicFileWriter writer;
+    std::filesystem::create_directories( std::filesystem::path( fileName ).parent_path(), code );
+    LibraryError error = writer.open( fileName );
+    if ( error == LibraryError::No_Error )
+    {
+        writer.write( std::string_view( (const char*)&header, sizeof( header ) ) );
+        writer.write( std::string_view( (const char*)outFiles.data(), outFiles.size() * sizeof( FileRecord ) ) );
+        writer.write( std::string_view( (const char*)outTrigrams.data(), outTrigrams.size() * sizeof( TrigramRecord ) ) );
+        writer.write( names );
+        writer.write( std::string_view( (const char*)postings.data(), postings.size() ) );
+
+        // nothing written refers to the mapping, which can not be replaced while mapped on some systems
+        std::string folder = m_folder;
+        close();
+        m_folder = folder;
+        error    = writer.commit();
+    }
+    else
+    {
+        close();
+    }
+    mapIndex();
+    return error;
+}
+
+// getters --------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Gets the folder indexed
+    @return     const std::string&  folder
+-----------------------------------------------------------------------------*/
+const std::string& IDETrigramIndex::getFolder() const
+{
+    return m_folder;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Gets the number of files in the index, removed files included
+    @return     uint32_t    files
+-----------------------------------------------------------------------------*/
+uint32_t IDETrigramIndex::getFileCount() const
+{
+    return ( m_header != nullptr ) ? m_header->fileCount : 0;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Gets the number of trigrams in the index
+    @return     uint32_t    trigrams
+-----------------------------------------------------------------------------*/
+uint32_t IDETrigramIndex::getTrigramCount() const
+{
+    return ( m_header != nullptr ) ? m_header->trigramCount : 0;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Gets the number of files removed and not yet dropped
+    @return     uint32_t    files
+-----------------------------------------------------------------------------*/
+uint32_t IDETrigramIndex::getRemovedCount() const
+{
+    return ( m_header != nullptr ) ? m_header->removedCount : 0;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Finds a file in the index
+    @param      path        path, relative to the folder
+    @return     uint32_t    file, NOT_INDEXED if it is not in the index
+-----------------------------------------------------------------------------*/
+uint32_t IDETrigramIndex::findFile( std::string_view path ) const
+{
+    auto found = m_lookup.find( path );
+    return ( found != m_lookup.end() ) ? found->second : NOT_INDEXED;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Gets the path of a file
+    @param      file                file
+    @return     std::string_view    path, relative to the folder
+-----------------------------------------------------------------------------*/
+std::string_view IDETrigramIndex::getPath( uint32_t file ) const
+{
+    return ( file < getFileCount() ) ? std::string_view( m_names + m_files[file].nameOffset, m_files[file].nameLength ) : std::string_view();
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Gets the FLAG_ values of a file
+    @param      file        file
+    @return     uint32_t    flags
+-----------------------------------------------------------------------------*/
+uint32_t IDETrigramIndex::getFlags( uint32_t file ) const
+{
+    return ( file < getFileCount() ) ? m_files[file].flags : 0;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Checks if a file is as it was when it was indexed
+    @param      file    file
+    @param      stamp   stamp of the file now
+    @return     bool    true if the time and length are unchanged
+-----------------------------------------------------------------------------*/
+bool IDETrigramIndex::isCurrent( uint32_t file, const FileStamp& stamp ) const
+{
+    return file < getFileCount() && m_files[file].stamp.modified == stamp.modified && m_files[file].stamp.size == stamp.size;
+}
+
+// helpers --------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Finds every trigram of some text, folded to lower case
+    @param      data        text
+    @param      size        length of the text
+    @param      trigrams    set to the trigrams, once each, in order
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDETrigramIndex::extractTrigrams( const char* data, uint64_t size, std::vector<uint32_t>& trigrams )
+{
+    // a bit for each trigram, only the bits set are cleared afterwards
+    static thread_local std::vector<uint64_t> found( TRIGRAM_SPACE / 64 );
+    const uint8_t*                            text    = (const uint8_t*)data;
+    uint32_t                                  trigram = 0;
+
+    trigrams.clear();
+    for ( uint64_t position = 0; position < size; position++ )
+    {
+        uint8_t character = text[position];
+        trigram           = ( ( trigram << 8 ) | ( ( character >= 'A' && character <= 'Z' ) ? character + 32 : character ) ) & ( TRIGRAM_SPACE - 1 );
+        if ( position >= 2 )
+        {
+            uint64_t& word = found[trigram >> 6];
+            uint64_t  bit  = (uint64_t)1 << ( trigram & 63 );
+            if ( ( word & bit ) == 0 )
+            {
+                word |= bit;
+                trigrams.push_back( trigram );
+            }
+        }
+    }
+    for ( uint32_t each : trigrams )
+    {
+        found[each >> 6] = 0;
+    }
+    std::sort( trigrams.begin(), trigrams.end() );
+}
+
+// private functions ----------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Maps the index file of m_folder and checks it, builds the
+                lookup of paths
+    @return     bool    false if the index file is damaged
+-----------------------------------------------------------------------------*/
+bool IDETrigramIndex::mapIndex()
+{
+    std::error_code code;
+    std::string     fileName = ( std::filesystem::path( m_folder ) / INDEX_FILE ).string();
+
+    if ( std::filesystem::is_regular_file( fileName, code ) == false )
+    {
+        return true;
+    }
+    if ( m_file.open( fileName ) != LibraryError::No_Error )
+    {
+        return false;
+    }
+
+    const char*        data   = m_file.getData();
+    uint64_t           size   = m_file.getSize();
+    const IndexHeader* header = (const IndexHeader*)data;
+    bool               valid  = size >= sizeof( IndexHeader ) && memcmp( header->magic, INDEX_MAGIC, sizeof( header->magic ) ) == 0 && header->version == VERSION;
+    if ( valid )
+    {
+        uint64_t tables = sizeof( IndexHeader ) + (uint64_t)header->fileCount * sizeof( FileRecord ) + (uint64_t)header->trigramCount * sizeof( TrigramRecord );
+        valid           = header->namesSize <= size && header->postingsSize <= size && tables + header->namesSize + header->postingsSize == size;
+    }
+    if ( valid )
+    {
+        m_files    = (const FileRecord*)( data + sizeof( IndexHeader ) );
+        m_trigrams = (const TrigramRecord*)( m_files + header->fileCount );
+        m_names    = (const char*)( m_trigrams + header->trigramCount );
+        m_postings = (const uint8_t*)( m_names + header->namesSize );
+        for ( uint32_t file = 0; file < header->fileCount && valid; file++ )
+        {
+            valid = (uint64_t)m_files[file].nameOffset + m_files[file].nameLength <= header->namesSize;
+        }
+        for ( uint32_t trigram = 0; trigram < header->trigramCount && valid; trigram++ )
+        {
+            valid = m_trigrams[trigram].offset <= header->postingsSize && ( trigram == 0 || m_trigrams[trigram - 1].trigram < m_trigrams[trigram].trigram );
+        }
+    }
+    if ( valid == false )
+    {
+        ErrorHandler::getInstance().handleError( ErrorType::Warning, LibraryError::IDETrigramIndex_InvalidIndexFile, "IDETrigramIndex::open() : " + fileName + " is damaged, it will be rebuilt" );
+        close();
+        return false;
+    }
+
+    m_header = header;
+    m_lookup.reserve( header->fileCount );
+    for ( uint32_t file = 0; file < header->fileCount; file++ )
+    {
+        if ( ( m_files[file].flags & FLAG_REMOVED ) == 0 )
+        {
+            m_lookup[getPath( file )] = file;
+            if ( m_files[file].flags & FLAG_UNINDEXED )
+            {
+                m_unindexed.push_back( file );
+            }
+        }
+    }
+    return true;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Finds the record of a trigram
+    @param      trigram                 trigram to find
+    @return     const TrigramRecord*    record, nullptr if no file holds it
+-----------------------------------------------------------------------------*/
+const IDETrigramIndex::TrigramRecord* IDETrigramIndex::findTrigram( uint32_t trigram ) const
+{
+    const TrigramRecord* end   = m_trigrams + getTrigramCount();
+    const TrigramRecord* found = std::lower_bound( m_trigrams, end, trigram, []( const TrigramRecord& record, uint32_t value ) { return record.trigram < value; } );
+    return ( found != end && found->trigram == trigram ) ? found : nullptr;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Reads the posting list of a trigram
+    @param      record  trigram
+    @param      files   the files in the list are added, in order
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDETrigramIndex::readPostings( const TrigramRecord& record, std::vector<uint32_t>& files ) const
+{
+    const uint8_t* position = m_postings + record.offset;
+    const uint8_t* end      = m_postings + m_header->postingsSize;
+    uint32_t       file     = 0;
+
+    files.reserve( files.size() + record.count );
+    for ( uint32_t count = 0; count < record.count && position < end; count++ )
+    {
+        file += getVarint( position, end );
+        if ( file >= m_header->fileCount )
+        {
+            break;
+        }
+        files.push_back( file );
+    }
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Adds a varint, seven bits a byte, the top bit set on every
+                byte but the last
+    @param      bytes   bytes to add to
+    @param      value   value to add
+    @return     void
+-----------------------------------------------------------------------------*/
+void IDETrigramIndex::putVarint( std::vector<uint8_t>& bytes, uint32_t value )
+{
+    while ( value >= 0x80 )
+    {
+        bytes.push_back( (uint8_t)( value | 0x80 ) );
+        value >>= 7;
+    }
+    bytes.push_back( (uint8_t)value );
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      Reads a varint
+    @param      bytes       position to read from, moved past the varint
+    @param      end         end of the bytes
+    @return     uint32_t    value read
+-----------------------------------------------------------------------------*/
+uint32_t IDETrigramIndex::getVarint( const uint8_t*& bytes, const uint8_t* end )
+{
+    uint32_t value = 0;
+    uint32_t shift = 0;
+
+    while ( bytes < end && shift < 32 )
+    {
+        uint8_t byte = *bytes++;
+        value |= (uint32_t)( byte & 0x7F ) << shift;
+        if ( ( byte & 0x80 ) == 0 )
+        {
+            break;
+        }
+        shift += 7;
+    }
+    return value;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: IDETrigramIndex.cpp
+// ----------------------------------------------------------------------------
@@ -0,0 +1,501 @@
+/**----------------------------------------------------------------------------
+
+    @file       IDEUndoJournal.cpp
+    @defgroup   NimbleLIBIDE Nimble Library IDE Module
+    @brief      IDEUndoJournal class for the Nimble Library
+
+    @copyright  Neil Bereford 2023
+
+Notes:
+
+    Each edit is stored as its document offset and the text inserted or
+    erased, never as a copy of the document, so undoing a large paste only
+    costs the pasted text.
+
+    Edits are undone a step at a time. Consecutive typing joins the step
+    before it, as long as it carries on from where the last edit finished
+    and neither edit holds a line feed. Moving the cursor (closeStep())
+    starts a new step. Edits made between beginGroup() and endGroup(), such
+    as a replace all, always form a single step.
+
+    The memory used is bounded by a byte budget rather than a step count,
+    the oldest steps are dropped once the text and records held go over the
+    budget. A step larger than the whole budget cannot be undone, an edit
+    as large as a replace all asks canRecordStep() first and is refused,
+    leaving the older steps as they were, rather than being recorded and
+    taking the whole history with it.
+
+    Recording an edit clears the redo list.
+
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// Include files
+// ----------------------------------------------------------------------------
+
+#include "../../../inc/Modules/IDE/IDEUndoJournal.h"
+
+//-----------------------------------------------------------------------------
+// Namespace
+// ----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+// Constructor & Destructor -----------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      IDEUndoJournal Constructor
+    @param      byteBudget  most bytes the journal may hold
+
+------------------------------------------------------------------------------*/
+IDEUndoJournal::IDEUndoJournal( uint64_t byteBudget /*= DEFAULT_BYTE_BUDGET*/ )
+{
+    m_byteBudget = byteBudget;
+    m_groupDepth = 0;
+    clear();
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      IDEUndoJournal Destructor
+
+------------------------------------------------------------------------------*/
+IDEUndoJournal::~IDEUndoJournal()
+{
+}
+
+// recording -------------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      records text inserted into the document
+    @param      offset  document offset the text was inserted at
+    @param      text    text inserted
+    @param      before  cursor before the edit
+    @return     void
+------------------------------------------------------------------------------*/
+void IDEUndoJournal::recordInsert( uint64_t offset, const std::string& text, const CursorState& before )
+{
+    record( EditType::Insert, offset, text, before );
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      records text erased from the document
+    @param      offset  document offset the text was erased from
+    @param      text    text erased
+    @param      before  cursor before the edit
+    @return     void
+------------------------------------------------------------------------------*/
+void IDEUndoJournal::recordErase( uint64_t offset, const std::string& text, const CursorState& before )
+{
+    record( EditType::Erase, offset, text, before );
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      sets the cursor after the last edit, restored by redo
+    @param      after   cursor after the edit
+    @return     void
+------------------------------------------------------------------------------*/
+void IDEUndoJournal::setCursorAfter( const CursorState& after )
+{
+    if ( m_undo.empty() == false )
+    {
+        m_undo.back().after = after;
+    }
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      stops the next edit joining the last step
+    @return     void
+------------------------------------------------------------------------------*/
+void IDEUndoJournal::closeStep()
+{
+    if ( m_groupDepth == 0 )
+    {
+        m_stepOpen = false;
+    }
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      starts a group, every edit until the matching endGroup() is
+                undone as one step. Groups can be nested.
+    @return     void
+------------------------------------------------------------------------------*/
+void IDEUndoJournal::beginGroup()
+{
+    if ( m_groupDepth == 0 )
+    {
+        m_stepOpen = false;
+    }
+    m_groupDepth++;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      ends a group
+    @return     void
+------------------------------------------------------------------------------*/
+void IDEUndoJournal::endGroup()
+{
+    if ( m_groupDepth > 0 )
+    {
+        m_groupDepth--;
+        closeStep();
+    }
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      forgets every edit, used when a new document is loaded
+    @return     void
+------------------------------------------------------------------------------*/
+void IDEUndoJournal::clear()
+{
+    m_undo.clear();
+    m_redo.clear();
+    m_bytesUsed = 0;
+    m_undoSteps = 0;
+    m_redoSteps = 0;
+    m_lastStep  = 0;
+    m_stepOpen  = false;
+}
+
+// undo / redo -----------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      undoes the last step, newest edit first
+    @param      document    document the edits were made to
+    @param      cursor      set to the cursor before the step
+    @return     bool        true if a step was undone
+------------------------------------------------------------------------------*/
+bool IDEUndoJournal::undo( IDEPieceTable& document, CursorState& cursor )
+{
+    if ( m_undo.empty() )
+    {
+        return false;
+    }
+
+    uint32_t step = m_undo.back().step;
+    while ( m_undo.empty() == false && m_undo.back().step == step )
+    {
+        EditRecord& edit = m_undo.back();
+        if ( edit.type == EditType::Insert )
+        {
+            document.eraseAt( edit.offset, edit.text.size() );
+        }
+        else
+        {
+            document.insertAt( edit.offset, edit.text );
+        }
+        cursor = edit.before;
+        m_redo.push_back( std::move( edit ) );
+        m_undo.pop_back();
+    }
+    m_undoSteps--;
+    m_redoSteps++;
+    m_stepOpen = false;
+    return true;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      redoes the last step undone, oldest edit first
+    @param      document    document the edits were made to
+    @param      cursor      set to the cursor after the step
+    @return     bool        true if a step was redone
+------------------------------------------------------------------------------*/
+bool IDEUndoJournal::redo( IDEPieceTable& document, CursorState& cursor )
+{
+    if ( m_redo.empty() )
+    {
+        return false;
+    }
+
+    uint32_t step = m_redo.back().step;
+    while ( m_redo.empty() == false && m_redo.back().step == step )
+    {
+        EditRecord& edit = m_redo.back();
+        if ( edit.type == EditType::Insert )
+        {
+            document.insertAt( edit.offset, edit.text );
+        }
+        else
+        {
+            document.eraseAt( edit.offset, edit.text.size() );
+        }
+        cursor = edit.after;
+        m_undo.push_back( std::move( edit ) );
+        m_redo.pop_back();
+    }
+    m_redoSteps--;
+    m_undoSteps++;
+    m_stepOpen = false;
+    return true;
+}
+
+// getters ---------------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      returns if there is a step to undo
+    @return     bool    true if undo is possible
+------------------------------------------------------------------------------*/
+bool IDEUndoJournal::canUndo() const
+{
+    return m_undo.empty() == false;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      returns if there is a step to redo
+    @return     bool    true if redo is possible
+------------------------------------------------------------------------------*/
+bool IDEUndoJournal::canRedo() const
+{
+    return m_redo.empty() == false;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      checks if a step fits the budget before it is made, older
+                steps are dropped to make room once it is recorded
+    @param      edits       inserts and erases in the step
+    @param      textBytes   text inserted and erased by them
+    @return     bool        false if the step could not be undone
+------------------------------------------------------------------------------*/
+bool IDEUndoJournal::canRecordStep( uint64_t edits, uint64_t textBytes ) const
+{
+    // a short edit still holds the string's inline capacity
+    uint64_t minimum = std::string().capacity();
+    return edits * ( sizeof( EditRecord ) + minimum ) + textBytes <= m_byteBudget;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      returns the number of steps that can be undone
+    @return     uint32_t    steps
+------------------------------------------------------------------------------*/
+uint32_t IDEUndoJournal::getUndoSteps() const
+{
+    return m_undoSteps;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      returns the number of steps that can be redone
+    @return     uint32_t    steps
+------------------------------------------------------------------------------*/
+uint32_t IDEUndoJournal::getRedoSteps() const
+{
+    return m_redoSteps;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      returns the memory held by the journal
+    @return     uint64_t    bytes
+------------------------------------------------------------------------------*/
+uint64_t IDEUndoJournal::getBytesUsed() const
+{
+    return m_bytesUsed;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      returns the memory budget of the journal
+    @return     uint64_t    bytes
+------------------------------------------------------------------------------*/
+uint64_t IDEUndoJournal::getByteBudget() const
+{
+    return m_byteBudget;
+}
+
+// setters ---------------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      sets the memory budget, dropping the oldest steps to fit
+    @param      byteBudget  most bytes the journal may hold
+    @return     void
+------------------------------------------------------------------------------*/
+void IDEUndoJournal::setByteBudget( uint64_t byteBudget )
+{
+    m_byteBudget = byteBudget;
+    trim();
+}
+
+// private functions -----------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      records an edit, joining it to the last step if it carries on
+                from it or a group is open
+    @param      type    insert or erase
+    @param      offset  document offset of the edit
+    @param      text    text inserted or erased
+    @param      before  cursor before the edit
+    @return     void
+------------------------------------------------------------------------------*/
+void IDEUndoJournal::record( EditType type, uint64_t offset, const std::string& text, const CursorState& before )
+{
+    if ( text.empty() )
+    {
+        return;
+    }
+    clearRedo();
+
+    if ( m_stepOpen == false || coalesce( type, offset, text ) == false )
+    {
+        // a group adds every edit to the same step
+        if ( m_stepOpen == false || m_groupDepth == 0 )
+        {
+            m_lastStep++;
+            m_undoSteps++;
+            m_stepOpen = true;
+        }
+
+        EditRecord edit;
+        edit.offset = offset;
+        edit.text   = text;
+        edit.before = before;
+        edit.after  = before;
+        edit.step   = m_lastStep;
+        edit.type   = type;
+        m_bytesUsed += recordBytes( edit );
+        m_undo.push_back( std::move( edit ) );
+    }
+    trim();
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      joins an edit to the last edit when it carries straight on
+                from it, typing after typing or backspace after backspace
+    @param      type    insert or erase
+    @param      offset  document offset of the edit
+    @param      text    text inserted or erased
+    @return     bool    true if joined
+------------------------------------------------------------------------------*/
+bool IDEUndoJournal::coalesce( EditType type, uint64_t offset, const std::string& text )
+{
+    if ( m_undo.empty() || m_undo.back().type != type || m_undo.back().step != m_lastStep )
+    {
+        return false;
+    }
+
+    EditRecord& last = m_undo.back();
+    if ( text.find( '\n' ) != std::string::npos || last.text.find( '\n' ) != std::string::npos )
+    {
+        return false;
+    }
+
+    uint64_t bytes  = recordBytes( last );
+    bool     joined = true;
+    if ( type == EditType::Insert && offset == last.offset + last.text.size() )
+    {
+        // typing
+        last.text += text;
+    }
+    else if ( type == EditType::Erase && offset + text.size() == last.offset )
+    {
+        // backspace
+        last.text.insert( 0, text );
+        last.offset = offset;
+    }
+    else if ( type == EditType::Erase && offset == last.offset )
+    {
+        // delete
+        last.text += text;
+    }
+    else
+    {
+        joined = false;
+    }
+
+    if ( joined )
+    {
+        m_bytesUsed = m_bytesUsed - bytes + recordBytes( last );
+    }
+    return joined;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      drops every step that could be redone
+    @return     void
+------------------------------------------------------------------------------*/
+void IDEUndoJournal::clearRedo()
+{
+    for ( const EditRecord& edit : m_redo )
+    {
+        m_bytesUsed -= recordBytes( edit );
+    }
+    m_redo.clear();
+    m_redoSteps = 0;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      drops the oldest steps until the journal fits its budget,
+                undo steps first then the furthest redo steps
+    @return     void
+------------------------------------------------------------------------------*/
+void IDEUndoJournal::trim()
+{
+    while ( m_bytesUsed > m_byteBudget && m_undo.empty() == false )
+    {
+        uint32_t step = m_undo.front().step;
+        while ( m_undo.empty() == false && m_undo.front().step == step )
+        {
+            m_bytesUsed -= recordBytes( m_undo.front() );
+            m_undo.pop_front();
+        }
+        m_undoSteps--;
+
+        // the rest of a dropped step starts a new one
+        if ( step == m_lastStep )
+        {
+            m_stepOpen = false;
+        }
+    }
+    while ( m_bytesUsed > m_byteBudget && m_redo.empty() == false )
+    {
+        uint32_t step = m_redo.front().step;
+        while ( m_redo.empty() == false && m_redo.front().step == step )
+        {
+            m_bytesUsed -= recordBytes( m_redo.front() );
+            m_redo.pop_front();
+        }
+        m_redoSteps--;
+    }
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBIDE Nimble Library IDE Module
+    @brief      returns the memory an edit holds
+    @param      record  edit
+    @return     uint64_t    bytes
+------------------------------------------------------------------------------*/
+uint64_t IDEUndoJournal::recordBytes( const EditRecord& record ) const
+{
+    return sizeof( EditRecord ) + record.text.capacity();
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: IDEUndoJournal.cpp
+// ----------------------------------------------------------------------------
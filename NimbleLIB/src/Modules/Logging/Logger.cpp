@@ -18,8 +18,28 @@ Notes:
     - LogMessage()
     - LogError()
 
-    TODO: Add the ability to log to a file
-    TODO: Switch different output methods on and off
+    Logging does no formatting or output on the caller's thread. The caller
+    claims a cell of a fixed ring of records with one compare and swap,
+    copies in the time, the error code and the start of the message, and
+    publishes the cell. Any number of threads may log at once. A writer
+    thread takes the records in order, formats them and outputs each batch
+    with one write. The time stamp is only formatted again when the second
+    changes.
+
+    Only a caller that finds the writer asleep wakes it, the writer then
+    waits BATCH_DELAY_MS for more records before draining, so a burst of
+    logging costs one wake up rather than one a record.
+
+    Memory is bounded, the ring holds RING_RECORDS records and a message is
+    cut to PAYLOAD_SIZE bytes, room for a path after the text of the error.
+    A message cut short ends with "..." so the loss shows. When the ring is
+    full the record is dropped rather than waiting, the writer reports how
+    many were dropped. The last HISTORY_LINES lines are kept for saveLog().
+
+    setOutputFile() writes the log straight to a file. The file is rotated
+    once it would pass its size limit, name.1 is the newest old file and the
+    oldest beyond the file count is removed. flush() waits for every
+    record logged so far to be output.
 
 -----------------------------------------------------------------------------*/
 //-----------------------------------------------------------------------------
@@ -28,6 +48,18 @@ Notes:
 
 #include "../../../inc/Modules/ErrorHandling/ErrorHandler.h"
 #include "../../../inc/Modules/Logging/Logger.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+
+#define LOG_FILE_NAME     ( "NimbleLIB.log" ) /* saveLog() file when no output file is set */
+#define TRUNCATION_MARKER ( "..." )           /* ends a message cut short */
+#define TRUNCATION_LENGTH ( 3 )               /* bytes of TRUNCATION_MARKER */
 
 //-----------------------------------------------------------------------------
 // Namesapce
@@ -49,6 +81,24 @@ namespace Nimble
   --------------------------------------------------------------------------*/
 Logger::Logger()
 {
+    ring = std::make_unique<LogRecord[]>( RING_RECORDS );
+    for ( uint32_t index = 0; index < RING_RECORDS; index++ )
+    {
+        ring[index].sequence.store( index, std::memory_order_relaxed );
+    }
+    enqueuePosition.store( 0, std::memory_order_relaxed );
+    writtenCount.store( 0, std::memory_order_relaxed );
+    droppedCount.store( 0, std::memory_order_relaxed );
+    writerSleeping.store( false, std::memory_order_relaxed );
+    writerWake.store( 0, std::memory_order_relaxed );
+    stopWriter.store( false, std::memory_order_relaxed );
+    dequeuePosition = 0;
+    droppedReported = 0;
+    stampSecond     = -1;
+    logFileSize     = 0;
+    maxFileSize     = DEFAULT_FILE_SIZE;
+    maxFiles        = DEFAULT_FILE_COUNT;
+
     outputFile        = false;
     outputTerminal    = false;
     loggerInitialized = false;
@@ -56,20 +106,44 @@ Logger::Logger()
 
 /**---------------------------------------------------------------------------
     @ingroup    NimbleLIBLogger Nimble Library Logger Module
-    @brief      Destructor for the Logger class
+    @brief      Destructor for the Logger class, everything logged is output
+                before the writer ends
 
   --------------------------------------------------------------------------*/
 Logger::~Logger()
 {
+    if ( writerThread.joinable() )
+    {
+        stopWriter.store( true, std::memory_order_release );
+        writerWake.fetch_add( 1, std::memory_order_release );
+        writerWake.notify_one();
+        writerThread.join();
+    }
+    if ( logFile.is_open() )
+    {
+        logFile.close();
+    }
 }
 
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBLogger Nimble Library Logger Module
+    @brief      Initializes the logger, output defaults to the terminal
+                and the writer thread is started
+    @return     void
+  --------------------------------------------------------------------------*/
 void Logger::loggerInitialize()
 {
+    if ( loggerInitialized )
+    {
+        return;
+    }
+
     // defaulted to terminal output
     outputFile     = false;
     outputTerminal = true;
 
     // set the logger as initialized
+    writerThread      = std::thread( &Logger::writerLoop, this );
     loggerInitialized = true;
 }
 
@@ -81,62 +155,431 @@ void Logger::loggerInitialize()
   --------------------------------------------------------------------------*/
 LibraryError Logger::LogMessage( const std::string& message )
 {
-    if ( loggerInitialized == false )
+    return pushRecord( LibraryError::No_Error, message );
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBLogger Nimble Library Logger Module
+    @brief      Log a message to the log file
+    @param      error	   Error code
+    @param      message     Message to log
+    @return     LibraryError - Error code
+  --------------------------------------------------------------------------*/
+LibraryError Logger::LogError( LibraryError error, const std::string& message )
+{
+    return pushRecord( error, message );
+}
+
+// Output of log data ---------------------------------------------------------
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBLogger Nimble Library Logger Module
+    @brief      Switches output to the terminal on or off
+    @param      enabled     True, log lines are written to stdout
+    @return     void
+  --------------------------------------------------------------------------*/
+void Logger::setOutputTerminal( bool enabled )
+{
+    outputTerminal = enabled;
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBLogger Nimble Library Logger Module
+    @brief      Logs straight to a file, appending to it
+    @param      fileName    log file
+    @param      fileSize    size the file may reach before it is rotated
+    @param      fileCount   log files kept, the current one and older ones
+    @return     LibraryError - Error code
+  --------------------------------------------------------------------------*/
+LibraryError Logger::setOutputFile( const std::string& fileName, uint64_t fileSize, uint32_t fileCount )
+{
+    std::lock_guard<std::mutex> lock( sinkMutex );
+    std::error_code             error;
+
+    if ( logFile.is_open() )
     {
-        return LibraryError::Logger_InitializeNotCalled;
+        logFile.close();
+    }
+    logFile.open( fileName, std::ios::binary | std::ios::app );
+    if ( logFile.is_open() == false )
+    {
+        outputFile = false;
+        return LibraryError::Logger_FailedToOpenFile;
     }
 
-    std::time_t       t  = std::chrono::system_clock::to_time_t( std::chrono::system_clock::now() );
-    std::tm*          tm = std::localtime( &t );
-    std::stringstream ss;
+    logFileName = fileName;
+    logFileSize = std::filesystem::file_size( fileName, error );
+    if ( error )
+    {
+        logFileSize = 0;
+    }
+    maxFileSize = std::max<uint64_t>( fileSize, 1 );
+    maxFiles    = std::max<uint32_t>( fileCount, 1 );
+    outputFile  = true;
+    return LibraryError::No_Error;
+}
 
-    // build the logged message
-    ss << "[" << std::put_time( tm, "%d-%m-%Y %H-%M-%S" ) << "] - " << message << std::endl;
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBLogger Nimble Library Logger Module
+    @brief      Stops logging to the file, once everything logged is in it
+    @return     void
+  --------------------------------------------------------------------------*/
+void Logger::closeOutputFile()
+{
+    flush();
 
-    // Add the message to the log
-    loggedInformation.push_back( ss.str() );
+    std::lock_guard<std::mutex> lock( sinkMutex );
+    if ( logFile.is_open() )
+    {
+        logFile.close();
+    }
+    outputFile = false;
+}
 
-    // Output to the terminal if required
-    if ( outputTerminal )
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBLogger Nimble Library Logger Module
+    @brief      Waits until everything logged so far has been output
+    @return     void
+  --------------------------------------------------------------------------*/
+void Logger::flush()
+{
+    if ( writerThread.joinable() == false )
     {
-        std::cout << ss.str();
+        return;
     }
 
-    return LibraryError::No_Error;
+    uint64_t target  = enqueuePosition.load( std::memory_order_acquire );
+    uint64_t written = writtenCount.load( std::memory_order_acquire );
+    while ( written < target )
+    {
+        writerWake.fetch_add( 1, std::memory_order_release );
+        writerWake.notify_one();
+        writtenCount.wait( written, std::memory_order_acquire );
+        written = writtenCount.load( std::memory_order_acquire );
+    }
 }
 
 /**---------------------------------------------------------------------------
     @ingroup    NimbleLIBLogger Nimble Library Logger Module
-    @brief      Log a message to the log file
-    @param      error	   Error code
+    @brief      Gets the number of records dropped as the ring was full
+    @return     uint64_t - records dropped
+  --------------------------------------------------------------------------*/
+uint64_t Logger::getDroppedCount() const
+{
+    return droppedCount.load( std::memory_order_relaxed );
+}
+
+// Control of log data --------------------------------------------------------
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBLogger Nimble Library Logger Module
+    @brief      Clears the lines kept for saveLog()
+    @return     void
+  --------------------------------------------------------------------------*/
+void Logger::clearLog()
+{
+    flush();
+
+    std::lock_guard<std::mutex> lock( historyMutex );
+    loggedInformation.clear();
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBLogger Nimble Library Logger Module
+    @brief      Saves the log. When logging to a file the file is brought up
+                to date, otherwise the lines kept are appended to the log
+                file, LOG_FILE_NAME if none has been set
+    @return     LibraryError - Error code
+  --------------------------------------------------------------------------*/
+LibraryError Logger::saveLog()
+{
+    flush();
+    if ( outputFile )
+    {
+        return LibraryError::No_Error;
+    }
+
+    std::string fileName;
+    {
+        std::lock_guard<std::mutex> lock( sinkMutex );
+        fileName = logFileName.empty() ? LOG_FILE_NAME : logFileName;
+    }
+    std::ofstream file( fileName, std::ios::binary | std::ios::app );
+    if ( file.is_open() == false )
+    {
+        return LibraryError::Logger_FailedToOpenFile;
+    }
+
+    std::lock_guard<std::mutex> lock( historyMutex );
+    for ( const std::string& line : loggedInformation )
+    {
+        file << line;
+    }
+    return file.good() ? LibraryError::No_Error : LibraryError::Logger_FailedToOpenFile;
+}
+
+// Private functions ----------------------------------------------------------
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBLogger Nimble Library Logger Module
+    @brief      Queues a record for the writer, dropping it if the ring is
+                full. Safe to call from any number of threads.
+    @param      error       Error code, No_Error for a message
     @param      message     Message to log
     @return     LibraryError - Error code
   --------------------------------------------------------------------------*/
-LibraryError Logger::LogError( LibraryError error, const std::string& message )
+LibraryError Logger::pushRecord( LibraryError error, const std::string& message )
 {
     if ( loggerInitialized == false )
     {
         return LibraryError::Logger_InitializeNotCalled;
     }
 
-    std::time_t       t  = std::chrono::system_clock::to_time_t( std::chrono::system_clock::now() );
-    std::tm*          tm = std::localtime( &t );
-    std::stringstream ss;
+    // claim the next free cell
+    LogRecord* record   = nullptr;
+    uint64_t   position = enqueuePosition.load( std::memory_order_relaxed );
+    while ( true )
+    {
+        record          = &ring[position & ( RING_RECORDS - 1 )];
+        uint64_t ready  = record->sequence.load( std::memory_order_acquire );
+        int64_t  behind = (int64_t)( ready - position );
+        if ( behind == 0 )
+        {
+            if ( enqueuePosition.compare_exchange_weak( position, position + 1, std::memory_order_relaxed ) )
+            {
+                break;
+            }
+        }
+        else if ( behind < 0 )
+        {
+            droppedCount.fetch_add( 1, std::memory_order_relaxed );
+            return LibraryError::Logger_QueueFull;
+        }
+        else
+        {
+            position = enqueuePosition.load( std::memory_order_relaxed );
+        }
+    }
 
-    // build the logged message
-    ss << "[" << std::put_time( tm, "%d-%m-%Y %H-%M-%S" ) << "] - "
-       << "Error 0x" << std::hex << (uint32_t)error << std::dec << " - " << message << std::endl;
+    // fill and publish it
+    record->ticks  = std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::system_clock::now().time_since_epoch() ).count();
+    record->error  = error;
+    record->length = (uint16_t)std::min<size_t>( message.size(), PAYLOAD_SIZE );
+    memcpy( record->payload, message.data(), record->length );
+    if ( message.size() > PAYLOAD_SIZE )
+    {
+        // show the message was cut short
+        memcpy( record->payload + PAYLOAD_SIZE - TRUNCATION_LENGTH, TRUNCATION_MARKER, TRUNCATION_LENGTH );
+    }
+    record->sequence.store( position + 1, std::memory_order_release );
 
-    // Add the message to the log
-    loggedInformation.push_back( ss.str() );
+    wakeWriter();
+    return LibraryError::No_Error;
+}
 
-    // Output to the terminal if required
-    if ( outputTerminal )
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBLogger Nimble Library Logger Module
+    @brief      Wakes the writer if it is waiting for records. The fence
+                pairs with the one in writerLoop(), either the writer sees
+                the record or the caller sees the writer waiting.
+    @return     void
+  --------------------------------------------------------------------------*/
+void Logger::wakeWriter()
+{
+    std::atomic_thread_fence( std::memory_order_seq_cst );
+    if ( writerSleeping.load( std::memory_order_relaxed ) && writerSleeping.exchange( false, std::memory_order_relaxed ) )
     {
-        std::cout << ss.str();
+        // only the caller that cleared the flag wakes the writer
+        writerWake.fetch_add( 1, std::memory_order_release );
+        writerWake.notify_one();
     }
+}
 
-    return LibraryError::No_Error;
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBLogger Nimble Library Logger Module
+    @brief      Writer thread, outputs the records in batches and sleeps
+                while there are none
+    @return     void
+  --------------------------------------------------------------------------*/
+void Logger::writerLoop()
+{
+    std::string batch;
+
+    while ( true )
+    {
+        uint64_t records = drainRecords( batch );
+        if ( batch.empty() == false )
+        {
+            writeBatch( batch );
+            batch.clear();
+        }
+        if ( records > 0 )
+        {
+            writtenCount.fetch_add( records, std::memory_order_release );
+            writtenCount.notify_all();
+            continue;
+        }
+        if ( stopWriter.load( std::memory_order_acquire ) )
+        {
+            break;
+        }
+
+        // wait, unless a record was published while going to sleep
+        uint32_t wake = writerWake.load( std::memory_order_acquire );
+        writerSleeping.store( true, std::memory_order_relaxed );
+        std::atomic_thread_fence( std::memory_order_seq_cst );
+        if ( ring[dequeuePosition & ( RING_RECORDS - 1 )].sequence.load( std::memory_order_acquire ) != dequeuePosition + 1 && stopWriter.load( std::memory_order_acquire ) == false )
+        {
+            writerWake.wait( wake, std::memory_order_acquire );
+            writerSleeping.store( false, std::memory_order_relaxed );
+
+            // let the records that follow the first gather, callers do not wake the writer while it is awake
+            std::this_thread::sleep_for( std::chrono::milliseconds( (int64_t)BATCH_DELAY_MS ) );
+        }
+        writerSleeping.store( false, std::memory_order_relaxed );
+    }
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBLogger Nimble Library Logger Module
+    @brief      Formats every record published, in order, freeing the cells
+    @param      batch       formatted lines are appended to this
+    @return     uint64_t - records taken from the ring
+  --------------------------------------------------------------------------*/
+uint64_t Logger::drainRecords( std::string& batch )
+{
+    uint64_t records = 0;
+    char     code[32];
+
+    while ( true )
+    {
+        LogRecord& record = ring[dequeuePosition & ( RING_RECORDS - 1 )];
+        if ( record.sequence.load( std::memory_order_acquire ) != dequeuePosition + 1 )
+        {
+            break;
+        }
+
+        // build the logged message
+        formatStamp( record.ticks );
+        batch += stampText;
+        if ( record.error != LibraryError::No_Error )
+        {
+            snprintf( code, sizeof( code ), "Error 0x%x - ", (uint32_t)record.error );
+            batch += code;
+        }
+        batch.append( record.payload, record.length );
+        batch += '\n';
+
+        record.sequence.store( dequeuePosition + RING_RECORDS, std::memory_order_release );
+        dequeuePosition++;
+        records++;
+    }
+
+    uint64_t dropped = droppedCount.load( std::memory_order_relaxed );
+    if ( dropped != droppedReported )
+    {
+        formatStamp( std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::system_clock::now().time_since_epoch() ).count() );
+        batch += stampText + std::to_string( dropped - droppedReported ) + " log records dropped\n";
+        droppedReported = dropped;
+    }
+    return records;
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBLogger Nimble Library Logger Module
+    @brief      Makes stampText for a time, only when the second changes
+    @param      ticks       nanoseconds since the epoch, system clock
+    @return     void
+  --------------------------------------------------------------------------*/
+void Logger::formatStamp( int64_t ticks )
+{
+    int64_t second = ticks / 1000000000;
+    if ( second == stampSecond )
+    {
+        return;
+    }
+
+    std::time_t time = (std::time_t)second;
+    std::tm     local;
+    char        text[64];
+#if ( __linux__ )
+    localtime_r( &time, &local );
+#else
+    localtime_s( &local, &time );
+#endif
+    strftime( text, sizeof( text ), "[%d-%m-%Y %H-%M-%S] - ", &local );
+    stampText   = text;
+    stampSecond = second;
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBLogger Nimble Library Logger Module
+    @brief      Outputs a batch of lines to the terminal and the log file,
+                and keeps them for saveLog()
+    @param      batch       formatted lines
+    @return     void
+  --------------------------------------------------------------------------*/
+void Logger::writeBatch( const std::string& batch )
+{
+    {
+        std::lock_guard<std::mutex> lock( sinkMutex );
+
+        // Output to the terminal if required
+        if ( outputTerminal )
+        {
+            std::cout << batch;
+            std::cout.flush();
+        }
+        if ( outputFile && logFile.is_open() )
+        {
+            if ( logFileSize > 0 && logFileSize + batch.size() > maxFileSize )
+            {
+                rotateFile();
+            }
+            logFile.write( batch.data(), batch.size() );
+            logFile.flush();
+            logFileSize += batch.size();
+        }
+    }
+
+    // Add the lines to the log, the oldest are dropped
+    std::lock_guard<std::mutex> lock( historyMutex );
+    size_t                      start = 0;
+    while ( start < batch.size() )
+    {
+        size_t end = batch.find( '\n', start );
+        end        = ( end == std::string::npos ) ? batch.size() : end + 1;
+        loggedInformation.emplace_back( batch, start, end - start );
+        start = end;
+    }
+    while ( loggedInformation.size() > HISTORY_LINES )
+    {
+        loggedInformation.pop_front();
+    }
+}
+
+/**---------------------------------------------------------------------------
+    @ingroup    NimbleLIBLogger Nimble Library Logger Module
+    @brief      Moves the log file to name.1, older files up by one, and
+                starts the log file again. sinkMutex must be held.
+    @return     void
+  --------------------------------------------------------------------------*/
+void Logger::rotateFile()
+{
+    std::error_code error;
+
+    logFile.close();
+    for ( uint32_t index = maxFiles - 1; index > 0; index-- )
+    {
+        std::string from = ( index == 1 ) ? logFileName : logFileName + "." + std::to_string( index - 1 );
+        std::filesystem::rename( from, logFileName + "." + std::to_string( index ), error );
+    }
+    logFile.open( logFileName, std::ios::binary | std::ios::trunc );
+    logFileSize = 0;
+    if ( logFile.is_open() == false )
+    {
+        outputFile = false;
+    }
 }
 
 //-----------------------------------------------------------------------------
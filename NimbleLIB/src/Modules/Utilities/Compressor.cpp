@@ -0,0 +1,306 @@
+/**----------------------------------------------------------------------------
+
+    @file       Compressor.cpp
+    @defgroup   NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      Compressor class for the Nimble Library
+
+    @copyright  Neil Bereford 2023
+
+Notes:
+
+    The format is a run of sequences after an 8 byte original size. Each
+    sequence is a token byte, literals, a 2 byte offset and more match
+    length. The token's high nibble is the literal count and the low nibble
+    the match length less MIN_MATCH, a nibble of 15 is followed by bytes
+    that are added to it until one is below 255. The last sequence has only
+    literals, it ends at the end of the input.
+
+    The compressor finds matches with a single entry hash table of the
+    next 4 bytes, it does not search for the longest match. Where nothing
+    matches it steps further the longer it has gone without a match, so
+    text that does not compress is passed over quickly. Source text
+    usually packs to between a third and a quarter of its size.
+
+    decompress() checks every length and offset against the buffers, bad
+    input returns false rather than reading or writing out of bounds.
+
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// Include files
+// ----------------------------------------------------------------------------
+
+#include "../../../inc/Modules/Utilities/Compressor.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+// Namespace
+// ----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Local data
+// ----------------------------------------------------------------------------
+
+static const uint32_t HEADER_SIZE   = 8;  //!< original size stored before the sequences
+static const uint32_t NIBBLE_MAX    = 15; //!< nibble value followed by more length bytes
+static const uint32_t SKIP_STRENGTH = 6;  //!< step grows by one every 64 bytes without a match
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      reads 4 bytes, unaligned
+    @param      data    bytes to read
+    @return     uint32_t    bytes read
+------------------------------------------------------------------------------*/
+static inline uint32_t read32( const uint8_t* data )
+{
+    uint32_t value;
+    memcpy( &value, data, sizeof( value ) );
+    return value;
+}
+
+//-----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+// compression -----------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      compresses a block of bytes
+    @param      input   bytes to compress
+    @param      output  set to the compressed bytes
+    @return     void
+------------------------------------------------------------------------------*/
+void Compressor::compress( std::string_view input, std::string& output )
+{
+    const uint8_t* data   = (const uint8_t*)input.data();
+    uint64_t       size   = input.size();
+    uint64_t       anchor = 0;
+    uint64_t       pos    = 0;
+
+    output.clear();
+    output.reserve( HEADER_SIZE + size / 2 );
+    for ( uint32_t byte = 0; byte < HEADER_SIZE; byte++ )
+    {
+        output += (char)( ( size >> ( byte * 8 ) ) & 0xFF );
+    }
+
+    // positions + 1 of the last 4 bytes seen with each hash, 0 if none
+    std::vector<uint32_t> table( (size_t)1 << HASH_BITS, 0 );
+    uint64_t              base = 0;
+
+    while ( size >= MIN_MATCH && pos <= size - MIN_MATCH )
+    {
+        // the table holds 32 bit positions, start again every 4GB
+        if ( pos - base >= 0xFFFFFFF0 )
+        {
+            std::fill( table.begin(), table.end(), 0 );
+            base = pos;
+        }
+
+        uint32_t value     = read32( data + pos );
+        uint32_t hash      = ( value * 2654435761u ) >> ( 32 - HASH_BITS );
+        uint64_t candidate = base + table[hash] - 1;
+        bool     found     = table[hash] != 0 && pos - candidate <= MAX_OFFSET && read32( data + candidate ) == value;
+        table[hash]        = (uint32_t)( pos - base + 1 );
+
+        if ( found == false )
+        {
+            pos += 1 + ( ( pos - anchor ) >> SKIP_STRENGTH );
+            continue;
+        }
+
+        uint64_t length = MIN_MATCH;
+        while ( pos + length < size && data[candidate + length] == data[pos + length] )
+        {
+            length++;
+        }
+
+        // token, literals, offset, then the rest of each length
+        uint64_t literals = pos - anchor;
+        uint64_t extra    = length - MIN_MATCH;
+        uint8_t  token    = (uint8_t)( ( std::min<uint64_t>( literals, NIBBLE_MAX ) << 4 ) | std::min<uint64_t>( extra, NIBBLE_MAX ) );
+        uint64_t offset   = pos - candidate;
+        output += (char)token;
+        if ( literals >= NIBBLE_MAX )
+        {
+            writeLength( output, literals - NIBBLE_MAX );
+        }
+        output.append( (const char*)data + anchor, literals );
+        output += (char)( offset & 0xFF );
+        output += (char)( offset >> 8 );
+        if ( extra >= NIBBLE_MAX )
+        {
+            writeLength( output, extra - NIBBLE_MAX );
+        }
+
+        pos += length;
+        anchor = pos;
+    }
+
+    // the last sequence is only literals
+    uint64_t literals = size - anchor;
+    output += (char)( std::min<uint64_t>( literals, NIBBLE_MAX ) << 4 );
+    if ( literals >= NIBBLE_MAX )
+    {
+        writeLength( output, literals - NIBBLE_MAX );
+    }
+    output.append( (const char*)data + anchor, literals );
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      restores a block compressed by compress()
+    @param      input   compressed bytes
+    @param      output  set to the original bytes
+    @return     bool    false if the input is not a valid block
+------------------------------------------------------------------------------*/
+bool Compressor::decompress( std::string_view input, std::string& output )
+{
+    const uint8_t* cursor = (const uint8_t*)input.data();
+    const uint8_t* end    = cursor + input.size();
+    uint64_t       size   = getOriginalSize( input );
+    uint64_t       pos    = 0;
+
+    // no sequence can expand by more than 255 times its own size
+    output.clear();
+    if ( input.size() < HEADER_SIZE + 1 || size / 256 > input.size() )
+    {
+        return false;
+    }
+    output.resize( size );
+    char* out = output.data();
+    cursor += HEADER_SIZE;
+
+    while ( cursor < end )
+    {
+        uint8_t  token    = *cursor++;
+        uint64_t literals = token >> 4;
+        uint64_t length   = token & NIBBLE_MAX;
+
+        if ( literals == NIBBLE_MAX && readLength( cursor, end, literals ) == false )
+        {
+            return false;
+        }
+        if ( literals > (uint64_t)( end - cursor ) || literals > size - pos )
+        {
+            return false;
+        }
+        memcpy( out + pos, cursor, literals );
+        cursor += literals;
+        pos += literals;
+
+        // the last sequence ends at the end of the input
+        if ( cursor == end )
+        {
+            break;
+        }
+
+        if ( end - cursor < 2 )
+        {
+            return false;
+        }
+        uint64_t offset = cursor[0] | ( (uint64_t)cursor[1] << 8 );
+        cursor += 2;
+        if ( length == NIBBLE_MAX && readLength( cursor, end, length ) == false )
+        {
+            return false;
+        }
+        length += MIN_MATCH;
+        if ( offset == 0 || offset > pos || length > size - pos )
+        {
+            return false;
+        }
+
+        // a match may overlap the bytes it writes, copy forwards
+        const char* from = out + pos - offset;
+        if ( offset >= length )
+        {
+            memcpy( out + pos, from, length );
+        }
+        else
+        {
+            for ( uint64_t byte = 0; byte < length; byte++ )
+            {
+                out[pos + byte] = from[byte];
+            }
+        }
+        pos += length;
+    }
+    return pos == size;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      returns the size of a compressed block once restored
+    @param      input   compressed bytes
+    @return     uint64_t    original size, 0 if the input is too short
+------------------------------------------------------------------------------*/
+uint64_t Compressor::getOriginalSize( std::string_view input )
+{
+    uint64_t size = 0;
+
+    if ( input.size() >= HEADER_SIZE )
+    {
+        for ( uint32_t byte = 0; byte < HEADER_SIZE; byte++ )
+        {
+            size |= (uint64_t)(uint8_t)input[byte] << ( byte * 8 );
+        }
+    }
+    return size;
+}
+
+// private functions -----------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      writes the part of a length above a full nibble
+    @param      output  compressed bytes to append to
+    @param      length  length less NIBBLE_MAX
+    @return     void
+------------------------------------------------------------------------------*/
+void Compressor::writeLength( std::string& output, uint64_t length )
+{
+    while ( length >= 255 )
+    {
+        output += (char)255;
+        length -= 255;
+    }
+    output += (char)length;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      reads the part of a length above a full nibble
+    @param      cursor  position in the compressed bytes, moved past the length
+    @param      end     end of the compressed bytes
+    @param      length  nibble value, the bytes read are added to it
+    @return     bool    false if the input ends within the length
+------------------------------------------------------------------------------*/
+bool Compressor::readLength( const uint8_t*& cursor, const uint8_t* end, uint64_t& length )
+{
+    uint8_t byte;
+    do
+    {
+        if ( cursor == end )
+        {
+            return false;
+        }
+        byte = *cursor++;
+        length += byte;
+    } while ( byte == 255 );
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: Compressor.cpp
+// ----------------------------------------------------------------------------
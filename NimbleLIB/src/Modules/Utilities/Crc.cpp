@@ -0,0 +1,384 @@
+/**----------------------------------------------------------------------------
+
+    @file       Crc.cpp
+    @defgroup   NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      CRC engine for the Nimble Library
+
+    @copyright  Neil Bereford 2023
+
+Notes:
+
+    All three CRCs are reflected, the low bit of the running CRC is the
+    next to be shifted out, so one routine serves them all with a table
+    made from the reflected polynomial of each.
+
+    Table takes a byte a step, a lookup replacing the eight shifts of the
+    bitwise loop Tools::crc16 used. Slice8 takes eight bytes a step, the
+    eight bytes xored with the CRC each index a table of their own and the
+    eight lookups, being independent, run side by side. The tables are
+    built by the compiler.
+
+    CRC-32C has an instruction of its own on x86 CPUs with SSE4.2, the CPU
+    is checked once when the first Crc asks for it, the CRC is taken eight
+    bytes an instruction. Other CPUs, and the other CRCs, use Slice8.
+
+    update() can be called as often as wanted, finalise() gives the CRC of
+    everything passed so far and leaves the CRC running. updateFile() maps
+    the file with MappedFile rather than reading it, the pages are loaded
+    as the CRC reaches them.
+
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// Include files
+// ----------------------------------------------------------------------------
+
+#include "../../../inc/Modules/Utilities/Crc.h"
+#include "../../../inc/Modules/FileHandling/MappedFile.h"
+#include <cstring>
+
+#if defined( __x86_64__ ) || defined( _M_X64 )
+#define CRC_HARDWARE 1
+#include <nmmintrin.h>
+#if defined( _MSC_VER )
+#include <intrin.h>
+#define CRC_TARGET_SSE42
+#else
+#define CRC_TARGET_SSE42 __attribute__( ( target( "sse4.2" ) ) )
+#endif
+#endif
+
+//-----------------------------------------------------------------------------
+// Namespace
+// ----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Local types and data
+// ----------------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      Lookup tables of a CRC, entry[0] is the byte table and
+                entry[n] moves a byte n bytes further on
+-----------------------------------------------------------------------------*/
+struct CrcTables
+{
+    uint32_t entry[Crc::SLICE_BYTES][Crc::TABLE_SIZE]; //!< tables, by byte position
+};
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      Builds the tables of a reflected CRC
+    @param      poly        reflected polynomial
+    @return     CrcTables   tables
+-----------------------------------------------------------------------------*/
+static constexpr CrcTables makeTables( uint32_t poly )
+{
+    CrcTables tables {};
+
+    for ( uint32_t index = 0; index < Crc::TABLE_SIZE; index++ )
+    {
+        uint32_t crc = index;
+        for ( uint32_t bit = 0; bit < 8; bit++ )
+        {
+            crc = ( crc & 1 ) ? ( crc >> 1 ) ^ poly : crc >> 1;
+        }
+        tables.entry[0][index] = crc;
+    }
+    for ( uint32_t slice = 1; slice < Crc::SLICE_BYTES; slice++ )
+    {
+        for ( uint32_t index = 0; index < Crc::TABLE_SIZE; index++ )
+        {
+            uint32_t crc               = tables.entry[slice - 1][index];
+            tables.entry[slice][index] = ( crc >> 8 ) ^ tables.entry[0][crc & 0xFF];
+        }
+    }
+    return tables;
+}
+
+static constexpr CrcTables CRC16_TABLES  = makeTables( 0x0000A001 ); //!< CRC-16/MODBUS
+static constexpr CrcTables CRC32_TABLES  = makeTables( 0xEDB88320 ); //!< CRC-32
+static constexpr CrcTables CRC32C_TABLES = makeTables( 0x82F63B78 ); //!< CRC-32C
+
+//-----------------------------------------------------------------------------
+// Local functions
+// ----------------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      Gets the tables of a CRC
+    @param      type        CRC
+    @return     const CrcTables&    tables
+-----------------------------------------------------------------------------*/
+static const CrcTables& getTables( Crc::CrcType type )
+{
+    switch ( type )
+    {
+        case Crc::CrcType::Crc16:
+            return CRC16_TABLES;
+        case Crc::CrcType::Crc32C:
+            return CRC32C_TABLES;
+        default:
+            return CRC32_TABLES;
+    }
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      Gets the starting value of a CRC, also the value it is
+                xored with to finish
+    @param      type        CRC
+    @param      final       true for the final xor
+    @return     uint32_t    value
+-----------------------------------------------------------------------------*/
+static uint32_t getInitial( Crc::CrcType type, bool final )
+{
+    if ( type == Crc::CrcType::Crc16 )
+    {
+        return final ? 0x0000 : 0xFFFF;
+    }
+    return 0xFFFFFFFF;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      Adds bytes to a CRC, a byte a step
+    @param      tables      tables of the CRC
+    @param      crc         running CRC
+    @param      data        bytes
+    @param      length      number of bytes
+    @return     uint32_t    running CRC
+-----------------------------------------------------------------------------*/
+static uint32_t updateTable( const CrcTables& tables, uint32_t crc, const uint8_t* data, size_t length )
+{
+    while ( length-- )
+    {
+        crc = ( crc >> 8 ) ^ tables.entry[0][( crc ^ *data++ ) & 0xFF];
+    }
+    return crc;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      Adds bytes to a CRC, eight bytes a step
+    @param      tables      tables of the CRC
+    @param      crc         running CRC
+    @param      data        bytes
+    @param      length      number of bytes
+    @return     uint32_t    running CRC
+-----------------------------------------------------------------------------*/
+static uint32_t updateSlice8( const CrcTables& tables, uint32_t crc, const uint8_t* data, size_t length )
+{
+    const uint32_t( &entry )[Crc::SLICE_BYTES][Crc::TABLE_SIZE] = tables.entry;
+
+    while ( length >= Crc::SLICE_BYTES )
+    {
+        // the bytes are assembled little endian whatever the CPU
+        uint32_t low  = ( (uint32_t)data[0] | (uint32_t)data[1] << 8 | (uint32_t)data[2] << 16 | (uint32_t)data[3] << 24 ) ^ crc;
+        uint32_t high = (uint32_t)data[4] | (uint32_t)data[5] << 8 | (uint32_t)data[6] << 16 | (uint32_t)data[7] << 24;
+
+        crc = entry[7][low & 0xFF] ^ entry[6][( low >> 8 ) & 0xFF] ^ entry[5][( low >> 16 ) & 0xFF] ^ entry[4][low >> 24] ^
+              entry[3][high & 0xFF] ^ entry[2][( high >> 8 ) & 0xFF] ^ entry[1][( high >> 16 ) & 0xFF] ^ entry[0][high >> 24];
+        data += Crc::SLICE_BYTES;
+        length -= Crc::SLICE_BYTES;
+    }
+    return updateTable( tables, crc, data, length );
+}
+
+#if defined( CRC_HARDWARE )
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      Adds bytes to a CRC-32C with the SSE4.2 crc32 instruction,
+                only called when the CPU has it
+    @param      crc         running CRC
+    @param      data        bytes
+    @param      length      number of bytes
+    @return     uint32_t    running CRC
+-----------------------------------------------------------------------------*/
+CRC_TARGET_SSE42 static uint32_t updateHardware( uint32_t crc, const uint8_t* data, size_t length )
+{
+    uint64_t value = crc;
+
+    while ( length >= sizeof( uint64_t ) )
+    {
+        uint64_t word;
+        memcpy( &word, data, sizeof( word ) );
+        value = _mm_crc32_u64( value, word );
+        data += sizeof( uint64_t );
+        length -= sizeof( uint64_t );
+    }
+    crc = (uint32_t)value;
+    while ( length-- )
+    {
+        crc = _mm_crc32_u8( crc, *data++ );
+    }
+    return crc;
+}
+#endif
+
+//-----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+// constructor ----------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      Constructor for the Crc class
+    @param      type        CRC to calculate
+    @param      method      how to calculate it, Hardware is only used for
+                            CRC-32C on a CPU that has it
+
+-----------------------------------------------------------------------------*/
+Crc::Crc( CrcType type, CrcMethod method )
+{
+    crcType   = type;
+    crcMethod = method;
+    if ( method == CrcMethod::Fastest || method == CrcMethod::Hardware )
+    {
+        crcMethod = ( type == CrcType::Crc32C && hasHardwareCrc32C() ) ? CrcMethod::Hardware : CrcMethod::Slice8;
+    }
+    reset();
+}
+
+// streaming ------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      Starts the CRC again
+    @return     void
+-----------------------------------------------------------------------------*/
+void Crc::reset()
+{
+    crcValue = getInitial( crcType, false );
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      Adds data to the CRC
+    @param      data        data
+    @param      length      number of bytes
+    @return     void
+-----------------------------------------------------------------------------*/
+void Crc::update( const void* data, size_t length )
+{
+    const uint8_t* bytes = (const uint8_t*)data;
+
+    switch ( crcMethod )
+    {
+        case CrcMethod::Table:
+            crcValue = updateTable( getTables( crcType ), crcValue, bytes, length );
+            break;
+#if defined( CRC_HARDWARE )
+        case CrcMethod::Hardware:
+            crcValue = updateHardware( crcValue, bytes, length );
+            break;
+#endif
+        default:
+            crcValue = updateSlice8( getTables( crcType ), crcValue, bytes, length );
+            break;
+    }
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      Adds the contents of a file to the CRC, the file is mapped
+                rather than read
+    @param      fileName    file
+    @return     LibraryError    error code, the CRC is unchanged on error
+-----------------------------------------------------------------------------*/
+LibraryError Crc::updateFile( const std::string& fileName )
+{
+    MappedFile   file;
+    LibraryError error = file.open( fileName );
+
+    if ( error == LibraryError::No_Error )
+    {
+        update( file.getData(), (size_t)file.getSize() );
+    }
+    return error;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      Gets the CRC of the data added so far, more can be added
+    @return     uint32_t    CRC, CRC-16 in the low 16 bits
+-----------------------------------------------------------------------------*/
+uint32_t Crc::finalise() const
+{
+    return crcValue ^ getInitial( crcType, true );
+}
+
+// one shot -------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      Calculates the CRC of a buffer, by the fastest method
+    @param      type        CRC to calculate
+    @param      data        data
+    @param      length      number of bytes
+    @return     uint32_t    CRC, CRC-16 in the low 16 bits
+-----------------------------------------------------------------------------*/
+uint32_t Crc::calculate( CrcType type, const void* data, size_t length )
+{
+    Crc crc( type );
+
+    crc.update( data, length );
+    return crc.finalise();
+}
+
+// getters --------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      Gets the CRC calculated
+    @return     CrcType     CRC
+-----------------------------------------------------------------------------*/
+Crc::CrcType Crc::getType() const
+{
+    return crcType;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      Gets the method used, Fastest is given as the method it chose
+    @return     CrcMethod   method
+-----------------------------------------------------------------------------*/
+Crc::CrcMethod Crc::getMethod() const
+{
+    return crcMethod;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      Checks if the CPU has the CRC-32C instruction, SSE4.2
+    @return     bool    true if the instruction can be used
+-----------------------------------------------------------------------------*/
+bool Crc::hasHardwareCrc32C()
+{
+#if defined( CRC_HARDWARE ) && defined( _MSC_VER )
+    static const bool hardware = []()
+    {
+        int info[4];
+        __cpuid( info, 1 );
+        return ( info[2] & ( 1 << 20 ) ) != 0;
+    }();
+    return hardware;
+#elif defined( CRC_HARDWARE )
+    static const bool hardware = __builtin_cpu_supports( "sse4.2" );
+    return hardware;
+#else
+    return false;
+#endif
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: Crc.cpp
+// ----------------------------------------------------------------------------
@@ -0,0 +1,357 @@
+/**----------------------------------------------------------------------------
+
+    @file       Profiler.cpp
+    @defgroup   NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      Profiler class for the Nimble Library
+
+    @copyright  Neil Bereford 2023
+
+Notes:
+
+    A zone is a scope timed with PROFILE_ZONE( "name" ), the name must be a
+    string literal as only the pointer is kept. While the profiler is
+    disabled a zone checks one flag and records nothing, building with
+    NIMBLE_NO_PROFILER defined removes the zones altogether.
+
+    Each thread records its zones into its own ring of ZONE_HISTORY
+    records, the oldest being overwritten, so recording takes no lock. The
+    ring is found through a thread local pointer, the profiler's list of
+    rings is only locked the first time a thread records a zone. The ring
+    is read while its thread writes it, records the thread may have
+    overwritten during the read are dropped.
+
+    A frame runs from the outermost CursesWin::beginFrame() to the matching
+    endFrame(), including the terminal update, and is recorded as a zone
+    named "frame" as well. The frame statistics and the top zones cover the
+    last FRAME_HISTORY frames. Frames must be begun and ended on one thread.
+
+    exportChromeTrace() writes every zone still held as a Chrome trace
+    event file, which chrome://tracing and Perfetto load.
+
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// Include files
+// ----------------------------------------------------------------------------
+
+#include "../../../inc/Modules/Utilities/Profiler.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <string_view>
+
+//-----------------------------------------------------------------------------
+// Namespace
+// ----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Local data
+// ----------------------------------------------------------------------------
+
+static const char* FRAME_ZONE = "frame"; //!< zone name the frames are recorded under
+
+std::atomic<bool> Profiler::enabled( false );
+
+//-----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+// constructors ----------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      Profiler Constructor
+------------------------------------------------------------------------------*/
+Profiler::Profiler() : m_epoch( std::chrono::steady_clock::now() ), m_frameStarts( FRAME_HISTORY, 0 ), m_frameLengths( FRAME_HISTORY, 0 ), m_frameCount( 0 ), m_frameStart( 0 )
+{
+}
+
+// singleton -------------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      gets the profiler
+    @return     Profiler&   the profiler
+------------------------------------------------------------------------------*/
+Profiler& Profiler::getInstance()
+{
+    static Profiler instance;
+    return instance;
+}
+
+// control ---------------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      starts or stops recording, the zones and frames already
+                recorded are kept
+    @param      enable  true to record
+    @return     void
+------------------------------------------------------------------------------*/
+void Profiler::setEnabled( bool enable )
+{
+    m_frameStart = 0;
+    enabled.store( enable, std::memory_order_relaxed );
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      forgets the frames recorded, and the zones of the calling
+                thread and of threads not recording at the time
+    @return     void
+------------------------------------------------------------------------------*/
+void Profiler::clear()
+{
+    std::lock_guard<std::mutex> lock( m_ringsMutex );
+    for ( auto& ring : m_rings )
+    {
+        ring->written.store( 0, std::memory_order_release );
+    }
+    std::fill( m_frameStarts.begin(), m_frameStarts.end(), 0 );
+    std::fill( m_frameLengths.begin(), m_frameLengths.end(), 0 );
+    m_frameCount = 0;
+    m_frameStart = 0;
+}
+
+// recording -------------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      records a zone in the calling thread's ring
+    @param      name    zone name, a string literal
+    @param      start   start of the zone, from now()
+    @param      end     end of the zone, from now()
+    @return     void
+------------------------------------------------------------------------------*/
+void Profiler::recordZone( const char* name, uint64_t start, uint64_t end )
+{
+    ZoneRing*   ring   = getThreadRing();
+    uint64_t    index  = ring->written.load( std::memory_order_relaxed );
+    ZoneRecord& record = ring->records[index & ( ZONE_HISTORY - 1 )];
+    record.name.store( name, std::memory_order_relaxed );
+    record.start.store( start, std::memory_order_relaxed );
+    record.end.store( end, std::memory_order_relaxed );
+    ring->written.store( index + 1, std::memory_order_release );
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      starts timing a frame
+    @return     void
+------------------------------------------------------------------------------*/
+void Profiler::beginFrame()
+{
+    if ( isEnabled() )
+    {
+        m_frameStart = now();
+    }
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      records the frame begun, if the profiler was enabled for the
+                whole of it
+    @return     void
+------------------------------------------------------------------------------*/
+void Profiler::endFrame()
+{
+    if ( isEnabled() && m_frameStart != 0 )
+    {
+        uint64_t end = now();
+
+        m_frameStarts[m_frameCount % FRAME_HISTORY]  = m_frameStart;
+        m_frameLengths[m_frameCount % FRAME_HISTORY] = end - m_frameStart;
+        m_frameCount++;
+        recordZone( FRAME_ZONE, m_frameStart, end );
+    }
+    m_frameStart = 0;
+}
+
+// statistics ------------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      gets the times of the last FRAME_HISTORY frames
+    @param      lastMs      returns the last frame, in milliseconds
+    @param      averageMs   returns the average frame
+    @param      p99Ms       returns the 99th percentile frame
+    @return     bool        false if no frame has been recorded
+------------------------------------------------------------------------------*/
+bool Profiler::getFrameTimes( double& lastMs, double& averageMs, double& p99Ms ) const
+{
+    uint32_t frames = (uint32_t)std::min<uint64_t>( m_frameCount, FRAME_HISTORY );
+
+    if ( frames == 0 )
+    {
+        return false;
+    }
+
+    std::vector<uint64_t> lengths( m_frameLengths.begin(), m_frameLengths.begin() + frames );
+    uint64_t              total = 0;
+    for ( uint64_t length : lengths )
+    {
+        total += length;
+    }
+    size_t rank = ( frames * 99 ) / 100;
+    std::nth_element( lengths.begin(), lengths.begin() + rank, lengths.end() );
+    lastMs    = m_frameLengths[( m_frameCount - 1 ) % FRAME_HISTORY] / 1e6;
+    averageMs = total / 1e6 / frames;
+    p99Ms     = lengths[rank] / 1e6;
+    return true;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      gets the zones that took longest over the last FRAME_HISTORY
+                frames, a zone's time includes the zones inside it
+    @param      count   zones wanted
+    @return     std::vector<std::pair<const char*, uint64_t>>   zone names
+                and nanoseconds, longest first
+------------------------------------------------------------------------------*/
+std::vector<std::pair<const char*, uint64_t>> Profiler::getTopZones( uint32_t count ) const
+{
+    std::map<std::string_view, std::pair<const char*, uint64_t>> totals;
+    uint64_t                                                     since = 0;
+
+    if ( m_frameCount > 0 )
+    {
+        since = m_frameStarts[( m_frameCount > FRAME_HISTORY ) ? m_frameCount % FRAME_HISTORY : 0];
+    }
+
+    std::lock_guard<std::mutex> lock( m_ringsMutex );
+    for ( const auto& ring : m_rings )
+    {
+        uint64_t written = ring->written.load( std::memory_order_acquire );
+        uint64_t first   = ( written > ZONE_HISTORY ) ? written - ZONE_HISTORY : 0;
+        for ( uint64_t index = written; index > first; index-- )
+        {
+            const ZoneRecord& record = ring->records[( index - 1 ) & ( ZONE_HISTORY - 1 )];
+            const char*       name   = record.name.load( std::memory_order_relaxed );
+            uint64_t          start  = record.start.load( std::memory_order_relaxed );
+            uint64_t          end    = record.end.load( std::memory_order_relaxed );
+            if ( start < since )
+            {
+                break;
+            }
+            if ( name != FRAME_ZONE && name != nullptr && end > start )
+            {
+                auto& total = totals[name];
+                total.first = name;
+                total.second += end - start;
+            }
+        }
+    }
+
+    std::vector<std::pair<const char*, uint64_t>> zones;
+    for ( auto& total : totals )
+    {
+        zones.push_back( total.second );
+    }
+    std::sort( zones.begin(), zones.end(), []( const auto& a, const auto& b ) { return a.second > b.second; } );
+    if ( zones.size() > count )
+    {
+        zones.resize( count );
+    }
+    return zones;
+}
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      gets the number of frames recorded
+    @return     uint64_t    frames
+------------------------------------------------------------------------------*/
+uint64_t Profiler::getFrameCount() const
+{
+    return m_frameCount;
+}
+
+// export ----------------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      writes the zones held as a Chrome trace event file
+    @param      fileName    file to write
+    @return     bool        false if the file could not be written
+------------------------------------------------------------------------------*/
+bool Profiler::exportChromeTrace( const std::string& fileName ) const
+{
+    std::ofstream file( fileName, std::ios::binary );
+    const char*   separator = "\n";
+    char          event[128];
+
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    std::lock_guard<std::mutex> lock( m_ringsMutex );
+    for ( const auto& ring : m_rings )
+    {
+        uint64_t written = ring->written.load( std::memory_order_acquire );
+        uint64_t first   = ( written > ZONE_HISTORY ) ? written - ZONE_HISTORY : 0;
+        std::vector<std::pair<const char*, std::pair<uint64_t, uint64_t>>> zones;
+        for ( uint64_t index = first; index < written; index++ )
+        {
+            const ZoneRecord& record = ring->records[index & ( ZONE_HISTORY - 1 )];
+            zones.push_back( { record.name.load( std::memory_order_relaxed ), { record.start.load( std::memory_order_relaxed ), record.end.load( std::memory_order_relaxed ) } } );
+        }
+
+        // records the thread wrote over while they were copied are dropped
+        uint64_t after = ring->written.load( std::memory_order_acquire );
+        size_t   skip  = (size_t)std::min<uint64_t>( zones.size(), ( after - first > ZONE_HISTORY - 1 ) ? after - first - ( ZONE_HISTORY - 1 ) : 0 );
+        for ( size_t zone = skip; zone < zones.size(); zone++ )
+        {
+            const char* name  = zones[zone].first;
+            uint64_t    start = zones[zone].second.first;
+            uint64_t    end   = zones[zone].second.second;
+            if ( name == nullptr || end < start )
+            {
+                continue;
+            }
+            file << separator << "{\"name\":\"";
+            for ( const char* ch = name; *ch != '\0'; ch++ )
+            {
+                file << ( ( *ch == '"' || *ch == '\\' ) ? "\\" : "" ) << *ch;
+            }
+            snprintf( event, sizeof( event ), "\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", ring->threadID, start / 1e3, ( end - start ) / 1e3 );
+            file << event;
+            separator = ",\n";
+        }
+    }
+    file << "\n]}\n";
+    return file.good();
+}
+
+// private functions -----------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      gets the calling thread's ring, creating it the first time
+    @return     ZoneRing*   the thread's ring
+------------------------------------------------------------------------------*/
+Profiler::ZoneRing* Profiler::getThreadRing()
+{
+    thread_local ZoneRing* threadRing = nullptr;
+
+    if ( threadRing == nullptr )
+    {
+        auto ring     = std::make_unique<ZoneRing>();
+        ring->records = std::make_unique<ZoneRecord[]>( ZONE_HISTORY );
+        ring->written.store( 0, std::memory_order_relaxed );
+
+        std::lock_guard<std::mutex> lock( m_ringsMutex );
+        ring->threadID = (uint32_t)m_rings.size() + 1;
+        threadRing     = ring.get();
+        m_rings.push_back( std::move( ring ) );
+    }
+    return threadRing;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: Profiler.cpp
+// ----------------------------------------------------------------------------
@@ -0,0 +1,271 @@
+/**----------------------------------------------------------------------------
+
+    @file       ThreadPool.cpp
+    @defgroup   NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      Work stealing thread pool for the Nimble Library
+
+    @copyright  Neil Bereford 2023
+
+Notes:
+
+    Every worker has a queue of its own. A task submitted by a worker, say
+    a directory found while walking a tree, goes on the back of that
+    worker's queue and the worker takes from the back, so it carries on
+    with the work it just found while its data is still in the cache. A
+    task submitted from any other thread goes on the queues in turn.
+
+    A worker whose queue is empty steals from the front of the other
+    queues, the oldest task, which in a tree walk is the one nearest the
+    root and so likely to lead to the most work. Each queue has a lock of
+    its own, held only to push or take one task, so the workers rarely
+    wait on each other.
+
+    Workers with nothing to take sleep on a condition variable and are
+    woken as tasks are submitted. wait() sleeps until every task submitted
+    has finished, it must not be called from a task. The destructor lets
+    the tasks already submitted finish before the workers exit.
+
+    Example of usage:
+
+        ThreadPool pool;
+        pool.submit( []() { searchFile( "main.cpp" ); } );
+        pool.wait();
+
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// Include files
+// ----------------------------------------------------------------------------
+
+#include "../../../inc/Modules/Utilities/ThreadPool.h"
+
+//-----------------------------------------------------------------------------
+// Namespace
+// ----------------------------------------------------------------------------
+
+namespace Nimble
+{
+
+//-----------------------------------------------------------------------------
+// Local variables
+// ----------------------------------------------------------------------------
+
+static thread_local const ThreadPool* workerPool  = nullptr; //!< pool the thread works for, if any
+static thread_local uint32_t          workerIndex = 0;       //!< queue of the thread in that pool
+
+//-----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+// constructors & destructors -------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      Constructor for ThreadPool class, starts the workers
+    @param      threads     workers to start, 0 for one per core
+-----------------------------------------------------------------------------*/
+ThreadPool::ThreadPool( uint32_t threads /*= 0*/ )
+{
+    if ( threads == 0 )
+    {
+        threads = std::thread::hardware_concurrency();
+    }
+    if ( threads == 0 )
+    {
+        threads = 1;
+    }
+
+    m_queued.store( 0 );
+    m_unfinished.store( 0 );
+    m_nextQueue.store( 0 );
+    m_stolen.store( 0 );
+    m_stopping = false;
+
+    for ( uint32_t index = 0; index < threads; index++ )
+    {
+        m_queues.push_back( std::make_unique<WorkQueue>() );
+    }
+    for ( uint32_t index = 0; index < threads; index++ )
+    {
+        m_workers.emplace_back( &ThreadPool::workerLoop, this, index );
+    }
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      Destructor for ThreadPool class, the tasks submitted finish
+                before the workers exit
+-----------------------------------------------------------------------------*/
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> guard( m_sleepLock );
+        m_stopping = true;
+    }
+    m_wakeUp.notify_all();
+    for ( std::thread& worker : m_workers )
+    {
+        worker.join();
+    }
+}
+
+// tasks ----------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      Submits a task, from a worker it goes on that worker's queue
+    @param      task    task to run
+    @return     void
+-----------------------------------------------------------------------------*/
+void ThreadPool::submit( Task task )
+{
+    uint32_t index;
+
+    if ( workerPool == this )
+    {
+        index = workerIndex;
+    }
+    else
+    {
+        index = m_nextQueue.fetch_add( 1, std::memory_order_relaxed ) % (uint32_t)m_queues.size();
+    }
+
+    m_unfinished.fetch_add( 1 );
+    {
+        std::lock_guard<std::mutex> guard( m_queues[index]->lock );
+        m_queues[index]->tasks.push_back( std::move( task ) );
+    }
+    m_queued.fetch_add( 1 );
+
+    // taking the lock orders this with a worker about to sleep
+    {
+        std::lock_guard<std::mutex> guard( m_sleepLock );
+    }
+    m_wakeUp.notify_one();
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      Waits until every task submitted has finished, including the
+                tasks they submit, not to be called from a task
+    @return     void
+-----------------------------------------------------------------------------*/
+void ThreadPool::wait()
+{
+    std::unique_lock<std::mutex> lock( m_sleepLock );
+    m_finished.wait( lock, [this]() { return m_unfinished.load() == 0; } );
+}
+
+// getters --------------------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      Checks if every task submitted has finished
+    @return     bool    true if there is nothing to do
+-----------------------------------------------------------------------------*/
+bool ThreadPool::isIdle() const
+{
+    return m_unfinished.load() == 0;
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      Gets the number of workers
+    @return     uint32_t    workers
+-----------------------------------------------------------------------------*/
+uint32_t ThreadPool::getThreadCount() const
+{
+    return (uint32_t)m_workers.size();
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      Gets the number of tasks a worker took from another's queue
+    @return     uint64_t    tasks stolen
+-----------------------------------------------------------------------------*/
+uint64_t ThreadPool::getStolenCount() const
+{
+    return m_stolen.load( std::memory_order_relaxed );
+}
+
+// private functions ----------------------------------------------------------
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      Runs tasks until the pool is destroyed
+    @param      index   queue of the worker
+    @return     void
+-----------------------------------------------------------------------------*/
+void ThreadPool::workerLoop( uint32_t index )
+{
+    Task task;
+
+    workerPool  = this;
+    workerIndex = index;
+    while ( true )
+    {
+        if ( takeTask( index, task ) )
+        {
+            task();
+            task = nullptr;
+            if ( m_unfinished.fetch_sub( 1 ) == 1 )
+            {
+                std::lock_guard<std::mutex> guard( m_sleepLock );
+                m_finished.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock( m_sleepLock );
+        m_wakeUp.wait( lock, [this]() { return m_stopping || m_queued.load() > 0; } );
+        if ( m_stopping && m_queued.load() == 0 )
+        {
+            return;
+        }
+    }
+}
+
+/**----------------------------------------------------------------------------
+    @ingroup    NimbleLIBUtilities Nimble Library Utilities Module
+    @brief      Takes the newest task from the worker's own queue, or else the
+                oldest task from another worker's queue
+    @param      index   queue of the worker
+    @param      task    set to the task taken
+    @return     bool    true if a task was taken
+-----------------------------------------------------------------------------*/
+bool ThreadPool::takeTask( uint32_t index, Task& task )
+{
+    uint32_t count = (uint32_t)m_queues.size();
+
+    for ( uint32_t offset = 0; offset < count; offset++ )
+    {
+        WorkQueue&                  queue = *m_queues[( index + offset ) % count];
+        std::lock_guard<std::mutex> guard( queue.lock );
+        if ( queue.tasks.empty() )
+        {
+            continue;
+        }
+        if ( offset == 0 )
+        {
+            task = std::move( queue.tasks.back() );
+            queue.tasks.pop_back();
+        }
+        else
+        {
+            task = std::move( queue.tasks.front() );
+            queue.tasks.pop_front();
+            m_stolen.fetch_add( 1, std::memory_order_relaxed );
+        }
+        m_queued.fetch_sub( 1 );
+        return true;
+    }
+    return false;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace Nimble
+
+//-----------------------------------------------------------------------------
+// End of file: ThreadPool.cpp
+// ----------------------------------------------------------------------------
@@ -8,6 +8,7 @@
 
 Notes:
 
+    crc16() is calculated by the Crc engine, please see Crc.cpp.
 
 -----------------------------------------------------------------------------*/
 
@@ -16,6 +17,7 @@ Notes:
 // ----------------------------------------------------------------------------
 
 #include "../../../inc/Modules/Utilities/Tools.h"
+#include "../../../inc/Modules/Utilities/Crc.h"
 
 //-----------------------------------------------------------------------------
 // Namespace
@@ -52,33 +54,14 @@ Tools::~Tools()
 
 /**---------------------------------------------------------------------------
     @ingroup    NimbleLIBTools Nimble Library Tools Module
-    @brief      Calculates the CRC for the data
+    @brief      Calculates the CRC for the data, CRC-16/MODBUS
     @param      pData - Pointer to the data
     @param      len - Length of the data to calculate the CRC for
     @return     uint16_t - CRC16 value
   --------------------------------------------------------------------------*/
 uint16_t Tools::crc16( uint8_t* pData, uint32_t len ) const
 {
-    uint16_t crc = CRC_START;
-    uint8_t  i;
-
-    while ( len-- )
-    {
-        crc ^= *pData++;
-        for ( i = 0; i < CRC_BITS; i++ )
-        {
-            if ( crc & CRC_MASK )
-            {
-                crc >>= CRC_SHIFT;
-                crc ^= CRC_POLY;
-            }
-            else
-            {
-                crc >>= CRC_SHIFT;
-            }
-        }
-    }
-    return crc;
+    return (uint16_t)Crc::calculate( Crc::CrcType::Crc16, pData, len );
 }
 
 //-----------------------------------------------------------------------------
@@ -0,0 +1,113 @@
+/**-----------------------------------------------------------------------------
+
+    @file       unitTests_AtomicFileWriter.h
+    @defgroup   NimbleLIB Nimble LIB
+    @brief      Unit Tests for the atomic file writer used to save documents
+
+    @copyright  Neil Beresford 2023
+
+Notes:
+
+    This file contains the unit tests for the AtomicFileWriter class in the
+    File Handling Module, in the Nimble Library
+
+    The target must be untouched until commit() and must keep its old
+    contents when a write is abandoned. A document is then loaded and saved
+    through IDEFileHandler to check the bytes come back unchanged.
+
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include "../../NimbleLIB/inc/NimbleLib.h"
+
+//-----------------------------------------------------------------------------
+// Namespace access
+//-----------------------------------------------------------------------------
+
+using namespace Nimble;
+
+//-----------------------------------------------------------------------------
+// Tests
+//-----------------------------------------------------------------------------
+TEST_CASE( "Testing the atomic file writer within the File Handling Module" )
+{
+    auto readAll = []( const std::string& fileName )
+    {
+        std::ifstream input( fileName, std::ios::binary );
+        return std::string( ( std::istreambuf_iterator<char>( input ) ), std::istreambuf_iterator<char>() );
+    };
+
+    // Commit and abort -------------------------------------------------------
+    SUBCASE( "AtomicFileWriter commit and abort" )
+    {
+        std::string fileName = "unitTests_AtomicFileWriter.txt";
+        std::string many;
+        std::ofstream( fileName, std::ios::binary ) << "old";
+
+        AtomicFileWriter writer;
+        CHECK( writer.open( fileName ) == LibraryError::No_Error ); //!< test open
+        CHECK( writer.write( "new " ) == LibraryError::No_Error );
+        CHECK( writer.write( "text" ) == LibraryError::No_Error );
+        CHECK( readAll( fileName ) == "old" );                      //!< test target untouched before commit
+        writer.abort();
+        CHECK( readAll( fileName ) == "old" );                      //!< test abort leaves the target
+        CHECK( writer.isOpen() == false );                          //!< test temporary file closed
+
+        // more spans than one gathered write takes
+        std::string digits = "0123456789";
+        CHECK( writer.open( fileName ) == LibraryError::No_Error );
+        for ( uint32_t span = 0; span < AtomicFileWriter::MAX_SPANS * 3 + 7; span++ )
+        {
+            writer.write( std::string_view( digits ).substr( span % 10, 1 ) );
+            many += digits[span % 10];
+        }
+        CHECK( writer.commit() == LibraryError::No_Error );         //!< test commit
+        CHECK( readAll( fileName ) == many );                       //!< test every span written in order
+        CHECK( writer.getBytesWritten() == many.size() );           //!< test bytes written
+        std::remove( fileName.c_str() );
+    }
+    // Save round trip --------------------------------------------------------
+    SUBCASE( "IDEFileHandler save keeps the file as loaded" )
+    {
+        std::string    fileName = "unitTests_AtomicFileWriter.src";
+        std::string    saveName = "unitTests_AtomicFileWriter.out";
+        std::string    text     = "first\r\nsecond\r\n\r\nlast\r\n";
+        IDEFileHandler handler;
+        uint32_t       firstLine;
+        uint32_t       linesAdded;
+        std::ofstream( fileName, std::ios::binary ) << text;
+
+        CHECK( handler.openFile( fileName ) == LibraryError::No_Error ); //!< test open
+        CHECK( handler.saveFile( saveName ) != LibraryError::No_Error ); //!< test no save while loading
+        while ( handler.isLoading() )
+        {
+            handler.pollLoad( IDEFileLoader::LOAD_BLOCK_SIZE, firstLine, linesAdded );
+        }
+        CHECK( handler.saveFile( saveName ) == LibraryError::No_Error ); //!< test save
+        CHECK( readAll( saveName ) == text );                            //!< test line endings and final newline kept
+        CHECK( handler.saveFile( saveName ) == LibraryError::No_Error ); //!< test file stays open after a save
+
+        std::ofstream( fileName, std::ios::binary ) << "no final newline";
+        handler.openFile( fileName );
+        while ( handler.isLoading() )
+        {
+            handler.pollLoad( IDEFileLoader::LOAD_BLOCK_SIZE, firstLine, linesAdded );
+        }
+        CHECK( handler.saveFile( saveName ) == LibraryError::No_Error );
+        CHECK( readAll( saveName ) == "no final newline" ); //!< test no newline added
+        std::remove( fileName.c_str() );
+        std::remove( saveName.c_str() );
+    }
+}
+
+// end of TEST_CASE
+//-----------------------------------------------------------------------------
+// End of File unitTests_AtomicFileWriter.h
+// ----------------------------------------------------------------------------
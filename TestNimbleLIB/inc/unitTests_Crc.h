@@ -0,0 +1,134 @@
+/**-----------------------------------------------------------------------------
+
+    @file       unitTests_Crc.h
+    @defgroup   NimbleLIB Nimble LIB
+    @brief      Unit Tests for the CRC engine
+
+    @copyright  Neil Beresford 2023
+
+Notes:
+
+    This file contains the unit tests for the Crc class in the Utilities
+    Module, in the Nimble Library
+
+    Each CRC gives the standard check value for "123456789", every method
+    gives the same CRC for any length and alignment, the CRC of data added
+    in pieces is the CRC of the whole, and Tools::crc16 is unchanged.
+
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "../../NimbleLIB/inc/NimbleLib.h"
+
+//-----------------------------------------------------------------------------
+// Namespace access
+//-----------------------------------------------------------------------------
+
+using namespace Nimble;
+
+//-----------------------------------------------------------------------------
+// Tests
+//-----------------------------------------------------------------------------
+
+TEST_CASE( "Testing the Crc class" )
+{
+    const char*          check = "123456789";
+    std::vector<uint8_t> data( 4099 );
+
+    for ( size_t index = 0; index < data.size(); index++ )
+    {
+        data[index] = (uint8_t)( index * 131 + ( index >> 7 ) );
+    }
+
+    SUBCASE( "Testing the check values" )
+    {
+        CHECK( Crc::calculate( Crc::CrcType::Crc16, check, 9 ) == 0x4B37 );
+        CHECK( Crc::calculate( Crc::CrcType::Crc32, check, 9 ) == 0xCBF43926 );
+        CHECK( Crc::calculate( Crc::CrcType::Crc32C, check, 9 ) == 0xE3069283 );
+        CHECK( Crc::calculate( Crc::CrcType::Crc32, check, 0 ) == 0x00000000 );
+        CHECK( Crc::calculate( Crc::CrcType::Crc16, check, 0 ) == 0xFFFF );
+    }
+    SUBCASE( "Testing every method gives the same CRC" )
+    {
+        for ( Crc::CrcType type : { Crc::CrcType::Crc16, Crc::CrcType::Crc32, Crc::CrcType::Crc32C } )
+        {
+            for ( size_t offset = 0; offset < 8; offset++ )
+            {
+                for ( size_t length : { (size_t)0, (size_t)1, (size_t)7, (size_t)8, (size_t)9, (size_t)63, (size_t)4000 } )
+                {
+                    Crc table( type, Crc::CrcMethod::Table );
+                    Crc slice( type, Crc::CrcMethod::Slice8 );
+                    Crc hardware( type, Crc::CrcMethod::Hardware );
+                    table.update( data.data() + offset, length );
+                    slice.update( data.data() + offset, length );
+                    hardware.update( data.data() + offset, length );
+                    CHECK( table.finalise() == slice.finalise() );
+                    CHECK( table.finalise() == hardware.finalise() );
+                }
+            }
+        }
+    }
+    SUBCASE( "Testing the methods chosen" )
+    {
+        CHECK( Crc( Crc::CrcType::Crc32, Crc::CrcMethod::Table ).getMethod() == Crc::CrcMethod::Table );
+        CHECK( Crc( Crc::CrcType::Crc32, Crc::CrcMethod::Hardware ).getMethod() == Crc::CrcMethod::Slice8 );
+        CHECK( Crc( Crc::CrcType::Crc16 ).getMethod() == Crc::CrcMethod::Slice8 );
+        CHECK( Crc( Crc::CrcType::Crc32C ).getMethod() == ( Crc::hasHardwareCrc32C() ? Crc::CrcMethod::Hardware : Crc::CrcMethod::Slice8 ) );
+    }
+    SUBCASE( "Testing streaming in pieces" )
+    {
+        Crc crc( Crc::CrcType::Crc32 );
+        for ( size_t index = 0; index < data.size(); index += 13 )
+        {
+            crc.update( data.data() + index, std::min<size_t>( 13, data.size() - index ) );
+        }
+        CHECK( crc.finalise() == Crc::calculate( Crc::CrcType::Crc32, data.data(), data.size() ) );
+        crc.reset();
+        crc.update( check, 4 );
+        uint32_t part = crc.finalise();
+        crc.update( check + 4, 5 );
+        CHECK( part == Crc::calculate( Crc::CrcType::Crc32, check, 4 ) );
+        CHECK( crc.finalise() == 0xCBF43926 );
+    }
+    SUBCASE( "Testing Tools::crc16 matches the bitwise CRC" )
+    {
+        uint16_t crc = 0xFFFF;
+        for ( uint8_t byte : data )
+        {
+            crc ^= byte;
+            for ( int bit = 0; bit < 8; bit++ )
+            {
+                crc = ( crc & 1 ) ? ( crc >> 1 ) ^ 0xA001 : crc >> 1;
+            }
+        }
+        CHECK( Tools::getInstance().crc16( data.data(), (uint32_t)data.size() ) == crc );
+    }
+    SUBCASE( "Testing the CRC of a file" )
+    {
+        std::string fileName = "unitTest_Crc.bin";
+        {
+            std::ofstream file( fileName, std::ios::binary );
+            file.write( (const char*)data.data(), (std::streamsize)data.size() );
+        }
+        Crc crc( Crc::CrcType::Crc32C );
+        CHECK( crc.updateFile( fileName ) == LibraryError::No_Error );
+        CHECK( crc.finalise() == Crc::calculate( Crc::CrcType::Crc32C, data.data(), data.size() ) );
+        std::remove( fileName.c_str() );
+        crc.reset();
+        CHECK( crc.updateFile( fileName ) != LibraryError::No_Error );
+        CHECK( crc.finalise() == Crc::calculate( Crc::CrcType::Crc32C, data.data(), 0 ) );
+    }
+}
+
+//-----------------------------------------------------------------------------
+// End of file: unitTests_Crc.h
+//-----------------------------------------------------------------------------
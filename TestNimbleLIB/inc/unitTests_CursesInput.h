@@ -0,0 +1,121 @@
+/**-----------------------------------------------------------------------------
+
+    @file       unitTests_CursesInput.h
+    @defgroup   NimbleLIB Nimble LIB
+    @brief      Unit Tests for the input pump
+
+    @copyright  Neil Beresford 2023
+
+Notes:
+
+    This file contains the unit tests for the CursesInput class, in the
+    Curses Module of the Nimble Library
+
+    Printable keys are joined into text, other keys stay in order, a
+    bracketed paste is one event even across batches, and an escape
+    sequence that is not a paste is passed on as its keys. A sequence cut
+    off by the end of a batch is held for the next, until it times out.
+
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../../NimbleLIB/inc/Modules/Curses/CursesInput.h"
+
+//-----------------------------------------------------------------------------
+// Namespace access
+//-----------------------------------------------------------------------------
+
+using namespace Nimble;
+
+//-----------------------------------------------------------------------------
+// Tests
+//-----------------------------------------------------------------------------
+TEST_CASE( "Testing the input pump within the Curses Module" )
+{
+    using EventType = CursesInput::EventType;
+    CursesInput input;
+
+    // Text runs --------------------------------------------------------------
+    SUBCASE( "CursesInput joins printable keys" )
+    {
+        auto& events = input.processKeys( { 'a', 'b', 'c', 10, 'd', 259, 259 } );
+        CHECK( events.size() == 5 );
+        CHECK( events[0].type == EventType::Text );
+        CHECK( events[0].text == "abc" ); //!< test run joined
+        CHECK( events[1].type == EventType::Key );
+        CHECK( events[1].key == 10 );
+        CHECK( events[2].text == "d" );
+        CHECK( events[3].key == 259 ); //!< test keys kept apart
+        CHECK( events[4].key == 259 );
+        CHECK( input.getKeys().size() == 7 );
+        CHECK( input.processKeys( {} ).empty() == true );
+    }
+    // Bracketed paste --------------------------------------------------------
+    SUBCASE( "CursesInput reads bracketed pastes" )
+    {
+        auto& events = input.processKeys( { 'x', 27, '[', '2', '0', '0', '~', 'a', 10, 'b', 27 } );
+        CHECK( events.size() == 1 ); //!< test paste not finished
+        CHECK( events[0].text == "x" );
+        CHECK( input.isPasting() == true );
+
+        input.processKeys( { '[', '2', '0', '1', '~', 'y' } );
+        CHECK( input.isPasting() == false );
+        CHECK( input.getEvents().size() == 2 );
+        CHECK( input.getEvents()[0].type == EventType::Paste );
+        CHECK( input.getEvents()[0].text == "a\nb" ); //!< test paste over batches
+        CHECK( input.getEvents()[1].text == "y" );
+    }
+    // Escape keys ------------------------------------------------------------
+    SUBCASE( "CursesInput passes on other escapes" )
+    {
+        input.setEscapeTimeout( 0 ); //!< nothing is held for the next batch
+        auto& events = input.processKeys( { 27 } );
+        CHECK( events.size() == 1 );
+        CHECK( events[0].key == 27 ); //!< test escape key alone
+
+        input.processKeys( { 27, '[', 'A', 27, 27, '[', '2' } );
+        CHECK( input.getEvents().size() == 5 );
+        CHECK( input.getEvents()[0].key == 27 );
+        CHECK( input.getEvents()[1].text == "[A" ); //!< test sequence passed on
+        CHECK( input.getEvents()[2].key == 27 );
+        CHECK( input.getEvents()[3].key == 27 );
+        CHECK( input.getEvents()[4].text == "[2" ); //!< test unfinished sequence passed on
+        CHECK( input.isPasting() == false );
+    }
+    // Escapes over batches ---------------------------------------------------
+    SUBCASE( "CursesInput holds escapes cut off by the batch" )
+    {
+        input.setEscapeTimeout( 10000 );
+        CHECK( input.processKeys( { 'x', 27, '[', '2' } ).size() == 1 ); //!< test the start of a bracket is held
+        CHECK( input.hasPendingEscape() == true );
+        input.processKeys( { '0', '0', '~', 'a', 27, '[', '2', '0', '1', '~' } );
+        CHECK( input.getEvents().size() == 1 );
+        CHECK( input.getEvents()[0].type == EventType::Paste );
+        CHECK( input.getEvents()[0].text == "a" ); //!< test a bracket over two batches
+        CHECK( input.hasPendingEscape() == false );
+
+        CHECK( input.processKeys( { 27 } ).empty() == true ); //!< test an escape at the end is held
+        CHECK( input.processKeys( { 'A' } ).size() == 2 );    //!< test it is passed on with the next key
+        CHECK( input.getEvents()[0].key == 27 );
+        CHECK( input.getEvents()[1].text == "A" );
+
+        input.setEscapeTimeout( 20 );
+        CHECK( input.processKeys( { 27 } ).empty() == true );
+        std::this_thread::sleep_for( std::chrono::milliseconds( 30 ) );
+        CHECK( input.processKeys( {} ).size() == 1 ); //!< test it is passed on once the wait is over
+        CHECK( input.getEvents()[0].key == 27 );
+        CHECK( input.hasPendingEscape() == false );
+    }
+}
+
+// end of TEST_CASE
+//-----------------------------------------------------------------------------
+// End of File unitTests_CursesInput.h
+// ----------------------------------------------------------------------------
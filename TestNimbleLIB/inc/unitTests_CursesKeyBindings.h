@@ -0,0 +1,123 @@
+/**-----------------------------------------------------------------------------
+
+    @file       unitTests_CursesKeyBindings.h
+    @defgroup   NimbleLIB Nimble LIB
+    @brief      Unit Tests for the compiled key bindings
+
+    @copyright  Neil Beresford 2023
+
+Notes:
+
+    This file contains the unit tests for the CursesKeyBindings class and
+    the key maps of CursesKeyboard, in the Curses Module of the Nimble
+    Library
+
+    A key calls only the first binding for it, chords complete, break and
+    time out, and a large table still finds every binding.
+
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include <string>
+#include <vector>
+#include "../../NimbleLIB/inc/Modules/Curses/CursesKeyboard.h"
+
+//-----------------------------------------------------------------------------
+// Namespace access
+//-----------------------------------------------------------------------------
+
+using namespace Nimble;
+
+//-----------------------------------------------------------------------------
+// Tests
+//-----------------------------------------------------------------------------
+TEST_CASE( "Testing the key bindings within the Curses Module" )
+{
+    using KeyResult = CursesKeyBindings::KeyResult;
+    std::string calls;
+    auto        record = [ &calls ]( const char* name ) { return [ &calls, name ]( uint32_t key ) { calls += std::string( name ) + std::to_string( key ) + " "; }; };
+
+    // Bindings ---------------------------------------------------------------
+    SUBCASE( "CursesKeyBindings keys and chords" )
+    {
+        CursesKeyBindings bindings;
+        CHECK( bindings.addBinding( { 'a' }, record( "a" ) ) == true );
+        CHECK( bindings.addBinding( { 'a' }, record( "second" ) ) == false ); //!< test first binding kept
+        CHECK( bindings.addBinding( {}, record( "empty" ) ) == false );
+        CHECK( bindings.addBinding( { 11, 3 }, record( "chord" ) ) == true );
+        CHECK( bindings.addBinding( { 24 }, record( "x" ) ) == true );
+        CHECK( bindings.addBinding( { 24, 19 }, record( "xs" ) ) == true );
+        CHECK( bindings.getBindingCount() == 4 );
+
+        CHECK( bindings.dispatch( 'a', 0 ) == KeyResult::Handled );
+        CHECK( bindings.dispatch( 'b', 0 ) == KeyResult::Unbound );
+        CHECK( bindings.dispatch( 11, 100 ) == KeyResult::Pending ); //!< test chord held
+        CHECK( bindings.isPending() == true );
+        CHECK( bindings.dispatch( 3, 200 ) == KeyResult::Handled ); //!< test chord completed
+        CHECK( bindings.isPending() == false );
+        CHECK( calls == "a97 chord3 " );
+
+        // broken and timed out chords
+        calls.clear();
+        CHECK( bindings.dispatch( 11, 300 ) == KeyResult::Pending );
+        CHECK( bindings.dispatch( 'a', 400 ) == KeyResult::Handled ); //!< test broken chord, key used alone
+        CHECK( bindings.dispatch( 11, 500 ) == KeyResult::Pending );
+        CHECK( bindings.dispatch( 3, 500 + CursesKeyBindings::CHORD_TIMEOUT_MS ) == KeyResult::Unbound ); //!< test timed out
+        CHECK( bindings.dispatch( 24, 3000 ) == KeyResult::Pending );
+        CHECK( bindings.processTimeout( 3500 ) == false );
+        CHECK( bindings.processTimeout( 4000 ) == true ); //!< test prefix binding called on timeout
+        CHECK( bindings.dispatch( 24, 5000 ) == KeyResult::Pending );
+        CHECK( bindings.dispatch( 19, 5001 ) == KeyResult::Handled );
+        CHECK( calls == "a97 x24 xs19 " );
+
+        // a large table finds every binding
+        uint32_t found = 0;
+        bindings.clear();
+        for ( uint32_t key = 1000; key < 21000; key++ )
+        {
+            bindings.addBinding( { key }, [ &found ]( uint32_t ) { found++; } );
+        }
+        for ( uint32_t key = 1000; key < 21000; key++ )
+        {
+            bindings.dispatch( key, 0 );
+        }
+        CHECK( found == 20000 );
+        CHECK( bindings.dispatch( 'a', 0 ) == KeyResult::Unbound ); //!< test cleared
+    }
+    // Keyboard ---------------------------------------------------------------
+    SUBCASE( "CursesKeyboard key maps" )
+    {
+        CursesKeyboard keyboard;
+        keyboard.addKeyMap( "first", { 'q', 'Q' }, record( "first" ) );
+        keyboard.addKeyMap( "second", { 'q', 'w' }, record( "second" ) );
+        keyboard.addChord( "chord", { 11, 'w' }, record( "chord" ) );
+
+        keyboard.setKey( 'q' );
+        keyboard.processKeyMaps();
+        CHECK( calls == "first113 " ); //!< test only the first map called
+        CHECK( keyboard.getKey() == 0 );
+        CHECK( keyboard.getLastKey() == 'q' );
+        keyboard.setKey( 'z' );
+        keyboard.processKeyMaps();
+        CHECK( keyboard.getKey() == 'z' ); //!< test unbound key left
+        keyboard.setKey( 11 );
+        keyboard.processKeyMaps();
+        CHECK( keyboard.isChordPending() == true );
+        keyboard.setKey( 'w' );
+        keyboard.processKeyMaps();
+        CHECK( calls == "first113 chord119 " );
+
+        keyboard.clearKeyMaps();
+        keyboard.setKey( 'q' );
+        keyboard.processKeyMaps();
+        CHECK( keyboard.getKey() == 'q' ); //!< test table compiled again
+    }
+}
+
+// end of TEST_CASE
+//-----------------------------------------------------------------------------
+// End of File unitTests_CursesKeyBindings.h
+// ----------------------------------------------------------------------------
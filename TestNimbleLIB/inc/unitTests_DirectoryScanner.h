@@ -0,0 +1,127 @@
+/**-----------------------------------------------------------------------------
+
+    @file       unitTests_DirectoryScanner.h
+    @defgroup   NimbleLIB Nimble LIB
+    @brief      Unit Tests for the background directory scanner
+
+    @copyright  Neil Beresford 2023
+
+Notes:
+
+    This file contains the unit tests for the DirectoryScanner class in the
+    File Handling Module, in the Nimble Library
+
+    A directory is read whole with its directories marked, a listing read
+    before is cached and given back at once, a change to the directory
+    drops the listing, and a directory that cannot be read is reported.
+
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../../NimbleLIB/inc/Modules/FileHandling/DirectoryScanner.h"
+
+//-----------------------------------------------------------------------------
+// Namespace access
+//-----------------------------------------------------------------------------
+
+using namespace Nimble;
+
+//-----------------------------------------------------------------------------
+// Local functions
+//-----------------------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @brief      reads a directory with the scanner, polling until it is done
+    @param      path        directory
+    @return     std::vector<DirectoryEntry>     entries, sorted by name
+------------------------------------------------------------------------------*/
+static std::vector<DirectoryEntry> scanDirectory( const std::string& path )
+{
+    std::vector<DirectoryEntry> entries;
+    DirectoryScanner&           scanner = DirectoryScanner::getInstance();
+
+    scanner.scan( path );
+    for ( uint32_t wait = 0; wait < 5000; wait++ )
+    {
+        scanner.poll( entries );
+        if ( scanner.isScanning() == false )
+        {
+            break;
+        }
+        std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+    }
+    std::sort( entries.begin(), entries.end(), []( const DirectoryEntry& a, const DirectoryEntry& b ) { return a.name < b.name; } );
+    return entries;
+}
+
+//-----------------------------------------------------------------------------
+// Tests
+//-----------------------------------------------------------------------------
+TEST_CASE( "Testing the directory scanner within the File Handling Module" )
+{
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "unitTest_DirectoryScanner";
+    std::filesystem::remove_all( directory );
+    std::filesystem::create_directories( directory / "subDirectory" );
+    for ( uint32_t file = 0; file < 1000; file++ )
+    {
+        std::ofstream( directory / ( "file" + std::to_string( 1000 + file ) + ".txt" ) ) << file;
+    }
+    DirectoryScanner::getInstance().clearCache();
+
+    SUBCASE( "Testing a directory is read whole" )
+    {
+        std::vector<DirectoryEntry> entries = scanDirectory( directory.string() );
+        CHECK( DirectoryScanner::getInstance().hasFailed() == false );
+        CHECK( entries.size() == 1001 );
+        CHECK( entries[0].name == "file1000.txt" );
+        CHECK( entries[0].directory == false );
+        CHECK( entries.back().name == "subDirectory" );
+        CHECK( entries.back().directory == true );
+    }
+    SUBCASE( "Testing a listing is cached until the directory changes" )
+    {
+        CHECK( DirectoryScanner::getInstance().isCached( directory.string() ) == false );
+        scanDirectory( directory.string() );
+        CHECK( DirectoryScanner::getInstance().isCached( directory.string() ) == true );
+        CHECK( DirectoryScanner::getInstance().isCached( directory.string() + "/" ) == true );
+
+        // the cached listing is given by the first poll
+        std::vector<DirectoryEntry> entries;
+        DirectoryScanner::getInstance().scan( directory.string() );
+        CHECK( DirectoryScanner::getInstance().poll( entries ) == true );
+        CHECK( DirectoryScanner::getInstance().isScanning() == false );
+        CHECK( entries.size() == 1001 );
+
+        // write times are only to the second on some file systems
+        std::this_thread::sleep_for( std::chrono::milliseconds( 1100 ) );
+        std::ofstream( directory / "added.txt" ) << "added";
+        CHECK( DirectoryScanner::getInstance().isCached( directory.string() ) == false );
+        entries = scanDirectory( directory.string() );
+        CHECK( entries.size() == 1002 );
+        CHECK( entries[0].name == "added.txt" );
+    }
+    SUBCASE( "Testing a directory that cannot be read" )
+    {
+        std::vector<DirectoryEntry> entries = scanDirectory( ( directory / "missing" ).string() );
+        CHECK( entries.empty() );
+        CHECK( DirectoryScanner::getInstance().hasFailed() == true );
+        CHECK( DirectoryScanner::getInstance().isCached( ( directory / "missing" ).string() ) == false );
+    }
+
+    DirectoryScanner::getInstance().clearCache();
+    std::filesystem::remove_all( directory );
+}
+
+//-----------------------------------------------------------------------------
+// End of file: unitTests_DirectoryScanner.h
+//-----------------------------------------------------------------------------
@@ -81,6 +81,76 @@ TEST_CASE( "Testing the Error Handler Module" )
         CHECK( errorStatus.numStatus == 1 );
         ErrorHandler::getInstance().clearErrors();
     }
+    // Test a burst of the same error is kept once but counted every time
+    SUBCASE( "Testing Error Handler repeated errors" )
+    {
+        ErrorHandler::getInstance().clearErrors();
+        for ( int count = 0; count < 1000; count++ )
+        {
+            ErrorHandler::getInstance().handleError( ErrorType::Warning, LibraryError::Logger_QueueFull, "Test Repeat" );
+        }
+        ErrorHandler::getInstance().handleError( ErrorType::Error, LibraryError::Logger_InitializeNotCalled, "Test Error" );
+        std::vector<ErrorInformation> errors = ErrorHandler::getInstance().getRecentErrors();
+        CHECK( errors.size() == 2 );
+        CHECK( errors[0].repeats == 1000 );
+        CHECK( errors[1].repeats == 1 );
+        CHECK( errors[1].number == LibraryError::Logger_InitializeNotCalled );
+        ErrorStatus errorStatus = ErrorHandler::getInstance().getStatusInformation();
+        CHECK( errorStatus.totalErrors == 1001 );
+        CHECK( errorStatus.numWarnings == 1000 );
+        ErrorHandler::getInstance().clearErrors();
+    }
+    // Test the repeats of the last error are logged with no error after it
+    SUBCASE( "Testing Error Handler reports trailing repeats" )
+    {
+        ErrorHandler::getInstance().clearErrors();
+        CHECK( ErrorHandler::getInstance().reportRepeats() == 0 );
+        for ( int count = 0; count < 5; count++ )
+        {
+            ErrorHandler::getInstance().handleError( ErrorType::Warning, LibraryError::Logger_QueueFull, "Test Trailing Repeat" );
+        }
+        CHECK( ErrorHandler::getInstance().reportRepeats() == 4 ); //!< test the repeats are logged
+        CHECK( ErrorHandler::getInstance().reportRepeats() == 0 ); //!< test they are logged once
+        ErrorHandler::getInstance().handleError( ErrorType::Warning, LibraryError::Logger_QueueFull, "Test Trailing Repeat" );
+        ErrorHandler::getInstance().handleError( ErrorType::Warning, LibraryError::Logger_QueueFull, "Test Trailing Repeat" );
+        ErrorHandler::getInstance().flush();                       //!< flush logs the repeats since
+        CHECK( ErrorHandler::getInstance().reportRepeats() == 0 );
+        CHECK( ErrorHandler::getInstance().getRecentErrors().back().repeats == 7 );
+        ErrorHandler::getInstance().clearErrors();
+    }
+    // Test only the most recent errors are kept
+    SUBCASE( "Testing Error Handler recent errors are bounded" )
+    {
+        ErrorHandler::getInstance().clearErrors();
+        for ( uint32_t count = 0; count < ErrorHandler::RECENT_ERRORS + 10; count++ )
+        {
+            ErrorHandler::getInstance().handleError( ErrorType::Status, LibraryError::Logger_InitializeNotCalled, "Test Status " + std::to_string( count ) );
+        }
+        std::vector<ErrorInformation> errors = ErrorHandler::getInstance().getRecentErrors();
+        CHECK( errors.size() == ErrorHandler::RECENT_ERRORS );
+        CHECK( errors.front().message == "Test Status 10" );
+        CHECK( errors.back().message == "Test Status " + std::to_string( ErrorHandler::RECENT_ERRORS + 9 ) );
+        CHECK( ErrorHandler::getInstance().getErrorCount( LibraryError::Logger_InitializeNotCalled ) == ErrorHandler::RECENT_ERRORS + 10 );
+        ErrorHandler::getInstance().clearErrors();
+    }
+    // Test the count and times of each error code
+    SUBCASE( "Testing Error Handler error code counts" )
+    {
+        std::time_t first = 0;
+        std::time_t last  = 0;
+        ErrorHandler::getInstance().clearErrors();
+        CHECK( ErrorHandler::getInstance().getErrorCount( LibraryError::Logger_FailedToOpenFile ) == 0 );
+        CHECK( ErrorHandler::getInstance().getErrorTimes( LibraryError::Logger_FailedToOpenFile, first, last ) == false );
+        ErrorHandler::getInstance().handleError( ErrorType::Error, LibraryError::Logger_FailedToOpenFile, "Test Error 1" );
+        ErrorHandler::getInstance().handleError( ErrorType::Error, LibraryError::Logger_QueueFull, "Test Error 2" );
+        ErrorHandler::getInstance().handleError( ErrorType::Error, LibraryError::Logger_FailedToOpenFile, "Test Error 3" );
+        CHECK( ErrorHandler::getInstance().getErrorCount( LibraryError::Logger_FailedToOpenFile ) == 2 );
+        CHECK( ErrorHandler::getInstance().getErrorCount( LibraryError::Logger_QueueFull ) == 1 );
+        CHECK( ErrorHandler::getInstance().getErrorTimes( LibraryError::Logger_FailedToOpenFile, first, last ) == true );
+        CHECK( first != 0 );
+        CHECK( first <= last );
+        ErrorHandler::getInstance().clearErrors();
+    }
 }
 
 //-----------------------------------------------------------------------------
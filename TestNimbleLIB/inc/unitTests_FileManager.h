@@ -0,0 +1,126 @@
+/**-----------------------------------------------------------------------------
+
+    @file       unitTests_FileManager.h
+    @defgroup   NimbleLIB Nimble LIB
+    @brief      Unit Tests for the file manager holding the open buffers
+
+    @copyright  Neil Beresford 2023
+
+Notes:
+
+    This file contains the unit tests for the FileManager class in the File
+    Handling Module, in the Nimble Library
+
+    Buffers are stored and restored without being read again, compressed
+    and then dropped oldest first once over the memory budget, and a
+    buffer with edits is never dropped. The Compressor used to pack them
+    must give back exactly the bytes it was given.
+
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include "../../NimbleLIB/inc/NimbleLib.h"
+
+//-----------------------------------------------------------------------------
+// Namespace access
+//-----------------------------------------------------------------------------
+
+using namespace Nimble;
+
+//-----------------------------------------------------------------------------
+// Tests
+//-----------------------------------------------------------------------------
+TEST_CASE( "Testing the file manager within the File Handling Module" )
+{
+    // Compressor -------------------------------------------------------------
+    SUBCASE( "Compressor round trip" )
+    {
+        std::string text;
+        std::string packed;
+        std::string unpacked;
+        for ( uint32_t line = 0; line < 2000; line++ )
+        {
+            text += "    value" + std::to_string( line % 37 ) + " = value" + std::to_string( line ) + ";\n";
+        }
+
+        Compressor::compress( text, packed );
+        CHECK( packed.size() < text.size() / 2 );                      //!< test text packs
+        CHECK( Compressor::getOriginalSize( packed ) == text.size() ); //!< test size header
+        CHECK( Compressor::decompress( packed, unpacked ) == true );   //!< test unpack
+        CHECK( unpacked == text );                                     //!< test bytes unchanged
+        Compressor::compress( "", packed );
+        CHECK( Compressor::decompress( packed, unpacked ) == true ); //!< test empty input
+        CHECK( unpacked.empty() );
+        packed.resize( packed.size() - 1 );
+        CHECK( Compressor::decompress( packed, unpacked ) == false ); //!< test truncated input refused
+    }
+    // Buffers ----------------------------------------------------------------
+    SUBCASE( "FileManager store, compress and drop" )
+    {
+        std::string                 names[3] = { "unitTests_FileManager0.txt", "unitTests_FileManager1.txt", "unitTests_FileManager2.txt" };
+        FileManager                 files;
+        IDEPieceTable               document;
+        IDEUndoJournal              journal;
+        IDEUndoJournal::CursorState cursor;
+        bool                        modified = false;
+        uint32_t                    ids[3];
+        for ( uint32_t file = 0; file < 3; file++ )
+        {
+            std::ofstream( names[file], std::ios::binary ) << "file " << file << "\nsecond line\n";
+            ids[file] = files.openFile( names[file] );
+        }
+
+        CHECK( files.openFile( "unitTests_FileManager.none" ) == FileManager::NO_FILE ); //!< test missing file
+        CHECK( files.openFile( names[1] ) == ids[1] );                                   //!< test already open
+        CHECK( files.getFileCount() == 3 );
+        CHECK( files.getNextFileID( ids[2], true ) == ids[0] ); //!< test cycling wraps
+        CHECK( files.getNextFileID( ids[0], false ) == ids[2] );
+        CHECK( files.restoreBuffer( ids[0], document, journal, cursor, modified ) == false ); //!< test first read is from disk
+
+        // an edited buffer, stored then restored as it was
+        cursor = { 3, 0, 1, 2 };
+        document.load( "file 0\r\nsecond line\r\n" );
+        document.insertAt( 0, "edited " );
+        journal.recordInsert( 0, "edited ", cursor );
+        CHECK( files.storeBuffer( ids[0], document, journal, cursor, true ) == LibraryError::No_Error );
+        CHECK( document.getLength() == 0 ); //!< test buffer moved out
+        CHECK( files.getFileState( ids[0] ) == READ );
+        CHECK( files.restoreBuffer( ids[0], document, journal, cursor, modified ) ); //!< test restored without a read
+        CHECK( document.getText() == "edited file 0\r\nsecond line\r" );
+        CHECK( modified == true );
+        CHECK( journal.canUndo() == true ); //!< test journal kept
+        CHECK( cursor.cursorY == 2 );
+
+        // over budget, packed first then only the unedited buffer dropped
+        files.storeBuffer( ids[0], document, journal, cursor, true );
+        document.load( "file 1\nsecond line\n" );
+        files.storeBuffer( ids[1], document, journal, cursor, false );
+        files.setMemoryBudget( 0 );
+        CHECK( files.getFileState( ids[0] ) == COMPRESSED ); //!< test edited buffer kept packed
+        CHECK( files.getFileState( ids[1] ) == DROPPED );    //!< test unedited buffer dropped
+        CHECK( files.restoreBuffer( ids[0], document, journal, cursor, modified ) );
+        CHECK( document.getText() == "edited file 0\r\nsecond line\r" ); //!< test unpacked text
+        CHECK( document.hasTrailingNewline() == true );
+        CHECK( document.usesCrlf() == true );
+        CHECK( files.restoreBuffer( ids[1], document, journal, cursor, modified ) == false ); //!< test dropped buffer read again
+
+        CHECK( files.closeFile( ids[1] ) == true );
+        CHECK( files.getFileCount() == 2 );
+        CHECK( files.getNextFileID( ids[0], true ) == ids[2] ); //!< test closed file skipped
+        for ( uint32_t file = 0; file < 3; file++ )
+        {
+            std::remove( names[file].c_str() );
+        }
+    }
+}
+
+// end of TEST_CASE
+//-----------------------------------------------------------------------------
+// End of File unitTests_FileManager.h
+// ----------------------------------------------------------------------------
@@ -17,6 +17,8 @@ Notes:
     against the expected values.
 
     Editing of  the IDEEditline is also tested.
+    The cost of editing a long line is checked through getBytesMoved(),
+    edits at the cursor must not move the rest of the line.
 
 -----------------------------------------------------------------------------*/
 
@@ -92,6 +94,51 @@ TEST_CASE( "Testing the IDE Edit functionality within the IDE Module" )
         CHECK( editline.deleteChars( 2 ) == LibraryError::No_Error );         //!< test delete chars
         CHECK( editline.getLineString() == "atest string" );                  //!< test get line string
     }
+    // Editline gap buffer, cost of editing a long line ------------------------
+    SUBCASE( "IDEEditline gap buffer editing cost" )
+    {
+        // Test that edits at the cursor do not move the rest of the line,
+        // with an insert per key each key would move 10000 bytes
+        std::string testString( 20000, 'x' );
+        std::string pasteString( 20000, 'b' );
+        IDEEditline editline;
+
+        CHECK( editline.init( testString, 1, 2 ) == LibraryError::No_Error );                     //!< test the init function, long line
+        CHECK( editline.setParams( 10000, COLOR_WHITE, COLOR_BLACK ) == LibraryError::No_Error ); //!< cursor in the middle of the line
+        for ( uint32_t key = 0; key < 20000; key++ )
+        {
+            editline.addChar( 'a' ); //!< type at the cursor
+        }
+        CHECK( editline.getLineLength() == 40000 );                                                                             //!< test the line length
+        CHECK( editline.getLineCursor() == 30000 );                                                                             //!< test the cursor followed the typing
+        CHECK( editline.getBytesMoved() <= 20000 );                                                                             //!< test one gap move plus one growth, not one move per key
+        CHECK( editline.getLineString() == std::string( 10000, 'x' ) + std::string( 20000, 'a' ) + std::string( 10000, 'x' ) ); //!< test get line string
+        CHECK( editline.getLineBufferChar( 9999 ) == 'x' );                                                                     //!< test get buffer char before the gap
+        CHECK( editline.getLineBufferChar( 10000 ) == 'a' );                                                                    //!< test get buffer char at the start of the typing
+        CHECK( editline.getLineBufferChar( 30000 ) == 'x' );                                                                    //!< test get buffer char after the gap
+
+        uint64_t moved = editline.getBytesMoved();
+        for ( uint32_t key = 0; key < 1000; key++ )
+        {
+            editline.moveCursorHome(); //!< cursor moves alone
+            editline.moveCursorEnd();  //!< do not move the gap
+        }
+        CHECK( editline.getBytesMoved() == moved ); //!< test cursor moves cost nothing
+        editline.setLineCursor( 30000 );            //!< back to the end of the typing
+        for ( uint32_t key = 0; key < 10000; key++ )
+        {
+            editline.deleteChar(); //!< backspace at the cursor
+        }
+        CHECK( editline.getBytesMoved() == moved );                                                                             //!< test backspace at the gap moves nothing
+        CHECK( editline.getLineString() == std::string( 10000, 'x' ) + std::string( 10000, 'a' ) + std::string( 10000, 'x' ) ); //!< test get line string
+
+        moved = editline.getBytesMoved();
+        CHECK( editline.addString( pasteString ) == LibraryError::No_Error ); //!< paste into the middle of the line
+        CHECK( editline.getBytesMoved() - moved <= 10000 );                   //!< test the paste moves the tail at most once
+        CHECK( editline.getLineLength() == 50000 );                           //!< test the line length
+        CHECK( editline.getLineBufferChar( 20000 ) == 'b' );                  //!< test get buffer char in the paste
+        CHECK( editline.getLineBufferChar( 40000 ) == 'x' );                  //!< test get buffer char after the paste
+    }
     // check the user flags ----------------------------------------------------
     SUBCASE( "IDEEditline check user flags" )
     {
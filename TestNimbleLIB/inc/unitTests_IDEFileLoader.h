@@ -0,0 +1,116 @@
+/**-----------------------------------------------------------------------------
+
+    @file       unitTests_IDEFileLoader.h
+    @defgroup   NimbleLIB Nimble LIB
+    @brief      Unit Tests for the IDE background file loader
+
+    @copyright  Neil Beresford 2023
+
+Notes:
+
+    This file contains the unit tests for the IDEFileLoader class in the IDE
+    Module, and the SPSCQueue it passes the lines through, in the Nimble
+    Library
+
+    Files larger than one read block are loaded a poll at a time and the
+    document compared with the file.
+
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include "../../NimbleLIB/inc/NimbleLib.h"
+
+//-----------------------------------------------------------------------------
+// Namespace access
+//-----------------------------------------------------------------------------
+
+using namespace Nimble;
+
+//-----------------------------------------------------------------------------
+// Tests
+//-----------------------------------------------------------------------------
+TEST_CASE( "Testing the background file loader within the IDE Module" )
+{
+    // Queue --------------------------------------------------------------------
+    SUBCASE( "SPSCQueue push and pop" )
+    {
+        SPSCQueue<std::string> queue( 3 );
+        std::string            item;
+
+        CHECK( queue.getCapacity() == 4 );                 //!< test rounded up to a power of 2
+        CHECK( queue.pop( item ) == false );               //!< test empty
+        for ( uint32_t count = 0; count < 4; count++ )
+        {
+            CHECK( queue.push( std::to_string( count ) ) ); //!< test filling the queue
+        }
+        CHECK( queue.push( "full" ) == false );            //!< test full
+        CHECK( queue.pop( item ) == true );
+        CHECK( item == "0" );                              //!< test oldest first
+        CHECK( queue.push( "4" ) == true );                //!< test slot reused
+        while ( queue.pop( item ) )
+        {
+        }
+        CHECK( item == "4" );                              //!< test newest last
+        CHECK( queue.isEmpty() );                          //!< test drained
+    }
+    // Loading ------------------------------------------------------------------
+    SUBCASE( "IDEFileLoader loading a file" )
+    {
+        std::string   filename = ( std::filesystem::temp_directory_path() / "nimble_loader_test.txt" ).string();
+        std::string   text;
+        IDEPieceTable document;
+        IDEFileLoader loader;
+        uint32_t      firstLine;
+        uint32_t      linesAdded;
+        uint32_t      totalAdded = 0;
+
+        for ( uint32_t line = 0; line < 200000; line++ )
+        {
+            text += "line " + std::to_string( line ) + " of the file being loaded\n";
+        }
+        text += "last line";
+        std::ofstream( filename, std::ios::binary ) << text;
+
+        CHECK( loader.open( filename ) == LibraryError::No_Error );
+        CHECK( loader.isLoading() );                                 //!< test load started
+        while ( loader.isLoading() )
+        {
+            if ( loader.poll( document, IDEFileLoader::LOAD_BLOCK_SIZE, firstLine, linesAdded ) )
+            {
+                CHECK( firstLine + 1 == document.getLineCount() - linesAdded ); //!< test lines added at the end
+                totalAdded += linesAdded;
+            }
+        }
+        CHECK( document.getLineCount() == 200001 );                  //!< test every line loaded
+        CHECK( totalAdded == 200000 );                               //!< test lines added reported
+        CHECK( document.getText() == text );                         //!< test text matches the file
+        CHECK( document.hasTrailingNewline() == false );             //!< test no final line feed
+        CHECK( loader.getProgress() == 100 );                        //!< test progress complete
+
+        text = "one\ntwo\n";
+        std::ofstream( filename, std::ios::binary ) << text;
+        CHECK( loader.open( filename ) == LibraryError::No_Error );
+        document.clear();
+        while ( loader.isLoading() )
+        {
+            loader.poll( document, IDEFileLoader::LOAD_BLOCK_SIZE, firstLine, linesAdded );
+        }
+        CHECK( document.getLineCount() == 2 );                       //!< test final line feed ends a line
+        CHECK( document.hasTrailingNewline() == true );              //!< test final line feed kept
+
+        std::remove( filename.c_str() );
+        CHECK( loader.open( filename ) != LibraryError::No_Error );  //!< test missing file
+    }
+}
+
+// end of TEST_CASE
+//-----------------------------------------------------------------------------
+// End of File unitTests_IDEFileLoader.h
+// ----------------------------------------------------------------------------
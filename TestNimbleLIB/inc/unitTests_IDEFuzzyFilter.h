@@ -0,0 +1,157 @@
+/**-----------------------------------------------------------------------------
+
+    @file       unitTests_IDEFuzzyFilter.h
+    @defgroup   NimbleLIB Nimble LIB
+    @brief      Unit Tests for the IDE fuzzy filter
+
+    @copyright  Neil Beresford 2023
+
+Notes:
+
+    This file contains the unit tests for the IDEFuzzyFilter class in the IDE
+    Module, in the Nimble Library
+
+    A query typed a character at a time narrows the last matches, these are
+    checked against the same query filtered from scratch. A list long
+    enough to be scored on the pool is checked against one thread, as a
+    query is typed and taken off again.
+
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include "../../NimbleLIB/inc/NimbleLib.h"
+
+//-----------------------------------------------------------------------------
+// Namespace access
+//-----------------------------------------------------------------------------
+
+using namespace Nimble;
+
+//-----------------------------------------------------------------------------
+// Tests
+//-----------------------------------------------------------------------------
+TEST_CASE( "Testing the IDE fuzzy filter within the IDE Module" )
+{
+    // Matching -----------------------------------------------------------------
+    SUBCASE( "IDEFuzzyFilter matching and ranking" )
+    {
+        IDEFuzzyFilter filter;
+        filter.addItem( "readme.txt" );
+        filter.addItem( "IDEFileDialog.cpp" );
+        filter.addItem( "find_dialog.h" );
+        filter.addItem( "fd.h" );
+
+        CHECK( filter.getItemCount() == 4 );
+        CHECK( filter.filter( "" ).size() == 4 );                             //!< test empty query matches all
+        CHECK( filter.filter( "" )[ 0 ].item == 0 );                          //!< test empty query keeps the order
+        std::vector<uint32_t> ranked;
+        std::vector<uint32_t> expected = { 3, 2, 1 };
+        for ( const auto& match : filter.filter( "FD" ) )
+        {
+            ranked.push_back( match.item );
+        }
+        CHECK( ranked == expected );                                           //!< test start and word boundary rank above a gap
+        CHECK( filter.getMatches()[ 0 ].score > filter.getMatches()[ 1 ].score );
+        CHECK( filter.filter( "hf" ).empty() );                               //!< test characters out of order
+        CHECK( filter.filter( "xyz" ).empty() );                              //!< test characters not held
+    }
+    // Narrowing ----------------------------------------------------------------
+    SUBCASE( "IDEFuzzyFilter narrowing as a query is typed" )
+    {
+        IDEFuzzyFilter           typed;
+        IDEFuzzyFilter           fresh;
+        std::vector<std::string> names;
+        for ( uint32_t index = 0; index < 2000; index++ )
+        {
+            names.push_back( "src/module" + std::to_string( index % 37 ) + "/File_" + std::to_string( index ) + ( ( index & 1 ) ? ".cpp" : ".h" ) );
+            typed.addItem( names.back() );
+        }
+
+        std::string query = "mod1/f1cp";
+        bool        same  = true;
+        for ( size_t length = 1; length <= query.size(); length++ )
+        {
+            const auto& narrowed = typed.filter( query.substr( 0, length ) );
+            fresh.clear();
+            for ( const auto& name : names )
+            {
+                fresh.addItem( name );
+            }
+            const auto& scanned = fresh.filter( query.substr( 0, length ) );
+            same = same && narrowed.size() == scanned.size();
+            for ( size_t index = 0; same && index < narrowed.size(); index++ )
+            {
+                same = narrowed[ index ].item == scanned[ index ].item && narrowed[ index ].score == scanned[ index ].score;
+            }
+        }
+        CHECK( same );                                                        //!< test narrowing matches a full scan
+        CHECK( typed.filter( "mod1/f" ).size() > typed.filter( "mod1/f1cp" ).size() ); //!< test backspace widens again
+    }
+    // Speed --------------------------------------------------------------------
+    SUBCASE( "IDEFuzzyFilter filtering a large directory" )
+    {
+        IDEFuzzyFilter filter;
+        for ( uint32_t index = 0; index < 100000; index++ )
+        {
+            filter.addItem( "file_" + std::to_string( index ) + ".txt" );
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        filter.filter( "f" );
+        filter.filter( "f1" );
+        filter.filter( "f12" );
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::steady_clock::now() - start ).count();
+
+        CHECK( filter.getMatches().size() > 0 );
+        CHECK( elapsed < 1000 );                                              //!< test generous bound, debug builds included
+    }
+    // Pool ---------------------------------------------------------------------
+    SUBCASE( "IDEFuzzyFilter scoring a project on the pool" )
+    {
+        IDEFuzzyFilter pooled;
+        IDEFuzzyFilter single;
+        single.setParallelThreshold( 0xFFFFFFFF );
+        for ( uint32_t index = 0; index < IDEFuzzyFilter::PARALLEL_THRESHOLD + 20000; index++ )
+        {
+            std::string name = "src/module" + std::to_string( index % 97 ) + "/File_" + std::to_string( index ) + ( ( index & 1 ) ? ".cpp" : ".h" );
+            if ( index % 1000 == 0 )
+            {
+                name = "src/generated/" + std::string( 80, 'x' ) + "/File_" + std::to_string( index ) + ".cpp"; //!< names scored without SSE2
+            }
+            pooled.addItem( name );
+            single.addItem( name );
+        }
+
+        // typed, taken off with backspace, then a query that does not add to the last
+        std::vector<std::string> queries = { "m", "mod", "mod1f", "mod1fil12", "mod1fil12c", "mod1f", "", "genfile", "xfile3" };
+        bool                     same    = true;
+        for ( const std::string& query : queries )
+        {
+            const auto& matches  = pooled.filter( query );
+            const auto& expected = single.filter( query );
+            same = same && matches.size() == expected.size();
+            for ( size_t index = 0; same && index < matches.size(); index++ )
+            {
+                same = matches[ index ].item == expected[ index ].item && matches[ index ].score == expected[ index ].score;
+            }
+        }
+        CHECK( same );                                                        //!< test the pool matches one thread, in the same order
+        CHECK( pooled.filter( "genfile" ).size() == 120 );
+
+        int32_t score = 0;
+        pooled.filter( "mod1f" );
+        CHECK( pooled.score( pooled.getMatches()[ 0 ].item, score ) );
+        CHECK( score == pooled.getMatches()[ 0 ].score );                     //!< test narrowing scores as a full score does
+    }
+}
+
+// end of TEST_CASE
+//-----------------------------------------------------------------------------
+// End of File unitTests_IDEFuzzyFilter.h
+// ----------------------------------------------------------------------------
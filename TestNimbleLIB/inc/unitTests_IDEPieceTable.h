@@ -0,0 +1,85 @@
+/**-----------------------------------------------------------------------------
+
+    @file       unitTests_IDEPieceTable.h
+    @defgroup   NimbleLIB Nimble LIB
+    @brief      Unit Tests for the IDE piece table document model
+
+    @copyright  Neil Beresford 2023
+
+Notes:
+
+    This file contains the unit tests for the IDEPieceTable class in the
+    IDE Module, in the Nimble Library
+
+    Lines are checked after loading, inserting, erasing, splitting and
+    joining, including edits that span pieces.
+
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include <string>
+#include "../../NimbleLIB/inc/NimbleLib.h"
+
+//-----------------------------------------------------------------------------
+// Namespace access
+//-----------------------------------------------------------------------------
+
+using namespace Nimble;
+
+//-----------------------------------------------------------------------------
+// Tests
+//-----------------------------------------------------------------------------
+TEST_CASE( "Testing the IDE piece table within the IDE Module" )
+{
+    // Loading -----------------------------------------------------------------
+    SUBCASE( "IDEPieceTable load and line access" )
+    {
+        IDEPieceTable document;
+        CHECK( document.getLineCount() == 1 );     //!< empty document has one empty line
+        CHECK( document.getLineLength( 0 ) == 0 ); //!< test empty line length
+        document.load( std::string( "first\nsecond\n\nfourth\n" ) );
+        CHECK( document.getLineCount() == 4 );          //!< trailing newline does not add a line
+        CHECK( document.hasTrailingNewline() == true ); //!< test trailing newline is remembered
+        CHECK( document.getLine( 0 ) == "first" );      //!< test get line
+        CHECK( document.getLine( 1 ) == "second" );     //!< test get line
+        CHECK( document.getLine( 2 ) == "" );           //!< test empty line
+        CHECK( document.getLine( 3 ) == "fourth" );     //!< test last line
+        CHECK( document.getLineLength( 1 ) == 6 );      //!< test line length
+        CHECK( document.getChar( 3, 2 ) == 'u' );       //!< test get char
+        CHECK( document.getLineOffset( 3 ) == 14 );     //!< test line offset
+        CHECK( document.getLineAt( 14 ) == 3 );         //!< test line at offset
+        CHECK( document.getLineAt( 13 ) == 2 );         //!< test line at a line feed
+        CHECK( document.getLine( 9 ) == "" );           //!< out of range line is empty
+    }
+    // Editing -----------------------------------------------------------------
+    SUBCASE( "IDEPieceTable edit functionality" )
+    {
+        IDEPieceTable document;
+        document.load( std::string( "alpha\nbeta\ngamma" ) );
+        CHECK( document.insert( 1, 4, "ine" ) == LibraryError::No_Error );                    //!< test insert at end of line
+        CHECK( document.getLine( 1 ) == "betaine" );                                          //!< test line after insert
+        CHECK( document.insert( 1, 7, "s" ) == LibraryError::No_Error );                      //!< continued typing
+        CHECK( document.getLine( 1 ) == "betaines" );                                         //!< test line after typing
+        CHECK( document.splitLine( 0, 2 ) == LibraryError::No_Error );                        //!< test split line
+        CHECK( document.getLineCount() == 4 );                                                //!< test line count after split
+        CHECK( document.getLine( 0 ) == "al" );                                               //!< test first half
+        CHECK( document.getLine( 1 ) == "pha" );                                              //!< test second half
+        CHECK( document.joinLines( 0 ) == LibraryError::No_Error );                           //!< test join lines
+        CHECK( document.getLine( 0 ) == "alpha" );                                            //!< test joined line
+        CHECK( document.erase( 0, 3, 5 ) == LibraryError::No_Error );                         //!< erase across a line feed
+        CHECK( document.getLine( 0 ) == "alptaines" );                                        //!< test line after erase
+        CHECK( document.getLineCount() == 2 );                                                //!< test line count after erase
+        CHECK( document.getText() == "alptaines\ngamma" );                                    //!< test whole text
+        CHECK( document.insert( 5, 0, "x" ) == LibraryError::IDEPieceTable_InvalidPosition ); //!< test bad line
+        CHECK( document.insert( 1, 9, "x" ) == LibraryError::IDEPieceTable_InvalidPosition ); //!< test bad column
+        ErrorHandler::getInstance().clearErrors();
+    }
+}
+
+// end of TEST_CASE
+//-----------------------------------------------------------------------------
+// End of File unitTests_IDEPieceTable.h
+// ----------------------------------------------------------------------------
@@ -0,0 +1,142 @@
+/**-----------------------------------------------------------------------------
+
+    @file       unitTests_IDEProjectFiles.h
+    @defgroup   NimbleLIB Nimble LIB
+    @brief      Unit Tests for the quick open project file list
+
+    @copyright  Neil Beresford 2023
+
+Notes:
+
+    This file contains the unit tests for the IDEProjectFiles class in the
+    IDE Module, in the Nimble Library
+
+    A tree of files, with a hidden folder, is listed and the list checked.
+    The folders are given times in the past so the next walk can trust
+    them, it must then read only the folders changed since, and a walk
+    finding nothing new must keep the list it has.
+
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../../NimbleLIB/inc/NimbleLib.h"
+
+//-----------------------------------------------------------------------------
+// Namespace access
+//-----------------------------------------------------------------------------
+
+using namespace Nimble;
+
+//-----------------------------------------------------------------------------
+// Local functions
+//-----------------------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @brief      lists a folder, polling until the walk has finished
+    @param      files       file list
+    @param      folder      project folder
+    @return     bool        true if the list changed
+------------------------------------------------------------------------------*/
+static bool listFiles( IDEProjectFiles& files, const std::string& folder )
+{
+    bool changed = false;
+
+    files.refresh( folder );
+    for ( uint32_t wait = 0; wait < 5000 && files.isRefreshing(); wait++ )
+    {
+        changed |= files.poll();
+        std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+    }
+    return changed;
+}
+
+/**-----------------------------------------------------------------------------
+    @brief      sets the write time of every folder below a folder an hour
+                back, as if they were written long before
+    @param      folder      project folder
+    @return     void
+------------------------------------------------------------------------------*/
+static void ageFolders( const std::filesystem::path& folder )
+{
+    auto past = std::filesystem::file_time_type::clock::now() - std::chrono::hours( 1 );
+
+    std::filesystem::last_write_time( folder, past );
+    for ( const auto& entry : std::filesystem::recursive_directory_iterator( folder ) )
+    {
+        if ( entry.is_directory() )
+        {
+            std::filesystem::last_write_time( entry.path(), past );
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Tests
+//-----------------------------------------------------------------------------
+TEST_CASE( "Testing the project file list within the IDE Module" )
+{
+    std::filesystem::path folder = std::filesystem::temp_directory_path() / "unitTest_IDEProjectFiles";
+    std::filesystem::remove_all( folder );
+    std::filesystem::create_directories( folder / "src" / "deep" );
+    std::filesystem::create_directories( folder / "inc" );
+    std::filesystem::create_directories( folder / ".git" );
+    std::ofstream( folder / "main.cpp" ) << "int main;\n";
+    std::ofstream( folder / "src" / "IDEFileDialog.cpp" ) << "\n";
+    std::ofstream( folder / "src" / "deep" / "last.h" ) << "\n";
+    std::ofstream( folder / "inc" / "IDEFileDialog.h" ) << "\n";
+    std::ofstream( folder / ".git" / "HEAD" ) << "\n";
+
+    // Listing ------------------------------------------------------------------
+    SUBCASE( "IDEProjectFiles listing a tree of files" )
+    {
+        IDEProjectFiles          files;
+        std::vector<std::string> expected = { "main.cpp", "inc/IDEFileDialog.h", "src/IDEFileDialog.cpp", "src/deep/last.h" };
+
+        CHECK( listFiles( files, folder.string() ) == true );
+        CHECK( files.getPaths() == expected );                                //!< test dot folders are skipped, files before folders
+        CHECK( files.getFoldersRead() == 4 );
+        CHECK( files.getFilter().getItemCount() == 4 );                       //!< test the filter is given the paths
+        CHECK( files.getFilter().filter( "fdlgh" ).size() == 1 );
+        CHECK( files.getFullPath( 3 ) == ( folder / "src/deep/last.h" ).string() );
+
+        // a folder that cannot be read
+        CHECK( files.refresh( ( folder / "missing" ).string() ) == LibraryError::IDEProjectFiles_FailedToOpenDirectory );
+        CHECK( files.isRefreshing() == false );
+    }
+    // Refreshing ---------------------------------------------------------------
+    SUBCASE( "IDEProjectFiles reads only the folders changed" )
+    {
+        IDEProjectFiles files;
+        ageFolders( folder );
+        listFiles( files, folder.string() );
+        CHECK( files.getFoldersRead() == 4 );
+
+        CHECK( listFiles( files, folder.string() ) == false );                //!< test nothing new keeps the list
+        CHECK( files.getFoldersRead() == 0 );                                 //!< test unchanged folders are not read
+        CHECK( files.getPaths().size() == 4 );
+
+        std::ofstream( folder / "src" / "deep" / "added.cpp" ) << "\n";
+        std::filesystem::remove( folder / "inc" / "IDEFileDialog.h" );
+        CHECK( listFiles( files, folder.string() ) == true );
+        CHECK( files.getFoldersRead() == 2 );                                 //!< test only the changed folders are read
+        CHECK( files.getPaths().size() == 4 );
+        CHECK( files.getPaths()[ 2 ] == "src/deep/added.cpp" );
+        CHECK( files.getFilter().filter( "fdlgh" ).empty() );                 //!< test the filter has the new list
+    }
+
+    std::filesystem::remove_all( folder );
+}
+
+// end of TEST_CASE
+//-----------------------------------------------------------------------------
+// End of File unitTests_IDEProjectFiles.h
+// ----------------------------------------------------------------------------
@@ -0,0 +1,178 @@
+/**-----------------------------------------------------------------------------
+
+    @file       unitTests_IDEProjectSearch.h
+    @defgroup   NimbleLIB Nimble LIB
+    @brief      Unit Tests for the project search and its thread pool
+
+    @copyright  Neil Beresford 2023
+
+Notes:
+
+    This file contains the unit tests for the IDEProjectSearch class in the
+    IDE Module, and the ThreadPool class it runs on, in the Nimble Library
+
+    A tree of text files, with a binary file and a hidden folder, is
+    searched and every line found is checked for its file, line and
+    column. A search is cancelled part way and a folder that cannot be
+    read is reported.
+
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../../NimbleLIB/inc/NimbleLib.h"
+
+//-----------------------------------------------------------------------------
+// Namespace access
+//-----------------------------------------------------------------------------
+
+using namespace Nimble;
+
+//-----------------------------------------------------------------------------
+// Local functions
+//-----------------------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @brief      searches a folder, polling until the search has ended
+    @param      search      project search
+    @param      folder      folder to search
+    @param      pattern     text to find
+    @return     std::vector<IDEProjectSearch::SearchResult>     lines found, sorted by file and line
+------------------------------------------------------------------------------*/
+static std::vector<IDEProjectSearch::SearchResult> searchFolder( IDEProjectSearch& search, const std::string& folder, const std::string& pattern )
+{
+    std::vector<IDEProjectSearch::SearchResult> results;
+
+    search.start( folder, pattern, true, false );
+    for ( uint32_t wait = 0; wait < 5000 && search.isSearching(); wait++ )
+    {
+        search.poll( results );
+        std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+    }
+    search.poll( results );
+    std::sort( results.begin(), results.end(),
+               []( const IDEProjectSearch::SearchResult& a, const IDEProjectSearch::SearchResult& b ) { return a.path < b.path || ( a.path == b.path && a.line < b.line ); } );
+    return results;
+}
+
+//-----------------------------------------------------------------------------
+// Tests
+//-----------------------------------------------------------------------------
+TEST_CASE( "Testing the project search within the IDE Module" )
+{
+    // Thread pool --------------------------------------------------------------
+    SUBCASE( "ThreadPool runs every task, including tasks submitted by tasks" )
+    {
+        ThreadPool            pool( 4 );
+        std::atomic<uint32_t> count( 0 );
+        for ( uint32_t task = 0; task < 64; task++ )
+        {
+            pool.submit(
+                [ &pool, &count ]()
+                {
+                    for ( uint32_t child = 0; child < 16; child++ )
+                    {
+                        pool.submit( [ &count ]() { count.fetch_add( 1 ); } );
+                    }
+                    count.fetch_add( 1 );
+                } );
+        }
+        pool.wait();
+
+        CHECK( pool.getThreadCount() == 4 );
+        CHECK( pool.isIdle() == true );
+        CHECK( count.load() == 64 * 17 );                                     //!< test every task ran once
+    }
+    // Binary check -------------------------------------------------------------
+    SUBCASE( "IDEProjectSearch binary file check" )
+    {
+        std::string text( 200, 'a' );
+        CHECK( IDEProjectSearch::isBinary( text.data(), text.size() ) == false );
+        text[ 150 ] = '\0';
+        CHECK( IDEProjectSearch::isBinary( text.data(), text.size() ) == true ); //!< test NUL within the vector loop
+        text[ 150 ] = 'a';
+        text[ 199 ] = '\0';
+        CHECK( IDEProjectSearch::isBinary( text.data(), text.size() ) == true ); //!< test NUL within the tail
+        CHECK( IDEProjectSearch::isBinary( text.data(), 0 ) == false );
+    }
+    // Searching ----------------------------------------------------------------
+    SUBCASE( "IDEProjectSearch searching a tree of files" )
+    {
+        std::filesystem::path folder = std::filesystem::temp_directory_path() / "unitTest_IDEProjectSearch";
+        std::filesystem::remove_all( folder );
+        std::filesystem::create_directories( folder / "src" / "deep" );
+        std::filesystem::create_directories( folder / ".git" );
+        for ( uint32_t file = 0; file < 200; file++ )
+        {
+            std::ofstream( folder / "src" / ( "file" + std::to_string( file ) + ".cpp" ) ) << "int value;\n"
+                                                                                           << ( ( file % 10 == 0 ) ? "  return needle;\r\n" : "return 0;\n" );
+        }
+        std::ofstream( folder / "src" / "deep" / "last.h" ) << "needle needle";
+        std::ofstream( folder / ".git" / "hidden.txt" ) << "needle\n";
+        std::ofstream( folder / "data.bin", std::ios::binary ) << std::string( "needle\0\0\0", 9 );
+
+        IDEProjectSearch                            search;
+        std::vector<IDEProjectSearch::SearchResult> results = searchFolder( search, folder.string(), "needle" );
+
+        CHECK( results.size() == 21 );                                        //!< test binary files and dot folders are skipped
+        CHECK( search.getMatchCount() == 21 );
+        CHECK( search.getFilesSkipped() == 1 );
+        CHECK( search.getFilesSearched() == 201 );
+        CHECK( search.isTruncated() == false );
+        CHECK( search.getPattern() == "needle" );
+        CHECK( results[ 0 ].path == ( folder / "src" / "deep" / "last.h" ).string() );
+        CHECK( results[ 0 ].line == 1 );                                      //!< test one result for each line
+        CHECK( results[ 1 ].line == 2 );
+        CHECK( results[ 1 ].column == 9 );
+        CHECK( results[ 1 ].text == "  return needle;" );                     //!< test line ending is dropped
+
+        // a folder that cannot be read
+        CHECK( search.start( ( folder / "missing" ).string(), "needle", true, false ) == LibraryError::IDEProjectSearch_FailedToOpenDirectory );
+        CHECK( search.isSearching() == false );
+
+        std::filesystem::remove_all( folder );
+    }
+    // Cancelling ---------------------------------------------------------------
+    SUBCASE( "IDEProjectSearch cancelled part way" )
+    {
+        std::filesystem::path folder = std::filesystem::temp_directory_path() / "unitTest_IDEProjectSearchCancel";
+        std::filesystem::remove_all( folder );
+        for ( uint32_t directory = 0; directory < 20; directory++ )
+        {
+            std::filesystem::create_directories( folder / std::to_string( directory ) );
+            for ( uint32_t file = 0; file < 100; file++ )
+            {
+                std::ofstream( folder / std::to_string( directory ) / ( std::to_string( file ) + ".txt" ) ) << "a needle in a haystack\n";
+            }
+        }
+
+        IDEProjectSearch                            search;
+        std::vector<IDEProjectSearch::SearchResult> results;
+        search.start( folder.string(), "needle", true, false );
+        search.cancel();
+        CHECK( search.isSearching() == false );                               //!< test cancel returns at once
+        search.poll( results );
+        CHECK( results.size() <= 2000 );
+
+        // a new search replaces the cancelled one
+        results = searchFolder( search, folder.string(), "needle" );
+        CHECK( results.size() == 2000 );
+
+        std::filesystem::remove_all( folder );
+    }
+}
+
+// end of TEST_CASE
+//-----------------------------------------------------------------------------
+// End of File unitTests_IDEProjectSearch.h
+// ----------------------------------------------------------------------------
@@ -0,0 +1,126 @@
+/**-----------------------------------------------------------------------------
+
+    @file       unitTests_IDESearch.h
+    @defgroup   NimbleLIB Nimble LIB
+    @brief      Unit Tests for the IDE find / replace search
+
+    @copyright  Neil Beresford 2023
+
+Notes:
+
+    This file contains the unit tests for the IDESearch class in the IDE
+    Module, in the Nimble Library
+
+    The vector scans are checked against a byte at a time search, over text
+    long enough to cross several 16 and 32 byte blocks. Text cut into
+    pieces must give the same matches as the text in one block, including
+    matches that run across several pieces.
+
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../../NimbleLIB/inc/NimbleLib.h"
+
+//-----------------------------------------------------------------------------
+// Namespace access
+//-----------------------------------------------------------------------------
+
+using namespace Nimble;
+
+//-----------------------------------------------------------------------------
+// Tests
+//-----------------------------------------------------------------------------
+TEST_CASE( "Testing the IDE search within the IDE Module" )
+{
+    // Find ---------------------------------------------------------------------
+    SUBCASE( "IDESearch find functionality" )
+    {
+        IDESearch   search;
+        std::string text = "int Count = count + counter; // COUNT";
+
+        search.setPattern( "count", true, false );
+        CHECK( search.findNext( text.data(), text.size(), 0 ) == 12 );                     //!< test case sensitive
+        CHECK( search.findNext( text.data(), text.size(), 13 ) == 20 );                    //!< test find from a position
+        CHECK( search.findPrevious( text.data(), text.size(), 20 ) == 12 );                //!< test find previous
+        CHECK( search.findNext( text.data(), text.size(), 21 ) == IDESearch::NOT_FOUND );  //!< test no more matches
+        search.setPattern( "count", false, false );
+        CHECK( search.findNext( text.data(), text.size(), 0 ) == 4 );                      //!< test ignoring case
+        CHECK( search.findPrevious( text.data(), text.size(), text.size() ) == 32 );       //!< test find previous ignoring case
+        search.setPattern( "count", false, true );
+        CHECK( search.findNext( text.data(), text.size(), 13 ) == 32 );                    //!< test whole word skips counter
+        search.setPattern( "", true, false );
+        CHECK( search.findNext( text.data(), text.size(), 0 ) == IDESearch::NOT_FOUND );   //!< test empty pattern
+    }
+    // Find all -----------------------------------------------------------------
+    SUBCASE( "IDESearch find all" )
+    {
+        IDESearch             search;
+        std::string           text;
+        std::vector<uint64_t> matches;
+        uint64_t              expected = 0;
+
+        for ( uint32_t line = 0; line < 100; line++ )
+        {
+            text += std::string( line % 37, 'a' ) + "abcab\n"; //!< matches at every alignment
+        }
+        search.setPattern( "ab", true, false );
+        for ( uint64_t position = 0; position + 1 < text.size(); position++ )
+        {
+            if ( text[position] == 'a' && text[position + 1] == 'b' )
+            {
+                expected++;
+            }
+        }
+        CHECK( search.findAll( text.data(), text.size(), matches ) == expected ); //!< test against a byte at a time count
+    }
+    // Text in pieces -----------------------------------------------------------
+    SUBCASE( "IDESearch find across pieces" )
+    {
+        IDESearch                     search;
+        std::string                   text = "one two_one one counter oNe Count one";
+        std::vector<std::string_view> spans;
+        std::vector<std::string_view> none;
+        std::vector<uint64_t>         whole;
+        std::vector<uint64_t>         pieces;
+        bool                          same = true;
+
+        // every piece length from one byte up, so matches start and end at each boundary
+        for ( uint64_t pieceLength = 1; pieceLength <= 8; pieceLength++ )
+        {
+            spans.clear();
+            for ( uint64_t offset = 0; offset < text.size(); offset += pieceLength )
+            {
+                spans.push_back( std::string_view( text ).substr( offset, pieceLength ) );
+            }
+            spans.insert( spans.begin() + 2, std::string_view() ); //!< an empty piece
+            for ( const char* pattern : { "one", "o", "count", "one one", "e t" } )
+            {
+                for ( bool wholeWord : { false, true } )
+                {
+                    search.setPattern( pattern, false, wholeWord );
+                    search.findAll( text.data(), text.size(), whole );
+                    search.findAll( spans, pieces );
+                    same = same && whole == pieces;
+                    same = same && search.findNext( spans, 5 ) == search.findNext( text.data(), text.size(), 5 );
+                    same = same && search.findPrevious( spans, 30 ) == search.findPrevious( text.data(), text.size(), 30 );
+                    same = same && search.findPrevious( spans, text.size() ) == search.findPrevious( text.data(), text.size(), text.size() );
+                }
+            }
+        }
+        CHECK( same == true ); //!< test pieces match the whole text
+        search.setPattern( "one", true, true );
+        CHECK( search.findAll( spans, pieces ) == 3 );               //!< test whole word across pieces
+        CHECK( search.findNext( none, 0 ) == IDESearch::NOT_FOUND ); //!< test no pieces
+    }
+}
+
+// end of TEST_CASE
+//-----------------------------------------------------------------------------
+// End of File unitTests_IDESearch.h
+// ----------------------------------------------------------------------------
@@ -0,0 +1,113 @@
+/**-----------------------------------------------------------------------------
+
+    @file       unitTests_IDESyntax.h
+    @defgroup   NimbleLIB Nimble LIB
+    @brief      Unit Tests for the IDE syntax highlighter
+
+    @copyright  Neil Beresford 2023
+
+Notes:
+
+    This file contains the unit tests for the IDESyntax class in the IDE
+    Module, in the Nimble Library
+
+    Lines are lexed on their own, then a document is edited to check only
+    the lines whose state changes are lexed again.
+
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include <string>
+#include <vector>
+#include "../../NimbleLIB/inc/NimbleLib.h"
+
+//-----------------------------------------------------------------------------
+// Namespace access
+//-----------------------------------------------------------------------------
+
+using namespace Nimble;
+
+//-----------------------------------------------------------------------------
+// Tests
+//-----------------------------------------------------------------------------
+TEST_CASE( "Testing the IDE syntax highlighter within the IDE Module" )
+{
+    // Lexing lines -------------------------------------------------------------
+    SUBCASE( "IDESyntax lexing lines" )
+    {
+        std::vector<IDESyntax::TokenRun> runs;
+        IDESyntax::LexState              state;
+
+        state = IDESyntax::lexLine( "int x = 0x1F; // done", IDESyntax::initialState(), &runs );
+        CHECK( runs.size() == 3 );                                   //!< type, number and comment
+        CHECK( runs[0].type == IDESyntax::TokenType::Type );         //!< test type
+        CHECK( runs[1].start == 8 );                                 //!< test number start
+        CHECK( runs[1].length == 4 );                                //!< test number length
+        CHECK( runs[2].type == IDESyntax::TokenType::Comment );      //!< test line comment
+        CHECK( state.mode == IDESyntax::LexMode::Normal );           //!< test nothing carries on
+
+        state = IDESyntax::lexLine( "return \"a\\\"b\"; /* open", IDESyntax::initialState(), &runs );
+        CHECK( runs[0].type == IDESyntax::TokenType::Keyword );      //!< test keyword
+        CHECK( runs[1].length == 6 );                                //!< test escaped quote in a string
+        CHECK( state.mode == IDESyntax::LexMode::BlockComment );     //!< test open block comment
+        state = IDESyntax::lexLine( "still */ if", state, &runs );
+        CHECK( runs[0].length == 8 );                                //!< test comment carried on
+        CHECK( runs[1].type == IDESyntax::TokenType::Keyword );      //!< test code after the comment
+
+        state = IDESyntax::lexLine( "auto s = R\"x(one )\" two", IDESyntax::initialState(), &runs );
+        CHECK( state.mode == IDESyntax::LexMode::RawString );        //!< test raw string carries on
+        state = IDESyntax::lexLine( ")\" ignored )x\";", state, &runs );
+        CHECK( runs[0].length == 14 );                               //!< test only the delimiter closes it
+        CHECK( state.mode == IDESyntax::LexMode::Normal );           //!< test raw string closed
+
+        IDESyntax::lexLine( "#include <vector>", IDESyntax::initialState(), &runs );
+        CHECK( runs[0].type == IDESyntax::TokenType::Preprocessor ); //!< test directive
+        CHECK( runs[1].type == IDESyntax::TokenType::String );       //!< test header name
+    }
+    // Incremental update -------------------------------------------------------
+    SUBCASE( "IDESyntax incremental update" )
+    {
+        IDEPieceTable document;
+        IDESyntax     syntax;
+        uint32_t      firstChanged;
+        uint32_t      lastChanged;
+        std::string   text;
+
+        for ( uint32_t line = 0; line < 1000; line++ )
+        {
+            text += "int value = 1;\n";
+        }
+        document.load( std::move( text ) );
+        CHECK( syntax.update( document, 999, firstChanged, lastChanged ) == false ); //!< first lex changes nothing shown
+        CHECK( syntax.getLinesLexed() == 1000 );                                     //!< test every line lexed once
+
+        document.insert( 500, 0, "x" ); //!< edit without a state change
+        syntax.linesChanged( 500, 1, 1 );
+        CHECK( syntax.update( document, 999, firstChanged, lastChanged ) == false ); //!< test no start states changed
+        CHECK( syntax.getLinesLexed() == 1001 );                                     //!< test only the edited line lexed
+
+        document.insert( 500, 0, "/*" ); //!< opens a comment to the end of the file
+        syntax.linesChanged( 500, 1, 1 );
+        CHECK( syntax.update( document, 599, firstChanged, lastChanged ) == true );  //!< test later lines changed
+        CHECK( firstChanged == 501 );                                                //!< test first line changed
+        CHECK( lastChanged == 600 );                                                 //!< test only as far as asked
+        CHECK( syntax.getStartState( 599 ).mode == IDESyntax::LexMode::BlockComment );
+
+        document.splitLine( 100, 0 ); //!< new line above, the cache moves down with it
+        syntax.linesChanged( 100, 1, 2 );
+        document.erase( 501, 0, 2 ); //!< close the comment again
+        syntax.linesChanged( 501, 1, 1 );
+        uint32_t lexed = syntax.getLinesLexed();
+        CHECK( syntax.update( document, 1000, firstChanged, lastChanged ) == true ); //!< test the comment is removed
+        CHECK( syntax.getStartState( 1000 ).mode == IDESyntax::LexMode::Normal );
+        CHECK( syntax.getLinesLexed() - lexed < 510 );                               //!< test it stopped once settled
+    }
+}
+
+// end of TEST_CASE
+//-----------------------------------------------------------------------------
+// End of File unitTests_IDESyntax.h
+// ----------------------------------------------------------------------------
@@ -0,0 +1,178 @@
+/**-----------------------------------------------------------------------------
+
+    @file       unitTests_IDETrigramIndex.h
+    @defgroup   NimbleLIB Nimble LIB
+    @brief      Unit Tests for the project trigram index
+
+    @copyright  Neil Beresford 2023
+
+Notes:
+
+    This file contains the unit tests for the IDETrigramIndex class in the
+    IDE Module, in the Nimble Library
+
+    A tree is searched with the index and without, the lines found must be
+    the same. Files are then changed, written again unchanged, added and
+    removed, and each search must only read the files it needs to.
+
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../../NimbleLIB/inc/NimbleLib.h"
+
+//-----------------------------------------------------------------------------
+// Namespace access
+//-----------------------------------------------------------------------------
+
+using namespace Nimble;
+
+//-----------------------------------------------------------------------------
+// Local functions
+//-----------------------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @brief      searches a folder, polling until the search and the commit of
+                the index have ended
+    @param      search      project search
+    @param      folder      folder to search
+    @param      pattern     text to find
+    @return     std::vector<std::string>    "path:line" of the lines found, sorted
+------------------------------------------------------------------------------*/
+static std::vector<std::string> searchLines( IDEProjectSearch& search, const std::string& folder, const std::string& pattern )
+{
+    std::vector<IDEProjectSearch::SearchResult> results;
+    std::vector<std::string>                    lines;
+
+    search.start( folder, pattern, true, false );
+    for ( uint32_t wait = 0; wait < 5000 && search.isSearching(); wait++ )
+    {
+        search.poll( results );
+        std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+    }
+    search.poll( results );
+    for ( const auto& result : results )
+    {
+        lines.push_back( result.path + ":" + std::to_string( result.line ) );
+    }
+    std::sort( lines.begin(), lines.end() );
+    return lines;
+}
+
+//-----------------------------------------------------------------------------
+// Tests
+//-----------------------------------------------------------------------------
+TEST_CASE( "Testing the project trigram index within the IDE Module" )
+{
+    std::filesystem::path folder = std::filesystem::temp_directory_path() / "unitTest_IDETrigramIndex";
+    std::filesystem::remove_all( folder );
+    std::filesystem::create_directories( folder / "src" );
+    for ( uint32_t file = 0; file < 300; file++ )
+    {
+        std::ofstream( folder / "src" / ( "file" + std::to_string( file ) + ".cpp" ) ) << "int value = " << file << ";\n"
+                                                                                       << ( ( file % 30 == 0 ) ? "call( Needle );\n" : "return 0;\n" );
+    }
+    std::ofstream( folder / "data.bin", std::ios::binary ) << std::string( "Needle\0\0", 8 );
+
+    // Trigrams -----------------------------------------------------------------
+    SUBCASE( "IDETrigramIndex trigrams folded to lower case" )
+    {
+        std::vector<uint32_t> trigrams;
+        std::vector<uint32_t> expected = { ( 'a' << 16 ) | ( 'b' << 8 ) | 'c', ( 'b' << 16 ) | ( 'c' << 8 ) | 'a', ( 'c' << 16 ) | ( 'a' << 8 ) | 'b' };
+        IDETrigramIndex::extractTrigrams( "AbCabc", 6, trigrams );
+        CHECK( trigrams == expected );                                        //!< test each trigram once, in order
+        IDETrigramIndex::extractTrigrams( "ab", 2, trigrams );
+        CHECK( trigrams.empty() );
+    }
+    // Searching ----------------------------------------------------------------
+    SUBCASE( "IDETrigramIndex search matches a search of every file" )
+    {
+        IDEProjectSearch plain;
+        IDEProjectSearch indexed;
+        indexed.setIndexed( true );
+
+        std::vector<std::string> expected = searchLines( plain, folder.string(), "Needle" );
+        CHECK( expected.size() == 10 );
+        CHECK( searchLines( indexed, folder.string(), "Needle" ) == expected ); //!< test the search that builds the index
+        CHECK( indexed.getFilesIndexed() == 301 );
+        CHECK( std::filesystem::is_regular_file( folder / IDETrigramIndex::INDEX_FILE ) );
+
+        CHECK( searchLines( indexed, folder.string(), "Needle" ) == expected ); //!< test the search that uses it
+        CHECK( indexed.getFilesIndexed() == 0 );
+        CHECK( indexed.getFilesSearched() == 10 );                            //!< test only the files holding the trigrams are read
+        CHECK( searchLines( indexed, folder.string(), "needle" ).empty() );   //!< test case is checked after the index
+        CHECK( searchLines( indexed, folder.string(), "Ne" ) == expected );   //!< test a pattern too short for the index
+        CHECK( indexed.getFilesSearched() == 300 );
+
+        IDETrigramIndex       index;
+        std::vector<uint32_t> files;
+        CHECK( index.open( folder.string() ) == LibraryError::No_Error );
+        CHECK( index.getFileCount() == 301 );
+        CHECK( index.query( "NEEDLE", files ) == true );
+        CHECK( files.size() == 10 );                                          //!< test the binary file has no postings
+        CHECK( index.query( "zzzz", files ) == true );
+        CHECK( files.empty() );
+        CHECK( index.query( "ab", files ) == false );
+    }
+    // Updating -----------------------------------------------------------------
+    SUBCASE( "IDETrigramIndex kept up to date as files change" )
+    {
+        IDEProjectSearch search;
+        search.setIndexed( true );
+        searchLines( search, folder.string(), "Needle" );
+
+        // changed, written again with the same contents, added and removed
+        std::ofstream( folder / "src" / "file1.cpp" ) << "Needle, changed\n";
+        std::filesystem::last_write_time( folder / "src" / "file2.cpp", std::filesystem::last_write_time( folder / "src" / "file2.cpp" ) + std::chrono::seconds( 5 ) );
+        std::ofstream( folder / "src" / "added.cpp" ) << "\n\nNeedle\n";
+        std::filesystem::remove( folder / "src" / "file0.cpp" );
+
+        std::vector<std::string> lines = searchLines( search, folder.string(), "Needle" );
+        CHECK( lines.size() == 11 );
+        CHECK( search.getFilesIndexed() == 2 );                               //!< test only the changed and added files are indexed
+        CHECK( std::find( lines.begin(), lines.end(), ( folder / "src" / "file1.cpp" ).string() + ":1" ) != lines.end() );
+        CHECK( std::find( lines.begin(), lines.end(), ( folder / "src" / "added.cpp" ).string() + ":3" ) != lines.end() );
+
+        CHECK( searchLines( search, folder.string(), "Needle" ) == lines );
+        CHECK( search.getFilesIndexed() == 0 );                               //!< test the changes were committed
+        CHECK( search.getFilesSearched() == 11 );
+
+        IDETrigramIndex index;
+        index.open( folder.string() );
+        CHECK( index.findFile( "src/file0.cpp" ) == IDETrigramIndex::NOT_INDEXED );
+        CHECK( index.findFile( "src/added.cpp" ) != IDETrigramIndex::NOT_INDEXED );
+        CHECK( index.getRemovedCount() == 2 );                                //!< test replaced and removed files are marked
+    }
+    // Damaged ------------------------------------------------------------------
+    SUBCASE( "IDETrigramIndex damaged index file is rebuilt" )
+    {
+        std::filesystem::create_directories( ( folder / IDETrigramIndex::INDEX_FILE ).parent_path() );
+        std::ofstream( folder / IDETrigramIndex::INDEX_FILE ) << "not an index";
+
+        IDETrigramIndex index;
+        CHECK( index.open( folder.string() ) == LibraryError::IDETrigramIndex_InvalidIndexFile );
+        CHECK( index.getFileCount() == 0 );
+
+        IDEProjectSearch search;
+        search.setIndexed( true );
+        CHECK( searchLines( search, folder.string(), "Needle" ).size() == 10 );
+        CHECK( index.open( folder.string() ) == LibraryError::No_Error );
+        CHECK( index.getFileCount() == 301 );
+    }
+
+    std::filesystem::remove_all( folder );
+}
+
+// end of TEST_CASE
+//-----------------------------------------------------------------------------
+// End of File unitTests_IDETrigramIndex.h
+// ----------------------------------------------------------------------------
@@ -0,0 +1,143 @@
+/**-----------------------------------------------------------------------------
+
+    @file       unitTests_IDEUndoJournal.h
+    @defgroup   NimbleLIB Nimble LIB
+    @brief      Unit Tests for the IDE undo / redo journal
+
+    @copyright  Neil Beresford 2023
+
+Notes:
+
+    This file contains the unit tests for the IDEUndoJournal class in the
+    IDE Module, in the Nimble Library
+
+    Edits are made to an IDEPieceTable and recorded, then undone and redone,
+    checking the text, the steps typing is merged into and the byte budget.
+    A step over the budget must be refused before it is made, leaving the
+    older steps as they were.
+
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include <string>
+#include "../../NimbleLIB/inc/NimbleLib.h"
+
+//-----------------------------------------------------------------------------
+// Namespace access
+//-----------------------------------------------------------------------------
+
+using namespace Nimble;
+
+//-----------------------------------------------------------------------------
+// Tests
+//-----------------------------------------------------------------------------
+TEST_CASE( "Testing the IDE undo journal within the IDE Module" )
+{
+    // Typing and undo / redo --------------------------------------------------
+    SUBCASE( "IDEUndoJournal typing is one step" )
+    {
+        IDEPieceTable               document;
+        IDEUndoJournal              journal;
+        IDEUndoJournal::CursorState cursor = { 0, 0, 0, 0 };
+        document.load( std::string( "abc\ndef" ) );
+
+        for ( uint32_t index = 0; index < 3; index++ )
+        {
+            document.insertAt( 3 + index, "x" ); //!< type at the end of the first line
+            journal.recordInsert( 3 + index, "x", cursor );
+        }
+        CHECK( journal.getUndoSteps() == 1 ); //!< test typing is merged
+        document.eraseAt( 5, 1 );             //!< backspace
+        journal.recordErase( 5, "x", cursor );
+        document.eraseAt( 4, 1 ); //!< backspace
+        journal.recordErase( 4, "x", cursor );
+        CHECK( journal.getUndoSteps() == 2 );               //!< test backspaces are merged
+        CHECK( document.getText() == "abcx\ndef" );         //!< test the edits
+        CHECK( journal.undo( document, cursor ) == true );  //!< undo the backspaces
+        CHECK( document.getText() == "abcxxx\ndef" );       //!< test the backspaces are undone
+        CHECK( journal.undo( document, cursor ) == true );  //!< undo the typing
+        CHECK( document.getText() == "abc\ndef" );          //!< test the typing is undone
+        CHECK( journal.undo( document, cursor ) == false ); //!< test nothing left to undo
+        CHECK( journal.redo( document, cursor ) == true );  //!< redo the typing
+        CHECK( document.getText() == "abcxxx\ndef" );       //!< test the typing is redone
+        journal.closeStep();                                //!< the cursor moved
+        document.insertAt( 0, "y" );                        //!< a new edit
+        journal.recordInsert( 0, "y", cursor );
+        CHECK( journal.canRedo() == false );  //!< test a new edit clears redo
+        CHECK( journal.getUndoSteps() == 2 ); //!< test the new edit is a new step
+    }
+    // Groups and budget -------------------------------------------------------
+    SUBCASE( "IDEUndoJournal groups and byte budget" )
+    {
+        IDEPieceTable               document;
+        IDEUndoJournal              journal;
+        IDEUndoJournal::CursorState cursor = { 0, 0, 0, 0 };
+        document.load( std::string( "one two one" ) );
+
+        journal.beginGroup(); //!< replace all as one step
+        document.eraseAt( 8, 3 );
+        journal.recordErase( 8, "one", cursor );
+        document.insertAt( 8, "1" );
+        journal.recordInsert( 8, "1", cursor );
+        document.eraseAt( 0, 3 );
+        journal.recordErase( 0, "one", cursor );
+        document.insertAt( 0, "1" );
+        journal.recordInsert( 0, "1", cursor );
+        journal.endGroup();
+        CHECK( document.getText() == "1 two 1" );          //!< test the replace
+        CHECK( journal.getUndoSteps() == 1 );              //!< test the group is one step
+        CHECK( journal.undo( document, cursor ) == true ); //!< undo the group
+        CHECK( document.getText() == "one two one" );      //!< test every edit is undone
+
+        std::string paste( 100000, 'p' );
+        journal.setByteBudget( 50000 ); //!< smaller than the paste
+        journal.recordInsert( 0, paste, cursor );
+        CHECK( journal.getBytesUsed() <= journal.getByteBudget() ); //!< test the budget is kept
+        CHECK( journal.canUndo() == false );                        //!< test the paste did not fit
+        journal.setByteBudget( IDEUndoJournal::DEFAULT_BYTE_BUDGET );
+        journal.recordInsert( 0, paste, cursor );
+        CHECK( journal.getBytesUsed() < paste.size() * 2 ); //!< test only the pasted text is held
+    }
+    // Large step --------------------------------------------------------------
+    SUBCASE( "IDEUndoJournal large step is refused" )
+    {
+        IDEPieceTable               document;
+        IDEUndoJournal              journal( 300000 );
+        IDEUndoJournal::CursorState cursor = { 0, 0, 0, 0 };
+        std::string                 original( 100000, 'a' );
+        std::string                 replaced( 100000, 'b' );
+        document.load( std::string( original ) );
+
+        document.insertAt( 0, "x" ); //!< an older step
+        journal.recordInsert( 0, "x", cursor );
+        CHECK( journal.canRecordStep( 2, original.size() + 1 + replaced.size() ) == true ); //!< test the replace fits
+        journal.beginGroup();
+        document.eraseAt( 0, original.size() + 1 );
+        journal.recordErase( 0, "x" + original, cursor );
+        document.insertAt( 0, replaced );
+        journal.recordInsert( 0, replaced, cursor );
+        journal.endGroup();
+        CHECK( journal.getBytesUsed() <= journal.getByteBudget() );
+        CHECK( journal.undo( document, cursor ) == true ); //!< test both halves are undone
+        CHECK( document.getText() == "x" + original );
+        CHECK( journal.redo( document, cursor ) == true );
+
+        journal.setByteBudget( 150000 ); //!< smaller than the replace
+        document.insertAt( 0, "y" );      //!< a step that fits
+        journal.recordInsert( 0, "y", cursor );
+        uint64_t used = journal.getBytesUsed();
+        CHECK( journal.canRecordStep( 2, original.size() + replaced.size() ) == false ); //!< test the replace is refused
+        CHECK( journal.canRecordStep( 1000, 1000 * 8 ) == true );                        //!< test many small edits fit
+        CHECK( journal.getBytesUsed() == used );                                         //!< test the history is kept
+        CHECK( journal.canUndo() == true );
+        CHECK( journal.getByteBudget() == 150000 );
+    }
+}
+
+// end of TEST_CASE
+//-----------------------------------------------------------------------------
+// End of File unitTests_IDEUndoJournal.h
+// ----------------------------------------------------------------------------
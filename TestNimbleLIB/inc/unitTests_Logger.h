@@ -0,0 +1,154 @@
+/**----------------------------------------------------------------------------
+
+    @file       unitTests_Logger.h
+    @defgroup   NimbleLIB Nimble LIB
+    @brief      Unit Tests for the Logger
+
+    @copyright  Neil Beresford 2023
+
+Notes:
+
+    This file contains the unit tests for the Logger class, in the Logging
+    Module of the Nimble Library
+
+    Records logged from several threads all reach the log file, long
+    messages are cut short, the file is rotated at its size limit and
+    saveLog() / clearLog() work on the lines kept.
+
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../../NimbleLIB/inc/Modules/Logging/Logger.h"
+
+//-----------------------------------------------------------------------------
+// Namespace access
+//-----------------------------------------------------------------------------
+
+using namespace Nimble;
+
+//-----------------------------------------------------------------------------
+// Tests
+//-----------------------------------------------------------------------------
+TEST_CASE( "Testing the Logger within the Logging Module" )
+{
+    std::string logName = ( std::filesystem::temp_directory_path() / "unitTests_Logger.log" ).string();
+    auto        readLog = []( const std::string& fileName )
+    {
+        std::ifstream            file( fileName );
+        std::vector<std::string> lines;
+        std::string              line;
+        while ( std::getline( file, line ) )
+        {
+            lines.push_back( line );
+        }
+        return lines;
+    };
+    auto removeLogs = [ & ]()
+    {
+        std::filesystem::remove( logName );
+        std::filesystem::remove( logName + ".1" );
+        std::filesystem::remove( logName + ".2" );
+    };
+    removeLogs();
+
+    // Logging ----------------------------------------------------------------
+    SUBCASE( "Logger writes records from every thread" )
+    {
+        Logger logger;
+        CHECK( logger.LogMessage( "too early" ) == LibraryError::Logger_InitializeNotCalled );
+        logger.loggerInitialize();
+        logger.setOutputTerminal( false );
+        CHECK( logger.setOutputFile( logName ) == LibraryError::No_Error );
+
+        std::vector<std::thread> threads;
+        for ( uint32_t thread = 0; thread < 4; thread++ )
+        {
+            threads.emplace_back(
+                [ &logger, thread ]()
+                {
+                    for ( uint32_t index = 0; index < 500; index++ )
+                    {
+                        logger.LogMessage( "message " + std::to_string( thread ) + " " + std::to_string( index ) );
+                    }
+                } );
+        }
+        for ( std::thread& thread : threads )
+        {
+            thread.join();
+        }
+        logger.flush();
+
+        std::vector<std::string> lines    = readLog( logName );
+        uint64_t                 messages = 0;
+        for ( const std::string& line : lines )
+        {
+            messages += ( line.find( "] - message " ) != std::string::npos ) ? 1 : 0;
+        }
+        CHECK( messages + logger.getDroppedCount() == 2000 ); //!< test every record written or counted
+
+        std::string path = "FileManager::openFile() : /" + std::string( 300, 'p' ) + "/file.cpp";
+        logger.LogError( LibraryError::Logger_QueueFull, path );
+        logger.flush();
+        lines = readLog( logName );
+        CHECK( lines.back().find( "] - Error 0x" ) != std::string::npos );
+        CHECK( lines.back().find( path ) != std::string::npos ); //!< test a long path is kept whole
+
+        logger.LogError( LibraryError::Logger_QueueFull, std::string( 1000, 'x' ) );
+        logger.flush();
+        lines = readLog( logName );
+        CHECK( lines.back().size() == lines.back().find( "xxx" ) + Logger::PAYLOAD_SIZE ); //!< test message cut short
+        CHECK( lines.back().substr( lines.back().size() - 4 ) == "x..." );                //!< test the cut is marked
+    }
+    // Rotation ---------------------------------------------------------------
+    SUBCASE( "Logger rotates the log file" )
+    {
+        Logger logger;
+        logger.loggerInitialize();
+        logger.setOutputTerminal( false );
+        CHECK( logger.setOutputFile( logName, 4096, 2 ) == LibraryError::No_Error );
+        for ( uint32_t index = 0; index < 400; index++ )
+        {
+            logger.LogMessage( "rotated message " + std::to_string( index ) );
+            if ( ( index & 31 ) == 0 )
+            {
+                logger.flush();
+            }
+        }
+        logger.closeOutputFile();
+        CHECK( std::filesystem::exists( logName + ".1" ) == true );
+        CHECK( std::filesystem::exists( logName + ".2" ) == false ); //!< test only two files kept
+        CHECK( std::filesystem::file_size( logName ) <= 4096 );
+        CHECK( readLog( logName ).back().find( "rotated message 399" ) != std::string::npos );
+    }
+    // Save and clear ---------------------------------------------------------
+    SUBCASE( "Logger saves and clears the lines kept" )
+    {
+        Logger logger;
+        logger.loggerInitialize();
+        logger.setOutputTerminal( false );
+        logger.LogMessage( "kept message" );
+        logger.flush();
+        CHECK( logger.setOutputFile( logName ) == LibraryError::No_Error );
+        logger.closeOutputFile();
+        CHECK( readLog( logName ).empty() == true ); //!< test written before the file was set
+        CHECK( logger.saveLog() == LibraryError::No_Error );
+        CHECK( readLog( logName ).size() == 1 );
+        logger.clearLog();
+        CHECK( logger.saveLog() == LibraryError::No_Error );
+        CHECK( readLog( logName ).size() == 1 ); //!< test nothing kept after clearLog()
+    }
+    removeLogs();
+}
+
+// end of TEST_CASE
+//-----------------------------------------------------------------------------
+// End of File unitTests_Logger.h
+// ----------------------------------------------------------------------------
@@ -0,0 +1,180 @@
+/**-----------------------------------------------------------------------------
+
+    @file       unitTests_PatchedFile.h
+    @defgroup   NimbleLIB Nimble LIB
+    @brief      Unit Tests for the patched file used by the hex editor
+
+    @copyright  Neil Beresford 2023
+
+Notes:
+
+    This file contains the unit tests for the PatchedFile class in the
+    File Handling Module, in the Nimble Library
+
+    Edits are checked through the overlay before the save, then the file is
+    mapped again to check only the edited bytes were written. A mapped file
+    cut short on disk must read as zeros past its new end, files opened
+    past the truncation guard table must be read into memory instead. A
+    file replaced or resized on disk must be reported as changed.
+
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "../../NimbleLIB/inc/NimbleLib.h"
+
+//-----------------------------------------------------------------------------
+// Namespace access
+//-----------------------------------------------------------------------------
+
+using namespace Nimble;
+
+//-----------------------------------------------------------------------------
+// Tests
+//-----------------------------------------------------------------------------
+TEST_CASE( "Testing the patched file within the File Handling Module" )
+{
+    // Overlay and save --------------------------------------------------------
+    SUBCASE( "PatchedFile edit and save" )
+    {
+        std::string fileName = "unitTests_PatchedFile.bin";
+        {
+            std::ofstream output( fileName, std::ios::binary );
+            output << "0123456789ABCDEF";
+        }
+
+        PatchedFile file;
+        uint8_t     bytes[20];
+        CHECK( file.open( fileName ) == LibraryError::No_Error );                    //!< test open
+        CHECK( file.getSize() == 16 );                                               //!< test size
+        CHECK( file.setByte( 2, 'x' ) == LibraryError::No_Error );                   //!< edit a byte
+        CHECK( file.setByte( 3, 'y' ) == LibraryError::No_Error );                   //!< edit the next byte
+        CHECK( file.setByte( 9, '9' ) == LibraryError::No_Error );                   //!< setting the same value is not an edit
+        CHECK( file.setByte( 16, 'z' ) == LibraryError::PatchedFile_InvalidOffset ); //!< test edit past the end
+        CHECK( file.getEditCount() == 2 );                                           //!< test only real changes are held
+        CHECK( file.isEdited( 2 ) == true );                                         //!< test edited byte
+        CHECK( file.isEdited( 9 ) == false );                                        //!< test unchanged byte
+        CHECK( file.readBytes( 0, bytes, 20 ) == 16 );                               //!< test read stops at the end of file
+        CHECK( std::string( (char*)bytes, 16 ) == "01xy456789ABCDEF" );              //!< test edits are applied to the read
+        CHECK( file.setByte( 3, '3' ) == LibraryError::No_Error );                   //!< put a byte back
+        CHECK( file.getEditCount() == 1 );                                           //!< test the edit is dropped
+        CHECK( file.setByte( 15, 'f' ) == LibraryError::No_Error );                  //!< edit the last byte
+        CHECK( file.save() == LibraryError::No_Error );                              //!< test save
+        CHECK( file.isModified() == false );                                         //!< test the overlay is empty after saving
+        CHECK( file.readBytes( 0, bytes, 16 ) == 16 );                               //!< read the saved file
+        CHECK( std::string( (char*)bytes, 16 ) == "01x3456789ABCDEf" );              //!< test the edits were written
+        file.close();
+        std::remove( fileName.c_str() );
+    }
+    // Truncated while mapped --------------------------------------------------
+    SUBCASE( "MappedFile truncated while mapped" )
+    {
+        std::string fileName = "unitTests_MappedFile.bin";
+        {
+            std::ofstream output( fileName, std::ios::binary );
+            output << std::string( 256 * 1024, 'a' );
+        }
+
+        MappedFile file;
+        CHECK( file.open( fileName ) == LibraryError::No_Error );
+        CHECK( file.isTruncated() == false );
+        std::filesystem::resize_file( fileName, 10 );                                //!< cut short by another writer
+        CHECK( file.getData()[file.getSize() - 1] == 0 );                            //!< test the lost page reads as zero
+        CHECK( file.getData()[200 * 1024] == 0 );
+        CHECK( file.isTruncated() == true );                                         //!< test the truncation is reported
+        CHECK( file.getData()[0] == 'a' );                                           //!< test the bytes kept still read
+        file.close();
+        CHECK( file.open( fileName ) == LibraryError::No_Error );                    //!< test mapping the short file again
+        CHECK( file.getSize() == 10 );
+        CHECK( file.isTruncated() == false );
+        file.close();
+        std::remove( fileName.c_str() );
+    }
+    // Save blocked once truncated -------------------------------------------
+    SUBCASE( "PatchedFile save refused once truncated" )
+    {
+        std::string fileName = "unitTests_PatchedFile.bin";
+        {
+            std::ofstream output( fileName, std::ios::binary );
+            output << std::string( 64 * 1024, 'c' );
+        }
+
+        PatchedFile file;
+        uint8_t     bytes[4];
+        CHECK( file.open( fileName ) == LibraryError::No_Error );
+        CHECK( file.setByte( 0, 'x' ) == LibraryError::No_Error );
+        std::filesystem::resize_file( fileName, 10 );                                //!< cut short by another writer
+        CHECK( file.readBytes( 60 * 1024, bytes, 4 ) == 4 );                         //!< read a lost page
+        CHECK( bytes[0] == 0 );
+        CHECK( file.isTruncated() == true );                                         //!< test the truncation is reported
+        CHECK( file.save() == LibraryError::PatchedFile_FileTruncated );             //!< test the save is refused
+        CHECK( file.isModified() == true );                                          //!< test the edit is kept
+        CHECK( std::filesystem::file_size( fileName ) == 10 );                       //!< test the file was not written
+        file.close();
+        std::remove( fileName.c_str() );
+    }
+    // Changed on disk ---------------------------------------------------------
+    SUBCASE( "MappedFile changed on disk" )
+    {
+        std::string fileName = "unitTests_MappedFile.bin";
+        std::string tempName = "unitTests_MappedFile.tmp";
+        {
+            std::ofstream output( fileName, std::ios::binary );
+            output << "0123456789";
+        }
+
+        MappedFile file;
+        CHECK( file.open( fileName ) == LibraryError::No_Error );
+        CHECK( file.isChangedOnDisk() == false );                                    //!< test an untouched file
+        {
+            std::ofstream output( tempName, std::ios::binary );
+            output << "9876543210";
+        }
+        std::filesystem::rename( tempName, fileName );                               //!< replaced the way a save does
+        CHECK( file.isChangedOnDisk() == true );                                     //!< test the new inode is noticed
+        CHECK( file.open( fileName ) == LibraryError::No_Error );
+        CHECK( file.isChangedOnDisk() == false );                                    //!< test opening again takes the new file
+        std::filesystem::resize_file( fileName, 4 );                                 //!< written in place
+        CHECK( file.isChangedOnDisk() == true );                                     //!< test the new size is noticed
+        std::remove( fileName.c_str() );
+        CHECK( file.isChangedOnDisk() == true );                                     //!< test a removed file is changed
+        file.close();
+        CHECK( file.isChangedOnDisk() == false );                                    //!< test nothing open
+    }
+    // More files than the guard table holds -----------------------------------
+    SUBCASE( "MappedFile past the truncation guard table" )
+    {
+        std::string fileName = "unitTests_MappedFile.bin";
+        {
+            std::ofstream output( fileName, std::ios::binary );
+            output << std::string( 64 * 1024, 'b' );
+        }
+
+        std::vector<MappedFile> files( 80 );
+        bool                    allOpen = true;
+        for ( MappedFile& file : files )
+        {
+            allOpen = allOpen && file.open( fileName ) == LibraryError::No_Error && file.getSize() == 64 * 1024;
+        }
+        CHECK( allOpen == true );                                                    //!< test every file opens
+        std::filesystem::resize_file( fileName, 10 );                                //!< cut short by another writer
+        CHECK( files.back().getData()[64 * 1024 - 1] == 'b' );                       //!< test the copy keeps the bytes read
+        CHECK( files.back().isTruncated() == false );
+        CHECK( files.front().getData()[64 * 1024 - 1] == 0 );                        //!< test a guarded mapping still reads zero
+        CHECK( files.front().isTruncated() == true );
+        files.clear();
+        std::remove( fileName.c_str() );
+    }
+}
+
+// end of TEST_CASE
+//-----------------------------------------------------------------------------
+// End of File unitTests_PatchedFile.h
+// ----------------------------------------------------------------------------
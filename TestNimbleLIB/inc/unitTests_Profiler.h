@@ -0,0 +1,109 @@
+/**-----------------------------------------------------------------------------
+
+    @file       unitTests_Profiler.h
+    @defgroup   NimbleLIB Nimble LIB
+    @brief      Unit Tests for the frame and zone profiler
+
+    @copyright  Neil Beresford 2023
+
+Notes:
+
+    This file contains the unit tests for the Profiler class in the
+    Utilities Module, in the Nimble Library
+
+    Zones are only recorded while the profiler is enabled, the frame times
+    and the top zones come from what was recorded, and the Chrome trace
+    holds a complete event for each zone.
+
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include "../../NimbleLIB/inc/Modules/Utilities/Profiler.h"
+
+//-----------------------------------------------------------------------------
+// Namespace access
+//-----------------------------------------------------------------------------
+
+using namespace Nimble;
+
+//-----------------------------------------------------------------------------
+// Tests
+//-----------------------------------------------------------------------------
+TEST_CASE( "Testing the profiler within the Utilities Module" )
+{
+    Profiler& profiler = Profiler::getInstance();
+    double    lastMs   = 0.0;
+    double    avgMs    = 0.0;
+    double    p99Ms    = 0.0;
+    profiler.setEnabled( false );
+    profiler.clear();
+
+    // Zones ------------------------------------------------------------------
+    SUBCASE( "Profiler zones and frames" )
+    {
+        {
+            PROFILE_ZONE( "unitTests::disabled" );
+        }
+        profiler.beginFrame();
+        profiler.endFrame();
+        CHECK( profiler.getFrameCount() == 0 ); //!< test nothing recorded while disabled
+        CHECK( profiler.getTopZones( 4 ).empty() );
+        CHECK( profiler.getFrameTimes( lastMs, avgMs, p99Ms ) == false );
+
+        profiler.setEnabled( true );
+        for ( uint32_t frame = 0; frame < 3; frame++ )
+        {
+            profiler.beginFrame();
+            {
+                PROFILE_ZONE( "unitTests::outer" );
+                PROFILE_ZONE( "unitTests::inner" );
+                std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+            }
+            profiler.endFrame();
+        }
+        std::thread( []() { PROFILE_ZONE( "unitTests::thread" ); } ).join();
+        profiler.setEnabled( false );
+
+        auto zones = profiler.getTopZones( 2 );
+        CHECK( profiler.getFrameCount() == 3 );
+        CHECK( zones.size() == 2 ); //!< test count limited
+        CHECK( strncmp( zones[0].first, "unitTests::", 11 ) == 0 );
+        CHECK( zones[0].second >= 3000000 ); //!< test three 1ms zones summed
+        CHECK( profiler.getFrameTimes( lastMs, avgMs, p99Ms ) == true );
+        CHECK( lastMs >= 1.0 );
+        CHECK( p99Ms >= avgMs );
+
+        // chrome trace, one complete event per zone and frame
+        CHECK( profiler.exportChromeTrace( "unitTests_Profiler.json" ) == true );
+        std::ifstream     file( "unitTests_Profiler.json" );
+        std::stringstream trace;
+        trace << file.rdbuf();
+        std::string text   = trace.str();
+        size_t      events = 0;
+        for ( size_t found = text.find( "\"ph\":\"X\"" ); found != std::string::npos; found = text.find( "\"ph\":\"X\"", found + 1 ) )
+        {
+            events++;
+        }
+        CHECK( text.rfind( "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0 ) == 0 );
+        CHECK( events == 10 ); //!< test 3 frames, 6 zones and the other thread's zone
+        CHECK( text.find( "\"name\":\"unitTests::thread\"" ) != std::string::npos );
+        CHECK( text.find( "unitTests::disabled" ) == std::string::npos );
+        file.close();
+        std::remove( "unitTests_Profiler.json" );
+        profiler.clear();
+    }
+}
+
+// end of TEST_CASE
+//-----------------------------------------------------------------------------
+// End of File unitTests_Profiler.h
+// ----------------------------------------------------------------------------
@@ -19,6 +19,21 @@ Notes:
 #include "../../doctest/doctest/doctest.h"
 #include "../../NimbleLIB/inc/NimbleLib.h"
 
+// standard headers used by the tests, the test headers are included inside
+// the TEST_SUITE so anything they include for the first time lands in it
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
 //-----------------------------------------------------------------------------
 // Namespace access
 //-----------------------------------------------------------------------------
@@ -55,12 +70,45 @@ TEST_SUITE( "Nimble LIB Test Suite" )
     //-----------------------------------------------------------------------------
 
     #include "../inc/unitTests_ErrorHandler.h"
+    #include "../inc/unitTests_Logger.h"
+
+    //-----------------------------------------------------------------------------
+    // Test the Curses Module
+    //-----------------------------------------------------------------------------
+
+    #include "../inc/unitTests_CursesKeyBindings.h"
+    #include "../inc/unitTests_CursesInput.h"
 
     //-----------------------------------------------------------------------------
     // Test the IDE Module
     //-----------------------------------------------------------------------------
 
     #include "../inc/unitTests_IDEEdit.h"
+    #include "../inc/unitTests_IDEPieceTable.h"
+    #include "../inc/unitTests_IDEUndoJournal.h"
+    #include "../inc/unitTests_IDESearch.h"
+    #include "../inc/unitTests_IDESyntax.h"
+    #include "../inc/unitTests_IDEFileLoader.h"
+    #include "../inc/unitTests_IDEFuzzyFilter.h"
+    #include "../inc/unitTests_IDEProjectSearch.h"
+    #include "../inc/unitTests_IDETrigramIndex.h"
+    #include "../inc/unitTests_IDEProjectFiles.h"
+
+    //-----------------------------------------------------------------------------
+    // Test the File Handling Module
+    //-----------------------------------------------------------------------------
+
+    #include "../inc/unitTests_PatchedFile.h"
+    #include "../inc/unitTests_AtomicFileWriter.h"
+    #include "../inc/unitTests_FileManager.h"
+    #include "../inc/unitTests_DirectoryScanner.h"
+
+    //-----------------------------------------------------------------------------
+    // Test the Utilities Module
+    //-----------------------------------------------------------------------------
+
+    #include "../inc/unitTests_Profiler.h"
+    #include "../inc/unitTests_Crc.h"
 
 
 } // TEST_SUITE( "Nimble LIB Test Suite" )